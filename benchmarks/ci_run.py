@@ -670,7 +670,7 @@ def main() -> int:
             "tak_z": 6,
             "sieve_n": 100_000,
             "struct_sum_n": 10_000_000,
-            "struct_array_push_n": 1_000_000,
+            "struct_array_push_n": 10_000_000,
         },
         "cpu": cpu,
         "http": {
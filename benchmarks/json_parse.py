@@ -0,0 +1,52 @@
+"""fromJson throughput comparator: CPython json.loads on the same inputs
+benchmarks/json_parse.tpr generates (or TULPAR_JSON_FILE)."""
+
+import json
+import os
+import time
+
+
+def make_records(n):
+    return json.dumps([{"id": i, "name": "user%d" % i,
+                        "email": "u%d@example.com" % i,
+                        "active": i % 2 == 0, "score": i * 1.5,
+                        "tags": ["a", "b"]} for i in range(n)],
+                      separators=(",", ":"))
+
+
+def make_tweets(n):
+    statuses = []
+    for i in range(n):
+        statuses.append({
+            "created_at": "Sun Aug 31 00:29:15 +0000 2014",
+            "id": 505874924095815681 + i,
+            "text": "@aym0566x\n\nnamae: 前田あゆみ\tçğüş https://t.co/x",
+            "user": {"id": 1186275104 + i, "screen_name": "ayuu0123",
+                     "name": "あゆみ", "followers_count": 262,
+                     "verified": False,
+                     "description": "湖南中→定時制 \"quoted\" / Türkçe"},
+            "retweet_count": i % 7, "favorited": False, "hashtags": [],
+            "indices": [0, 22], "lang": "ja"})
+    return json.dumps({"statuses": statuses}, ensure_ascii=False,
+                      separators=(",", ":"))
+
+
+def measure(label, body, repeats):
+    best = float("inf")
+    for _ in range(repeats):
+        t0 = time.perf_counter()
+        v = json.loads(body)
+        best = min(best, time.perf_counter() - t0)
+    mb = len(body.encode("utf-8")) / 1e6
+    print("%s: %.2f MB, %.1f ms, %.1f MB/s (top-level items: %d)"
+          % (label, mb, best * 1000, mb / best, len(v)))
+
+
+repeats = int(os.environ.get("TULPAR_BENCH_REPEATS", "5") or 5)
+path = os.environ.get("TULPAR_JSON_FILE", "")
+if path:
+    with open(path, encoding="utf-8") as f:
+        measure(path, f.read(), repeats)
+else:
+    measure("twitter-like", make_tweets(20000), repeats)
+    measure("array-of-records", make_records(100000), repeats)
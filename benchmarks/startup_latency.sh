@@ -0,0 +1,40 @@
+#!/usr/bin/env bash
+# `tulpar run` startup latency: AOT (emit + link + exec /tmp/.tulpar_run)
+# vs in-process JIT (ORC LLJIT, O1). Reports the best wall time of N runs
+# for a hello-world and a ~200-line script.
+#
+# Usage: REPEATS=5 ./benchmarks/startup_latency.sh
+
+set -e
+cd "$(dirname "$0")/.."
+
+REPEATS="${REPEATS:-5}"
+TULPAR="${TULPAR:-./tulpar}"
+
+best_ms() {  # mode file
+    local mode="$1" file="$2"
+    local best="999999.999"
+    for ((i=0; i<REPEATS; i++)); do
+        local t0 t1 elapsed
+        t0=$EPOCHREALTIME
+        TULPAR_RUN_MODE="$mode" "$TULPAR" "$file" >/dev/null 2>&1
+        t1=$EPOCHREALTIME
+        elapsed=$(awk "BEGIN { printf \"%.3f\", ($t1 - $t0) * 1000 }")
+        if awk "BEGIN { exit !($elapsed < $best) }"; then
+            best=$elapsed
+        fi
+    done
+    echo "$best"
+}
+
+# Warm the page cache / runtime lookup once so the first row isn't penalised.
+"$TULPAR" benchmarks/startup_hello.tpr >/dev/null 2>&1 || true
+
+echo "| Script                  |   AOT (ms) |   JIT (ms) | Speedup |"
+echo "|-------------------------|-----------:|-----------:|--------:|"
+for f in benchmarks/startup_hello.tpr benchmarks/startup_200.tpr; do
+    aot=$(best_ms aot "$f")
+    jit=$(best_ms jit "$f")
+    printf '| %-23s | %10s | %10s | %6sx |\n' "$(basename "$f")" "$aot" "$jit" \
+        "$(awk "BEGIN { printf \"%.2f\", $aot / $jit }")"
+done
@@ -1,4 +1,4 @@
-// C reference for struct_array_push: 1M typed struct push + readback.
+// C reference for struct_array_push: 10M typed struct push + readback.
 // Same shape as the Tulpar version; uses dynamic array to mirror the
 // `array` resize path Tulpar's runtime takes (ObjArray's items vector
 // is realloc'd on capacity overflow). int64 fields match Tulpar's V3.
@@ -14,7 +14,7 @@ static V3 make_v3(long long a, long long b, long long c) {
 }
 
 int main(void) {
-    const int n = 1000000;
+    const int n = 10000000;
     V3 *points = (V3 *)malloc((size_t)n * sizeof(V3));
     if (!points) return 1;
 
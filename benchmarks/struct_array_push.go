@@ -7,7 +7,7 @@ type V3 struct {
 }
 
 func main() {
-	n := 1_000_000
+	n := 10_000_000
 	points := make([]V3, 0, n)
 	for i := 0; i < n; i++ {
 		points = append(points, V3{int64(i), int64(i) * 2, int64(i) * 3})
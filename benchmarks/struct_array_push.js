@@ -1,4 +1,4 @@
-const n = 1_000_000;
+const n = 10_000_000;
 const points = [];
 for (let i = 0; i < n; i++) {
     points.push({ x: i, y: i * 2, z: i * 3 });
@@ -1,4 +1,4 @@
-n = 1_000_000
+n = 10_000_000
 points = []
 for i in range(n):
     points.append((i, i * 2, i * 3))
@@ -5,7 +5,7 @@ struct V3 {
 }
 
 fn main() {
-    let n = 1_000_000;
+    let n = 10_000_000;
     let mut points = Vec::with_capacity(n);
     for i in 0..n as i64 {
         points.push(V3 { x: i, y: i * 2, z: i * 3 });
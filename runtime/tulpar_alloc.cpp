@@ -0,0 +1,492 @@
+// Tulpar small-object allocator - Implementation
+//
+// Obj headers and their payload tables (array items, object keys/values,
+// persisted strings, closures) are small, numerous and, under listen_pool,
+// allocated by many threads at once. glibc serves them from shared malloc
+// arenas that contend and fragment. Here every thread gets its own heap:
+//
+//   * 20 size classes, 16..1024 bytes; anything larger goes to malloc.
+//   * Memory comes in 64 KB spans carved from one reserved address range,
+//     so "is this block ours?" is a range check and a block's span header
+//     is found by masking the pointer.
+//   * A span belongs to one thread heap. The owner allocates and frees with
+//     plain loads and stores; a free from another thread pushes the block
+//     onto the span's lock-free remote list, which the owner collects once
+//     its local blocks run out.
+//   * A heap keeps a few empty spans resident for reuse and purges the rest
+//     (MADV_DONTNEED / MEM_RESET), so RSS follows the live set.
+//   * A heap outlives its thread: the next thread to start adopts it, and
+//     frees that arrive in between wait on the remote lists.
+//
+// wasm and 32-bit targets (no room for the reservation) and
+// `tulpar build --allocator=system` route every call straight to malloc.
+
+#include "tulpar_alloc.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+#if defined(__EMSCRIPTEN__) || UINTPTR_MAX <= 0xFFFFFFFFu
+#define TA_ENABLED 0
+#else
+#define TA_ENABLED 1
+#endif
+
+#if TA_ENABLED
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#endif
+
+static std::atomic<int> g_allocator{TULPAR_ALLOCATOR_TULPAR};
+
+#if TA_ENABLED
+
+#define TA_SPAN_SIZE ((size_t)64 * 1024)
+#define TA_SPAN_HEADER 128                     // blocks start here (16-aligned)
+#define TA_REGION_SIZE ((size_t)64 << 30)      // address space, reserved once
+#define TA_COMMIT_CHUNK ((size_t)4 << 20)      // committed 4 MB at a time
+#define TA_MAX_SMALL 1024
+#define TA_CLASS_COUNT 20
+#define TA_KEEP_EMPTY 4 // empty spans a heap keeps resident
+
+static const uint32_t k_class_size[TA_CLASS_COUNT] = {
+    16,  32,  48,  64,  80,  96,  112, 128, 160, 192,
+    224, 256, 320, 384, 448, 512, 640, 768, 896, 1024};
+static uint8_t g_class_of[TA_MAX_SMALL / 16 + 1]; // by (size + 15) >> 4
+
+enum : uint8_t { TA_SPAN_AVAIL, TA_SPAN_FULL, TA_SPAN_EMPTY };
+
+struct TaHeap;
+
+struct TaSpan {
+  TaHeap *heap;
+  TaSpan *prev;
+  TaSpan *next;       // class list (avail / full) or an empty list
+  void *free;         // owner-local free blocks
+  char *bump;         // start of the not yet carved tail
+  uint32_t block_size;
+  uint32_t used;      // blocks out; remote-freed ones count until collected
+  uint8_t cls;
+  std::atomic<uint8_t> state;
+  std::atomic<uint8_t> notified; // queued on heap->remote_spans
+  std::atomic<void *> remote;    // blocks freed by other threads
+  TaSpan *remote_next;
+};
+
+static_assert(sizeof(TaSpan) <= TA_SPAN_HEADER, "span header too large");
+
+struct TaHeap {
+  TaSpan *avail[TA_CLASS_COUNT]; // spans with free blocks; the head is current
+  TaSpan *full[TA_CLASS_COUNT];
+  TaSpan *empty;                 // resident, ready for any class
+  TaSpan *purged;                // pages returned to the OS
+  int empty_count;
+  // FULL spans that received a remote free since the owner last looked.
+  std::atomic<TaSpan *> remote_spans;
+  TaHeap *next_abandoned;
+};
+
+static char *g_base = nullptr;
+static size_t g_reserved = 0; // 0 until the region is reserved
+static size_t g_committed = 0;
+static size_t g_top = 0;
+static bool g_reserve_failed = false;
+static std::mutex g_mtx; // region growth + the abandoned-heap list
+static TaHeap *g_abandoned = nullptr;
+static size_t g_page = 4096;
+
+static std::atomic<int64_t> g_spans{0};
+static std::atomic<int64_t> g_purged_spans{0};
+static std::atomic<int64_t> g_remote_frees{0};
+static std::atomic<int64_t> g_heaps{0};
+
+static thread_local TaHeap *t_heap = nullptr;
+// Set once this thread's TaHeapRelease has run. Other thread_local
+// destructors may still allocate after that; they get plain malloc instead
+// of a fresh heap that nothing would hand back. Trivially destructible, so
+// it stays readable for the whole of thread exit.
+static thread_local bool t_heap_gone = false;
+
+static inline bool ta_owns(const void *p) {
+  return (uintptr_t)p - (uintptr_t)g_base < g_reserved;
+}
+
+static inline TaSpan *ta_span_of(const void *p) {
+  return (TaSpan *)((uintptr_t)p & ~(uintptr_t)(TA_SPAN_SIZE - 1));
+}
+
+// Doubly linked span lists.
+static void ta_list_push(TaSpan **head, TaSpan *s) {
+  s->prev = nullptr;
+  s->next = *head;
+  if (*head)
+    (*head)->prev = s;
+  *head = s;
+}
+
+static void ta_list_remove(TaSpan **head, TaSpan *s) {
+  if (s->prev)
+    s->prev->next = s->next;
+  else
+    *head = s->next;
+  if (s->next)
+    s->next->prev = s->prev;
+  s->prev = s->next = nullptr;
+}
+
+// Called with g_mtx held.
+static bool ta_reserve(void) {
+  if (g_reserved || g_reserve_failed)
+    return g_reserved != 0;
+  for (int c = 0, i = 0; i <= TA_MAX_SMALL / 16; i++) {
+    while (k_class_size[c] < (uint32_t)i * 16)
+      c++;
+    g_class_of[i] = (uint8_t)c;
+  }
+#ifdef _WIN32
+  // Reservations are 64 KB aligned (allocation granularity).
+  void *p = VirtualAlloc(nullptr, TA_REGION_SIZE, MEM_RESERVE, PAGE_NOACCESS);
+  if (!p) {
+    g_reserve_failed = true;
+    return false;
+  }
+  g_base = (char *)p;
+#else
+  g_page = (size_t)sysconf(_SC_PAGESIZE);
+  void *p = mmap(nullptr, TA_REGION_SIZE + TA_SPAN_SIZE, PROT_NONE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (p == MAP_FAILED) {
+    g_reserve_failed = true;
+    return false;
+  }
+  uintptr_t aligned =
+      ((uintptr_t)p + TA_SPAN_SIZE - 1) & ~(uintptr_t)(TA_SPAN_SIZE - 1);
+  g_base = (char *)aligned;
+#endif
+  g_reserved = TA_REGION_SIZE;
+  return true;
+}
+
+// A fresh span from the region, or nullptr once it is exhausted.
+static TaSpan *ta_region_span(void) {
+  std::lock_guard<std::mutex> lock(g_mtx);
+  if (g_top + TA_SPAN_SIZE > g_committed) {
+    if (g_committed + TA_COMMIT_CHUNK > g_reserved)
+      return nullptr;
+#ifdef _WIN32
+    if (!VirtualAlloc(g_base + g_committed, TA_COMMIT_CHUNK, MEM_COMMIT,
+                      PAGE_READWRITE))
+      return nullptr;
+#else
+    if (mprotect(g_base + g_committed, TA_COMMIT_CHUNK,
+                 PROT_READ | PROT_WRITE) != 0)
+      return nullptr;
+#endif
+    g_committed += TA_COMMIT_CHUNK;
+  }
+  TaSpan *s = new (g_base + g_top) TaSpan();
+  g_top += TA_SPAN_SIZE;
+  g_spans++;
+  return s;
+}
+
+// Give an empty span's pages (all but the header page) back to the OS. The
+// mapping stays, so reusing the span just faults zero pages back in.
+static void ta_purge(TaSpan *s) {
+  size_t off = (TA_SPAN_HEADER + g_page - 1) & ~(g_page - 1);
+  if (off >= TA_SPAN_SIZE)
+    return;
+#ifdef _WIN32
+  VirtualAlloc((char *)s + off, TA_SPAN_SIZE - off, MEM_RESET, PAGE_READWRITE);
+#else
+  madvise((char *)s + off, TA_SPAN_SIZE - off, MADV_DONTNEED);
+#endif
+  g_purged_spans++;
+}
+
+struct TaHeapRelease {
+  ~TaHeapRelease() {
+    t_heap_gone = true;
+    if (!t_heap)
+      return;
+    std::lock_guard<std::mutex> lock(g_mtx);
+    t_heap->next_abandoned = g_abandoned;
+    g_abandoned = t_heap;
+    t_heap = nullptr;
+  }
+};
+static thread_local TaHeapRelease t_heap_release;
+
+static TaHeap *ta_heap_acquire(void) {
+  std::lock_guard<std::mutex> lock(g_mtx);
+  if (!ta_reserve()) {
+    g_allocator.store(TULPAR_ALLOCATOR_SYSTEM, std::memory_order_relaxed);
+    return nullptr;
+  }
+  TaHeap *h = g_abandoned;
+  if (h) {
+    g_abandoned = h->next_abandoned;
+    h->next_abandoned = nullptr;
+  } else {
+    h = new (std::nothrow) TaHeap();
+    if (!h)
+      return nullptr;
+    g_heaps++;
+  }
+  (void)&t_heap_release; // registers the thread-exit hand-back
+  t_heap = h;
+  return h;
+}
+
+static void *ta_span_take(TaSpan *s) {
+  void *p = s->free;
+  if (p) {
+    s->free = *(void **)p;
+    s->used++;
+    return p;
+  }
+  if (s->bump + s->block_size <= (char *)s + TA_SPAN_SIZE) {
+    p = s->bump;
+    s->bump += s->block_size;
+    s->used++;
+    return p;
+  }
+  p = s->remote.exchange(nullptr, std::memory_order_acquire);
+  if (p) {
+    uint32_t n = 0;
+    for (void *q = p; q; q = *(void **)q)
+      n++;
+    s->used -= n;
+    s->free = *(void **)p;
+    s->used++;
+    return p;
+  }
+  return nullptr;
+}
+
+// Park an exhausted span on the full list. A remote free that lands while
+// the state flips is caught by one side or the other: the freer reads the
+// state after publishing its block, the owner reads the remote list after
+// publishing FULL (both sequentially consistent).
+static void ta_span_retire(TaHeap *h, TaSpan *s) {
+  ta_list_remove(&h->avail[s->cls], s);
+  s->state.store(TA_SPAN_FULL);
+  if (s->remote.load() != nullptr) {
+    s->state.store(TA_SPAN_AVAIL);
+    ta_list_push(&h->avail[s->cls], s);
+    return;
+  }
+  ta_list_push(&h->full[s->cls], s);
+}
+
+// Move FULL spans that other threads freed into back to the avail lists.
+static bool ta_reclaim_remote(TaHeap *h) {
+  TaSpan *s = h->remote_spans.exchange(nullptr, std::memory_order_acquire);
+  bool any = false;
+  while (s) {
+    TaSpan *next = s->remote_next; // read before a freer can re-queue s
+    s->notified.store(0);
+    if (s->state.load(std::memory_order_relaxed) == TA_SPAN_FULL) {
+      ta_list_remove(&h->full[s->cls], s);
+      s->state.store(TA_SPAN_AVAIL, std::memory_order_relaxed);
+      ta_list_push(&h->avail[s->cls], s);
+      any = true;
+    }
+    s = next;
+  }
+  return any;
+}
+
+static TaSpan *ta_span_new(TaHeap *h, int cls) {
+  TaSpan *s = h->empty;
+  if (s) {
+    ta_list_remove(&h->empty, s);
+    h->empty_count--;
+  } else if ((s = h->purged) != nullptr) {
+    ta_list_remove(&h->purged, s);
+  } else if ((s = ta_region_span()) == nullptr) {
+    return nullptr;
+  }
+  // A reused span may still sit on remote_spans from an old life
+  // (notified / remote_next); reclaim ignores it unless it is FULL.
+  s->heap = h;
+  s->free = nullptr;
+  s->bump = (char *)s + TA_SPAN_HEADER;
+  s->block_size = k_class_size[cls];
+  s->used = 0;
+  s->cls = (uint8_t)cls;
+  s->state.store(TA_SPAN_AVAIL, std::memory_order_relaxed);
+  ta_list_push(&h->avail[cls], s);
+  return s;
+}
+
+static void *ta_alloc_slow(TaHeap *h, int cls) {
+  for (;;) {
+    TaSpan *s;
+    while ((s = h->avail[cls]) != nullptr) {
+      void *p = ta_span_take(s);
+      if (p)
+        return p;
+      ta_span_retire(h, s);
+    }
+    if (ta_reclaim_remote(h) && h->avail[cls])
+      continue;
+    s = ta_span_new(h, cls);
+    return s ? ta_span_take(s) : nullptr;
+  }
+}
+
+// The last block of a span came home. The current span of its class stays
+// put; any other goes to the heap's empty list, purged beyond the first few.
+static void ta_span_emptied(TaHeap *h, TaSpan *s) {
+  if (s == h->avail[s->cls])
+    return;
+  uint8_t st = s->state.load(std::memory_order_relaxed);
+  ta_list_remove(st == TA_SPAN_FULL ? &h->full[s->cls] : &h->avail[s->cls], s);
+  s->state.store(TA_SPAN_EMPTY);
+  if (h->empty_count < TA_KEEP_EMPTY) {
+    ta_list_push(&h->empty, s);
+    h->empty_count++;
+  } else {
+    ta_purge(s);
+    ta_list_push(&h->purged, s);
+  }
+}
+
+static void ta_free_remote(TaSpan *s, void *p) {
+  void *head = s->remote.load(std::memory_order_relaxed);
+  do {
+    *(void **)p = head;
+  } while (!s->remote.compare_exchange_weak(head, p));
+  g_remote_frees.fetch_add(1, std::memory_order_relaxed);
+  // The owner no longer looks at FULL spans by itself; queue this one.
+  if (s->state.load() == TA_SPAN_FULL && s->notified.exchange(1) == 0) {
+    TaHeap *owner = s->heap;
+    TaSpan *top = owner->remote_spans.load(std::memory_order_relaxed);
+    do {
+      s->remote_next = top;
+    } while (!owner->remote_spans.compare_exchange_weak(
+        top, s, std::memory_order_release, std::memory_order_relaxed));
+  }
+}
+
+#endif // TA_ENABLED
+
+extern "C" {
+
+void *tulpar_malloc(size_t size) {
+#if TA_ENABLED
+  if (size <= TA_MAX_SMALL &&
+      g_allocator.load(std::memory_order_relaxed) == TULPAR_ALLOCATOR_TULPAR) {
+    TaHeap *h = t_heap;
+    if (!h && !t_heap_gone)
+      h = ta_heap_acquire();
+    if (h) {
+      int cls = g_class_of[(size + 15) >> 4];
+      TaSpan *s = h->avail[cls];
+      if (s && s->free) {
+        void *p = s->free;
+        s->free = *(void **)p;
+        s->used++;
+        return p;
+      }
+      void *p = ta_alloc_slow(h, cls);
+      if (p)
+        return p;
+    }
+  }
+#endif
+  return malloc(size);
+}
+
+void tulpar_free(void *ptr) {
+  if (!ptr)
+    return;
+#if TA_ENABLED
+  if (ta_owns(ptr)) {
+    TaSpan *s = ta_span_of(ptr);
+    TaHeap *h = t_heap;
+    if (s->heap != h) {
+      ta_free_remote(s, ptr);
+      return;
+    }
+    *(void **)ptr = s->free;
+    s->free = ptr;
+    if (--s->used == 0) {
+      ta_span_emptied(h, s);
+    } else if (s->state.load(std::memory_order_relaxed) == TA_SPAN_FULL) {
+      ta_list_remove(&h->full[s->cls], s);
+      s->state.store(TA_SPAN_AVAIL, std::memory_order_relaxed);
+      ta_list_push(&h->avail[s->cls], s);
+    }
+    return;
+  }
+#endif
+  free(ptr);
+}
+
+void *tulpar_realloc(void *ptr, size_t size) {
+  if (!ptr)
+    return tulpar_malloc(size);
+#if TA_ENABLED
+  if (ta_owns(ptr)) {
+    size_t have = ta_span_of(ptr)->block_size;
+    if (size <= have)
+      return ptr;
+    void *grown = tulpar_malloc(size);
+    if (!grown)
+      return nullptr;
+    memcpy(grown, ptr, have);
+    tulpar_free(ptr);
+    return grown;
+  }
+#endif
+  return realloc(ptr, size);
+}
+
+void tulpar_alloc_select(int allocator) {
+  g_allocator.store(allocator == TULPAR_ALLOCATOR_SYSTEM
+                        ? TULPAR_ALLOCATOR_SYSTEM
+                        : TULPAR_ALLOCATOR_TULPAR,
+                    std::memory_order_relaxed);
+}
+
+int tulpar_alloc_selected(void) {
+#if TA_ENABLED
+  return g_allocator.load(std::memory_order_relaxed);
+#else
+  return TULPAR_ALLOCATOR_SYSTEM;
+#endif
+}
+
+void tulpar_alloc_get_stats(TulparAllocStats *out) {
+  if (!out)
+    return;
+  memset(out, 0, sizeof(*out));
+#if TA_ENABLED
+  out->spans = g_spans.load();
+  {
+    std::lock_guard<std::mutex> lock(g_mtx);
+    out->committed_bytes = (int64_t)g_committed;
+  }
+  out->purged_spans = g_purged_spans.load();
+  out->remote_frees = g_remote_frees.load();
+  out->heaps = g_heaps.load();
+#endif
+  out->allocator = tulpar_alloc_selected();
+}
+
+} // extern "C"
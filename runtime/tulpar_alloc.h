@@ -0,0 +1,46 @@
+// Tulpar small-object allocator
+// Thread-caching heaps for Obj headers and their payload tables
+
+#ifndef TULPAR_ALLOC_H
+#define TULPAR_ALLOC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Which allocator tulpar_malloc uses. `tulpar build --allocator=system`
+// emits tulpar_alloc_select(TULPAR_ALLOCATOR_SYSTEM) at the top of main.
+#define TULPAR_ALLOCATOR_TULPAR 0
+#define TULPAR_ALLOCATOR_SYSTEM 1
+
+// malloc / realloc / free for runtime objects. tulpar_free and
+// tulpar_realloc also accept pointers that came from plain malloc, so
+// every Obj free site goes through them regardless of who allocated.
+void *tulpar_malloc(size_t size);
+void *tulpar_realloc(void *ptr, size_t size);
+void tulpar_free(void *ptr);
+
+// Switch the allocator for later allocations; blocks already handed out
+// stay valid and are freed by their owner.
+void tulpar_alloc_select(int allocator);
+int tulpar_alloc_selected(void);
+
+typedef struct {
+  int64_t spans;          // 64 KB spans carved from the reserved region
+  int64_t committed_bytes;
+  int64_t purged_spans;   // empty spans given back to the OS (cumulative)
+  int64_t remote_frees;   // blocks freed by a thread other than the owner
+  int64_t heaps;          // thread heaps created (reused after thread exit)
+  int allocator;          // TULPAR_ALLOCATOR_*
+} TulparAllocStats;
+
+void tulpar_alloc_get_stats(TulparAllocStats *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TULPAR_ALLOC_H
@@ -2,9 +2,56 @@
 // High-performance memory management with Move Semantics
 
 #include "tulpar_arc.h"
+#include "tulpar_alloc.h"
 #include "../src/vm/vm.hpp"
 #include <cstdio>
+#include <atomic>
 #include <cstring>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// ============================================================================
+// Shared-bit ("biased") reference counting
+// ============================================================================
+//
+// A plain `ref_count++` is a load/add/store; two threads retaining the same
+// object can lose an update, and the object is then freed while still in use
+// (or never freed). Making every count atomic would put a locked instruction
+// on the single-threaded fast path, where nearly all objects live.
+//
+// Instead each object carries `is_shared`. Objects start thread-owned
+// (is_shared = 0) and use plain increments. An object becomes shared when it
+// can be reached from another thread:
+//   * aot_persist / string_pin copies (what globals hold once a request
+//     stores into them) are created shared;
+//   * a top-level global's initial value, a value stored into a shared
+//     container (runtime write barrier) and a thread_create argument go
+//     through arc_share.
+// Shared objects use atomic add/sub. The bit is sticky and arc_share marks
+// everything reachable, so no thread-owned object ever hangs off a shared
+// one. Arena objects are not counted at all; arc_share still walks through
+// them to reach malloc'd children.
+
+#if defined(_MSC_VER) && !defined(__clang__)
+static inline void rc_atomic_inc(int32_t *rc) {
+  _InterlockedIncrement(reinterpret_cast<volatile long *>(rc));
+}
+static inline int32_t rc_atomic_dec(int32_t *rc) {
+  return _InterlockedDecrement(reinterpret_cast<volatile long *>(rc));
+}
+#else
+static inline void rc_atomic_inc(int32_t *rc) {
+  __atomic_add_fetch(rc, 1, __ATOMIC_RELAXED);
+}
+// acq_rel: the thread that drops the last reference must see every other
+// thread's writes to the object before freeing it.
+static inline int32_t rc_atomic_dec(int32_t *rc) {
+  return __atomic_sub_fetch(rc, 1, __ATOMIC_ACQ_REL);
+}
+#endif
 
 // ============================================================================
 // EXTERN "C" BLOCK - ARC Runtime (called from LLVM compiled code)
@@ -20,7 +67,10 @@ extern "C" {
 
 void arc_retain(Obj *obj) {
   if (obj && !obj->arena_allocated) {
-    obj->ref_count++;
+    if (obj->is_shared)
+      rc_atomic_inc(&obj->ref_count);
+    else
+      obj->ref_count++;
 #ifdef TULPAR_DEBUG
     arc_retain_count++;
 #endif
@@ -29,13 +79,13 @@ void arc_retain(Obj *obj) {
 
 void arc_move(Obj **src) {
   if (src && *src) {
-    (*src)->is_moved = 1;
+    (*src)->is_moved |= OBJ_MOVED;
     *src = nullptr;  // nullptr out source
   }
 }
 
 int arc_is_valid(Obj *obj) {
-  return obj != nullptr && !obj->is_moved;
+  return obj != nullptr && !(obj->is_moved & OBJ_MOVED);
 }
 
 // ============================================================================
@@ -59,18 +109,111 @@ int arc_get_live_count(void) {
 }
 #endif
 
+// ============================================================================
+// Deferred, iterative freeing
+// ============================================================================
+//
+// Dropping the last reference to a container used to free it recursively:
+// arc_free_array -> arc_release(child) -> arc_free_object -> ... A deeply
+// nested json overflowed the C stack, and a big one (1M-element list of
+// dicts from fromJson) froze the request that happened to release it.
+//
+// Now a release that reaches zero pushes the object onto a per-thread
+// worklist. Freeing an object only decrements its children and queues the
+// ones that reach zero, so the drain loop is flat regardless of depth.
+//
+// By default the drain runs to completion inside that arc_release (same
+// observable timing as before, minus the recursion). With a free budget
+// (TULPAR_ARC_FREE_BUDGET=<objects>, or arc_set_free_budget) one release frees
+// at most that many objects and leaves the rest queued; the next release on
+// the thread continues, and arena_restore (end of request) / arc_drain()
+// flush whatever is left. arc_stats() reports the queued ("deferred") bytes.
+
+static thread_local std::vector<Obj *> t_free_pending;
+static thread_local bool t_draining = false;
+
+static int g_free_budget = -1; // -1: not read from the environment yet
+static std::atomic<int64_t> g_freed_objects{0};
+static std::atomic<int64_t> g_freed_bytes{0};
+static std::atomic<int64_t> g_pending_objects{0};
+static std::atomic<int64_t> g_pending_bytes{0};
+static std::atomic<int64_t> g_deferred_releases{0};
+
+static int arc_free_budget(void) {
+  if (g_free_budget < 0) {
+    const char *env = getenv("TULPAR_ARC_FREE_BUDGET");
+    int v = env ? atoi(env) : 0;
+    g_free_budget = v > 0 ? v : 0;
+  }
+  return g_free_budget;
+}
+
+void arc_set_free_budget(int max_objects) {
+  g_free_budget = max_objects > 0 ? max_objects : 0;
+}
+
+// Bytes an object owns on the malloc heap (header + separately allocated
+// payload), for the freed / deferred counters.
+static size_t arc_obj_bytes(Obj *obj) {
+  switch (obj->type) {
+  case OBJ_STRING:
+    return sizeof(ObjString) + (size_t)((ObjString *)obj)->capacity;
+  case OBJ_ARRAY:
+    return sizeof(ObjArray) +
+           (size_t)((ObjArray *)obj)->capacity * sizeof(VMValue);
+  case OBJ_OBJECT:
+    return sizeof(ObjObject) + (size_t)((ObjObject *)obj)->capacity *
+                                   (sizeof(VMValue) + sizeof(ObjString *));
+  case OBJ_CLOSURE:
+    return sizeof(ObjClosure);
+  default:
+    return sizeof(Obj);
+  }
+}
+
+static void arc_queue_free(Obj *obj) {
+  t_free_pending.push_back(obj);
+  g_pending_objects.fetch_add(1, std::memory_order_relaxed);
+  g_pending_bytes.fetch_add((int64_t)arc_obj_bytes(obj),
+                            std::memory_order_relaxed);
+}
+
+// Drop one reference; returns 1 when it was the last.
+static int arc_drop_ref(Obj *obj) {
+  int32_t left = obj->is_shared ? rc_atomic_dec(&obj->ref_count)
+                                : --obj->ref_count;
+  return left <= 0;
+}
+
+// Release a child of an object being freed: queue it instead of recursing.
+static void arc_release_child(Obj *child) {
+  if (!child || child->arena_allocated) return;
+#ifdef TULPAR_DEBUG
+  arc_release_count++;
+#endif
+  if (arc_drop_ref(child)) arc_queue_free(child);
+}
+
+static void arc_release_child_value(VMValue v) {
+  if (IS_OBJ(v)) arc_release_child(AS_OBJ(v));
+}
+
 // ============================================================================
 // Type-Specific Free Functions
 // ============================================================================
+//
+// Each frees the object's own memory and hands its children to the worklist;
+// called directly (not from a drain) they also drain what they queued.
+
+static void arc_drain_after_free(void) {
+  if (!t_draining) arc_drain(0);
+}
 
 void arc_free_string(Obj *obj) {
   if (!obj) return;
-  ObjString *str = (ObjString *)obj;
-  if (str->chars && !obj->arena_allocated) {
-    free(str->chars);
-  }
   if (!obj->arena_allocated) {
-    free(str);
+    // chars are inline after the header: one block.
+    tulpar_free(obj);
 #ifdef TULPAR_DEBUG
     arc_free_count++;
 #endif
@@ -80,75 +223,130 @@ void arc_free_string(Obj *obj) {
 void arc_free_array(Obj *obj) {
   if (!obj) return;
   ObjArray *arr = (ObjArray *)obj;
-  
-  // Release all items in array
+
   if (arr->items) {
     for (int i = 0; i < arr->count; i++) {
-      if (IS_OBJ(arr->items[i])) {
-        arc_release(AS_OBJ(arr->items[i]));
-      }
+      arc_release_child_value(arr->items[i]);
     }
     if (!obj->arena_allocated) {
-      free(arr->items);
+      tulpar_free(arr->items);
     }
   }
-  
+
   if (!obj->arena_allocated) {
-    free(arr);
+    tulpar_free(arr);
 #ifdef TULPAR_DEBUG
     arc_free_count++;
 #endif
   }
+  arc_drain_after_free();
 }
 
 void arc_free_object(Obj *obj) {
   if (!obj) return;
   ObjObject *object = (ObjObject *)obj;
-  
-  // Release all values
+
   if (object->values) {
     for (int i = 0; i < object->count; i++) {
-      if (IS_OBJ(object->values[i])) {
-        arc_release(AS_OBJ(object->values[i]));
-      }
+      arc_release_child_value(object->values[i]);
     }
     if (!obj->arena_allocated) {
-      free(object->values);
+      tulpar_free(object->values);
     }
   }
-  
-  // Free keys (strings)
+
+  // Keys are strings too
   if (object->keys) {
     for (int i = 0; i < object->count; i++) {
-      if (object->keys[i]) {
-        arc_release((Obj *)object->keys[i]);
-      }
+      arc_release_child((Obj *)object->keys[i]);
     }
     if (!obj->arena_allocated) {
-      free(object->keys);
+      tulpar_free(object->keys);
     }
   }
-  
+
   if (!obj->arena_allocated) {
-    free(object);
+    tulpar_free(object);
 #ifdef TULPAR_DEBUG
     arc_free_count++;
 #endif
   }
+  arc_drain_after_free();
 }
 
 void arc_free_closure(Obj *obj) {
   if (!obj) return;
   ObjClosure *closure = (ObjClosure *)obj;
-  if (closure->env) {
-    arc_release((Obj *)closure->env);
-  }
+  arc_release_child((Obj *)closure->env);
   if (!obj->arena_allocated) {
-    free(closure);
+    tulpar_free(closure);
 #ifdef TULPAR_DEBUG
     arc_free_count++;
 #endif
   }
+  arc_drain_after_free();
+}
+
+static void arc_free_now(Obj *obj) {
+  switch (obj->type) {
+  case OBJ_STRING:
+    arc_free_string(obj);
+    break;
+  case OBJ_ARRAY:
+    arc_free_array(obj);
+    break;
+  case OBJ_OBJECT:
+    arc_free_object(obj);
+    break;
+  case OBJ_CLOSURE:
+    arc_free_closure(obj);
+    break;
+  case OBJ_FUNCTION:
+    // Functions are usually static, don't free
+    break;
+  default:
+    // Unknown type - just free the base
+    tulpar_free(obj);
+#ifdef TULPAR_DEBUG
+    arc_free_count++;
+#endif
+    break;
+  }
+}
+
+// Free up to `max_objects` queued objects on this thread (<= 0: all of them,
+// including whatever those frees queue). Returns how many were freed.
+int arc_drain(int max_objects) {
+  if (t_draining) return 0;
+  t_draining = true;
+  int freed = 0;
+  int64_t bytes = 0;
+  while (!t_free_pending.empty() && (max_objects <= 0 || freed < max_objects)) {
+    Obj *obj = t_free_pending.back();
+    t_free_pending.pop_back();
+    size_t b = arc_obj_bytes(obj);
+    g_pending_objects.fetch_sub(1, std::memory_order_relaxed);
+    g_pending_bytes.fetch_sub((int64_t)b, std::memory_order_relaxed);
+    arc_free_now(obj);
+    bytes += (int64_t)b;
+    freed++;
+  }
+  t_draining = false;
+  if (freed) {
+    g_freed_objects.fetch_add(freed, std::memory_order_relaxed);
+    g_freed_bytes.fetch_add(bytes, std::memory_order_relaxed);
+  }
+  return freed;
+}
+
+void arc_get_stats(ArcStats *out) {
+  if (!out) return;
+  out->freed_objects = g_freed_objects.load(std::memory_order_relaxed);
+  out->freed_bytes = g_freed_bytes.load(std::memory_order_relaxed);
+  out->pending_objects = g_pending_objects.load(std::memory_order_relaxed);
+  out->pending_bytes = g_pending_bytes.load(std::memory_order_relaxed);
+  out->deferred_releases = g_deferred_releases.load(std::memory_order_relaxed);
+  out->free_budget = arc_free_budget();
 }
 
 // ============================================================================
@@ -157,41 +355,61 @@ void arc_free_closure(Obj *obj) {
 
 void arc_release(Obj *obj) {
   if (!obj) return;
-  
+
   // Arena allocated objects are freed in bulk
   if (obj->arena_allocated) return;
-  
+
 #ifdef TULPAR_DEBUG
   arc_release_count++;
 #endif
-  
-  obj->ref_count--;
-  
-  if (obj->ref_count <= 0) {
-    // Free based on type
-    switch (obj->type) {
-      case OBJ_STRING:
-        arc_free_string(obj);
-        break;
-      case OBJ_ARRAY:
-        arc_free_array(obj);
-        break;
-      case OBJ_OBJECT:
-        arc_free_object(obj);
-        break;
-      case OBJ_CLOSURE:
-        arc_free_closure(obj);
-        break;
-      case OBJ_FUNCTION:
-        // Functions are usually static, don't free
-        break;
-      default:
-        // Unknown type - just free the base
-        free(obj);
-#ifdef TULPAR_DEBUG
-        arc_free_count++;
-#endif
-        break;
+
+  if (!arc_drop_ref(obj)) return;
+  arc_queue_free(obj);
+  if (t_draining) return; // an enclosing drain on this thread picks it up
+  arc_drain(arc_free_budget());
+  if (!t_free_pending.empty())
+    g_deferred_releases.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Mark `obj` and everything reachable from it shared. Stops at objects that
+// already are (the bit is sticky), so sharing a structure repeatedly costs
+// one header check; an explicit stack keeps deep nesting off the C stack.
+void arc_share(Obj *obj) {
+  if (!obj || obj->is_shared) return;
+  std::vector<Obj *> pending;
+  pending.push_back(obj);
+  while (!pending.empty()) {
+    Obj *o = pending.back();
+    pending.pop_back();
+    if (!o || o->is_shared) continue;
+    o->is_shared = 1;
+    switch (o->type) {
+    case OBJ_ARRAY: {
+      ObjArray *arr = (ObjArray *)o;
+      for (int i = 0; arr->items && i < arr->count; i++)
+        if (IS_OBJ(arr->items[i])) pending.push_back(AS_OBJ(arr->items[i]));
+      break;
+    }
+    case OBJ_OBJECT: {
+      ObjObject *object = (ObjObject *)o;
+      for (int i = 0; i < object->count; i++) {
+        if (object->keys && object->keys[i])
+          pending.push_back((Obj *)object->keys[i]);
+        if (object->values && IS_OBJ(object->values[i]))
+          pending.push_back(AS_OBJ(object->values[i]));
+      }
+      break;
+    }
+    case OBJ_CLOSURE:
+      pending.push_back((Obj *)((ObjClosure *)o)->env);
+      break;
+    case OBJ_PROMISE: {
+      ObjPromise *p = (ObjPromise *)o;
+      if (IS_OBJ(p->value)) pending.push_back(AS_OBJ(p->value));
+      break;
+    }
+    default:
+      break;
     }
   }
 }
@@ -202,7 +420,7 @@ void arc_release(Obj *obj) {
 
 void arc_scope_exit(Obj **objects, int count) {
   for (int i = 0; i < count; i++) {
-    if (objects[i] && !objects[i]->is_moved) {
+    if (objects[i] && !(objects[i]->is_moved & OBJ_MOVED)) {
       arc_release(objects[i]);
     }
   }
@@ -226,6 +444,13 @@ void arc_release_vmvalue(VMValue *val) {
   }
 }
 
+// Share a VMValue's object graph (see arc_share)
+void arc_share_vmvalue(VMValue *val) {
+  if (val && IS_OBJ(*val)) {
+    arc_share(AS_OBJ(*val));
+  }
+}
+
 // Move a VMValue - transfer ownership
 void arc_move_vmvalue(VMValue *src, VMValue *dst) {
   if (!src || !dst) return;
@@ -235,26 +460,23 @@ void arc_move_vmvalue(VMValue *src, VMValue *dst) {
   
   // Mark source as moved (don't release on scope exit)
   if (IS_OBJ(*src)) {
-    AS_OBJ(*src)->is_moved = 1;
+    AS_OBJ(*src)->is_moved |= OBJ_MOVED;
   }
   
   // Clear source
-  src->type = VM_VAL_VOID;
-  src->as.obj = nullptr;
+  *src = VM_VOID();
 }
 
 ObjClosure* aot_create_closure(void *func_ptr, ObjArray *env, int arity) {
-  ObjClosure *closure = (ObjClosure *)malloc(sizeof(ObjClosure));
+  ObjClosure *closure = (ObjClosure *)tulpar_malloc(sizeof(ObjClosure));
   closure->obj.type = OBJ_CLOSURE;
   closure->obj.arena_allocated = 0;
+  closure->obj.is_shared = 0;
   closure->obj.ref_count = 1;
   closure->obj.is_moved = 0;
-  closure->obj.next = nullptr;
   closure->func_ptr = func_ptr;
   closure->env = env;
-  if (env) {
-    env->obj.ref_count++;
-  }
+  arc_retain((Obj *)env);
   closure->arity = arity;
   return closure;
 }
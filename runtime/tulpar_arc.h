@@ -48,6 +48,45 @@ void arc_free_object(Obj *obj);
 // Called at end of scope to release all locals
 void arc_scope_exit(Obj **objects, int count);
 
+// ============================================================================
+// Deferred Freeing
+// ============================================================================
+
+// Objects whose count reached zero wait on a per-thread worklist and are
+// freed iteratively (no recursion into children). By default each release
+// drains the list completely; with a budget it frees at most that many
+// objects per release and leaves the rest for later.
+
+// Free up to max_objects queued objects on this thread (<= 0: all).
+// Call when: end of a request (aot_arena_restore does), or idle time.
+// Returns the number of objects freed.
+int arc_drain(int max_objects);
+
+// Objects freed per release; 0 = unlimited (the default, also used when
+// TULPAR_ARC_FREE_BUDGET is unset).
+void arc_set_free_budget(int max_objects);
+
+typedef struct {
+  int64_t freed_objects;     // total, all threads
+  int64_t freed_bytes;
+  int64_t pending_objects;   // queued right now, all threads
+  int64_t pending_bytes;     // "deferred bytes"
+  int64_t deferred_releases; // releases that returned with work still queued
+  int free_budget;
+} ArcStats;
+
+void arc_get_stats(ArcStats *out);
+
+// ============================================================================
+// Thread Sharing
+// ============================================================================
+
+// Mark obj and everything reachable from it shared: from then on its
+// retain/release are atomic. Call when: a value becomes reachable from a
+// global or is handed to another thread. Thread-owned objects (the default)
+// keep plain, non-atomic counts.
+void arc_share(Obj *obj);
+
 // ============================================================================
 // Debug Functions
 // ============================================================================
@@ -36,6 +36,7 @@
 
 #include "tulpar_async.h"
 #include "tulpar_arc.h"
+#include "tulpar_eh.h"
 
 #include <cstdlib>
 #include <cstring>
@@ -72,7 +73,7 @@ void arc_retain_vmvalue(VMValue *val);
 void arc_release_vmvalue(VMValue *val);
 // Exception-handler runtime (src/vm/runtime_bindings.cpp). Coroutines get their
 // own handler context so an uncaught throw rejects the promise instead of
-// longjmp'ing across stacks; await re-raises a rejection in the awaiter.
+// escaping across stacks; await re-raises a rejection in the awaiter.
 jmp_buf *aot_try_push(void);
 void aot_try_pop(void);
 void aot_throw_ptr(VMValue *exception_ptr);
@@ -153,9 +154,7 @@ long long now_ms() {
 // Invoke a top-level user function via the AOT ABI:
 //   void fn(VMValue* ret, VMValue* arg0, VMValue* arg1, ...)
 VMValue call_user_fn(void *fn, VMValue *a, int argc) {
-  VMValue r;
-  r.type = VM_VAL_VOID;
-  r.as.int_val = 0;
+  VMValue r = VM_VOID();
   switch (argc) {
     case 0: ((void (*)(VMValue *))fn)(&r); break;
     case 1: ((void (*)(VMValue *, VMValue *))fn)(&r, &a[0]); break;
@@ -195,44 +194,63 @@ VMValue gather_body(GatherState *gs) {
   for (int i = 0; i < gs->n; i++) arc_release_vmvalue(&gs->items[i]);
   free(gs->items);
   delete gs;
-  VMValue out;
-  out.type = VM_VAL_OBJ;
-  out.as.obj = (Obj *)arr;
-  return out;
+  return VM_OBJ(arr);
+}
+
+// An uncaught throw reached the coroutine root — reject with the thrown
+// value. gather_body frees its state on the normal path; on this reject path
+// the throw skipped that, so do the equivalent cleanup (release the retained
+// child args and the partial result array, free the state).
+void task_reject(Task *t, VMValue exception) {
+  if (t->gather) {
+    GatherState *gs = t->gather;
+    for (int i = 0; i < gs->n; i++) arc_release_vmvalue(&gs->items[i]);
+    if (gs->arr) {
+      VMValue av = VM_OBJ(gs->arr);
+      arc_release_vmvalue(&av); // drops gather's own ref → frees the array
+    }
+    free(gs->items);
+    delete gs;
+    t->gather = nullptr;
+  }
+  t->done = true;
+  aot_promise_settle(t->result, exception, /*rejected*/ 2);
 }
 
 // The body every coroutine runs: call the user function, fulfil the promise.
-// A root try-frame catches any throw the user code didn't handle and settles
-// the promise *rejected* (state 2) instead of letting longjmp escape the
-// coroutine. The coroutine's own EH context is already active here (resume()
-// swapped it in), so this frame and any nested user try/catch share it.
+// A root handler catches any throw the user code didn't handle and settles
+// the promise *rejected* (state 2) instead of letting it escape the
+// coroutine. With zero-cost EH that is a plain C++ catch — the unwinder walks
+// this coroutine's own stack and stops here. Under the setjmp lowering it is a
+// root try-frame in the coroutine's EH context (resume() swapped it in), so
+// this frame and any nested user try/catch share it.
 void task_body(Task *t) {
+#if TULPAR_EH_UNWIND
+  VMValue rv;
+  bool threw = false;
+  try {
+    rv = t->gather ? gather_body(t->gather)
+                   : call_user_fn(t->fn, t->args, t->argc);
+  } catch (const TulparThrow &e) {
+    rv = e.value;
+    threw = true;
+  }
+  // Settle outside the handler: settling wakes awaiters, and nothing should
+  // run with a C++ exception still "being handled" on this stack.
+  if (threw) {
+    task_reject(t, rv);
+    return;
+  }
+#else
   jmp_buf *root = aot_try_push();
   if (root && setjmp(*root) != 0) {
-    // An uncaught throw unwound to here — reject with the thrown value.
-    // gather_body frees its state on the normal path; on this reject path the
-    // throw skipped that, so do the equivalent cleanup (release the retained
-    // child args and the partial result array, free the state).
-    if (t->gather) {
-      GatherState *gs = t->gather;
-      for (int i = 0; i < gs->n; i++) arc_release_vmvalue(&gs->items[i]);
-      if (gs->arr) {
-        VMValue av;
-        av.type = VM_VAL_OBJ;
-        av.as.obj = (Obj *)gs->arr;
-        arc_release_vmvalue(&av); // drops gather's own ref → frees the array
-      }
-      free(gs->items);
-      delete gs;
-      t->gather = nullptr;
-    }
-    t->done = true;
-    aot_promise_settle(t->result, aot_get_exception(), /*rejected*/ 2);
+    task_reject(t, aot_get_exception());
     return;
   }
   VMValue rv = t->gather ? gather_body(t->gather)
                          : call_user_fn(t->fn, t->args, t->argc);
   aot_try_pop(); // pop the root frame on the normal (non-throwing) path
+#endif
   t->done = true;
   aot_promise_settle(t->result, rv, /*fulfilled*/ 1);
 }
@@ -369,9 +387,7 @@ bool loop_step() {
       else keep.push_back(tm);
     }
     g_timers.swap(keep);
-    VMValue v;
-    v.type = VM_VAL_VOID;
-    v.as.int_val = 0;
+    VMValue v = VM_VOID();
     for (ObjPromise *p : fire) aot_promise_settle(p, v, 1);
     return true;
   }
@@ -394,13 +410,12 @@ extern "C" {
 ObjPromise *aot_promise_new(void) {
   ObjPromise *p = (ObjPromise *)malloc(sizeof(ObjPromise));
   p->obj.type = OBJ_PROMISE;
-  p->obj.next = nullptr;
   p->obj.arena_allocated = 1; // ARC must not reclaim while the loop holds it
+  p->obj.is_shared = 0;
   p->obj.ref_count = 1;
   p->obj.is_moved = 0;
   p->state = 0;
-  p->value.type = VM_VAL_VOID;
-  p->value.as.int_val = 0;
+  p->value = VM_VOID();
   p->waiters = nullptr;
   p->nwaiters = 0;
   p->cap_waiters = 0;
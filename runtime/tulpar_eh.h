@@ -0,0 +1,53 @@
+// Tulpar exception-handling ABI shared by the AOT backend and the runtime.
+//
+// On Itanium-ABI targets (Linux, macOS, Android) `try`/`catch` compiles to
+// `invoke` + `landingpad` with the C++ personality (__gxx_personality_v0), so
+// a try block costs nothing until something is thrown: no handler push, no
+// setjmp register save, no depth limit. `throw` raises a C++ exception of type
+// TulparThrow carrying the thrown value; the landing pad's single clause
+// names TulparThrow's typeinfo, so foreign C++ exceptions (and forced unwinds)
+// pass through untouched.
+//
+// Windows x64 (SEH) and wasm32 (--target=web) keep the setjmp/longjmp
+// lowering: aot_try_push / setjmp / aot_try_pop with the thread-local handler
+// stack in runtime_bindings.cpp.
+//
+// The backend decides per target (llvm_eh_uses_unwind); TULPAR_EH_UNWIND is
+// the matching compile-time switch for the runtime, which is always built for
+// the target it runs on.
+
+#ifndef TULPAR_EH_H
+#define TULPAR_EH_H
+
+#include "../src/vm/vm.hpp"
+
+#if defined(_WIN32) || defined(__EMSCRIPTEN__)
+#define TULPAR_EH_UNWIND 0
+#else
+#define TULPAR_EH_UNWIND 1
+#endif
+
+#ifdef __cplusplus
+// The in-flight C++ exception object. Polymorphic with an out-of-line key
+// function so its typeinfo (_ZTI11TulparThrow) is ONE strong, exported
+// symbol in runtime_bindings.cpp — the landing pads emitted by the backend
+// (and JIT'd code, via the process symbol generator) reference it by name.
+struct TulparThrow {
+  VMValue value;
+  explicit TulparThrow(VMValue v) : value(v) {}
+  virtual ~TulparThrow();
+};
+
+extern "C" {
+#endif
+
+// Landing-pad helper: takes the raw exception pointer from a landingpad,
+// returns the thrown value and ends the C++ catch immediately, so no
+// exception stays "being handled" across a coroutine yield in the catch body.
+VMValue aot_eh_catch(void *exn);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TULPAR_EH_H
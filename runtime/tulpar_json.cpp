@@ -0,0 +1,340 @@
+// Stage-1 structural indexer for fromJson. See tulpar_json.h for scope.
+#include "tulpar_json.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define TJ_X86 1
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define TJ_AVX2_DISPATCH 1 // target("avx2") + __builtin_cpu_supports
+#endif
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+static inline int tj_ctz64(uint64_t x) {
+  unsigned long i;
+  _BitScanForward64(&i, x);
+  return (int)i;
+}
+#else
+static inline int tj_ctz64(uint64_t x) { return __builtin_ctzll(x); }
+#endif
+
+// ---- Per-block character classes ------------------------------------------
+// Bit i of each mask describes byte i of the 64-byte block.
+typedef struct {
+  uint64_t quote;  // "
+  uint64_t bslash; // backslash
+  uint64_t ws;     // space \t \n \r
+  uint64_t op;     // { } [ ] : ,
+  uint64_t high;   // >= 0x80 (UTF-8 lead / continuation)
+} TjMasks;
+
+typedef void (*TjClassify)(const unsigned char *p, TjMasks *m);
+
+static void classify_scalar(const unsigned char *p, TjMasks *m) {
+  uint64_t q = 0, b = 0, w = 0, o = 0, h = 0;
+  for (int i = 0; i < 64; i++) {
+    unsigned char c = p[i];
+    uint64_t bit = 1ULL << i;
+    switch (c) {
+    case '"': q |= bit; break;
+    case '\\': b |= bit; break;
+    case ' ': case '\t': case '\n': case '\r': w |= bit; break;
+    case '{': case '}': case '[': case ']': case ':': case ',': o |= bit; break;
+    default: if (c >= 0x80) h |= bit; break;
+    }
+  }
+  m->quote = q;
+  m->bslash = b;
+  m->ws = w;
+  m->op = o;
+  m->high = h;
+}
+
+#ifdef TJ_X86
+// `{`/`}` and `[`/`]` differ from each other only in bit 5, so OR-ing 0x20
+// folds the four brackets onto two compares.
+static void classify_sse2(const unsigned char *p, TjMasks *m) {
+  const __m128i q = _mm_set1_epi8('"'), bs = _mm_set1_epi8('\\');
+  const __m128i sp = _mm_set1_epi8(' '), tab = _mm_set1_epi8('\t');
+  const __m128i nl = _mm_set1_epi8('\n'), cr = _mm_set1_epi8('\r');
+  const __m128i colon = _mm_set1_epi8(':'), comma = _mm_set1_epi8(',');
+  const __m128i lbr = _mm_set1_epi8('{'), rbr = _mm_set1_epi8('}');
+  const __m128i b20 = _mm_set1_epi8(0x20);
+  uint64_t mq = 0, mb = 0, mw = 0, mo = 0, mh = 0;
+  for (int k = 0; k < 4; k++) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(p + 16 * k));
+    __m128i f = _mm_or_si128(v, b20);
+    __m128i w = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(v, sp), _mm_cmpeq_epi8(v, tab)),
+        _mm_or_si128(_mm_cmpeq_epi8(v, nl), _mm_cmpeq_epi8(v, cr)));
+    __m128i o = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(f, lbr), _mm_cmpeq_epi8(f, rbr)),
+        _mm_or_si128(_mm_cmpeq_epi8(v, colon), _mm_cmpeq_epi8(v, comma)));
+    int sh = 16 * k;
+    mq |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, q)) << sh;
+    mb |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, bs)) << sh;
+    mw |= (uint64_t)(uint16_t)_mm_movemask_epi8(w) << sh;
+    mo |= (uint64_t)(uint16_t)_mm_movemask_epi8(o) << sh;
+    mh |= (uint64_t)(uint16_t)_mm_movemask_epi8(v) << sh;
+  }
+  m->quote = mq;
+  m->bslash = mb;
+  m->ws = mw;
+  m->op = mo;
+  m->high = mh;
+}
+#endif
+
+#ifdef TJ_AVX2_DISPATCH
+__attribute__((target("avx2"))) static void
+classify_avx2(const unsigned char *p, TjMasks *m) {
+  const __m256i q = _mm256_set1_epi8('"'), bs = _mm256_set1_epi8('\\');
+  const __m256i sp = _mm256_set1_epi8(' '), tab = _mm256_set1_epi8('\t');
+  const __m256i nl = _mm256_set1_epi8('\n'), cr = _mm256_set1_epi8('\r');
+  const __m256i colon = _mm256_set1_epi8(':'), comma = _mm256_set1_epi8(',');
+  const __m256i lbr = _mm256_set1_epi8('{'), rbr = _mm256_set1_epi8('}');
+  const __m256i b20 = _mm256_set1_epi8(0x20);
+  uint64_t mq = 0, mb = 0, mw = 0, mo = 0, mh = 0;
+  for (int k = 0; k < 2; k++) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)(p + 32 * k));
+    __m256i f = _mm256_or_si256(v, b20);
+    __m256i w = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, sp), _mm256_cmpeq_epi8(v, tab)),
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, nl), _mm256_cmpeq_epi8(v, cr)));
+    __m256i o = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(f, lbr), _mm256_cmpeq_epi8(f, rbr)),
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, colon),
+                        _mm256_cmpeq_epi8(v, comma)));
+    int sh = 32 * k;
+    mq |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, q)) << sh;
+    mb |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, bs)) << sh;
+    mw |= (uint64_t)(uint32_t)_mm256_movemask_epi8(w) << sh;
+    mo |= (uint64_t)(uint32_t)_mm256_movemask_epi8(o) << sh;
+    mh |= (uint64_t)(uint32_t)_mm256_movemask_epi8(v) << sh;
+  }
+  m->quote = mq;
+  m->bslash = mb;
+  m->ws = mw;
+  m->op = mo;
+  m->high = mh;
+}
+#endif
+
+// Lazy kernel pick is idempotent (every thread computes the same pointer),
+// same accepted pattern as the gzip CRC table.
+static TjClassify g_classify = NULL;
+static const char *g_kernel_name = "scalar";
+
+static TjClassify pick_kernel(void) {
+  if (g_classify)
+    return g_classify;
+  const char *force = getenv("TULPAR_JSON_SIMD");
+  TjClassify k = classify_scalar;
+  const char *name = "scalar";
+  if (!force || strcmp(force, "scalar") != 0) {
+#ifdef TJ_X86
+    k = classify_sse2;
+    name = "sse2";
+#endif
+#ifdef TJ_AVX2_DISPATCH
+    if (!force || strcmp(force, "sse2") != 0) {
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx2")) {
+        k = classify_avx2;
+        name = "avx2";
+      }
+    }
+#endif
+  }
+  g_kernel_name = name;
+  g_classify = k;
+  return k;
+}
+
+const char *tulpar_json_kernel(void) {
+  pick_kernel();
+  return g_kernel_name;
+}
+
+// ---- Bit arithmetic on the masks -------------------------------------------
+
+// Bytes escaped by a backslash. A backslash that is itself escaped escapes
+// nothing, so runs are resolved left to right; *carry says byte 0 of the
+// next block is escaped. Backslashes are rare in real bodies — the loop runs
+// once per backslash, not per byte.
+static inline uint64_t escaped_bytes(uint64_t bslash, uint64_t *carry) {
+  uint64_t esc = *carry;
+  *carry = 0;
+  while (bslash) {
+    int i = tj_ctz64(bslash);
+    bslash &= bslash - 1;
+    if ((esc >> i) & 1)
+      continue;
+    if (i == 63)
+      *carry = 1;
+    else
+      esc |= 1ULL << (i + 1);
+  }
+  return esc;
+}
+
+// Bit i = XOR of bits 0..i: 1 from an opening quote up to (not including)
+// its closing quote.
+static inline uint64_t prefix_xor(uint64_t x) {
+  x ^= x << 1;
+  x ^= x << 2;
+  x ^= x << 4;
+  x ^= x << 8;
+  x ^= x << 16;
+  x ^= x << 32;
+  return x;
+}
+
+// ---- UTF-8 validation ------------------------------------------------------
+// Only blocks with a byte >= 0x80 (or a sequence still open from the previous
+// block) reach this; ASCII blocks cost one mask test.
+typedef struct {
+  int need;              // continuation bytes still expected
+  unsigned char lo, hi;  // allowed range of the next continuation byte
+} TjUtf8;
+
+static int utf8_step(TjUtf8 *u, const unsigned char *p, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    unsigned char c = p[i];
+    if (u->need) {
+      if (c < u->lo || c > u->hi)
+        return 0;
+      u->need--;
+      u->lo = 0x80;
+      u->hi = 0xBF;
+      continue;
+    }
+    if (c < 0x80)
+      continue;
+    u->lo = 0x80;
+    u->hi = 0xBF;
+    if (c >= 0xC2 && c <= 0xDF) {
+      u->need = 1;
+    } else if (c == 0xE0) {
+      u->need = 2; // no overlongs
+      u->lo = 0xA0;
+    } else if (c == 0xED) {
+      u->need = 2; // no UTF-16 surrogates
+      u->hi = 0x9F;
+    } else if (c >= 0xE1 && c <= 0xEF) {
+      u->need = 2;
+    } else if (c == 0xF0) {
+      u->need = 3;
+      u->lo = 0x90;
+    } else if (c >= 0xF1 && c <= 0xF3) {
+      u->need = 3;
+    } else if (c == 0xF4) {
+      u->need = 3; // <= U+10FFFF
+      u->hi = 0x8F;
+    } else {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// ---- Driver ----------------------------------------------------------------
+
+static int index_reserve(TulparJsonIndex *ix, size_t extra) {
+  if (ix->count + extra <= ix->capacity)
+    return 1;
+  size_t cap = ix->capacity ? ix->capacity * 2 : 256;
+  while (cap < ix->count + extra)
+    cap *= 2;
+  uint32_t *p = (uint32_t *)realloc(ix->pos, cap * sizeof(uint32_t));
+  if (!p)
+    return 0;
+  ix->pos = p;
+  ix->capacity = cap;
+  return 1;
+}
+
+int tulpar_json_index(const unsigned char *src, size_t len,
+                      TulparJsonIndex *ix) {
+  ix->pos = NULL;
+  ix->count = 0;
+  ix->capacity = 0;
+  if (len >= 0xFFFFFFFFu)
+    return TULPAR_JSON_ENOMEM;
+  // Typical bodies have one structural per ~6 bytes; start near that so the
+  // realloc ladder rarely fires on multi-MB inputs.
+  if (!index_reserve(ix, len / 6 + 64))
+    return TULPAR_JSON_ENOMEM;
+
+  TjClassify classify = pick_kernel();
+  TjUtf8 utf8 = {0, 0x80, 0xBF};
+  uint64_t esc_carry = 0;   // byte 0 of the next block is escaped
+  uint64_t in_string = 0;   // all-ones while a string spans the boundary
+  uint64_t prev_atom = 0;   // last byte of the previous block was atom text
+  unsigned char tail[64];
+
+  for (size_t base = 0; base < len; base += 64) {
+    const unsigned char *block = src + base;
+    size_t n = len - base;
+    if (n < 64) {
+      // Pad with spaces: whitespace never starts an atom or a string.
+      memcpy(tail, block, n);
+      memset(tail + n, ' ', 64 - n);
+      block = tail;
+    } else {
+      n = 64;
+    }
+
+    TjMasks m;
+    classify(block, &m);
+
+    if ((m.high || utf8.need) && !utf8_step(&utf8, block, n)) {
+      tulpar_json_index_free(ix);
+      return TULPAR_JSON_EUTF8;
+    }
+
+    uint64_t quote = m.quote & ~escaped_bytes(m.bslash, &esc_carry);
+    uint64_t str = prefix_xor(quote) ^ in_string;
+    in_string = (uint64_t)((int64_t)str >> 63);
+
+    uint64_t op = m.op & ~str;
+    uint64_t open_quote = quote & str;
+    uint64_t atom = ~(m.op | m.ws | quote | str);
+    uint64_t atom_start = atom & ~((atom << 1) | prev_atom);
+    prev_atom = atom >> 63;
+
+    uint64_t s = op | open_quote | atom_start;
+    if (!index_reserve(ix, 64)) {
+      tulpar_json_index_free(ix);
+      return TULPAR_JSON_ENOMEM;
+    }
+    uint32_t *out = ix->pos + ix->count;
+    while (s) {
+      *out++ = (uint32_t)(base + tj_ctz64(s));
+      s &= s - 1;
+    }
+    ix->count = (size_t)(out - ix->pos);
+  }
+
+  if (in_string) {
+    tulpar_json_index_free(ix);
+    return TULPAR_JSON_ESTRING;
+  }
+  if (utf8.need) {
+    tulpar_json_index_free(ix);
+    return TULPAR_JSON_EUTF8;
+  }
+  return TULPAR_JSON_OK;
+}
+
+void tulpar_json_index_free(TulparJsonIndex *ix) {
+  free(ix->pos);
+  ix->pos = NULL;
+  ix->count = 0;
+  ix->capacity = 0;
+}
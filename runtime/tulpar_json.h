@@ -0,0 +1,48 @@
+// tulpar_json — stage 1 of the AOT runtime's two-stage `fromJson` parser.
+//
+// One pass over the input, 64 bytes at a time, that (a) finds every
+// structural character ({ } [ ] : , outside strings), every string's opening
+// quote and the first byte of every bare atom (number / true / false / null),
+// and (b) validates UTF-8. Classification is SIMD (AVX2 when the CPU has it,
+// SSE2 on every other x86-64, plain C elsewhere — wasm / Android ARM); the
+// in-string / escape bookkeeping is branch-free bit arithmetic on the 64-bit
+// masks (simdjson-style), so the cost per byte no longer depends on how many
+// strings the body contains.
+//
+// Stage 2 (the VMValue builder, aot_from_json in runtime_bindings.cpp) then
+// walks the offset list instead of re-scanning whitespace byte by byte.
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  uint32_t *pos; // byte offsets into the input, ascending
+  size_t count;
+  size_t capacity;
+} TulparJsonIndex;
+
+enum {
+  TULPAR_JSON_OK = 0,
+  TULPAR_JSON_EUTF8 = 1,   // invalid / truncated UTF-8 sequence
+  TULPAR_JSON_ESTRING = 2, // input ends inside a string
+  TULPAR_JSON_ENOMEM = 3,  // allocation failed, or input >= 4 GiB
+};
+
+// Index src[0..len). On TULPAR_JSON_OK, ix->pos holds ix->count offsets and
+// the caller releases it with tulpar_json_index_free; on error ix is left
+// empty.
+int tulpar_json_index(const unsigned char *src, size_t len,
+                      TulparJsonIndex *ix);
+void tulpar_json_index_free(TulparJsonIndex *ix);
+
+// "avx2" | "sse2" | "scalar" — the kernel tulpar_json_index dispatches to.
+// TULPAR_JSON_SIMD=scalar|sse2 forces a narrower one (benchmarks, bisecting).
+const char *tulpar_json_kernel(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -243,6 +243,29 @@ void tulpar_array_str_free(TulparArrayStr *arr) {
   free(arr);
 }
 
+// ============================================================================
+// Typed Array Storage (AOT unboxed arrayInt / arrayFloat / arrayBool locals)
+// ============================================================================
+
+// The AOT backend keeps the {data, count, capacity} header of an unboxed
+// array local in the function's own stack frame (same layout as
+// TulparArrayInt) and emits push / index / bounds checks inline. Only the
+// backing buffer crosses into the runtime — the header never escapes, so
+// LLVM can keep it in registers across a hot loop.
+void *tulpar_array_grow(void *data, TulparInt capacity, TulparInt elem_size) {
+  void *grown = realloc(data, (size_t)capacity * (size_t)elem_size);
+  if (!grown) {
+    fprintf(stderr, "Runtime Error: out of memory growing array to %lld items\n",
+            (long long)capacity);
+    exit(1);
+  }
+  return grown;
+}
+
+void tulpar_array_release(void *data) {
+  if (data) free(data);
+}
+
 // ============================================================================
 // Type Conversion
 // ============================================================================
@@ -100,6 +100,10 @@ void tulpar_array_str_set(TulparArrayStr *arr, TulparInt index, TulparString val
 TulparInt tulpar_array_str_length(TulparArrayStr *arr);
 void tulpar_array_str_free(TulparArrayStr *arr);
 
+// Typed array storage (AOT backend; header lives in the caller's frame)
+void *tulpar_array_grow(void *data, TulparInt capacity, TulparInt elem_size);
+void tulpar_array_release(void *data);
+
 // ============================================================================
 // Type Conversion
 // ============================================================================
@@ -0,0 +1,193 @@
+#include "aot_lld.hpp"
+#include "../common/platform.h"
+
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <sys/stat.h>
+
+#if defined(TULPAR_HAS_LLD) && PLATFORM_LINUX
+#include <elf.h>
+#include "lld/Common/Driver.h"
+#if __has_include("lld/Common/CommonLinkerContext.h")
+#include "lld/Common/CommonLinkerContext.h"
+#define TULPAR_LLD_HAS_CONTEXT 1
+#endif
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/raw_ostream.h"
+
+#if TULPAR_LLVM_MAJOR >= 17
+// LLVM 17+ registers each flavor's entry point through this macro and
+// routes every in-process invocation via lld::lldMain().
+LLD_HAS_DRIVER(elf)
+#endif
+#endif
+
+#if defined(TULPAR_HAS_LLD) && PLATFORM_LINUX
+
+// Toolchain paths probed by CMake (`<cxx> -print-file-name=...`) when the
+// driver was configured. The AOT binary links the same libstdc++ / libgcc /
+// libc the driver itself was built against, which is also what `clang++`
+// resolves on the same host.
+#ifndef TULPAR_LLD_CRT1
+#define TULPAR_LLD_CRT1 ""
+#endif
+#ifndef TULPAR_LLD_CRTI
+#define TULPAR_LLD_CRTI ""
+#endif
+#ifndef TULPAR_LLD_CRTN
+#define TULPAR_LLD_CRTN ""
+#endif
+#ifndef TULPAR_LLD_CRTBEGIN
+#define TULPAR_LLD_CRTBEGIN ""
+#endif
+#ifndef TULPAR_LLD_CRTEND
+#define TULPAR_LLD_CRTEND ""
+#endif
+// ':'-separated list (libstdc++ dir, libgcc dir, libc dir).
+#ifndef TULPAR_LLD_LIB_DIRS
+#define TULPAR_LLD_LIB_DIRS ""
+#endif
+
+static bool file_exists(const char *path) {
+  struct stat st;
+  return path && *path && stat(path, &st) == 0;
+}
+
+// The program interpreter (`/lib64/ld-linux-x86-64.so.2`, ...) of the
+// running tulpar binary. The AOT output targets the same host, so its
+// PT_INTERP is exactly the `-dynamic-linker` clang would have picked —
+// no per-distro/per-arch table needed.
+static std::string self_program_interpreter() {
+  FILE *f = fopen("/proc/self/exe", "rb");
+  if (!f) return "";
+  std::string out;
+  Elf64_Ehdr eh;
+  if (fread(&eh, sizeof(eh), 1, f) == 1 &&
+      memcmp(eh.e_ident, ELFMAG, SELFMAG) == 0 &&
+      eh.e_ident[EI_CLASS] == ELFCLASS64) {
+    for (int i = 0; i < eh.e_phnum && out.empty(); i++) {
+      Elf64_Phdr ph;
+      if (fseek(f, (long)(eh.e_phoff + (Elf64_Off)i * eh.e_phentsize),
+                SEEK_SET) != 0 ||
+          fread(&ph, sizeof(ph), 1, f) != 1)
+        break;
+      if (ph.p_type != PT_INTERP || ph.p_filesz == 0 || ph.p_filesz > 4096)
+        continue;
+      std::string buf(ph.p_filesz, '\0');
+      if (fseek(f, (long)ph.p_offset, SEEK_SET) == 0 &&
+          fread(&buf[0], 1, ph.p_filesz, f) == ph.p_filesz) {
+        out.assign(buf.c_str()); // drop the trailing NUL
+      }
+    }
+  }
+  fclose(f);
+  return out;
+}
+
+static const std::string &dynamic_linker() {
+  static const std::string dl = self_program_interpreter();
+  return dl;
+}
+
+int aot_lld_available() {
+  static int cached = -1;
+  if (cached < 0) {
+    cached = file_exists(TULPAR_LLD_CRT1) && file_exists(TULPAR_LLD_CRTI) &&
+                     file_exists(TULPAR_LLD_CRTN) &&
+                     file_exists(TULPAR_LLD_CRTBEGIN) &&
+                     file_exists(TULPAR_LLD_CRTEND) &&
+                     !dynamic_linker().empty()
+                 ? 1
+                 : 0;
+  }
+  return cached;
+}
+
+int aot_lld_link_elf(const std::vector<std::string> &objects,
+                     const std::string &output,
+                     const std::vector<std::string> &search_dirs,
+                     const std::vector<std::string> &libs,
+                     std::string *diag) {
+  if (!aot_lld_available()) {
+    if (diag) *diag += "lld: toolchain start files not found\n";
+    return -1;
+  }
+
+  // Same shape as `clang++ -no-pie -rdynamic ...` → ld: start files,
+  // search dirs, user objects, Tulpar libs, then the C++ runtime tail.
+  std::vector<std::string> args;
+  args.push_back("ld.lld");
+  args.push_back("--eh-frame-hdr");
+  args.push_back("--export-dynamic"); // -rdynamic: call(name) → dlsym
+  args.push_back("-dynamic-linker");
+  args.push_back(dynamic_linker());
+  args.push_back("-o");
+  args.push_back(output);
+  args.push_back(TULPAR_LLD_CRT1);
+  args.push_back(TULPAR_LLD_CRTI);
+  args.push_back(TULPAR_LLD_CRTBEGIN);
+  for (const std::string &d : search_dirs) args.push_back("-L" + d);
+  {
+    const char *p = TULPAR_LLD_LIB_DIRS;
+    while (*p) {
+      const char *colon = strchr(p, ':');
+      size_t n = colon ? (size_t)(colon - p) : strlen(p);
+      if (n) args.push_back("-L" + std::string(p, n));
+      p += n + (colon ? 1 : 0);
+    }
+  }
+  for (const std::string &o : objects) args.push_back(o);
+  for (const std::string &l : libs) args.push_back("-l" + l);
+  for (const char *tail : {"-lstdc++", "-lm", "-lgcc_s", "-lgcc", "-lc",
+                           "-lgcc_s", "-lgcc"})
+    args.push_back(tail);
+  args.push_back(TULPAR_LLD_CRTEND);
+  args.push_back(TULPAR_LLD_CRTN);
+
+  std::vector<const char *> argv;
+  argv.reserve(args.size());
+  for (const std::string &a : args) argv.push_back(a.c_str());
+
+  // LLD keeps its linker state in globals; one link at a time.
+  static std::mutex lld_mutex;
+  std::lock_guard<std::mutex> lock(lld_mutex);
+
+  std::string out_text, err_text;
+  llvm::raw_string_ostream out_os(out_text), err_os(err_text);
+  bool ok;
+#if TULPAR_LLVM_MAJOR >= 17
+  lld::Result r = lld::lldMain(argv, out_os, err_os,
+                               {{lld::Gnu, &lld::elf::link}});
+  ok = r.retCode == 0;
+#else
+  // exitEarly=false: never exit() the tulpar process on a link error.
+  ok = lld::elf::link(argv, out_os, err_os, /*exitEarly=*/false,
+                      /*disableOutput=*/false);
+#ifdef TULPAR_LLD_HAS_CONTEXT
+  lld::CommonLinkerContext::destroy();
+#endif
+#endif
+  out_os.flush();
+  err_os.flush();
+  if (diag) {
+    *diag += out_text;
+    *diag += err_text;
+  }
+  return ok ? 0 : 1;
+}
+
+#else // !TULPAR_HAS_LLD
+
+int aot_lld_available() { return 0; }
+
+int aot_lld_link_elf(const std::vector<std::string> &,
+                     const std::string &,
+                     const std::vector<std::string> &,
+                     const std::vector<std::string> &,
+                     std::string *diag) {
+  if (diag) *diag += "lld: not compiled in (configure with TULPAR_WITH_LLD)\n";
+  return -1;
+}
+
+#endif
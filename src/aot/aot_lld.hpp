@@ -0,0 +1,36 @@
+#ifndef AOT_LLD_H
+#define AOT_LLD_H
+
+#include <string>
+#include <vector>
+
+// In-process ELF linking through the LLD library API.
+//
+// `tulpar build` / `tulpar run` used to shell out to `clang++` for the link
+// step: one fork for the shell, one for the clang driver, one for the system
+// linker — frequently the slowest phase for small programs, and a hard
+// dependency on clang being installed. When the driver is configured with
+// `TULPAR_WITH_LLD=ON` and CMake finds LLD's libraries (+ the host's crt
+// objects), the link runs inside the tulpar process instead. Everything
+// else (Windows/macOS, web/android targets, a build without LLD, any
+// in-process failure) keeps the external `clang++` path — see
+// aot_link_native() in aot_pipeline.cpp.
+
+// 1 when this driver was built with LLD linked in AND the toolchain files
+// probed at configure time (crt1.o, crtbegin.o, ...) still exist on this
+// host. Cached after the first call.
+int aot_lld_available();
+
+// Link `objects` into the executable `output` with ld.lld. `search_dirs`
+// are the Tulpar runtime search dirs (same list clang++ gets as -L);
+// `libs` are bare library names (`tulpar_runtime`, `m`, ...) in link order.
+// The C/C++ startup objects and the libstdc++/libgcc/libc tail are added
+// here, mirroring what `clang++ -no-pie` passes to the system linker.
+// Diagnostics are appended to `*diag` (may be null). Returns 0 on success.
+int aot_lld_link_elf(const std::vector<std::string> &objects,
+                     const std::string &output,
+                     const std::vector<std::string> &search_dirs,
+                     const std::vector<std::string> &libs,
+                     std::string *diag);
+
+#endif
@@ -6,6 +6,9 @@
 #include "../pkg/manifest.hpp"  // [android] bölümü: paket adi/ikon/yon/surum
 #include "../lsp/document_index.hpp"
 #include "llvm_backend.hpp"
+#include "aot_lld.hpp"
+#include "llvm_parallel.hpp"
+#include "llvm_jit.hpp"
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -19,9 +22,12 @@
 #include <csignal>   // SIGINT
 #include <sys/wait.h> // WIFSIGNALED / WTERMSIG on system() status
 #include <dirent.h>  // find_android_ndk: ~/Android/android-ndk-* taraması
+#include <sys/statvfs.h> // ST_NOEXEC: /tmp noexec → JIT run mode
 #endif
 #include <chrono>
+#include <thread>
 #include <string>
+#include <vector>
 
 #include <llvm-c/Core.h>
 #include <llvm-c/Target.h>
@@ -187,18 +193,17 @@ static std::string get_executable_dir() {
 #endif
 }
 
-// Build the `-L<dir>` switches passed to clang++ at link time.
+// Runtime library search dirs, in priority order. Formatted as `-L`
+// switches for clang++ by build_link_search_dirs(), passed as-is to the
+// in-process LLD link (aot_lld_link_elf).
 //
 // Order matters: clang searches the first path that contains the
 // requested library first, so the installer location should win
 // over the dev-tree fallbacks if both happen to be present.
-static std::string build_link_search_dirs() {
-  std::string out;
+static std::vector<std::string> link_search_dir_list() {
+  std::vector<std::string> out;
   auto add = [&](const std::string &dir) {
-    if (dir.empty()) return;
-    out += "-L\"";
-    out += dir;
-    out += "\" ";
+    if (!dir.empty()) out.push_back(dir);
   };
 
   std::string exe_dir = get_executable_dir();
@@ -229,6 +234,17 @@ static std::string build_link_search_dirs() {
   return out;
 }
 
+// Build the `-L<dir>` switches passed to clang++ at link time.
+static std::string build_link_search_dirs() {
+  std::string out;
+  for (const std::string &dir : link_search_dir_list()) {
+    out += "-L\"";
+    out += dir;
+    out += "\" ";
+  }
+  return out;
+}
+
 // Optional extra flags spliced into the final clang++ AOT link command. Set
 // TULPAR_AOT_LINK_FLAGS to forward switches to the link step — e.g.
 // "-fsanitize=address" to leak/UB-check the AOT'd binary against an ASan-built
@@ -276,6 +292,54 @@ static int g_android_aab = 0;
 void aot_set_android_apk(int enable) { g_android_apk = enable ? 1 : 0; }
 void aot_set_android_aab(int enable) { g_android_aab = enable ? 1 : 0; }
 
+// Worker threads for the partitioned optimise + emit path (-j N). 0 = not
+// set on the CLI: fall back to TULPAR_BUILD_JOBS, then 1 (serial, one
+// module — the historical pipeline and the best code for small programs).
+static int g_build_jobs = 0;
+void aot_set_build_jobs(int jobs) { g_build_jobs = jobs; }
+
+// --allocator seçimi codegen'e backend üzerinden taşınır (main() başında
+// tulpar_alloc_select çağrısı); web hedefinde runtime zaten malloc kullanır.
+void aot_set_allocator(int use_system) {
+  llvm_backend_set_allocator(use_system ? 1 : 0);
+}
+
+// --checks seviyesi de aynı yoldan: codegen her erişim / işlem için okur.
+void aot_set_checks(int level) { llvm_backend_set_checks(level); }
+
+static int aot_build_jobs() {
+  int jobs = g_build_jobs;
+  if (jobs == 0) {
+    const char *e = getenv("TULPAR_BUILD_JOBS");
+    jobs = (e && *e) ? atoi(e) : 1;
+  }
+  if (jobs <= 0) { // -j0 / TULPAR_BUILD_JOBS=0: one per hardware thread
+    unsigned hw = std::thread::hardware_concurrency();
+    jobs = hw ? (int)hw : 1;
+  }
+  return jobs;
+}
+
+// Partitioned optimise + emit for `-j N` (llvm_parallel.cpp). Only the
+// native host target qualifies: debug builds keep one module so the DWARF
+// graph stays whole, web/android have their own emit paths. Returns 0 with
+// `objects` filled, 1 when the serial optimize + emit path should run
+// instead (jobs == 1, other target, module too small), -1 on failure.
+static int aot_emit_partitioned(LLVMBackend *backend, const char *output_name,
+                                std::vector<std::string> *objects) {
+  int jobs = aot_build_jobs();
+  if (jobs <= 1 || g_target_web || g_target_android ||
+      backend->emit_debug_info)
+    return 1;
+  AOTPhaseTimer t("opt+emit-j");
+  int rc = llvm_backend_emit_objects_parallel(backend, output_name, jobs,
+                                              objects);
+  if (rc == 0)
+    AOT_PROGRESS("[AOT] Optimized + emitted %zu partitions on %d threads\n",
+                 objects->size(), jobs);
+  return rc;
+}
+
 // Paketleme betiğini bul: TULPAR_ANDROID_TOOLS ortam değişkeni (dizin), sonra
 // tulpar'ın yanı (kurulum düzeni), sonra çalışma dizini (dev-tree). `name` =
 // "package_apk.sh" ya da "package_aab.sh".
@@ -768,6 +832,104 @@ static const char *tame_link_flags(int uses_tame) {
 #endif
 }
 
+// Native link backend selection. TULPAR_LINKER=driver forces the external
+// `clang++` link, TULPAR_LINKER=lld asks for the in-process LLD link (falls
+// back to clang++ with a note when this driver has no LLD). Unset / "auto":
+// LLD when compiled in, clang++ otherwise.
+enum AOTLinkerMode { AOT_LINKER_AUTO, AOT_LINKER_LLD, AOT_LINKER_DRIVER };
+static AOTLinkerMode aot_linker_mode() {
+  static int cached = -1;
+  if (cached < 0) {
+    const char *e = getenv("TULPAR_LINKER");
+    if (e && strcmp(e, "driver") == 0) cached = AOT_LINKER_DRIVER;
+    else if (e && strcmp(e, "lld") == 0) cached = AOT_LINKER_LLD;
+    else cached = AOT_LINKER_AUTO;
+  }
+  return (AOTLinkerMode)cached;
+}
+
+// Link the host executable `exe_filename` (AOT_EXE_SUFFIX appended) from
+// `objects` (one, or one per partition with -j). Returns 0 on success, like
+// system().
+//
+// ELF hosts try LLD in-process first (aot_lld.cpp): no shell, no clang
+// driver, no second linker process — the link step of `tulpar run` on a
+// small script drops from a few hundred ms to a few tens. Anything the
+// in-process path cannot express is left to `clang++`: extra driver flags
+// from TULPAR_AOT_LINK_FLAGS (e.g. -fsanitize=address), Windows/macOS, or
+// a driver built without LLD. An in-process failure also retries with
+// clang++, so a quirky toolchain layout can't make a build worse than it
+// was before; LLD's own diagnostics only surface under TULPAR_AOT_VERBOSE.
+//
+// `quiet` is the `tulpar run` path: the clang++ fallback's output goes to
+// the null device instead of the terminal.
+static int aot_link_native(const std::vector<std::string> &objects,
+                           const char *exe_filename, int uses_tame,
+                           int emit_debug_info, int quiet) {
+  std::string extra_flags = aot_extra_link_flags();
+  AOTLinkerMode mode = aot_linker_mode();
+
+#if PLATFORM_LINUX
+  if (mode != AOT_LINKER_DRIVER && extra_flags.empty()) {
+    if (aot_lld_available()) {
+      std::vector<std::string> libs;
+      if (uses_tame) libs.push_back("tulpar_tame");
+      for (const char *l : {"tulpar_runtime", "m", "pthread", "dl"})
+        libs.push_back(l);
+#if defined(TULPAR_HAS_TLS)
+      libs.push_back("ssl");
+      libs.push_back("crypto");
+#endif
+      std::string diag;
+      int rc;
+      {
+        AOTPhaseTimer t("link-lld");
+        rc = aot_lld_link_elf(objects, exe_filename,
+                              link_search_dir_list(), libs, &diag);
+      }
+      if (rc == 0) return 0;
+      AOT_PROGRESS("[AOT] In-process link failed, retrying with clang++:\n%s",
+                   diag.c_str());
+    } else if (mode == AOT_LINKER_LLD && !quiet) {
+      fprintf(stderr, "%s\n",
+              tulpar::i18n::tr_en(
+                  "[AOT] TULPAR_LINKER=lld: bu surucu LLD olmadan derlenmis, "
+                  "clang++ kullaniliyor.",
+                  "[AOT] TULPAR_LINKER=lld: this driver was built without "
+                  "LLD, using clang++."));
+    }
+  }
+#else
+  (void)mode;
+#endif
+
+  // External driver. `-g` is forwarded to clang when --debug was requested
+  // so debug sections emitted in the object file survive linking into the
+  // final binary.
+  std::string search_dirs = build_link_search_dirs();
+  const char *debug_flag = emit_debug_info ? "-g " : "";
+  std::string obj_list;
+  for (const std::string &o : objects) {
+    if (!obj_list.empty()) obj_list += ' ';
+    obj_list += o;
+  }
+#if PLATFORM_WINDOWS
+  const char *redirect = quiet ? " 2>NUL" : " 2>&1";
+#else
+  const char *redirect = quiet ? " 2>/dev/null" : " 2>&1";
+#endif
+  char link_cmd[4096];
+  snprintf(
+      link_cmd, sizeof(link_cmd),
+      "clang++ %s%s -o %s%s %s %s%s%s%s%s",
+      debug_flag, obj_list.c_str(), exe_filename, AOT_EXE_SUFFIX,
+      AOT_LINK_PIE_FLAG, search_dirs.c_str(),
+      tame_link_flags(uses_tame), " " AOT_LINK_LIB_FLAGS,
+      extra_flags.c_str(), redirect);
+  AOTPhaseTimer t("link");
+  return system(link_cmd);
+}
+
 // Parse source code to AST. Caller-provided `source_filename` is
 // optional and only used by parse-time diagnostics for the file path
 // in `--> path:line` headers.
@@ -892,7 +1054,20 @@ AOTResult aot_compile_with_filename_debug(const char *source,
     }
   }
 
-  {
+  // -j N: optimise + emit partitions in parallel. On success the module has
+  // already been turned into `objects` and the serial optimize / emit-obj
+  // steps below are skipped (so is TULPAR_AOT_EMIT_LL — there is no single
+  // optimized module to print; use -j1 to inspect it).
+  std::vector<std::string> objects;
+  int partitioned = aot_emit_partitioned(backend, output_name, &objects);
+  if (partitioned < 0) {
+    fprintf(stderr, "%s", tulpar::i18n::tr_for_en("[AOT] Error: Failed to emit object file\n"));
+    llvm_backend_destroy(backend);
+    ast_node_free(ast);
+    return AOT_ERROR_EMIT;
+  }
+
+  if (partitioned != 0) {
     AOTPhaseTimer t("optimize");
     AOT_PROGRESS("[AOT] Optimizing...\n");
     llvm_backend_optimize(backend);
@@ -932,7 +1107,7 @@ AOTResult aot_compile_with_filename_debug(const char *source,
   // and almost nobody reads the .ll. Enable with TULPAR_AOT_EMIT_LL=1.
   {
     const char *e = getenv("TULPAR_AOT_EMIT_LL");
-    if (e && *e && *e != '0') {
+    if (e && *e && *e != '0' && partitioned != 0) {
       AOTPhaseTimer t("emit-ll");
       char ir_file[256];
       snprintf(ir_file, sizeof(ir_file), "%s.ll", output_name);
@@ -1135,7 +1310,7 @@ AOTResult aot_compile_with_filename_debug(const char *source,
     return AOT_OK;
   }
 
-  {
+  if (partitioned != 0) {
     AOTPhaseTimer t("emit-obj");
     AOT_PROGRESS("[AOT] Emitting object file: %s\n", obj_filename);
     if (llvm_backend_emit_object(backend, obj_filename) != 0) {
@@ -1144,21 +1319,16 @@ AOTResult aot_compile_with_filename_debug(const char *source,
       ast_node_free(ast);
       return AOT_ERROR_EMIT;
     }
+    objects.assign(1, obj_filename);
   }
 
-  // Link using clang++ (need C++ runtime for tulpar_runtime).
-  // `-g` is forwarded to clang when --debug was requested so debug
-  // sections emitted in the object file survive linking into the
-  // final binary. Today the object has no `!dbg` metadata yet
-  // (Plan 07 PR 2 wires up LLVMDIBuilder), so `-g` is effectively
-  // a no-op until that lands — but plumbing the switch through now
-  // keeps the CLI surface stable across the PR series.
+  // Link (need C++ runtime for tulpar_runtime): in-process LLD or
+  // clang++ for the host, em++ for the web target.
   AOT_PROGRESS("[AOT] Linking executable: %s\n", exe_filename);
-  std::string search_dirs = build_link_search_dirs();
-  std::string extra_flags = aot_extra_link_flags();
-  const char *debug_flag = emit_debug_info ? "-g " : "";
-  char link_cmd[2048];
+  int link_result;
   if (g_target_web) {
+    std::string extra_flags = aot_extra_link_flags();
+    char link_cmd[2048];
     // Web hedefi: em++ (Emscripten) linkler → <out>.html + .js + .wasm.
     // - USE_GLFW=3: raylib PLATFORM_WEB, Emscripten'in GLFW JS
     //   implementasyonunu kullanır (rglfw.c web arşivinde yok).
@@ -1196,20 +1366,15 @@ AOTResult aot_compile_with_filename_debug(const char *source,
         "%s-ltulpar_tame_web -ltulpar_runtime_web%s%s 2>&1",
         obj_filename, exe_filename, web_dirs.c_str(), preload.c_str(),
         extra_flags.c_str());
-  } else {
-  snprintf(
-      link_cmd, sizeof(link_cmd),
-      "clang++ %s%s -o %s%s %s %s%s%s%s 2>&1",
-      debug_flag, obj_filename, exe_filename, AOT_EXE_SUFFIX,
-      AOT_LINK_PIE_FLAG, search_dirs.c_str(),
-      tame_link_flags(backend->uses_tame), " " AOT_LINK_LIB_FLAGS,
-      extra_flags.c_str());
-  }
-
-  int link_result;
-  {
     AOTPhaseTimer t("link");
     link_result = system(link_cmd);
+  } else {
+    link_result = aot_link_native(objects, exe_filename, backend->uses_tame,
+                                  emit_debug_info, /*quiet=*/0);
+    // Partition objects are pure intermediates; the single-module build
+    // keeps its `<out>.o` next to the binary as before.
+    if (partitioned == 0)
+      for (const std::string &o : objects) remove(o.c_str());
   }
   if (link_result != 0) {
     fprintf(stderr, tulpar::i18n::tr_for_en(
@@ -1290,45 +1455,32 @@ static AOTResult aot_compile_silent(const char *source,
     ast_node_free(ast);
     return AOT_ERROR_CODEGEN;
   }
-  llvm_backend_optimize(backend);
-
   char obj_filename[256];
   char exe_filename[256];
   snprintf(obj_filename, sizeof(obj_filename), "%s.o", output_name);
   snprintf(exe_filename, sizeof(exe_filename), "%s", output_name);
 
-  if (llvm_backend_emit_object(backend, obj_filename) != 0) {
-    llvm_backend_destroy(backend);
-    ast_node_free(ast);
-    return AOT_ERROR_EMIT;
+  std::vector<std::string> objects;
+  int partitioned = aot_emit_partitioned(backend, output_name, &objects);
+  if (partitioned != 0) {
+    if (partitioned > 0) {
+      llvm_backend_optimize(backend);
+      if (llvm_backend_emit_object(backend, obj_filename) == 0)
+        objects.assign(1, obj_filename);
+    }
+    if (objects.empty()) {
+      llvm_backend_destroy(backend);
+      ast_node_free(ast);
+      return AOT_ERROR_EMIT;
+    }
   }
 
   // Link silently (suppress output)
-  std::string silent_search_dirs = build_link_search_dirs();
-  std::string silent_extra_flags = aot_extra_link_flags();
-  char link_cmd[2048];
-#if PLATFORM_WINDOWS
-  snprintf(
-      link_cmd, sizeof(link_cmd),
-      "clang++ %s -o %s%s %s %s%s%s%s 2>NUL",
-      obj_filename, exe_filename, AOT_EXE_SUFFIX,
-      AOT_LINK_PIE_FLAG, silent_search_dirs.c_str(),
-      tame_link_flags(backend->uses_tame), " " AOT_LINK_LIB_FLAGS,
-      silent_extra_flags.c_str());
-#else
-  snprintf(
-      link_cmd, sizeof(link_cmd),
-      "clang++ %s -o %s%s %s %s%s%s%s 2>/dev/null",
-      obj_filename, exe_filename, AOT_EXE_SUFFIX,
-      AOT_LINK_PIE_FLAG, silent_search_dirs.c_str(),
-      tame_link_flags(backend->uses_tame), " " AOT_LINK_LIB_FLAGS,
-      silent_extra_flags.c_str());
-#endif
+  int link_result = aot_link_native(objects, exe_filename, backend->uses_tame,
+                                    0, /*quiet=*/1);
 
-  int link_result = system(link_cmd);
-
-  // Cleanup object file
-  remove(obj_filename);
+  // Cleanup object file(s)
+  for (const std::string &o : objects) remove(o.c_str());
 
   llvm_backend_destroy(backend);
   ast_node_free(ast);
@@ -1340,6 +1492,68 @@ static AOTResult aot_compile_silent(const char *source,
   return AOT_OK;
 }
 
+// `tulpar run` execution engine: -1 = not set on the CLI (TULPAR_RUN_MODE
+// decides), 0 = AOT temp binary, 1 = in-process ORC JIT.
+static int g_run_jit = -1;
+void aot_set_run_jit(int enable) { g_run_jit = enable ? 1 : 0; }
+
+// JIT when asked for (--jit, TULPAR_RUN_MODE=jit), or — unless AOT was
+// asked for explicitly — when /tmp is mounted noexec, where the temp
+// binary could be written but never executed.
+static int aot_run_wants_jit() {
+  if (g_run_jit >= 0) return g_run_jit;
+  const char *e = getenv("TULPAR_RUN_MODE");
+  if (e && strcmp(e, "jit") == 0) return 1;
+  if (e && strcmp(e, "aot") == 0) return 0;
+#if !PLATFORM_WINDOWS
+  struct statvfs vfs;
+  if (statvfs("/tmp", &vfs) == 0 && (vfs.f_flag & ST_NOEXEC)) return 1;
+#endif
+  return 0;
+}
+
+// JIT run path. Returns true when it produced the final result in *out
+// (program ran, or codegen failed); false means "not JIT-able here" and
+// the caller continues with the AOT temp-binary path — nothing ran yet.
+static bool aot_jit_run_silent(const char *source, const char *source_filename,
+                               AOTResult *out) {
+  ASTNode_C *ast = parse_source(source, source_filename);
+  if (!ast) {
+    *out = AOT_ERROR_PARSE;
+    return true;
+  }
+  LLVMBackend *backend = llvm_backend_create("tulpar_jit_module");
+  if (!backend) {
+    ast_node_free(ast);
+    return false;
+  }
+  backend->quiet = 1;
+  backend->source_text = source;
+  backend->source_filename = source_filename;
+  {
+    AOTPhaseTimer t("codegen");
+    llvm_backend_compile(backend, ast);
+  }
+  if (backend->had_error) {
+    llvm_backend_destroy(backend);
+    ast_node_free(ast);
+    *out = AOT_ERROR_CODEGEN;
+    return true;
+  }
+  int exit_code = 0;
+  int rc = llvm_backend_jit_run(backend, &exit_code);
+  if (rc != 0) {
+    AOT_PROGRESS("[AOT] JIT unavailable for this program; using AOT.\n");
+    llvm_backend_destroy(backend);
+    ast_node_free(ast);
+    return false;
+  }
+  llvm_backend_destroy(backend);
+  ast_node_free(ast);
+  *out = (exit_code == 0) ? AOT_OK : AOT_RAN_NONZERO;
+  return true;
+}
+
 // Silent compile and run - used as default execution mode.
 // Compiles to temp binary, runs it, cleans up. No [AOT] output.
 AOTResult aot_compile_and_run_silent(const char *source) {
@@ -1348,6 +1562,11 @@ AOTResult aot_compile_and_run_silent(const char *source) {
 
 AOTResult aot_compile_and_run_silent_with_filename(const char *source,
                                                    const char *source_filename) {
+  if (aot_run_wants_jit()) {
+    AOTResult jit_result;
+    if (aot_jit_run_silent(source, source_filename, &jit_result))
+      return jit_result;
+  }
 #if PLATFORM_WINDOWS
   const char *base = "tulpar_run_tmp";
   AOTResult result = aot_compile_silent(source, base, source_filename);
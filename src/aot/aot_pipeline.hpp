@@ -36,6 +36,20 @@ void aot_set_android_apk(int enable);
 // Play Store'a yüklenebilir imzalı <out>.aab (bundletool). Android hedefini ima
 // eder; --apk yerine geçer (ikisi verilirse --aab kazanır).
 void aot_set_android_aab(int enable);
+// `-j N` / `--jobs=N`: optimise + emit the module as N partitions on N
+// threads (llvm_parallel.cpp), then link them together. 0 leaves the choice
+// to TULPAR_BUILD_JOBS (default 1 = single module); a negative value means
+// one job per hardware thread. Output is deterministic for a given N.
+void aot_set_build_jobs(int jobs);
+// `--allocator=system`: the generated main() switches the runtime's object
+// allocator to plain malloc (tulpar_alloc_select) before anything runs.
+// 0 keeps the default thread-caching allocator (runtime/tulpar_alloc.cpp).
+void aot_set_allocator(int use_system);
+// `--checks=release|full|none` (0 / 1 / 2, ChecksMode in llvm_backend.hpp).
+// release (default) drops the typed-array bounds checks a `for` loop's range
+// proves; full keeps every bounds check and also reports int overflow;
+// none emits no typed-array bounds checks (`unchecked { }` for a whole build).
+void aot_set_checks(int level);
 
 // Compile Tulpar source to executable (verbose mode).
 // Returns AOT_OK on success, error code otherwise.
@@ -64,6 +78,12 @@ AOTResult aot_compile_and_run(const char *source);
 // Silent compile and run - no [AOT] messages, temp binary, auto-cleanup.
 // Returns AOT_OK on success. Used as default execution mode.
 AOTResult aot_compile_and_run_silent(const char *source);
+// `tulpar run` engine: 1 = JIT the module in-process with ORC LLJIT at O1
+// (no temp binary, no link, works with a noexec /tmp), 0 = AOT temp binary.
+// Unset, TULPAR_RUN_MODE=jit|aot decides (default AOT, or JIT when /tmp is
+// noexec). Programs the JIT can't host (thread-local wings globals, tame)
+// transparently fall back to AOT.
+void aot_set_run_jit(int enable);
 AOTResult aot_compile_and_run_silent_with_filename(const char *source,
                                                    const char *source_filename);
 
@@ -27,6 +27,41 @@ struct CaptureData {
   std::unordered_map<ASTNode_C*, int> depths;
 };
 
+// Untyped functions with an unboxed int clone; see SPECIALISED CLONES.
+enum { SPEC_UNSEEN, SPEC_PENDING, SPEC_OK, SPEC_NO };
+
+struct SpecFunc {
+  ASTNode_C *node;
+  int state;          // SPEC_*; SPEC_PENDING while its own proof runs
+  int stdlib;         // declared by an embedded stdlib module
+  LLVMValueRef clone; // `<name>$i…`, declared once the proof succeeds
+};
+
+struct SpecData {
+  std::unordered_map<std::string, SpecFunc> funcs;
+  // Locals of the function being emitted that only ever hold ints
+  // (collect_spec_int_locals); null outside one.
+  const std::unordered_set<std::string> *int_locals = nullptr;
+  int calls = 0;
+  int stdlib_calls = 0;
+  int clones = 0;
+};
+
+// Typed-array accesses `<array>[<index> + c]` proved in bounds for every c
+// in [min_off, max_off]; see RANGE-PROVED ARRAY ACCESSES.
+struct RangeFact {
+  std::string index;   // induction variable of the enclosing loop
+  LLVMValueRef header; // the array's header alloca (LocalVar::value)
+  long long min_off, max_off;
+};
+
+struct RangeData {
+  std::vector<RangeFact> facts; // of the loop bodies being emitted
+  int elided = 0;               // accesses emitted without their check
+  int static_loops = 0;         // loops proved at compile time
+  int versioned_loops = 0;      // loops emitted twice behind a guard
+};
+
 static void collect_declared_locals(ASTNode_C *node, std::unordered_set<std::string> &declared) {
   if (!node) return;
   if (node->type == AST_VARIABLE_DECL) {
@@ -363,6 +398,19 @@ static void report_codegen_error(LLVMBackend *backend, int line,
                                  const char *kind, const char *message,
                                  const char *caret_token, const char *hint);
 
+static void lower_range_for_in(LLVMBackend *backend, ASTNode_C *node);
+LLVMTypeRef get_function_type(LLVMBackend *backend, const char *name);
+
+// `range(...)` call that a for-in can iterate without materialising: the
+// builtin (no user function shadows it) with 1-3 arguments.
+static int for_in_is_range(LLVMBackend *backend, ASTNode_C *iterable) {
+  return iterable && iterable->type == AST_FUNCTION_CALL && iterable->name &&
+         !iterable->receiver && !iterable->callee &&
+         strcmp(iterable->name, "range") == 0 &&
+         iterable->argument_count >= 1 && iterable->argument_count <= 3 &&
+         !get_function_type(backend, "range");
+}
+
 // Lowers `for (name in iterable) body` to a desugared C-style for over an
 // index, in place. The original AST_FOR_IN node is mutated into an AST_BLOCK
 // whose statements are equivalent to:
@@ -380,7 +428,11 @@ static void report_codegen_error(LLVMBackend *backend, int line,
 // exactly once on shutdown. Necessary because AST_FOR_IN had no codegen case
 // at all in this backend — `for (x in arr) { ... }` silently produced an
 // exe that did nothing.
-static void lower_for_in_in_place(ASTNode_C *node) {
+static void lower_for_in_in_place(LLVMBackend *backend, ASTNode_C *node) {
+  if (for_in_is_range(backend, node->iterable)) {
+    lower_range_for_in(backend, node);
+    return;
+  }
   ASTNode_C *iterable = node->iterable;
   ASTNode_C *body = node->body;
   char *loop_var = node->name;
@@ -496,6 +548,165 @@ static void lower_for_in_in_place(ASTNode_C *node) {
   node->statements[2] = for_node;
 }
 
+// Compile-time step of a range() call: 1 when omitted, the value of an int
+// literal (or `-literal`), else 0 = "only known at run time".
+static long long range_literal_step(ASTNode_C *range_call) {
+  if (range_call->argument_count < 3) return 1;
+  ASTNode_C *s = range_call->arguments[2];
+  if (s->type == AST_INT_LITERAL) return s->value.int_value;
+  if (s->type == AST_UNARY_OP && s->op == TOKEN_MINUS && s->left &&
+      s->left->type == AST_INT_LITERAL)
+    return -s->left->value.int_value;
+  return 0;
+}
+
+// `for (name in range(...))` — the for-in whose iterable we can see through
+// at compile time. range() itself materialises an ObjArray of boxed ints
+// (range(10000000) = 160 MB of arena) only for the loop to index it back
+// out; here the call is dropped and the loop counts natively:
+//
+//   { int <name>; int __forin_idx = <start>; int __forin_end = <end>;
+//     [int __forin_step = <step>;]
+//     for (; <cond>; __forin_idx = __forin_idx + <step>) {
+//       <name> = __forin_idx;
+//       <body>
+//     } }
+//
+// Memory is O(1) and the body is a plain i64 induction loop LLVM can unroll
+// and vectorise. Arguments are evaluated once, left to right, like the call,
+// and truncated like toInt() (as aot_range_step does), unless they are
+// already ints: `range(1.5, 4)` counts 1, 2, 3 either way.
+// <cond> is `idx < end` / `idx > end` for a literal step; a run-time step
+// tests its sign (`step > 0 && idx < end || step < 0 && idx > end`), so a 0
+// step is an empty loop — the same as the materialised range().
+// Assigning to <name> in the body doesn't disturb the iteration, matching
+// the array-backed lowering.
+static void lower_range_for_in(LLVMBackend *backend, ASTNode_C *node) {
+  ASTNode_C *call = node->iterable;
+  ASTNode_C *body = node->body;
+  int line = node->line;
+  int argc = call->argument_count;
+  long long lit_step = range_literal_step(call);
+
+  char idx_name[48], end_name[48], step_name[48];
+  std::snprintf(idx_name, sizeof(idx_name), "__forin_idx_%d_%p", line,
+                static_cast<void *>(node));
+  std::snprintf(end_name, sizeof(end_name), "__forin_end_%d_%p", line,
+                static_cast<void *>(node));
+  std::snprintf(step_name, sizeof(step_name), "__forin_step_%d_%p", line,
+                static_cast<void *>(node));
+
+  auto mk_id = [&](const char *n) {
+    ASTNode_C *id = ast_node_create(AST_IDENTIFIER);
+    id->name = strdup(n);
+    id->line = line;
+    return id;
+  };
+  auto mk_int = [&](long long v) {
+    ASTNode_C *lit = ast_node_create(AST_INT_LITERAL);
+    lit->value.int_value = v;
+    lit->line = line;
+    return lit;
+  };
+  auto mk_decl = [&](const char *n, ASTNode_C *init) {
+    ASTNode_C *d = ast_node_create(AST_VARIABLE_DECL);
+    d->name = strdup(n);
+    d->data_type = TYPE_INT;
+    d->right = init;
+    d->line = line;
+    return d;
+  };
+  auto mk_bin = [&](TulparTokenType op, ASTNode_C *l, ASTNode_C *r) {
+    ASTNode_C *b = ast_node_create(AST_BINARY_OP);
+    b->op = op;
+    b->left = l;
+    b->right = r;
+    b->line = line;
+    return b;
+  };
+  // toInt(arg) unless arg is an int literal or an int local.
+  auto mk_to_int = [&](ASTNode_C *arg) {
+    if (!arg || arg->type == AST_INT_LITERAL ||
+        (arg->type == AST_IDENTIFIER &&
+         get_local_type(backend, arg->name) == INFERRED_INT))
+      return arg;
+    ASTNode_C *c = ast_node_create(AST_FUNCTION_CALL);
+    c->name = strdup("toInt");
+    c->argument_count = 1;
+    c->arguments = static_cast<ASTNode_C **>(std::calloc(1, sizeof(ASTNode_C *)));
+    c->arguments[0] = arg;
+    c->line = line;
+    return c;
+  };
+
+  // range(end) / range(start, end) / range(start, end, step) — the argument
+  // nodes move into the decls; the call node itself is freed below.
+  ASTNode_C *start = argc >= 2 ? mk_to_int(call->arguments[0]) : mk_int(0);
+  ASTNode_C *end = mk_to_int(argc >= 2 ? call->arguments[1] : call->arguments[0]);
+  ASTNode_C *step = argc >= 3 ? call->arguments[2] : nullptr;
+  for (int i = 0; i < argc; i++) call->arguments[i] = nullptr;
+  ast_node_free(call);
+
+  ASTNode_C *stmts[5];
+  int n = 0;
+  stmts[n++] = mk_decl(node->name, nullptr);
+  stmts[n++] = mk_decl(idx_name, start);
+  stmts[n++] = mk_decl(end_name, end);
+  ASTNode_C *cond;
+  ASTNode_C *incr_by;
+  if (lit_step > 0 || lit_step < 0) {
+    if (step) ast_node_free(step); // a literal: nothing to evaluate
+    cond = mk_bin(lit_step > 0 ? TOKEN_LESS : TOKEN_GREATER, mk_id(idx_name),
+                  mk_id(end_name));
+    incr_by = mk_int(lit_step);
+  } else {
+    stmts[n++] = mk_decl(step_name, mk_to_int(step));
+    ASTNode_C *up = mk_bin(
+        TOKEN_AND, mk_bin(TOKEN_GREATER, mk_id(step_name), mk_int(0)),
+        mk_bin(TOKEN_LESS, mk_id(idx_name), mk_id(end_name)));
+    ASTNode_C *down = mk_bin(
+        TOKEN_AND, mk_bin(TOKEN_LESS, mk_id(step_name), mk_int(0)),
+        mk_bin(TOKEN_GREATER, mk_id(idx_name), mk_id(end_name)));
+    cond = mk_bin(TOKEN_OR, up, down);
+    incr_by = mk_id(step_name);
+  }
+
+  ASTNode_C *idx_inc = ast_node_create(AST_ASSIGNMENT);
+  idx_inc->name = strdup(idx_name);
+  idx_inc->right = mk_bin(TOKEN_PLUS, mk_id(idx_name), incr_by);
+  idx_inc->line = line;
+
+  ASTNode_C *name_assign = ast_node_create(AST_ASSIGNMENT);
+  name_assign->name = strdup(node->name);
+  name_assign->right = mk_id(idx_name);
+  name_assign->line = line;
+
+  ASTNode_C *new_body = ast_node_create(AST_BLOCK);
+  new_body->statement_count = 2;
+  new_body->statements =
+      static_cast<ASTNode_C **>(std::calloc(2, sizeof(ASTNode_C *)));
+  new_body->statements[0] = name_assign;
+  new_body->statements[1] = body;
+  new_body->line = line;
+
+  ASTNode_C *for_node = ast_node_create(AST_FOR);
+  for_node->condition = cond;
+  for_node->increment = idx_inc;
+  for_node->body = new_body;
+  for_node->line = line;
+  stmts[n++] = for_node;
+
+  std::free(node->name);
+  node->type = AST_BLOCK;
+  node->name = nullptr;
+  node->iterable = nullptr;
+  node->body = nullptr;
+  node->statement_count = n;
+  node->statements =
+      static_cast<ASTNode_C **>(std::calloc(n, sizeof(ASTNode_C *)));
+  for (int i = 0; i < n; i++) node->statements[i] = stmts[i];
+}
+
 // ---------------------------------------------------------------------------
 // "Did you mean..?" Levenshtein-based suggestion helper for diagnostics.
 // ---------------------------------------------------------------------------
@@ -893,6 +1104,20 @@ static const TameBuiltin *tame_builtin_lookup(const char *name) {
   return nullptr;
 }
 
+// Which try/catch lowering this target gets (must match TULPAR_EH_UNWIND in
+// runtime/tulpar_eh.h for the runtime it links against). Itanium-ABI targets
+// unwind with landing pads; Windows x64 would need SEH funclets
+// (catchswitch/catchpad) rather than landingpad, and wasm32 has no unwinder
+// without -fwasm-exceptions, so both keep setjmp/longjmp.
+static int llvm_eh_uses_unwind(LLVMBackend *backend) {
+#ifdef _WIN32
+  (void)backend;
+  return 0;
+#else
+  return backend->target_web ? 0 : 1;
+#endif
+}
+
 // Declare external runtime functions
 void declare_runtime_functions(LLVMBackend *backend) {
   // printf: i32 printf(i8*, ...)
@@ -1178,6 +1403,69 @@ void declare_runtime_functions(LLVMBackend *backend) {
   backend->func_aot_array_set_raw_fast = LLVMAddFunction(
       backend->module, "aot_array_set_raw_fast", set_raw_fast_type);
 
+  // Unboxed typed arrays (`arrayInt a = [];` locals — see typed_array_*).
+  // tulpar_array_grow(ptr data, i64 capacity, i64 elem_size) -> ptr
+  LLVMTypeRef ta_grow_params[] = {backend->ptr_type, backend->int_type,
+                                  backend->int_type};
+  backend->func_tulpar_array_grow = LLVMAddFunction(
+      backend->module, "tulpar_array_grow",
+      LLVMFunctionType(backend->ptr_type, ta_grow_params, 3, 0));
+  // tulpar_array_release(ptr data) -> void
+  LLVMTypeRef ta_release_params[] = {backend->ptr_type};
+  backend->func_tulpar_array_release = LLVMAddFunction(
+      backend->module, "tulpar_array_release",
+      LLVMFunctionType(backend->void_type, ta_release_params, 1, 0));
+  // aot_typed_array_box(ptr data, i64 count, i64 kind) -> VMValue
+  LLVMTypeRef ta_box_params[] = {backend->ptr_type, backend->int_type,
+                                 backend->int_type};
+  backend->func_aot_typed_array_box = LLVMAddFunction(
+      backend->module, "aot_typed_array_box",
+      llvm_make_vmvalue_func_type(backend, ta_box_params, 3, 0));
+  // aot_typed_array_oob() -> void
+  backend->func_aot_typed_array_oob = LLVMAddFunction(
+      backend->module, "aot_typed_array_oob",
+      LLVMFunctionType(backend->void_type, nullptr, 0, 0));
+  // aot_int_overflow() -> void (--checks=full)
+  backend->func_aot_int_overflow = LLVMAddFunction(
+      backend->module, "aot_int_overflow",
+      LLVMFunctionType(backend->void_type, nullptr, 0, 0));
+
+  // Stack container literals (see STACK CONTAINER LOCALS)
+  // aot_stack_array_init(ObjArray*, VMValue*, i32 cap) -> ObjArray*
+  LLVMTypeRef sa_init_params[] = {backend->ptr_type, backend->ptr_type,
+                                  backend->int32_type};
+  backend->func_aot_stack_array_init = LLVMAddFunction(
+      backend->module, "aot_stack_array_init",
+      LLVMFunctionType(backend->ptr_type, sa_init_params, 3, 0));
+  // aot_stack_object_init(ObjObject*, ObjString**, VMValue*, i32 cap)
+  LLVMTypeRef so_init_params[] = {backend->ptr_type, backend->ptr_type,
+                                  backend->ptr_type, backend->int32_type};
+  backend->func_aot_stack_object_init = LLVMAddFunction(
+      backend->module, "aot_stack_object_init",
+      LLVMFunctionType(backend->ptr_type, so_init_params, 4, 0));
+
+  // Compiled struct toJson writer: begin() -> builder, raw/int/bool appends,
+  // end(builder) -> VMValue string.
+  backend->func_aot_json_buf_begin = LLVMAddFunction(
+      backend->module, "aot_json_buf_begin",
+      LLVMFunctionType(backend->ptr_type, nullptr, 0, 0));
+  LLVMTypeRef jb_raw_params[] = {backend->ptr_type, backend->ptr_type,
+                                 backend->int_type};
+  backend->func_aot_json_buf_raw = LLVMAddFunction(
+      backend->module, "aot_json_buf_raw",
+      LLVMFunctionType(backend->void_type, jb_raw_params, 3, 0));
+  LLVMTypeRef jb_val_params[] = {backend->ptr_type, backend->int_type};
+  backend->func_aot_json_buf_int = LLVMAddFunction(
+      backend->module, "aot_json_buf_int",
+      LLVMFunctionType(backend->void_type, jb_val_params, 2, 0));
+  backend->func_aot_json_buf_bool = LLVMAddFunction(
+      backend->module, "aot_json_buf_bool",
+      LLVMFunctionType(backend->void_type, jb_val_params, 2, 0));
+  LLVMTypeRef jb_end_params[] = {backend->ptr_type};
+  backend->func_aot_json_buf_end = LLVMAddFunction(
+      backend->module, "aot_json_buf_end",
+      llvm_make_vmvalue_func_type(backend, jb_end_params, 1, 0));
+
   // aot_input() -> VMValue
   LLVMTypeRef input_type = llvm_make_vmvalue_func_type(backend, nullptr, 0, 0);
   backend->func_aot_input =
@@ -1264,6 +1552,30 @@ void declare_runtime_functions(LLVMBackend *backend) {
   // long-lived globals. Same 1-arg VMValue→VMValue shape, reuses fmt_iso_type.
   backend->func_aot_persist =
       LLVMAddFunction(backend->module, "aot_persist", fmt_iso_type);
+  // aot_persist_move(value) -> value: a last use stored into a global (see
+  // OWNERSHIP MOVES) — the value itself when already permanent.
+  backend->func_aot_persist_move =
+      LLVMAddFunction(backend->module, "aot_persist_move", fmt_iso_type);
+  // aot_cow(value) -> value / aot_cow_element(target, index) -> element:
+  // copy-on-write for shared permanent nodes on a write path (see
+  // COPY-ON-WRITE WRITES).
+  backend->func_aot_cow =
+      LLVMAddFunction(backend->module, "aot_cow", fmt_iso_type);
+  LLVMTypeRef cow_elem_params[] = {backend->vm_value_type,
+                                   backend->vm_value_type};
+  backend->func_aot_cow_element = LLVMAddFunction(
+      backend->module, "aot_cow_element",
+      llvm_make_vmvalue_func_type(backend, cow_elem_params, 2, 0));
+  // aot_alias(value) -> value: the node a new alias shares is never shared
+  // by aot_persist afterwards.
+  backend->func_aot_alias =
+      LLVMAddFunction(backend->module, "aot_alias", fmt_iso_type);
+  // arc_share_vmvalue(VMValue*) -> void: a global's initial value becomes
+  // reachable from every thread, so its ARC counts switch to atomic.
+  LLVMTypeRef share_params[] = {backend->ptr_type};
+  backend->func_arc_share_vmvalue = LLVMAddFunction(
+      backend->module, "arc_share_vmvalue",
+      LLVMFunctionType(backend->void_type, share_params, 1, 0));
 
   // Regex (std::regex) builtins. Two-arg: match/search/capture; three-arg: replace.
   LLVMTypeRef regex2_params[] = {backend->vm_value_type, backend->vm_value_type};
@@ -1315,6 +1627,16 @@ void declare_runtime_functions(LLVMBackend *backend) {
   backend->func_aot_arena_drop =
       LLVMAddFunction(backend->module, "aot_arena_drop", arena_restore_type);
 
+  // aot_arc_stats() -> json, aot_arc_drain() -> int (deferred ARC frees)
+  LLVMTypeRef arc_stats_type = llvm_make_vmvalue_func_type(backend, nullptr, 0, 0);
+  backend->func_aot_arc_stats =
+      LLVMAddFunction(backend->module, "aot_arc_stats", arc_stats_type);
+  backend->func_aot_arc_drain =
+      LLVMAddFunction(backend->module, "aot_arc_drain", arc_stats_type);
+  // aot_arena_stats() -> json (arena blocks / trims, same shape)
+  backend->func_aot_arena_stats =
+      LLVMAddFunction(backend->module, "aot_arena_stats", arc_stats_type);
+
   // aot_trim_ptr(VMValue*) -> VMValue
   LLVMTypeRef trim_params[] = {backend->ptr_type};
   LLVMTypeRef trim_type =
@@ -1365,6 +1687,8 @@ void declare_runtime_functions(LLVMBackend *backend) {
 
   backend->func_aot_file_exists =
       LLVMAddFunction(backend->module, "aot_file_exists_ptr", read_type);
+  backend->func_aot_file_delete =
+      LLVMAddFunction(backend->module, "aot_file_delete_ptr", read_type);
 
   // aot_sys_run(cmd) -> int : run a shell command, return its exit code.
   // Same single-VMValue-pointer ABI as read_file.
@@ -1507,6 +1831,22 @@ void declare_runtime_functions(LLVMBackend *backend) {
   backend->func_frameaddress = nullptr;
 #endif
 
+  // Zero-cost EH: the personality routine, the TulparThrow typeinfo named by
+  // every landing pad's catch clause, and aot_eh_catch(exn) -> VMValue.
+  backend->eh_unwind = llvm_eh_uses_unwind(backend);
+  if (backend->eh_unwind) {
+    backend->eh_personality = LLVMAddFunction(
+        backend->module, "__gxx_personality_v0",
+        LLVMFunctionType(backend->int32_type, nullptr, 0, 1));
+    backend->eh_typeinfo =
+        LLVMAddGlobal(backend->module, backend->ptr_type, "_ZTI11TulparThrow");
+    LLVMSetGlobalConstant(backend->eh_typeinfo, 1);
+    LLVMTypeRef eh_catch_params[] = {backend->ptr_type};
+    backend->func_aot_eh_catch = LLVMAddFunction(
+        backend->module, "aot_eh_catch",
+        llvm_make_vmvalue_func_type(backend, eh_catch_params, 1, 0));
+  }
+
   // aot_clock_ms() -> VMValue (float ms)
   LLVMTypeRef clock_type = llvm_make_vmvalue_func_type(backend, nullptr, 0, 0);
   backend->func_aot_clock_ms =
@@ -1652,6 +1992,12 @@ void declare_runtime_functions(LLVMBackend *backend) {
       llvm_make_vmvalue_func_type(backend, str_concat_params, 2, 0);
   backend->func_aot_string_concat_fast = LLVMAddFunction(
       backend->module, "aot_string_concat_fast_ptr", str_concat_type);
+  // aot_string_append_inplace(VMValue *slot, VMValue *b, void **owner) -> void
+  LLVMTypeRef str_append_params[] = {backend->ptr_type, backend->ptr_type,
+                                     backend->ptr_type};
+  backend->func_aot_string_append_inplace = LLVMAddFunction(
+      backend->module, "aot_string_append_inplace",
+      LLVMFunctionType(backend->void_type, str_append_params, 3, 0));
 
   // ====== StringBuilder Functions ======
   // aot_stringbuilder_new(int capacity) -> ptr
@@ -1818,6 +2164,13 @@ void declare_runtime_functions(LLVMBackend *backend) {
   backend->func_aot_wings_find_route = LLVMAddFunction(
       backend->module, "aot_wings_find_route", wings_find_route_type);
 
+  // aot_wings_encode_model(schema, result) -> JSON string
+  LLVMTypeRef wings_encode_model_params[] = {backend->vm_value_type,
+                                             backend->vm_value_type};
+  backend->func_aot_wings_encode_model = LLVMAddFunction(
+      backend->module, "aot_wings_encode_model",
+      llvm_make_vmvalue_func_type(backend, wings_encode_model_params, 2, 0));
+
   // aot_string_pin(str) -> str (permanent copy)
   // VMValue->VMValue. Used by the wings response cache to pin entries
   // past the per-request `arena_restore`.
@@ -2058,6 +2411,12 @@ void declare_runtime_functions(LLVMBackend *backend) {
       llvm_make_vmvalue_func_type(backend, range_params, 1, 0);
   backend->func_aot_range =
       LLVMAddFunction(backend->module, "aot_range", range_type);
+  // aot_range_step(start, end, step) -> VMValue (array)
+  LLVMTypeRef range3_params[] = {backend->vm_value_type, backend->vm_value_type,
+                                 backend->vm_value_type};
+  backend->func_aot_range_step = LLVMAddFunction(
+      backend->module, "aot_range_step",
+      llvm_make_vmvalue_func_type(backend, range3_params, 3, 0));
 
   // ====== SQLite Database Functions ======
   // aot_db_open_ptr(path) -> int64 (db handle)
@@ -2110,6 +2469,45 @@ void declare_runtime_functions(LLVMBackend *backend) {
   backend->func_aot_db_error =
       LLVMAddFunction(backend->module, "aot_db_error", db_byval_type);
 
+  // Cursors and column-major reads, by value like db_last_insert_id:
+  // aot_db_cursor(db, sql, params) -> cursor, aot_db_next(cursor) -> row|0,
+  // aot_db_close_cursor(cursor), aot_db_query_columns(db, sql, params).
+  LLVMTypeRef db_byval3_params[] = {backend->vm_value_type,
+                                    backend->vm_value_type,
+                                    backend->vm_value_type};
+  LLVMTypeRef db_byval3_type =
+      llvm_make_vmvalue_func_type(backend, db_byval3_params, 3, 0);
+  backend->func_aot_db_cursor =
+      LLVMAddFunction(backend->module, "aot_db_cursor", db_byval3_type);
+  backend->func_aot_db_query_columns = LLVMAddFunction(
+      backend->module, "aot_db_query_columns", db_byval3_type);
+  backend->func_aot_db_next =
+      LLVMAddFunction(backend->module, "aot_db_next", db_byval_type);
+  backend->func_aot_db_close_cursor = LLVMAddFunction(
+      backend->module, "aot_db_close_cursor",
+      LLVMFunctionType(backend->void_type, db_byval_params, 1, 0));
+
+  // Prepared handles: aot_db_prepare(db, sql) -> stmt,
+  // aot_db_stmt_query/execute(stmt, params), aot_db_stats() -> object.
+  LLVMTypeRef db_byval2_type =
+      llvm_make_vmvalue_func_type(backend, db_byval3_params, 2, 0);
+  backend->func_aot_db_prepare =
+      LLVMAddFunction(backend->module, "aot_db_prepare", db_byval2_type);
+  backend->func_aot_db_stmt_query =
+      LLVMAddFunction(backend->module, "aot_db_stmt_query", db_byval2_type);
+  backend->func_aot_db_stmt_execute = LLVMAddFunction(
+      backend->module, "aot_db_stmt_execute", db_byval2_type);
+  backend->func_aot_db_stats = LLVMAddFunction(
+      backend->module, "aot_db_stats",
+      llvm_make_vmvalue_func_type(backend, nullptr, 0, 0));
+
+  // Batched writes: aot_db_executemany(db, sql, rows) -> bool,
+  // aot_db_group_commit(db, on) -> bool.
+  backend->func_aot_db_executemany = LLVMAddFunction(
+      backend->module, "aot_db_executemany", db_byval3_type);
+  backend->func_aot_db_group_commit = LLVMAddFunction(
+      backend->module, "aot_db_group_commit", db_byval2_type);
+
   // ====== Type Checking Functions ======
   LLVMTypeRef type_check_params[] = {backend->vm_value_type};
   LLVMTypeRef type_check_type =
@@ -2143,6 +2541,19 @@ void llvm_backend_set_target_web(int enable) {
   g_backend_target_web = enable ? 1 : 0;
 }
 
+static int g_backend_alloc_system = 0;
+
+void llvm_backend_set_allocator(int use_system) {
+  g_backend_alloc_system = use_system ? 1 : 0;
+}
+
+static int g_backend_checks = CHECKS_RELEASE;
+
+void llvm_backend_set_checks(int mode) {
+  g_backend_checks =
+      (mode == CHECKS_FULL || mode == CHECKS_NONE) ? mode : CHECKS_RELEASE;
+}
+
 LLVMBackend *llvm_backend_create(const char *module_name) {
   // calloc instead of malloc: every counter / pointer field defaults to 0 /
   // NULL. Previously this struct grew via malloc and each new counter had
@@ -2182,6 +2593,8 @@ LLVMBackend *llvm_backend_create(const char *module_name) {
   backend->function_count = 0;
   backend->imported_count = 0;
   backend->capture_data = new CaptureData();
+  backend->spec_data = new SpecData();
+  backend->range_data = new RangeData();
 
   // Enable static typing by default for performance
   backend->use_static_typing = 1;
@@ -2200,6 +2613,8 @@ LLVMBackend *llvm_backend_create(const char *module_name) {
   // Web hedefi — MUTLAKA declare_runtime_functions'tan önce (VMValue
   // fonksiyon tiplerinin şekli buna bağlı; bkz. g_backend_target_web notu).
   backend->target_web = g_backend_target_web;
+  backend->alloc_system = g_backend_alloc_system;
+  backend->checks_mode = g_backend_checks;
 
   // Declare Runtime
   declare_runtime_functions(backend);
@@ -2236,6 +2651,14 @@ void llvm_backend_destroy(LLVMBackend *backend) {
     delete static_cast<CaptureData*>(backend->capture_data);
     backend->capture_data = nullptr;
   }
+  if (backend->spec_data) {
+    delete static_cast<SpecData*>(backend->spec_data);
+    backend->spec_data = nullptr;
+  }
+  if (backend->range_data) {
+    delete static_cast<RangeData*>(backend->range_data);
+    backend->range_data = nullptr;
+  }
   free(backend);
 }
 
@@ -2360,6 +2783,8 @@ static int scope_decl_slot(Scope *s, const char *name) {
       free(s->vars[i].name);
       if (s->vars[i].struct_type_name) free(s->vars[i].struct_type_name);
       s->vars[i].struct_type_name = nullptr;
+      s->vars[i].typed_array = TYPE_UNKNOWN;
+      s->vars[i].str_owner = nullptr;
       return i;
     }
   }
@@ -2628,6 +3053,7 @@ StructTypeEntry *register_struct_type(LLVMBackend *backend, ASTNode_C *type_decl
   char ty_name[128];
   snprintf(ty_name, sizeof(ty_name), "tulpar_struct.%s", st->name);
   st->llvm_type = LLVMStructCreateNamed(backend->context, ty_name);
+  st->json_fn = nullptr;
   LLVMStructSetBody(st->llvm_type, field_llvm, (unsigned)st->field_count, 0);
   free(field_llvm);
 
@@ -2851,6 +3277,8 @@ typedef struct {
 // Forward declarations for typed codegen
 TypedValue codegen_typed_expr(LLVMBackend *backend, ASTNode_C *node);
 LLVMValueRef box_typed_value(LLVMBackend *backend, TypedValue tv);
+static int spec_emit_call(LLVMBackend *backend, ASTNode_C *node, int typed,
+                          LLVMValueRef *out);
 
 // Box a typed value to VMValue when needed
 LLVMValueRef box_typed_value(LLVMBackend *backend, TypedValue tv) {
@@ -2864,141 +3292,2774 @@ LLVMValueRef box_typed_value(LLVMBackend *backend, TypedValue tv) {
     return llvm_build_vm_val_float(backend, tv.value);
   case INFERRED_BOOL: {
     // Convert i64 to bool VMValue
-    LLVMValueRef s = LLVMGetUndef(backend->vm_value_type);
-    s = LLVMBuildInsertValue(backend->builder, s,
-                             LLVMConstInt(backend->int32_type, 2, 0), 0, "");  // VM_VAL_BOOL = 2
-    s = LLVMBuildInsertValue(backend->builder, s, tv.value, 2, "");
-    return s;
+    return llvm_vm_make(backend, LLVMConstInt(backend->int32_type, 2, 0),
+                        tv.value, "");  // VM_VAL_BOOL = 2
   }
   default:
     return tv.value; // Already boxed
   }
 }
 
-// Typed expression codegen - returns native values when possible
-TypedValue codegen_typed_expr(LLVMBackend *backend, ASTNode_C *node) {
-  TypedValue result = {nullptr, INFERRED_UNKNOWN, nullptr};
+// ============================================================
+// UNBOXED TYPED ARRAYS (arrayInt / arrayFloat / arrayBool locals)
+// ============================================================
+//
+// A typed array local that never escapes its function is lowered to a
+// plain native buffer instead of an ObjArray of 16-byte VMValues:
+//
+//   header alloca  { ptr data, i32 count, i32 capacity }   (TulparArrayInt)
+//   data           malloc'd i64[] / double[] / i8[]
+//
+// `a[i]` becomes an inline `idx <u count` check + GEP + load (the OOB arm
+// prints the usual runtime error and yields 0, like vm_array_get), `a[i] = v`
+// a checked GEP + store, `push(a, v)` an inline append that only calls
+// tulpar_array_grow when count hits capacity, and `len(a)` a load of the
+// count field. Nothing is boxed inside the hot loop; `sieve` runs on an i64
+// buffer with no tag checks left for LLVM to prove away. The index check
+// itself is dropped where a counted loop proves the index in range (see
+// RANGE-PROVED ARRAY ACCESSES).
+//
+// The array is boxed (aot_typed_array_box — a snapshot ObjArray copy) only
+// at the dynamic boundaries the escape scan below allows: a bare `a` in
+// print / toJson / return / a for-in iterable. Any other bare use — passing
+// it to a function, storing it into a json/object, capturing it in a lambda,
+// `a = ...` reassignment, a shadowing decl — keeps the WHOLE local on the
+// boxed path, because the snapshot would silently break aliasing there
+// (`f(a)` mutating `a`, `json j = a; push(j, 1)`).
+//
+// Arrays of a trivially-unboxable struct (`array pts = []` whose every push
+// is a `V3`) use the same header with the struct's LLVM type as element:
+// an inline array-of-structs. `pts[i].x` is one GEP + load, `V3 p = pts[i]`
+// one struct copy, and push amortises with the same x2 growth instead of
+// heap-promoting every element to its own ObjStruct. Such an array is never
+// boxed — any use other than push / len / element field access / element
+// copy-out keeps it on the ObjArray path.
+//
+// Scope: only locals of a boxed-ABI user function (codegen_func_def).
+// Globals and lambda locals stay boxed; the native i64 function path never
+// sees array decls. The buffer is freed on every `return` and at function
+// end; a `throw` that unwinds past the function leaks it (same as the
+// setjmp EH already leaks any malloc a frame owned).
+
+static int is_typed_array_kind(DataType t) {
+  return t == TYPE_ARRAY_INT || t == TYPE_ARRAY_FLOAT || t == TYPE_ARRAY_BOOL;
+}
 
-  if (!node)
-    return result;
+static LLVMTypeRef typed_array_header_type(LLVMBackend *backend) {
+  LLVMTypeRef fields[] = {backend->ptr_type, backend->int32_type,
+                          backend->int32_type};
+  return LLVMStructTypeInContext(backend->context, fields, 3, 0);
+}
 
-  switch (node->type) {
-  case AST_INT_LITERAL:
-    result.value = LLVMConstInt(backend->int_type, node->value.int_value, 1);
-    result.type = INFERRED_INT;
-    return result;
+static LLVMTypeRef typed_array_elem_type(LLVMBackend *backend, DataType kind) {
+  if (kind == TYPE_ARRAY_FLOAT) return backend->float_type;
+  if (kind == TYPE_ARRAY_BOOL) return LLVMInt8TypeInContext(backend->context);
+  return backend->int_type;
+}
 
-  case AST_FLOAT_LITERAL:
-    result.value = LLVMConstReal(backend->float_type, node->value.float_value);
-    result.type = INFERRED_FLOAT;
-    return result;
+// aot_typed_array_box's `kind` argument: 0 int64, 1 double, 2 int8 bool.
+static long long typed_array_box_kind(DataType kind) {
+  if (kind == TYPE_ARRAY_FLOAT) return 1;
+  if (kind == TYPE_ARRAY_BOOL) return 2;
+  return 0;
+}
 
-  case AST_BOOL_LITERAL:
-    result.value = LLVMConstInt(backend->int_type, node->value.bool_value, 0);
-    result.type = INFERRED_BOOL;
-    return result;
+// Receiver name of `x[i]`: the C bridge puts it on node->left (an
+// AST_IDENTIFIER); some legacy paths still use node->name.
+static const char *array_access_receiver(ASTNode_C *access) {
+  if (!access || access->type != AST_ARRAY_ACCESS) return nullptr;
+  if (access->left && access->left->type == AST_IDENTIFIER && access->left->name)
+    return access->left->name;
+  if (!access->left) return access->name;
+  return nullptr;
+}
 
-  case AST_IDENTIFIER: {
-    // Captured closure variable: read it out of the heap env array. The
-    // typed fast path below can't see it (get_local_native is null for
-    // captured vars and get_local's value pointer is null), so without
-    // this branch `n + x` inside a closure would read `n` as 0. Mirrors
-    // the captured-read branch in codegen_expression's AST_IDENTIFIER.
-    LocalVar *cap_var = get_local_var(backend, node->name);
-    if (cap_var && cap_var->is_captured == 1) {
-      LLVMValueRef env =
-          find_env_for_decl(backend, cap_var->declaring_function);
-      LLVMValueRef idx_val =
-          LLVMConstInt(backend->int32_type, cap_var->slot_index, 0);
-      LLVMValueRef get_args[] = {env, idx_val};
-      result.boxed = llvm_call_vmvalue_func(
-          backend, backend->func_vm_array_get, get_args, 2, node->name);
-      result.value = result.boxed;
-      result.type = INFERRED_UNKNOWN;
-      return result;
+static int ast_is_identifier(ASTNode_C *n, const char *name) {
+  return n && n->type == AST_IDENTIFIER && n->name && strcmp(n->name, name) == 0;
+}
+
+// Calls fn(child) for every non-null direct child of `n`, in source order:
+// parameters and struct field defaults, the expression slots, call
+// arguments and literal elements/values, then the branches, bodies and
+// statement lists. Stops at the first child for which fn returns false and
+// returns false. Every AST analysis below walks through this so none of
+// them can miss a child field; ast_node_free_recursive is the reference.
+template <typename Fn> static bool for_each_child(ASTNode_C *n, Fn &&fn) {
+  if (!n) return true;
+  for (int i = 0; i < n->param_count; i++)
+    if (n->parameters[i] && !fn(n->parameters[i])) return false;
+  if (n->field_defaults)
+    for (int i = 0; i < n->field_count; i++)
+      if (n->field_defaults[i] && !fn(n->field_defaults[i])) return false;
+  ASTNode_C *head[] = {n->init,     n->condition, n->left,  n->right,
+                       n->iterable, n->receiver,  n->callee, n->index};
+  for (ASTNode_C *k : head)
+    if (k && !fn(k)) return false;
+  for (int i = 0; i < n->argument_count; i++)
+    if (n->arguments[i] && !fn(n->arguments[i])) return false;
+  for (int i = 0; i < n->element_count; i++)
+    if (n->elements[i] && !fn(n->elements[i])) return false;
+  for (int i = 0; i < n->object_count; i++)
+    if (n->object_values[i] && !fn(n->object_values[i])) return false;
+  ASTNode_C *branches[] = {n->then_branch, n->else_branch, n->body,
+                           n->increment};
+  for (ASTNode_C *k : branches)
+    if (k && !fn(k)) return false;
+  for (int i = 0; i < n->statement_count; i++)
+    if (n->statements[i] && !fn(n->statements[i])) return false;
+  ASTNode_C *tail[] = {n->return_value, n->throw_expr, n->try_block,
+                       n->catch_block,  n->finally_block};
+  for (ASTNode_C *k : tail)
+    if (k && !fn(k)) return false;
+  return true;
+}
+
+// Does `name` appear anywhere under `n` (reads, writes, decls, params)?
+// Used for lambda / nested function bodies, where any reference would have
+// to go through a capture.
+static int ast_mentions_name(ASTNode_C *n, const char *name) {
+  if (!n) return 0;
+  if (n->type != AST_FUNCTION_CALL && n->name && strcmp(n->name, name) == 0)
+    return 1;
+  if (n->catch_var && strcmp(n->catch_var, name) == 0) return 1;
+  return !for_each_child(n, [&](ASTNode_C *k) {
+    return !ast_mentions_name(k, name);
+  });
+}
+
+// Struct name a VAR_DECL / parameter was declared with (`V3 p`), mirroring
+// the lookup in AST_VARIABLE_DECL's typed-struct path.
+static const char *decl_struct_name(ASTNode_C *decl) {
+  if (!decl || decl->data_type != TYPE_CUSTOM) return nullptr;
+  if (decl->return_custom_type) return decl->return_custom_type;
+  if (decl->field_custom_types && decl->field_count > 0)
+    return decl->field_custom_types[0];
+  return nullptr;
+}
+
+// Struct type of every VAR_DECL named `name` under `n`; sets *conflict when
+// two of them disagree (or one isn't a struct at all).
+static void find_decl_struct(ASTNode_C *n, const char *name, const char **out,
+                             int *conflict) {
+  if (!n || *conflict || n->type == AST_LAMBDA ||
+      n->type == AST_FUNCTION_DECL)
+    return;
+  if (n->type == AST_VARIABLE_DECL && n->name && strcmp(n->name, name) == 0) {
+    const char *sn = decl_struct_name(n);
+    if (!sn || (*out && strcmp(*out, sn) != 0)) {
+      *conflict = 1;
+      return;
     }
+    *out = sn;
+  }
+  for_each_child(n, [&](ASTNode_C *k) {
+    find_decl_struct(k, name, out, conflict);
+    return true;
+  });
+}
 
-    InferredType var_type = get_local_type(backend, node->name);
-    LLVMValueRef native = get_local_native(backend, node->name);
+// Static struct type of a push()ed value, from the AST alone: a call to a
+// struct-returning function, or a parameter / local declared `V3 x`.
+static const char *ast_static_struct_name(LLVMBackend *backend,
+                                          ASTNode_C *func, ASTNode_C *e) {
+  if (!e) return nullptr;
+  if (e->type == AST_FUNCTION_CALL && e->name && !e->receiver && !e->callee) {
+    for (int i = 0; i < backend->function_count; i++)
+      if (strcmp(backend->functions[i].name, e->name) == 0)
+        return backend->functions[i].return_struct_name;
+    return nullptr;
+  }
+  if (e->type != AST_IDENTIFIER || !e->name) return nullptr;
+  for (int i = 0; i < func->param_count; i++)
+    if (func->parameters[i] && func->parameters[i]->name &&
+        strcmp(func->parameters[i]->name, e->name) == 0)
+      return decl_struct_name(func->parameters[i]);
+  const char *sn = nullptr;
+  int conflict = 0;
+  find_decl_struct(func->body, e->name, &sn, &conflict);
+  return conflict ? nullptr : sn;
+}
 
-    if (var_type != INFERRED_UNKNOWN && native) {
-      result.value = LLVMBuildLoad2(
-          backend->builder,
-          var_type == INFERRED_FLOAT ? backend->float_type : backend->int_type,
-          native, node->name);
-      result.type = var_type;
-    } else {
-      // Fall back to boxed
-      LLVMValueRef val_ptr = get_local(backend, node->name);
-      if (val_ptr) {
-        result.boxed = LLVMBuildLoad2(backend->builder, backend->vm_value_type,
-                                      val_ptr, node->name);
-        result.value = result.boxed;
-      }
+// Element struct of `name` if every push(name, v) under `n` pushes the same
+// struct type; *bad is set on the first push that doesn't.
+static void struct_array_push_type(LLVMBackend *backend, ASTNode_C *func,
+                                   ASTNode_C *n, const char *name,
+                                   const char **out, int *bad) {
+  if (!n || *bad) return;
+  if (n->type == AST_FUNCTION_CALL && n->name && !n->receiver &&
+      strcmp(n->name, "push") == 0 && n->argument_count == 2 &&
+      ast_is_identifier(n->arguments[0], name)) {
+    const char *sn = ast_static_struct_name(backend, func, n->arguments[1]);
+    if (!sn || (*out && strcmp(*out, sn) != 0)) {
+      *bad = 1;
+      return;
     }
-    return result;
+    *out = sn;
   }
+  for_each_child(n, [&](ASTNode_C *k) {
+    struct_array_push_type(backend, func, k, name, out, bad);
+    return true;
+  });
+}
 
-  case AST_FUNCTION_CALL: {
-    // Look up the function
-    LLVMValueRef func = LLVMGetNamedFunction(backend->module, node->name);
-    if (func) {
-      LLVMTypeRef func_type = LLVMGlobalGetValueType(func);
-      LLVMTypeRef ret_type = LLVMGetReturnType(func_type);
+// Escape scan for struct arrays: push / len / toJson / `a[i].field` (read
+// or write) and `<St> p = a[i];` only. A bare `a[i]` anywhere else — or any bare `a`
+// — would need a boxed ObjStruct, so it disqualifies the local.
+static int struct_array_uses_ok(ASTNode_C *n, const char *name,
+                                ASTNode_C *decl, StructTypeEntry *st) {
+  if (!n) return 1;
+  switch (n->type) {
+  case AST_IDENTIFIER:
+    return !(n->name && strcmp(n->name, name) == 0);
+  case AST_LAMBDA:
+  case AST_FUNCTION_DECL:
+    return !ast_mentions_name(n, name);
+  case AST_ARRAY_ACCESS: {
+    const char *recv = array_access_receiver(n);
+    if (recv && strcmp(recv, name) == 0) return 0;
+    const char *inner = array_access_receiver(n->left);
+    if (inner && strcmp(inner, name) == 0) {
+      if (!n->index || n->index->type != AST_STRING_LITERAL ||
+          !n->index->value.string_value ||
+          struct_type_field_index(st, n->index->value.string_value) < 0)
+        return 0;
+      if (n->left->index && n->left->index->type == AST_STRING_LITERAL)
+        return 0;
+      return struct_array_uses_ok(n->left->index, name, decl, st);
+    }
+    break;
+  }
+  case AST_FUNCTION_CALL:
+    if (!n->receiver && !n->callee && n->name && n->argument_count >= 1 &&
+        ast_is_identifier(n->arguments[0], name)) {
+      if (strcmp(n->name, "push") == 0 && n->argument_count == 2)
+        return struct_array_uses_ok(n->arguments[1], name, decl, st);
+      if ((strcmp(n->name, "len") == 0 || strcmp(n->name, "length") == 0 ||
+           strcmp(n->name, "toJson") == 0) &&
+          n->argument_count == 1)
+        return 1;
+    }
+    break;
+  case AST_VARIABLE_DECL: {
+    if (n != decl && n->name && strcmp(n->name, name) == 0) return 0;
+    const char *sn = decl_struct_name(n);
+    const char *recv = array_access_receiver(n->right);
+    if (sn && strcmp(sn, st->name) == 0 && recv && strcmp(recv, name) == 0) {
+      if (n->right->index && n->right->index->type == AST_STRING_LITERAL)
+        return 0;
+      return struct_array_uses_ok(n->right->index, name, decl, st);
+    }
+    break;
+  }
+  case AST_ASSIGNMENT:
+    if (n->name && strcmp(n->name, name) == 0) return 0;
+    break;
+  case AST_COMPOUND_ASSIGN:
+  case AST_INCREMENT:
+  case AST_DECREMENT:
+    if (n->name && strcmp(n->name, name) == 0) return 0;
+    if (ast_mentions_name(n->left, name)) return 0;
+    break;
+  case AST_FOR_IN:
+    if (n->name && strcmp(n->name, name) == 0) return 0;
+    break;
+  case AST_TRY_CATCH:
+    if (n->catch_var && strcmp(n->catch_var, name) == 0) return 0;
+    break;
+  default:
+    break;
+  }
+  return for_each_child(n, [&](ASTNode_C *k) {
+    return struct_array_uses_ok(k, name, decl, st);
+  });
+}
 
-      // Check if it's a native function (returns i64 directly)
-      if (ret_type == backend->int_type) {
-        // Build arguments - convert to i64
-        int arg_count = node->argument_count;
-        LLVMValueRef *args = nullptr;
-        if (arg_count > 0) {
-          args = static_cast<LLVMValueRef*>(malloc(sizeof(LLVMValueRef) * arg_count));
-          for (int i = 0; i < arg_count; i++) {
-            TypedValue arg = codegen_typed_expr(backend, node->arguments[i]);
-            if (arg.type == INFERRED_INT || arg.type == INFERRED_BOOL) {
-              args[i] = arg.value;
-            } else if (arg.boxed) {
-              // Extract int from boxed value
-              args[i] = LLVMBuildExtractValue(backend->builder, arg.boxed, 2,
-                                              "arg_int");
-            } else {
-              args[i] = arg.value;
-            }
-          }
+// Escape scan: 1 when every use of `name` under `n` is one the unboxed
+// lowering handles (see the section comment). `decl` is the declaration
+// being considered — any other decl of the same name disqualifies it, since
+// scopes would make the two indistinguishable here.
+static int typed_array_uses_ok(ASTNode_C *n, const char *name, ASTNode_C *decl) {
+  if (!n) return 1;
+  switch (n->type) {
+  case AST_IDENTIFIER:
+    return !(n->name && strcmp(n->name, name) == 0);
+  case AST_LAMBDA:
+  case AST_FUNCTION_DECL:
+    return !ast_mentions_name(n, name);
+  case AST_ARRAY_ACCESS: {
+    const char *recv = array_access_receiver(n);
+    if (recv && strcmp(recv, name) == 0) {
+      // `a.field` / `a["k"]` is object sugar, not an element read.
+      if (n->index && n->index->type == AST_STRING_LITERAL) return 0;
+      return typed_array_uses_ok(n->index, name, decl);
+    }
+    break;
+  }
+  case AST_FUNCTION_CALL:
+    if (!n->receiver && !n->callee && n->name) {
+      if (strcmp(n->name, "push") == 0 && n->argument_count == 2 &&
+          ast_is_identifier(n->arguments[0], name))
+        return typed_array_uses_ok(n->arguments[1], name, decl);
+      if ((strcmp(n->name, "len") == 0 || strcmp(n->name, "length") == 0 ||
+           strcmp(n->name, "toJson") == 0) &&
+          n->argument_count == 1 && ast_is_identifier(n->arguments[0], name))
+        return 1;
+      if (strcmp(n->name, "print") == 0) {
+        for (int i = 0; i < n->argument_count; i++) {
+          if (ast_is_identifier(n->arguments[i], name)) continue;
+          if (!typed_array_uses_ok(n->arguments[i], name, decl)) return 0;
         }
-
-        result.value = LLVMBuildCall2(backend->builder, func_type, func, args,
-                                      arg_count, "call_native");
-        result.type = INFERRED_INT;
-        if (args)
-          free(args);
-        return result;
+        return 1;
       }
     }
-
-    // Fall back to boxed codegen
-    result.boxed = codegen_expression(backend, node);
-    result.value = result.boxed;
-    return result;
+    break;
+  case AST_RETURN:
+    if (ast_is_identifier(n->return_value, name)) return 1;
+    break;
+  case AST_FOR_IN:
+    if (n->name && strcmp(n->name, name) == 0) return 0;
+    if (ast_is_identifier(n->iterable, name))
+      return typed_array_uses_ok(n->body, name, decl);
+    break;
+  case AST_VARIABLE_DECL:
+    if (n != decl && n->name && strcmp(n->name, name) == 0) return 0;
+    break;
+  case AST_ASSIGNMENT:
+    if (n->name && strcmp(n->name, name) == 0) return 0;
+    break;
+  case AST_COMPOUND_ASSIGN:
+  case AST_INCREMENT:
+  case AST_DECREMENT: {
+    if (n->name && strcmp(n->name, name) == 0) return 0;
+    const char *recv = array_access_receiver(n->left);
+    if (recv && strcmp(recv, name) == 0) return 0;
+    break;
+  }
+  case AST_TRY_CATCH:
+    if (n->catch_var && strcmp(n->catch_var, name) == 0) return 0;
+    break;
+  default:
+    break;
   }
+  return for_each_child(n, [&](ASTNode_C *k) {
+    return typed_array_uses_ok(k, name, decl);
+  });
+}
 
-  case AST_BINARY_OP: {
-    TypedValue L = codegen_typed_expr(backend, node->left);
-    TypedValue R = codegen_typed_expr(backend, node->right);
+// Pre-pass over a function body (entry block, before any statement is
+// emitted): pick the typed-array decls that can live unboxed and give each
+// a zeroed header alloca. Lambdas / nested functions are not entered.
+static void collect_typed_array_decls(LLVMBackend *backend, ASTNode_C *func,
+                                      ASTNode_C *n, TypedArraySlot *slots,
+                                      int *count, int cap) {
+  if (!n || n->type == AST_LAMBDA || n->type == AST_FUNCTION_DECL) return;
+  if (n->type == AST_VARIABLE_DECL && n->name && *count < cap &&
+      (n->right ? n->right->type == AST_ARRAY_LITERAL
+                : is_typed_array_kind(n->data_type))) {
+    int ok = LLVMGetNamedGlobal(backend->module, n->name) == nullptr;
+    for (int i = 0; ok && i < func->param_count; i++)
+      if (func->parameters[i] && func->parameters[i]->name &&
+          strcmp(func->parameters[i]->name, n->name) == 0)
+        ok = 0;
+    CaptureData *cd = (CaptureData *)backend->capture_data;
+    if (ok && cd && cd->slots.find(func) != cd->slots.end() &&
+        cd->slots[func].find(n->name) != cd->slots[func].end())
+      ok = 0;
+
+    DataType kind = TYPE_UNKNOWN;
+    StructTypeEntry *elem_st = nullptr;
+    if (ok && is_typed_array_kind(n->data_type)) {
+      if (typed_array_uses_ok(func->body, n->name, n)) kind = n->data_type;
+    } else if (ok && n->right && n->right->element_count == 0 &&
+               (n->data_type == TYPE_ARRAY || n->data_type == TYPE_ARRAY_JSON ||
+                n->data_type == TYPE_JSON || n->data_type == TYPE_UNKNOWN)) {
+      // Untyped `[]` whose pushes are all one native struct type.
+      const char *sn = nullptr;
+      int bad = 0;
+      struct_array_push_type(backend, func, func->body, n->name, &sn, &bad);
+      elem_st = (!bad && sn) ? find_struct_type(backend, sn) : nullptr;
+      if (elem_st && struct_is_trivially_unboxable(elem_st) &&
+          struct_array_uses_ok(func->body, n->name, n, elem_st))
+        kind = TYPE_CUSTOM;
+    }
+
+    if (kind != TYPE_UNKNOWN) {
+      LLVMTypeRef hdr_ty = typed_array_header_type(backend);
+      LLVMValueRef hdr = llvm_build_alloca_at_entry(backend, hdr_ty, n->name);
+      LLVMBuildStore(backend->builder, LLVMConstNull(hdr_ty), hdr);
+      slots[*count].decl = n;
+      slots[*count].header = hdr;
+      slots[*count].kind = kind;
+      slots[*count].elem_struct = kind == TYPE_CUSTOM ? elem_st : nullptr;
+      (*count)++;
+    }
+  }
+  for_each_child(n, [&](ASTNode_C *k) {
+    collect_typed_array_decls(backend, func, k, slots, count, cap);
+    return true;
+  });
+}
 
-    // Fast path: both are known integers
-    if (L.type == INFERRED_INT && R.type == INFERRED_INT) {
-      switch (node->op) {
-      case TOKEN_PLUS:
-        result.value = LLVMBuildAdd(backend->builder, L.value, R.value, "add");
-        result.type = INFERRED_INT;
+static TypedArraySlot *typed_array_slot_for_decl(LLVMBackend *backend,
+                                                 ASTNode_C *decl) {
+  if (!backend->typed_array_fn ||
+      backend->current_function != backend->typed_array_fn)
+    return nullptr;
+  for (int i = 0; i < backend->typed_array_count; i++)
+    if (backend->typed_arrays[i].decl == decl) return &backend->typed_arrays[i];
+  return nullptr;
+}
+
+// The unboxed array local (scalar or struct) `name` resolves to, or null.
+static LocalVar *typed_array_header_local(LLVMBackend *backend,
+                                          const char *name) {
+  if (!name || !backend->typed_array_fn ||
+      backend->current_function != backend->typed_array_fn)
+    return nullptr;
+  LocalVar *v = get_local_var(backend, name);
+  if (!v || v->is_captured || v->typed_array == TYPE_UNKNOWN) return nullptr;
+  return v;
+}
+
+// arrayInt / arrayFloat / arrayBool local only.
+static LocalVar *typed_array_local(LLVMBackend *backend, const char *name) {
+  LocalVar *v = typed_array_header_local(backend, name);
+  return v && is_typed_array_kind(v->typed_array) ? v : nullptr;
+}
+
+// Element struct of a struct-array local (looked up by its header).
+static StructTypeEntry *typed_array_elem_struct(LLVMBackend *backend,
+                                                LocalVar *v) {
+  for (int i = 0; i < backend->typed_array_count; i++)
+    if (backend->typed_arrays[i].header == v->value)
+      return backend->typed_arrays[i].elem_struct;
+  return nullptr;
+}
+
+// Struct-array local only; its element struct goes to *st.
+static LocalVar *struct_array_local(LLVMBackend *backend, const char *name,
+                                    StructTypeEntry **st) {
+  LocalVar *v = typed_array_header_local(backend, name);
+  if (!v || v->typed_array != TYPE_CUSTOM) return nullptr;
+  *st = typed_array_elem_struct(backend, v);
+  return *st ? v : nullptr;
+}
+
+// LLVM element type of an unboxed array local.
+static LLVMTypeRef typed_array_local_elem_type(LLVMBackend *backend,
+                                               LocalVar *v) {
+  if (v->typed_array == TYPE_CUSTOM)
+    return typed_array_elem_struct(backend, v)->llvm_type;
+  return typed_array_elem_type(backend, v->typed_array);
+}
+
+static void add_local_typed_array(LLVMBackend *backend, const char *name,
+                                  LLVMValueRef header, DataType kind) {
+  if (!backend->current_scope) return;
+  Scope *s = backend->current_scope;
+  int si = scope_decl_slot(s, name);
+  if (si >= 0) {
+    s->vars[si].name = my_strdup(name);
+    s->vars[si].value = header;
+    s->vars[si].known_type = INFERRED_UNKNOWN;
+    s->vars[si].native_value = nullptr;
+    s->vars[si].struct_type_name = nullptr;
+    s->vars[si].typed_array = kind;
+    s->vars[si].is_captured = 0;
+    s->vars[si].slot_index = 0;
+    s->vars[si].env_ptr = nullptr;
+    s->vars[si].declaring_function = backend->current_function_node;
+  }
+}
+
+static LLVMValueRef typed_array_field(LLVMBackend *backend, LocalVar *v,
+                                      unsigned idx, const char *label) {
+  return LLVMBuildStructGEP2(backend->builder,
+                             typed_array_header_type(backend), v->value, idx,
+                             label);
+}
+
+// Convert any TypedValue to the element representation of `kind`
+// (i64 / double / i8), with the same int<->float rules as toInt / toFloat.
+static LLVMValueRef typed_array_coerce(LLVMBackend *backend, DataType kind,
+                                       TypedValue tv) {
+  LLVMBuilderRef b = backend->builder;
+  if (!tv.value && !tv.boxed) tv.value = LLVMConstInt(backend->int_type, 0, 0);
+  int native = tv.type == INFERRED_INT || tv.type == INFERRED_BOOL ||
+               tv.type == INFERRED_FLOAT;
+  LLVMValueRef boxed = native ? nullptr : (tv.boxed ? tv.boxed : tv.value);
+  LLVMValueRef is_float = nullptr, payload = nullptr;
+  if (boxed) {
+    is_float = LLVMBuildICmp(
+        b, LLVMIntEQ, llvm_vm_tag(backend, boxed, "ta.tag"),
+        LLVMConstInt(backend->int32_type, 1, 0), "ta.isfloat"); // VM_VAL_FLOAT
+    payload = llvm_vm_payload(backend, boxed, "ta.payload");
+  }
+
+  if (kind == TYPE_ARRAY_FLOAT) {
+    if (tv.type == INFERRED_FLOAT) return tv.value;
+    if (native) return LLVMBuildSIToFP(b, tv.value, backend->float_type, "ta.f");
+    return LLVMBuildSelect(
+        b, is_float, LLVMBuildBitCast(b, payload, backend->float_type, "ta.fb"),
+        LLVMBuildSIToFP(b, payload, backend->float_type, "ta.fi"), "ta.f");
+  }
+  if (kind == TYPE_ARRAY_BOOL) {
+    LLVMValueRef bit;
+    if (tv.type == INFERRED_FLOAT)
+      bit = LLVMBuildFCmp(b, LLVMRealONE, tv.value,
+                          LLVMConstReal(backend->float_type, 0.0), "ta.b");
+    else if (native)
+      bit = LLVMBuildICmp(b, LLVMIntNE, tv.value,
+                          LLVMConstInt(backend->int_type, 0, 0), "ta.b");
+    else
+      bit = llvm_build_is_truthy(backend, boxed);
+    return LLVMBuildZExt(b, bit, LLVMInt8TypeInContext(backend->context),
+                         "ta.b8");
+  }
+  if (tv.type == INFERRED_FLOAT)
+    return LLVMBuildFPToSI(b, tv.value, backend->int_type, "ta.i");
+  if (native) return tv.value;
+  return LLVMBuildSelect(
+      b, is_float,
+      LLVMBuildFPToSI(
+          b, LLVMBuildBitCast(b, payload, backend->float_type, "ta.fb"),
+          backend->int_type, "ta.fi"),
+      payload, "ta.i");
+}
+
+// Index expression as a native i64.
+static LLVMValueRef typed_array_index(LLVMBackend *backend, ASTNode_C *index) {
+  TypedValue iv = codegen_typed_expr(backend, index);
+  if (iv.type == INFERRED_INT || iv.type == INFERRED_BOOL) return iv.value;
+  if (iv.type == INFERRED_FLOAT)
+    return LLVMBuildFPToSI(backend->builder, iv.value, backend->int_type,
+                           "ta.idx");
+  LLVMValueRef boxed = iv.boxed ? iv.boxed : iv.value;
+  if (!boxed) return LLVMConstInt(backend->int_type, 0, 0);
+  return llvm_vm_int_payload(backend, boxed, "ta.idx");
+}
+
+// `idx <u count` — one compare covers both negative and too-large indices.
+static LLVMValueRef typed_array_in_bounds(LLVMBackend *backend, LocalVar *v,
+                                          LLVMValueRef idx) {
+  LLVMValueRef count = LLVMBuildLoad2(
+      backend->builder, backend->int32_type,
+      typed_array_field(backend, v, 1, "ta.count.ptr"), "ta.count");
+  return LLVMBuildICmp(
+      backend->builder, LLVMIntULT, idx,
+      LLVMBuildSExt(backend->builder, count, backend->int_type, "ta.count64"),
+      "ta.inbounds");
+}
+
+static LLVMValueRef typed_array_elem_ptr(LLVMBackend *backend, LocalVar *v,
+                                         LLVMValueRef idx) {
+  LLVMValueRef data = LLVMBuildLoad2(
+      backend->builder, backend->ptr_type,
+      typed_array_field(backend, v, 0, "ta.data.ptr"), "ta.data");
+  return LLVMBuildInBoundsGEP2(backend->builder,
+                               typed_array_local_elem_type(backend, v), data,
+                               &idx, 1, "ta.elem.ptr");
+}
+
+// `var`, `var + c`, `c + var` or `var - c` with c an int literal: the
+// offset c (RANGE-PROVED ARRAY ACCESSES keys its facts on this shape).
+static int range_index_offset(ASTNode_C *index, const char *var,
+                              long long *off) {
+  if (ast_is_identifier(index, var)) {
+    *off = 0;
+    return 1;
+  }
+  if (!index || index->type != AST_BINARY_OP) return 0;
+  ASTNode_C *l = index->left, *r = index->right;
+  long long c;
+  if (index->op == TOKEN_PLUS && ast_is_identifier(l, var) && r &&
+      r->type == AST_INT_LITERAL)
+    c = r->value.int_value;
+  else if (index->op == TOKEN_PLUS && ast_is_identifier(r, var) && l &&
+           l->type == AST_INT_LITERAL)
+    c = l->value.int_value;
+  else if (index->op == TOKEN_MINUS && ast_is_identifier(l, var) && r &&
+           r->type == AST_INT_LITERAL)
+    c = -r->value.int_value;
+  else
+    return 0;
+  // Small offsets only, so `bound + c` can never wrap in the loop guard.
+  if (c < -(1LL << 20) || c > (1LL << 20)) return 0;
+  *off = c;
+  return 1;
+}
+
+// 1 when `v[index]` needs no bounds check: inside `unchecked { }`, under
+// --checks=none, or proved by an enclosing loop's RangeFact.
+static int typed_array_check_elided(LLVMBackend *backend, LocalVar *v,
+                                    ASTNode_C *index) {
+  if (backend->checks_mode == CHECKS_NONE || backend->unchecked_depth > 0)
+    return 1;
+  RangeData *rd = static_cast<RangeData *>(backend->range_data);
+  long long off;
+  for (const RangeFact &f : rd->facts) {
+    if (f.header == v->value &&
+        range_index_offset(index, f.index.c_str(), &off) &&
+        off >= f.min_off && off <= f.max_off) {
+      rd->elided++;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// Branch on `idx <u count`: the out-of-bounds arm prints the runtime error
+// and falls through to the returned join block; the builder is left in the
+// in-bounds arm, which the caller must close with a br to the join block.
+// An elided check keeps that shape behind a constant `br true` (the callers
+// join on the OOB arm), which the first SimplifyCFG folds away.
+static LLVMBasicBlockRef typed_array_bounds_check(LLVMBackend *backend,
+                                                  LocalVar *v, ASTNode_C *index,
+                                                  LLVMValueRef idx,
+                                                  LLVMBasicBlockRef *oob_out) {
+  LLVMBuilderRef b = backend->builder;
+  LLVMValueRef ok = typed_array_check_elided(backend, v, index)
+                        ? LLVMConstInt(backend->bool_type, 1, 0)
+                        : typed_array_in_bounds(backend, v, idx);
+  LLVMValueRef fn = backend->current_function;
+  LLVMBasicBlockRef in_bb = LLVMAppendBasicBlock(fn, "ta.in");
+  LLVMBasicBlockRef oob_bb = LLVMAppendBasicBlock(fn, "ta.oob");
+  LLVMBasicBlockRef done_bb = LLVMAppendBasicBlock(fn, "ta.done");
+  LLVMBuildCondBr(b, ok, in_bb, oob_bb);
+
+  LLVMPositionBuilderAtEnd(b, oob_bb);
+  LLVMBuildCall2(b, LLVMGlobalGetValueType(backend->func_aot_typed_array_oob),
+                 backend->func_aot_typed_array_oob, nullptr, 0, "");
+  LLVMBuildBr(b, done_bb);
+
+  LLVMPositionBuilderAtEnd(b, in_bb);
+  if (oob_out) *oob_out = oob_bb;
+  return done_bb;
+}
+
+// Close the in-bounds arm of typed_array_bounds_check and merge `val` with
+// a zero from the OOB arm.
+static LLVMValueRef typed_array_join(LLVMBackend *backend,
+                                     LLVMBasicBlockRef done_bb,
+                                     LLVMBasicBlockRef oob_bb,
+                                     LLVMValueRef val, const char *label) {
+  LLVMBuilderRef b = backend->builder;
+  LLVMBasicBlockRef in_end = LLVMGetInsertBlock(b);
+  LLVMBuildBr(b, done_bb);
+  LLVMPositionBuilderAtEnd(b, done_bb);
+  LLVMValueRef phi = LLVMBuildPhi(b, LLVMTypeOf(val), label);
+  LLVMValueRef vals[] = {val, LLVMConstNull(LLVMTypeOf(val))};
+  LLVMBasicBlockRef bbs[] = {in_end, oob_bb};
+  LLVMAddIncoming(phi, vals, bbs, 2);
+  return phi;
+}
+
+// `a[i]` → native INT / FLOAT / BOOL TypedValue (bool as i64 0/1).
+static TypedValue typed_array_load(LLVMBackend *backend, LocalVar *v,
+                                   ASTNode_C *index) {
+  TypedValue result = {nullptr, INFERRED_UNKNOWN, nullptr};
+  LLVMBuilderRef b = backend->builder;
+  LLVMValueRef idx = typed_array_index(backend, index);
+  LLVMBasicBlockRef oob_bb;
+  LLVMBasicBlockRef done_bb =
+      typed_array_bounds_check(backend, v, index, idx, &oob_bb);
+  LLVMValueRef loaded = LLVMBuildLoad2(
+      b, typed_array_elem_type(backend, v->typed_array),
+      typed_array_elem_ptr(backend, v, idx), "ta.elem");
+  LLVMValueRef phi = typed_array_join(backend, done_bb, oob_bb, loaded,
+                                      "ta.val");
+
+  switch (v->typed_array) {
+  case TYPE_ARRAY_FLOAT:
+    result.value = phi;
+    result.type = INFERRED_FLOAT;
+    break;
+  case TYPE_ARRAY_BOOL:
+    result.value = LLVMBuildZExt(b, phi, backend->int_type, "ta.bool");
+    result.type = INFERRED_BOOL;
+    break;
+  default:
+    result.value = phi;
+    result.type = INFERRED_INT;
+    break;
+  }
+  return result;
+}
+
+// `a[i] = rhs`. The rhs is evaluated before the index, matching the boxed
+// assignment path. Returns the boxed rhs (statement value).
+static LLVMValueRef typed_array_store(LLVMBackend *backend, LocalVar *v,
+                                      ASTNode_C *index, ASTNode_C *rhs) {
+  LLVMBuilderRef b = backend->builder;
+  TypedValue tv = codegen_typed_expr(backend, rhs);
+  LLVMValueRef elem = typed_array_coerce(backend, v->typed_array, tv);
+  LLVMValueRef idx = typed_array_index(backend, index);
+  LLVMBasicBlockRef done_bb =
+      typed_array_bounds_check(backend, v, index, idx, nullptr);
+  LLVMBuildStore(b, elem, typed_array_elem_ptr(backend, v, idx));
+  LLVMBuildBr(b, done_bb);
+  LLVMPositionBuilderAtEnd(b, done_bb);
+  return box_typed_value(backend, tv);
+}
+
+// First half of a push: grow (x2, min 8) only when full, and return the
+// address of element `count` (old count in *count_out). The caller writes
+// the element, then typed_array_commit bumps the count.
+static LLVMValueRef typed_array_reserve(LLVMBackend *backend, LocalVar *v,
+                                        LLVMValueRef *count_out) {
+  LLVMBuilderRef b = backend->builder;
+  LLVMValueRef count_ptr = typed_array_field(backend, v, 1, "ta.count.ptr");
+  LLVMValueRef cap_ptr = typed_array_field(backend, v, 2, "ta.cap.ptr");
+  LLVMValueRef count = LLVMBuildLoad2(b, backend->int32_type, count_ptr,
+                                      "ta.count");
+  LLVMValueRef cap = LLVMBuildLoad2(b, backend->int32_type, cap_ptr, "ta.cap");
+  LLVMValueRef full = LLVMBuildICmp(b, LLVMIntSGE, count, cap, "ta.full");
+
+  LLVMValueRef fn = backend->current_function;
+  LLVMBasicBlockRef grow_bb = LLVMAppendBasicBlock(fn, "ta.grow");
+  LLVMBasicBlockRef put_bb = LLVMAppendBasicBlock(fn, "ta.put");
+  LLVMBuildCondBr(b, full, grow_bb, put_bb);
+
+  LLVMPositionBuilderAtEnd(b, grow_bb);
+  LLVMValueRef eight = LLVMConstInt(backend->int32_type, 8, 0);
+  LLVMValueRef new_cap = LLVMBuildSelect(
+      b, LLVMBuildICmp(b, LLVMIntSLT, cap, eight, "ta.small"), eight,
+      LLVMBuildMul(b, cap, LLVMConstInt(backend->int32_type, 2, 0), "ta.dbl"),
+      "ta.newcap");
+  LLVMValueRef data_ptr = typed_array_field(backend, v, 0, "ta.data.ptr");
+  LLVMValueRef grow_args[] = {
+      LLVMBuildLoad2(b, backend->ptr_type, data_ptr, "ta.data"),
+      LLVMBuildSExt(b, new_cap, backend->int_type, "ta.newcap64"),
+      LLVMSizeOf(typed_array_local_elem_type(backend, v))};
+  LLVMValueRef grown = LLVMBuildCall2(
+      b, LLVMGlobalGetValueType(backend->func_tulpar_array_grow),
+      backend->func_tulpar_array_grow, grow_args, 3, "ta.grown");
+  LLVMBuildStore(b, grown, data_ptr);
+  LLVMBuildStore(b, new_cap, cap_ptr);
+  LLVMBuildBr(b, put_bb);
+
+  LLVMPositionBuilderAtEnd(b, put_bb);
+  *count_out = count;
+  return typed_array_elem_ptr(
+      backend, v, LLVMBuildSExt(b, count, backend->int_type, "ta.at"));
+}
+
+static void typed_array_commit(LLVMBackend *backend, LocalVar *v,
+                               LLVMValueRef count) {
+  LLVMBuildStore(
+      backend->builder,
+      LLVMBuildAdd(backend->builder, count,
+                   LLVMConstInt(backend->int32_type, 1, 0), "ta.count.next"),
+      typed_array_field(backend, v, 1, "ta.count.ptr"));
+}
+
+// push(a, elem) with an already-coerced scalar element.
+static void typed_array_push_elem(LLVMBackend *backend, LocalVar *v,
+                                  LLVMValueRef elem) {
+  LLVMValueRef count;
+  LLVMValueRef slot = typed_array_reserve(backend, v, &count);
+  LLVMBuildStore(backend->builder, elem, slot);
+  typed_array_commit(backend, v, count);
+}
+
+// Write the struct value of `e` into `dst` (an element slot of a struct
+// array): typed-struct local → one struct copy; struct-returning call →
+// the call writes through `dst` (pending_struct_result_ptr, as in
+// VAR_DECL); anything else → unpack the boxed value field by field.
+static void store_struct_expr_into(LLVMBackend *backend, StructTypeEntry *st,
+                                   ASTNode_C *e, LLVMValueRef dst) {
+  if (e->type == AST_IDENTIFIER && e->name) {
+    const char *sn = get_local_struct_type(backend, e->name);
+    LLVMValueRef src = sn ? get_local(backend, e->name) : nullptr;
+    if (src && strcmp(sn, st->name) == 0) {
+      LLVMBuildStore(backend->builder,
+                     LLVMBuildLoad2(backend->builder, st->llvm_type, src,
+                                    "sa.copy"),
+                     dst);
+      return;
+    }
+  }
+  LLVMBuildStore(backend->builder, LLVMConstNull(st->llvm_type), dst);
+  const char *call_st =
+      e->type == AST_FUNCTION_CALL
+          ? ast_static_struct_name(backend, backend->current_function_node, e)
+          : nullptr;
+  if (call_st && strcmp(call_st, st->name) == 0) {
+    backend->pending_struct_result_ptr = dst;
+    backend->pending_struct_result_name = st->name;
+    (void)codegen_expression(backend, e);
+    backend->pending_struct_result_ptr = nullptr;
+    backend->pending_struct_result_name = nullptr;
+    return;
+  }
+  LLVMValueRef boxed = codegen_expression(backend, e);
+  if (boxed) emit_unpack_boxed_struct_into(backend, boxed, st, dst);
+}
+
+// push(a, <St expr>) on a struct array: the value is built in place.
+static void struct_array_push(LLVMBackend *backend, LocalVar *v,
+                              StructTypeEntry *st, ASTNode_C *e) {
+  LLVMValueRef count;
+  LLVMValueRef slot = typed_array_reserve(backend, v, &count);
+  store_struct_expr_into(backend, st, e, slot);
+  typed_array_commit(backend, v, count);
+}
+
+// Append the compile-time constant `s` to the toJson writer `buf`.
+static void json_buf_raw(LLVMBackend *backend, LLVMValueRef buf,
+                         const std::string &s) {
+  LLVMValueRef args[] = {
+      buf, LLVMBuildGlobalStringPtr(backend->builder, s.c_str(), "json.frag"),
+      LLVMConstInt(backend->int_type, s.size(), 0)};
+  LLVMBuildCall2(backend->builder,
+                 LLVMGlobalGetValueType(backend->func_aot_json_buf_raw),
+                 backend->func_aot_json_buf_raw, args, 3, "");
+}
+
+// `"name"` with JSON escaping, done here so the emitted code only memcpys.
+static std::string json_quote(const char *s) {
+  std::string out = "\"";
+  for (const unsigned char *p = (const unsigned char *)s; *p; p++) {
+    if (*p == '"' || *p == '\\') {
+      out += '\\';
+      out += (char)*p;
+    } else if (*p < 0x20) {
+      char tmp[8];
+      snprintf(tmp, sizeof(tmp), "\\u%04x", *p);
+      out += tmp;
+    } else {
+      out += (char)*p;
+    }
+  }
+  return out + "\"";
+}
+
+// `void tulpar.tojson.<St>(ptr s, ptr buf)` — the struct's serialiser,
+// emitted on first use. Fields are written in declaration order, the same
+// order box_native_struct_as_object inserts them, so the bytes match the
+// generic toJson of the boxed value.
+static LLVMValueRef struct_json_fn(LLVMBackend *backend, StructTypeEntry *st) {
+  if (st->json_fn) return st->json_fn;
+  LLVMTypeRef params[] = {backend->ptr_type, backend->ptr_type};
+  LLVMTypeRef fty = LLVMFunctionType(backend->void_type, params, 2, 0);
+  std::string fname = std::string("tulpar.tojson.") + st->name;
+  LLVMValueRef fn = LLVMAddFunction(backend->module, fname.c_str(), fty);
+  LLVMSetLinkage(fn, LLVMInternalLinkage);
+  st->json_fn = fn;
+
+  // The caller's --debug location is scoped to the caller's subprogram;
+  // the verifier rejects it on instructions in this function.
+  LLVMBasicBlockRef saved_bb = LLVMGetInsertBlock(backend->builder);
+  LLVMMetadataRef saved_loc = LLVMGetCurrentDebugLocation2(backend->builder);
+  LLVMValueRef saved_fn = backend->current_function;
+  LLVMSetCurrentDebugLocation2(backend->builder, nullptr);
+  backend->current_function = fn;
+  LLVMPositionBuilderAtEnd(backend->builder,
+                           LLVMAppendBasicBlock(fn, "entry"));
+  LLVMValueRef sp = LLVMGetParam(fn, 0);
+  LLVMValueRef buf = LLVMGetParam(fn, 1);
+  std::string frag = "{";
+  for (int i = 0; i < st->field_count; i++) {
+    if (i > 0) frag += ",";
+    frag += json_quote(st->field_names[i]) + ":";
+    json_buf_raw(backend, buf, frag);
+    frag.clear();
+    LLVMValueRef fv = LLVMBuildLoad2(
+        backend->builder, backend->int_type,
+        LLVMBuildStructGEP2(backend->builder, st->llvm_type, sp, (unsigned)i,
+                            "json.fp"),
+        "json.fv");
+    LLVMValueRef fn_put = st->field_types[i] == TYPE_BOOL
+                              ? backend->func_aot_json_buf_bool
+                              : backend->func_aot_json_buf_int;
+    LLVMValueRef args[] = {buf, fv};
+    LLVMBuildCall2(backend->builder, LLVMGlobalGetValueType(fn_put), fn_put,
+                   args, 2, "");
+  }
+  json_buf_raw(backend, buf, st->field_count ? "}" : "{}");
+  LLVMBuildRetVoid(backend->builder);
+
+  backend->current_function = saved_fn;
+  if (saved_bb) LLVMPositionBuilderAtEnd(backend->builder, saved_bb);
+  LLVMSetCurrentDebugLocation2(backend->builder, saved_loc);
+  return fn;
+}
+
+// toJson(<native struct>) / toJson(<struct array>) without boxing: a
+// struct local, a struct-returning call, or an inline struct-array local
+// is written straight through its tulpar.tojson.<St> serialiser. Returns
+// nullptr for anything else (the caller takes the generic aot_to_json path).
+static LLVMValueRef codegen_struct_to_json(LLVMBackend *backend,
+                                           ASTNode_C *arg) {
+  if (!arg || !arg->name) return nullptr;
+  StructTypeEntry *st = nullptr;
+  LLVMValueRef sp = nullptr;
+  LocalVar *arr = nullptr;
+  if (arg->type == AST_IDENTIFIER) {
+    arr = struct_array_local(backend, arg->name, &st);
+    if (!arr) {
+      const char *sn = get_local_struct_type(backend, arg->name);
+      sp = sn ? get_local(backend, arg->name) : nullptr;
+      st = sp ? find_struct_type(backend, sn) : nullptr;
+    }
+  } else if (arg->type == AST_FUNCTION_CALL && !arg->receiver &&
+             !arg->callee) {
+    for (int j = 0; j < backend->function_count; j++) {
+      if (backend->functions[j].name &&
+          strcmp(backend->functions[j].name, arg->name) == 0) {
+        const char *rn = backend->functions[j].return_struct_name;
+        st = rn ? find_struct_type(backend, rn) : nullptr;
+        break;
+      }
+    }
+    if (st && struct_is_trivially_unboxable(st)) {
+      sp = llvm_build_alloca_at_entry(backend, st->llvm_type,
+                                      "json.struct.tmp");
+      LLVMBuildStore(backend->builder, LLVMConstNull(st->llvm_type), sp);
+      backend->pending_struct_result_ptr = sp;
+      backend->pending_struct_result_name = st->name;
+      (void)codegen_expression(backend, arg);
+      backend->pending_struct_result_ptr = nullptr;
+      backend->pending_struct_result_name = nullptr;
+    }
+  }
+  if (!st || !struct_is_trivially_unboxable(st) || (!sp && !arr))
+    return nullptr;
+
+  LLVMBuilderRef b = backend->builder;
+  LLVMValueRef ser = struct_json_fn(backend, st);
+  LLVMValueRef buf = LLVMBuildCall2(
+      b, LLVMGlobalGetValueType(backend->func_aot_json_buf_begin),
+      backend->func_aot_json_buf_begin, nullptr, 0, "json.buf");
+  if (sp) {
+    LLVMValueRef args[] = {sp, buf};
+    LLVMBuildCall2(b, LLVMGlobalGetValueType(ser), ser, args, 2, "");
+  } else {
+    // "[" s0 ("," si)* "]" — the loop reads the count once; nothing in the
+    // body can push to the array.
+    LLVMValueRef count = LLVMBuildSExt(
+        b,
+        LLVMBuildLoad2(b, backend->int32_type,
+                       typed_array_field(backend, arr, 1, "json.count.ptr"),
+                       "json.count"),
+        backend->int_type, "json.count64");
+    json_buf_raw(backend, buf, "[");
+    LLVMValueRef fn = backend->current_function;
+    LLVMBasicBlockRef pre_bb = LLVMGetInsertBlock(b);
+    LLVMBasicBlockRef cond_bb = LLVMAppendBasicBlock(fn, "json.arr.cond");
+    LLVMBasicBlockRef body_bb = LLVMAppendBasicBlock(fn, "json.arr.body");
+    LLVMBasicBlockRef sep_bb = LLVMAppendBasicBlock(fn, "json.arr.sep");
+    LLVMBasicBlockRef elem_bb = LLVMAppendBasicBlock(fn, "json.arr.elem");
+    LLVMBasicBlockRef end_bb = LLVMAppendBasicBlock(fn, "json.arr.end");
+    LLVMBuildBr(b, cond_bb);
+
+    LLVMPositionBuilderAtEnd(b, cond_bb);
+    LLVMValueRef i = LLVMBuildPhi(b, backend->int_type, "json.i");
+    LLVMBuildCondBr(b, LLVMBuildICmp(b, LLVMIntSLT, i, count, "json.more"),
+                    body_bb, end_bb);
+
+    LLVMPositionBuilderAtEnd(b, body_bb);
+    LLVMBuildCondBr(b,
+                    LLVMBuildICmp(b, LLVMIntNE, i,
+                                  LLVMConstInt(backend->int_type, 0, 0),
+                                  "json.notfirst"),
+                    sep_bb, elem_bb);
+    LLVMPositionBuilderAtEnd(b, sep_bb);
+    json_buf_raw(backend, buf, ",");
+    LLVMBuildBr(b, elem_bb);
+
+    LLVMPositionBuilderAtEnd(b, elem_bb);
+    LLVMValueRef args[] = {typed_array_elem_ptr(backend, arr, i), buf};
+    LLVMBuildCall2(b, LLVMGlobalGetValueType(ser), ser, args, 2, "");
+    LLVMValueRef next = LLVMBuildAdd(
+        b, i, LLVMConstInt(backend->int_type, 1, 0), "json.next");
+    LLVMBuildBr(b, cond_bb);
+
+    LLVMValueRef vals[] = {LLVMConstInt(backend->int_type, 0, 0), next};
+    LLVMBasicBlockRef bbs[] = {pre_bb, elem_bb};
+    LLVMAddIncoming(i, vals, bbs, 2);
+
+    LLVMPositionBuilderAtEnd(b, end_bb);
+    json_buf_raw(backend, buf, "]");
+  }
+  LLVMValueRef end_args[] = {buf};
+  return llvm_call_vmvalue_func(backend, backend->func_aot_json_buf_end,
+                                end_args, 1, "to_json");
+}
+
+// `a[i].field` on a struct array → native INT / BOOL TypedValue.
+static TypedValue struct_array_field_load(LLVMBackend *backend, LocalVar *v,
+                                          StructTypeEntry *st,
+                                          ASTNode_C *index, int field) {
+  TypedValue result = {nullptr, INFERRED_UNKNOWN, nullptr};
+  LLVMBuilderRef b = backend->builder;
+  LLVMValueRef idx = typed_array_index(backend, index);
+  LLVMBasicBlockRef oob_bb;
+  LLVMBasicBlockRef done_bb =
+      typed_array_bounds_check(backend, v, index, idx, &oob_bb);
+  LLVMValueRef fptr = LLVMBuildStructGEP2(
+      b, st->llvm_type, typed_array_elem_ptr(backend, v, idx),
+      (unsigned)field, "sa.field.ptr");
+  LLVMValueRef loaded = LLVMBuildLoad2(b, backend->int_type, fptr, "sa.field");
+  result.value = typed_array_join(backend, done_bb, oob_bb, loaded, "sa.val");
+  result.type =
+      st->field_types[field] == TYPE_BOOL ? INFERRED_BOOL : INFERRED_INT;
+  return result;
+}
+
+// `a[i].field = rhs` on a struct array. Same evaluation order as
+// typed_array_store; returns the boxed rhs.
+static LLVMValueRef struct_array_field_store(LLVMBackend *backend,
+                                             LocalVar *v, StructTypeEntry *st,
+                                             ASTNode_C *index, int field,
+                                             ASTNode_C *rhs) {
+  LLVMBuilderRef b = backend->builder;
+  TypedValue tv = codegen_typed_expr(backend, rhs);
+  LLVMValueRef val = typed_array_coerce(backend, TYPE_ARRAY_INT, tv);
+  LLVMValueRef idx = typed_array_index(backend, index);
+  LLVMBasicBlockRef done_bb =
+      typed_array_bounds_check(backend, v, index, idx, nullptr);
+  LLVMBuildStore(b, val,
+                 LLVMBuildStructGEP2(b, st->llvm_type,
+                                     typed_array_elem_ptr(backend, v, idx),
+                                     (unsigned)field, "sa.field.ptr"));
+  LLVMBuildBr(b, done_bb);
+  LLVMPositionBuilderAtEnd(b, done_bb);
+  return box_typed_value(backend, tv);
+}
+
+// Struct array + field index behind `a[i].field`, or null.
+static LocalVar *struct_array_field_access(LLVMBackend *backend,
+                                           ASTNode_C *access,
+                                           StructTypeEntry **st, int *field) {
+  if (!access || access->type != AST_ARRAY_ACCESS || !access->index ||
+      access->index->type != AST_STRING_LITERAL ||
+      !access->index->value.string_value)
+    return nullptr;
+  LocalVar *v =
+      struct_array_local(backend, array_access_receiver(access->left), st);
+  if (!v) return nullptr;
+  *field = struct_type_field_index(*st, access->index->value.string_value);
+  return *field >= 0 ? v : nullptr;
+}
+
+// `St p = a[i];` — copy element i of a struct array into `dst` (already
+// zeroed, so an out-of-range index leaves the fields 0). Returns 0 when
+// `rhs` isn't an element of a struct array of type `st`.
+static int struct_array_copy_out(LLVMBackend *backend, ASTNode_C *rhs,
+                                 StructTypeEntry *st, LLVMValueRef dst) {
+  StructTypeEntry *elem_st = nullptr;
+  LocalVar *v =
+      struct_array_local(backend, array_access_receiver(rhs), &elem_st);
+  if (!v || elem_st != st) return 0;
+  LLVMBuilderRef b = backend->builder;
+  LLVMValueRef idx = typed_array_index(backend, rhs->index);
+  LLVMBasicBlockRef done_bb =
+      typed_array_bounds_check(backend, v, rhs->index, idx, nullptr);
+  LLVMBuildStore(b,
+                 LLVMBuildLoad2(b, st->llvm_type,
+                                typed_array_elem_ptr(backend, v, idx),
+                                "sa.elem"),
+                 dst);
+  LLVMBuildBr(b, done_bb);
+  LLVMPositionBuilderAtEnd(b, done_bb);
+  return 1;
+}
+
+// Bare `a` at a dynamic boundary: a fresh boxed ObjArray snapshot.
+static LLVMValueRef typed_array_box(LLVMBackend *backend, LocalVar *v) {
+  LLVMBuilderRef b = backend->builder;
+  LLVMValueRef data = LLVMBuildLoad2(
+      b, backend->ptr_type, typed_array_field(backend, v, 0, "ta.data.ptr"),
+      "ta.data");
+  LLVMValueRef count = LLVMBuildLoad2(
+      b, backend->int32_type, typed_array_field(backend, v, 1, "ta.count.ptr"),
+      "ta.count");
+  LLVMValueRef args[] = {
+      data, LLVMBuildSExt(b, count, backend->int_type, "ta.count64"),
+      LLVMConstInt(backend->int_type,
+                   (unsigned long long)typed_array_box_kind(v->typed_array),
+                   0)};
+  return llvm_call_vmvalue_func(backend, backend->func_aot_typed_array_box,
+                                args, 3, "ta.boxed");
+}
+
+// `arrayInt a = [...]` (or a struct array's `[]`) for a slot picked by
+// collect_typed_array_decls. The header alloca is reused when the decl runs
+// again (loop body), so the previous buffer is released first.
+static LLVMValueRef codegen_typed_array_decl(LLVMBackend *backend,
+                                             ASTNode_C *node,
+                                             TypedArraySlot *slot) {
+  LLVMBuilderRef b = backend->builder;
+  LLVMTypeRef hdr_ty = typed_array_header_type(backend);
+  LLVMValueRef old = LLVMBuildLoad2(
+      b, backend->ptr_type,
+      LLVMBuildStructGEP2(b, hdr_ty, slot->header, 0, "ta.data.ptr"),
+      "ta.old");
+  LLVMValueRef rel_args[] = {old};
+  LLVMBuildCall2(b, LLVMGlobalGetValueType(backend->func_tulpar_array_release),
+                 backend->func_tulpar_array_release, rel_args, 1, "");
+  LLVMBuildStore(b, LLVMConstNull(hdr_ty), slot->header);
+
+  // Elements are evaluated before the name is bound, like the boxed path.
+  int n = node->right ? node->right->element_count : 0;
+  LLVMValueRef *elems =
+      n > 0 ? static_cast<LLVMValueRef *>(malloc(sizeof(LLVMValueRef) * n))
+            : nullptr;
+  for (int i = 0; i < n; i++)
+    elems[i] = typed_array_coerce(
+        backend, slot->kind,
+        codegen_typed_expr(backend, node->right->elements[i]));
+
+  add_local_typed_array(backend, node->name, slot->header, slot->kind);
+  LocalVar *v = get_local_var(backend, node->name);
+  for (int i = 0; v && i < n; i++)
+    typed_array_push_elem(backend, v, elems[i]);
+  if (elems) free(elems);
+  return slot->header;
+}
+
+// Free every unboxed buffer of the current function. Emitted right before
+// each `ret` of a function that has typed-array slots (headers are zeroed
+// at entry, so a release on a path that never ran the decl frees NULL).
+static void emit_typed_array_releases(LLVMBackend *backend) {
+  if (!backend->typed_array_fn ||
+      backend->current_function != backend->typed_array_fn)
+    return;
+  LLVMTypeRef hdr_ty = typed_array_header_type(backend);
+  for (int i = 0; i < backend->typed_array_count; i++) {
+    LLVMValueRef data = LLVMBuildLoad2(
+        backend->builder, backend->ptr_type,
+        LLVMBuildStructGEP2(backend->builder, hdr_ty,
+                            backend->typed_arrays[i].header, 0, "ta.data.ptr"),
+        "ta.data");
+    LLVMValueRef args[] = {data};
+    LLVMBuildCall2(backend->builder,
+                   LLVMGlobalGetValueType(backend->func_tulpar_array_release),
+                   backend->func_tulpar_array_release, args, 1, "");
+  }
+}
+
+// ============================================================
+// RANGE-PROVED ARRAY ACCESSES (`for` loops over typed arrays)
+// ============================================================
+//
+// A counted loop
+//
+//   for (int i = LO; i < B; i = i + S) { ... a[i + c] ... }
+//
+// (also `<=`, `i++`, `i += S`) keeps i in [LO, last], last = B - 1 (B for
+// `<=`), as long as the body never writes i, B or S, S >= 1 and all three
+// hold ints. With no `push(a, ..)` in the body the length of a typed-array
+// local is fixed as well: nothing else can resize it, since it never
+// escapes its function (UNBOXED TYPED ARRAYS). `a[i + c]` (c a literal) is
+// then in bounds whenever LO + c >= 0 and last + c < length(a).
+//
+//  - At compile time: B is `length(a)` / `len(a)` (plus or minus a literal)
+//    and LO, S are literals that make both sides hold for any length. The loop is emitted once and
+//    those accesses skip their check (typed_array_check_elided).
+//  - Behind a loop guard: otherwise, for an innermost loop with a plain
+//    body, the same conditions are evaluated once after the init. The loop
+//    is emitted twice — the guarded copy without checks, the other exactly
+//    as before — so a loop that does run out of bounds still reports every
+//    bad access.
+//
+// Boxed arrays keep the runtime's checked vm_array_get / vm_array_set.
+// `--checks=full` skips the proofs, `--checks=none` and `unchecked { }` drop
+// every typed-array check (ChecksMode).
+
+enum { RANGE_NONE, RANGE_STATIC, RANGE_GUARDED };
+
+struct RangeLoop {
+  const char *var;       // induction variable
+  ASTNode_C *lo;         // init value (only read for the compile-time case)
+  ASTNode_C *bound;      // B
+  int inclusive;         // `i <= B`
+  ASTNode_C *step;       // S when it is a variable, else null
+  long long step_lit;    // S when it is a literal (`i++`: 1), else 0
+  LLVMValueRef len_of;   // header of `a` when B is `length(a) + len_off`
+  long long len_off;
+  std::vector<RangeFact> facts;
+};
+
+// A plain local the loop may rely on: not backed by a global (a call in the
+// body could write it), not captured by a closure, not an unboxed array.
+static int range_local_ok(LLVMBackend *backend, const char *name) {
+  LocalVar *v = get_local_var(backend, name);
+  return v && !v->is_captured && v->typed_array == TYPE_UNKNOWN &&
+         !v->struct_type_name &&
+         !(v->value && LLVMIsAGlobalVariable(v->value)) &&
+         !(v->native_value && LLVMIsAGlobalVariable(v->native_value));
+}
+
+// Does anything under `n` write (or redeclare) `name`?
+static int range_writes(ASTNode_C *n, const char *name) {
+  if (!n) return 0;
+  switch (n->type) {
+  case AST_LAMBDA:
+  case AST_FUNCTION_DECL:
+    return ast_mentions_name(n, name);
+  case AST_VARIABLE_DECL:
+  case AST_ASSIGNMENT:
+  case AST_COMPOUND_ASSIGN:
+  case AST_INCREMENT:
+  case AST_DECREMENT:
+  case AST_FOR_IN:
+    if (n->name && strcmp(n->name, name) == 0) return 1;
+    break;
+  case AST_TRY_CATCH:
+    if (n->catch_var && strcmp(n->catch_var, name) == 0) return 1;
+    break;
+  case AST_FUNCTION_CALL:
+    // push is the only call that resizes a typed-array local.
+    if (!n->receiver && !n->callee && n->name &&
+        strcmp(n->name, "push") == 0 && n->argument_count > 0 &&
+        ast_is_identifier(n->arguments[0], name))
+      return 1;
+    break;
+  default:
+    break;
+  }
+  return !for_each_child(n, [&](ASTNode_C *k) {
+    return !range_writes(k, name);
+  });
+}
+
+// Header of the typed array `x` when `e` is `length(x)` / `len(x)`.
+static LLVMValueRef range_length_of(LLVMBackend *backend, ASTNode_C *e) {
+  if (!e || e->type != AST_FUNCTION_CALL || e->receiver || e->callee ||
+      !e->name || e->argument_count != 1 ||
+      (strcmp(e->name, "length") != 0 && strcmp(e->name, "len") != 0) ||
+      !e->arguments[0] || e->arguments[0]->type != AST_IDENTIFIER)
+    return nullptr;
+  LocalVar *v = typed_array_header_local(backend, e->arguments[0]->name);
+  return v ? v->value : nullptr;
+}
+
+// Every `a[var + c]` under `n` on a typed-array local: widen a's offset
+// span. Lambdas / nested functions never see the array (escape scan).
+static void range_collect(LLVMBackend *backend, ASTNode_C *n, const char *var,
+                          std::vector<RangeFact> &facts) {
+  if (!n || n->type == AST_LAMBDA || n->type == AST_FUNCTION_DECL) return;
+  long long off;
+  const char *recv = array_access_receiver(n);
+  LocalVar *v = recv ? typed_array_header_local(backend, recv) : nullptr;
+  if (v && range_index_offset(n->index, var, &off)) {
+    RangeFact *f = nullptr;
+    for (RangeFact &g : facts)
+      if (g.header == v->value) f = &g;
+    if (!f) {
+      facts.push_back({var, v->value, off, off});
+    } else {
+      if (off < f->min_off) f->min_off = off;
+      if (off > f->max_off) f->max_off = off;
+    }
+  }
+  for_each_child(n, [&](ASTNode_C *k) {
+    range_collect(backend, k, var, facts);
+    return true;
+  });
+}
+
+// A body that is safe to emit twice: no nested loop (only innermost loops
+// are duplicated), closure, declaration with per-decl codegen state, or
+// control flow that registers handlers.
+static int range_body_plain(LLVMBackend *backend, ASTNode_C *n) {
+  if (!n) return 1;
+  switch (n->type) {
+  case AST_FOR:
+  case AST_FOR_IN:
+  case AST_WHILE:
+  case AST_LAMBDA:
+  case AST_FUNCTION_DECL:
+  case AST_TRY_CATCH:
+  case AST_MATCH:
+  case AST_IMPORT:
+  case AST_TYPE_DECL:
+    return 0;
+  case AST_VARIABLE_DECL:
+    if (typed_array_slot_for_decl(backend, n)) return 0;
+    break;
+  default:
+    break;
+  }
+  return for_each_child(n, [&](ASTNode_C *k) {
+    return range_body_plain(backend, k);
+  });
+}
+
+// Match `node` (a for loop whose init has just been emitted) against the
+// counted-loop shape above. Returns RANGE_STATIC / RANGE_GUARDED with the
+// facts the body may use, or RANGE_NONE.
+static int range_plan_for(LLVMBackend *backend, ASTNode_C *node,
+                          RangeLoop *rl) {
+  if (backend->checks_mode != CHECKS_RELEASE || backend->unchecked_depth > 0 ||
+      !backend->typed_array_count)
+    return RANGE_NONE;
+  ASTNode_C *init = node->init, *cond = node->condition;
+  ASTNode_C *incr = node->increment, *body = node->body;
+  if (!init || init->type != AST_VARIABLE_DECL || !init->name ||
+      !init->right ||
+      (init->data_type != TYPE_INT && init->data_type != TYPE_UNKNOWN))
+    return RANGE_NONE;
+  const char *var = init->name;
+  if (!range_local_ok(backend, var) || range_writes(body, var))
+    return RANGE_NONE;
+  if (!cond || cond->type != AST_BINARY_OP ||
+      (cond->op != TOKEN_LESS && cond->op != TOKEN_LESS_EQUAL) ||
+      !ast_is_identifier(cond->left, var) || !cond->right)
+    return RANGE_NONE;
+
+  rl->var = var;
+  rl->lo = init->right;
+  rl->bound = cond->right;
+  rl->inclusive = cond->op == TOKEN_LESS_EQUAL;
+  rl->step = nullptr;
+  rl->step_lit = 0;
+  rl->len_of = nullptr;
+  rl->len_off = 0;
+
+  ASTNode_C *b = rl->bound;
+  if (b->type == AST_IDENTIFIER) {
+    if (strcmp(b->name, var) == 0 || !range_local_ok(backend, b->name) ||
+        range_writes(body, b->name))
+      return RANGE_NONE;
+  } else if (b->type != AST_INT_LITERAL) {
+    // length(a), length(a) + c, length(a) - c
+    ASTNode_C *call = b;
+    if (b->type == AST_BINARY_OP && b->right &&
+        b->right->type == AST_INT_LITERAL &&
+        (b->op == TOKEN_PLUS || b->op == TOKEN_MINUS) &&
+        b->right->value.int_value >= -(1LL << 20) &&
+        b->right->value.int_value <= (1LL << 20)) {
+      call = b->left;
+      rl->len_off = b->op == TOKEN_PLUS ? b->right->value.int_value
+                                        : -b->right->value.int_value;
+    }
+    rl->len_of = range_length_of(backend, call);
+    if (!rl->len_of || range_writes(body, call->arguments[0]->name))
+      return RANGE_NONE;
+  }
+
+  // i++ / i += S / i = i + S / i = S + i
+  ASTNode_C *s = nullptr;
+  if (incr && incr->type == AST_INCREMENT && incr->name &&
+      strcmp(incr->name, var) == 0) {
+    rl->step_lit = 1;
+  } else if (incr && incr->type == AST_COMPOUND_ASSIGN &&
+             incr->op == TOKEN_PLUS_EQUAL && incr->name &&
+             strcmp(incr->name, var) == 0) {
+    s = incr->right;
+  } else if (incr && incr->type == AST_ASSIGNMENT && incr->name &&
+             strcmp(incr->name, var) == 0 && incr->right &&
+             incr->right->type == AST_BINARY_OP &&
+             incr->right->op == TOKEN_PLUS) {
+    if (ast_is_identifier(incr->right->left, var))
+      s = incr->right->right;
+    else if (ast_is_identifier(incr->right->right, var))
+      s = incr->right->left;
+  }
+  if (s && s->type == AST_INT_LITERAL && s->value.int_value >= 1 &&
+      s->value.int_value <= (1LL << 32))
+    rl->step_lit = s->value.int_value;
+  else if (s && s->type == AST_IDENTIFIER && strcmp(s->name, var) != 0 &&
+           range_local_ok(backend, s->name) && !range_writes(body, s->name))
+    rl->step = s;
+  if (!rl->step_lit && !rl->step) return RANGE_NONE;
+
+  std::vector<RangeFact> all;
+  range_collect(backend, body, var, all);
+  std::vector<RangeFact> fixed, proved;
+  for (const RangeFact &f : all) {
+    LocalVar *v = nullptr;
+    for (Scope *sc = backend->current_scope; sc && !v; sc = sc->parent)
+      for (int i = 0; i < sc->count && !v; i++)
+        if (sc->vars[i].value == f.header) v = &sc->vars[i];
+    if (!v || range_writes(body, v->name)) continue;
+    fixed.push_back(f);
+    // length(a) (+ c) bound, literal LO and S: no guard needed.
+    long long last_slack = rl->inclusive ? 1 : 0;
+    if (f.header == rl->len_of && rl->step_lit && rl->lo &&
+        rl->lo->type == AST_INT_LITERAL &&
+        rl->lo->value.int_value + f.min_off >= 0 &&
+        f.max_off + last_slack + rl->len_off <= 0)
+      proved.push_back(f);
+  }
+  if (fixed.empty()) return RANGE_NONE;
+  if (proved.size() == fixed.size() || !range_body_plain(backend, body)) {
+    if (proved.empty()) return RANGE_NONE;
+    rl->facts = proved;
+    return RANGE_STATIC;
+  }
+  rl->facts = fixed;
+  return RANGE_GUARDED;
+}
+
+// `e` as an i64 for the loop guard; a boxed value also ANDs its "is an int"
+// test into *ok. 0 when `e` is statically not an int.
+static int range_int_operand(LLVMBackend *backend, ASTNode_C *e,
+                             LLVMValueRef *val, LLVMValueRef *ok) {
+  TypedValue tv = codegen_typed_expr(backend, e);
+  if (tv.type == INFERRED_INT) {
+    *val = tv.value;
+    return 1;
+  }
+  if (tv.type != INFERRED_UNKNOWN) return 0;
+  LLVMValueRef boxed = tv.boxed ? tv.boxed : tv.value;
+  if (!boxed) return 0;
+  LLVMBuilderRef b = backend->builder;
+  LLVMValueRef is_int =
+      LLVMBuildICmp(b, LLVMIntEQ, llvm_vm_tag(backend, boxed, "rg.tag"),
+                    LLVMConstInt(backend->int32_type, 0, 0), "rg.isint"); // VM_VAL_INT
+  *ok = LLVMBuildAnd(b, *ok, is_int, "rg.ok");
+  *val = llvm_vm_int_payload(backend, boxed, "rg.val");
+  return 1;
+}
+
+// The loop guard of RANGE_GUARDED, emitted right after the init: 1 when the
+// induction variable, B and S are ints, S >= 1 and every fact holds for
+// [i, last]. Null when an operand is statically not an int.
+static LLVMValueRef range_loop_guard(LLVMBackend *backend, RangeLoop *rl) {
+  LLVMBuilderRef b = backend->builder;
+  LLVMTypeRef i64 = backend->int_type;
+  auto k = [&](long long c) { return LLVMConstInt(i64, (unsigned long long)c, 1); };
+  LLVMValueRef ok = LLVMConstInt(backend->bool_type, 1, 0);
+  LLVMValueRef lo, bound, step;
+
+  ASTNode_C *id = ast_node_create(AST_IDENTIFIER);
+  id->name = strdup(rl->var);
+  int have_lo = range_int_operand(backend, id, &lo, &ok);
+  ast_node_free(id);
+  if (!have_lo || !range_int_operand(backend, rl->bound, &bound, &ok))
+    return nullptr;
+  if (rl->step) {
+    if (!range_int_operand(backend, rl->step, &step, &ok)) return nullptr;
+    ok = LLVMBuildAnd(b, ok, LLVMBuildICmp(b, LLVMIntSGE, step, k(1), "rg.s1"),
+                      "rg.ok");
+    ok = LLVMBuildAnd(
+        b, ok, LLVMBuildICmp(b, LLVMIntSLE, step, k(1LL << 32), "rg.smax"),
+        "rg.ok");
+  }
+  // Keep every sum below far from i64 wrap-around.
+  ok = LLVMBuildAnd(
+      b, ok, LLVMBuildICmp(b, LLVMIntSLE, bound, k(1LL << 32), "rg.bmax"),
+      "rg.ok");
+  ok = LLVMBuildAnd(
+      b, ok, LLVMBuildICmp(b, LLVMIntSGE, lo, k(-(1LL << 32)), "rg.lmin"),
+      "rg.ok");
+  LLVMValueRef last =
+      rl->inclusive ? bound : LLVMBuildSub(b, bound, k(1), "rg.last");
+  for (const RangeFact &f : rl->facts) {
+    LLVMValueRef count = LLVMBuildLoad2(
+        b, backend->int32_type,
+        LLVMBuildStructGEP2(b, typed_array_header_type(backend), f.header, 1,
+                            "rg.count.ptr"),
+        "rg.count");
+    LLVMValueRef len = LLVMBuildSExt(b, count, i64, "rg.len");
+    LLVMValueRef low_ok = LLVMBuildICmp(
+        b, LLVMIntSGE, LLVMBuildAdd(b, lo, k(f.min_off), "rg.lo"), k(0),
+        "rg.lo.ok");
+    LLVMValueRef high_ok = LLVMBuildICmp(
+        b, LLVMIntSLT, LLVMBuildAdd(b, last, k(f.max_off), "rg.hi"), len,
+        "rg.hi.ok");
+    ok = LLVMBuildAnd(b, ok, LLVMBuildAnd(b, low_ok, high_ok, "rg.in"),
+                      "rg.ok");
+  }
+  return ok;
+}
+
+// cond / body / incr of a C-style for loop, entered from the current block
+// and left through `exitB`.
+static void codegen_for_loop(LLVMBackend *backend, ASTNode_C *node,
+                             LLVMBasicBlockRef exitB) {
+  LLVMBasicBlockRef condB =
+      LLVMAppendBasicBlock(backend->current_function, "for_cond");
+  LLVMBasicBlockRef bodyB =
+      LLVMAppendBasicBlock(backend->current_function, "for_body");
+  LLVMBasicBlockRef incrB =
+      LLVMAppendBasicBlock(backend->current_function, "for_incr");
+
+  LLVMBuildBr(backend->builder, condB);
+  LLVMPositionBuilderAtEnd(backend->builder, condB);
+
+  LLVMValueRef c =
+      node->condition
+          ? llvm_build_is_truthy(backend,
+                                 codegen_expression(backend, node->condition))
+          : LLVMConstInt(backend->bool_type, 1, 0); // true if no condition
+  LLVMBuildCondBr(backend->builder, c, bodyB, exitB);
+
+  LLVMPositionBuilderAtEnd(backend->builder, bodyB);
+  // continue jumps to incrB (so the loop variable still increments),
+  // break jumps to exitB.
+  if (backend->loop_depth < 32) {
+    backend->loop_stack[backend->loop_depth].continue_block = incrB;
+    backend->loop_stack[backend->loop_depth].break_block = exitB;
+    backend->loop_stack[backend->loop_depth].try_depth_at_entry =
+        backend->try_depth;
+    backend->loop_depth++;
+  }
+  codegen_statement(backend, node->body);
+  if (backend->loop_depth > 0) backend->loop_depth--;
+  if (!LLVMGetBasicBlockTerminator(LLVMGetInsertBlock(backend->builder)))
+    LLVMBuildBr(backend->builder, incrB);
+
+  LLVMPositionBuilderAtEnd(backend->builder, incrB);
+  if (node->increment)
+    codegen_statement(backend, node->increment);
+  LLVMBuildBr(backend->builder, condB);
+}
+
+// Everything after the init of a `for`: plan the range proof, then emit the
+// loop once (with the proved facts, if any) or twice behind the guard.
+static void codegen_for_ranged(LLVMBackend *backend, ASTNode_C *node) {
+  LLVMValueRef fn = backend->current_function;
+  LLVMBasicBlockRef exitB = LLVMAppendBasicBlock(fn, "for_exit");
+  RangeData *rd = static_cast<RangeData *>(backend->range_data);
+  size_t depth = rd->facts.size();
+  RangeLoop rl;
+  int plan = range_plan_for(backend, node, &rl);
+  LLVMValueRef guard =
+      plan == RANGE_GUARDED ? range_loop_guard(backend, &rl) : nullptr;
+
+  if (plan == RANGE_STATIC) {
+    rd->static_loops++;
+    rd->facts.insert(rd->facts.end(), rl.facts.begin(), rl.facts.end());
+    codegen_for_loop(backend, node, exitB);
+    rd->facts.resize(depth);
+  } else if (guard) {
+    rd->versioned_loops++;
+    LLVMBasicBlockRef provedB = LLVMAppendBasicBlock(fn, "for_proved");
+    LLVMBasicBlockRef checkedB = LLVMAppendBasicBlock(fn, "for_checked");
+    LLVMBuildCondBr(backend->builder, guard, provedB, checkedB);
+    // Each copy declares the body's locals afresh in a scope of its own.
+    LLVMPositionBuilderAtEnd(backend->builder, provedB);
+    rd->facts.insert(rd->facts.end(), rl.facts.begin(), rl.facts.end());
+    enter_scope(backend);
+    codegen_for_loop(backend, node, exitB);
+    exit_scope(backend);
+    rd->facts.resize(depth);
+    LLVMPositionBuilderAtEnd(backend->builder, checkedB);
+    enter_scope(backend);
+    codegen_for_loop(backend, node, exitB);
+    exit_scope(backend);
+  } else {
+    codegen_for_loop(backend, node, exitB);
+  }
+  LLVMMoveBasicBlockAfter(exitB, LLVMGetLastBasicBlock(fn));
+  LLVMPositionBuilderAtEnd(backend->builder, exitB);
+}
+
+// ============================================================
+// CHECKED INT ARITHMETIC (--checks=full)
+// ============================================================
+//
+// `l op r` for op in + - *. Under --checks=full, outside `unchecked { }`,
+// the llvm.s*.with.overflow intrinsic feeds a cold call to aot_int_overflow,
+// which reports the error like the other runtime errors; the wrapped result
+// is kept either way, so values match the other check levels.
+static LLVMValueRef llvm_build_int_arith(LLVMBackend *backend,
+                                         TulparTokenType op, LLVMValueRef l,
+                                         LLVMValueRef r, const char *name) {
+  LLVMBuilderRef b = backend->builder;
+  if (backend->checks_mode != CHECKS_FULL || backend->unchecked_depth > 0) {
+    if (op == TOKEN_PLUS) return LLVMBuildAdd(b, l, r, name);
+    if (op == TOKEN_MINUS) return LLVMBuildSub(b, l, r, name);
+    return LLVMBuildMul(b, l, r, name);
+  }
+  const char *intrinsic = op == TOKEN_PLUS    ? "llvm.sadd.with.overflow.i64"
+                          : op == TOKEN_MINUS ? "llvm.ssub.with.overflow.i64"
+                                              : "llvm.smul.with.overflow.i64";
+  LLVMTypeRef pair_fields[] = {backend->int_type, backend->bool_type};
+  LLVMTypeRef pair_ty =
+      LLVMStructTypeInContext(backend->context, pair_fields, 2, 0);
+  LLVMTypeRef params[] = {backend->int_type, backend->int_type};
+  LLVMTypeRef fn_ty = LLVMFunctionType(pair_ty, params, 2, 0);
+  LLVMValueRef fn = LLVMGetNamedFunction(backend->module, intrinsic);
+  if (!fn) fn = LLVMAddFunction(backend->module, intrinsic, fn_ty);
+
+  LLVMValueRef args[] = {l, r};
+  LLVMValueRef pair = LLVMBuildCall2(b, fn_ty, fn, args, 2, "ovf");
+  LLVMValueRef res = LLVMBuildExtractValue(b, pair, 0, name);
+  LLVMValueRef bad = LLVMBuildExtractValue(b, pair, 1, "ovf.bad");
+  LLVMBasicBlockRef bad_bb =
+      LLVMAppendBasicBlock(backend->current_function, "ovf.report");
+  LLVMBasicBlockRef ok_bb =
+      LLVMAppendBasicBlock(backend->current_function, "ovf.ok");
+  LLVMBuildCondBr(b, bad, bad_bb, ok_bb);
+  LLVMPositionBuilderAtEnd(b, bad_bb);
+  LLVMBuildCall2(b, LLVMGlobalGetValueType(backend->func_aot_int_overflow),
+                 backend->func_aot_int_overflow, nullptr, 0, "");
+  LLVMBuildBr(b, ok_bb);
+  LLVMPositionBuilderAtEnd(b, ok_bb);
+  return res;
+}
+
+// ============================================================
+// STRING BUILDER LOCALS (`s = s + x` in a loop)
+// ============================================================
+//
+// Every `+` on strings allocates a fresh arena string holding both operands,
+// so the usual "build a CSV / HTML / metrics page in a loop" idiom
+//
+//   str out = "";
+//   for (...) { out = out + name + "," + toString(v) + "\n"; }
+//
+// copies the whole prefix on every step: O(n^2) bytes and arena memory.
+//
+// A `str` local that never escapes its function instead appends in place:
+// `out = out + e1 + e2` (and `out += e`) becomes one
+// aot_string_append_inplace call per e_i against the local's slot. The
+// runtime grows a string this function built itself geometrically (at the
+// arena tip when possible), and copies anything else — a literal, a
+// parameter's string, a call result — into a fresh buffer first. A hidden
+// per-local `owner` pointer says which string is ours; every plain
+// `out = ...` clears it.
+//
+// In-place growth is only sound while no one else can see the string, so
+// the escape scan below allows a bare `out` only where nothing keeps it:
+// print / len / length arguments, an operand of a binary operator other
+// than && / || (those results are new values), `return out`, and the
+// append / reassignment forms themselves (with `out` absent from the
+// appended parts). Passing it to a function, storing it into an array or
+// object, aliasing it (`t = out`), capturing it in a lambda or a shadowing
+// decl keeps the WHOLE local on the regular `+` path. Functions that call
+// arena_restore / arena_drop / arena_reset are skipped entirely: a rewind
+// could recycle the owned string's memory behind the owner pointer.
+//
+// Scope: like the unboxed typed arrays, only locals of a boxed-ABI user
+// function (codegen_func_def); globals and lambda locals are untouched.
+
+// `rhs` is `name + e1 + ... + en` (left-nested, n >= 1) with `name` absent
+// from every e_i. Fills `parts` (in order) when non-null; returns n or 0.
+static int str_builder_append_chain(ASTNode_C *rhs, const char *name,
+                                    ASTNode_C **parts, int cap) {
+  int n = 0;
+  ASTNode_C *r = rhs;
+  while (r && r->type == AST_BINARY_OP && r->op == TOKEN_PLUS) {
+    if (ast_mentions_name(r->right, name)) return 0;
+    n++;
+    r = r->left;
+  }
+  if (n == 0 || n > cap || !ast_is_identifier(r, name)) return 0;
+  if (parts) {
+    int i = n;
+    for (r = rhs; i > 0; r = r->left) parts[--i] = r->right;
+  }
+  return n;
+}
+
+// Escape scan (see the section comment): 1 when every use of `name` under
+// `n` keeps the string private to the local. Same shape as
+// typed_array_uses_ok.
+static int str_builder_uses_ok(ASTNode_C *n, const char *name,
+                               ASTNode_C *decl) {
+  if (!n) return 1;
+  switch (n->type) {
+  case AST_IDENTIFIER:
+    return !(n->name && strcmp(n->name, name) == 0);
+  case AST_LAMBDA:
+  case AST_FUNCTION_DECL:
+    return !ast_mentions_name(n, name);
+  case AST_ASSIGNMENT:
+    if (n->name && strcmp(n->name, name) == 0) {
+      if (n->left) return 0;
+      ASTNode_C *parts[64];
+      int np = str_builder_append_chain(n->right, name, parts, 64);
+      for (int i = 0; i < np; i++)
+        if (!str_builder_uses_ok(parts[i], name, decl)) return 0;
+      if (np > 0) return 1;
+      return !ast_mentions_name(n->right, name) &&
+             str_builder_uses_ok(n->right, name, decl);
+    }
+    break;
+  case AST_COMPOUND_ASSIGN:
+    if (n->name && strcmp(n->name, name) == 0)
+      return n->op == TOKEN_PLUS_EQUAL && !ast_mentions_name(n->right, name) &&
+             str_builder_uses_ok(n->right, name, decl);
+    break;
+  case AST_INCREMENT:
+  case AST_DECREMENT:
+    if (n->name && strcmp(n->name, name) == 0) return 0;
+    break;
+  case AST_BINARY_OP:
+    if (n->op != TOKEN_AND && n->op != TOKEN_OR) {
+      if (!ast_is_identifier(n->left, name) &&
+          !str_builder_uses_ok(n->left, name, decl))
+        return 0;
+      if (!ast_is_identifier(n->right, name) &&
+          !str_builder_uses_ok(n->right, name, decl))
+        return 0;
+      return 1;
+    }
+    break;
+  case AST_FUNCTION_CALL:
+    if (!n->receiver && !n->callee && n->name) {
+      if (strcmp(n->name, "arena_restore") == 0 ||
+          strcmp(n->name, "arena_drop") == 0 ||
+          strcmp(n->name, "arena_reset") == 0)
+        return 0;
+      if (strcmp(n->name, "print") == 0 || strcmp(n->name, "len") == 0 ||
+          strcmp(n->name, "length") == 0) {
+        for (int i = 0; i < n->argument_count; i++) {
+          if (ast_is_identifier(n->arguments[i], name)) continue;
+          if (!str_builder_uses_ok(n->arguments[i], name, decl)) return 0;
+        }
+        return 1;
+      }
+    }
+    break;
+  case AST_RETURN:
+    if (ast_is_identifier(n->return_value, name)) return 1;
+    break;
+  case AST_VARIABLE_DECL:
+    if (n != decl && n->name && strcmp(n->name, name) == 0) return 0;
+    break;
+  case AST_FOR_IN:
+    if (n->name && strcmp(n->name, name) == 0) return 0;
+    break;
+  case AST_TRY_CATCH:
+    if (n->catch_var && strcmp(n->catch_var, name) == 0) return 0;
+    break;
+  default:
+    break;
+  }
+  return for_each_child(n, [&](ASTNode_C *k) {
+    return str_builder_uses_ok(k, name, decl);
+  });
+}
+
+// Does the body append to `name` at all? Without an append the scan is
+// moot and the local keeps the plain path.
+static int str_builder_has_append(ASTNode_C *n, const char *name) {
+  if (!n || n->type == AST_LAMBDA || n->type == AST_FUNCTION_DECL) return 0;
+  if (n->name && strcmp(n->name, name) == 0 && !n->left &&
+      ((n->type == AST_ASSIGNMENT &&
+        str_builder_append_chain(n->right, name, nullptr, 64) > 0) ||
+       (n->type == AST_COMPOUND_ASSIGN && n->op == TOKEN_PLUS_EQUAL)))
+    return 1;
+  return !for_each_child(n, [&](ASTNode_C *k) {
+    return !str_builder_has_append(k, name);
+  });
+}
+
+// Pre-pass over a function body, next to collect_typed_array_decls: pick the
+// `str` decls that can append in place.
+static void collect_str_builder_decls(LLVMBackend *backend, ASTNode_C *func,
+                                      ASTNode_C *n, ASTNode_C **decls,
+                                      int *count, int cap) {
+  if (!n || n->type == AST_LAMBDA || n->type == AST_FUNCTION_DECL) return;
+  if (n->type == AST_VARIABLE_DECL && n->name && *count < cap &&
+      (n->data_type == TYPE_STRING ||
+       (n->right && n->right->type == AST_STRING_LITERAL))) {
+    int ok = LLVMGetNamedGlobal(backend->module, n->name) == nullptr;
+    for (int i = 0; ok && i < func->param_count; i++)
+      if (func->parameters[i] && func->parameters[i]->name &&
+          strcmp(func->parameters[i]->name, n->name) == 0)
+        ok = 0;
+    CaptureData *cd = (CaptureData *)backend->capture_data;
+    if (ok && cd && cd->slots.find(func) != cd->slots.end() &&
+        cd->slots[func].find(n->name) != cd->slots[func].end())
+      ok = 0;
+    if (ok && str_builder_has_append(func->body, n->name) &&
+        !ast_mentions_name(n->right, n->name) &&
+        str_builder_uses_ok(func->body, n->name, n))
+      decls[(*count)++] = n;
+  }
+  for_each_child(n, [&](ASTNode_C *k) {
+    collect_str_builder_decls(backend, func, k, decls, count, cap);
+    return true;
+  });
+}
+
+static int is_str_builder_decl(LLVMBackend *backend, ASTNode_C *decl) {
+  if (!backend->str_builder_fn ||
+      backend->current_function != backend->str_builder_fn)
+    return 0;
+  for (int i = 0; i < backend->str_builder_count; i++)
+    if (backend->str_builders[i] == decl) return 1;
+  return 0;
+}
+
+// The string-builder local `name` resolves to here, or null.
+static LocalVar *str_builder_local(LLVMBackend *backend, const char *name) {
+  if (!name || !backend->str_builder_fn ||
+      backend->current_function != backend->str_builder_fn)
+    return nullptr;
+  LocalVar *v = get_local_var(backend, name);
+  return v && v->str_owner && !v->is_captured ? v : nullptr;
+}
+
+// Append each part to the builder's slot in order; returns the new value.
+static LLVMValueRef emit_str_builder_append(LLVMBackend *backend, LocalVar *v,
+                                            ASTNode_C **parts, int count) {
+  LLVMValueRef tmp =
+      llvm_build_alloca_at_entry(backend, backend->vm_value_type, "sb.part");
+  for (int i = 0; i < count; i++) {
+    LLVMValueRef part = codegen_expression(backend, parts[i]);
+    LLVMBuildStore(backend->builder, part, tmp);
+    LLVMValueRef args[] = {v->value, tmp, v->str_owner};
+    LLVMBuildCall2(
+        backend->builder,
+        LLVMGlobalGetValueType(backend->func_aot_string_append_inplace),
+        backend->func_aot_string_append_inplace, args, 3, "");
+  }
+  return LLVMBuildLoad2(backend->builder, backend->vm_value_type, v->value,
+                        v->name);
+}
+
+// ============================================================
+// STACK CONTAINER LOCALS (`json opts = {...}` that never leaves)
+// ============================================================
+//
+// A `{...}` / `[...]` literal normally gets a runtime-allocated header:
+// malloc'd outside a request scope (and, since nothing frees locals, kept
+// for good), bump-allocated from the arena inside one. A literal bound to a
+// local that provably never escapes its function instead gets its header
+// and first slots as allocas in the entry block; aot_stack_*_init stamps the
+// header each time the declaration runs (so a decl in a loop reuses the same
+// frame memory) and the usual push / set calls fill it. No allocation, no
+// ARC traffic, nothing for arena_restore to walk.
+//
+// The scan below is intraprocedural and deliberately narrow. A bare `x` is
+// allowed only where the callee reads it and keeps nothing: print / len /
+// length / toJson / toString / keys / values / contains / indexOf, and as
+// the receiver of push / pop (the pushed value is scanned like any other
+// expression). `x[k]` reads, `x[k] = v` / `x[k] += v` writes and a for-in
+// over `x` are fine — the elements themselves are ordinary heap / arena
+// values, so reading one out hands back something that outlives the frame.
+// Returning `x`, passing it to a user function, storing it anywhere,
+// aliasing it, capturing it in a lambda, rebinding it or a shadowing decl
+// keeps the literal on the regular path. Functions that call arena_restore /
+// arena_drop / arena_reset are skipped like the string builders: the
+// container is tagged transient, so values stored into it are not persisted
+// and a rewind in the same frame would leave it pointing at recycled memory.
+//
+// Growth past the inline slots (STACK_CONTAINER_MIN_SLOTS, or the literal's
+// size up to STACK_CONTAINER_MAX_LITERAL) goes to the arena, same as any
+// transient container. Scope: locals of a boxed-ABI user function only.
+
+#define STACK_CONTAINER_MIN_SLOTS 8
+#define STACK_CONTAINER_MAX_LITERAL 16
+
+// Push each element of an array literal into `arr` (an ObjArray*).
+static void emit_array_literal_items(LLVMBackend *backend, ASTNode_C *node,
+                                     LLVMValueRef arr) {
+  for (int i = 0; node->elements && i < node->element_count; i++) {
+    ASTNode_C *el = node->elements[i];
+    // A native (int/bool) struct element is boxed as a string-keyed
+    // object here too — otherwise `[a][0].x` reinterprets the aggregate's
+    // bytes as a VMValue. Mirrors the push() escape path.
+    LLVMValueRef val = codegen_struct_expr_as_object(backend, el);
+    if (!val) val = codegen_expression(backend, el);
+    LLVMValueRef val_ptr = llvm_build_alloca_at_entry(
+        backend, backend->vm_value_type, "arr_lit_val_ptr");
+    LLVMBuildStore(backend->builder, val, val_ptr);
+    LLVMValueRef val_void = LLVMBuildBitCast(
+        backend->builder, val_ptr, backend->ptr_type, "arr_lit_val_void");
+    LLVMValueRef push_args[] = {LLVMConstNull(backend->ptr_type), arr,
+                                val_void};
+    LLVMBuildCall2(backend->builder,
+                   LLVMGlobalGetValueType(backend->func_vm_array_push),
+                   backend->func_vm_array_push, push_args, 3, "");
+  }
+}
+
+// Set each key of an object literal on `obj` (an ObjObject*).
+static void emit_object_literal_entries(LLVMBackend *backend, ASTNode_C *node,
+                                        LLVMValueRef obj) {
+  for (int i = 0; i < node->object_count; i++) {
+    char *key_str = node->object_keys[i];
+    LLVMValueRef key_global =
+        LLVMBuildGlobalStringPtr(backend->builder, key_str, "key_str");
+
+    LLVMValueRef val = codegen_expression(backend, node->object_values[i]);
+
+    LLVMValueRef val_ptr = llvm_build_alloca_at_entry(
+        backend, backend->vm_value_type, "obj_lit_val_ptr");
+    LLVMBuildStore(backend->builder, val, val_ptr);
+    LLVMValueRef val_void = LLVMBuildBitCast(
+        backend->builder, val_ptr, backend->ptr_type, "obj_lit_val_void");
+
+    LLVMValueRef set_args[] = {
+        LLVMConstPointerNull(backend->ptr_type), // VM*
+        obj,                                     // ObjObject*
+        key_global,                              // char* key
+        val_void                                 // VMValue* value
+    };
+    LLVMBuildCall2(backend->builder,
+                   LLVMGlobalGetValueType(backend->func_vm_object_set),
+                   backend->func_vm_object_set, set_args, 4, "");
+  }
+}
+
+// Builtins that only read a container argument.
+static int stack_container_reader(const char *fn) {
+  static const char *const readers[] = {
+      "print", "len",    "length",   "toJson", "toString",
+      "keys",  "values", "contains", "indexOf"};
+  for (const char *r : readers)
+    if (strcmp(fn, r) == 0) return 1;
+  return 0;
+}
+
+// Escape scan (see the section comment): 1 when no use of `name` under `n`
+// can let the container outlive the frame. Same shape as
+// typed_array_uses_ok.
+static int stack_container_uses_ok(ASTNode_C *n, const char *name,
+                                   ASTNode_C *decl) {
+  if (!n) return 1;
+  switch (n->type) {
+  case AST_IDENTIFIER:
+    return !(n->name && strcmp(n->name, name) == 0);
+  case AST_LAMBDA:
+  case AST_FUNCTION_DECL:
+    return !ast_mentions_name(n, name);
+  case AST_ARRAY_ACCESS: {
+    const char *recv = array_access_receiver(n);
+    if (recv && strcmp(recv, name) == 0)
+      return stack_container_uses_ok(n->index, name, decl);
+    break;
+  }
+  case AST_FUNCTION_CALL:
+    if (!n->receiver && !n->callee && n->name) {
+      if (strcmp(n->name, "arena_restore") == 0 ||
+          strcmp(n->name, "arena_drop") == 0 ||
+          strcmp(n->name, "arena_reset") == 0)
+        return 0;
+      int reader = stack_container_reader(n->name);
+      int mutator =
+          strcmp(n->name, "push") == 0 || strcmp(n->name, "pop") == 0;
+      if (reader || mutator) {
+        for (int i = 0; i < n->argument_count; i++) {
+          if ((reader || i == 0) && ast_is_identifier(n->arguments[i], name))
+            continue;
+          if (!stack_container_uses_ok(n->arguments[i], name, decl)) return 0;
+        }
+        return 1;
+      }
+    }
+    break;
+  case AST_FOR_IN:
+    if (n->name && strcmp(n->name, name) == 0) return 0;
+    if (ast_is_identifier(n->iterable, name))
+      return stack_container_uses_ok(n->body, name, decl);
+    break;
+  case AST_VARIABLE_DECL:
+    if (n != decl && n->name && strcmp(n->name, name) == 0) return 0;
+    break;
+  case AST_ASSIGNMENT:
+  case AST_COMPOUND_ASSIGN:
+  case AST_INCREMENT:
+  case AST_DECREMENT:
+    // `x = ...` rebinds the local; `x[k] = v` keeps `n->left` (the access).
+    if (!n->left && n->name && strcmp(n->name, name) == 0) return 0;
+    break;
+  case AST_TRY_CATCH:
+    if (n->catch_var && strcmp(n->catch_var, name) == 0) return 0;
+    break;
+  default:
+    break;
+  }
+  return for_each_child(n, [&](ASTNode_C *k) {
+    return stack_container_uses_ok(k, name, decl);
+  });
+}
+
+// ObjArray / ObjObject header layouts (src/vm/vm.hpp), so the allocas get
+// the target's size and alignment.
+static LLVMTypeRef stack_container_header_type(LLVMBackend *backend,
+                                               int is_object) {
+  LLVMTypeRef fields[] = {backend->obj_type, backend->int32_type,
+                          backend->int32_type, backend->ptr_type,
+                          backend->ptr_type};
+  return LLVMStructTypeInContext(backend->context, fields, is_object ? 5 : 4,
+                                 0);
+}
+
+// Pre-pass over a function body, after collect_typed_array_decls: pick the
+// container literal decls that can live on the stack and give each its
+// header + slot allocas (still in the entry block).
+static void collect_stack_container_decls(LLVMBackend *backend,
+                                          ASTNode_C *func, ASTNode_C *n,
+                                          StackContainerSlot *slots,
+                                          int *count, int cap) {
+  if (!n || n->type == AST_LAMBDA || n->type == AST_FUNCTION_DECL) return;
+  if (n->type == AST_VARIABLE_DECL && n->name && *count < cap && n->right &&
+      (n->right->type == AST_OBJECT_LITERAL ||
+       n->right->type == AST_ARRAY_LITERAL) &&
+      (n->data_type == TYPE_UNKNOWN || n->data_type == TYPE_JSON ||
+       n->data_type == TYPE_ARRAY || n->data_type == TYPE_ARRAY_JSON ||
+       n->data_type == TYPE_ARRAY_STR)) {
+    int is_object = n->right->type == AST_OBJECT_LITERAL;
+    int size = is_object ? n->right->object_count : n->right->element_count;
+    int ok = size <= STACK_CONTAINER_MAX_LITERAL &&
+             LLVMGetNamedGlobal(backend->module, n->name) == nullptr &&
+             !typed_array_slot_for_decl(backend, n);
+    for (int i = 0; ok && i < func->param_count; i++)
+      if (func->parameters[i] && func->parameters[i]->name &&
+          strcmp(func->parameters[i]->name, n->name) == 0)
+        ok = 0;
+    CaptureData *cd = (CaptureData *)backend->capture_data;
+    if (ok && cd && cd->slots.find(func) != cd->slots.end() &&
+        cd->slots[func].find(n->name) != cd->slots[func].end())
+      ok = 0;
+    if (ok && !ast_mentions_name(n->right, n->name) &&
+        stack_container_uses_ok(func->body, n->name, n)) {
+      int slots_n =
+          size > STACK_CONTAINER_MIN_SLOTS ? size : STACK_CONTAINER_MIN_SLOTS;
+      StackContainerSlot *s = &slots[(*count)++];
+      s->decl = n;
+      s->cap = slots_n;
+      s->header = llvm_build_alloca_at_entry(
+          backend, stack_container_header_type(backend, is_object), n->name);
+      s->slots = llvm_build_alloca_at_entry(
+          backend, LLVMArrayType(backend->vm_value_type, slots_n),
+          "stack.slots");
+      s->keys = is_object ? llvm_build_alloca_at_entry(
+                                backend,
+                                LLVMArrayType(backend->ptr_type, slots_n),
+                                "stack.keys")
+                          : nullptr;
+      backend->stack_container_total++;
+    }
+  }
+  for_each_child(n, [&](ASTNode_C *k) {
+    collect_stack_container_decls(backend, func, k, slots, count, cap);
+    return true;
+  });
+}
+
+static StackContainerSlot *stack_container_slot_for_decl(LLVMBackend *backend,
+                                                         ASTNode_C *decl) {
+  if (!backend->stack_container_fn ||
+      backend->current_function != backend->stack_container_fn)
+    return nullptr;
+  for (int i = 0; i < backend->stack_container_count; i++)
+    if (backend->stack_containers[i].decl == decl)
+      return &backend->stack_containers[i];
+  return nullptr;
+}
+
+// The declaration's literal, built in its frame slot. Returns the boxed
+// VMValue like the AST_ARRAY_LITERAL / AST_OBJECT_LITERAL codegen.
+static LLVMValueRef emit_stack_container_literal(LLVMBackend *backend,
+                                                 StackContainerSlot *s,
+                                                 ASTNode_C *lit) {
+  LLVMValueRef hdr = LLVMBuildBitCast(backend->builder, s->header,
+                                      backend->ptr_type, "stack.hdr");
+  LLVMValueRef vals = LLVMBuildBitCast(backend->builder, s->slots,
+                                       backend->ptr_type, "stack.vals");
+  LLVMValueRef cap = LLVMConstInt(backend->int32_type, s->cap, 0);
+  LLVMValueRef obj;
+  if (s->keys) {
+    LLVMValueRef keys = LLVMBuildBitCast(backend->builder, s->keys,
+                                         backend->ptr_type, "stack.keys.ptr");
+    LLVMValueRef args[] = {hdr, keys, vals, cap};
+    obj = LLVMBuildCall2(
+        backend->builder,
+        LLVMGlobalGetValueType(backend->func_aot_stack_object_init),
+        backend->func_aot_stack_object_init, args, 4, "stack_obj");
+    emit_object_literal_entries(backend, lit, obj);
+  } else {
+    LLVMValueRef args[] = {hdr, vals, cap};
+    obj = LLVMBuildCall2(
+        backend->builder,
+        LLVMGlobalGetValueType(backend->func_aot_stack_array_init),
+        backend->func_aot_stack_array_init, args, 3, "stack_arr");
+    emit_array_literal_items(backend, lit, obj);
+  }
+  return llvm_build_vm_val_obj(backend, obj);
+}
+
+// ============================================================
+// OWNERSHIP MOVES (last use of a local stored into a global)
+// ============================================================
+//
+// Locals get no retain/release in AOT code: they are arena values
+// (reclaimed by arena_restore) or malloc'd ones that simply live on. The
+// ownership traffic the backend does emit sits at the global boundary:
+// every `g = v` copies v with aot_persist (AUTO-PERSIST above) and
+// every boxed global decl walks its value with arc_share_vmvalue. This
+// pass drops the ones that cannot matter:
+//
+//  * a global declared with a scalar value (`bool g = true`, `json g = 0`)
+//    has nothing to share, so the decl emits no arc_share_vmvalue;
+//  * a fresh container temporary (`g = []`, `g = {"n": 0}`,
+//    `g = fromJson(s)`) and the last use of a local that only ever held
+//    fresh values become a move: aot_persist_move hands a permanent value
+//    over as is and still copies an arena one.
+//
+// "Last use" is per function and in source order: `g = x` is the final
+// mention of x, x is a plain local (not a parameter, global or capture),
+// and every loop around the assignment also contains x's declaration, so
+// the next iteration starts from a new x. Before that point x may only be
+// used the way STACK CONTAINER LOCALS allows — builtins that keep nothing,
+// element reads and writes, push / pop, for-in — and whatever is stored
+// into it must be fresh too, so the global never shares a child with
+// another variable. If a stored value is itself a container, handing out
+// elements (`x[k]`, for-in, values(x)) is refused as well. The verdict is
+// recorded on the rhs identifier (ASTNode_C.is_moved); the assignment
+// codegen reads it. TULPAR_AOT_VERBOSE reports the count per function.
+
+// Declared type of `name` in `func`: its parameter or every local decl of
+// that name agreeing on one type; TYPE_UNKNOWN otherwise.
+static void ownership_decl_types(ASTNode_C *n, const char *name,
+                                 DataType *type, int *count) {
+  if (!n || n->type == AST_LAMBDA || n->type == AST_FUNCTION_DECL) return;
+  if ((n->type == AST_VARIABLE_DECL || n->type == AST_FOR_IN) && n->name &&
+      strcmp(n->name, name) == 0) {
+    DataType t = n->type == AST_VARIABLE_DECL ? n->data_type : TYPE_UNKNOWN;
+    if (*count > 0 && *type != t) t = TYPE_UNKNOWN;
+    *type = t;
+    (*count)++;
+  }
+  if (n->catch_var && strcmp(n->catch_var, name) == 0) {
+    *type = TYPE_UNKNOWN;
+    (*count)++;
+  }
+  for_each_child(n, [&](ASTNode_C *k) {
+    ownership_decl_types(k, name, type, count);
+    return true;
+  });
+}
+
+static DataType ownership_decl_type(ASTNode_C *func, const char *name) {
+  if (!func || !name) return TYPE_UNKNOWN;
+  for (int i = 0; i < func->param_count; i++)
+    if (func->parameters[i] && func->parameters[i]->name &&
+        strcmp(func->parameters[i]->name, name) == 0)
+      return func->parameters[i]->data_type;
+  DataType t = TYPE_UNKNOWN;
+  int count = 0;
+  ownership_decl_types(func->body, name, &t, &count);
+  return count > 0 ? t : TYPE_UNKNOWN;
+}
+
+static int ownership_user_function(LLVMBackend *backend, const char *name) {
+  for (int j = 0; j < backend->function_count; j++)
+    if (backend->functions[j].name &&
+        strcmp(backend->functions[j].name, name) == 0)
+      return 1;
+  return 0;
+}
+
+// How fresh a value is — nothing else can reference it once built:
+// 0 = might alias a variable, 1 = scalar or string, 2 = new container of
+// scalars / strings, 3 = new container that may hold containers.
+static int ownership_fresh_expr(LLVMBackend *backend, ASTNode_C *func,
+                                ASTNode_C *n) {
+  if (!n) return 0;
+  switch (n->type) {
+  case AST_INT_LITERAL:
+  case AST_FLOAT_LITERAL:
+  case AST_BOOL_LITERAL:
+  case AST_NULL_LITERAL:
+  case AST_STRING_LITERAL:
+  case AST_BINARY_OP: // arithmetic, comparisons, string concatenation
+  case AST_UNARY_OP:
+    return 1;
+  case AST_IDENTIFIER: {
+    DataType t = ownership_decl_type(func, n->name);
+    return t == TYPE_INT || t == TYPE_FLOAT || t == TYPE_BOOL ||
+           t == TYPE_STRING;
+  }
+  case AST_TERNARY: {
+    int a = ownership_fresh_expr(backend, func, n->then_branch);
+    int b = ownership_fresh_expr(backend, func, n->else_branch);
+    return a && b ? (a > b ? a : b) : 0;
+  }
+  case AST_ARRAY_LITERAL:
+  case AST_OBJECT_LITERAL: {
+    int is_object = n->type == AST_OBJECT_LITERAL;
+    int count = is_object ? n->object_count : n->element_count;
+    int level = 2;
+    for (int i = 0; i < count; i++) {
+      int e = ownership_fresh_expr(
+          backend, func, is_object ? n->object_values[i] : n->elements[i]);
+      if (!e) return 0;
+      if (e >= 2) level = 3;
+    }
+    return level;
+  }
+  case AST_FUNCTION_CALL: {
+    if (n->receiver || n->callee || !n->name ||
+        ownership_user_function(backend, n->name))
+      return 0;
+    static const char *const scalars[] = {
+        "toString", "toJson", "toInt",   "toFloat", "len",     "length",
+        "upper",    "lower",  "trim",    "replace", "substring", "contains",
+        "indexOf",  "str"};
+    for (const char *s : scalars)
+      if (strcmp(n->name, s) == 0) return 1;
+    if (strcmp(n->name, "split") == 0 || strcmp(n->name, "keys") == 0 ||
+        strcmp(n->name, "range") == 0)
+      return 2;
+    if (strcmp(n->name, "fromJson") == 0) return 3;
+    return 0;
+  }
+  default:
+    return 0;
+  }
+}
+
+// Nothing to copy or share: the value is an int / float / bool whatever
+// the operands hold at run time.
+static int ownership_scalar_expr(LLVMBackend *backend, ASTNode_C *n) {
+  if (!n) return 0;
+  switch (n->type) {
+  case AST_INT_LITERAL:
+  case AST_FLOAT_LITERAL:
+  case AST_BOOL_LITERAL:
+  case AST_UNARY_OP:
+    return 1;
+  case AST_BINARY_OP:
+    return n->op != TOKEN_PLUS ||
+           (ownership_scalar_expr(backend, n->left) &&
+            ownership_scalar_expr(backend, n->right));
+  case AST_IDENTIFIER: {
+    InferredType t = n->name ? get_local_type(backend, n->name)
+                             : INFERRED_UNKNOWN;
+    return t == INFERRED_INT || t == INFERRED_FLOAT || t == INFERRED_BOOL;
+  }
+  case AST_TERNARY:
+    return ownership_scalar_expr(backend, n->then_branch) &&
+           ownership_scalar_expr(backend, n->else_branch);
+  default:
+    return 0;
+  }
+}
+
+typedef struct {
+  LLVMBackend *backend;
+  ASTNode_C *func;
+  const char *name;  // the local `x`
+  ASTNode_C *decl;   // its only declaration
+  ASTNode_C *site;   // the `g = x` assignment
+  int nested;        // a container was stored into x
+  int reads;         // x handed out an element
+  ASTNode_C *decl_loops[16];
+  int decl_depth;    // -1 until the decl is reached
+  int seen_site;
+  int reject;
+} OwnershipScan;
+
+// Uses of x before the move (see the section comment). Same shape as
+// stack_container_uses_ok.
+static int ownership_uses_ok(OwnershipScan *s, ASTNode_C *n) {
+  if (!n || n == s->site) return 1;
+  const char *name = s->name;
+  switch (n->type) {
+  case AST_IDENTIFIER:
+    return !(n->name && strcmp(n->name, name) == 0);
+  case AST_LAMBDA:
+  case AST_FUNCTION_DECL:
+    return !ast_mentions_name(n, name);
+  case AST_ARRAY_ACCESS: {
+    const char *recv = array_access_receiver(n);
+    if (recv && strcmp(recv, name) == 0) {
+      s->reads = 1;
+      return ownership_uses_ok(s, n->index);
+    }
+    break;
+  }
+  case AST_FUNCTION_CALL:
+    if (!n->receiver && !n->callee && n->name &&
+        !ownership_user_function(s->backend, n->name)) {
+      int push = strcmp(n->name, "push") == 0;
+      int mutator = push || strcmp(n->name, "pop") == 0;
+      int reader = stack_container_reader(n->name);
+      if (strcmp(n->name, "values") == 0) {
+        reader = 1;
+        if (n->argument_count > 0 && ast_is_identifier(n->arguments[0], name))
+          s->reads = 1;
+      }
+      if (reader || mutator) {
+        for (int i = 0; i < n->argument_count; i++) {
+          if ((reader || i == 0) && ast_is_identifier(n->arguments[i], name))
+            continue;
+          if (push && n->argument_count > 0 &&
+              ast_is_identifier(n->arguments[0], name)) {
+            int f = ownership_fresh_expr(s->backend, s->func, n->arguments[i]);
+            if (!f) return 0;
+            if (f >= 2) s->nested = 1;
+          }
+          if (!ownership_uses_ok(s, n->arguments[i])) return 0;
+        }
+        return 1;
+      }
+    }
+    break;
+  case AST_FOR_IN:
+    if (n->name && strcmp(n->name, name) == 0) return 0;
+    if (ast_is_identifier(n->iterable, name)) {
+      s->reads = 1;
+      return ownership_uses_ok(s, n->body);
+    }
+    break;
+  case AST_VARIABLE_DECL:
+    if (n->name && strcmp(n->name, name) == 0) {
+      if (n != s->decl) return 0;
+      int f = n->right ? ownership_fresh_expr(s->backend, s->func, n->right)
+                       : 1;
+      if (!f) return 0;
+      if (f == 3) s->nested = 1;
+    }
+    break;
+  case AST_ASSIGNMENT:
+    if (!n->left && n->name && strcmp(n->name, name) == 0) {
+      int f = ownership_fresh_expr(s->backend, s->func, n->right);
+      if (!f) return 0;
+      if (f == 3) s->nested = 1;
+      return ownership_uses_ok(s, n->right);
+    }
+    if (n->left && n->left->type == AST_ARRAY_ACCESS) {
+      const char *recv = array_access_receiver(n->left);
+      if (recv && strcmp(recv, name) == 0) {
+        int f = ownership_fresh_expr(s->backend, s->func, n->right);
+        if (!f) return 0;
+        if (f >= 2) s->nested = 1;
+        return ownership_uses_ok(s, n->left->index) &&
+               ownership_uses_ok(s, n->right);
+      }
+    }
+    break;
+  case AST_COMPOUND_ASSIGN:
+  case AST_INCREMENT:
+  case AST_DECREMENT:
+    if (!n->left && n->name && strcmp(n->name, name) == 0) return 0;
+    break;
+  case AST_TRY_CATCH:
+    if (n->catch_var && strcmp(n->catch_var, name) == 0) return 0;
+    break;
+  default:
+    break;
+  }
+  return for_each_child(n, [&](ASTNode_C *k) {
+    return ownership_uses_ok(s, k);
+  });
+}
+
+// Source-order walk: is the site the last mention of x, and is every loop
+// around it also around the decl?
+static void ownership_order_scan(OwnershipScan *s, ASTNode_C *n,
+                                 ASTNode_C **loops, int depth) {
+  if (!n || s->reject || n->type == AST_LAMBDA ||
+      n->type == AST_FUNCTION_DECL)
+    return;
+  if (n == s->decl) {
+    s->decl_depth = depth;
+    for (int i = 0; i < depth; i++) s->decl_loops[i] = loops[i];
+  }
+  if (n == s->site) {
+    s->seen_site = 1;
+    if (s->decl_depth < 0 || depth < s->decl_depth) {
+      s->reject = 1;
+      return;
+    }
+    for (int i = 0; i < depth; i++)
+      if (i >= s->decl_depth || loops[i] != s->decl_loops[i]) s->reject = 1;
+    return;
+  }
+  if (s->seen_site && n->type != AST_FUNCTION_CALL && n->name &&
+      strcmp(n->name, s->name) == 0) {
+    s->reject = 1;
+    return;
+  }
+  if (n->type == AST_WHILE || n->type == AST_FOR || n->type == AST_FOR_IN) {
+    if (depth >= 16) {
+      s->reject = 1;
+      return;
+    }
+    loops[depth++] = n;
+  }
+  for_each_child(n, [&](ASTNode_C *k) {
+    ownership_order_scan(s, k, loops, depth);
+    return true;
+  });
+}
+
+static ASTNode_C *ownership_find_decl(ASTNode_C *n, const char *name) {
+  if (!n || n->type == AST_LAMBDA || n->type == AST_FUNCTION_DECL)
+    return nullptr;
+  if (n->type == AST_VARIABLE_DECL && n->name && strcmp(n->name, name) == 0)
+    return n;
+  ASTNode_C *found = nullptr;
+  for_each_child(n, [&](ASTNode_C *k) {
+    found = ownership_find_decl(k, name);
+    return !found;
+  });
+  return found;
+}
+
+// Pre-pass over a function body: mark `g = x` sites that can move x.
+static void collect_ownership_moves(LLVMBackend *backend, ASTNode_C *func,
+                                    ASTNode_C *n) {
+  if (!n || n->type == AST_LAMBDA || n->type == AST_FUNCTION_DECL) return;
+  if (n->type == AST_ASSIGNMENT && !n->left && n->name &&
+      strcmp(n->name, "_request") != 0 && n->right &&
+      n->right->type == AST_IDENTIFIER && n->right->name &&
+      LLVMGetNamedGlobal(backend->module, n->name) != nullptr &&
+      LLVMGetNamedGlobal(backend->module, n->right->name) == nullptr) {
+    const char *x = n->right->name;
+    DataType dt = TYPE_UNKNOWN;
+    int decls = 0, shadows = 0;
+    ownership_decl_types(func->body, x, &dt, &decls);
+    ownership_decl_types(func->body, n->name, &dt, &shadows);
+    int ok = decls == 1 && shadows == 0;
+    for (int i = 0; ok && i < func->param_count; i++)
+      if (func->parameters[i] && func->parameters[i]->name &&
+          (strcmp(func->parameters[i]->name, x) == 0 ||
+           strcmp(func->parameters[i]->name, n->name) == 0))
+        ok = 0;
+    CaptureData *cd = (CaptureData *)backend->capture_data;
+    if (ok && cd && cd->slots.find(func) != cd->slots.end() &&
+        cd->slots[func].find(x) != cd->slots[func].end())
+      ok = 0;
+    if (ok) {
+      OwnershipScan s = {};
+      s.backend = backend;
+      s.func = func;
+      s.name = x;
+      s.decl = ownership_find_decl(func->body, x);
+      s.site = n;
+      s.decl_depth = -1;
+      ok = s.decl && ownership_uses_ok(&s, func->body) &&
+           !(s.nested && s.reads);
+      if (ok) {
+        ASTNode_C *loops[16];
+        ownership_order_scan(&s, func->body, loops, 0);
+        ok = s.seen_site && !s.reject;
+      }
+    }
+    n->right->is_moved = ok ? 1 : 0;
+  }
+  for_each_child(n, [&](ASTNode_C *k) {
+    collect_ownership_moves(backend, func, k);
+    return true;
+  });
+}
+
+// TULPAR_AOT_VERBOSE line for the function just emitted; folds its counts
+// into the module total.
+static void report_arc_elision(LLVMBackend *backend, const char *fn) {
+  backend->arc_elided_total += backend->arc_elided_fn;
+  const char *v = getenv("TULPAR_AOT_VERBOSE");
+  if (backend->arc_elided_fn > 0 && v && *v && *v != '0')
+    printf("[AOT] ARC elision: %s: %d refcount op(s) removed, %d move(s).\n",
+           fn ? fn : "?", backend->arc_elided_fn, backend->arc_moves_fn);
+}
+
+// Whole-variable store into a global (the AUTO-PERSIST site): persist or
+// move, per the section comment.
+static LLVMValueRef emit_global_store_value(LLVMBackend *backend,
+                                            ASTNode_C *rhs, LLVMValueRef val) {
+  LLVMValueRef fn = backend->func_aot_persist;
+  if ((rhs && rhs->type == AST_IDENTIFIER && rhs->is_moved) ||
+      ownership_fresh_expr(backend, backend->current_function_node, rhs) >=
+          2) {
+    fn = backend->func_aot_persist_move;
+    backend->arc_moves_fn++;
+    backend->arc_elided_fn++;
+  }
+  LLVMValueRef pargs[] = {val};
+  return llvm_call_vmvalue_func(backend, fn, pargs, 1, "assign.autopersist");
+}
+
+// ============================================================
+// COPY-ON-WRITE WRITES
+// ============================================================
+//
+// aot_persist copies only arena-backed nodes; permanent substructure is
+// shared with the copy and carries ref_count > 1 (see aot_persist in
+// runtime_bindings.cpp). So `_snap = {"users": _users}` or rebuilding a
+// cache entry around its old item list no longer deep-copies the list —
+// and a write that reaches a shared node must copy it first, or the other
+// owner would see the change.
+//
+// Every write rooted at a variable — `push(_log, e)`, `pop(q)`,
+// `_users[i]["name"] = n`, `push(_cache[k]["items"], x)` — makes each node
+// on its path unique before mutating the last one: the variable's own value
+// through an inline ref_count check (aot_cow on the cold path, the copy is
+// stored back into the variable) and each intermediate element through
+// aot_cow_element, which takes the place of the vm_get_element read the
+// path would have done anyway. Unshared nodes cost one header load.
+//
+// A copy made for a local only helps if the local was not meant to update
+// a container: `json u = _users[i]; u["name"] = n` must still reach
+// _users[i]. So the points where a second name starts to alias a container
+// — a json local's initializer or assignment, a user-function argument, a
+// returned value — run the same path first when the source is a variable or
+// an element chain: the node is made unique where it lives, and the alias
+// shares that unique node. aot_alias then marks it so a later `_g = x` or
+// persist() copies it instead of sharing it; otherwise a snapshot taken
+// after `json u = _users[i]` would make u's next write copy-on-write and
+// miss _users[i]. Captured variables and typed locals are not tracked;
+// their writes keep plain reference semantics.
+
+// The boxed global `name` names (typed-int globals are native i64 and never
+// hold a container), or null.
+static LLVMValueRef cow_global_slot(LLVMBackend *backend, const char *name) {
+  if (!is_global_var(backend, name)) return nullptr;
+  LLVMValueRef g = LLVMGetNamedGlobal(backend->module, name);
+  return g && LLVMGlobalGetValueType(g) == backend->vm_value_type ? g : nullptr;
+}
+
+// Slot of variable `name` when it is a boxed global or a boxed local /
+// parameter alloca, else null.
+static LLVMValueRef cow_var_slot(LLVMBackend *backend, const char *name) {
+  if (!name) return nullptr;
+  if (LLVMValueRef g = cow_global_slot(backend, name)) return g;
+  LocalVar *var = get_local_var(backend, name);
+  if (!var || var->is_captured || !var->value) return nullptr;
+  if (typed_array_header_local(backend, name)) return nullptr;
+  if (!LLVMIsAAllocaInst(var->value) ||
+      LLVMGetAllocatedType(var->value) != backend->vm_value_type)
+    return nullptr;
+  return var->value;
+}
+
+// Slot of the variable an access chain `a[i][k]...` starts from.
+static LLVMValueRef cow_chain_root(LLVMBackend *backend, ASTNode_C *n) {
+  while (n && n->type == AST_ARRAY_ACCESS) {
+    if (!n->left) return cow_var_slot(backend, n->name);
+    n = n->left;
+  }
+  if (n && n->type == AST_IDENTIFIER) return cow_var_slot(backend, n->name);
+  return nullptr;
+}
+
+// Load variable slot `slot` for a write, copying its value first when
+// shared:  v = *slot; if (obj && v->ref_count > 1) { v = aot_cow(v); *slot = v; }
+static LLVMValueRef emit_cow_slot(LLVMBackend *backend, LLVMValueRef slot,
+                                  const char *name) {
+  LLVMBuilderRef b = backend->builder;
+  LLVMValueRef fn = backend->current_function;
+  LLVMValueRef v = LLVMBuildLoad2(b, backend->vm_value_type, slot, name);
+  LLVMValueRef is_obj = LLVMBuildICmp(
+      b, LLVMIntEQ, llvm_vm_tag(backend, v, "cow.tag"),
+      LLVMConstInt(backend->int32_type, 4, 0), "cow.isobj"); // VM_VAL_OBJ
+  LLVMBasicBlockRef load_bb = LLVMGetInsertBlock(b);
+  LLVMBasicBlockRef rc_bb = LLVMAppendBasicBlock(fn, "cow.rc");
+  LLVMBasicBlockRef copy_bb = LLVMAppendBasicBlock(fn, "cow.copy");
+  LLVMBasicBlockRef done_bb = LLVMAppendBasicBlock(fn, "cow.done");
+  LLVMBuildCondBr(b, is_obj, rc_bb, done_bb);
+
+  // Obj header: {u8 type, u8 arena_allocated, u8 is_shared, u8 is_moved,
+  // i32 ref_count}.
+  LLVMPositionBuilderAtEnd(b, rc_bb);
+  LLVMValueRef obj = llvm_extract_vm_val_ptr(backend, v);
+  LLVMValueRef rc_off = LLVMConstInt(backend->int_type, 4, 0);
+  LLVMValueRef rc_ptr =
+      LLVMBuildGEP2(b, LLVMInt8TypeInContext(backend->context), obj, &rc_off,
+                    1, "cow.rc.ptr");
+  LLVMValueRef rc = LLVMBuildLoad2(b, backend->int32_type, rc_ptr, "cow.rc");
+  LLVMValueRef shared =
+      LLVMBuildICmp(b, LLVMIntSGT, rc, LLVMConstInt(backend->int32_type, 1, 0),
+                    "cow.shared");
+  LLVMBuildCondBr(b, shared, copy_bb, done_bb);
+
+  LLVMPositionBuilderAtEnd(b, copy_bb);
+  LLVMValueRef args[] = {v};
+  LLVMValueRef copy =
+      llvm_call_vmvalue_func(backend, backend->func_aot_cow, args, 1, "cow.new");
+  LLVMBuildStore(b, copy, slot);
+  LLVMBasicBlockRef copy_end = LLVMGetInsertBlock(b);
+  LLVMBuildBr(b, done_bb);
+
+  LLVMPositionBuilderAtEnd(b, done_bb);
+  LLVMValueRef phi = LLVMBuildPhi(b, backend->vm_value_type, "cow.val");
+  LLVMValueRef vals[] = {v, v, copy};
+  LLVMBasicBlockRef blocks[] = {load_bb, rc_bb, copy_end};
+  LLVMAddIncoming(phi, vals, blocks, 3);
+  return phi;
+}
+
+// The container a push / pop / element assignment mutates, every node on
+// the path from its variable made unique first; anything not rooted at a
+// tracked variable is the plain read.
+static LLVMValueRef codegen_cow_target(LLVMBackend *backend, ASTNode_C *n) {
+  LLVMValueRef root = cow_chain_root(backend, n);
+  if (!root) return codegen_expression(backend, n);
+  if (n->type == AST_IDENTIFIER) return emit_cow_slot(backend, root, n->name);
+  LLVMValueRef parent = n->left ? codegen_cow_target(backend, n->left)
+                                : emit_cow_slot(backend, root, n->name);
+  LLVMValueRef args[] = {parent, codegen_expression(backend, n->index)};
+  return llvm_call_vmvalue_func(backend, backend->func_aot_cow_element, args,
+                                2, "cow.elem");
+}
+
+// A value about to get a second name (json local, argument, return): a
+// variable or element chain goes through codegen_cow_target so the alias
+// shares a node only it and its container reach, and stays the only copy
+// (aot_alias).
+static LLVMValueRef codegen_alias_source(LLVMBackend *backend, ASTNode_C *n) {
+  if (n && (n->type == AST_IDENTIFIER || n->type == AST_ARRAY_ACCESS) &&
+      cow_chain_root(backend, n)) {
+    LLVMValueRef args[] = {codegen_cow_target(backend, n)};
+    return llvm_call_vmvalue_func(backend, backend->func_aot_alias, args, 1,
+                                  "alias");
+  }
+  return codegen_expression(backend, n);
+}
+
+// Typed expression codegen - returns native values when possible
+TypedValue codegen_typed_expr(LLVMBackend *backend, ASTNode_C *node) {
+  TypedValue result = {nullptr, INFERRED_UNKNOWN, nullptr};
+
+  if (!node)
+    return result;
+
+  switch (node->type) {
+  case AST_INT_LITERAL:
+    result.value = LLVMConstInt(backend->int_type, node->value.int_value, 1);
+    result.type = INFERRED_INT;
+    return result;
+
+  case AST_FLOAT_LITERAL:
+    result.value = LLVMConstReal(backend->float_type, node->value.float_value);
+    result.type = INFERRED_FLOAT;
+    return result;
+
+  case AST_BOOL_LITERAL:
+    result.value = LLVMConstInt(backend->int_type, node->value.bool_value, 0);
+    result.type = INFERRED_BOOL;
+    return result;
+
+  case AST_IDENTIFIER: {
+    // Unboxed typed-array local used as a whole value: boxed snapshot.
+    if (LocalVar *ta = typed_array_local(backend, node->name)) {
+      result.boxed = typed_array_box(backend, ta);
+      result.value = result.boxed;
+      return result;
+    }
+
+    // Captured closure variable: read it out of the heap env array. The
+    // typed fast path below can't see it (get_local_native is null for
+    // captured vars and get_local's value pointer is null), so without
+    // this branch `n + x` inside a closure would read `n` as 0. Mirrors
+    // the captured-read branch in codegen_expression's AST_IDENTIFIER.
+    LocalVar *cap_var = get_local_var(backend, node->name);
+    if (cap_var && cap_var->is_captured == 1) {
+      LLVMValueRef env =
+          find_env_for_decl(backend, cap_var->declaring_function);
+      LLVMValueRef idx_val =
+          LLVMConstInt(backend->int32_type, cap_var->slot_index, 0);
+      LLVMValueRef get_args[] = {env, idx_val};
+      result.boxed = llvm_call_vmvalue_func(
+          backend, backend->func_vm_array_get, get_args, 2, node->name);
+      result.value = result.boxed;
+      result.type = INFERRED_UNKNOWN;
+      return result;
+    }
+
+    InferredType var_type = get_local_type(backend, node->name);
+    LLVMValueRef native = get_local_native(backend, node->name);
+
+    if (var_type != INFERRED_UNKNOWN && native) {
+      result.value = LLVMBuildLoad2(
+          backend->builder,
+          var_type == INFERRED_FLOAT ? backend->float_type : backend->int_type,
+          native, node->name);
+      result.type = var_type;
+    } else {
+      // Fall back to boxed
+      LLVMValueRef val_ptr = get_local(backend, node->name);
+      if (val_ptr) {
+        result.boxed = LLVMBuildLoad2(backend->builder, backend->vm_value_type,
+                                      val_ptr, node->name);
+        result.value = result.boxed;
+      }
+    }
+    return result;
+  }
+
+  case AST_ARRAY_ACCESS: {
+    // Unboxed typed-array element: native i64/double/bool straight out of
+    // the buffer, so `flags[i] == 0` compares without any VMValue.
+    LocalVar *ta = typed_array_local(backend, array_access_receiver(node));
+    if (ta && !(node->index && node->index->type == AST_STRING_LITERAL))
+      return typed_array_load(backend, ta, node->index);
+    // `pts[i].x` on an unboxed struct array.
+    StructTypeEntry *sa_st = nullptr;
+    int sa_field = -1;
+    if (LocalVar *sa =
+            struct_array_field_access(backend, node, &sa_st, &sa_field))
+      return struct_array_field_load(backend, sa, sa_st, node->left->index,
+                                     sa_field);
+    result.boxed = codegen_expression(backend, node);
+    result.value = result.boxed;
+    return result;
+  }
+
+  case AST_FUNCTION_CALL: {
+    // Untyped callee, int arguments: its clone (SPECIALISED CLONES).
+    if (spec_emit_call(backend, node, /*typed=*/1, &result.value)) {
+      result.type = INFERRED_INT;
+      return result;
+    }
+
+    // Look up the function
+    LLVMValueRef func = LLVMGetNamedFunction(backend->module, node->name);
+    if (func) {
+      LLVMTypeRef func_type = LLVMGlobalGetValueType(func);
+      LLVMTypeRef ret_type = LLVMGetReturnType(func_type);
+
+      // Check if it's a native function (returns i64 directly)
+      if (ret_type == backend->int_type) {
+        // Build arguments - convert to i64
+        int arg_count = node->argument_count;
+        LLVMValueRef *args = nullptr;
+        if (arg_count > 0) {
+          args = static_cast<LLVMValueRef*>(malloc(sizeof(LLVMValueRef) * arg_count));
+          for (int i = 0; i < arg_count; i++) {
+            TypedValue arg = codegen_typed_expr(backend, node->arguments[i]);
+            if (arg.type == INFERRED_INT || arg.type == INFERRED_BOOL) {
+              args[i] = arg.value;
+            } else if (arg.boxed) {
+              // Extract int from boxed value
+              args[i] = llvm_vm_int_payload(backend, arg.boxed, "arg_int");
+            } else {
+              args[i] = arg.value;
+            }
+          }
+        }
+
+        result.value = LLVMBuildCall2(backend->builder, func_type, func, args,
+                                      arg_count, "call_native");
+        result.type = INFERRED_INT;
+        if (args)
+          free(args);
+        return result;
+      }
+    }
+
+    // Fall back to boxed codegen
+    result.boxed = codegen_expression(backend, node);
+    result.value = result.boxed;
+    return result;
+  }
+
+  case AST_BINARY_OP: {
+    TypedValue L = codegen_typed_expr(backend, node->left);
+    TypedValue R = codegen_typed_expr(backend, node->right);
+
+    // Fast path: both are known integers
+    if (L.type == INFERRED_INT && R.type == INFERRED_INT) {
+      switch (node->op) {
+      case TOKEN_PLUS:
+        result.value =
+            llvm_build_int_arith(backend, TOKEN_PLUS, L.value, R.value, "add");
+        result.type = INFERRED_INT;
         return result;
       case TOKEN_MINUS:
-        result.value = LLVMBuildSub(backend->builder, L.value, R.value, "sub");
+        result.value =
+            llvm_build_int_arith(backend, TOKEN_MINUS, L.value, R.value, "sub");
         result.type = INFERRED_INT;
         return result;
       case TOKEN_MULTIPLY:
-        result.value = LLVMBuildMul(backend->builder, L.value, R.value, "mul");
+        result.value = llvm_build_int_arith(backend, TOKEN_MULTIPLY, L.value,
+                                            R.value, "mul");
         result.type = INFERRED_INT;
         return result;
       case TOKEN_DIVIDE:
@@ -3114,26 +6175,7 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
         backend->func_vm_allocate_array, alloc_args, 1, "alloc_arr");
 
     // 2. Loop elements and push: vm_array_push_wrapper(vm, arr, val)
-    if (node->elements) {
-      for (int i = 0; i < node->element_count; i++) {
-        ASTNode_C *el = node->elements[i];
-        // A native (int/bool) struct element is boxed as a string-keyed
-        // object here too — otherwise `[a][0].x` reinterprets the aggregate's
-        // bytes as a VMValue. Mirrors the push() escape path.
-        LLVMValueRef val = codegen_struct_expr_as_object(backend, el);
-        if (!val) val = codegen_expression(backend, el);
-        LLVMValueRef val_ptr = LLVMBuildAlloca(
-            backend->builder, backend->vm_value_type, "arr_lit_val_ptr");
-        LLVMBuildStore(backend->builder, val, val_ptr);
-        LLVMValueRef val_void = LLVMBuildBitCast(
-            backend->builder, val_ptr, backend->ptr_type, "arr_lit_val_void");
-        LLVMValueRef push_args[] = {LLVMConstNull(backend->ptr_type), arr_obj,
-                                    val_void};
-        LLVMBuildCall2(backend->builder,
-                       LLVMGlobalGetValueType(backend->func_vm_array_push),
-                       backend->func_vm_array_push, push_args, 3, "");
-      }
-    }
+    emit_array_literal_items(backend, node, arr_obj);
     return llvm_build_vm_val_obj(backend, arr_obj);
   }
 
@@ -3146,34 +6188,26 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
                        backend->func_vm_allocate_object, args, 1, "alloc_obj");
 
     // 2. Iterate keys/values and Set
-    for (int i = 0; i < node->object_count; i++) {
-      char *key_str = node->object_keys[i];
-      LLVMValueRef key_global =
-          LLVMBuildGlobalStringPtr(backend->builder, key_str, "key_str");
-
-      LLVMValueRef val = codegen_expression(backend, node->object_values[i]);
-
-      LLVMValueRef val_ptr = llvm_build_alloca_at_entry(
-          backend, backend->vm_value_type, "obj_lit_val_ptr");
-      LLVMBuildStore(backend->builder, val, val_ptr);
-      LLVMValueRef val_void = LLVMBuildBitCast(
-          backend->builder, val_ptr, backend->ptr_type, "obj_lit_val_void");
-
-      LLVMValueRef set_args[] = {
-          LLVMConstPointerNull(backend->ptr_type), // VM*
-          obj_ptr,                                 // ObjObject*
-          key_global,                              // char* key
-          val_void                                 // VMValue* value
-      };
-      LLVMBuildCall2(backend->builder,
-                     LLVMGlobalGetValueType(backend->func_vm_object_set),
-                     backend->func_vm_object_set, set_args, 4, "");
-    }
-
+    emit_object_literal_entries(backend, node, obj_ptr);
     return llvm_build_vm_val_obj(backend, obj_ptr);
   }
 
   case AST_ARRAY_ACCESS: {
+    // Unboxed typed-array local (arrayInt & co.): inline checked load, boxed
+    // only for the surrounding dynamic expression.
+    if (LocalVar *ta = typed_array_local(backend, array_access_receiver(node)))
+      return box_typed_value(backend,
+                             typed_array_load(backend, ta, node->index));
+    {
+      StructTypeEntry *sa_st = nullptr;
+      int sa_field = -1;
+      if (LocalVar *sa =
+              struct_array_field_access(backend, node, &sa_st, &sa_field))
+        return box_typed_value(
+            backend, struct_array_field_load(backend, sa, sa_st,
+                                             node->left->index, sa_field));
+    }
+
     // Typed-struct fast path: when the receiver is a bare identifier
     // backed by a typed-struct local AND the index is a literal string
     // matching one of the struct's field names, lower this access to
@@ -3382,13 +6416,16 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
       LLVMValueRef new_int = nullptr;
       switch (node->op) {
       case TOKEN_PLUS_EQUAL:
-        new_int = LLVMBuildAdd(backend->builder, old_int, rhs_int, "addeq");
+        new_int =
+            llvm_build_int_arith(backend, TOKEN_PLUS, old_int, rhs_int, "addeq");
         break;
       case TOKEN_MINUS_EQUAL:
-        new_int = LLVMBuildSub(backend->builder, old_int, rhs_int, "subeq");
+        new_int = llvm_build_int_arith(backend, TOKEN_MINUS, old_int, rhs_int,
+                                       "subeq");
         break;
       case TOKEN_MULTIPLY_EQUAL:
-        new_int = LLVMBuildMul(backend->builder, old_int, rhs_int, "muleq");
+        new_int = llvm_build_int_arith(backend, TOKEN_MULTIPLY, old_int,
+                                       rhs_int, "muleq");
         break;
       case TOKEN_DIVIDE_EQUAL:
         new_int = LLVMBuildSDiv(backend->builder, old_int, rhs_int, "diveq");
@@ -3401,6 +6438,14 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
       return llvm_vm_val_int_val(backend, new_int);
     }
 
+    // `s += x` on a string-builder local: append in place.
+    if (node->op == TOKEN_PLUS_EQUAL) {
+      if (LocalVar *sbv = str_builder_local(backend, node->name)) {
+        ASTNode_C *parts[] = {node->right};
+        return emit_str_builder_append(backend, sbv, parts, 1);
+      }
+    }
+
     LLVMValueRef val_ptr = get_local(backend, node->name);
     if (!val_ptr) {
       char msg[256];
@@ -3486,6 +6531,11 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
           backend, backend->func_vm_array_get, get_args, 2, node->name);
     }
 
+    // Unboxed typed-array local at a dynamic boundary (print / toJson /
+    // return / for-in): hand out a boxed snapshot.
+    if (LocalVar *ta = typed_array_local(backend, node->name))
+      return typed_array_box(backend, ta);
+
     // Native typed-int local/global: load i64 and box back to VMValue.
     InferredType vt = get_local_type(backend, node->name);
     LLVMValueRef native = get_local_native(backend, node->name);
@@ -3557,9 +6607,9 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
 
     // Extract types for fast path checking
     LLVMValueRef l_type =
-        LLVMBuildExtractValue(backend->builder, L, 0, "l_type");
+        llvm_vm_tag(backend, L, "l_type");
     LLVMValueRef r_type =
-        LLVMBuildExtractValue(backend->builder, R, 0, "r_type");
+        llvm_vm_tag(backend, R, "r_type");
 
     // Check if both are INT (type == 1)
     LLVMValueRef l_is_int =
@@ -3600,20 +6650,21 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
     // --- Integer Block ---
     // VMValue struct: {i32 type, pad, i64 as}
     LLVMPositionBuilderAtEnd(backend->builder, int_block);
-    LLVMValueRef l_val = LLVMBuildExtractValue(backend->builder, L, 2, "l_val");
-    LLVMValueRef r_val = LLVMBuildExtractValue(backend->builder, R, 2, "r_val");
+    LLVMValueRef l_val = llvm_vm_payload(backend, L, "l_val");
+    LLVMValueRef r_val = llvm_vm_payload(backend, R, "r_val");
     LLVMValueRef int_res = nullptr;
     int is_bool_res = 0;
 
     switch (node->op) {
     case TOKEN_PLUS:
-      int_res = LLVMBuildAdd(backend->builder, l_val, r_val, "add");
+      int_res = llvm_build_int_arith(backend, TOKEN_PLUS, l_val, r_val, "add");
       break;
     case TOKEN_MINUS:
-      int_res = LLVMBuildSub(backend->builder, l_val, r_val, "sub");
+      int_res = llvm_build_int_arith(backend, TOKEN_MINUS, l_val, r_val, "sub");
       break;
     case TOKEN_MULTIPLY:
-      int_res = LLVMBuildMul(backend->builder, l_val, r_val, "mul");
+      int_res =
+          llvm_build_int_arith(backend, TOKEN_MULTIPLY, l_val, r_val, "mul");
       break;
     case TOKEN_DIVIDE:
       int_res = LLVMBuildSDiv(backend->builder, l_val, r_val, "div");
@@ -3704,11 +6755,9 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
         // but llvm_vm_val_int_val handles runtime values for INT, need one for
         // BOOL?
 
-        LLVMValueRef s = LLVMGetUndef(backend->vm_value_type);
-        s = LLVMBuildInsertValue(backend->builder, s,
-                                 LLVMConstInt(backend->int32_type, 2, 0), 0,
-                                 "");  // VM_VAL_BOOL = 2
-        s = LLVMBuildInsertValue(backend->builder, s, int_res, 2, "");
+        LLVMValueRef s = llvm_vm_make(
+            backend, LLVMConstInt(backend->int32_type, 2, 0), int_res,
+            "");  // VM_VAL_BOOL = 2
         int_vm_res = s;
       } else {
         // Result is INT (type 1)
@@ -3724,9 +6773,9 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
     // --- Float Block (Fast Path for float operations) ---
     LLVMPositionBuilderAtEnd(backend->builder, float_block);
     LLVMValueRef l_float_bits =
-        LLVMBuildExtractValue(backend->builder, L, 2, "l_float_bits");
+        llvm_vm_payload(backend, L, "l_float_bits");
     LLVMValueRef r_float_bits =
-        LLVMBuildExtractValue(backend->builder, R, 2, "r_float_bits");
+        llvm_vm_payload(backend, R, "r_float_bits");
     // Reinterpret i64 bits as double
     LLVMValueRef l_float = LLVMBuildBitCast(backend->builder, l_float_bits,
                                             LLVMDoubleType(), "l_double");
@@ -3789,21 +6838,17 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
         // Result is BOOL (type 3)
         LLVMValueRef bool_ext = LLVMBuildZExt(backend->builder, float_res,
                                               backend->int_type, "bool_zext");
-        LLVMValueRef s = LLVMGetUndef(backend->vm_value_type);
-        s = LLVMBuildInsertValue(backend->builder, s,
-                                 LLVMConstInt(backend->int32_type, 2, 0), 0,
-                                 "");  // VM_VAL_BOOL = 2
-        s = LLVMBuildInsertValue(backend->builder, s, bool_ext, 2, "");
+        LLVMValueRef s = llvm_vm_make(
+            backend, LLVMConstInt(backend->int32_type, 2, 0), bool_ext,
+            "");  // VM_VAL_BOOL = 2
         float_vm_res = s;
       } else {
         // Result is FLOAT (type 2) - convert double back to i64 bits
         LLVMValueRef res_bits = LLVMBuildBitCast(backend->builder, float_res,
                                                  backend->int_type, "res_bits");
-        LLVMValueRef s = LLVMGetUndef(backend->vm_value_type);
-        s = LLVMBuildInsertValue(backend->builder, s,
-                                 LLVMConstInt(backend->int32_type, 1, 0), 0,
-                                 "");  // VM_VAL_FLOAT = 1
-        s = LLVMBuildInsertValue(backend->builder, s, res_bits, 2, "");
+        LLVMValueRef s = llvm_vm_make(
+            backend, LLVMConstInt(backend->int32_type, 1, 0), res_bits,
+            "");  // VM_VAL_FLOAT = 1
         float_vm_res = s;
       }
       LLVMBuildBr(backend->builder, merge_block);
@@ -3947,18 +6992,16 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
            node->op == TOKEN_LESS_EQUAL || node->op == TOKEN_GREATER_EQUAL ||
            node->op == TOKEN_AND || node->op == TOKEN_OR);
       if (fb_op_is_bool) {
-        LLVMValueRef fb_payload = LLVMBuildExtractValue(
-            backend->builder, fallback_res, 2, "fb_payload");
+        LLVMValueRef fb_payload =
+            llvm_vm_payload(backend, fallback_res, "fb_payload");
         LLVMValueRef fb_bool =
             LLVMBuildICmp(backend->builder, LLVMIntNE, fb_payload,
                           LLVMConstInt(backend->int_type, 0, 0), "fb_bool");
         LLVMValueRef fb_zext = LLVMBuildZExt(backend->builder, fb_bool,
                                              backend->int_type, "fb_bool_zext");
-        LLVMValueRef fb_s = LLVMGetUndef(backend->vm_value_type);
-        fb_s = LLVMBuildInsertValue(backend->builder, fb_s,
-                                    LLVMConstInt(backend->int32_type, 2, 0), 0,
-                                    "");  // VM_VAL_BOOL = 2
-        fb_s = LLVMBuildInsertValue(backend->builder, fb_s, fb_zext, 2, "");
+        LLVMValueRef fb_s = llvm_vm_make(
+            backend, LLVMConstInt(backend->int32_type, 2, 0), fb_zext,
+            "");  // VM_VAL_BOOL = 2
         fallback_res = fb_s;
       }
     }
@@ -4026,7 +7069,7 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
     // Unary minus for int/float
     if (node->op == TOKEN_MINUS) {
       LLVMValueRef type_val =
-          LLVMBuildExtractValue(backend->builder, operand, 0, "unary_type");
+          llvm_vm_tag(backend, operand, "unary_type");
       LLVMValueRef is_int = LLVMBuildICmp(
           backend->builder, LLVMIntEQ, type_val,
           LLVMConstInt(backend->int32_type, 0, 0), "unary_is_int");  // VM_VAL_INT = 0
@@ -4062,8 +7105,8 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
       // Payload is field 2 (the i64); field 1 is the [4 x i8] alignment pad —
       // extracting that and bitcasting 4 bytes to an 8-byte double is the
       // "Invalid bitcast" crash this path used to hit on `-<boxed float>`.
-      LLVMValueRef float_bits = LLVMBuildExtractValue(backend->builder, operand,
-                                                      2, "unary_float_bits");
+      LLVMValueRef float_bits =
+          llvm_vm_payload(backend, operand, "unary_float_bits");
       LLVMValueRef float_val = LLVMBuildBitCast(
           backend->builder, float_bits, backend->float_type, "unary_float");
       LLVMValueRef neg_float =
@@ -4355,6 +7398,8 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
     // toJson(value) -> String
     if (node->name && strcmp(node->name, "toJson") == 0 &&
         node->argument_count >= 1) {
+      if (LLVMValueRef js = codegen_struct_to_json(backend, node->arguments[0]))
+        return js;
       LLVMValueRef arg = codegen_expression(backend, node->arguments[0]);
       LLVMValueRef arg_ptr = llvm_build_alloca_at_entry(
           backend, backend->vm_value_type, "to_json_arg");
@@ -4381,6 +7426,36 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
       return llvm_build_vm_val_float(backend, result);
     }
 
+    // Unboxed typed-array / struct-array local: len/length read the
+    // header's count, push appends inline (tulpar_array_grow only when the
+    // buffer is full).
+    if (node->name && node->argument_count >= 1 &&
+        node->arguments[0] && node->arguments[0]->type == AST_IDENTIFIER) {
+      LocalVar *ta =
+          typed_array_header_local(backend, node->arguments[0]->name);
+      if (ta && (strcmp(node->name, "len") == 0 ||
+                 strcmp(node->name, "length") == 0)) {
+        LLVMValueRef count = LLVMBuildLoad2(
+            backend->builder, backend->int32_type,
+            typed_array_field(backend, ta, 1, "ta.count.ptr"), "ta.count");
+        return llvm_vm_val_int_val(
+            backend, LLVMBuildSExt(backend->builder, count, backend->int_type,
+                                   "len_result"));
+      }
+      StructTypeEntry *sa_st = nullptr;
+      if (ta && strcmp(node->name, "push") == 0 && node->argument_count == 2 &&
+          struct_array_local(backend, node->arguments[0]->name, &sa_st)) {
+        struct_array_push(backend, ta, sa_st, node->arguments[1]);
+        return llvm_vm_val_int(backend, 0);
+      }
+      if (ta && strcmp(node->name, "push") == 0 && node->argument_count == 2) {
+        TypedValue tv = codegen_typed_expr(backend, node->arguments[1]);
+        typed_array_push_elem(backend, ta,
+                              typed_array_coerce(backend, ta->typed_array, tv));
+        return llvm_vm_val_int(backend, 0);
+      }
+    }
+
     // len(value) -> int
     if (node->name && strcmp(node->name, "len") == 0 &&
         node->argument_count >= 1) {
@@ -4430,7 +7505,7 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
       // dynamic key lookup — resolves afterwards. nullptr = not a struct
       // expression → fall through to the plain codegen below.
       LLVMValueRef val = codegen_struct_expr_as_object(backend, val_arg);
-      LLVMValueRef arr = codegen_expression(backend, node->arguments[0]);
+      LLVMValueRef arr = codegen_cow_target(backend, node->arguments[0]);
       if (!val) {
         val = codegen_expression(backend, val_arg);
       }
@@ -4461,7 +7536,7 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
     // pop(array) -> value
     if (node->name && strcmp(node->name, "pop") == 0 &&
         node->argument_count >= 1) {
-      LLVMValueRef arr = codegen_expression(backend, node->arguments[0]);
+      LLVMValueRef arr = codegen_cow_target(backend, node->arguments[0]);
       if (!arr) return llvm_vm_val_int(backend, 0);
       LLVMValueRef args[] = {arr};
       return llvm_call_vmvalue_func(backend, backend->func_aot_array_pop, args, 1, "pop_result");
@@ -4624,6 +7699,18 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
       return llvm_call_vmvalue_func(backend, backend->func_aot_arena_drop,
                                     args, 1, "arena_drop_res");
     }
+    if (node->name && strcmp(node->name, "arc_stats") == 0) {
+      return llvm_call_vmvalue_func(backend, backend->func_aot_arc_stats,
+                                    nullptr, 0, "arc_stats");
+    }
+    if (node->name && strcmp(node->name, "arc_drain") == 0) {
+      return llvm_call_vmvalue_func(backend, backend->func_aot_arc_drain,
+                                    nullptr, 0, "arc_drain");
+    }
+    if (node->name && strcmp(node->name, "arena_stats") == 0) {
+      return llvm_call_vmvalue_func(backend, backend->func_aot_arena_stats,
+                                    nullptr, 0, "arena_stats");
+    }
     if (node->name && strcmp(node->name, "input") == 0) {
       if (!backend->func_aot_input)
         fprintf(stderr, "Fatal: func_aot_input is nullptr\n");
@@ -4907,6 +7994,16 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
       LLVMValueRef args[] = {arg_void};
       return llvm_call_vmvalue_func(backend, backend->func_aot_file_exists, args, 1, "exists_res");
     }
+    if (strcmp(node->name, "file_delete") == 0) {
+      LLVMValueRef arg = codegen_expression(backend, node->arguments[0]);
+      LLVMValueRef arg_ptr = llvm_build_alloca_at_entry(
+          backend, backend->vm_value_type, "delete_arg_ptr");
+      LLVMBuildStore(backend->builder, arg, arg_ptr);
+      LLVMValueRef arg_void = LLVMBuildBitCast(
+          backend->builder, arg_ptr, backend->ptr_type, "delete_arg_void");
+      LLVMValueRef args[] = {arg_void};
+      return llvm_call_vmvalue_func(backend, backend->func_aot_file_delete, args, 1, "delete_res");
+    }
     if (strcmp(node->name, "sha256") == 0) {
       LLVMValueRef arg = codegen_expression(backend, node->arguments[0]);
       LLVMValueRef arg_ptr = llvm_build_alloca_at_entry(
@@ -5067,6 +8164,88 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
       return llvm_call_vmvalue_func(backend, backend->func_aot_db_query, args, 2, "db_query_res");
     }
 
+    // db_cursor(db, sql[, params]) / db_query_columns(db, sql[, params]);
+    // a missing params array binds nothing.
+    bool db_cursor_call = strcmp(node->name, "db_cursor") == 0;
+    if ((db_cursor_call || strcmp(node->name, "db_query_columns") == 0) &&
+        node->argument_count >= 2) {
+      bool cursor = db_cursor_call;
+      LLVMValueRef args[] = {
+          codegen_expression(backend, node->arguments[0]),
+          codegen_expression(backend, node->arguments[1]),
+          node->argument_count >= 3
+              ? codegen_expression(backend, node->arguments[2])
+              : llvm_vm_val_int(backend, 0)};
+      return llvm_call_vmvalue_func(
+          backend,
+          cursor ? backend->func_aot_db_cursor
+                 : backend->func_aot_db_query_columns,
+          args, 3, cursor ? "db_cursor" : "db_columns");
+    }
+
+    if (strcmp(node->name, "db_next") == 0 && node->argument_count >= 1) {
+      LLVMValueRef args[] = {codegen_expression(backend, node->arguments[0])};
+      return llvm_call_vmvalue_func(backend, backend->func_aot_db_next, args,
+                                    1, "db_row");
+    }
+
+    if (strcmp(node->name, "db_close_cursor") == 0 &&
+        node->argument_count >= 1) {
+      LLVMValueRef args[] = {codegen_expression(backend, node->arguments[0])};
+      LLVMBuildCall2(backend->builder,
+                     LLVMGlobalGetValueType(backend->func_aot_db_close_cursor),
+                     backend->func_aot_db_close_cursor, args, 1, "");
+      return llvm_vm_val_int(backend, 0);
+    }
+
+    // db_prepare(db, sql) -> stmt handle
+    if (strcmp(node->name, "db_prepare") == 0 && node->argument_count >= 2) {
+      LLVMValueRef args[] = {codegen_expression(backend, node->arguments[0]),
+                             codegen_expression(backend, node->arguments[1])};
+      return llvm_call_vmvalue_func(backend, backend->func_aot_db_prepare,
+                                    args, 2, "db_stmt");
+    }
+
+    // db_stmt_query(stmt[, params]) / db_stmt_execute(stmt[, params])
+    bool db_stmt_query_call = strcmp(node->name, "db_stmt_query") == 0;
+    if ((db_stmt_query_call || strcmp(node->name, "db_stmt_execute") == 0) &&
+        node->argument_count >= 1) {
+      LLVMValueRef args[] = {
+          codegen_expression(backend, node->arguments[0]),
+          node->argument_count >= 2
+              ? codegen_expression(backend, node->arguments[1])
+              : llvm_vm_val_int(backend, 0)};
+      return llvm_call_vmvalue_func(
+          backend,
+          db_stmt_query_call ? backend->func_aot_db_stmt_query
+                             : backend->func_aot_db_stmt_execute,
+          args, 2, db_stmt_query_call ? "db_stmt_rows" : "db_stmt_ok");
+    }
+
+    // db_executemany(db, sql, rows) -> bool
+    if (strcmp(node->name, "db_executemany") == 0 &&
+        node->argument_count >= 3) {
+      LLVMValueRef args[] = {codegen_expression(backend, node->arguments[0]),
+                             codegen_expression(backend, node->arguments[1]),
+                             codegen_expression(backend, node->arguments[2])};
+      return llvm_call_vmvalue_func(backend, backend->func_aot_db_executemany,
+                                    args, 3, "db_many_ok");
+    }
+
+    // db_group_commit(db, on) -> bool
+    if (strcmp(node->name, "db_group_commit") == 0 &&
+        node->argument_count >= 2) {
+      LLVMValueRef args[] = {codegen_expression(backend, node->arguments[0]),
+                             codegen_expression(backend, node->arguments[1])};
+      return llvm_call_vmvalue_func(backend, backend->func_aot_db_group_commit,
+                                    args, 2, "db_gc_ok");
+    }
+
+    if (strcmp(node->name, "db_stats") == 0) {
+      return llvm_call_vmvalue_func(backend, backend->func_aot_db_stats, nullptr,
+                                    0, "db_stats");
+    }
+
     // Socket Functions
     if (strcmp(node->name, "socket_server") == 0) {
       LLVMValueRef args[] = {codegen_expression(backend, node->arguments[0]),
@@ -5313,6 +8492,17 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
                                     args, 3, "wings_build_resp");
     }
 
+    // wings_encode_model(schema, result) -> JSON body of a response_model()
+    // route: declared fields only, key fragments escaped once per schema.
+    if (strcmp(node->name, "wings_encode_model") == 0 &&
+        node->argument_count >= 2) {
+      LLVMValueRef args[] = {codegen_expression(backend, node->arguments[0]),
+                             codegen_expression(backend, node->arguments[1])};
+      return llvm_call_vmvalue_func(backend,
+                                    backend->func_aot_wings_encode_model,
+                                    args, 2, "wings_encode_model");
+    }
+
     // wings_find_route(routes, method, path) -> {"index", "params"}
     // Native replacement for the Tulpar `_find_route_with_params`
     // serve-path lookup. Saves N json[get]s per route iteration on
@@ -5648,7 +8838,7 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
     if (strcmp(node->name, "sleep_async") == 0 && node->argument_count >= 1) {
       LLVMValueRef arg = codegen_expression(backend, node->arguments[0]);
       LLVMValueRef ms_i64 =
-          LLVMBuildExtractValue(backend->builder, arg, 2, "sleep_async_ms");
+          llvm_vm_int_payload(backend, arg, "sleep_async_ms");
       LLVMValueRef args[] = {ms_i64};
       LLVMValueRef pr = LLVMBuildCall2(
           backend->builder,
@@ -5719,10 +8909,23 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
 
     // ====== Range Function ======
     // range(end) -> array [0, 1, ..., end-1]
-    if (strcmp(node->name, "range") == 0 && node->argument_count >= 1) {
+    // range(start, end[, step]) -> array [start, start+step, ...)
+    // Only an escaping range lands here; `for (x in range(...))` is a counted
+    // loop (lower_range_for_in) and never builds the array.
+    if (strcmp(node->name, "range") == 0 && node->argument_count == 1) {
       LLVMValueRef args[] = {codegen_expression(backend, node->arguments[0])};
       return llvm_call_vmvalue_func(backend, backend->func_aot_range, args, 1, "range_res");
     }
+    if (strcmp(node->name, "range") == 0 && node->argument_count >= 2) {
+      LLVMValueRef args[3];
+      args[0] = codegen_expression(backend, node->arguments[0]);
+      args[1] = codegen_expression(backend, node->arguments[1]);
+      args[2] = node->argument_count >= 3
+                    ? codegen_expression(backend, node->arguments[2])
+                    : llvm_vm_val_int(backend, 1);
+      return llvm_call_vmvalue_func(backend, backend->func_aot_range_step,
+                                    args, 3, "range_res");
+    }
 
     // ====== SQLite Database Functions ======
     // db_open(path) -> db_handle
@@ -5979,6 +9182,14 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
       }
     }
 
+    // Untyped callee whose arguments are all provably int here: call its
+    // unboxed clone instead of t_<name> (SPECIALISED CLONES).
+    {
+      LLVMValueRef spec_res;
+      if (spec_emit_call(backend, node, /*typed=*/0, &spec_res))
+        return llvm_vm_val_int_val(backend, spec_res);
+    }
+
     // User-defined or Runtime function call
     // NB: a user `func main` is mangled to `t_main` like any other function,
     // so it never collides with the synthesized C `int main()` entrypoint.
@@ -6015,7 +9226,7 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
                   codegen_expression(backend, node->arguments[i]);
               // Extract i64 from VMValue
               args[i] =
-                  LLVMBuildExtractValue(backend->builder, val, 2, "arg_i64");
+                  llvm_vm_int_payload(backend, val, "arg_i64");
             }
           }
 
@@ -6159,8 +9370,8 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
                   int idx = struct_type_field_index(st, arg->object_keys[k]);
                   LLVMValueRef vbox =
                       codegen_expression(backend, arg->object_values[k]);
-                  LLVMValueRef i64v = LLVMBuildExtractValue(
-                      backend->builder, vbox, 2, "arg.lit.i64");
+                  LLVMValueRef i64v =
+                      llvm_vm_int_payload(backend, vbox, "arg.lit.i64");
                   LLVMValueRef fp = LLVMBuildStructGEP2(
                       backend->builder, st->llvm_type, tmp,
                       (unsigned)idx, "arg.lit.field.ptr");
@@ -6234,8 +9445,9 @@ LLVMValueRef codegen_expression(LLVMBackend *backend, ASTNode_C *node) {
             // the existing path keeps the rest of the program compilable
             // and lets typeinfer surface the user-visible diagnostic.
           }
-          // Evaluate argument
-          LLVMValueRef val = codegen_expression(backend, node->arguments[i]);
+          // Evaluate argument (the parameter aliases it: COPY-ON-WRITE
+          // WRITES)
+          LLVMValueRef val = codegen_alias_source(backend, node->arguments[i]);
           // Store to temp alloca to get pointer (entry-hoisted)
           LLVMValueRef arg_temp = llvm_build_alloca_at_entry(
               backend, backend->vm_value_type, "arg_tmp");
@@ -6873,16 +10085,211 @@ static void set_debug_loc_for_node(LLVMBackend *backend, ASTNode_C *node) {
   LLVMSetCurrentDebugLocation2(backend->builder, loc);
 }
 
-// Emit `count` aot_try_pop() calls. Used by return/break/continue when they
-// transfer control out of one or more enclosing `try` scopes: the setjmp
-// frames those scopes pushed must come off the runtime handler stack, or a
-// later throw longjmps into a stack frame that no longer exists.
-static void emit_try_pops(LLVMBackend *backend, int count) {
-  for (int i = 0; i < count; i++) {
-    LLVMBuildCall2(backend->builder,
-                   LLVMGlobalGetValueType(backend->func_aot_try_pop),
-                   backend->func_aot_try_pop, nullptr, 0, "");
+// Emit `count` aot_try_pop() calls. Used by return/break/continue when they
+// transfer control out of one or more enclosing `try` scopes: the setjmp
+// frames those scopes pushed must come off the runtime handler stack, or a
+// later throw longjmps into a stack frame that no longer exists.
+static void emit_try_pops(LLVMBackend *backend, int count) {
+  for (int i = 0; i < count; i++) {
+    LLVMBuildCall2(backend->builder,
+                   LLVMGlobalGetValueType(backend->func_aot_try_pop),
+                   backend->func_aot_try_pop, nullptr, 0, "");
+  }
+}
+
+// ---- Zero-cost try/catch (eh_unwind) --------------------------------------
+// The try body is generated with ordinary calls, then every call in the
+// blocks it produced is rewritten to an `invoke` that unwinds to the try's
+// landing pad. Rewriting after the fact keeps the hundreds of LLVMBuildCall2
+// sites in codegen unaware of EH. A nested try has already rewritten its own
+// body to its own pad, so the only calls left for the outer pass are the
+// ones in the nested catch/finally — exactly the code a throw from which
+// must reach the outer handler.
+
+// Intrinsics and inline asm can't be invoked; aot_eh_catch runs inside the
+// landing pad itself and never throws.
+static bool eh_call_may_unwind(LLVMBackend *backend, LLVMValueRef call) {
+  LLVMValueRef callee = LLVMGetCalledValue(call);
+  if (LLVMIsAInlineAsm(callee)) return false;
+  if (LLVMIsAFunction(callee)) {
+    if (LLVMGetIntrinsicID(callee) != 0) return false;
+    if (callee == backend->func_aot_eh_catch) return false;
+  }
+  return true;
+}
+
+// `from`'s terminator moved into `to`, but PHIs in the successors still name
+// `from` as the incoming block. The C API can't retarget one incoming edge,
+// so rebuild each affected PHI.
+static void eh_retarget_phis(LLVMBackend *backend, LLVMBasicBlockRef from,
+                             LLVMBasicBlockRef to) {
+  LLVMValueRef term = LLVMGetBasicBlockTerminator(to);
+  if (!term) return;
+  LLVMBuilderRef b = LLVMCreateBuilderInContext(backend->context);
+  unsigned nsucc = LLVMGetNumSuccessors(term);
+  for (unsigned s = 0; s < nsucc; s++) {
+    LLVMBasicBlockRef succ = LLVMGetSuccessor(term, s);
+    LLVMValueRef phi = LLVMGetFirstInstruction(succ);
+    while (phi && LLVMIsAPHINode(phi)) {
+      LLVMValueRef next = LLVMGetNextInstruction(phi);
+      unsigned n = LLVMCountIncoming(phi);
+      bool hit = false;
+      for (unsigned i = 0; i < n && !hit; i++)
+        hit = LLVMGetIncomingBlock(phi, i) == from;
+      if (hit) {
+        LLVMPositionBuilderBefore(b, phi);
+        LLVMValueRef np = LLVMBuildPhi(b, LLVMTypeOf(phi), "");
+        for (unsigned i = 0; i < n; i++) {
+          LLVMValueRef v = LLVMGetIncomingValue(phi, i);
+          LLVMBasicBlockRef ib = LLVMGetIncomingBlock(phi, i);
+          if (ib == from) ib = to;
+          LLVMAddIncoming(np, &v, &ib, 1);
+        }
+        LLVMReplaceAllUsesWith(phi, np);
+        LLVMInstructionEraseFromParent(phi);
+      }
+      phi = next;
+    }
+  }
+  LLVMDisposeBuilder(b);
+}
+
+// Rewrite `call` as `invoke ... to label %cont unwind label %lpad`. The
+// instructions after the call move into the new `cont` block, placed right
+// after the call's block so a forward walk visits it next.
+static void eh_call_to_invoke(LLVMBackend *backend, LLVMValueRef call,
+                              LLVMBasicBlockRef lpad) {
+  LLVMBasicBlockRef bb = LLVMGetInstructionParent(call);
+  LLVMBasicBlockRef after = LLVMGetNextBasicBlock(bb);
+  LLVMBasicBlockRef cont =
+      after ? LLVMInsertBasicBlockInContext(backend->context, after,
+                                            "invoke.cont")
+            : LLVMAppendBasicBlockInContext(
+                  backend->context, LLVMGetBasicBlockParent(bb), "invoke.cont");
+
+  LLVMBuilderRef b = LLVMCreateBuilderInContext(backend->context);
+  LLVMPositionBuilderAtEnd(b, cont);
+  for (LLVMValueRef inst = LLVMGetNextInstruction(call); inst;) {
+    LLVMValueRef next = LLVMGetNextInstruction(inst);
+    size_t len = 0;
+    std::string name = LLVMGetValueName2(inst, &len);
+    LLVMInstructionRemoveFromParent(inst);
+    LLVMInsertIntoBuilderWithName(b, inst, name.c_str());
+    inst = next;
+  }
+
+  LLVMPositionBuilderBefore(b, call);
+  unsigned nargs = LLVMGetNumArgOperands(call);
+  std::vector<LLVMValueRef> args(nargs);
+  for (unsigned i = 0; i < nargs; i++) args[i] = LLVMGetOperand(call, i);
+  size_t len = 0;
+  std::string name = LLVMGetValueName2(call, &len);
+  LLVMValueRef inv = LLVMBuildInvoke2(
+      b, LLVMGetCalledFunctionType(call), LLVMGetCalledValue(call),
+      args.data(), nargs, cont, lpad, name.c_str());
+  LLVMSetInstructionCallConv(inv, LLVMGetInstructionCallConv(call));
+  // Call-site attributes carry the VMValue ABI (sret/byval) — keep them all.
+  for (long idx = -1; idx <= (long)nargs; idx++) {
+    LLVMAttributeIndex ai = idx < 0
+                                ? (LLVMAttributeIndex)LLVMAttributeFunctionIndex
+                                : (LLVMAttributeIndex)idx;
+    unsigned na = LLVMGetCallSiteAttributeCount(call, ai);
+    if (na == 0) continue;
+    std::vector<LLVMAttributeRef> attrs(na);
+    LLVMGetCallSiteAttributes(call, ai, attrs.data());
+    for (LLVMAttributeRef a : attrs) LLVMAddCallSiteAttribute(inv, ai, a);
+  }
+  LLVMInstructionSetDebugLoc(inv, LLVMInstructionGetDebugLoc(call));
+  LLVMDisposeBuilder(b);
+
+  LLVMReplaceAllUsesWith(call, inv);
+  LLVMInstructionEraseFromParent(call);
+  eh_retarget_phis(backend, bb, cont);
+}
+
+// Catch + finally tail shared by both lowerings. The builder sits in the
+// catch block; `exc` is the caught value (NULL under setjmp, where it is
+// fetched from the runtime with aot_get_exception).
+static void codegen_catch_finally(LLVMBackend *backend, ASTNode_C *node,
+                                  LLVMValueRef exc, LLVMBasicBlockRef finallyB,
+                                  LLVMBasicBlockRef endB) {
+  if (node->catch_var && node->catch_block) {
+    // Get exception: VMValue e = aot_get_exception()
+    if (!exc)
+      exc = llvm_call_vmvalue_func(backend, backend->func_aot_get_exception,
+                                   nullptr, 0, "exception");
+    // Store to catch variable (at entry)
+    LLVMValueRef alloca = llvm_build_alloca_at_entry(
+        backend, backend->vm_value_type, node->catch_var);
+    LLVMBuildStore(backend->builder, exc, alloca);
+    add_local(backend, node->catch_var, alloca);
+    // PR 3f: surface the catch-bound exception value to the debugger.
+    llvm_backend_emit_local_vmvalue_declare(backend, node->catch_var, alloca,
+                                            node->line);
+
+    codegen_statement(backend, node->catch_block);
+  }
+  if (!LLVMGetBasicBlockTerminator(LLVMGetInsertBlock(backend->builder)))
+    LLVMBuildBr(backend->builder, finallyB ? finallyB : endB);
+
+  // Finally block
+  if (finallyB) {
+    LLVMPositionBuilderAtEnd(backend->builder, finallyB);
+    codegen_statement(backend, node->finally_block);
+    if (!LLVMGetBasicBlockTerminator(LLVMGetInsertBlock(backend->builder)))
+      LLVMBuildBr(backend->builder, endB);
+  }
+
+  LLVMPositionBuilderAtEnd(backend->builder, endB);
+}
+
+// try/catch as invoke + landingpad. Nothing runs on entry to the try — no
+// handler push, no setjmp — so try_depth stays untouched and return/break/
+// continue inside the body need no pops.
+static void codegen_try_catch_unwind(LLVMBackend *backend, ASTNode_C *node) {
+  LLVMValueRef fn = backend->current_function;
+  LLVMBasicBlockRef tryB = LLVMAppendBasicBlock(fn, "try");
+  LLVMBuildBr(backend->builder, tryB);
+  LLVMPositionBuilderAtEnd(backend->builder, tryB);
+  codegen_statement(backend, node->try_block);
+  LLVMBasicBlockRef bodyEnd = LLVMGetInsertBlock(backend->builder);
+
+  // Everything appended from tryB on belongs to the body; the blocks created
+  // below mark where it ends.
+  LLVMBasicBlockRef lpadB = LLVMAppendBasicBlock(fn, "catch");
+  LLVMBasicBlockRef finallyB =
+      node->finally_block ? LLVMAppendBasicBlock(fn, "finally") : nullptr;
+  LLVMBasicBlockRef endB = LLVMAppendBasicBlock(fn, "try_end");
+
+  if (!LLVMGetBasicBlockTerminator(bodyEnd)) {
+    LLVMPositionBuilderAtEnd(backend->builder, bodyEnd);
+    LLVMBuildBr(backend->builder, finallyB ? finallyB : endB);
+  }
+  // Builder must sit outside the body while its blocks are split.
+  LLVMPositionBuilderAtEnd(backend->builder, lpadB);
+  for (LLVMBasicBlockRef bb = tryB; bb && bb != lpadB;
+       bb = LLVMGetNextBasicBlock(bb)) {
+    for (LLVMValueRef inst = LLVMGetFirstInstruction(bb); inst;
+         inst = LLVMGetNextInstruction(inst)) {
+      if (LLVMIsACallInst(inst) && eh_call_may_unwind(backend, inst)) {
+        eh_call_to_invoke(backend, inst, lpadB);
+        break; // the rest of bb is now the next block
+      }
+    }
   }
+
+  // landingpad { ptr, i32 } catch ptr @_ZTI11TulparThrow — only Tulpar
+  // throws stop here; anything else keeps unwinding.
+  LLVMTypeRef lp_fields[] = {backend->ptr_type, backend->int32_type};
+  LLVMTypeRef lp_type =
+      LLVMStructTypeInContext(backend->context, lp_fields, 2, 0);
+  LLVMValueRef lp = LLVMBuildLandingPad(backend->builder, lp_type,
+                                        backend->eh_personality, 1, "eh_lp");
+  LLVMAddClause(lp, backend->eh_typeinfo);
+  LLVMValueRef exn = LLVMBuildExtractValue(backend->builder, lp, 0, "eh_exn");
+  LLVMValueRef exc = llvm_call_vmvalue_func(
+      backend, backend->func_aot_eh_catch, &exn, 1, "exception");
+  codegen_catch_finally(backend, node, exc, finallyB, endB);
 }
 
 LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
@@ -6928,6 +10335,11 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
       }
     }
 
+    // Unboxed typed array picked by collect_typed_array_decls for this
+    // function (`arrayInt flags = [];` that never escapes).
+    if (TypedArraySlot *ta_slot = typed_array_slot_for_decl(backend, node))
+      return codegen_typed_array_decl(backend, node, ta_slot);
+
     // Native typed-int global (registered in Pass 0.1 for `int x = ...;`)?
     LLVMValueRef existing_global =
         LLVMGetNamedGlobal(backend->module, node->name);
@@ -6939,8 +10351,7 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
         if (tv.type == INFERRED_INT || tv.type == INFERRED_BOOL) {
           int_init = tv.value;
         } else if (tv.boxed) {
-          int_init = LLVMBuildExtractValue(backend->builder, tv.boxed, 2,
-                                           "init_int");
+          int_init = llvm_vm_int_payload(backend, tv.boxed, "init_int");
         } else {
           int_init = LLVMConstInt(backend->int_type, 0, 0);
         }
@@ -7076,8 +10487,8 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
             int idx = struct_type_field_index(st, fname);
             LLVMValueRef val_box = codegen_expression(
                 backend, node->right->object_values[k]);
-            LLVMValueRef i64_val = LLVMBuildExtractValue(
-                backend->builder, val_box, 2, "lit.i64");
+            LLVMValueRef i64_val =
+                llvm_vm_int_payload(backend, val_box, "lit.i64");
             LLVMValueRef field_ptr = LLVMBuildStructGEP2(
                 backend->builder, st->llvm_type, typed_alloca,
                 (unsigned)idx, "struct.lit.field.ptr");
@@ -7095,6 +10506,11 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
           // the call took the regular VMValue path instead.
           backend->pending_struct_result_ptr = nullptr;
           backend->pending_struct_result_name = nullptr;
+        } else if (init_is_heap_unpack &&
+                   struct_array_copy_out(backend, node->right, st,
+                                         typed_alloca)) {
+          // `V3 p = points[i];` on an unboxed struct array: one struct
+          // load straight out of the buffer (see UNBOXED TYPED ARRAYS).
         } else if (init_is_heap_unpack) {
           // `V3 p = points[0];` — codegen the RHS as a regular VMValue,
           // store it to a temp alloca, hand the pointer to
@@ -7119,7 +10535,14 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
     // printf("[AOT] Declaring var: %s\n", node->name);
     LLVMValueRef init;
     if (node->right) {
-      init = codegen_expression(backend, node->right);
+      StackContainerSlot *sc = stack_container_slot_for_decl(backend, node);
+      bool scalar_decl = node->data_type == TYPE_INT ||
+                         node->data_type == TYPE_FLOAT ||
+                         node->data_type == TYPE_BOOL ||
+                         node->data_type == TYPE_STRING;
+      init = sc ? emit_stack_container_literal(backend, sc, node->right)
+             : scalar_decl ? codegen_expression(backend, node->right)
+                           : codegen_alias_source(backend, node->right);
       // Honour the declared type for the int case. `int x = <bool expr>`
       // (e.g. `int ok = db_execute(db, sql)` — sqlite helpers return
       // VM_BOOL) needs to land as VM_VAL_INT so toString(x) prints "1"
@@ -7130,8 +10553,7 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
       // left alone — typeinfer's pre-pass already warned about those
       // mismatches.
       if (node->data_type == TYPE_INT && init) {
-        LLVMValueRef tag = LLVMBuildExtractValue(backend->builder, init, 0,
-                                                 "decl.tag");
+        LLVMValueRef tag = llvm_vm_tag(backend, init, "decl.tag");
         LLVMValueRef is_bool = LLVMBuildICmp(
             backend->builder, LLVMIntEQ, tag,
             LLVMConstInt(backend->int32_type, /*VM_VAL_BOOL=*/2, 0),
@@ -7140,8 +10562,7 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
             backend->builder, is_bool,
             LLVMConstInt(backend->int32_type, /*VM_VAL_INT=*/0, 0),
             tag, "decl.tag.coerced");
-        init = LLVMBuildInsertValue(backend->builder, init, new_tag, 0,
-                                    "decl.bool_to_int");
+        init = llvm_vm_retag(backend, init, new_tag, "decl.bool_to_int");
       }
     } else if (node->data_type == TYPE_CUSTOM) {
       // `Point p;` form: allocate an empty Object so subsequent `p.x = ...`
@@ -7160,6 +10581,16 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
     // Check if it's already a (boxed) global (from pre-scan).
     if (existing_global) {
       LLVMBuildStore(backend->builder, init, existing_global);
+      if (node->data_type == TYPE_INT || node->data_type == TYPE_FLOAT ||
+          node->data_type == TYPE_BOOL ||
+          ownership_scalar_expr(backend, node->right)) {
+        backend->arc_elided_fn++; // nothing to share (OWNERSHIP MOVES)
+        return existing_global;
+      }
+      LLVMValueRef share_args[] = {existing_global};
+      LLVMBuildCall2(backend->builder,
+                     LLVMGlobalGetValueType(backend->func_arc_share_vmvalue),
+                     backend->func_arc_share_vmvalue, share_args, 1, "");
       return existing_global;
     }
 
@@ -7167,12 +10598,48 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
         llvm_build_alloca_at_entry(backend, backend->vm_value_type, node->name);
     LLVMBuildStore(backend->builder, init, alloca);
     add_local(backend, node->name, alloca);
+    if (is_str_builder_decl(backend, node)) {
+      // In-place append target (see STRING BUILDER LOCALS). The owner is
+      // cleared here too, so a decl re-run by a loop starts from scratch.
+      LocalVar *sbv = get_local_var(backend, node->name);
+      if (sbv) {
+        sbv->str_owner = llvm_build_alloca_at_entry(backend, backend->ptr_type,
+                                                    "sb.owner");
+        LLVMBuildStore(backend->builder,
+                       LLVMConstPointerNull(backend->ptr_type),
+                       sbv->str_owner);
+      }
+    }
     // PR 3f: surface this boxed VMValue local to the debugger.
     llvm_backend_emit_local_vmvalue_declare(backend, node->name, alloca,
                                             node->line);
     return alloca;
   }
   case AST_ASSIGNMENT: {
+    // `s = s + a + b` on a string-builder local: append in place.
+    if (!node->left && node->right) {
+      if (LocalVar *sbv = str_builder_local(backend, node->name)) {
+        ASTNode_C *parts[64];
+        int np = str_builder_append_chain(node->right, node->name, parts, 64);
+        if (np > 0) return emit_str_builder_append(backend, sbv, parts, np);
+      }
+    }
+    // `a[i] = v` on an unboxed typed-array local.
+    if (node->left && node->left->type == AST_ARRAY_ACCESS) {
+      LocalVar *ta =
+          typed_array_local(backend, array_access_receiver(node->left));
+      if (ta)
+        return typed_array_store(backend, ta, node->left->index, node->right);
+      // `pts[i].x = v` on an unboxed struct array.
+      StructTypeEntry *sa_st = nullptr;
+      int sa_field = -1;
+      if (LocalVar *sa = struct_array_field_access(backend, node->left,
+                                                   &sa_st, &sa_field))
+        return struct_array_field_store(backend, sa, sa_st,
+                                        node->left->left->index, sa_field,
+                                        node->right);
+    }
+
     // Native typed-int target fast path: avoid boxing the rhs.
     if (node->name) {
       InferredType vt_t = get_local_type(backend, node->name);
@@ -7207,8 +10674,8 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
             if (dt.type == INFERRED_INT || dt.type == INFERRED_BOOL) {
               delta_i64 = dt.value;
             } else if (dt.boxed) {
-              delta_i64 = LLVMBuildExtractValue(backend->builder, dt.boxed,
-                                                2, "atomic.delta");
+              delta_i64 =
+                  llvm_vm_int_payload(backend, dt.boxed, "atomic.delta");
             } else {
               delta_i64 = LLVMConstInt(backend->int_type, 0, 0);
             }
@@ -7230,8 +10697,7 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
         if (tv.type == INFERRED_INT || tv.type == INFERRED_BOOL) {
           int_val = tv.value;
         } else if (tv.boxed) {
-          int_val = LLVMBuildExtractValue(backend->builder, tv.boxed, 2,
-                                          "assign_int");
+          int_val = llvm_vm_int_payload(backend, tv.boxed, "assign_int");
         } else {
           int_val = LLVMConstInt(backend->int_type, 0, 0);
         }
@@ -7250,6 +10716,14 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
     if (node->left && node->left->type == AST_ARRAY_ACCESS) {
       val = codegen_struct_expr_as_object(backend, node->right);
     }
+    if (!val && node->name && !node->left &&
+        !is_global_var(backend, node->name)) {
+      // Whole local: it aliases the value (COPY-ON-WRITE WRITES).
+      InferredType lt = get_local_type(backend, node->name);
+      if (lt != INFERRED_INT && lt != INFERRED_FLOAT && lt != INFERRED_BOOL &&
+          lt != INFERRED_STRING)
+        val = codegen_alias_source(backend, node->right);
+    }
     if (!val) {
       val = codegen_expression(backend, node->right);
     }
@@ -7286,11 +10760,11 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
             LLVMValueRef field_ptr = LLVMBuildStructGEP2(
                 backend->builder, st->llvm_type, alloca_ptr,
                 (unsigned)idx, "struct.field.ptr");
-            // Extract the i64 payload from the boxed VMValue rhs (slot 2
-            // of {tag, pad, i64}). The bool case writes the same i64
-            // because true/false box with int_val=1 / int_val=0.
-            LLVMValueRef rhs_i64 = LLVMBuildExtractValue(
-                backend->builder, val, 2, "rhs.i64");
+            // Extract the i64 payload from the boxed VMValue rhs. The bool
+            // case writes the same i64 because true/false box with
+            // int_val=1 / int_val=0.
+            LLVMValueRef rhs_i64 =
+                llvm_vm_int_payload(backend, val, "rhs.i64");
             LLVMBuildStore(backend->builder, rhs_i64, field_ptr);
             return val;
           }
@@ -7306,16 +10780,19 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
       // Array access can be either:
       // 1. Simple: arr[i] - name is in access->name, left is nullptr
       // 2. Nested: arr[i][j] - left has previous access
+      // The target is made unique on the way down (COPY-ON-WRITE WRITES).
       if (access->name) {
         // Simple access: get array from variable
         LLVMValueRef var_ptr = get_local(backend, access->name);
-        if (var_ptr) {
+        if (LLVMValueRef slot = cow_var_slot(backend, access->name)) {
+          target = emit_cow_slot(backend, slot, access->name);
+        } else if (var_ptr) {
           target = LLVMBuildLoad2(backend->builder, backend->vm_value_type,
                                   var_ptr, access->name);
         }
       } else if (access->left) {
         // Nested access: evaluate left expression
-        target = codegen_expression(backend, access->left);
+        target = codegen_cow_target(backend, access->left);
       }
 
       LLVMValueRef index = codegen_expression(backend, access->index);
@@ -7372,13 +10849,13 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
       // read within the request, so persisting it would deep-copy (and leak)
       // the whole request object on every call.
       if (is_global_var(backend, node->name) &&
-          strcmp(node->name, "_request") != 0) {
-        LLVMValueRef pargs[] = {val};
-        val = llvm_call_vmvalue_func(backend, backend->func_aot_persist, pargs,
-                                     1, "assign.autopersist");
-      }
+          strcmp(node->name, "_request") != 0)
+        val = emit_global_store_value(backend, node->right, val);
 
       LLVMValueRef target = get_local(backend, node->name);
+      if (var && var->str_owner && target)
+        LLVMBuildStore(backend->builder,
+                       LLVMConstPointerNull(backend->ptr_type), var->str_owner);
       if (target)
         LLVMBuildStore(backend->builder, val, target);
       else {
@@ -7394,6 +10871,9 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
   }
   case AST_BLOCK: {
     LLVMValueRef last = nullptr;
+    // `unchecked { ... }`: typed-array accesses inside skip their bounds
+    // check, int arithmetic its --checks=full overflow check.
+    if (node->is_unchecked) backend->unchecked_depth++;
     if (node->statements) {
       for (int i = 0; i < node->statement_count; i++) {
         if (LLVMGetBasicBlockTerminator(LLVMGetInsertBlock(backend->builder)))
@@ -7401,6 +10881,7 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
         last = codegen_statement(backend, node->statements[i]);
       }
     }
+    if (node->is_unchecked) backend->unchecked_depth--;
     return last;
   }
   case AST_IF: {
@@ -7458,7 +10939,7 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
     // Lower in place to a desugared C-style for over an index, then re-
     // dispatch through the now-AST_BLOCK case. Done lazily on first visit
     // so the AST stays small until/unless this codegen pass touches it.
-    lower_for_in_in_place(node);
+    lower_for_in_in_place(backend, node);
     return codegen_statement(backend, node);
   }
   case AST_FOR: {
@@ -7469,46 +10950,8 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
     if (node->init)
       codegen_statement(backend, node->init);
 
-    LLVMBasicBlockRef condB =
-        LLVMAppendBasicBlock(backend->current_function, "for_cond");
-    LLVMBasicBlockRef bodyB =
-        LLVMAppendBasicBlock(backend->current_function, "for_body");
-    LLVMBasicBlockRef incrB =
-        LLVMAppendBasicBlock(backend->current_function, "for_incr");
-    LLVMBasicBlockRef exitB =
-        LLVMAppendBasicBlock(backend->current_function, "for_exit");
-
-    LLVMBuildBr(backend->builder, condB);
-    LLVMPositionBuilderAtEnd(backend->builder, condB);
-
-    LLVMValueRef c =
-        node->condition
-            ? llvm_build_is_truthy(backend,
-                                   codegen_expression(backend, node->condition))
-            : LLVMConstInt(backend->bool_type, 1, 0); // true if no condition
-    LLVMBuildCondBr(backend->builder, c, bodyB, exitB);
-
-    LLVMPositionBuilderAtEnd(backend->builder, bodyB);
-    // continue jumps to incrB (so the loop variable still increments),
-    // break jumps to exitB.
-    if (backend->loop_depth < 32) {
-      backend->loop_stack[backend->loop_depth].continue_block = incrB;
-      backend->loop_stack[backend->loop_depth].break_block = exitB;
-      backend->loop_stack[backend->loop_depth].try_depth_at_entry =
-          backend->try_depth;
-      backend->loop_depth++;
-    }
-    codegen_statement(backend, node->body);
-    if (backend->loop_depth > 0) backend->loop_depth--;
-    if (!LLVMGetBasicBlockTerminator(LLVMGetInsertBlock(backend->builder)))
-      LLVMBuildBr(backend->builder, incrB);
-
-    LLVMPositionBuilderAtEnd(backend->builder, incrB);
-    if (node->increment)
-      codegen_statement(backend, node->increment);
-    LLVMBuildBr(backend->builder, condB);
-
-    LLVMPositionBuilderAtEnd(backend->builder, exitB);
+    // cond / body / incr, possibly twice (RANGE-PROVED ARRAY ACCESSES)
+    codegen_for_ranged(backend, node);
 
     // Exit loop scope
     exit_scope(backend);
@@ -7573,6 +11016,7 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
           LLVMValueRef loaded = LLVMBuildLoad2(
               backend->builder, st->llvm_type, src, "ret.struct.load");
           LLVMBuildStore(backend->builder, loaded, res_ptr);
+          emit_typed_array_releases(backend);
           emit_try_pops(backend, backend->try_depth);
           return LLVMBuildRetVoid(backend->builder);
         }
@@ -7596,6 +11040,7 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
           (void)codegen_expression(backend, rv);
           backend->pending_struct_result_ptr = nullptr;
           backend->pending_struct_result_name = nullptr;
+          emit_typed_array_releases(backend);
           emit_try_pops(backend, backend->try_depth);
           return LLVMBuildRetVoid(backend->builder);
         }
@@ -7621,13 +11066,14 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
             int idx = struct_type_field_index(st, rv->object_keys[k]);
             LLVMValueRef val_box =
                 codegen_expression(backend, rv->object_values[k]);
-            LLVMValueRef i64_val = LLVMBuildExtractValue(
-                backend->builder, val_box, 2, "ret.lit.i64");
+            LLVMValueRef i64_val =
+                llvm_vm_int_payload(backend, val_box, "ret.lit.i64");
             LLVMValueRef field_ptr = LLVMBuildStructGEP2(
                 backend->builder, st->llvm_type, res_ptr,
                 (unsigned)idx, "ret.lit.field.ptr");
             LLVMBuildStore(backend->builder, i64_val, field_ptr);
           }
+          emit_typed_array_releases(backend);
           emit_try_pops(backend, backend->try_depth);
           return LLVMBuildRetVoid(backend->builder);
         }
@@ -7638,7 +11084,7 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
     }
     LLVMValueRef ret =
         node->return_value
-            ? codegen_expression(backend, node->return_value)
+            ? codegen_alias_source(backend, node->return_value)
             : llvm_vm_val_int(backend, 0); // Return 0/Void if no value
 
     // ABI Change: Store to Result Pointer (Param 0)
@@ -7646,10 +11092,15 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
     LLVMBuildStore(backend->builder, ret, res_ptr);
     // Pops go AFTER evaluating the return expression: `return f();` inside a
     // try must still route f's throw to this try's handler.
+    emit_typed_array_releases(backend);
     emit_try_pops(backend, backend->try_depth);
     return LLVMBuildRetVoid(backend->builder);
   }
   case AST_TRY_CATCH: {
+    if (backend->eh_unwind) {
+      codegen_try_catch_unwind(backend, node);
+      return nullptr;
+    }
     // jmp_buf* buf = aot_try_push()
     LLVMValueRef buf = LLVMBuildCall2(
         backend->builder, LLVMGlobalGetValueType(backend->func_aot_try_push),
@@ -7713,33 +11164,7 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
 
     // Catch block
     LLVMPositionBuilderAtEnd(backend->builder, catchB);
-    if (node->catch_var && node->catch_block) {
-      // Get exception: VMValue e = aot_get_exception()
-      LLVMValueRef exc = llvm_call_vmvalue_func(
-          backend, backend->func_aot_get_exception, nullptr, 0, "exception");
-      // Store to catch variable (at entry)
-      LLVMValueRef alloca = llvm_build_alloca_at_entry(
-          backend, backend->vm_value_type, node->catch_var);
-      LLVMBuildStore(backend->builder, exc, alloca);
-      add_local(backend, node->catch_var, alloca);
-      // PR 3f: surface the catch-bound exception value to the debugger.
-      llvm_backend_emit_local_vmvalue_declare(backend, node->catch_var, alloca,
-                                              node->line);
-
-      codegen_statement(backend, node->catch_block);
-    }
-    if (!LLVMGetBasicBlockTerminator(LLVMGetInsertBlock(backend->builder)))
-      LLVMBuildBr(backend->builder, finallyB ? finallyB : endB);
-
-    // Finally block
-    if (finallyB) {
-      LLVMPositionBuilderAtEnd(backend->builder, finallyB);
-      codegen_statement(backend, node->finally_block);
-      if (!LLVMGetBasicBlockTerminator(LLVMGetInsertBlock(backend->builder)))
-        LLVMBuildBr(backend->builder, endB);
-    }
-
-    LLVMPositionBuilderAtEnd(backend->builder, endB);
+    codegen_catch_finally(backend, node, nullptr, finallyB, endB);
     return nullptr;
   }
   case AST_THROW: {
@@ -7897,6 +11322,7 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
       apply_import_alias(module_ast, node->name);
     }
 
+    if (embedded_code) backend->stdlib_depth++;
     if (module_ast) {
       if (module_ast->type == AST_PROGRAM && module_ast->statements) {
         // Pass 0.1: Pre-scan for Global Variables (Forward Declaration).
@@ -8006,6 +11432,7 @@ LLVMValueRef codegen_statement(LLVMBackend *backend, ASTNode_C *node) {
         }
       }
     }
+    if (embedded_code) backend->stdlib_depth--;
 
     for (int i = 0; i < token_count; i++) {
       token_free(tokens[i]);
@@ -8248,7 +11675,7 @@ static LLVMValueRef native_loop_int_value(LLVMBackend *backend, TypedValue v,
                                           int have_default) {
   if (v.type == INFERRED_INT || v.type == INFERRED_BOOL) return v.value;
   if (v.boxed)
-    return LLVMBuildExtractValue(backend->builder, v.boxed, 2, "loop_int");
+    return llvm_vm_int_payload(backend, v.boxed, "loop_int");
   return have_default ? LLVMConstInt(backend->int_type, 0, 0) : nullptr;
 }
 
@@ -8289,7 +11716,10 @@ void codegen_native_func_def(LLVMBackend *backend, ASTNode_C *node) {
 
   // Add function-level attributes.
   //
-  //   nounwind         this function doesn't throw exceptions
+  //   nounwind         this function doesn't throw exceptions (setjmp EH
+  //                    targets only — under landing pads a throw unwinds
+  //                    through here, and nounwind would let LLVM turn a
+  //                    caller's invoke back into a call and drop its pad)
   //   inlinehint       hint the inliner to lean toward inlining; matches
   //                    the regular boxed-typed function path
   //   uwtable          keep the unwind table so longjmp can SEH-walk
@@ -8304,10 +11734,12 @@ void codegen_native_func_def(LLVMBackend *backend, ASTNode_C *node) {
   // params, redundant zext/icmp, etc. Benchmarks have been switched
   // to env-based loop bounds (TULPAR_BENCH_N) so the fold can no
   // longer happen, and the optnone gag is removed here.
-  LLVMAddAttributeAtIndex(
-      func, LLVMAttributeFunctionIndex,
-      LLVMCreateEnumAttribute(
-          backend->context, LLVMGetEnumAttributeKindForName("nounwind", 8), 0));
+  if (!backend->eh_unwind)
+    LLVMAddAttributeAtIndex(
+        func, LLVMAttributeFunctionIndex,
+        LLVMCreateEnumAttribute(backend->context,
+                                LLVMGetEnumAttributeKindForName("nounwind", 8),
+                                0));
   LLVMAddAttributeAtIndex(
       func, LLVMAttributeFunctionIndex,
       LLVMCreateEnumAttribute(backend->context,
@@ -8377,7 +11809,7 @@ void codegen_native_func_def(LLVMBackend *backend, ASTNode_C *node) {
           // Extract int from boxed value
           LLVMValueRef boxed = box_typed_value(backend, ret);
           LLVMValueRef int_val =
-              LLVMBuildExtractValue(backend->builder, boxed, 2, "ret_int");
+              llvm_vm_int_payload(backend, boxed, "ret_int");
           LLVMBuildRet(backend->builder, int_val);
         }
       } else if (stmt->type == AST_IF) {
@@ -8391,7 +11823,7 @@ void codegen_native_func_def(LLVMBackend *backend, ASTNode_C *node) {
         } else {
           LLVMValueRef boxed = box_typed_value(backend, cond);
           LLVMValueRef val =
-              LLVMBuildExtractValue(backend->builder, boxed, 2, "cond_val");
+              llvm_vm_payload(backend, boxed, "cond_val");
           cond_bool =
               LLVMBuildICmp(backend->builder, LLVMIntNE, val,
                             LLVMConstInt(backend->int_type, 0, 0), "cond");
@@ -8417,7 +11849,7 @@ void codegen_native_func_def(LLVMBackend *backend, ASTNode_C *node) {
             } else {
               LLVMValueRef boxed = box_typed_value(backend, ret);
               LLVMValueRef int_val =
-                  LLVMBuildExtractValue(backend->builder, boxed, 2, "ret_int");
+                  llvm_vm_int_payload(backend, boxed, "ret_int");
               LLVMBuildRet(backend->builder, int_val);
             }
           } else if (stmt->then_branch->type == AST_BLOCK &&
@@ -8431,8 +11863,8 @@ void codegen_native_func_def(LLVMBackend *backend, ASTNode_C *node) {
                   LLVMBuildRet(backend->builder, ret.value);
                 } else {
                   LLVMValueRef boxed = box_typed_value(backend, ret);
-                  LLVMValueRef int_val = LLVMBuildExtractValue(
-                      backend->builder, boxed, 2, "ret_int");
+                  LLVMValueRef int_val =
+                      llvm_vm_int_payload(backend, boxed, "ret_int");
                   LLVMBuildRet(backend->builder, int_val);
                 }
                 break;
@@ -8462,8 +11894,8 @@ void codegen_native_func_def(LLVMBackend *backend, ASTNode_C *node) {
           if (init.type == INFERRED_INT || init.type == INFERRED_BOOL) {
             LLVMBuildStore(backend->builder, init.value, alloca);
           } else if (init.boxed) {
-            LLVMValueRef int_val = LLVMBuildExtractValue(
-                backend->builder, init.boxed, 2, "init_int");
+            LLVMValueRef int_val =
+                llvm_vm_int_payload(backend, init.boxed, "init_int");
             LLVMBuildStore(backend->builder, int_val, alloca);
           } else {
             LLVMBuildStore(backend->builder,
@@ -8486,8 +11918,8 @@ void codegen_native_func_def(LLVMBackend *backend, ASTNode_C *node) {
           if (val.type == INFERRED_INT || val.type == INFERRED_BOOL) {
             LLVMBuildStore(backend->builder, val.value, var_ptr);
           } else if (val.boxed) {
-            LLVMValueRef int_val = LLVMBuildExtractValue(
-                backend->builder, val.boxed, 2, "assign_int");
+            LLVMValueRef int_val =
+                llvm_vm_int_payload(backend, val.boxed, "assign_int");
             LLVMBuildStore(backend->builder, int_val, var_ptr);
           }
         }
@@ -8512,8 +11944,8 @@ void codegen_native_func_def(LLVMBackend *backend, ASTNode_C *node) {
           // where the builtin makes the comparison boxed). Test the payload
           // (field 2) != 0 rather than defaulting to `true`, which would spin
           // the loop forever.
-          LLVMValueRef payload = LLVMBuildExtractValue(
-              backend->builder, wcond.boxed, 2, "w_cond_payload");
+          LLVMValueRef payload =
+              llvm_vm_payload(backend, wcond.boxed, "w_cond_payload");
           wcond_bool =
               LLVMBuildICmp(backend->builder, LLVMIntNE, payload,
                             LLVMConstInt(backend->int_type, 0, 0), "w_cond");
@@ -8539,8 +11971,10 @@ void codegen_native_func_def(LLVMBackend *backend, ASTNode_C *node) {
                   LLVMBuildStore(backend->builder, store_val, var_ptr);
               }
             } else if (body_stmt->type == AST_VARIABLE_DECL) {
-              LLVMValueRef alloca = LLVMBuildAlloca(
-                  backend->builder, backend->int_type, body_stmt->name);
+              // Entry-block slot: a loop-body alloca grows the stack every
+              // iteration and is invisible to mem2reg.
+              LLVMValueRef alloca = llvm_build_alloca_at_entry(
+                  backend, backend->int_type, body_stmt->name);
               if (body_stmt->right) {
                 TypedValue init = codegen_typed_expr(backend, body_stmt->right);
                 LLVMBuildStore(backend->builder,
@@ -8602,8 +12036,8 @@ void codegen_native_func_def(LLVMBackend *backend, ASTNode_C *node) {
         } else if (cond.boxed) {
           // Boxed VMValue condition (e.g. `i < length(arr)`): test payload
           // (field 2) != 0 instead of defaulting to `true` (infinite loop).
-          LLVMValueRef payload = LLVMBuildExtractValue(
-              backend->builder, cond.boxed, 2, "for_cond_payload");
+          LLVMValueRef payload =
+              llvm_vm_payload(backend, cond.boxed, "for_cond_payload");
           cond_bool =
               LLVMBuildICmp(backend->builder, LLVMIntNE, payload,
                             LLVMConstInt(backend->int_type, 0, 0), "for_cond");
@@ -8630,8 +12064,8 @@ void codegen_native_func_def(LLVMBackend *backend, ASTNode_C *node) {
               }
             } else if (body_stmt->type == AST_VARIABLE_DECL) {
               // Variable declaration inside loop body
-              LLVMValueRef alloca = LLVMBuildAlloca(
-                  backend->builder, backend->int_type, body_stmt->name);
+              LLVMValueRef alloca = llvm_build_alloca_at_entry(
+                  backend, backend->int_type, body_stmt->name);
               if (body_stmt->right) {
                 TypedValue init = codegen_typed_expr(backend, body_stmt->right);
                 LLVMBuildStore(backend->builder,
@@ -8650,8 +12084,8 @@ void codegen_native_func_def(LLVMBackend *backend, ASTNode_C *node) {
 
               // Initialize inner loop variable
               if (inner->init && inner->init->type == AST_VARIABLE_DECL) {
-                LLVMValueRef inner_alloca = LLVMBuildAlloca(
-                    backend->builder, backend->int_type, inner->init->name);
+                LLVMValueRef inner_alloca = llvm_build_alloca_at_entry(
+                    backend, backend->int_type, inner->init->name);
                 if (inner->init->right) {
                   TypedValue init_val =
                       codegen_typed_expr(backend, inner->init->right);
@@ -8774,6 +12208,433 @@ void codegen_native_func_def(LLVMBackend *backend, ASTNode_C *node) {
     LLVMPositionBuilderAtEnd(backend->builder, prev_block);
 }
 
+// ============================================================
+// SPECIALISED CLONES
+// ============================================================
+// An untyped helper (`func add(a, b) { return a + b; }`) only has the boxed
+// t_<name> ABI, so every `+` in it goes through the VMValue tag checks even
+// when every caller passes ints. A call site that can prove all of its
+// arguments are int calls `<name>$i…` instead: the same body emitted by
+// codegen_native_func_def with every parameter read as i64 — i64 in, i64
+// out. The boxed version stays for everyone else (call(), closures,
+// arguments of unknown type).
+//
+// A function qualifies when the native emitter can take its body and, with
+// its parameters assumed int, every value it stores or returns is provably
+// int (spec_int_expr), so the clone computes exactly what t_<name> would
+// for int arguments. An argument qualifies when it is an int literal, a
+// native int local/global, an untyped local that only ever holds ints
+// (collect_spec_int_locals), or int arithmetic / calls over those — the
+// rules of src/typeinfer (int op int is int), restricted to what the native
+// path emits with the same result as the boxed one.
+//
+// Clones are declared when first proven and their bodies emitted at the
+// end of llvm_backend_compile (emit_spec_clones); unused ones are dropped.
+// TULPAR_AOT_VERBOSE reports the specialised call sites, the ones inside
+// stdlib modules separately.
+
+// Predeclare-time shape check: no return type, every parameter untyped or
+// `int`, synchronous. The body is only examined once a call site asks.
+static void spec_register_candidate(LLVMBackend *backend, ASTNode_C *node) {
+  if (node->is_async || node->return_type != TYPE_VOID ||
+      node->return_custom_type || node->param_count <= 0 ||
+      strcmp(node->name, "main") == 0)
+    return;
+  for (int i = 0; i < node->param_count; i++) {
+    ASTNode_C *p = node->parameters[i];
+    if (!p || !p->name || p->return_custom_type ||
+        (p->data_type != TYPE_UNKNOWN && p->data_type != TYPE_INT))
+      return;
+  }
+  SpecData *sd = static_cast<SpecData *>(backend->spec_data);
+  SpecFunc sf = {node, SPEC_UNSEEN, backend->stdlib_depth > 0, nullptr};
+  sd->funcs.emplace(node->name, sf); // first declaration wins
+}
+
+// What an expression may assume. `names` are known ints. With `in_scope`
+// set, a native int local/global found through the current scope counts as
+// well — unless it is in `locals` (declared by the function under analysis,
+// whose scope does not exist yet). `self` is the function whose clone is
+// being proven: its own recursive calls are int by induction.
+struct SpecCtx {
+  LLVMBackend *backend;
+  const std::unordered_set<std::string> *names;
+  const std::unordered_set<std::string> *locals;
+  int in_scope;
+  const char *self;
+};
+
+static int spec_func_ok(LLVMBackend *backend, SpecFunc *sf);
+static int spec_int_expr(const SpecCtx &cx, ASTNode_C *e);
+
+// The candidate `call` reaches with a full argument list, or null.
+static SpecFunc *spec_callee(LLVMBackend *backend, ASTNode_C *call) {
+  if (call->receiver || call->callee || !call->name) return nullptr;
+  SpecData *sd = static_cast<SpecData *>(backend->spec_data);
+  auto it = sd->funcs.find(call->name);
+  if (it == sd->funcs.end()) return nullptr;
+  if (call->argument_count != it->second.node->param_count) return nullptr;
+  return &it->second;
+}
+
+static int spec_args_int(const SpecCtx &cx, ASTNode_C *call) {
+  for (int i = 0; i < call->argument_count; i++)
+    if (!spec_int_expr(cx, call->arguments[i])) return 0;
+  return 1;
+}
+
+static int spec_call_int(const SpecCtx &cx, ASTNode_C *call) {
+  if (call->receiver || call->callee || !call->name) return 0;
+  if (cx.in_scope && get_local_var(cx.backend, call->name)) return 0;
+  if (SpecFunc *sf = spec_callee(cx.backend, call)) {
+    if (!spec_args_int(cx, call)) return 0;
+    if (cx.self && strcmp(cx.self, call->name) == 0) return 1;
+    return spec_func_ok(cx.backend, sf);
+  }
+  // A native-ABI user function (`func f(int a): int`) returns i64.
+  LLVMValueRef f = LLVMGetNamedFunction(cx.backend->module, call->name);
+  if (!f ||
+      LLVMGetReturnType(LLVMGlobalGetValueType(f)) != cx.backend->int_type)
+    return 0;
+  for (int i = 0; i < cx.backend->function_count; i++)
+    if (strcmp(cx.backend->functions[i].name, call->name) == 0) return 1;
+  return 0;
+}
+
+static int spec_int_expr(const SpecCtx &cx, ASTNode_C *e) {
+  if (!e) return 0;
+  switch (e->type) {
+  case AST_INT_LITERAL:
+    return 1;
+  case AST_IDENTIFIER:
+    if (!e->name) return 0;
+    if (cx.names && cx.names->count(e->name)) return 1;
+    if (!cx.in_scope || (cx.locals && cx.locals->count(e->name))) return 0;
+    return get_local_type(cx.backend, e->name) == INFERRED_INT &&
+           get_local_native(cx.backend, e->name) &&
+           !typed_array_local(cx.backend, e->name);
+  case AST_UNARY_OP:
+    return e->op == TOKEN_MINUS && spec_int_expr(cx, e->left);
+  case AST_BINARY_OP:
+    switch (e->op) {
+    case TOKEN_PLUS:
+    case TOKEN_MINUS:
+    case TOKEN_MULTIPLY:
+    case TOKEN_DIVIDE:
+      return spec_int_expr(cx, e->left) && spec_int_expr(cx, e->right);
+    default:
+      return 0;
+    }
+  case AST_FUNCTION_CALL:
+    return spec_call_int(cx, e);
+  default:
+    return 0;
+  }
+}
+
+// Conditions: an int comparison or an int (truthy when non-zero).
+static int spec_cond_expr(const SpecCtx &cx, ASTNode_C *e) {
+  if (e && e->type == AST_BINARY_OP) {
+    switch (e->op) {
+    case TOKEN_LESS:
+    case TOKEN_GREATER:
+    case TOKEN_LESS_EQUAL:
+    case TOKEN_GREATER_EQUAL:
+    case TOKEN_EQUAL:
+    case TOKEN_NOT_EQUAL:
+      return spec_int_expr(cx, e->left) && spec_int_expr(cx, e->right);
+    default:
+      break;
+    }
+  }
+  return spec_int_expr(cx, e);
+}
+
+static int spec_stmt_ok(const SpecCtx &cx, std::unordered_set<std::string> &names,
+                        ASTNode_C *s);
+
+static int spec_block_ok(const SpecCtx &cx,
+                         std::unordered_set<std::string> &names, ASTNode_C *b) {
+  if (!b) return 1;
+  if (b->type != AST_BLOCK) return spec_stmt_ok(cx, names, b);
+  for (int i = 0; i < b->statement_count; i++)
+    if (!spec_stmt_ok(cx, names, b->statements[i])) return 0;
+  return 1;
+}
+
+// Clone-body proof, statement by statement in emission order: `names` grows
+// with each int declaration. Only shapes native_codegen_supports_stmt lets
+// through reach here.
+static int spec_stmt_ok(const SpecCtx &cx, std::unordered_set<std::string> &names,
+                        ASTNode_C *s) {
+  if (!s) return 1;
+  switch (s->type) {
+  case AST_RETURN:
+    return spec_int_expr(cx, s->return_value);
+  case AST_VARIABLE_DECL:
+    if (s->data_type != TYPE_INT && s->data_type != TYPE_UNKNOWN) return 0;
+    if (!s->name || !spec_int_expr(cx, s->right)) return 0;
+    names.insert(s->name);
+    return 1;
+  case AST_ASSIGNMENT:
+    // A name that is not a clone local is a global the native emitter
+    // would silently skip.
+    return !s->left && s->name && names.count(s->name) &&
+           spec_int_expr(cx, s->right);
+  case AST_IF: {
+    ASTNode_C *t = s->then_branch;
+    if (t && t->type == AST_BLOCK) t = t->statements[0];
+    return spec_cond_expr(cx, s->condition) && spec_stmt_ok(cx, names, t);
+  }
+  case AST_WHILE:
+    return spec_cond_expr(cx, s->condition) &&
+           spec_block_ok(cx, names, s->body);
+  case AST_FOR:
+    // The for-init store keeps only an unboxed int and writes 0 otherwise.
+    if (s->init) {
+      ASTNode_C *r = s->init->right;
+      if (!r || !(r->type == AST_INT_LITERAL ||
+                  (r->type == AST_IDENTIFIER && names.count(r->name))))
+        return 0;
+      if (!spec_stmt_ok(cx, names, s->init)) return 0;
+    }
+    return spec_cond_expr(cx, s->condition) &&
+           spec_stmt_ok(cx, names, s->increment) &&
+           spec_block_ok(cx, names, s->body);
+  default:
+    return 0;
+  }
+}
+
+// Prove `sf` on first use and declare its clone.
+static int spec_func_ok(LLVMBackend *backend, SpecFunc *sf) {
+  if (sf->state == SPEC_OK) return 1;
+  if (sf->state != SPEC_UNSEEN) return 0; // SPEC_NO, or mutual recursion
+  ASTNode_C *node = sf->node;
+  sf->state = SPEC_PENDING;
+  std::unordered_set<std::string> names;
+  for (int i = 0; i < node->param_count; i++)
+    names.insert(node->parameters[i]->name);
+  SpecCtx cx = {backend, &names, nullptr, 0, node->name};
+  if (!backend->use_static_typing || !node->body ||
+      node->body->type != AST_BLOCK ||
+      !native_codegen_supports_body(node->body) ||
+      !spec_block_ok(cx, names, node->body)) {
+    sf->state = SPEC_NO;
+    return 0;
+  }
+  std::string clone_name = std::string(node->name) + "$";
+  std::vector<LLVMTypeRef> params(node->param_count, backend->int_type);
+  for (int i = 0; i < node->param_count; i++) clone_name += 'i';
+  LLVMTypeRef ft = LLVMFunctionType(backend->int_type, params.data(),
+                                    node->param_count, 0);
+  sf->clone = LLVMAddFunction(backend->module, clone_name.c_str(), ft);
+  sf->state = SPEC_OK;
+  return 1;
+}
+
+// Call `node` through its clone when it has one and every argument is
+// provably int here; `*out` is the i64 result. `typed`: the caller is on
+// the native path, so arguments go through codegen_typed_expr.
+static int spec_emit_call(LLVMBackend *backend, ASTNode_C *node, int typed,
+                          LLVMValueRef *out) {
+  if (!backend->use_static_typing) return 0;
+  SpecFunc *sf = spec_callee(backend, node);
+  if (!sf || get_local_var(backend, node->name)) return 0;
+  SpecData *sd = static_cast<SpecData *>(backend->spec_data);
+  SpecCtx cx = {backend, sd->int_locals, nullptr, 1, nullptr};
+  if (!spec_args_int(cx, node) || !spec_func_ok(backend, sf)) return 0;
+
+  int n = node->argument_count;
+  std::vector<LLVMValueRef> args(n);
+  for (int i = 0; i < n; i++) {
+    if (typed) {
+      TypedValue a = codegen_typed_expr(backend, node->arguments[i]);
+      args[i] = a.type == INFERRED_INT
+                    ? a.value
+                    : llvm_vm_int_payload(backend, box_typed_value(backend, a),
+                                          "spec_arg");
+    } else {
+      args[i] = llvm_vm_int_payload(
+          backend, codegen_expression(backend, node->arguments[i]), "spec_arg");
+    }
+  }
+  *out = LLVMBuildCall2(backend->builder, LLVMGlobalGetValueType(sf->clone),
+                        sf->clone, args.data(), n, "spec_call");
+  sd->calls++;
+  if (backend->stdlib_depth > 0) sd->stdlib_calls++;
+  return 1;
+}
+
+// Definitions of each local, for collect_spec_int_locals. A null expression
+// is a definition that is not int (for-in / catch variable, `str s`, ...).
+struct SpecDefs {
+  std::vector<std::pair<std::string, ASTNode_C *>> defs;
+  std::unordered_set<std::string> declared;
+  std::unordered_set<std::string> excluded;
+};
+
+// Every name a lambda mentions: it may capture and rewrite it.
+static void spec_exclude_names(ASTNode_C *n, SpecDefs &d) {
+  if (!n) return;
+  if (n->name) d.excluded.insert(n->name);
+  for_each_child(n, [&](ASTNode_C *k) {
+    spec_exclude_names(k, d);
+    return true;
+  });
+}
+
+static void spec_collect_defs(ASTNode_C *n, SpecDefs &d) {
+  if (!n || n->type == AST_FUNCTION_DECL) return;
+  if (n->type == AST_LAMBDA) {
+    spec_exclude_names(n, d);
+    return;
+  }
+  switch (n->type) {
+  case AST_VARIABLE_DECL:
+    if (!n->name) break;
+    d.declared.insert(n->name);
+    d.defs.emplace_back(n->name, (n->data_type == TYPE_INT ||
+                                  n->data_type == TYPE_UNKNOWN) &&
+                                         !n->return_custom_type
+                                     ? n->right
+                                     : nullptr);
+    break;
+  case AST_ASSIGNMENT:
+    if (!n->left && n->name) d.defs.emplace_back(n->name, n->right);
+    break;
+  case AST_COMPOUND_ASSIGN:
+    if (n->name)
+      d.defs.emplace_back(n->name, (n->op == TOKEN_PLUS_EQUAL ||
+                                    n->op == TOKEN_MINUS_EQUAL ||
+                                    n->op == TOKEN_MULTIPLY_EQUAL ||
+                                    n->op == TOKEN_DIVIDE_EQUAL)
+                                       ? n->right
+                                       : nullptr);
+    break;
+  case AST_FOR_IN:
+    if (n->name) {
+      d.declared.insert(n->name);
+      d.defs.emplace_back(n->name, nullptr);
+    }
+    break;
+  case AST_TRY_CATCH:
+    if (n->catch_var) {
+      d.declared.insert(n->catch_var);
+      d.defs.emplace_back(n->catch_var, nullptr);
+    }
+    break;
+  default:
+    break;
+  }
+  for_each_child(n, [&](ASTNode_C *k) {
+    spec_collect_defs(k, d);
+    return true;
+  });
+}
+
+// Boxed locals of `fn` (a function, or the program root for main's nested
+// scopes) that only ever hold ints, so their call sites can use a clone.
+// `int` parameters are trusted like the native path trusts them; every
+// other candidate needs each definition to be int given the rest — start
+// from all of them and drop the ones with a non-int definition until
+// nothing changes. Globals (any function may store into them), names that
+// shadow one and names a lambda touches stay out.
+static void collect_spec_int_locals(LLVMBackend *backend, ASTNode_C *fn,
+                                    std::unordered_set<std::string> &out) {
+  SpecDefs d;
+  if (fn->type == AST_PROGRAM) {
+    for (int i = 0; i < fn->statement_count; i++) {
+      ASTNode_C *st = fn->statements[i];
+      if (!st || st->type == AST_FUNCTION_DECL || st->type == AST_IMPORT)
+        continue;
+      if (st->type == AST_VARIABLE_DECL) {
+        if (st->name) d.excluded.insert(st->name);
+        spec_collect_defs(st->right, d);
+        continue;
+      }
+      spec_collect_defs(st, d);
+    }
+  } else {
+    for (int i = 0; i < fn->param_count; i++) {
+      ASTNode_C *p = fn->parameters[i];
+      if (!p || !p->name) continue;
+      d.declared.insert(p->name);
+      if (p->data_type == TYPE_INT && !p->return_custom_type)
+        out.insert(p->name);
+      else
+        d.defs.emplace_back(p->name, nullptr);
+    }
+    spec_collect_defs(fn->body, d);
+  }
+  for (const auto &def : d.defs) out.insert(def.first);
+  for (const auto &def : d.defs)
+    if (!def.second) out.erase(def.first);
+  for (const auto &name : d.excluded) out.erase(name);
+  for (auto it = out.begin(); it != out.end();) {
+    if (LLVMGetNamedGlobal(backend->module, it->c_str()))
+      it = out.erase(it);
+    else
+      ++it;
+  }
+  SpecCtx cx = {backend, &out, &d.declared, 1, nullptr};
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (const auto &def : d.defs) {
+      if (out.count(def.first) && !spec_int_expr(cx, def.second)) {
+        out.erase(def.first);
+        changed = true;
+      }
+    }
+  }
+}
+
+// Emit every clone a call site used (a clone body may use more), then drop
+// the declarations nobody called.
+static void emit_spec_clones(LLVMBackend *backend) {
+  SpecData *sd = static_cast<SpecData *>(backend->spec_data);
+  const std::unordered_set<std::string> *prev_ints = sd->int_locals;
+  sd->int_locals = nullptr;
+  for (bool emitted = true; emitted;) {
+    emitted = false;
+    for (auto &kv : sd->funcs) {
+      SpecFunc &sf = kv.second;
+      if (sf.state != SPEC_OK || LLVMCountBasicBlocks(sf.clone) > 0 ||
+          !LLVMGetFirstUse(sf.clone))
+        continue;
+      // The clone is the original body with `int` parameters and an `int`
+      // return, under the clone's name.
+      ASTNode_C *orig = sf.node;
+      std::vector<ASTNode_C> params(orig->param_count);
+      std::vector<ASTNode_C *> param_ptrs(orig->param_count);
+      for (int i = 0; i < orig->param_count; i++) {
+        params[i] = *orig->parameters[i];
+        params[i].data_type = TYPE_INT;
+        param_ptrs[i] = &params[i];
+      }
+      std::string name = LLVMGetValueName(sf.clone);
+      ASTNode_C clone = *orig;
+      clone.name = &name[0];
+      clone.parameters = param_ptrs.data();
+      clone.return_type = TYPE_INT;
+      backend->stdlib_depth += sf.stdlib;
+      codegen_native_func_def(backend, &clone);
+      backend->stdlib_depth -= sf.stdlib;
+      sd->clones++;
+      emitted = true;
+    }
+  }
+  for (auto &kv : sd->funcs) {
+    SpecFunc &sf = kv.second;
+    if (sf.state == SPEC_OK && LLVMCountBasicBlocks(sf.clone) == 0) {
+      LLVMDeleteFunction(sf.clone);
+      sf.clone = nullptr;
+      sf.state = SPEC_NO;
+    }
+  }
+  sd->int_locals = prev_ints;
+}
+
 void codegen_func_def(LLVMBackend *backend, ASTNode_C *node) {
   // Check if function has explicit return type - use native codegen.
   // Async functions are exempt: they must use the boxed `t_<name>` ABI (the
@@ -8890,10 +12751,16 @@ void codegen_func_def(LLVMBackend *backend, ASTNode_C *node) {
   // `longjmp`'s SEH walker can traverse the function. `uwtable` keeps
   // the table; `nounwind` keeps the optimization. See Issue #53 for
   // the minimal repro that surfaces under redirected stdio.
-  LLVMAddAttributeAtIndex(
-      func, LLVMAttributeFunctionIndex,
-      LLVMCreateEnumAttribute(
-          backend->context, LLVMGetEnumAttributeKindForName("nounwind", 8), 0));
+  //
+  // That reasoning only holds for the setjmp lowering. With landing pads
+  // (eh_unwind) a Tulpar throw IS a C++-style exception unwinding through
+  // user frames, so `nounwind` would be a lie the optimizer acts on.
+  if (!backend->eh_unwind)
+    LLVMAddAttributeAtIndex(
+        func, LLVMAttributeFunctionIndex,
+        LLVMCreateEnumAttribute(backend->context,
+                                LLVMGetEnumAttributeKindForName("nounwind", 8),
+                                0));
   LLVMAddAttributeAtIndex(
       func, LLVMAttributeFunctionIndex,
       LLVMCreateEnumAttribute(
@@ -9047,11 +12914,63 @@ void codegen_func_def(LLVMBackend *backend, ASTNode_C *node) {
     }
   }
 
+  // Typed-array locals that can live unboxed (see UNBOXED TYPED ARRAYS).
+  // Headers are allocated + zeroed here, still in the entry block.
+  TypedArraySlot ta_slots[32];
+  TypedArraySlot *prev_typed_arrays = backend->typed_arrays;
+  int prev_typed_array_count = backend->typed_array_count;
+  LLVMValueRef prev_typed_array_fn = backend->typed_array_fn;
+  int ta_count = 0;
+  collect_typed_array_decls(backend, node, node->body, ta_slots, &ta_count,
+                            32);
+  backend->typed_arrays = ta_slots;
+  backend->typed_array_count = ta_count;
+  backend->typed_array_fn = ta_count > 0 ? func : nullptr;
+
+  // `str` locals that append in place (see STRING BUILDER LOCALS).
+  ASTNode_C *sb_decls[32];
+  ASTNode_C **prev_str_builders = backend->str_builders;
+  int prev_str_builder_count = backend->str_builder_count;
+  LLVMValueRef prev_str_builder_fn = backend->str_builder_fn;
+  int sb_count = 0;
+  collect_str_builder_decls(backend, node, node->body, sb_decls, &sb_count,
+                            32);
+  backend->str_builders = sb_decls;
+  backend->str_builder_count = sb_count;
+  backend->str_builder_fn = sb_count > 0 ? func : nullptr;
+
+  // Container literals that never escape (see STACK CONTAINER LOCALS).
+  StackContainerSlot sc_slots[32];
+  StackContainerSlot *prev_stack_containers = backend->stack_containers;
+  int prev_stack_container_count = backend->stack_container_count;
+  LLVMValueRef prev_stack_container_fn = backend->stack_container_fn;
+  int sc_count = 0;
+  collect_stack_container_decls(backend, node, node->body, sc_slots,
+                                &sc_count, 32);
+  backend->stack_containers = sc_slots;
+  backend->stack_container_count = sc_count;
+  backend->stack_container_fn = sc_count > 0 ? func : nullptr;
+
+  // Last uses stored into globals (see OWNERSHIP MOVES).
+  collect_ownership_moves(backend, node, node->body);
+  int prev_arc_moves = backend->arc_moves_fn;
+  int prev_arc_elided = backend->arc_elided_fn;
+  backend->arc_moves_fn = 0;
+  backend->arc_elided_fn = 0;
+
+  // Locals that can feed an int clone (see SPECIALISED CLONES).
+  SpecData *sd = static_cast<SpecData *>(backend->spec_data);
+  std::unordered_set<std::string> spec_ints;
+  collect_spec_int_locals(backend, node, spec_ints);
+  const std::unordered_set<std::string> *prev_spec_ints = sd->int_locals;
+  sd->int_locals = &spec_ints;
+
   codegen_statement(backend, node->body);
 
   // Default return if missing
   if (!LLVMGetBasicBlockTerminator(LLVMGetInsertBlock(backend->builder))) {
     LLVMValueRef res_ptr = LLVMGetParam(func, 0);
+    emit_typed_array_releases(backend);
     if (backend->current_function_returns_struct) {
       // Struct-returning function with no explicit return: zero-fill the
       // result struct so the caller reads consistent default values rather
@@ -9070,6 +12989,19 @@ void codegen_func_def(LLVMBackend *backend, ASTNode_C *node) {
   }
 
   backend->current_function_returns_struct = prev_returns_struct;
+  backend->typed_arrays = prev_typed_arrays;
+  backend->typed_array_count = prev_typed_array_count;
+  backend->typed_array_fn = prev_typed_array_fn;
+  backend->str_builders = prev_str_builders;
+  backend->str_builder_count = prev_str_builder_count;
+  backend->str_builder_fn = prev_str_builder_fn;
+  backend->stack_containers = prev_stack_containers;
+  backend->stack_container_count = prev_stack_container_count;
+  backend->stack_container_fn = prev_stack_container_fn;
+  sd->int_locals = prev_spec_ints;
+  report_arc_elision(backend, node->name);
+  backend->arc_moves_fn = prev_arc_moves;
+  backend->arc_elided_fn = prev_arc_elided;
   backend->func_stack = stack_node.parent;
   backend->current_function_node = prev_func_node;
   backend->current_env_ptr = prev_env_ptr;
@@ -9123,10 +13055,12 @@ static void predeclare_func_signature(LLVMBackend *backend, ASTNode_C *node) {
     LLVMTypeRef ft = LLVMFunctionType(backend->int_type, pt, pc, 0);
     LLVMValueRef f = LLVMAddFunction(backend->module, node->name, ft);
     register_function(backend, node->name, ft);
-    LLVMAddAttributeAtIndex(
-        f, LLVMAttributeFunctionIndex,
-        LLVMCreateEnumAttribute(
-            backend->context, LLVMGetEnumAttributeKindForName("nounwind", 8), 0));
+    if (!backend->eh_unwind)
+      LLVMAddAttributeAtIndex(
+          f, LLVMAttributeFunctionIndex,
+          LLVMCreateEnumAttribute(
+              backend->context, LLVMGetEnumAttributeKindForName("nounwind", 8),
+              0));
     free(pt);
   } else {
     char fn[256];
@@ -9155,10 +13089,13 @@ static void predeclare_func_signature(LLVMBackend *backend, ASTNode_C *node) {
         }
       }
     }
-    LLVMAddAttributeAtIndex(
-        f, LLVMAttributeFunctionIndex,
-        LLVMCreateEnumAttribute(
-            backend->context, LLVMGetEnumAttributeKindForName("nounwind", 8), 0));
+    spec_register_candidate(backend, node);
+    if (!backend->eh_unwind)
+      LLVMAddAttributeAtIndex(
+          f, LLVMAttributeFunctionIndex,
+          LLVMCreateEnumAttribute(
+              backend->context, LLVMGetEnumAttributeKindForName("nounwind", 8),
+              0));
     free(pt);
   }
 }
@@ -9190,6 +13127,18 @@ void llvm_backend_compile(LLVMBackend *backend, ASTNode_C *node) {
 
   enter_scope(backend);
 
+  // `--allocator=system`: pick the runtime's object allocator before the
+  // first allocation (TULPAR_ALLOCATOR_SYSTEM, runtime/tulpar_alloc.h).
+  if (backend->alloc_system) {
+    LLVMTypeRef sel_params[] = {backend->int32_type};
+    LLVMTypeRef sel_type =
+        LLVMFunctionType(backend->void_type, sel_params, 1, 0);
+    LLVMValueRef sel =
+        LLVMAddFunction(backend->module, "tulpar_alloc_select", sel_type);
+    LLVMValueRef sel_args[] = {LLVMConstInt(backend->int32_type, 1, 0)};
+    LLVMBuildCall2(backend->builder, sel_type, sel, sel_args, 1, "");
+  }
+
   // Initialize Runtime
   LLVMBuildCall2(backend->builder,
                  LLVMGlobalGetValueType(backend->func_aot_runtime_init),
@@ -9348,14 +13297,19 @@ void llvm_backend_compile(LLVMBackend *backend, ASTNode_C *node) {
     }
   }
 
+  SpecData *sd = static_cast<SpecData *>(backend->spec_data);
   if (node->statements) {
     // Pass 2: Main loop logic (Execute Statements)
+    std::unordered_set<std::string> spec_ints;
+    collect_spec_int_locals(backend, node, spec_ints);
+    sd->int_locals = &spec_ints;
     for (int i = 0; i < node->statement_count; i++) {
       if (node->statements[i]->type != AST_FUNCTION_DECL &&
           node->statements[i]->type != AST_IMPORT) {
         codegen_statement(backend, node->statements[i]);
       }
     }
+    sd->int_locals = nullptr;
   }
 
   // Drain the async event loop before exit so spawned-but-unawaited
@@ -9370,6 +13324,23 @@ void llvm_backend_compile(LLVMBackend *backend, ASTNode_C *node) {
   if (!LLVMGetBasicBlockTerminator(LLVMGetInsertBlock(backend->builder)))
     LLVMBuildRet(backend->builder, LLVMConstInt(backend->int32_type, 0, 0));
 
+  report_arc_elision(backend, "main");
+  emit_spec_clones(backend);
+  const char *v = getenv("TULPAR_AOT_VERBOSE");
+  if (v && *v && *v != '0') {
+    printf("[AOT] Escape analysis: %d container literal(s) on the stack.\n",
+           backend->stack_container_total);
+    printf("[AOT] ARC elision: %d refcount op(s) removed.\n",
+           backend->arc_elided_total);
+    printf("[AOT] Int clones: %d call site(s) specialised (%d in the "
+           "stdlib), %d clone(s) emitted.\n",
+           sd->calls, sd->stdlib_calls, sd->clones);
+    RangeData *rd = static_cast<RangeData *>(backend->range_data);
+    printf("[AOT] Bounds checks: %d typed-array access(es) proved in range "
+           "(%d loop(s) at compile time, %d behind a loop guard).\n",
+           rd->elided, rd->static_loops, rd->versioned_loops);
+  }
+
   exit_scope(backend);
 }
 
@@ -9390,8 +13361,11 @@ int llvm_backend_emit_ir_file(LLVMBackend *backend, const char *filename) {
 // LLVMRelocDefault for executables and LLVMRelocPIC for the Android
 // shared-library objects (a non-PIC x86_64 object aborts the .so link with
 // "relocation R_X86_64_32 cannot be used against local symbol").
-static int emit_object_with_triple(LLVMBackend *backend, const char *filename,
-                                   char *triple, LLVMRelocMode reloc) {
+//
+// Takes the module rather than the backend so the parallel path
+// (llvm_parallel.cpp) can emit each partition from its own thread/context.
+int llvm_emit_module_object(LLVMModuleRef module, const char *filename,
+                            char *triple, LLVMRelocMode reloc) {
   LLVMTargetRef target;
   char *error = nullptr;
   if (LLVMGetTargetFromTriple(triple, &target, &error) != 0)
@@ -9399,12 +13373,12 @@ static int emit_object_with_triple(LLVMBackend *backend, const char *filename,
   LLVMTargetMachineRef machine = LLVMCreateTargetMachine(
       target, triple, "generic", "", LLVMCodeGenLevelDefault, reloc,
       LLVMCodeModelDefault);
-  LLVMSetModuleDataLayout(backend->module, LLVMCreateTargetDataLayout(machine));
-  LLVMSetTarget(backend->module, triple);
+  LLVMSetModuleDataLayout(module, LLVMCreateTargetDataLayout(machine));
+  LLVMSetTarget(module, triple);
 
   // Verify module
   char *verify_error = nullptr;
-  if (LLVMVerifyModule(backend->module, LLVMPrintMessageAction,
+  if (LLVMVerifyModule(module, LLVMPrintMessageAction,
                        &verify_error) != 0) {
     fprintf(stderr, "Global module verification failed: %s\n", verify_error);
     LLVMDisposeMessage(verify_error);
@@ -9412,7 +13386,7 @@ static int emit_object_with_triple(LLVMBackend *backend, const char *filename,
     // return 1;
   }
 
-  if (LLVMTargetMachineEmitToFile(machine, backend->module, filename,
+  if (LLVMTargetMachineEmitToFile(machine, module, filename,
                                   LLVMObjectFile, &error) != 0) {
     fprintf(stderr, "Error emitting object file: %s\n", error);
     return 1;
@@ -9422,6 +13396,11 @@ static int emit_object_with_triple(LLVMBackend *backend, const char *filename,
   return 0;
 }
 
+static int emit_object_with_triple(LLVMBackend *backend, const char *filename,
+                                   char *triple, LLVMRelocMode reloc) {
+  return llvm_emit_module_object(backend->module, filename, triple, reloc);
+}
+
 int llvm_backend_emit_object(LLVMBackend *backend, const char *filename) {
   char *triple;
   if (backend->target_web) {
@@ -9464,9 +13443,8 @@ int llvm_backend_emit_object_for_triple(LLVMBackend *backend,
                                  LLVMCreateMessage(triple_str), LLVMRelocPIC);
 }
 
-// Optimization Pass enabling using new LLVM Pass Manager
-void llvm_backend_optimize(LLVMBackend *backend) {
-  // Create pass builder options
+// Shared pass-builder options for the release pipeline.
+static LLVMPassBuilderOptionsRef create_release_pass_options() {
   LLVMPassBuilderOptionsRef options = LLVMCreatePassBuilderOptions();
 
   // Set optimization options
@@ -9482,36 +13460,17 @@ void llvm_backend_optimize(LLVMBackend *backend) {
   LLVMPassBuilderOptionsSetLoopUnrolling(options, 1);
   LLVMPassBuilderOptionsSetForgetAllSCEVInLoopUnroll(options, 0);
   LLVMPassBuilderOptionsSetMergeFunctions(options, 1);
+  return options;
+}
 
-  // Pipeline level: O3 by default. In `--debug` mode we drop to a
-  // verifier-only pass so the IR reaches the object emitter exactly
-  // as codegen produced it — inlining / vectorisation would otherwise
-  // shred the source-line mapping a debugger needs (gdb steps through
-  // basic blocks that no longer correspond 1:1 to .tpr lines). Plan
-  // 07 PR 3 — landed alongside the per-function DISubprogram /
-  // per-statement debug-location work in subsequent PRs.
-  //
-  // Full default<O3> pipeline. The previous `default<O2>,function(...)`
-  // string was effectively dead code — every emitted typed function had
-  // `optnone` set, so no pass could touch it (see codegen_native_func_def).
-  // With that gag removed, the pipeline level actually matters; O3 buys
-  // inliner aggressiveness, vectorization, and SCC-based passes that move
-  // fib/struct workloads materially closer to gcc -O2.
-  // Debug builds keep the codegen IR 1:1 (verifier-only) so the debugger's
-  // line mapping survives; inlining/vectorization would shred it.
-  if (backend->emit_debug_info) {
-    LLVMErrorRef error =
-        LLVMRunPasses(backend->module, "verify", nullptr, options);
-    if (error) {
-      char *msg = LLVMGetErrorMessage(error);
-      fprintf(stderr,
-              tulpar::i18n::tr_for_en("[AOT] Warning: Optimization failed: %s\n"),
-              msg);
-      LLVMDisposeErrorMessage(msg);
-    }
-    LLVMDisposePassBuilderOptions(options);
-    return;
-  }
+// Optimize `codegen_ir` (owned by `context`) with the graduated O3 → O1
+// fallback ladder below. Returns the module to keep using — either a new,
+// optimized module (codegen_ir is disposed) or codegen_ir itself when every
+// level produced invalid IR. Thread-safe as long as each caller brings its
+// own LLVMContext (llvm_parallel.cpp runs one per partition).
+LLVMModuleRef llvm_optimize_module(LLVMModuleRef codegen_ir,
+                                   LLVMContextRef context, int quiet) {
+  LLVMPassBuilderOptionsRef options = create_release_pass_options();
 
   // Release builds: optimize with a GRADUATED FALLBACK. The codegen output
   // verifies clean, but some LLVM versions' aggressive O3 passes (InstCombine
@@ -9520,7 +13479,6 @@ void llvm_backend_optimize(LLVMBackend *backend) {
   // the result type. Instead of dropping straight to unoptimized, try
   // O3 → O2 → O1 on a fresh clone of the codegen IR and keep the first level
   // that verifies clean; only use the unoptimized module if every level fails.
-  LLVMModuleRef codegen_ir = backend->module;
 
   // A "safe" options set with the forced vectorizers / mergefunc / unroll left
   // OFF. On some LLVM versions those aggressive passes are what turn our
@@ -9573,7 +13531,7 @@ void llvm_backend_optimize(LLVMBackend *backend) {
           LLVMMemoryBufferRef buf = LLVMCreateMemoryBufferWithMemoryRangeCopy(
               ir_text, strlen(ir_text), "tulpar_reparse");
           char *perr = nullptr;
-          if (LLVMParseIRInContext(backend->context, buf, &reparsed, &perr) !=
+          if (LLVMParseIRInContext(context, buf, &reparsed, &perr) !=
               0) {
             if (reparsed) {
               LLVMDisposeModule(reparsed);
@@ -9615,22 +13573,60 @@ void llvm_backend_optimize(LLVMBackend *backend) {
               "[AOT] Note: aggressive O3 IR invalid on this toolchain; "
               "optimized with %s%s instead.\n",
               att_level[chosen_idx], att_safe[chosen_idx] ? " (safe)" : "");
-    } else if (!backend->quiet) {
+    } else if (!quiet) {
       const char *v = getenv("TULPAR_AOT_VERBOSE");
       if (v && *v && *v != '0')
         printf("[AOT] Optimizations (O3) applied successfully.\n");
     }
     LLVMDisposeModule(codegen_ir);
-    backend->module = chosen;
   } else {
     fprintf(stderr, "%s",
             tulpar::i18n::tr_for_en(
                 "[AOT] Warning: optimization produced invalid IR at every "
                 "level; using the unoptimized module for this compile.\n"));
-    // keep codegen_ir (still backend->module) as-is
+    // keep codegen_ir as-is
+    chosen = codegen_ir;
   }
 
   LLVMDisposePassBuilderOptions(options);
+  return chosen;
+}
+
+// Optimization Pass enabling using new LLVM Pass Manager
+void llvm_backend_optimize(LLVMBackend *backend) {
+  // Pipeline level: O3 by default. In `--debug` mode we drop to a
+  // verifier-only pass so the IR reaches the object emitter exactly
+  // as codegen produced it — inlining / vectorisation would otherwise
+  // shred the source-line mapping a debugger needs (gdb steps through
+  // basic blocks that no longer correspond 1:1 to .tpr lines). Plan
+  // 07 PR 3 — landed alongside the per-function DISubprogram /
+  // per-statement debug-location work in subsequent PRs.
+  //
+  // Full default<O3> pipeline. The previous `default<O2>,function(...)`
+  // string was effectively dead code — every emitted typed function had
+  // `optnone` set, so no pass could touch it (see codegen_native_func_def).
+  // With that gag removed, the pipeline level actually matters; O3 buys
+  // inliner aggressiveness, vectorization, and SCC-based passes that move
+  // fib/struct workloads materially closer to gcc -O2.
+  // Debug builds keep the codegen IR 1:1 (verifier-only) so the debugger's
+  // line mapping survives; inlining/vectorization would shred it.
+  if (backend->emit_debug_info) {
+    LLVMPassBuilderOptionsRef options = create_release_pass_options();
+    LLVMErrorRef error =
+        LLVMRunPasses(backend->module, "verify", nullptr, options);
+    if (error) {
+      char *msg = LLVMGetErrorMessage(error);
+      fprintf(stderr,
+              tulpar::i18n::tr_for_en("[AOT] Warning: Optimization failed: %s\n"),
+              msg);
+      LLVMDisposeErrorMessage(msg);
+    }
+    LLVMDisposePassBuilderOptions(options);
+    return;
+  }
+
+  backend->module =
+      llvm_optimize_module(backend->module, backend->context, backend->quiet);
 }
 
 // ============================================================================
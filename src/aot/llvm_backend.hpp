@@ -30,6 +30,16 @@ typedef struct {
   // name so field access can resolve fields against the layout. NULL for
   // regular VMValue locals (the historical default path).
   char *struct_type_name;
+  // TYPE_ARRAY_INT / TYPE_ARRAY_FLOAT / TYPE_ARRAY_BOOL when this local is
+  // an unboxed typed array (TYPE_CUSTOM: an inline array of native structs):
+  // `value` then points at its {data, count, capacity} header alloca instead
+  // of a VMValue (see typed_array_* in llvm_backend.cpp). TYPE_UNKNOWN for
+  // every other local.
+  DataType typed_array;
+  // String-builder local (see STRING BUILDER LOCALS in llvm_backend.cpp):
+  // alloca of the `owner` pointer handed to aot_string_append_inplace.
+  // NULL for every other local.
+  LLVMValueRef str_owner;
   int is_captured;
   int slot_index;
   LLVMValueRef env_ptr;
@@ -80,8 +90,36 @@ typedef struct {
   char **field_names;    // declaration-ordered (matches LLVM struct order)
   DataType *field_types;
   int field_count;
+  LLVMValueRef json_fn;  // tulpar.tojson.<name>, emitted on first toJson use
 } StructTypeEntry;
 
+// One unboxed typed-array local of the function being emitted. Collected up
+// front by codegen_func_def so every `return` can release every buffer, even
+// one declared later in the body (loops).
+typedef struct {
+  struct ASTNode_C *decl; // the AST_VARIABLE_DECL that owns the header
+  LLVMValueRef header;    // alloca of {ptr data, i32 count, i32 capacity}
+  DataType kind;          // TYPE_ARRAY_INT / _FLOAT / _BOOL, or TYPE_CUSTOM
+  StructTypeEntry *elem_struct; // TYPE_CUSTOM: element struct (inline AoS)
+} TypedArraySlot;
+
+// One container literal local that never escapes its function (see STACK
+// CONTAINER LOCALS): header and inline slots are allocas in the entry block.
+typedef struct {
+  struct ASTNode_C *decl; // the AST_VARIABLE_DECL whose literal lives here
+  LLVMValueRef header;    // alloca of the ObjArray / ObjObject header
+  LLVMValueRef slots;     // alloca of [cap x VMValue] (items / values)
+  LLVMValueRef keys;      // alloca of [cap x ptr] (objects only)
+  int cap;
+} StackContainerSlot;
+
+// `tulpar build --checks=...` (see RANGE-PROVED ARRAY ACCESSES in
+// llvm_backend.cpp). RELEASE is the default: a typed-array bounds check the
+// loop range proves is dropped, every other one stays. FULL keeps every
+// bounds check and adds signed-overflow checks to int + - *. NONE emits no
+// typed-array bounds checks at all (an out-of-range index is undefined).
+typedef enum { CHECKS_RELEASE = 0, CHECKS_FULL = 1, CHECKS_NONE = 2 } ChecksMode;
+
 typedef struct {
   LLVMContextRef context;
   LLVMModuleRef module;
@@ -132,6 +170,24 @@ typedef struct {
   LLVMValueRef func_aot_array_get_raw_fast; // Direct access via ObjArray*
   LLVMValueRef func_aot_array_set_raw_fast; // Direct set via ObjArray*
 
+  // Unboxed typed arrays (`arrayInt` / `arrayFloat` / `arrayBool` locals)
+  LLVMValueRef func_tulpar_array_grow;    // (ptr data, i64 cap, i64 size) -> ptr
+  LLVMValueRef func_tulpar_array_release; // (ptr data) -> void
+  LLVMValueRef func_aot_typed_array_box;  // (ptr data, i64 n, i64 kind) -> VMValue
+  LLVMValueRef func_aot_typed_array_oob;  // () -> void, prints the OOB error
+  LLVMValueRef func_aot_int_overflow;     // () -> void, --checks=full only
+
+  // Non-escaping container literals (header + slots in the caller's frame)
+  LLVMValueRef func_aot_stack_array_init;  // (ptr hdr, ptr items, i32 cap) -> ptr
+  LLVMValueRef func_aot_stack_object_init; // (ptr hdr, ptr keys, ptr vals, i32 cap) -> ptr
+
+  // Compiled toJson for native structs (see tulpar.tojson.* emission)
+  LLVMValueRef func_aot_json_buf_begin; // () -> ptr builder
+  LLVMValueRef func_aot_json_buf_raw;   // (ptr b, ptr bytes, i64 len) -> void
+  LLVMValueRef func_aot_json_buf_int;   // (ptr b, i64 v) -> void
+  LLVMValueRef func_aot_json_buf_bool;  // (ptr b, i64 v) -> void
+  LLVMValueRef func_aot_json_buf_end;   // (ptr b) -> VMValue string
+
   LLVMTypeRef vm_binary_op_type; // Explicitly store type
 
   LLVMValueRef current_function;
@@ -144,6 +200,32 @@ typedef struct {
   FunctionEntry functions[1024];
   int function_count;
 
+  // Unboxed typed-array locals of the function codegen_func_def is emitting
+  // (`typed_array_fn`). Points into that call's stack frame; NULL outside a
+  // user function, and lambdas never match typed_array_fn.
+  TypedArraySlot *typed_arrays;
+  int typed_array_count;
+  LLVMValueRef typed_array_fn;
+
+  // `str` locals of that same function that append in place
+  // (collect_str_builder_decls); NULL outside a user function.
+  struct ASTNode_C **str_builders;
+  int str_builder_count;
+  LLVMValueRef str_builder_fn;
+
+  // Container literal locals of that same function that live on the stack
+  // (collect_stack_container_decls); NULL outside a user function.
+  StackContainerSlot *stack_containers;
+  int stack_container_count;
+  LLVMValueRef stack_container_fn;
+  int stack_container_total; // whole module, for TULPAR_AOT_VERBOSE
+
+  // Ownership ops dropped at compile time (see OWNERSHIP MOVES): in the
+  // function being emitted and in the whole module, for TULPAR_AOT_VERBOSE.
+  int arc_moves_fn;
+  int arc_elided_fn;
+  int arc_elided_total;
+
   StructTypeEntry struct_types[64];
   int struct_type_count;
 
@@ -156,6 +238,10 @@ typedef struct {
   // (bkz. tame_link_flags() / aot_pipeline.cpp). calloc ile 0 başlar.
   int uses_tame;
 
+  // >0 while an embedded stdlib module (`import "test"`, "wings", ...) is
+  // being compiled; TULPAR_AOT_VERBOSE splits its counts out.
+  int stdlib_depth;
+
   // Hedef web (wasm32-unknown-emscripten). declare_runtime_functions
   // llvm_backend_create İÇİNDE koştuğu için bu alan doğrudan set edilemez:
   // create'ten önce llvm_backend_set_target_web(1) çağrılır (aot_set_target_web
@@ -164,6 +250,15 @@ typedef struct {
   // llvm_values.cpp) ve emit'te triple'ı wasm32'ye çevirir.
   int target_web;
 
+  // `--allocator=system` — main() switches the runtime object allocator to
+  // malloc before aot_runtime_init (runtime/tulpar_alloc.h). 0 = default.
+  int alloc_system;
+
+  // `--checks=` level (ChecksMode) and the `unchecked { }` nesting depth of
+  // the statement being emitted; > 0 drops bounds / overflow checks.
+  int checks_mode;
+  int unchecked_depth;
+
   // Plan 02 PR3 multi-file paket: when processing an import statement
   // from inside a multi-file bundled package, sibling imports (`import
   // "util"` from `tulpar_modules/foo/main.tpr`) need to find the
@@ -211,6 +306,9 @@ typedef struct {
   LLVMValueRef func_aot_arena_save;
   LLVMValueRef func_aot_arena_restore;
   LLVMValueRef func_aot_arena_drop;
+  LLVMValueRef func_aot_arc_stats; // () -> json, deferred-free counters
+  LLVMValueRef func_aot_arc_drain; // () -> int, objects freed
+  LLVMValueRef func_aot_arena_stats; // () -> json, arena blocks / trims
   LLVMValueRef func_aot_now_iso8601;
   LLVMValueRef func_aot_format_iso8601;
   LLVMValueRef func_aot_parse_iso8601;
@@ -226,6 +324,11 @@ typedef struct {
   LLVMValueRef func_aot_keys;
   LLVMValueRef func_aot_object_clone;
   LLVMValueRef func_aot_persist; // persist(value) -> deep malloc'd copy (survives arena_restore)
+  LLVMValueRef func_aot_persist_move; // last use into a global: aot_persist unless already permanent
+  LLVMValueRef func_aot_cow;         // copy a shared permanent array/object before a global write
+  LLVMValueRef func_aot_cow_element; // element on a global write path, made unique in place
+  LLVMValueRef func_aot_alias;       // mark a node a local aliases: aot_persist copies it
+  LLVMValueRef func_arc_share_vmvalue; // (ptr VMValue) -> void, atomic ARC from here on
   LLVMValueRef func_aot_http_request;
   LLVMValueRef func_aot_http_request_h;
   LLVMValueRef func_aot_http_request_async; // (method,url,body) -> promise
@@ -238,6 +341,7 @@ typedef struct {
   LLVMValueRef func_aot_write_file;
   LLVMValueRef func_aot_append_file;
   LLVMValueRef func_aot_file_exists;
+  LLVMValueRef func_aot_file_delete;
   LLVMValueRef func_aot_sys_run; // sys_run(cmd)->int : run shell cmd, exit code
   LLVMValueRef func_aot_sha256;
   LLVMValueRef func_aot_password_hash;
@@ -254,6 +358,13 @@ typedef struct {
   LLVMValueRef func_setjmp;
   // llvm.frameaddress.p0 — Windows only, feeds _setjmpex's 2nd arg.
   LLVMValueRef func_frameaddress;
+  // Zero-cost EH (runtime/tulpar_eh.h): try = invoke + landingpad, throw =
+  // C++ exception. Set per target by llvm_eh_uses_unwind; when 0 the
+  // setjmp fields above are used instead and these stay NULL.
+  int eh_unwind;
+  LLVMValueRef func_aot_eh_catch;   // aot_eh_catch(ptr) -> VMValue
+  LLVMValueRef eh_personality;      // __gxx_personality_v0
+  LLVMValueRef eh_typeinfo;         // @_ZTI11TulparThrow (catch clause)
 
   // Time functions
   LLVMValueRef func_aot_clock_ms;
@@ -293,6 +404,7 @@ typedef struct {
 
   // Fast String Operations
   LLVMValueRef func_aot_string_concat_fast;
+  LLVMValueRef func_aot_string_append_inplace; // (ptr slot, ptr b, ptr owner) -> void
 
   // StringBuilder Functions
   LLVMValueRef func_aot_stringbuilder_new;
@@ -329,6 +441,9 @@ typedef struct {
   // Native route lookup (exact + pattern) — replaces the per-request
   // Tulpar `_find_route_with_params` loop with a single C call.
   LLVMValueRef func_aot_wings_find_route;
+  // response_model() serialiser: declared fields only, keys pre-escaped
+  // once per schema (replaces the Tulpar filter + toJson pass).
+  LLVMValueRef func_aot_wings_encode_model;
   // Permanent-storage copy of a string (escapes the per-request arena).
   // Wings response cache uses this to pin cached wire bytes past the
   // serve loop's `arena_restore`.
@@ -438,6 +553,7 @@ typedef struct {
 
   // Range Function
   LLVMValueRef func_aot_range;
+  LLVMValueRef func_aot_range_step;
 
   // SQLite Database Functions
   LLVMValueRef func_aot_db_open;
@@ -448,6 +564,16 @@ typedef struct {
   LLVMValueRef func_aot_db_query_params;
   LLVMValueRef func_aot_db_last_insert_id;
   LLVMValueRef func_aot_db_error;
+  LLVMValueRef func_aot_db_cursor;
+  LLVMValueRef func_aot_db_next;
+  LLVMValueRef func_aot_db_close_cursor;
+  LLVMValueRef func_aot_db_query_columns;
+  LLVMValueRef func_aot_db_prepare;
+  LLVMValueRef func_aot_db_stmt_query;
+  LLVMValueRef func_aot_db_stmt_execute;
+  LLVMValueRef func_aot_db_stats;
+  LLVMValueRef func_aot_db_executemany;
+  LLVMValueRef func_aot_db_group_commit;
 
   // Type Checking Functions
   LLVMValueRef func_aot_typeof;
@@ -508,7 +634,8 @@ typedef struct {
   int loop_depth;
 
   // Number of setjmp try-frames pushed (aot_try_push) and not yet popped at
-  // the current codegen position, per function. Any control transfer that
+  // the current codegen position, per function. Always 0 under eh_unwind
+  // (landing pads keep no runtime handler stack). Any control transfer that
   // exits a try scope abnormally — `return` (pops all), `break`/`continue`
   // (pops down to the loop's try_depth_at_entry) — must emit matching
   // aot_try_pop() calls, or the runtime handler stack keeps a jmp_buf whose
@@ -566,11 +693,21 @@ typedef struct {
   // ("HATA (lib/router.tpr:245): ..."). May be null for stdin/embedded input.
   const char *source_filename;
   void *capture_data;
+  // SpecData (llvm_backend.cpp, SPECIALISED CLONES): untyped functions
+  // with an unboxed int clone and the call sites that use it.
+  void *spec_data;
+  // RangeData (llvm_backend.cpp, RANGE-PROVED ARRAY ACCESSES): index ranges
+  // proved by the enclosing `for` loops, plus the elision counters.
+  void *range_data;
 } LLVMBackend;
 
 LLVMBackend *llvm_backend_create(const char *module_name);
 // Web hedefini create'ten ÖNCE kur (bkz. target_web alanının notu).
 void llvm_backend_set_target_web(int enable);
+// `--allocator=system` (1): main() başında tulpar_alloc_select(1) üretilir.
+void llvm_backend_set_allocator(int use_system);
+// `--checks=full|release|none` (ChecksMode); create'ten önce kurulur.
+void llvm_backend_set_checks(int mode);
 
 // Emit an object for an EXPLICIT target triple (Android cross-compile:
 // aarch64-linux-android34 / x86_64-linux-android34). Initializes both the
@@ -584,6 +721,16 @@ void llvm_backend_destroy(LLVMBackend *backend);
 void llvm_backend_compile(LLVMBackend *backend, ASTNode_C *node);
 void llvm_backend_optimize(LLVMBackend *backend);
 int llvm_backend_emit_object(LLVMBackend *backend, const char *filename);
+
+// Module-level halves of optimize / emit_object. They touch nothing but the
+// module and its context, so llvm_parallel.cpp can run them on worker
+// threads, one LLVMContext per partition. llvm_optimize_module returns the
+// module to keep (the input is disposed when a new one is returned);
+// llvm_emit_module_object takes ownership of `triple`.
+LLVMModuleRef llvm_optimize_module(LLVMModuleRef module, LLVMContextRef context,
+                                   int quiet);
+int llvm_emit_module_object(LLVMModuleRef module, const char *filename,
+                            char *triple, LLVMRelocMode reloc);
 int llvm_backend_emit_ir_file(LLVMBackend *backend, const char *filename);
 
 // Plan 07 PR 2: open / close the LLVMDIBuilder bundle. Call init once
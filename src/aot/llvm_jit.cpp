@@ -0,0 +1,158 @@
+#include "llvm_jit.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <llvm-c/Analysis.h>
+#include <llvm-c/BitReader.h>
+#include <llvm-c/BitWriter.h>
+#include <llvm-c/Core.h>
+#include <llvm-c/LLJIT.h>
+#include <llvm-c/Orc.h>
+#include <llvm-c/TargetMachine.h>
+#include <llvm-c/Transforms/PassBuilder.h>
+
+static void jit_report(LLVMBackend *backend, const char *what,
+                       LLVMErrorRef err) {
+  char *msg = LLVMGetErrorMessage(err);
+  const char *v = getenv("TULPAR_AOT_VERBOSE");
+  if (v && *v && *v != '0')
+    fprintf(stderr, "[JIT] %s: %s\n", what, msg);
+  LLVMDisposeErrorMessage(msg);
+  (void)backend;
+}
+
+// Reasons the module can't run in-process — see llvm_jit.hpp.
+static int module_needs_aot(LLVMBackend *backend) {
+  if (backend->uses_tame) return 1;
+  for (LLVMValueRef g = LLVMGetFirstGlobal(backend->module); g;
+       g = LLVMGetNextGlobal(g)) {
+    if (LLVMIsThreadLocal(g)) return 1;
+  }
+  return 0;
+}
+
+// Rebuild backend->module inside `ctx` (bitcode round-trip — cheap next to
+// codegen) so the JIT can own it through a ThreadSafeModule.
+static LLVMModuleRef copy_module_into(LLVMModuleRef src, LLVMContextRef ctx) {
+  LLVMMemoryBufferRef bc = LLVMWriteBitcodeToMemoryBuffer(src);
+  if (!bc) return nullptr;
+  LLVMModuleRef out = nullptr;
+  if (LLVMParseBitcodeInContext2(ctx, bc, &out) != 0) out = nullptr;
+  LLVMDisposeMemoryBuffer(bc);
+  return out;
+}
+
+// default<O1> on a clone; keep it only if it verifies (same guard as the
+// AOT ladder in llvm_optimize_module, minus the O3/O2 rungs — a script run
+// is startup-bound, and O1 is where LLVM's pipeline stops costing more
+// than it saves).
+static LLVMModuleRef optimize_o1(LLVMModuleRef mod) {
+  LLVMModuleRef trial = LLVMCloneModule(mod);
+  LLVMPassBuilderOptionsRef opts = LLVMCreatePassBuilderOptions();
+  LLVMErrorRef err = LLVMRunPasses(trial, "default<O1>", nullptr, opts);
+  LLVMDisposePassBuilderOptions(opts);
+  if (err) {
+    LLVMConsumeError(err);
+    LLVMDisposeModule(trial);
+    return mod;
+  }
+  char *verr = nullptr;
+  if (LLVMVerifyModule(trial, LLVMReturnStatusAction, &verr) != 0) {
+    if (verr) LLVMDisposeMessage(verr);
+    LLVMDisposeModule(trial);
+    return mod;
+  }
+  if (verr) LLVMDisposeMessage(verr);
+  LLVMDisposeModule(mod);
+  return trial;
+}
+
+int llvm_backend_jit_run(LLVMBackend *backend, int *exit_code) {
+  if (module_needs_aot(backend)) return 1;
+
+  LLVMInitializeNativeTarget();
+  LLVMInitializeNativeAsmPrinter();
+  LLVMInitializeNativeAsmParser();
+
+  // Host target machine at CodeGenOpt::Less: instruction selection is the
+  // other big startup cost next to the IR pipeline.
+  char *triple = LLVMGetDefaultTargetTriple();
+  LLVMTargetRef target = nullptr;
+  char *terr = nullptr;
+  if (LLVMGetTargetFromTriple(triple, &target, &terr) != 0) {
+    if (terr) LLVMDisposeMessage(terr);
+    LLVMDisposeMessage(triple);
+    return -1;
+  }
+  char *cpu = LLVMGetHostCPUName();
+  char *features = LLVMGetHostCPUFeatures();
+  LLVMTargetMachineRef tm = LLVMCreateTargetMachine(
+      target, triple, cpu, features, LLVMCodeGenLevelLess, LLVMRelocDefault,
+      LLVMCodeModelJITDefault);
+  LLVMDisposeMessage(triple);
+  LLVMDisposeMessage(cpu);
+  LLVMDisposeMessage(features);
+
+  LLVMOrcLLJITBuilderRef jb = LLVMOrcCreateLLJITBuilder();
+  LLVMOrcLLJITBuilderSetJITTargetMachineBuilder(
+      jb, LLVMOrcJITTargetMachineBuilderCreateFromTargetMachine(tm));
+  LLVMOrcLLJITRef jit = nullptr;
+  LLVMErrorRef err = LLVMOrcCreateLLJIT(&jit, jb);
+  if (err) {
+    jit_report(backend, "create", err);
+    return -1;
+  }
+
+  // Runtime symbols (aot_*, vm_*, libc, sqlite, OpenSSL) resolve against
+  // the running driver process — its exported copy of the runtime.
+  LLVMOrcDefinitionGeneratorRef gen = nullptr;
+  err = LLVMOrcCreateDynamicLibrarySearchGeneratorForProcess(
+      &gen, LLVMOrcLLJITGetGlobalPrefix(jit), nullptr, nullptr);
+  if (err) {
+    jit_report(backend, "process symbols", err);
+    LLVMOrcDisposeLLJIT(jit);
+    return -1;
+  }
+  LLVMOrcJITDylibAddGenerator(LLVMOrcLLJITGetMainJITDylib(jit), gen);
+
+  LLVMOrcThreadSafeContextRef tsc = LLVMOrcCreateNewThreadSafeContext();
+  LLVMModuleRef mod = copy_module_into(
+      backend->module, LLVMOrcThreadSafeContextGetContext(tsc));
+  if (!mod) {
+    LLVMOrcDisposeThreadSafeContext(tsc);
+    LLVMOrcDisposeLLJIT(jit);
+    return -1;
+  }
+  mod = optimize_o1(mod);
+  LLVMOrcThreadSafeModuleRef tsm = LLVMOrcCreateNewThreadSafeModule(mod, tsc);
+  LLVMOrcDisposeThreadSafeContext(tsc); // the module keeps it alive
+  err = LLVMOrcLLJITAddLLVMIRModule(jit, LLVMOrcLLJITGetMainJITDylib(jit),
+                                    tsm);
+  if (err) {
+    jit_report(backend, "add module", err);
+    LLVMOrcDisposeLLJIT(jit);
+    return -1;
+  }
+
+  // Lookup materialises (compiles + links) the whole module. An unresolved
+  // runtime symbol fails HERE, before any user code ran, so AOT can still
+  // take over cleanly.
+  LLVMOrcExecutorAddress main_addr = 0;
+  err = LLVMOrcLLJITLookup(jit, &main_addr, "main");
+  if (err || !main_addr) {
+    if (err) jit_report(backend, "lookup main", err);
+    LLVMOrcDisposeLLJIT(jit);
+    return 1;
+  }
+
+  int (*entry)(void) = (int (*)(void))(uintptr_t)main_addr;
+  fflush(stdout);
+  *exit_code = entry();
+  fflush(stdout);
+  // The JIT is deliberately NOT disposed: listen_pool / spawn workers may
+  // still be parked inside JIT'd code, and the driver exits right after.
+  return 0;
+}
@@ -0,0 +1,30 @@
+#ifndef LLVM_JIT_H
+#define LLVM_JIT_H
+
+#include "llvm_backend.hpp"
+
+// In-process execution for `tulpar run --jit` / TULPAR_RUN_MODE=jit.
+//
+// The default run path writes /tmp/.tulpar_run, links it and execs it —
+// a linker pass plus a process spawn per script, and unusable on hosts that
+// mount /tmp noexec. The JIT path hands the codegen module to ORC LLJIT
+// instead: it is optimised at O1 (startup beats peak throughput for
+// scripts), compiled with CodeGenOpt::Less, and its runtime calls bind to
+// the tulpar driver's OWN copy of the runtime (runtime_bindings.cpp & co.
+// are linked into the driver and exported via ENABLE_EXPORTS), so no
+// libtulpar_runtime.a lookup happens at all.
+//
+// Returns:
+//   0  — the program ran; its `main` return value is in *exit_code.
+//   1  — this module can't be JIT'd here (thread-local globals — LLJIT has
+//        no ELF TLS support on our minimum LLVM —, tame/raylib calls that
+//        only exist in libtulpar_tame.a, or a symbol the driver doesn't
+//        export). Nothing ran; the caller should fall back to AOT.
+//  -1  — JIT setup failed before running (also safe to fall back).
+//
+// backend->module itself is left untouched — a bitcode copy is rebuilt in
+// the JIT's own ThreadSafeContext — so llvm_backend_destroy works as usual
+// and an AOT fallback can reuse the same backend.
+int llvm_backend_jit_run(LLVMBackend *backend, int *exit_code);
+
+#endif
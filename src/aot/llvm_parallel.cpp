@@ -0,0 +1,122 @@
+#include "llvm_parallel.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+
+#include <llvm-c/BitReader.h>
+#include <llvm-c/Core.h>
+#include <llvm-c/TargetMachine.h>
+
+// LLVM's C++ headers are not warning-clean under our flags
+// (ModuleSummaryIndex.h, via BitcodeWriter.h, trips -Wuninitialized).
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#ifndef __clang__
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#endif
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+
+// Below this many function definitions per partition the split/serialise
+// overhead and the lost cross-partition inlining outweigh the parallel
+// O3 + codegen win (hello-world + stdlib glue is ~40 functions).
+static const unsigned kMinFunctionsPerPartition = 48;
+
+static unsigned count_defined_functions(LLVMModuleRef m) {
+  unsigned n = 0;
+  for (LLVMValueRef f = LLVMGetFirstFunction(m); f; f = LLVMGetNextFunction(f))
+    if (!LLVMIsDeclaration(f)) n++;
+  return n;
+}
+
+int llvm_backend_emit_objects_parallel(LLVMBackend *backend, const char *base,
+                                       int jobs,
+                                       std::vector<std::string> *objects) {
+  if (jobs < 2 || backend->emit_debug_info || backend->target_web) return 1;
+
+  unsigned defined = count_defined_functions(backend->module);
+  unsigned parts = (unsigned)jobs;
+  if (defined / kMinFunctionsPerPartition < parts)
+    parts = defined / kMinFunctionsPerPartition;
+  if (parts < 2) return 1;
+
+  // 1) Split on the caller's thread (SplitModule clones into the source
+  //    context) and serialise each partition to bitcode right away, so the
+  //    workers can rebuild it in a private context. Local symbols referenced
+  //    across partitions are externalised by SplitModule itself.
+  std::vector<llvm::SmallVector<char, 0>> bitcode;
+  llvm::SplitModule(
+      *llvm::unwrap(backend->module), parts,
+      [&](std::unique_ptr<llvm::Module> part) {
+        bitcode.emplace_back();
+        llvm::raw_svector_ostream os(bitcode.back());
+        llvm::WriteBitcodeToFile(*part, os);
+      },
+      /*PreserveLocals=*/false);
+
+  // Target setup must happen once, before any worker creates a machine.
+  LLVMInitializeNativeTarget();
+  LLVMInitializeNativeAsmParser();
+  LLVMInitializeNativeAsmPrinter();
+
+  objects->clear();
+  for (size_t i = 0; i < bitcode.size(); i++) {
+    char name[300];
+    snprintf(name, sizeof(name), "%s.p%zu.o", base, i);
+    objects->push_back(name);
+  }
+
+  // 2) Optimise + emit on a small pool. Output names are fixed by partition
+  //    index above, so scheduling order never leaks into the result.
+  std::atomic<size_t> next(0);
+  std::atomic<int> failed(0);
+  int quiet = backend->quiet;
+  auto worker = [&]() {
+    for (;;) {
+      size_t i = next.fetch_add(1);
+      if (i >= bitcode.size()) return;
+      LLVMContextRef ctx = LLVMContextCreate();
+      LLVMMemoryBufferRef buf = LLVMCreateMemoryBufferWithMemoryRange(
+          bitcode[i].data(), bitcode[i].size(), "tulpar_partition", 0);
+      LLVMModuleRef mod = nullptr;
+      if (LLVMParseBitcodeInContext2(ctx, buf, &mod) != 0 || !mod) {
+        LLVMDisposeMemoryBuffer(buf);
+        LLVMContextDispose(ctx);
+        failed.store(1);
+        continue;
+      }
+      LLVMDisposeMemoryBuffer(buf);
+      mod = llvm_optimize_module(mod, ctx, quiet);
+      if (llvm_emit_module_object(mod, (*objects)[i].c_str(),
+                                  LLVMGetDefaultTargetTriple(),
+                                  LLVMRelocDefault) != 0)
+        failed.store(1);
+      LLVMDisposeModule(mod);
+      LLVMContextDispose(ctx);
+    }
+  };
+
+  unsigned nthreads = (unsigned)jobs < bitcode.size() ? (unsigned)jobs
+                                                       : (unsigned)bitcode.size();
+  std::vector<std::thread> pool;
+  for (unsigned t = 1; t < nthreads; t++) pool.emplace_back(worker);
+  worker(); // the calling thread is worker 0
+  for (std::thread &th : pool) th.join();
+
+  if (failed.load()) {
+    for (const std::string &o : *objects) remove(o.c_str());
+    objects->clear();
+    return -1;
+  }
+  return 0;
+}
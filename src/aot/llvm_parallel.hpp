@@ -0,0 +1,29 @@
+#ifndef LLVM_PARALLEL_H
+#define LLVM_PARALLEL_H
+
+#include "llvm_backend.hpp"
+#include <string>
+#include <vector>
+
+// Parallel optimise + object emission (`tulpar build -j N`,
+// TULPAR_BUILD_JOBS=N).
+//
+// Splits the (unoptimised) backend->module into partitions, hands each one
+// to a worker thread with its own LLVMContext, runs the usual O3 → O1
+// fallback ladder (llvm_optimize_module) and emits `<base>.p<i>.o`.
+// Partitioning is name-hash based (llvm::SplitModule), so the same source
+// always yields the same partitions and byte-identical objects regardless
+// of thread scheduling; the object list is returned in partition order.
+//
+// Returns 0 on success (`objects` filled), 1 when the module is too small
+// for splitting to pay off (nothing written — caller runs the serial
+// optimize + emit_object path), -1 on failure.
+//
+// Trade-off: inlining cannot cross partition boundaries. Small programs
+// never split (see the threshold in llvm_parallel.cpp); for the large
+// services this targets, the O3 wall-clock win dominates.
+int llvm_backend_emit_objects_parallel(LLVMBackend *backend, const char *base,
+                                       int jobs,
+                                       std::vector<std::string> *objects);
+
+#endif
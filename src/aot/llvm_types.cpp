@@ -44,44 +44,36 @@ void llvm_init_types(LLVMBackend *backend) {
   backend->ret_pair_type = LLVMStructTypeInContext(ctx, ret_pair_elements, 2, 0);
 
   // --- Define Obj Body ---
-  // struct Obj {
-  //   ObjType type;             // offset 0 (i32)
-  //   padding 4 bytes           // offset 4
-  //   struct Obj *next;         // offset 8 (ptr)
-  //   uint8_t arena_allocated;  // offset 16
-  //   padding 3 bytes           // offset 17
-  //   int32_t ref_count;        // offset 20
-  //   uint8_t is_moved;         // offset 24
-  //   padding 7 bytes           // offset 25
+  // struct Obj {                // 8 bytes
+  //   uint8_t type;             // offset 0
+  //   uint8_t arena_allocated;  // offset 1
+  //   uint8_t is_shared;        // offset 2
+  //   uint8_t is_moved;         // offset 3
+  //   int32_t ref_count;        // offset 4
   // }
   LLVMTypeRef obj_elements[] = {
-      LLVMInt32TypeInContext(ctx),           // type (enum)
-      LLVMArrayType(LLVMInt8TypeInContext(ctx), 4),
-      LLVMPointerType(backend->obj_type, 0), // next
-      LLVMInt8TypeInContext(ctx),            // arena_allocated
-      LLVMArrayType(LLVMInt8TypeInContext(ctx), 3),
-      LLVMInt32TypeInContext(ctx),           // ref_count
-      LLVMInt8TypeInContext(ctx),            // is_moved
-      LLVMArrayType(LLVMInt8TypeInContext(ctx), 7)
+      LLVMInt8TypeInContext(ctx), // type (ObjType)
+      LLVMInt8TypeInContext(ctx), // arena_allocated
+      LLVMInt8TypeInContext(ctx), // is_shared
+      LLVMInt8TypeInContext(ctx), // is_moved
+      LLVMInt32TypeInContext(ctx) // ref_count
   };
-  LLVMStructSetBody(backend->obj_type, obj_elements, 8, 0);
+  LLVMStructSetBody(backend->obj_type, obj_elements, 5, 0);
 
   // --- Define ObjString Body ---
   // struct ObjString {
-  //   Obj obj;
-  //   int length;
-  //   int capacity;
-  //   char *chars;
-  //   uint32_t hash;
-  //   padding 4 bytes
+  //   Obj obj;                  // offset 0
+  //   int length;               // offset 8
+  //   int capacity;             // offset 12
+  //   uint32_t hash;            // offset 16
+  //   char chars[];             // offset 20 (inline bytes)
   // }
   LLVMTypeRef str_elements[] = {
       backend->obj_type,           // obj header
       LLVMInt32TypeInContext(ctx), // length
       LLVMInt32TypeInContext(ctx), // capacity
-      backend->ptr_type,           // chars static_cast<char*>
       LLVMInt32TypeInContext(ctx), // hash
-      LLVMArrayType(LLVMInt8TypeInContext(ctx), 4)
+      LLVMArrayType(LLVMInt8TypeInContext(ctx), 0) // chars
   };
-  LLVMStructSetBody(backend->obj_string_type, str_elements, 6, 0);
+  LLVMStructSetBody(backend->obj_string_type, str_elements, 5, 0);
 }
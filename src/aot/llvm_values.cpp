@@ -4,6 +4,7 @@
 #include <llvm-c/Core.h>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 
 // VMValue Construction Helpers
 // VMValue struct layout: {i32 type, [4 x i8] pad, i64 as}
@@ -15,6 +16,36 @@
 //   VM_VAL_VOID  = 3
 //   VM_VAL_OBJ   = 4
 
+// Generic tag / payload access for code that handles any VMValue kind.
+// `tag` is an i32 VMValueType, `payload` the i64 `as` union.
+LLVMValueRef llvm_vm_make(LLVMBackend *backend, LLVMValueRef tag,
+                          LLVMValueRef payload, const char *name) {
+  LLVMValueRef s = LLVMGetUndef(backend->vm_value_type);
+  s = LLVMBuildInsertValue(backend->builder, s, tag, 0, "");
+  return LLVMBuildInsertValue(backend->builder, s, payload, 2, name);
+}
+
+LLVMValueRef llvm_vm_tag(LLVMBackend *backend, LLVMValueRef vm_val,
+                         const char *name) {
+  return LLVMBuildExtractValue(backend->builder, vm_val, 0, name);
+}
+
+LLVMValueRef llvm_vm_payload(LLVMBackend *backend, LLVMValueRef vm_val,
+                             const char *name) {
+  return LLVMBuildExtractValue(backend->builder, vm_val, 2, name);
+}
+
+LLVMValueRef llvm_vm_int_payload(LLVMBackend *backend, LLVMValueRef vm_val,
+                                 const char *name) {
+  return LLVMBuildExtractValue(backend->builder, vm_val, 2, name);
+}
+
+// Same payload, new tag (e.g. BOOL → INT for `int x = <bool expr>`).
+LLVMValueRef llvm_vm_retag(LLVMBackend *backend, LLVMValueRef vm_val,
+                           LLVMValueRef tag, const char *name) {
+  return LLVMBuildInsertValue(backend->builder, vm_val, tag, 0, name);
+}
+
 // Create tagged INT value: {type: 0 (VM_VAL_INT), pad, as: i64}
 LLVMValueRef llvm_vm_val_int(LLVMBackend *backend, int64_t value) {
   LLVMValueRef padding =
@@ -5,6 +5,24 @@
 #include <llvm-c/Core.h>
 #include <cstdint>
 
+// Generic VMValue access: `tag` is an i32 VMValueType, `payload` the i64
+// union as the struct form stores it (float bits, int, 0/1, pointer). Code
+// that isn't constructing a specific kind goes through these, never through
+// raw extractvalue/insertvalue indices, so the layout lives in one place.
+LLVMValueRef llvm_vm_make(LLVMBackend *backend, LLVMValueRef tag,
+                          LLVMValueRef payload, const char *name);
+LLVMValueRef llvm_vm_tag(LLVMBackend *backend, LLVMValueRef vm_val,
+                         const char *name);
+LLVMValueRef llvm_vm_payload(LLVMBackend *backend, LLVMValueRef vm_val,
+                             const char *name);
+LLVMValueRef llvm_vm_retag(LLVMBackend *backend, LLVMValueRef vm_val,
+                           LLVMValueRef tag, const char *name);
+// Payload of a value the caller treats as int/bool (typed slots, native
+// args, int returns). Same bits as llvm_vm_payload; separate so int readers
+// say what they expect.
+LLVMValueRef llvm_vm_int_payload(LLVMBackend *backend, LLVMValueRef vm_val,
+                                 const char *name);
+
 // Helpers to build VMValue structs in IR
 LLVMValueRef llvm_vm_val_int(LLVMBackend *backend, int64_t value);
 LLVMValueRef llvm_vm_val_bool(LLVMBackend *backend, int value);
@@ -0,0 +1,9731 @@
+// ============================================
+// Tulpar Embedded Standard Libraries
+// ============================================
+// AUTO-GENERATED BY CMAKE - DO NOT EDIT!
+// Source files are in lib/ folder
+// ============================================
+
+#ifndef TULPAR_EMBEDDED_LIBS_H
+#define TULPAR_EMBEDDED_LIBS_H
+
+#include <string.h>
+
+// ========================================
+// lib/wings.tpr
+// ========================================
+static const char *EMBEDDED_WINGS =
+"// ============================================\n"
+    "// Tulpar Wings - Fast API Framework\n"
+    "// \"Give your API wings!\" 🪶\n"
+    "//\n"
+    "// HTTP request parsing and response building are delegated to native\n"
+    "// runtime builtins (`http_parse_request`, `http_create_response`,\n"
+    "// `http_status_text`) so the hot path runs in C++ rather than the\n"
+    "// interpreter. Handlers receive the parsed request via the `_request`\n"
+    "// global (with .method, .path, .raw_path, .query, .headers, .body fields).\n"
+    "// ============================================\n"
+    "\n"
+    "array _routes = [];\n"
+    "json _request = {};\n"
+    "\n"
+    "// Global middleware chain (run before every dispatch). Each entry is a\n"
+    "// function NAME (string). A middleware is `func mw(req)` that either returns a\n"
+    "// response dict (with `_status`, e.g. `unauthorized(...)`) to SHORT-CIRCUIT the\n"
+    "// request, or `{}` to continue to the next middleware / the route handler. It\n"
+    "// may mutate `req` (e.g. `req[\"user\"] = ...`) for downstream handlers. Empty\n"
+    "// chain = zero per-request cost.\n"
+    "array _middleware = [];\n"
+    "\n"
+    "// Active route-group prefix. `group(prefix, fn)` sets this around a batch of\n"
+    "// registrations so every get/post/put/del path is prepended with it; nested\n"
+    "// groups concatenate. Empty = no prefix.\n"
+    "str _route_prefix = \"\";\n"
+    "\n"
+    "// Resolved dependency values for the in-flight request (Wings DI). Written once\n"
+    "// per dispatch from the route's `deps`, read by the handler via `dep(name)`.\n"
+    "// Thread-local at the LLVM level (see global_needs_tls) so listen_pool workers\n"
+    "// don't share it — mirrors `_request`.\n"
+    "json _wings_deps = {};\n"
+    "\n"
+    "// Default response headers shared across the whole server lifetime.\n"
+    "// Pulled out of the per-connection block so the arena-reset path\n"
+    "// (`arena_save`/`arena_restore` in listen()) can roll a request's\n"
+    "// allocations back without freeing this object.\n"
+    "json _default_headers = {\n"
+    "    \"Access-Control-Allow-Origin\": \"*\",\n"
+    "    \"Access-Control-Allow-Methods\": \"GET, POST, PUT, DELETE, OPTIONS\",\n"
+    "    \"Access-Control-Allow-Headers\": \"Content-Type, Authorization\"\n"
+    "};\n"
+    "\n"
+    "// Server start time + per-request counters. Wings updates these on\n"
+    "// every request; `metrics_handler` reads them. Keep them tiny — adding\n"
+    "// a histogram would require either runtime support or a Tulpar-side\n"
+    "// reduction over an array, both bigger than warranted today.\n"
+    "//\n"
+    "// The four `_wings_requests_*` counters are race-free under parallel\n"
+    "// `listen_async` workers: the AOT codegen recognises the\n"
+    "// `name = name + delta` pattern against this whitelist and lowers it\n"
+    "// to `atomicrmw add monotonic` so concurrent threads cannot drop\n"
+    "// increments. `_wings_started_at` is written exactly once at startup\n"
+    "// and so doesn't need atomic treatment.\n"
+    "int _wings_started_at = 0;\n"
+    "// OpenAPI document metadata, surfaced at /openapi.json and /docs. Override\n"
+    "// with docs_info(title, version) before serve(); defaults below otherwise.\n"
+    "str _wings_title = \"Tulpar Wings API\";\n"
+    "str _wings_version = \"1.0.0\";\n"
+    "// When 1, /openapi.json advertises a bearerAuth (JWT) security scheme. Set\n"
+    "// automatically by jwt_guard(), or manually via docs_security(\"bearer\").\n"
+    "int _wings_docs_bearer = 0;\n"
+    "int _wings_requests_total = 0;\n"
+    "int _wings_requests_2xx = 0;\n"
+    "int _wings_requests_4xx = 0;\n"
+    "int _wings_requests_5xx = 0;\n"
+    "\n"
+    "// Per-request body cap. The native `http_recv_request` helper grows\n"
+    "// its receive buffer dynamically up to this ceiling, so values up to\n"
+    "// ~hundreds of MB are reachable without paying for memory you don't\n"
+    "// use on small requests. 16 MiB is a reasonable default for API\n"
+    "// uploads (package tarballs, multi-record JSON imports). Override\n"
+    "// via `TULPAR_HTTP_MAX_BODY=<bytes>` for stricter or looser caps.\n"
+    "int _wings_max_body_bytes = 16777216;\n"
+    "\n"
+    "// HTTP_QUIET cache. The per-request access log lookup used to call\n"
+    "// `env(\"TULPAR_HTTP_QUIET\")` on every served request — one getenv\n"
+    "// syscall + one string allocation per request, in three serve loops\n"
+    "// (sync, async, evented). Env vars don't change after process start,\n"
+    "// so we snapshot the truthiness once in `_wings_apply_env_config` and\n"
+    "// the serve loops read the int directly.\n"
+    "int _wings_quiet = 0;\n"
+    "// Colorized access log + banner. On by default; snapshot off when NO_COLOR is\n"
+    "// set (https://no-color.org) so piped/redirected logs stay clean.\n"
+    "int _wings_color = 1;\n"
+    "// Status of the most recently dispatched request, so the serve loop can log\n"
+    "// `method path status` AFTER the handler has run (the status isn't known\n"
+    "// before dispatch). _wings_dispatch_cached writes this at every return.\n"
+    "int _wings_last_status = 200;\n"
+    "\n"
+    "// Pulls config overrides from the environment. Today honours\n"
+    "// `TULPAR_HTTP_MAX_BODY` (bytes) and `TULPAR_HTTP_QUIET` (any\n"
+    "// non-empty value silences the per-request access log). Future\n"
+    "// env-based knobs land here too so listen()/listen_async() stay clean.\n"
+    "// Below 1 KiB is rejected — the static recv buffer is sized to fit at\n"
+    "// least the header block, anything smaller would just churn rejections.\n"
+    "func _wings_apply_env_config() {\n"
+    "    str cap_str = env(\"TULPAR_HTTP_MAX_BODY\");\n"
+    "    if (length(cap_str) > 0) {\n"
+    "        int parsed = toInt(cap_str);\n"
+    "        if (parsed >= 1024) {\n"
+    "            _wings_max_body_bytes = parsed;\n"
+    "        }\n"
+    "    }\n"
+    "    // Snapshot HTTP_QUIET once so the per-request access log check is\n"
+    "    // a single int comparison instead of a getenv syscall + length()\n"
+    "    // round-trip on every served request.\n"
+    "    if (length(env(\"TULPAR_HTTP_QUIET\")) > 0) {\n"
+    "        _wings_quiet = 1;\n"
+    "    }\n"
+    "    // NO_COLOR (any value) disables ANSI colors in the banner + access log.\n"
+    "    if (length(env(\"NO_COLOR\")) > 0) {\n"
+    "        _wings_color = 0;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// ----- Terminal colors -----------------------------------------------------\n"
+    "// Wrap `text` in an ANSI SGR sequence (`code`), or return it untouched when\n"
+    "// colors are disabled. `code` is the part between ESC[ and m, e.g. \"1;32\".\n"
+    "func _wings_c(str code, str text) {\n"
+    "    if (_wings_color == 0) {\n"
+    "        return text;\n"
+    "    }\n"
+    "    return \"\\e[\" + code + \"m\" + text + \"\\e[0m\";\n"
+    "}\n"
+    "\n"
+    "// SGR color per HTTP method, so GET/POST/PUT/DELETE read at a glance.\n"
+    "func _wings_method_color(str method) {\n"
+    "    if (method == \"GET\")     { return \"1;32\"; } // green\n"
+    "    if (method == \"POST\")    { return \"1;33\"; } // yellow\n"
+    "    if (method == \"PUT\")     { return \"1;34\"; } // blue\n"
+    "    if (method == \"DELETE\")  { return \"1;31\"; } // red\n"
+    "    if (method == \"PATCH\")   { return \"1;35\"; } // magenta\n"
+    "    if (method == \"HEAD\")    { return \"1;36\"; } // cyan\n"
+    "    if (method == \"OPTIONS\") { return \"1;90\"; } // dim\n"
+    "    return \"1;37\";                              // white\n"
+    "}\n"
+    "\n"
+    "// SGR color per status class: 2xx green, 3xx cyan, 4xx yellow, 5xx red.\n"
+    "func _wings_status_color(int status) {\n"
+    "    if (status >= 500) { return \"1;31\"; } // red\n"
+    "    if (status >= 400) { return \"1;33\"; } // yellow\n"
+    "    if (status >= 300) { return \"1;36\"; } // cyan\n"
+    "    if (status >= 200) { return \"1;32\"; } // green\n"
+    "    return \"1;37\";                        // white (1xx / unknown)\n"
+    "}\n"
+    "\n"
+    "// Format a byte count for the access log: 248B / 1.5KB / 2.3MB.\n"
+    "func _wings_fmt_bytes(int n) {\n"
+    "    if (n < 1024) {\n"
+    "        return toString(n) + \"B\";\n"
+    "    }\n"
+    "    if (n < 1048576) {\n"
+    "        int kb = (n * 10) / 1024;\n"
+    "        return toString(kb / 10) + \".\" + toString(mod(kb, 10)) + \"KB\";\n"
+    "    }\n"
+    "    int mb = (n * 10) / 1048576;\n"
+    "    return toString(mb / 10) + \".\" + toString(mod(mb, 10)) + \"MB\";\n"
+    "}\n"
+    "\n"
+    "// Format request latency. Sub-millisecond requests (the common case for\n"
+    "// an AOT server) render in microseconds — 142µs — so the speed is visible\n"
+    "// instead of collapsing to \"0.0ms\"; everything else is ms with one decimal.\n"
+    "func _wings_fmt_ms(float ms) {\n"
+    "    if (ms < 0.0) { ms = 0.0; }\n"
+    "    if (ms < 1.0) {\n"
+    "        int us = toInt(round(ms * 1000.0)); // microseconds, as a true int\n"
+    "        return toString(us) + \"µs\";\n"
+    "    }\n"
+    "    int t = toInt(round(ms * 10.0)); // tenths of a ms, as a true int\n"
+    "    return toString(t / 10) + \".\" + toString(mod(t, 10)) + \"ms\";\n"
+    "}\n"
+    "\n"
+    "// SGR color by latency: <50ms green, <500ms yellow, else red — so a slow\n"
+    "// request stands out in the log even when method and status read normal.\n"
+    "func _wings_latency_color(float ms) {\n"
+    "    if (ms >= 500.0) { return \"1;31\"; } // red\n"
+    "    if (ms >= 50.0)  { return \"1;33\"; } // yellow\n"
+    "    return \"1;32\";                      // green\n"
+    "}\n"
+    "\n"
+    "// HH:MM:SS (UTC) sliced out of the ISO-8601 clock, for the log prefix.\n"
+    "func _wings_now_hms() {\n"
+    "    str iso = now_iso8601();          // YYYY-MM-DDTHH:MM:SSZ\n"
+    "    if (length(iso) < 19) {\n"
+    "        return \"\";\n"
+    "    }\n"
+    "    return substring(iso, 11, 19);\n"
+    "}\n"
+    "\n"
+    "// One access-log line:\n"
+    "//   [HH:MM:SS] METHOD STATUS /path  → 12.4ms  - 248B\n"
+    "// timestamp dim, method/status colored by kind, latency colored by\n"
+    "// threshold, size dim. `ms` is wall time since the request was parsed,\n"
+    "// `bytes` the size of the response written back to the socket. Method is\n"
+    "// padded to 7 cols (DELETE + a space) so status codes line up.\n"
+    "func _wings_log_request(str method, str path, int status, float ms, int bytes) {\n"
+    "    if (_wings_quiet == 1) {\n"
+    "        return 0;\n"
+    "    }\n"
+    "    str m = method;\n"
+    "    while (length(m) < 7) {\n"
+    "        m = m + \" \";\n"
+    "    }\n"
+    "    str ts   = _wings_c(\"1;90\", \"[\" + _wings_now_hms() + \"] \");\n"
+    "    str meth = _wings_c(_wings_method_color(method), m);\n"
+    "    str st   = _wings_c(_wings_status_color(status), toString(status));\n"
+    "    str lat  = _wings_c(_wings_latency_color(ms), \"→ \" + _wings_fmt_ms(ms));\n"
+    "    str sz   = _wings_c(\"1;90\", \"- \" + _wings_fmt_bytes(bytes));\n"
+    "    print(\"  \" + ts + meth + st + \" \" + path + \"  \" + lat + \"  \" + sz);\n"
+    "    return 0;\n"
+    "}\n"
+    "\n"
+    "// Bind address used by every listener variant. Env-driven, default\n"
+    "// `0.0.0.0` so containerised / production deployments work without\n"
+    "// configuration. PR #141 had this hardcoded to `127.0.0.1` to keep\n"
+    "// Windows Firewall from prompting on every fresh dev binary, but that\n"
+    "// broke every Docker deploy of wings: inside the container 127.0.0.1\n"
+    "// is the *container's* own loopback, not the host's, so\n"
+    "// `docker run -p 8080:8080` forwards traffic to the container which\n"
+    "// never reaches a 127.0.0.1-only listener — the host sees connection\n"
+    "// refused / 502 Bad Gateway through any reverse proxy.\n"
+    "//\n"
+    "// Local-only callers (dev loops, smoke tests, benchmarks) set\n"
+    "// `TULPAR_WINGS_HOST=127.0.0.1` to keep the firewall-prompt-free\n"
+    "// path; production / containers leave it unset for the safe default.\n"
+    "func _wings_bind_host() {\n"
+    "    str h = env(\"TULPAR_WINGS_HOST\");\n"
+    "    if (length(h) == 0) {\n"
+    "        return \"0.0.0.0\";\n"
+    "    }\n"
+    "    return h;\n"
+    "}\n"
+    "\n"
+    "// Tulpar's signature default port: 8484 — ASCII 'T' (binary 01010100) is 84,\n"
+    "// so \"84-84\" is the Tulpar port. Used when serve()/listen() are called with no\n"
+    "// port (the arg is padded to 0 by the compiler's default-argument support).\n"
+    "int _WINGS_DEFAULT_PORT = 8484;\n"
+    "\n"
+    "// Resolve a listening socket from a requested port. Returns\n"
+    "// {\"fd\": <int>, \"port\": <int>} where fd < 0 means \"could not bind\".\n"
+    "//   port <= 0 : no port was given -> use the default; if it's busy, walk up\n"
+    "//               (8484, 8485, ...) so a second app on the box still starts.\n"
+    "//   port >  0 : an explicit port -> bind it once; fd < 0 means it's taken and\n"
+    "//               the caller tells the user (we don't silently move an explicit\n"
+    "//               port — that would hide a conflict).\n"
+    "func _wings_bind(int port) {\n"
+    "    str host = _wings_bind_host();\n"
+    "    if (port <= 0) {\n"
+    "        int p = _WINGS_DEFAULT_PORT;\n"
+    "        int tries = 0;\n"
+    "        while (tries < 20) {\n"
+    "            int fd = socket_server(host, p);\n"
+    "            if (fd >= 0) {\n"
+    "                return {\"fd\": fd, \"port\": p};\n"
+    "            }\n"
+    "            p = p + 1;\n"
+    "            tries = tries + 1;\n"
+    "        }\n"
+    "        return {\"fd\": -1, \"port\": _WINGS_DEFAULT_PORT};\n"
+    "    }\n"
+    "    return {\"fd\": socket_server(host, port), \"port\": port};\n"
+    "}\n"
+    "\n"
+    "// Shared \"couldn't bind\" message. `port` is the value the user asked for\n"
+    "// (0 = default path). Prints actionable guidance instead of a bare error.\n"
+    "func _wings_bind_failed(int port) {\n"
+    "    if (port > 0) {\n"
+    "        print(\"  ⚠ Port \" + toString(port) + \" kullanımda (başka bir süreç tutuyor).\");\n"
+    "        print(\"    Farklı bir port deneyin, örn:  serve(\" + toString(port + 1) + \")\");\n"
+    "    } else {\n"
+    "        print(\"  ⚠ Varsayılan port \" + toString(_WINGS_DEFAULT_PORT) +\n"
+    "              \" ve sonraki 20 port da dolu.\");\n"
+    "        print(\"    Açık bir port belirtin, örn:  serve(9090)\");\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Cache table for `cached_get`. Indexed by route position in `_routes`\n"
+    "// — kept the same length as the routes array, so lookup is a plain\n"
+    "// O(1) array read. Entries default to \"\" (uncached); the first\n"
+    "// request to a cached route writes the wire bytes here and every\n"
+    "// subsequent request short-circuits to a `socket_send` of these bytes.\n"
+    "//\n"
+    "// Why parallel array instead of a json-map keyed by index-string:\n"
+    "// json map lookup is a linear key scan, which would become the\n"
+    "// per-request cache lookup cost itself. Array index access is O(1).\n"
+    "array _wings_cache_wires = [];\n"
+    "\n"
+    "// Parallel to `_wings_cache_wires`: the strong ETag (quoted, sha256-derived)\n"
+    "// of the cached body for `cached_get` routes. Written once at cache\n"
+    "// population; read on every cache hit to answer `If-None-Match` with a 304.\n"
+    "// Same parallel-index invariant: every registration pushes a \"\" placeholder.\n"
+    "array _wings_cache_etags = [];\n"
+    "\n"
+    "// ----- Route registration --------------------------------------------------\n"
+    "// Every registration pushes a `\"\"` placeholder to `_wings_cache_wires`\n"
+    "// at the same time so the parallel-index invariant holds — even for\n"
+    "// non-cached routes, where the placeholder is simply never written.\n"
+    "func get(str path, str handler) {\n"
+    "    push(_routes, {\"method\": \"GET\", \"path\": _route_prefix + path, \"handler\": handler});\n"
+    "    push(_wings_cache_wires, \"\");\n"
+    "    push(_wings_cache_etags, \"\");\n"
+    "}\n"
+    "\n"
+    "func post(str path, str handler) {\n"
+    "    push(_routes, {\"method\": \"POST\", \"path\": _route_prefix + path, \"handler\": handler});\n"
+    "    push(_wings_cache_wires, \"\");\n"
+    "    push(_wings_cache_etags, \"\");\n"
+    "}\n"
+    "\n"
+    "func put(str path, str handler) {\n"
+    "    push(_routes, {\"method\": \"PUT\", \"path\": _route_prefix + path, \"handler\": handler});\n"
+    "    push(_wings_cache_wires, \"\");\n"
+    "    push(_wings_cache_etags, \"\");\n"
+    "}\n"
+    "\n"
+    "func del(str path, str handler) {\n"
+    "    push(_routes, {\"method\": \"DELETE\", \"path\": _route_prefix + path, \"handler\": handler});\n"
+    "    push(_wings_cache_wires, \"\");\n"
+    "    push(_wings_cache_etags, \"\");\n"
+    "}\n"
+    "\n"
+    "// PATCH — partial update. The dispatcher matches on the method string, so this\n"
+    "// is a first-class verb (the router/find_route compares methods generically).\n"
+    "func patch(str path, str handler) {\n"
+    "    push(_routes, {\"method\": \"PATCH\", \"path\": _route_prefix + path, \"handler\": handler});\n"
+    "    push(_wings_cache_wires, \"\");\n"
+    "    push(_wings_cache_etags, \"\");\n"
+    "}\n"
+    "\n"
+    "// HEAD — like GET but the framework's response writer omits the body for HEAD\n"
+    "// requests at the transport layer; the handler may return its normal payload.\n"
+    "func head(str path, str handler) {\n"
+    "    push(_routes, {\"method\": \"HEAD\", \"path\": _route_prefix + path, \"handler\": handler});\n"
+    "    push(_wings_cache_wires, \"\");\n"
+    "    push(_wings_cache_etags, \"\");\n"
+    "}\n"
+    "\n"
+    "// OPTIONS — preflight / capability probe (commonly paired with CORS headers).\n"
+    "func options(str path, str handler) {\n"
+    "    push(_routes, {\"method\": \"OPTIONS\", \"path\": _route_prefix + path, \"handler\": handler});\n"
+    "    push(_wings_cache_wires, \"\");\n"
+    "    push(_wings_cache_etags, \"\");\n"
+    "}\n"
+    "\n"
+    "// Register a global middleware by function name. Runs (in registration order)\n"
+    "// before every route's handler across all serve modes.\n"
+    "//\n"
+    "//   func require_auth(req) {\n"
+    "//       if (length(req[\"headers\"][\"authorization\"]) == 0) {\n"
+    "//           return unauthorized(\"token required\");   // short-circuit -> 401\n"
+    "//       }\n"
+    "//       return {};                                    // continue\n"
+    "//   }\n"
+    "//   use(\"require_auth\");\n"
+    "func use(str mw) {\n"
+    "    push(_middleware, mw);\n"
+    "}\n"
+    "\n"
+    "// Register a batch of routes under a common path prefix. `register_fn` is the\n"
+    "// NAME of a function that calls get/post/... ; every path it registers is\n"
+    "// prepended with `prefix`. The prefix is restored afterwards, so groups nest.\n"
+    "//\n"
+    "//   func api_v1() {\n"
+    "//       get(\"/users\", \"list_users\");      // -> /api/v1/users\n"
+    "//       post(\"/users\", \"create_user\");    // -> /api/v1/users\n"
+    "//   }\n"
+    "//   group(\"/api/v1\", \"api_v1\");\n"
+    "func group(str prefix, str register_fn) {\n"
+    "    str _saved = _route_prefix;\n"
+    "    _route_prefix = _saved + prefix;        // nested groups concatenate\n"
+    "    call(register_fn, 0);                   // run the registrations\n"
+    "    _route_prefix = _saved;                 // restore\n"
+    "}\n"
+    "\n"
+    "// ----- Dependency injection (FastAPI `Depends`-style) ----------------------\n"
+    "// Attach a dependency function NAME to the most recently registered route.\n"
+    "// Before the handler runs, each dependency is called with `req`; its return\n"
+    "// value is injected and read by the handler via `dep(\"name\")`. A dependency may\n"
+    "// short-circuit by returning a response dict (`_status` set, e.g.\n"
+    "// `unauthorized(...)`), exactly like middleware — but per-route and value-producing.\n"
+    "//\n"
+    "//   func current_user(req) {\n"
+    "//       str t = req[\"headers\"][\"Authorization\"];\n"
+    "//       if (length(t) == 0) { return unauthorized(\"token gerekli\"); }\n"
+    "//       return {\"id\": 1, \"name\": \"Ada\"};\n"
+    "//   }\n"
+    "//   func profile(req) { return ok(dep(\"current_user\")); }\n"
+    "//   get(\"/profile\", \"profile\");\n"
+    "//   depends(\"current_user\");\n"
+    "func depends(str dep_fn) {\n"
+    "    int last = length(_routes) - 1;\n"
+    "    if (last >= 0) {\n"
+    "        json dl = _routes[last][\"deps\"];\n"
+    "        if (typeof(dl) != \"array\") {\n"
+    "            dl = [];\n"
+    "        }\n"
+    "        push(dl, dep_fn);\n"
+    "        _routes[last][\"deps\"] = dl;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Read a resolved dependency value inside a handler.\n"
+    "func dep(str name) {\n"
+    "    return _wings_deps[name];\n"
+    "}\n"
+    "\n"
+    "// Register a GET route whose response is cached at the wire-byte level\n"
+    "// after the first hit. The handler is called *once*, the resulting\n"
+    "// wire bytes (full HTTP response including headers + body) are stored\n"
+    "// in `_wings_cache_wires[idx]`, and every subsequent request is served\n"
+    "// from the cache via a single socket_send — skipping handler dispatch,\n"
+    "// toJson, and response framing entirely. Per-request latency on the\n"
+    "// cached path is effectively one syscall.\n"
+    "//\n"
+    "// Use when the handler's output is a pure function of (method, path)\n"
+    "// — i.e. doesn't depend on `_request`, query params, cookies, body,\n"
+    "// or wall-clock time. Examples that fit: static JSON payloads, API\n"
+    "// version banners, config dumps that change only at restart. Examples\n"
+    "// that DON'T fit: anything reading `timestamp()` / `now_iso8601()`\n"
+    "// (the cache freezes that value), and anything that mutates\n"
+    "// per-request state.\n"
+    "//\n"
+    "// No invalidation API yet — re-cache happens at process restart.\n"
+    "func cached_get(str path, str handler) {\n"
+    "    push(_routes, {\"method\": \"GET\", \"path\": _route_prefix + path, \"handler\": handler, \"cached\": 1});\n"
+    "    push(_wings_cache_wires, \"\");\n"
+    "    push(_wings_cache_etags, \"\");\n"
+    "}\n"
+    "\n"
+    "// ----- Request validation --------------------------------------------------\n"
+    "// Attach a JSON-body schema to the most recently registered route. One schema\n"
+    "// drives BOTH the auto-422 check (run before the handler — invalid bodies\n"
+    "// never reach your code) AND the OpenAPI requestBody under /docs.\n"
+    "//\n"
+    "//   post(\"/users\", create_user);\n"
+    "//   body_schema({\"name\": \"str\", \"age?\": \"int\"});   // trailing ? = optional\n"
+    "//\n"
+    "// A field value is EITHER a simple type string OR a rich spec object:\n"
+    "//   Types: \"str\", \"int\", \"float\", \"num\" (int|float), \"bool\", \"array\",\n"
+    "//   \"object\", \"json\" (object|array), \"any\" (present, any type).\n"
+    "//   Rich spec {type, ...constraints} by type:\n"
+    "//     str            -> \"min\"/\"max\" (length), \"regex\" (full-string pattern)\n"
+    "//     int/float/num  -> \"min\"/\"max\" (value)\n"
+    "//     array          -> \"min\"/\"max\" (length), \"items\" (spec applied per element)\n"
+    "//     object         -> \"schema\" (nested {field: spec} map; recurses)\n"
+    "//\n"
+    "//   body_schema({\n"
+    "//     \"name\":  {\"type\":\"str\",   \"min\":3, \"max\":20},\n"
+    "//     \"email\": {\"type\":\"str\",   \"regex\":\"^[^@]+@[^@]+$\"},\n"
+    "//     \"age?\":  {\"type\":\"int\",   \"min\":0, \"max\":120},\n"
+    "//     \"tags\":  {\"type\":\"array\", \"items\":\"str\", \"min\":1},\n"
+    "//     \"addr\":  {\"type\":\"object\",\"schema\":{\"city\":\"str\",\n"
+    "//                  \"zip\":{\"type\":\"str\",\"regex\":\"^[0-9]{5}$\"}}}\n"
+    "//   });\n"
+    "//\n"
+    "// A missing required field, type mismatch, or violated constraint yields a 422\n"
+    "// listing every offender; nested/array failures use dotted paths:\n"
+    "//   422 {\"error\":\"validation failed\",\n"
+    "//        \"fields\":{\"name\":\"min length 3\",\"addr.zip\":\"must match ^[0-9]{5}$\",\n"
+    "//                  \"tags.0\":\"expected str, got int\"}}\n"
+    "func body_schema(json schema) {\n"
+    "    int last = length(_routes) - 1;\n"
+    "    if (last >= 0) {\n"
+    "        _routes[last][\"schema\"] = schema;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// ----- Response model (output shaping) -------------------------------------\n"
+    "// Symmetric counterpart to body_schema: attach a schema to the most recently\n"
+    "// registered route to FILTER successful handler output to only the declared\n"
+    "// fields. Anything not listed (internal/secret keys like password_hash,\n"
+    "// _internal) is dropped before serialization — so handlers can return their\n"
+    "// full row without leaking. `_`-prefixed control keys (_status/_raw/...) are\n"
+    "// always preserved; errors (status >= 400) bypass filtering so {error:...}\n"
+    "// isn't stripped. Works on a single object or an array of objects.\n"
+    "//\n"
+    "//   get(\"/users/:id\", \"show_user\");\n"
+    "//   response_model({\"id\": \"int\", \"name\": \"str\"});   // password etc. dropped\n"
+    "func response_model(json schema) {\n"
+    "    int last = length(_routes) - 1;\n"
+    "    if (last >= 0) {\n"
+    "        _routes[last][\"response_model\"] = schema;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Keep only `_`-control keys + the schema's declared fields (trailing `?` on a\n"
+    "// key is stripped). Returns a fresh object.\n"
+    "func _wings_filter_obj(json schema, json obj) {\n"
+    "    json out = {};\n"
+    "    // Preserve ONLY the known control keys — NOT arbitrary `_`-prefixed data\n"
+    "    // (e.g. a user field named `_internal` must still be dropped if undeclared).\n"
+    "    if (_wings_has_key(obj, \"_status\"))       { out[\"_status\"] = obj[\"_status\"]; }\n"
+    "    if (_wings_has_key(obj, \"_raw\"))          { out[\"_raw\"] = obj[\"_raw\"]; }\n"
+    "    if (_wings_has_key(obj, \"_content_type\")) { out[\"_content_type\"] = obj[\"_content_type\"]; }\n"
+    "    if (_wings_has_key(obj, \"_stream\"))       { out[\"_stream\"] = obj[\"_stream\"]; }\n"
+    "    if (_wings_has_key(obj, \"_headers\"))      { out[\"_headers\"] = obj[\"_headers\"]; }\n"
+    "    if (_wings_has_key(obj, \"_headers\"))      { out[\"_headers\"] = obj[\"_headers\"]; }\n"
+    "    for (sk in keys(schema)) {\n"
+    "        str field = sk;\n"
+    "        int L = length(field);\n"
+    "        if (L > 0) {\n"
+    "            if (substring(field, L - 1, L) == \"?\") {\n"
+    "                field = substring(field, 0, L - 1);\n"
+    "            }\n"
+    "        }\n"
+    "        if (_wings_has_key(obj, field)) {\n"
+    "            out[field] = obj[field];\n"
+    "        }\n"
+    "    }\n"
+    "    return out;\n"
+    "}\n"
+    "\n"
+    "// Apply a response model to a result that is either an object or an array of\n"
+    "// objects (non-object array elements pass through untouched).\n"
+    "func _wings_apply_response_model(json schema, json result) {\n"
+    "    if (typeof(result) == \"array\") {\n"
+    "        json arr = [];\n"
+    "        for (el in result) {\n"
+    "            if (typeof(el) == \"object\") {\n"
+    "                push(arr, _wings_filter_obj(schema, el));\n"
+    "            } else {\n"
+    "                push(arr, el);\n"
+    "            }\n"
+    "        }\n"
+    "        return arr;\n"
+    "    } else {\n"
+    "        return _wings_filter_obj(schema, result);\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Serialise `result` through the response model in one native pass\n"
+    "// (wings_encode_model: the schema's key fragments are escaped once and\n"
+    "// cached, undeclared keys are never copied) and hand the bytes to the\n"
+    "// framer as a `_raw` JSON body. `_status` / `_headers` / `_content_type`\n"
+    "// ride along (the content type defaults to application/json).\n"
+    "func _wings_model_envelope(json schema, json result) {\n"
+    "    json env = {\"_raw\": wings_encode_model(schema, result),\n"
+    "                \"_content_type\": \"application/json\"};\n"
+    "    if (typeof(result) == \"object\") {\n"
+    "        if (_wings_has_key(result, \"_status\"))  { env[\"_status\"] = result[\"_status\"]; }\n"
+    "        if (_wings_has_key(result, \"_headers\")) { env[\"_headers\"] = result[\"_headers\"]; }\n"
+    "        if (_wings_has_key(result, \"_content_type\")) { env[\"_content_type\"] = result[\"_content_type\"]; }\n"
+    "    }\n"
+    "    return env;\n"
+    "}\n"
+    "\n"
+    "// ----- Response helpers ----------------------------------------------------\n"
+    "// Tiny wrappers so handlers express intent instead of hand-writing the\n"
+    "// `{\"_status\": N}` envelope. Each returns a response dict the dispatcher\n"
+    "// understands. `ok` is the 200 default (return your data directly works too).\n"
+    "//\n"
+    "//   func get_user()    { return ok(user); }\n"
+    "//   func create_user() { return created(user); }\n"
+    "//   func missing()     { return not_found(\"no such user\"); }\n"
+    "//\n"
+    "// Error helpers carry a uniform `{\"error\": msg}` body so clients can rely on\n"
+    "// one shape across every 4xx/5xx.\n"
+    "func ok(json data)              { return data; }\n"
+    "func created(json data)         { data[\"_status\"] = 201; return data; }\n"
+    "func no_content()               { return {\"_status\": 204}; }\n"
+    "func bad_request(str msg)       { return {\"error\": msg, \"_status\": 400}; }\n"
+    "func unauthorized(str msg)      { return {\"error\": msg, \"_status\": 401}; }\n"
+    "func forbidden(str msg)         { return {\"error\": msg, \"_status\": 403}; }\n"
+    "func not_found(str msg)         { return {\"error\": msg, \"_status\": 404}; }\n"
+    "func conflict(str msg)          { return {\"error\": msg, \"_status\": 409}; }\n"
+    "func server_error(str msg)      { return {\"error\": msg, \"_status\": 500}; }\n"
+    "// Plain-text / custom-status escape hatches.\n"
+    "func text(str body)             { return {\"_raw\": body, \"_content_type\": \"text/plain; charset=utf-8\"}; }\n"
+    "func with_status(json data, int status) { data[\"_status\"] = status; return data; }\n"
+    "\n"
+    "// Redirect helpers — emit a real HTTP 3xx with a `Location` header. The\n"
+    "// dispatcher honours the `_headers` envelope key (merged over the default\n"
+    "// headers in wings_build_response), so this is a genuine 302, not an HTML\n"
+    "// meta-refresh. Body is empty.\n"
+    "//\n"
+    "//   func go() { return redirect(\"https://example.com\"); }            // 302\n"
+    "//   func perma() { return redirect_status(\"https://x.com\", 301); }   // any 3xx\n"
+    "func redirect(str url)                  { return {\"_status\": 302, \"_raw\": \"\", \"_headers\": {\"Location\": url}}; }\n"
+    "func redirect_status(str url, int code) { return {\"_status\": code, \"_raw\": \"\", \"_headers\": {\"Location\": url}}; }\n"
+    "// Attach arbitrary response headers (Set-Cookie, Cache-Control, ...) to any\n"
+    "// result dict. Returns the same dict for chaining.\n"
+    "func with_headers(json data, json headers) { data[\"_headers\"] = headers; return data; }\n"
+    "\n"
+    "// ----- Cookies (SET side) ---------------------------------------------------\n"
+    "// `wings_cookies(req)` / `req[\"cookies\"]` cover the READ side; these build the\n"
+    "// `Set-Cookie` response header. One cookie per response (response headers are\n"
+    "// a dict — one value per header name); the LAST set_cookie() call wins.\n"
+    "//\n"
+    "//   func login(req) {\n"
+    "//       json res = ok({\"ok\": true});\n"
+    "//       return set_cookie(res, \"theme\", \"dark\", {\"max_age\": 86400});\n"
+    "//   }\n"
+    "//\n"
+    "// opts (json, all optional — pass {} or omit entirely):\n"
+    "//   path (default \"/\"), domain, max_age (seconds), same_site (default \"Lax\"),\n"
+    "//   secure (bool, default off — turn ON behind HTTPS), http_only (default ON,\n"
+    "//   pass false to allow document.cookie access).\n"
+    "func _wings_cookie_str(str name, str val, json opts) {\n"
+    "    str c = name + \"=\" + val;\n"
+    "    json o = opts;\n"
+    "    if (typeof(o) != \"object\") {\n"
+    "        o = {};\n"
+    "    }\n"
+    "    if (_wings_has_key(o, \"path\")) {\n"
+    "        c = c + \"; Path=\" + o[\"path\"];\n"
+    "    } else {\n"
+    "        c = c + \"; Path=/\";\n"
+    "    }\n"
+    "    if (_wings_has_key(o, \"domain\")) {\n"
+    "        c = c + \"; Domain=\" + o[\"domain\"];\n"
+    "    }\n"
+    "    if (_wings_has_key(o, \"max_age\")) {\n"
+    "        c = c + \"; Max-Age=\" + toString(o[\"max_age\"]);\n"
+    "    }\n"
+    "    if (_wings_has_key(o, \"same_site\")) {\n"
+    "        c = c + \"; SameSite=\" + o[\"same_site\"];\n"
+    "    } else {\n"
+    "        c = c + \"; SameSite=Lax\";\n"
+    "    }\n"
+    "    if (_wings_has_key(o, \"secure\")) {\n"
+    "        if (o[\"secure\"]) {\n"
+    "            c = c + \"; Secure\";\n"
+    "        }\n"
+    "    }\n"
+    "    bool ho = true;\n"
+    "    if (_wings_has_key(o, \"http_only\")) {\n"
+    "        if (o[\"http_only\"] == false) {\n"
+    "            ho = false;\n"
+    "        }\n"
+    "    }\n"
+    "    if (ho) {\n"
+    "        c = c + \"; HttpOnly\";\n"
+    "    }\n"
+    "    return c;\n"
+    "}\n"
+    "\n"
+    "func set_cookie(json res, str name, str val, json opts) {\n"
+    "    json h = res[\"_headers\"];\n"
+    "    if (typeof(h) != \"object\") {\n"
+    "        h = {};\n"
+    "    }\n"
+    "    h[\"Set-Cookie\"] = _wings_cookie_str(name, val, opts);\n"
+    "    res[\"_headers\"] = h;\n"
+    "    return res;\n"
+    "}\n"
+    "\n"
+    "// Expire a cookie on the client (Max-Age=0).\n"
+    "func delete_cookie(json res, str name) {\n"
+    "    return set_cookie(res, name, \"\", {\"max_age\": 0});\n"
+    "}\n"
+    "\n"
+    "// ----- Signed cookies (tamper-proof via hmac_sha256) ------------------------\n"
+    "// Wire format: `<value>.<64-hex-hmac>` where the MAC covers `<name>.<value>`\n"
+    "// (binding the name prevents swapping one cookie's value into another).\n"
+    "// The value itself must be cookie-safe (tokens/ids — no `;`, no spaces).\n"
+    "//\n"
+    "//   return set_signed_cookie(res, \"uid\", \"42\", SECRET, {});\n"
+    "//   str uid = get_signed_cookie(req, \"uid\", SECRET);   // \"\" if absent/tampered\n"
+    "func set_signed_cookie(json res, str name, str val, str secret, json opts) {\n"
+    "    str mac = hmac_sha256(secret, name + \".\" + val);\n"
+    "    return set_cookie(res, name, val + \".\" + mac, opts);\n"
+    "}\n"
+    "\n"
+    "func get_signed_cookie(json req, str name, str secret) {\n"
+    "    json c = req[\"cookies\"];\n"
+    "    if (typeof(c) != \"object\") {\n"
+    "        c = wings_cookies(req);\n"
+    "    }\n"
+    "    if (_wings_has_key(c, name) == false) {\n"
+    "        return \"\";\n"
+    "    }\n"
+    "    str raw = c[name];\n"
+    "    int n = length(raw);\n"
+    "    // Shortest valid: 1-char value + \".\" + 64 hex chars.\n"
+    "    if (n < 66) {\n"
+    "        return \"\";\n"
+    "    }\n"
+    "    str val = substring(raw, 0, n - 65);\n"
+    "    str dot = substring(raw, n - 65, n - 64);\n"
+    "    str mac = substring(raw, n - 64, n);\n"
+    "    if (dot != \".\") {\n"
+    "        return \"\";\n"
+    "    }\n"
+    "    str expect = hmac_sha256(secret, name + \".\" + val);\n"
+    "    // Compare MACs through a second HMAC so the string compare's timing\n"
+    "    // reveals nothing about the expected digest.\n"
+    "    if (hmac_sha256(secret, mac) != hmac_sha256(secret, expect)) {\n"
+    "        return \"\";\n"
+    "    }\n"
+    "    return val;\n"
+    "}\n"
+    "\n"
+    "// ----- Server-side sessions --------------------------------------------------\n"
+    "// Minimal in-memory session store for server-rendered apps: the client holds\n"
+    "// only a signed random session id (cookie \"tsid\"); the data lives in the\n"
+    "// `_wings_sessions` global (auto-persist keeps writes durable across requests).\n"
+    "// Sessions vanish at process restart — put anything durable in a DB.\n"
+    "//\n"
+    "//   func page(req) {\n"
+    "//       str sid = session_start(req, SECRET);          // existing or fresh id\n"
+    "//       int seen = session_get(sid, \"seen\");\n"
+    "//       session_set(sid, \"seen\", seen + 1);\n"
+    "//       json res = ok({\"visits\": seen + 1});\n"
+    "//       return session_attach(res, sid, SECRET);       // (re)issue the cookie\n"
+    "//   }\n"
+    "json _wings_sessions = {};\n"
+    "\n"
+    "func session_start(json req, str secret) {\n"
+    "    str sid = get_signed_cookie(req, \"tsid\", secret);\n"
+    "    if (length(sid) == 0) {\n"
+    "        sid = secure_token(32);\n"
+    "    }\n"
+    "    return sid;\n"
+    "}\n"
+    "\n"
+    "// Attach the session cookie to a response (call on every response that may\n"
+    "// have created a fresh session id).\n"
+    "func session_attach(json res, str sid, str secret) {\n"
+    "    return set_signed_cookie(res, \"tsid\", sid, secret, {\"path\": \"/\", \"http_only\": true});\n"
+    "}\n"
+    "\n"
+    "func session_set(str sid, str key, json val) {\n"
+    "    json s = _wings_sessions[sid];\n"
+    "    if (typeof(s) != \"object\") {\n"
+    "        s = {};\n"
+    "    }\n"
+    "    s[key] = val;\n"
+    "    _wings_sessions[sid] = s;\n"
+    "}\n"
+    "\n"
+    "func session_get(str sid, str key) {\n"
+    "    json s = _wings_sessions[sid];\n"
+    "    if (typeof(s) != \"object\") {\n"
+    "        return 0;\n"
+    "    }\n"
+    "    return s[key];\n"
+    "}\n"
+    "\n"
+    "func session_destroy(str sid) {\n"
+    "    _wings_sessions[sid] = 0;\n"
+    "}\n"
+    "\n"
+    "// ----- CORS configuration ----------------------------------------------------\n"
+    "// Replace the default wildcard CORS headers. Call once, before serve().\n"
+    "// `origin` is a single origin (\"https://app.example.com\") or \"*\".\n"
+    "// Credentialed cross-origin (cookies / Authorization across sites) REQUIRES a\n"
+    "// specific origin — browsers reject `*` + credentials.\n"
+    "//\n"
+    "//   cors(\"https://app.example.com\", {\"credentials\": true,\n"
+    "//        \"methods\": \"GET, POST, PUT, DELETE, OPTIONS\",\n"
+    "//        \"headers\": \"Content-Type, Authorization\",\n"
+    "//        \"expose\": \"X-Total-Count\", \"max_age\": 600});\n"
+    "//\n"
+    "// Startup-only mutation of `_default_headers` (write-once before the serve\n"
+    "// loop), so it is thread-safe under every listen mode and covers the automatic\n"
+    "// OPTIONS/preflight 204 response too.\n"
+    "func cors(str origin, json opts) {\n"
+    "    _default_headers[\"Access-Control-Allow-Origin\"] = origin;\n"
+    "    if (origin != \"*\") {\n"
+    "        // Caches must key the response on the requesting origin.\n"
+    "        _default_headers[\"Vary\"] = \"Origin\";\n"
+    "    }\n"
+    "    json o = opts;\n"
+    "    if (typeof(o) != \"object\") {\n"
+    "        o = {};\n"
+    "    }\n"
+    "    if (_wings_has_key(o, \"methods\")) {\n"
+    "        _default_headers[\"Access-Control-Allow-Methods\"] = o[\"methods\"];\n"
+    "    }\n"
+    "    if (_wings_has_key(o, \"headers\")) {\n"
+    "        _default_headers[\"Access-Control-Allow-Headers\"] = o[\"headers\"];\n"
+    "    }\n"
+    "    if (_wings_has_key(o, \"expose\")) {\n"
+    "        _default_headers[\"Access-Control-Expose-Headers\"] = o[\"expose\"];\n"
+    "    }\n"
+    "    if (_wings_has_key(o, \"max_age\")) {\n"
+    "        _default_headers[\"Access-Control-Max-Age\"] = toString(o[\"max_age\"]);\n"
+    "    }\n"
+    "    if (_wings_has_key(o, \"credentials\")) {\n"
+    "        if (o[\"credentials\"]) {\n"
+    "            _default_headers[\"Access-Control-Allow-Credentials\"] = \"true\";\n"
+    "        }\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// ----- Rate limiting ----------------------------------------------------------\n"
+    "// Fixed-window limiter as a use()-able middleware. Keyed on the client IP from\n"
+    "// X-Forwarded-For / X-Real-IP (first hop) when present, else one global bucket\n"
+    "// (fine behind a proxy; direct exposure without those headers = global limit).\n"
+    "// The whole table resets when the window rolls over, so memory stays bounded.\n"
+    "//\n"
+    "//   rate_limit(100, 60);   // max 100 requests per 60s per client\n"
+    "json _wings_rl_hits = {};\n"
+    "int _wings_rl_max = 60;\n"
+    "int _wings_rl_window = 60;\n"
+    "int _wings_rl_epoch = 0;\n"
+    "\n"
+    "func rate_limit(int max_req, int window_s) {\n"
+    "    if (max_req > 0) {\n"
+    "        _wings_rl_max = max_req;\n"
+    "    }\n"
+    "    if (window_s > 0) {\n"
+    "        _wings_rl_window = window_s;\n"
+    "    }\n"
+    "    use(\"_wings_rate_limit_mw\");\n"
+    "}\n"
+    "\n"
+    "func _wings_rl_key(json req) {\n"
+    "    json h = req[\"headers\"];\n"
+    "    str ip = h[\"X-Forwarded-For\"];\n"
+    "    if (length(ip) == 0) {\n"
+    "        ip = h[\"x-forwarded-for\"];\n"
+    "    }\n"
+    "    if (length(ip) == 0) {\n"
+    "        ip = h[\"X-Real-IP\"];\n"
+    "    }\n"
+    "    if (length(ip) == 0) {\n"
+    "        ip = h[\"x-real-ip\"];\n"
+    "    }\n"
+    "    if (length(ip) == 0) {\n"
+    "        return \"global\";\n"
+    "    }\n"
+    "    json parts = split(ip, \",\");\n"
+    "    return trim(parts[0]);\n"
+    "}\n"
+    "\n"
+    "func _wings_rate_limit_mw(req) {\n"
+    "    int now = timestamp();\n"
+    "    int epoch = toInt(now / _wings_rl_window);\n"
+    "    if (epoch != _wings_rl_epoch) {\n"
+    "        _wings_rl_epoch = epoch;\n"
+    "        _wings_rl_hits = {};\n"
+    "    }\n"
+    "    str k = _wings_rl_key(req);\n"
+    "    int c = _wings_rl_hits[k];\n"
+    "    c = c + 1;\n"
+    "    _wings_rl_hits[k] = c;\n"
+    "    if (c > _wings_rl_max) {\n"
+    "        return {\"error\": \"rate limit exceeded\", \"_status\": 429,\n"
+    "                \"_headers\": {\"Retry-After\": toString(_wings_rl_window)}};\n"
+    "    }\n"
+    "    return {};\n"
+    "}\n"
+    "\n"
+    "// ----- Response compression (gzip) --------------------------------------------\n"
+    "// Opt-in: enable_gzip(min_bytes) turns on transparent gzip for responses whose\n"
+    "// serialized body is at least `min_bytes` (default 1024) when the client sent\n"
+    "// `Accept-Encoding: gzip`. Uses the in-tree `gzip_compress` builtin — no zlib\n"
+    "// dependency. Compressed responses carry `Content-Encoding: gzip` +\n"
+    "// `Vary: Accept-Encoding`; if compression doesn't shrink the body (already-\n"
+    "// compressed data) the plain response is sent. `cached_get` routes are never\n"
+    "// compressed — their pinned wire bytes are shared by every client, including\n"
+    "// ones that can't decode gzip.\n"
+    "//\n"
+    "//   enable_gzip(0);      // default threshold (1024 bytes)\n"
+    "//   enable_gzip(256);    // compress anything >= 256 bytes\n"
+    "int _wings_gzip = 0;\n"
+    "int _wings_gzip_min = 1024;\n"
+    "\n"
+    "func enable_gzip(int min_bytes) {\n"
+    "    _wings_gzip = 1;\n"
+    "    if (min_bytes > 0) {\n"
+    "        _wings_gzip_min = min_bytes;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// ----- JWT guard middleware ---------------------------------------------------\n"
+    "// use()-able bearer-token guard, wire-compatible with the `wings_jwt` package\n"
+    "// (HS256, base64url JSON segments, signature = base64url(hex HMAC)). Verifies\n"
+    "// `Authorization: Bearer <token>` on every request, rejects with 401 on\n"
+    "// missing/bad/expired tokens, and injects the claims as `req[\"jwt\"]` for\n"
+    "// handlers. Also flags /docs so the OpenAPI doc advertises bearerAuth.\n"
+    "//\n"
+    "//   jwt_guard(SECRET);                  // protect everything...\n"
+    "//   jwt_public(\"/login\");               // ...except these paths\n"
+    "//   func me(req) { return ok({\"sub\": req[\"jwt\"][\"sub\"]}); }\n"
+    "//\n"
+    "// /healthz, /metrics, /docs and /openapi.json are public by default.\n"
+    "str _wings_jwt_secret = \"\";\n"
+    "array _wings_jwt_public = [];\n"
+    "\n"
+    "func jwt_guard(str secret) {\n"
+    "    _wings_jwt_secret = secret;\n"
+    "    if (length(_wings_jwt_public) == 0) {\n"
+    "        push(_wings_jwt_public, \"/healthz\");\n"
+    "        push(_wings_jwt_public, \"/metrics\");\n"
+    "        push(_wings_jwt_public, \"/docs\");\n"
+    "        push(_wings_jwt_public, \"/openapi.json\");\n"
+    "    }\n"
+    "    use(\"_wings_jwt_mw\");\n"
+    "    _wings_docs_bearer = 1;\n"
+    "}\n"
+    "\n"
+    "// Exempt a path from the JWT guard. Exact match, or a trailing `*` for a\n"
+    "// prefix match: jwt_public(\"/items/*\") exempts every path under /items/.\n"
+    "func jwt_public(str path) {\n"
+    "    push(_wings_jwt_public, path);\n"
+    "}\n"
+    "\n"
+    "func _wings_jwt_is_public(str p) {\n"
+    "    int i = 0;\n"
+    "    while (i < length(_wings_jwt_public)) {\n"
+    "        str pat = _wings_jwt_public[i];\n"
+    "        int pl = length(pat);\n"
+    "        if (pl > 0 && substring(pat, pl - 1, pl) == \"*\") {\n"
+    "            str prefix = substring(pat, 0, pl - 1);\n"
+    "            if (length(p) >= length(prefix)) {\n"
+    "                if (substring(p, 0, length(prefix)) == prefix) {\n"
+    "                    return true;\n"
+    "                }\n"
+    "            }\n"
+    "        } else if (pat == p) {\n"
+    "            return true;\n"
+    "        }\n"
+    "        i = i + 1;\n"
+    "    }\n"
+    "    return false;\n"
+    "}\n"
+    "\n"
+    "func _wings_b64url_decode(str s) {\n"
+    "    str b = replace(s, \"-\", \"+\");\n"
+    "    b = replace(b, \"_\", \"/\");\n"
+    "    int r = mod(length(b), 4);\n"
+    "    if (r == 2) {\n"
+    "        b = b + \"==\";\n"
+    "    }\n"
+    "    if (r == 3) {\n"
+    "        b = b + \"=\";\n"
+    "    }\n"
+    "    return base64_decode(b);\n"
+    "}\n"
+    "\n"
+    "func _wings_b64url_encode(str s) {\n"
+    "    str b = base64_encode(s);\n"
+    "    b = replace(b, \"+\", \"-\");\n"
+    "    b = replace(b, \"/\", \"_\");\n"
+    "    b = replace(b, \"=\", \"\");\n"
+    "    return b;\n"
+    "}\n"
+    "\n"
+    "// Verify a wings_jwt-format HS256 token. Returns {\"ok\":1,\"claims\":{...}} or\n"
+    "// {\"ok\":0,\"error\":\"<reason>\"} — same contract as wings_jwt.verify().\n"
+    "func _wings_jwt_verify(str token, str secret) {\n"
+    "    json parts = split(token, \".\");\n"
+    "    if (length(parts) != 3) {\n"
+    "        return {\"ok\": 0, \"error\": \"malformed token\"};\n"
+    "    }\n"
+    "    str signing_input = parts[0] + \".\" + parts[1];\n"
+    "    str expected = _wings_b64url_encode(hmac_sha256(secret, signing_input));\n"
+    "    // Double-HMAC so the comparison is timing-safe.\n"
+    "    if (hmac_sha256(secret, parts[2]) != hmac_sha256(secret, expected)) {\n"
+    "        return {\"ok\": 0, \"error\": \"bad signature\"};\n"
+    "    }\n"
+    "    json claims = fromJson(_wings_b64url_decode(parts[1]));\n"
+    "    if (_wings_has_key(claims, \"exp\")) {\n"
+    "        if (timestamp() >= claims[\"exp\"]) {\n"
+    "            return {\"ok\": 0, \"error\": \"expired\"};\n"
+    "        }\n"
+    "    }\n"
+    "    return {\"ok\": 1, \"claims\": claims};\n"
+    "}\n"
+    "\n"
+    "func _wings_jwt_mw(req) {\n"
+    "    if (_wings_jwt_is_public(req[\"path\"])) {\n"
+    "        return {};\n"
+    "    }\n"
+    "    str auth = _hdr_ci(req[\"headers\"], \"Authorization\");\n"
+    "    if (length(auth) < 8) {\n"
+    "        return unauthorized(\"missing bearer token\");\n"
+    "    }\n"
+    "    str scheme = lower(substring(auth, 0, 7));\n"
+    "    if (scheme != \"bearer \") {\n"
+    "        return unauthorized(\"missing bearer token\");\n"
+    "    }\n"
+    "    str tok = trim(substring(auth, 7, length(auth)));\n"
+    "    json v = _wings_jwt_verify(tok, _wings_jwt_secret);\n"
+    "    if (v[\"ok\"] == 0) {\n"
+    "        return unauthorized(v[\"error\"]);\n"
+    "    }\n"
+    "    req[\"jwt\"] = v[\"claims\"];\n"
+    "    return {};\n"
+    "}\n"
+    "\n"
+    "// ----- HTML responses + tiny template render ----------------------------------\n"
+    "// `html(body)` returns a text/html response; `render(tpl, vars)` substitutes\n"
+    "// every `{{key}}` in the template with `toString(vars[key])` — enough for\n"
+    "// server-rendered pages without a template engine. t-strings cover the\n"
+    "// single-expression cases; render() covers \"template + data dict\".\n"
+    "//\n"
+    "//   func home(req) {\n"
+    "//       str page = render(\"<h1>{{title}}</h1><p>Hi {{name}}!</p>\",\n"
+    "//                         {\"title\": \"Wings\", \"name\": \"Ada\"});\n"
+    "//       return html(page);\n"
+    "//   }\n"
+    "func html(str body) {\n"
+    "    return {\"_raw\": body, \"_content_type\": \"text/html; charset=utf-8\"};\n"
+    "}\n"
+    "\n"
+    "func render(str tpl, json vars) {\n"
+    "    str out = tpl;\n"
+    "    if (typeof(vars) != \"object\") {\n"
+    "        return out;\n"
+    "    }\n"
+    "    for (k in keys(vars)) {\n"
+    "        out = replace(out, \"{{\" + k + \"}}\", toString(vars[k]));\n"
+    "    }\n"
+    "    return out;\n"
+    "}\n"
+    "\n"
+    "// ----- Typed path-param accessors ----------------------------------------------\n"
+    "// Mirrors of query/query_int/query_bool for `:name` route params.\n"
+    "//\n"
+    "//   get(\"/users/:id\", \"show\");\n"
+    "//   func show(req) { int id = param_int(req, \"id\", 0); ... }\n"
+    "func param(json req, str name, str fallback) {\n"
+    "    json p = req[\"params\"];\n"
+    "    if (typeof(p) == \"object\") {\n"
+    "        if (_wings_has_key(p, name)) {\n"
+    "            return p[name];\n"
+    "        }\n"
+    "    }\n"
+    "    return fallback;\n"
+    "}\n"
+    "\n"
+    "func param_int(json req, str name, int fallback) {\n"
+    "    json p = req[\"params\"];\n"
+    "    if (typeof(p) == \"object\") {\n"
+    "        if (_wings_has_key(p, name)) {\n"
+    "            str v = p[name];\n"
+    "            if (length(v) > 0) {\n"
+    "                return toInt(v);\n"
+    "            }\n"
+    "        }\n"
+    "    }\n"
+    "    return fallback;\n"
+    "}\n"
+    "\n"
+    "func param_bool(json req, str name, bool fallback) {\n"
+    "    json p = req[\"params\"];\n"
+    "    if (typeof(p) == \"object\") {\n"
+    "        if (_wings_has_key(p, name)) {\n"
+    "            str v = lower(p[name]);\n"
+    "            if (v == \"1\") { return true; }\n"
+    "            if (v == \"true\") { return true; }\n"
+    "            if (v == \"yes\") { return true; }\n"
+    "            if (v == \"0\") { return false; }\n"
+    "            if (v == \"false\") { return false; }\n"
+    "            if (v == \"no\") { return false; }\n"
+    "        }\n"
+    "    }\n"
+    "    return fallback;\n"
+    "}\n"
+    "\n"
+    "// ----- Typed query-param accessors -----------------------------------------\n"
+    "// `req[\"query\"]` holds raw string values; these coerce with a default fallback\n"
+    "// so list endpoints can read pagination/filters in one line instead of\n"
+    "// hand-checking presence + toInt().\n"
+    "//\n"
+    "//   int page  = query_int(req, \"page\", 1);\n"
+    "//   str sort  = query(req, \"sort\", \"id\");\n"
+    "//   bool desc = query_bool(req, \"desc\", false);\n"
+    "func query(json req, str name, str fallback) {\n"
+    "    json q = req[\"query\"];\n"
+    "    if (_wings_has_key(q, name)) {\n"
+    "        return q[name];\n"
+    "    }\n"
+    "    return fallback;\n"
+    "}\n"
+    "\n"
+    "func query_int(json req, str name, int fallback) {\n"
+    "    json q = req[\"query\"];\n"
+    "    if (_wings_has_key(q, name)) {\n"
+    "        str v = q[name];\n"
+    "        if (length(v) > 0) {\n"
+    "            return toInt(v);\n"
+    "        }\n"
+    "    }\n"
+    "    return fallback;\n"
+    "}\n"
+    "\n"
+    "func query_bool(json req, str name, bool fallback) {\n"
+    "    json q = req[\"query\"];\n"
+    "    if (_wings_has_key(q, name)) {\n"
+    "        str v = lower(q[name]);\n"
+    "        if (v == \"1\") { return true; }\n"
+    "        if (v == \"true\") { return true; }\n"
+    "        if (v == \"yes\") { return true; }\n"
+    "        if (v == \"0\") { return false; }\n"
+    "        if (v == \"false\") { return false; }\n"
+    "        if (v == \"no\") { return false; }\n"
+    "    }\n"
+    "    return fallback;\n"
+    "}\n"
+    "\n"
+    "// ----- Multipart / file uploads --------------------------------------------\n"
+    "// Parse a multipart/form-data request body into `{fields, files}` via the\n"
+    "// native `parse_multipart` builtin. Lazy — only call from handlers expecting\n"
+    "// uploads. `files` is an array of {name, filename, content_type, data, size}\n"
+    "// (data carries the raw bytes, binary-safe). Note: each form()/uploaded_files()\n"
+    "// call re-parses; for many fields call form_data() once and read it directly.\n"
+    "//\n"
+    "//   func upload(req) {\n"
+    "//       str title = form(req, \"title\", \"\");\n"
+    "//       for (f in uploaded_files(req)) {\n"
+    "//           write_file(\"./uploads/\" + f[\"filename\"], f[\"data\"]);\n"
+    "//       }\n"
+    "//       return created({\"title\": title});\n"
+    "//   }\n"
+    "//   post(\"/upload\", \"upload\");\n"
+    "func form_data(json req) {\n"
+    "    str ct = _hdr_ci(req[\"headers\"], \"Content-Type\");\n"
+    "    return parse_multipart(req[\"body\"], ct);\n"
+    "}\n"
+    "\n"
+    "func form(json req, str name, str fallback) {\n"
+    "    json mp = form_data(req);\n"
+    "    json f = mp[\"fields\"];\n"
+    "    if (_wings_has_key(f, name)) {\n"
+    "        return f[name];\n"
+    "    }\n"
+    "    return fallback;\n"
+    "}\n"
+    "\n"
+    "func uploaded_files(json req) {\n"
+    "    json mp = form_data(req);\n"
+    "    return mp[\"files\"];\n"
+    "}\n"
+    "\n"
+    "// Friendly alias for listen() — reads better at the bottom of an app file:\n"
+    "//   serve(8080);\n"
+    "// serve([port[, workers]]) — sunucunun TEK öğretilen kapısı (WINGS_DX §4).\n"
+    "//   serve();          → 8484 (\"Tulpar portu\"), tek thread\n"
+    "//   serve(8080);      → açık port\n"
+    "//   serve(8080, 4);   → 4 worker'lı thread pool (listen_pool)\n"
+    "// Eksik argümanlar 0'a pad'lenir (default-arg semantiği); workers <= 1 tek\n"
+    "// thread demektir. listen/listen_pool/listen_evented/listen_async \"gelişmiş\n"
+    "// modlar\" olarak kalır.\n"
+    "func serve(int port, int workers) {\n"
+    "    if (workers > 1) {\n"
+    "        return listen_pool(port, workers);\n"
+    "    }\n"
+    "    return listen(port);\n"
+    "}\n"
+    "\n"
+    "// Shared startup banner — colored box + route table + server line. Every serve\n"
+    "// mode (listen / listen_pool / listen_evented / listen_async) calls this so they\n"
+    "// render identically; NO_COLOR is honored via `_wings_c`. `suffix` annotates the\n"
+    "// serve mode on the Server line (\"\" = default single-thread accept loop).\n"
+    "func _wings_print_banner(int port, str suffix) {\n"
+    "    print(\"\");\n"
+    "    print(_wings_c(\"36\",   \"  ╔═══════════════════════════════════╗\"));\n"
+    "    print(_wings_c(\"1;36\", \"  ║       Tulpar Wings v3.6           ║\"));\n"
+    "    print(_wings_c(\"36\",   \"  ║    Give your API wings! 🪶        ║\"));\n"
+    "    print(_wings_c(\"36\",   \"  ╚═══════════════════════════════════╝\"));\n"
+    "    print(\"\");\n"
+    "    print(\"  \" + _wings_c(\"1\", \"Routes:\"));\n"
+    "    for (int i = 0; i < length(_routes); i++) {\n"
+    "        json r = _routes[i];\n"
+    "        print(\"    \" + _wings_c(_wings_method_color(r[\"method\"]), r[\"method\"]) +\n"
+    "              \" \" + r[\"path\"] + _wings_c(\"90\", \"  →  \" + r[\"handler\"] + \"()\"));\n"
+    "    }\n"
+    "    print(\"\");\n"
+    "    str url = _wings_c(\"1;32\", \"http://127.0.0.1:\" + toString(port));\n"
+    "    if (length(suffix) > 0) {\n"
+    "        url = url + _wings_c(\"90\", \"  (\" + suffix + \")\");\n"
+    "    }\n"
+    "    print(\"  \" + _wings_c(\"1\", \"Server:\") + \"  \" + url);\n"
+    "    print(_wings_c(\"90\", \"  Press Ctrl+C to stop\"));\n"
+    "    print(\"\");\n"
+    "}\n"
+    "\n"
+    "// ----- Internals -----------------------------------------------------------\n"
+    "// Pull `Cookie:` out of the parsed headers object and run it through the\n"
+    "// native `parse_cookies` builtin. Returns an empty object when the\n"
+    "// header is absent or empty. Tries both casings — `http_parse_request`\n"
+    "// preserves wire case, but most browsers send `Cookie` while curl\n"
+    "// defaults to `cookie`.\n"
+    "//\n"
+    "// Public: handlers that want cookies call this themselves with\n"
+    "// `_request` as the argument:\n"
+    "//   json cookies = wings_cookies(_request);\n"
+    "//   str sid = cookies[\"sid\"];\n"
+    "//\n"
+    "// We automatically populate `_request[\"cookies\"]` from the dispatcher\n"
+    "// for all requests. The historical Linux AOT codegen miscompile\n"
+    "// (where assigning a function-call's object return into a global subscript\n"
+    "// corrupted the object due to LocalExec TLS vs PIE layout incompatibility)\n"
+    "// has been resolved by switching the backend to InitialExec TLS.\n"
+    "// Case-insensitive header lookup (RFC 7230: field names are\n"
+    "// case-insensitive). Request headers are stored with the client's exact\n"
+    "// casing, so `headers[\"Authorization\"]` misses when a client/proxy sends\n"
+    "// `AUTHORIZATION` or `authorization`. Fast path: try the given casing and\n"
+    "// its lowercase form directly; only then scan the keys. Returns \"\" when\n"
+    "// the header is absent.\n"
+    "func _hdr_ci(json headers, str name) {\n"
+    "    str direct = headers[name];\n"
+    "    if (length(direct) > 0) { return direct; }\n"
+    "    str want = lower(name);\n"
+    "    direct = headers[want];\n"
+    "    if (length(direct) > 0) { return direct; }\n"
+    "    for (k in keys(headers)) {\n"
+    "        if (lower(k) == want) { return headers[k]; }\n"
+    "    }\n"
+    "    return \"\";\n"
+    "}\n"
+    "\n"
+    "// Public accessor: `req_header(req, \"content-type\")` finds the header no\n"
+    "// matter how the client cased it. Prefer this over indexing\n"
+    "// `req[\"headers\"]` directly.\n"
+    "func req_header(json req, str name) {\n"
+    "    return _hdr_ci(req[\"headers\"], name);\n"
+    "}\n"
+    "\n"
+    "func wings_cookies(json req) {\n"
+    "    str raw = _hdr_ci(req[\"headers\"], \"Cookie\");\n"
+    "    if (length(raw) == 0) {\n"
+    "        return {};\n"
+    "    }\n"
+    "    return parse_cookies(raw);\n"
+    "}\n"
+    "\n"
+    "// Parse a JSON request body once, up front, so handlers read\n"
+    "// `_request[\"json\"]` directly instead of calling `fromJson(_request[\"body\"])`\n"
+    "// themselves. Returns {} when there is no body or it isn't a JSON object/array\n"
+    "// (so `_request[\"json\"][\"field\"]` is always safe to index). The dispatcher\n"
+    "// calls this right before invoking a matched handler.\n"
+    "func _wings_parse_body(json req) {\n"
+    "    str body = req[\"body\"];\n"
+    "    if (length(body) == 0) {\n"
+    "        return {};\n"
+    "    }\n"
+    "    str first = substring(body, 0, 1);\n"
+    "    if (first == \"{\" || first == \"[\") {\n"
+    "        return fromJson(body);\n"
+    "    }\n"
+    "    return {};\n"
+    "}\n"
+    "\n"
+    "// True when object `obj` has its own key `k`. A missing object key reads back\n"
+    "// as int 0 (not null), so presence can't be inferred from the value — we scan\n"
+    "// the key list. Cheap: request bodies have a handful of keys.\n"
+    "func _wings_has_key(json obj, str k) {\n"
+    "    for (kk in keys(obj)) {\n"
+    "        if (kk == k) {\n"
+    "            return true;\n"
+    "        }\n"
+    "    }\n"
+    "    return false;\n"
+    "}\n"
+    "\n"
+    "// Does the runtime typeof() string `got` satisfy the schema type `want`?\n"
+    "func _wings_type_ok(str want, str got) {\n"
+    "    if (want == \"any\")    { return true; }\n"
+    "    if (want == \"str\")    { return got == \"string\"; }\n"
+    "    if (want == \"int\")    { return got == \"int\"; }\n"
+    "    if (want == \"float\")  { return got == \"float\" || got == \"int\"; }\n"
+    "    if (want == \"num\")    { return got == \"int\" || got == \"float\"; }\n"
+    "    if (want == \"bool\")   { return got == \"bool\"; }\n"
+    "    if (want == \"array\")  { return got == \"array\"; }\n"
+    "    if (want == \"object\") { return got == \"object\"; }\n"
+    "    if (want == \"json\")   { return got == \"object\" || got == \"array\"; }\n"
+    "    return false;\n"
+    "}\n"
+    "\n"
+    "// Check a single value `val` against a field `spec`, returning a flat map of\n"
+    "// {dotted-path -> message} (empty when valid). `spec` is either a simple type\n"
+    "// string (\"str\", \"int?\"-style markers live on the KEY, not here) or a rich\n"
+    "// object spec {type, min, max, regex, items, schema}. Used for both top-level\n"
+    "// fields and recursion (array items, nested objects), so error paths nest via\n"
+    "// the `path` prefix (e.g. \"addr.zip\", \"tags.0\").\n"
+    "func _wings_check(json spec, json val, str path) {\n"
+    "    json fields = {};\n"
+    "    str st = typeof(spec);\n"
+    "    if (st == \"string\") {\n"
+    "        // Simple type only (backwards-compatible form).\n"
+    "        str got0 = typeof(val);\n"
+    "        if (!_wings_type_ok(spec, got0)) {\n"
+    "            fields[path] = \"expected \" + spec + \", got \" + got0;\n"
+    "        }\n"
+    "        return fields;\n"
+    "    }\n"
+    "    // Rich object spec. Type-check first; never run constraints on a value of\n"
+    "    // the wrong type (a wrong type is the more useful single message).\n"
+    "    str want = spec[\"type\"];\n"
+    "    str got = typeof(val);\n"
+    "    if (!_wings_type_ok(want, got)) {\n"
+    "        fields[path] = \"expected \" + want + \", got \" + got;\n"
+    "        return fields;\n"
+    "    }\n"
+    "    if (want == \"str\") {\n"
+    "        int slen = length(val);\n"
+    "        if (_wings_has_key(spec, \"min\") && slen < spec[\"min\"]) {\n"
+    "            fields[path] = \"min length \" + toString(spec[\"min\"]);\n"
+    "        } else if (_wings_has_key(spec, \"max\") && slen > spec[\"max\"]) {\n"
+    "            fields[path] = \"max length \" + toString(spec[\"max\"]);\n"
+    "        } else if (_wings_has_key(spec, \"regex\") && regex_match(spec[\"regex\"], val) == 0) {\n"
+    "            fields[path] = \"must match \" + spec[\"regex\"];\n"
+    "        }\n"
+    "    } else if (want == \"int\" || want == \"float\" || want == \"num\") {\n"
+    "        if (_wings_has_key(spec, \"min\") && val < spec[\"min\"]) {\n"
+    "            fields[path] = \"min \" + toString(spec[\"min\"]);\n"
+    "        } else if (_wings_has_key(spec, \"max\") && val > spec[\"max\"]) {\n"
+    "            fields[path] = \"max \" + toString(spec[\"max\"]);\n"
+    "        }\n"
+    "    } else if (want == \"array\") {\n"
+    "        int alen = length(val);\n"
+    "        if (_wings_has_key(spec, \"min\") && alen < spec[\"min\"]) {\n"
+    "            fields[path] = \"min items \" + toString(spec[\"min\"]);\n"
+    "        } else if (_wings_has_key(spec, \"max\") && alen > spec[\"max\"]) {\n"
+    "            fields[path] = \"max items \" + toString(spec[\"max\"]);\n"
+    "        }\n"
+    "        // Element validation is independent of the length checks above.\n"
+    "        if (_wings_has_key(spec, \"items\")) {\n"
+    "            json items = spec[\"items\"];\n"
+    "            for (int i = 0; i < length(val); i++) {\n"
+    "                json ce = _wings_check(items, val[i], path + \".\" + toString(i));\n"
+    "                for (ek in keys(ce)) { fields[ek] = ce[ek]; }\n"
+    "            }\n"
+    "        }\n"
+    "    } else if (want == \"object\") {\n"
+    "        if (_wings_has_key(spec, \"schema\")) {\n"
+    "            json co = _wings_validate_fields(spec[\"schema\"], val, path + \".\");\n"
+    "            for (ok in keys(co)) { fields[ok] = co[ok]; }\n"
+    "        }\n"
+    "    }\n"
+    "    return fields;\n"
+    "}\n"
+    "\n"
+    "// Validate a body's fields against a schema map, accumulating dotted-path\n"
+    "// errors under `prefix`. Handles the trailing-`?` optional marker on keys.\n"
+    "func _wings_validate_fields(json schema, json body, str prefix) {\n"
+    "    json fields = {};\n"
+    "    for (k in keys(schema)) {\n"
+    "        json spec = schema[k];\n"
+    "        str name = k;\n"
+    "        int optional = 0;\n"
+    "        int klen = length(k);\n"
+    "        if (klen > 0 && substring(k, klen - 1, klen) == \"?\") {\n"
+    "            name = substring(k, 0, klen - 1);\n"
+    "            optional = 1;\n"
+    "        }\n"
+    "        str path = prefix + name;\n"
+    "        if (!_wings_has_key(body, name)) {\n"
+    "            if (optional == 0) {\n"
+    "                fields[path] = \"required\";\n"
+    "            }\n"
+    "        } else {\n"
+    "            json cf = _wings_check(spec, body[name], path);\n"
+    "            for (fk in keys(cf)) { fields[fk] = cf[fk]; }\n"
+    "        }\n"
+    "    }\n"
+    "    return fields;\n"
+    "}\n"
+    "\n"
+    "// Validate a parsed body against a schema. Returns {} when valid, or a ready\n"
+    "// 422 response envelope ({\"_status\":422, \"error\":..., \"fields\":{...}}) listing\n"
+    "// every offending field so the client sees them all at once (FastAPI-style).\n"
+    "// Schema values are either a simple type string or a rich spec object — see\n"
+    "// body_schema() for the full grammar. Nested/array errors use dotted paths.\n"
+    "func _wings_validate(json schema, json body) {\n"
+    "    json fields = _wings_validate_fields(schema, body, \"\");\n"
+    "    if (length(keys(fields)) > 0) {\n"
+    "        return {\"_status\": 422, \"error\": \"validation failed\", \"fields\": fields};\n"
+    "    }\n"
+    "    return {};\n"
+    "}\n"
+    "\n"
+    "// Linear scan over registered routes. Tulpar arrays of small dicts are tight\n"
+    "// enough that this is dominated by string compare cost; for hundreds of\n"
+    "// routes a hash table would help, but we avoid the dependency for now.\n"
+    "func _find_route(str method, str path) {\n"
+    "    for (int i = 0; i < length(_routes); i++) {\n"
+    "        json r = _routes[i];\n"
+    "        if (r[\"method\"] == method && r[\"path\"] == path) {\n"
+    "            return i;\n"
+    "        }\n"
+    "    }\n"
+    "    return -1;\n"
+    "}\n"
+    "\n"
+    "// ----- Path parameters ----------------------------------------------------\n"
+    "//\n"
+    "// Routes can include `:name` placeholders that match any single\n"
+    "// non-`/` segment, e.g. `get(\"/v1/packages/:name\", \"show\")` matches\n"
+    "// `/v1/packages/demo` and exposes `_request[\"params\"][\"name\"] == \"demo\"`.\n"
+    "// Multiple params per route work too: `/users/:uid/posts/:pid`.\n"
+    "//\n"
+    "// Two-pass dispatch:\n"
+    "//   1. Exact match (`_find_route`) — O(routes), no param overhead, the\n"
+    "//      hot path that 99% of static routes take.\n"
+    "//   2. Pattern match (`_find_route_with_params`) — only consulted when\n"
+    "//      the exact lookup misses AND the route's path contains a `:`.\n"
+    "//\n"
+    "// Falling back per-request keeps the param-free routes free of any\n"
+    "// extra string ops; param routes pay for split + per-segment compare,\n"
+    "// which on a typical 3-segment URL is still microseconds.\n"
+    "\n"
+    "func _wings_split_path(str path) {\n"
+    "    // Drop the leading `/` so split doesn't produce an empty first\n"
+    "    // segment. Trailing `/` is preserved as an empty segment, which\n"
+    "    // makes `/foo/` ≠ `/foo` — intentional, mirrors most routers.\n"
+    "    str trimmed = path;\n"
+    "    if (length(trimmed) > 0 && substring(trimmed, 0, 1) == \"/\") {\n"
+    "        trimmed = substring(trimmed, 1, length(trimmed));\n"
+    "    }\n"
+    "    return split(trimmed, \"/\");\n"
+    "}\n"
+    "\n"
+    "// Match a `:name`-bearing pattern against an actual path. Returns\n"
+    "// {\"match\": <bool>, \"params\": <json>} — params is empty when match is\n"
+    "// false. The two-key shape lets the caller tell \"no match\" from\n"
+    "// \"matched with zero params\" without a sentinel value.\n"
+    "func _wings_match_pattern(str pattern, str path) {\n"
+    "    array p_segs = _wings_split_path(pattern);\n"
+    "    array u_segs = _wings_split_path(path);\n"
+    "    if (length(p_segs) != length(u_segs)) {\n"
+    "        return {\"match\": false, \"params\": {}};\n"
+    "    }\n"
+    "    json params = {};\n"
+    "    for (int i = 0; i < length(p_segs); i++) {\n"
+    "        str ps = p_segs[i];\n"
+    "        str us = u_segs[i];\n"
+    "        if (length(ps) > 0 && substring(ps, 0, 1) == \":\") {\n"
+    "            // Capture: strip the leading `:`, store value under that name.\n"
+    "            str pname = substring(ps, 1, length(ps));\n"
+    "            params[pname] = us;\n"
+    "        } else {\n"
+    "            if (ps != us) {\n"
+    "                return {\"match\": false, \"params\": {}};\n"
+    "            }\n"
+    "        }\n"
+    "    }\n"
+    "    return {\"match\": true, \"params\": params};\n"
+    "}\n"
+    "\n"
+    "// Extended dispatch lookup that handles both exact and pattern routes.\n"
+    "// Returns {\"index\": <int>, \"params\": <json>} where index < 0 means no\n"
+    "// match. Populates _request[\"params\"] downstream so handlers can read\n"
+    "// captured values via `_request[\"params\"][\"name\"]`.\n"
+    "//\n"
+    "// The native `wings_find_route` builtin folds the exact + pattern\n"
+    "// two-pass walk into a single C call — replaces N × (`r[\"method\"]`,\n"
+    "// `r[\"path\"]`, `_wings_match_pattern` …) json hash hits with one\n"
+    "// memcmp-driven segment walk per request. The Tulpar wrapper is kept\n"
+    "// so user code calling `_find_route_with_params` directly still\n"
+    "// resolves, but the wings serve path now incurs a single native call\n"
+    "// per request.\n"
+    "func _find_route_with_params(str method, str path) {\n"
+    "    return wings_find_route(_routes, method, path);\n"
+    "}\n"
+    "\n"
+    "// Raw-response envelope detection. Handlers that need to bypass the\n"
+    "// default JSON serialisation (e.g. registry bytes, Prometheus\n"
+    "// exposition, plain-text health probes) return:\n"
+    "//   {\"_raw\": \"<body>\", \"_content_type\": \"text/plain; charset=utf-8\"}\n"
+    "// `_content_type` is optional and defaults to text/plain. Anything else\n"
+    "// in the dict is ignored — `_raw` is an all-or-nothing escape hatch.\n"
+    "func _wings_has_raw(json result) {\n"
+    "    array rk = keys(result);\n"
+    "    for (int i = 0; i < length(rk); i++) {\n"
+    "        if (rk[i] == \"_raw\") {\n"
+    "            return true;\n"
+    "        }\n"
+    "    }\n"
+    "    return false;\n"
+    "}\n"
+    "\n"
+    "// Optional status-code envelope. Handlers that want to return a\n"
+    "// non-200 status (`401` for auth failures, `404`s the handler computes\n"
+    "// itself, `409` for conflicts, `201` for creates, ...) include\n"
+    "// `\"_status\": <int>` in the response dict:\n"
+    "//\n"
+    "//   return {\"error\": \"conflict\", \"_status\": 409};\n"
+    "//   return {\"ok\": true, \"_status\": 201};\n"
+    "//\n"
+    "// Any positive integer is honored verbatim. The `_status` field (along\n"
+    "// with the other envelope meta keys `_stream`/`_raw`/`_content_type`) is\n"
+    "// read here for the HTTP status, then STRIPPED from the serialised JSON\n"
+    "// body by the native response builder — so `created(x)` returns a clean\n"
+    "// `{\"id\":1}` body with a `201` status line, not `{\"id\":1,\"_status\":201}`.\n"
+    "// Falls back to the caller-supplied default (200 for handler hits, 404\n"
+    "// for no-match) when absent or not an int. Both `_raw` and JSON paths see this.\n"
+    "func _wings_status_or(json result, int fallback) {\n"
+    "    array rk = keys(result);\n"
+    "    for (int i = 0; i < length(rk); i++) {\n"
+    "        if (rk[i] == \"_status\") {\n"
+    "            int s = result[\"_status\"];\n"
+    "            if (s > 0) {\n"
+    "                return s;\n"
+    "            }\n"
+    "            return fallback;\n"
+    "        }\n"
+    "    }\n"
+    "    return fallback;\n"
+    "}\n"
+    "\n"
+    "// Resolve a matched route to wire-byte response. This is the single\n"
+    "// dispatch point used by every serve loop (sync, async, evented) so\n"
+    "// the cache fast-path lives in one place instead of being duplicated\n"
+    "// across three serve sites.\n"
+    "//\n"
+    "// Cache fast path (only for routes registered via `cached_get`):\n"
+    "//   1. read `_wings_cache_wires[route_idx]`\n"
+    "//   2. if non-empty, this route's response was built on a prior\n"
+    "//      request — return the wire bytes directly, skipping the\n"
+    "//      handler call, toJson serialisation, and HTTP framing.\n"
+    "//\n"
+    "// Slow path (every uncached route, or first hit on a cached one):\n"
+    "//   1. dispatch the handler via `call()`\n"
+    "//   2. classify status into 2xx/4xx/5xx buckets for /metrics\n"
+    "//   3. build the wire response\n"
+    "//   4. on cached routes, store the wire bytes for future hits\n"
+    "//\n"
+    "// `_wings_requests_total` is always incremented exactly once per\n"
+    "// resolved request, regardless of cache hit/miss. Status bucketing\n"
+    "// on cache hits assumes 2xx — only success responses get cached\n"
+    "// (404 / 5xx bodies aren't worth pinning and would mask transient\n"
+    "// upstream failures).\n"
+    "func _wings_dispatch_cached(int route_idx, int keep) {\n"
+    "    // Global middleware chain — runs before cache check + handler, for every\n"
+    "    // serve mode (this is the single dispatch entry point). A middleware that\n"
+    "    // returns a response dict (`_status` set) short-circuits; `{}` continues.\n"
+    "    // Empty `_middleware` => the while loop never iterates (zero cost).\n"
+    "    int _mw_i = 0;\n"
+    "    int _mw_n = length(_middleware);\n"
+    "    while (_mw_i < _mw_n) {\n"
+    "        json _mres = call(_middleware[_mw_i], _request);\n"
+    "        int _mst = _mres[\"_status\"];\n"
+    "        if (_mst != 0) {\n"
+    "            _wings_requests_total = _wings_requests_total + 1;\n"
+    "            if (_mst >= 500) {\n"
+    "                _wings_requests_5xx = _wings_requests_5xx + 1;\n"
+    "            } else if (_mst >= 400) {\n"
+    "                _wings_requests_4xx = _wings_requests_4xx + 1;\n"
+    "            } else {\n"
+    "                _wings_requests_2xx = _wings_requests_2xx + 1;\n"
+    "            }\n"
+    "            _wings_last_status = _mst;\n"
+    "            return _wings_build_response(_mres, keep);\n"
+    "        }\n"
+    "        _mw_i = _mw_i + 1;\n"
+    "    }\n"
+    "\n"
+    "    json route = _routes[route_idx];\n"
+    "\n"
+    "    if (route[\"cached\"] == 1) {\n"
+    "        str cached = _wings_cache_wires[route_idx];\n"
+    "        if (length(cached) > 0) {\n"
+    "            // Conditional request: a client re-sending the ETag we served\n"
+    "            // gets an empty 304 instead of the full cached body.\n"
+    "            str _et = _wings_cache_etags[route_idx];\n"
+    "            if (length(_et) > 0) {\n"
+    "                str _inm = _hdr_ci(_request[\"headers\"], \"If-None-Match\");\n"
+    "                if (length(_inm) > 0 && trim(_inm) == _et) {\n"
+    "                    _wings_requests_total = _wings_requests_total + 1;\n"
+    "                    _wings_requests_2xx = _wings_requests_2xx + 1;\n"
+    "                    _wings_last_status = 304;\n"
+    "                    return http_create_response(304, \"application/json\", \"\",\n"
+    "                        {\"ETag\": _et}, keep);\n"
+    "                }\n"
+    "            }\n"
+    "            _wings_requests_total = _wings_requests_total + 1;\n"
+    "            _wings_requests_2xx = _wings_requests_2xx + 1;\n"
+    "            _wings_last_status = 200;\n"
+    "            return cached;\n"
+    "        }\n"
+    "    }\n"
+    "\n"
+    "    // Auto-parse the JSON body so handlers can read `_request[\"json\"]` without\n"
+    "    // calling fromJson() themselves. Empty/non-JSON bodies yield {}.\n"
+    "    _request[\"json\"] = _wings_parse_body(_request);\n"
+    "\n"
+    "    // Schema validation (opt-in via body_schema()). Runs BEFORE the handler so\n"
+    "    // a bad body short-circuits to 422 and never reaches user code. Routes with\n"
+    "    // no schema skip this entirely (route[\"schema\"] reads back as int 0).\n"
+    "    json _schema = route[\"schema\"];\n"
+    "    if (_schema) {\n"
+    "        json _verr = _wings_validate(_schema, _request[\"json\"]);\n"
+    "        int _vstatus = _verr[\"_status\"];\n"
+    "        if (_vstatus == 422) {\n"
+    "            _wings_requests_total = _wings_requests_total + 1;\n"
+    "            _wings_requests_4xx = _wings_requests_4xx + 1;\n"
+    "            _wings_last_status = 422;\n"
+    "            return _wings_build_response(_verr, keep);\n"
+    "        }\n"
+    "    }\n"
+    "\n"
+    "    // Route dependencies (Wings DI): resolve each before the handler. A\n"
+    "    // dependency returning a response dict (`_status` set) short-circuits;\n"
+    "    // otherwise its value is injected into `_wings_deps` for `dep(\"name\")`.\n"
+    "    json _dl = route[\"deps\"];\n"
+    "    if (typeof(_dl) == \"array\") {\n"
+    "        json _dvals = {};\n"
+    "        int _di = 0;\n"
+    "        while (_di < length(_dl)) {\n"
+    "            str _dname = _dl[_di];\n"
+    "            json _dres = call(_dname, _request);\n"
+    "            int _dst = _dres[\"_status\"];\n"
+    "            if (_dst != 0) {\n"
+    "                _wings_requests_total = _wings_requests_total + 1;\n"
+    "                if (_dst >= 500) {\n"
+    "                    _wings_requests_5xx = _wings_requests_5xx + 1;\n"
+    "                } else if (_dst >= 400) {\n"
+    "                    _wings_requests_4xx = _wings_requests_4xx + 1;\n"
+    "                } else {\n"
+    "                    _wings_requests_2xx = _wings_requests_2xx + 1;\n"
+    "                }\n"
+    "                _wings_last_status = _dst;\n"
+    "                return _wings_build_response(_dres, keep);\n"
+    "            } else {\n"
+    "                _dvals[_dname] = _dres;\n"
+    "            }\n"
+    "            _di = _di + 1;\n"
+    "        }\n"
+    "        _wings_deps = _dvals;\n"
+    "    }\n"
+    "\n"
+    "    // Every handler is handed the request object as its first argument, so it\n"
+    "    // can be written `func h(req) { req[\"params\"][\"id\"] }`. Handlers that take\n"
+    "    // no parameter simply ignore it (ABI-safe) and read the `_request` global\n"
+    "    // instead — both styles work.\n"
+    "    json result = call(route[\"handler\"], _request);\n"
+    "    _wings_requests_total = _wings_requests_total + 1;\n"
+    "    // Streaming handlers (SSE / WS upgrade / long-poll) signal\n"
+    "    // \"I've already written to the socket myself; don't try to\n"
+    "    // build a response envelope\" by returning `{\"_stream\": 1}`.\n"
+    "    // The serve loop sees the empty-string response and skips its\n"
+    "    // own socket_send + forces the connection closed (keep-alive\n"
+    "    // doesn't make sense after a stream — the handler picked the\n"
+    "    // moment the connection ends). Status is counted as 2xx; the\n"
+    "    // handler did its job successfully.\n"
+    "    int is_stream = result[\"_stream\"];\n"
+    "    if (is_stream == 1) {\n"
+    "        _wings_requests_2xx = _wings_requests_2xx + 1;\n"
+    "        _wings_last_status = 200;\n"
+    "        return \"\";\n"
+    "    }\n"
+    "    int eff_status = _wings_status_or(result, 200);\n"
+    "    _wings_last_status = eff_status;\n"
+    "    if (eff_status >= 500) {\n"
+    "        _wings_requests_5xx = _wings_requests_5xx + 1;\n"
+    "    } else if (eff_status >= 400) {\n"
+    "        _wings_requests_4xx = _wings_requests_4xx + 1;\n"
+    "    } else {\n"
+    "        _wings_requests_2xx = _wings_requests_2xx + 1;\n"
+    "    }\n"
+    "\n"
+    "    // Response model: shape successful output to the declared fields (drop\n"
+    "    // undeclared/secret keys). Errors (>=400) bypass so {error:...} survives.\n"
+    "    json _rm = route[\"response_model\"];\n"
+    "    if (_rm) {\n"
+    "        if (eff_status < 400) {\n"
+    "            if (typeof(result) == \"object\" &&\n"
+    "                (_wings_has_raw(result) || _wings_has_key(result, \"_stream\"))) {\n"
+    "                result = _wings_apply_response_model(_rm, result);\n"
+    "            } else {\n"
+    "                result = _wings_model_envelope(_rm, result);\n"
+    "            }\n"
+    "        }\n"
+    "    }\n"
+    "\n"
+    "    // Response compression (opt-in via enable_gzip()). Non-cached routes only:\n"
+    "    // cached_get pins ONE wire response for every client, and baking gzip into\n"
+    "    // it would serve compressed bytes to clients that never advertised\n"
+    "    // Accept-Encoding: gzip.\n"
+    "    if (_wings_gzip == 1 && route[\"cached\"] != 1) {\n"
+    "        str _ae = _hdr_ci(_request[\"headers\"], \"Accept-Encoding\");\n"
+    "        if (contains(lower(_ae), \"gzip\")) {\n"
+    "            str _gbody = \"\";\n"
+    "            str _gct = \"application/json\";\n"
+    "            if (_wings_has_raw(result)) {\n"
+    "                _gbody = result[\"_raw\"];\n"
+    "                str _ct0 = result[\"_content_type\"];\n"
+    "                if (length(_ct0) > 0) {\n"
+    "                    _gct = _ct0;\n"
+    "                } else {\n"
+    "                    _gct = \"text/plain; charset=utf-8\";\n"
+    "                }\n"
+    "            } else {\n"
+    "                _gbody = toJson(result);\n"
+    "            }\n"
+    "            if (length(_gbody) >= _wings_gzip_min) {\n"
+    "                str _gz = gzip_compress(_gbody);\n"
+    "                if (length(_gz) > 0 && length(_gz) < length(_gbody)) {\n"
+    "                    result[\"_raw\"] = _gz;\n"
+    "                    result[\"_content_type\"] = _gct;\n"
+    "                    json _ghh = result[\"_headers\"];\n"
+    "                    if (typeof(_ghh) != \"object\") {\n"
+    "                        _ghh = {};\n"
+    "                    }\n"
+    "                    _ghh[\"Content-Encoding\"] = \"gzip\";\n"
+    "                    _ghh[\"Vary\"] = \"Accept-Encoding\";\n"
+    "                    result[\"_headers\"] = _ghh;\n"
+    "                }\n"
+    "            }\n"
+    "        }\n"
+    "    }\n"
+    "\n"
+    "    // Cached routes get a strong ETag derived from the body, injected as a\n"
+    "    // response header BEFORE framing so the cached wire bytes carry it. The\n"
+    "    // etag is remembered in `_wings_cache_etags` for If-None-Match -> 304.\n"
+    "    str _etag = \"\";\n"
+    "    if (route[\"cached\"] == 1 && eff_status < 400) {\n"
+    "        str _ebody = \"\";\n"
+    "        if (_wings_has_raw(result)) {\n"
+    "            _ebody = result[\"_raw\"];\n"
+    "        } else {\n"
+    "            _ebody = toJson(result);\n"
+    "        }\n"
+    "        _etag = \"\\\"\" + substring(sha256(_ebody), 0, 16) + \"\\\"\";\n"
+    "        json _eh = result[\"_headers\"];\n"
+    "        if (typeof(_eh) != \"object\") {\n"
+    "            _eh = {};\n"
+    "        }\n"
+    "        _eh[\"ETag\"] = _etag;\n"
+    "        result[\"_headers\"] = _eh;\n"
+    "    }\n"
+    "\n"
+    "    str response = _wings_build_response(result, keep);\n"
+    "\n"
+    "    // First-hit cache population. Only 2xx responses get pinned —\n"
+    "    // pinning a 4xx/5xx would freeze a transient failure into the\n"
+    "    // hot path. `string_pin` copies the response out of the\n"
+    "    // per-request arena into permanent (malloc'd) storage so the\n"
+    "    // subsequent `arena_restore` doesn't reclaim the bytes the cache\n"
+    "    // points at. The keep flag is baked into the cached bytes; that's\n"
+    "    // fine because Connection is advisory and a close-requesting\n"
+    "    // client closes regardless of the server's hint.\n"
+    "    if (route[\"cached\"] == 1 && eff_status < 400) {\n"
+    "        _wings_cache_wires[route_idx] = string_pin(response);\n"
+    "        _wings_cache_etags[route_idx] = string_pin(_etag);\n"
+    "    }\n"
+    "\n"
+    "    return response;\n"
+    "}\n"
+    "\n"
+    "// Build the wire response for a dispatched handler. The native\n"
+    "// `wings_build_response` builtin folds the envelope check + JSON\n"
+    "// serialisation + response framing into a single C call, replacing\n"
+    "// three Tulpar function hops per request. Behaviour is identical to\n"
+    "// the prior all-Tulpar implementation:\n"
+    "//   * `_status`       overrides the 200 default\n"
+    "//   * `_raw`          uses the string verbatim as body (no JSON)\n"
+    "//   * `_content_type` Content-Type when `_raw` is set (else text/plain)\n"
+    "//   * otherwise       body = toJson(result), Content-Type = application/json\n"
+    "// The Tulpar wrapper is kept so library consumers calling\n"
+    "// `_wings_build_response` directly (uncommon, but legal) still resolve.\n"
+    "func _wings_build_response(json result, int keep) {\n"
+    "    return wings_build_response(result, _default_headers, keep);\n"
+    "}\n"
+    "\n"
+    "// ----- Static file serving -------------------------------------------------\n"
+    "// Mount a directory under a URL prefix. Files are served as a 404-fallback:\n"
+    "// after no route (exact or :param) matches, wings checks each mount and, if the\n"
+    "// path falls under a prefix and the file exists, returns it. So real routes\n"
+    "// always win; static is the catch-all. Path traversal (`..`) is rejected.\n"
+    "//\n"
+    "//   static(\"/static\", \"./public\");   // GET /static/app.css -> ./public/app.css\n"
+    "//\n"
+    "// Text assets (html/css/js/json/svg/txt) get a correct Content-Type; everything\n"
+    "// else falls back to application/octet-stream. Binary assets (e.g. PNG with\n"
+    "// embedded NULs) round-trip byte-exact — read_file/http_create_response are\n"
+    "// length-tracked, not strlen-based.\n"
+    "array _static_mounts = [];\n"
+    "\n"
+    "func static(str url_prefix, str dir) {\n"
+    "    json mount = {\"prefix\": url_prefix, \"dir\": dir};\n"
+    "    push(_static_mounts, mount);\n"
+    "}\n"
+    "\n"
+    "func _ends_with(str s, str suf) {\n"
+    "    int sl = length(s);\n"
+    "    int fl = length(suf);\n"
+    "    if (fl > sl) {\n"
+    "        return false;\n"
+    "    }\n"
+    "    str substr = substring(s, sl - fl, sl);\n"
+    "    return substr == suf;\n"
+    "}\n"
+    "\n"
+    "func _wings_content_type(str p) {\n"
+    "    if (_ends_with(p, \".html\")) {\n"
+    "        return \"text/html; charset=utf-8\";\n"
+    "    } else if (_ends_with(p, \".css\")) {\n"
+    "        return \"text/css; charset=utf-8\";\n"
+    "    } else if (_ends_with(p, \".js\")) {\n"
+    "        return \"application/javascript; charset=utf-8\";\n"
+    "    } else if (_ends_with(p, \".json\")) {\n"
+    "        return \"application/json; charset=utf-8\";\n"
+    "    } else if (_ends_with(p, \".svg\")) {\n"
+    "        return \"image/svg+xml\";\n"
+    "    } else if (_ends_with(p, \".png\")) {\n"
+    "        return \"image/png\";\n"
+    "    } else if (_ends_with(p, \".txt\")) {\n"
+    "        return \"text/plain; charset=utf-8\";\n"
+    "    }\n"
+    "    return \"application/octet-stream\";\n"
+    "}\n"
+    "\n"
+    "// Returns the file's wire response, or \"\" when no mount serves `path`.\n"
+    "func _wings_static_try(str path, int keep) {\n"
+    "    int i = 0;\n"
+    "    while (i < length(_static_mounts)) {\n"
+    "        json m = _static_mounts[i];\n"
+    "        str prefix = m[\"prefix\"];\n"
+    "        int plen = length(prefix);\n"
+    "        if (length(path) >= plen) {\n"
+    "            if (substring(path, 0, plen) == prefix) {\n"
+    "                str rel = substring(path, plen, length(path));\n"
+    "                if (contains(rel, \"..\") == false) {\n"
+    "                    // Directory-style request (mount root, or a trailing \"/\")\n"
+    "                    // serves index.html — so `static(\"/\", \"./public\")` answers\n"
+    "                    // GET / with public/index.html (SPA at root).\n"
+    "                    if (length(rel) == 0) {\n"
+    "                        rel = \"/index.html\";\n"
+    "                    } else if (substring(rel, length(rel) - 1, length(rel)) == \"/\") {\n"
+    "                        rel = rel + \"index.html\";\n"
+    "                    }\n"
+    "                    // Join dir + rel with exactly one \"/\" between them. With a\n"
+    "                    // prefix like \"/\" the leading slash is consumed from `rel`,\n"
+    "                    // so without this `\"./public\" + \"index.html\"` would become\n"
+    "                    // the bogus \"./publicindex.html\".\n"
+    "                    str dir = m[\"dir\"];\n"
+    "                    bool dir_slash = _ends_with(dir, \"/\");\n"
+    "                    bool rel_slash = (substring(rel, 0, 1) == \"/\");\n"
+    "                    if (dir_slash == true && rel_slash == true) {\n"
+    "                        rel = substring(rel, 1, length(rel));\n"
+    "                    } else if (dir_slash == false && rel_slash == false) {\n"
+    "                        dir = dir + \"/\";\n"
+    "                    }\n"
+    "                    str filepath = dir + rel;\n"
+    "                    str content = read_file(filepath);\n"
+    "                    if (length(content) > 0) {\n"
+    "                        return http_create_response(200, _wings_content_type(rel), content, _default_headers, keep);\n"
+    "                    }\n"
+    "                }\n"
+    "            }\n"
+    "        }\n"
+    "        i = i + 1;\n"
+    "    }\n"
+    "    return \"\";\n"
+    "}\n"
+    "\n"
+    "func _wings_build_404(str path, int keep) {\n"
+    "    // Static-file fallback: a static() mount may serve this path before 404.\n"
+    "    str _sw = _wings_static_try(path, keep);\n"
+    "    if (length(_sw) > 0) {\n"
+    "        return _sw;\n"
+    "    }\n"
+    "    str body = \"{\\\"error\\\":\\\"\" + http_status_text(404) +\n"
+    "        \"\\\",\\\"path\\\":\\\"\" + path + \"\\\"}\";\n"
+    "    return http_create_response(404, \"application/json\", body,\n"
+    "        _default_headers, keep);\n"
+    "}\n"
+    "\n"
+    "// HTTP HEAD support — RFC 9110 §9.3.2: \"The server SHOULD send the\n"
+    "// same header fields in response to a HEAD request as it would have\n"
+    "// sent if the request had been a GET\". We build the GET response\n"
+    "// normally (so Content-Length matches what GET would return) and then\n"
+    "// truncate everything after the headers / body separator. This also\n"
+    "// keeps healthcheck probes, uptime monitors and curl -I working\n"
+    "// without per-route HEAD handler registration.\n"
+    "func _wings_strip_response_body(str response) {\n"
+    "    int sep = indexOf(response, \"\\r\\n\\r\\n\");\n"
+    "    if (sep < 0) {\n"
+    "        return response;\n"
+    "    }\n"
+    "    return substring(response, 0, sep + 4);\n"
+    "}\n"
+    "\n"
+    "// ----- Built-in production helpers -----------------------------------------\n"
+    "//\n"
+    "// These are auto-registered when listen() is called: the user's app\n"
+    "// gets `/healthz` and `/metrics` for free, matching the de-facto k8s\n"
+    "// convention. Handlers can be replaced by registering the same paths\n"
+    "// before calling listen().\n"
+    "\n"
+    "func _wings_healthz() {\n"
+    "    return {\n"
+    "        \"status\": \"ok\",\n"
+    "        \"uptime_s\": timestamp() - _wings_started_at,\n"
+    "        \"now\": now_iso8601()\n"
+    "    };\n"
+    "}\n"
+    "\n"
+    "func _wings_metrics() {\n"
+    "    // Auto-detect format=prom in the query string. Routing on the query\n"
+    "    // string is the cheapest way to expose both shapes from the same path\n"
+    "    // until full content-negotiation lands.\n"
+    "    json q = _request[\"query\"];\n"
+    "    if (q) {\n"
+    "        str fmt = q[\"format\"];\n"
+    "        if (fmt == \"prom\") {\n"
+    "            // Raw envelope: the dispatcher serves `_raw` as the body\n"
+    "            // verbatim with `_content_type` as the response Content-Type.\n"
+    "            // Prom scrapers expect text/plain; version=0.0.4 explicitly.\n"
+    "            return {\n"
+    "                \"_raw\": wings_metrics_prom(),\n"
+    "                \"_content_type\": \"text/plain; version=0.0.4; charset=utf-8\"\n"
+    "            };\n"
+    "        }\n"
+    "    }\n"
+    "    return {\n"
+    "        \"uptime_s\": timestamp() - _wings_started_at,\n"
+    "        \"requests_total\": _wings_requests_total,\n"
+    "        \"requests_2xx\": _wings_requests_2xx,\n"
+    "        \"requests_4xx\": _wings_requests_4xx,\n"
+    "        \"requests_5xx\": _wings_requests_5xx,\n"
+    "        \"routes\": length(_routes),\n"
+    "        \"db\": db_stats(),\n"
+    "        \"arena\": arena_stats()\n"
+    "    };\n"
+    "}\n"
+    "\n"
+    "// Prometheus text exposition format. Same numbers, different shape — a\n"
+    "// scraper can hit `/metrics?format=prom` (or set `Accept: text/plain`,\n"
+    "// but Wings doesn't have content-negotiation yet so we go with the\n"
+    "// query-string switch).\n"
+    "//\n"
+    "// Format:\n"
+    "//   # HELP <name> <doc>\n"
+    "//   # TYPE <name> <gauge|counter>\n"
+    "//   <name> <value>\n"
+    "//\n"
+    "// Returned as a plain string so the user can wrap it in a `text/plain`\n"
+    "// response. We don't auto-register the prom handler — apps that want\n"
+    "// it call `wings_metrics_prom()` from their own /metrics handler.\n"
+    "func wings_metrics_prom() {\n"
+    "    int uptime = timestamp() - _wings_started_at;\n"
+    "    str s = \"# HELP tulpar_uptime_seconds Wings server uptime\\n\";\n"
+    "    s = s + \"# TYPE tulpar_uptime_seconds gauge\\n\";\n"
+    "    s = s + \"tulpar_uptime_seconds \" + toString(uptime) + \"\\n\";\n"
+    "    s = s + \"# HELP tulpar_requests_total HTTP requests served\\n\";\n"
+    "    s = s + \"# TYPE tulpar_requests_total counter\\n\";\n"
+    "    s = s + \"tulpar_requests_total \" + toString(_wings_requests_total) + \"\\n\";\n"
+    "    s = s + \"# HELP tulpar_requests_by_class HTTP requests grouped by status class\\n\";\n"
+    "    s = s + \"# TYPE tulpar_requests_by_class counter\\n\";\n"
+    "    s = s + \"tulpar_requests_by_class{class=\\\"2xx\\\"} \" + toString(_wings_requests_2xx) + \"\\n\";\n"
+    "    s = s + \"tulpar_requests_by_class{class=\\\"4xx\\\"} \" + toString(_wings_requests_4xx) + \"\\n\";\n"
+    "    s = s + \"tulpar_requests_by_class{class=\\\"5xx\\\"} \" + toString(_wings_requests_5xx) + \"\\n\";\n"
+    "    s = s + \"# HELP tulpar_routes_total Number of registered HTTP routes\\n\";\n"
+    "    s = s + \"# TYPE tulpar_routes_total gauge\\n\";\n"
+    "    s = s + \"tulpar_routes_total \" + toString(length(_routes)) + \"\\n\";\n"
+    "    // Prepared-statement cache (all db connections, all worker threads).\n"
+    "    json dbs = db_stats();\n"
+    "    s = s + \"# HELP tulpar_db_stmt_cache_hits_total Prepared-statement cache hits\\n\";\n"
+    "    s = s + \"# TYPE tulpar_db_stmt_cache_hits_total counter\\n\";\n"
+    "    s = s + \"tulpar_db_stmt_cache_hits_total \" + toString(dbs[\"stmt_cache_hits\"]) + \"\\n\";\n"
+    "    s = s + \"# HELP tulpar_db_stmt_cache_misses_total Prepared-statement cache misses (fresh prepares)\\n\";\n"
+    "    s = s + \"# TYPE tulpar_db_stmt_cache_misses_total counter\\n\";\n"
+    "    s = s + \"tulpar_db_stmt_cache_misses_total \" + toString(dbs[\"stmt_cache_misses\"]) + \"\\n\";\n"
+    "    s = s + \"# HELP tulpar_db_stmt_cache_evictions_total Statements evicted from the LRU cache\\n\";\n"
+    "    s = s + \"# TYPE tulpar_db_stmt_cache_evictions_total counter\\n\";\n"
+    "    s = s + \"tulpar_db_stmt_cache_evictions_total \" + toString(dbs[\"stmt_cache_evictions\"]) + \"\\n\";\n"
+    "    s = s + \"# HELP tulpar_db_group_commit_batches_total Transactions committed by group-commit writers\\n\";\n"
+    "    s = s + \"# TYPE tulpar_db_group_commit_batches_total counter\\n\";\n"
+    "    s = s + \"tulpar_db_group_commit_batches_total \" + toString(dbs[\"group_commit_batches\"]) + \"\\n\";\n"
+    "    s = s + \"# HELP tulpar_db_group_commit_writes_total Writes coalesced by group-commit writers\\n\";\n"
+    "    s = s + \"# TYPE tulpar_db_group_commit_writes_total counter\\n\";\n"
+    "    s = s + \"tulpar_db_group_commit_writes_total \" + toString(dbs[\"group_commit_writes\"]) + \"\\n\";\n"
+    "    // ARC frees (all threads). pending_bytes > 0 only under a free budget.\n"
+    "    json arc = arc_stats();\n"
+    "    s = s + \"# HELP tulpar_arc_freed_bytes_total Bytes released by reference counting\\n\";\n"
+    "    s = s + \"# TYPE tulpar_arc_freed_bytes_total counter\\n\";\n"
+    "    s = s + \"tulpar_arc_freed_bytes_total \" + toString(arc[\"freed_bytes\"]) + \"\\n\";\n"
+    "    s = s + \"# HELP tulpar_arc_deferred_bytes Bytes queued for freeing (TULPAR_ARC_FREE_BUDGET)\\n\";\n"
+    "    s = s + \"# TYPE tulpar_arc_deferred_bytes gauge\\n\";\n"
+    "    s = s + \"tulpar_arc_deferred_bytes \" + toString(arc[\"pending_bytes\"]) + \"\\n\";\n"
+    "    // Request arenas (all worker threads): mapped bytes now / at peak,\n"
+    "    // chain blocks, and how often idle threads gave surplus blocks back.\n"
+    "    json ar = arena_stats();\n"
+    "    s = s + \"# HELP tulpar_arena_bytes Arena memory currently mapped\\n\";\n"
+    "    s = s + \"# TYPE tulpar_arena_bytes gauge\\n\";\n"
+    "    s = s + \"tulpar_arena_bytes \" + toString(ar[\"bytes\"]) + \"\\n\";\n"
+    "    s = s + \"# HELP tulpar_arena_peak_bytes Highest arena memory mapped at once\\n\";\n"
+    "    s = s + \"# TYPE tulpar_arena_peak_bytes gauge\\n\";\n"
+    "    s = s + \"tulpar_arena_peak_bytes \" + toString(ar[\"peak_bytes\"]) + \"\\n\";\n"
+    "    s = s + \"# HELP tulpar_arena_blocks Arena blocks held by all threads\\n\";\n"
+    "    s = s + \"# TYPE tulpar_arena_blocks gauge\\n\";\n"
+    "    s = s + \"tulpar_arena_blocks \" + toString(ar[\"blocks\"]) + \"\\n\";\n"
+    "    s = s + \"# HELP tulpar_arena_trims_total Times a thread released surplus arena blocks\\n\";\n"
+    "    s = s + \"# TYPE tulpar_arena_trims_total counter\\n\";\n"
+    "    s = s + \"tulpar_arena_trims_total \" + toString(ar[\"trims\"]) + \"\\n\";\n"
+    "    s = s + \"# HELP tulpar_arena_huge_allocs_total Oversized allocations given their own mapping\\n\";\n"
+    "    s = s + \"# TYPE tulpar_arena_huge_allocs_total counter\\n\";\n"
+    "    s = s + \"tulpar_arena_huge_allocs_total \" + toString(ar[\"huge_allocs\"]) + \"\\n\";\n"
+    "    return s;\n"
+    "}\n"
+    "\n"
+    "// ----- Server-Sent Events (SSE) --------------------------------------------\n"
+    "//\n"
+    "// SSE is the half-duplex cousin of WebSockets: a long-lived HTTP/1.1\n"
+    "// response that streams `data: …\\n\\n` frames over a `text/event-stream`\n"
+    "// connection. The browser's `EventSource` API consumes them with one\n"
+    "// line of JS. Wings exposes two pieces:\n"
+    "//\n"
+    "//   1. `wings_sse_headers()` — the response status-line + headers\n"
+    "//      block. Send it once, immediately after accepting the request,\n"
+    "//      to upgrade the response to a stream.\n"
+    "//   2. `wings_sse_event(name, data)` — formats one event frame. Pass\n"
+    "//      an empty string for `name` to omit the `event:` line (the\n"
+    "//      browser will fire the default `message` event).\n"
+    "//\n"
+    "// Drive the stream by writing both into the connection's fd with\n"
+    "// `socket_send`. The handler should NOT return a normal envelope —\n"
+    "// wings can't both stream and build a single response, so SSE handlers\n"
+    "// `socket_close()` the fd themselves when the stream ends.\n"
+    "func wings_sse_headers() {\n"
+    "    str s = \"HTTP/1.1 200 OK\\r\\n\";\n"
+    "    s = s + \"Content-Type: text/event-stream\\r\\n\";\n"
+    "    s = s + \"Cache-Control: no-cache\\r\\n\";\n"
+    "    s = s + \"Connection: keep-alive\\r\\n\";\n"
+    "    s = s + \"Access-Control-Allow-Origin: *\\r\\n\";\n"
+    "    s = s + \"\\r\\n\";\n"
+    "    return s;\n"
+    "}\n"
+    "\n"
+    "func wings_sse_event(str name, str data) {\n"
+    "    str s = \"\";\n"
+    "    if (length(name) > 0) {\n"
+    "        s = s + \"event: \" + name + \"\\r\\n\";\n"
+    "    }\n"
+    "    // Multiline payloads need every line prefixed with `data: `.\n"
+    "    // For the common single-line JSON case, this is just one prefix\n"
+    "    // and one trailing blank line.\n"
+    "    s = s + \"data: \" + data + \"\\r\\n\\r\\n\";\n"
+    "    return s;\n"
+    "}\n"
+    "\n"
+    "// ----- WebSocket frame I/O helpers -----------------------------------------\n"
+    "//\n"
+    "// Three opcode constants + two send wrappers. The full\n"
+    "// `wings_ws_send_frame(fd, opcode, payload)` is still available for\n"
+    "// binary frames, ping/pong, etc.; these wrappers cover the 95% case\n"
+    "// (send text, send close, receive — and pong any ping we get).\n"
+    "\n"
+    "int WS_OPCODE_TEXT   = 1;\n"
+    "int WS_OPCODE_BINARY = 2;\n"
+    "int WS_OPCODE_CLOSE  = 8;\n"
+    "int WS_OPCODE_PING   = 9;\n"
+    "int WS_OPCODE_PONG   = 10;\n"
+    "\n"
+    "func wings_ws_send_text(int fd, str payload) {\n"
+    "    return wings_ws_send_frame(fd, WS_OPCODE_TEXT, payload);\n"
+    "}\n"
+    "\n"
+    "func wings_ws_send_close(int fd) {\n"
+    "    return wings_ws_send_frame(fd, WS_OPCODE_CLOSE, \"\");\n"
+    "}\n"
+    "\n"
+    "func wings_ws_send_pong(int fd, str payload) {\n"
+    "    return wings_ws_send_frame(fd, WS_OPCODE_PONG, payload);\n"
+    "}\n"
+    "\n"
+    "// ----- WebSocket upgrade helper --------------------------------------------\n"
+    "//\n"
+    "// `wings_ws_upgrade(req)` builds the 101 Switching Protocols response a\n"
+    "// WebSocket client expects after the GET-with-Upgrade-header handshake.\n"
+    "// The hard part — deriving Sec-WebSocket-Accept from the client's key\n"
+    "// per RFC 6455 §4.2.2 — is done in the `wings_ws_accept_key` native\n"
+    "// (sha1 + base64). The rest is plain header assembly.\n"
+    "//\n"
+    "// Returns the upgrade response string, ready to `socket_send`. The\n"
+    "// handler then owns the fd and can read/write frames at the socket\n"
+    "// level. Frame masking + opcode handling are left to user code today\n"
+    "// (WebSocket frame structure is documented enough that a 30-line\n"
+    "// Tulpar implementation is straightforward).\n"
+    "func wings_ws_upgrade(json req) {\n"
+    "    json hdrs = req[\"headers\"];\n"
+    "    str key = \"\";\n"
+    "    if (hdrs) {\n"
+    "        key = hdrs[\"Sec-WebSocket-Key\"];\n"
+    "        if (length(key) == 0) {\n"
+    "            key = hdrs[\"sec-websocket-key\"];\n"
+    "        }\n"
+    "    }\n"
+    "    if (length(key) == 0) {\n"
+    "        return \"HTTP/1.1 400 Bad Request\\r\\nContent-Length: 0\\r\\n\\r\\n\";\n"
+    "    }\n"
+    "    str accept_key = wings_ws_accept_key(key);\n"
+    "    str s = \"HTTP/1.1 101 Switching Protocols\\r\\n\";\n"
+    "    s = s + \"Upgrade: websocket\\r\\n\";\n"
+    "    s = s + \"Connection: Upgrade\\r\\n\";\n"
+    "    s = s + \"Sec-WebSocket-Accept: \" + accept_key + \"\\r\\n\";\n"
+    "    s = s + \"\\r\\n\";\n"
+    "    return s;\n"
+    "}\n"
+    "\n"
+    "// Structured access log entry — call from any handler that wants its\n"
+    "// own log line in the same format as Wings' built-in access log. The\n"
+    "// shape mirrors common JSON log conventions (`@timestamp`, `level`,\n"
+    "// `msg`) so log aggregators don't need a custom parser.\n"
+    "func log_info(str msg) {\n"
+    "    print(toJson({\n"
+    "        \"@timestamp\": now_iso8601(),\n"
+    "        \"level\": \"info\",\n"
+    "        \"msg\": msg\n"
+    "    }));\n"
+    "}\n"
+    "\n"
+    "func log_error(str msg) {\n"
+    "    print(toJson({\n"
+    "        \"@timestamp\": now_iso8601(),\n"
+    "        \"level\": \"error\",\n"
+    "        \"msg\": msg\n"
+    "    }));\n"
+    "}\n"
+    "\n"
+    "// ----- Multi-threaded request serving --------------------------------------\n"
+    "//\n"
+    "// `listen_async(port)` accepts on the main thread and spawns a detached\n"
+    "// worker per accepted TCP connection. Each worker runs the same\n"
+    "// keep-alive request loop as the synchronous `listen()` and dispatches\n"
+    "// its handler **without any cross-worker lock** — recv, parse,\n"
+    "// `_request = req`, the handler call, response build and send all run\n"
+    "// in parallel across worker threads.\n"
+    "//\n"
+    "// What makes this race-free:\n"
+    "//   * `_request` is marked thread-local at the LLVM level\n"
+    "//     (`global_needs_tls()` in src/aot/llvm_backend.cpp), so each\n"
+    "//     worker mutates its own copy. A handler reading `_request[\"body\"]`\n"
+    "//     sees the request that *its* worker just stored, never the one a\n"
+    "//     sibling worker is mid-update on.\n"
+    "//   * `_routes` and `_default_headers` are write-once-at-startup and\n"
+    "//     read-only during request serving.\n"
+    "//   * Counter increments (`_wings_requests_total`, `_2xx`, etc.) are\n"
+    "//     deliberately unlocked — see the comment on their declaration.\n"
+    "//\n"
+    "// VM path: `thread_create` in the VM doesn't actually spawn an OS\n"
+    "// thread (it's an inline call back into the same interpreter), so the\n"
+    "// VM serves connections sequentially anyway. The lock-free design is\n"
+    "// safe there too — there are simply no concurrent writers to race on.\n"
+    "func _wings_serve_connection(json client_arg) {\n"
+    "    int client = client_arg;\n"
+    "    int wm = arena_save();\n"
+    "\n"
+    "    while (true) {\n"
+    "        str raw = http_recv_request(client, _wings_max_body_bytes);\n"
+    "        if (length(raw) == 0) {\n"
+    "            break;\n"
+    "        }\n"
+    "        json req = http_parse_request(raw);\n"
+    "        int keep = http_should_keepalive(req);\n"
+    "\n"
+    "        _request = req;\n"
+    "        // Surface the connection fd to streaming handlers via a\n"
+    "        // dedicated thread-local rather than `_request[k] = client`.\n"
+    "        // The latter shape triggers the (still-open) wings cookies\n"
+    "        // miscompile: a single `_request[k] = ...` followed by\n"
+    "        // another subscript write later corrupts the object.\n"
+    "        wings_set_current_fd(client);\n"
+    "        str method = req[\"method\"];\n"
+    "        str path = req[\"path\"];\n"
+    "        float _t0 = clock_ms();\n"
+    "        // CORS preflight short-circuit. Browsers send `OPTIONS` before\n"
+    "        // any \"non-simple\" request (custom headers like `Authorization`,\n"
+    "        // PUT/DELETE, JSON body) and require a 2xx response WITH the\n"
+    "        // Access-Control-Allow-* headers attached, or they reject the\n"
+    "        // real request as \"preflight failed\". We don't want every route\n"
+    "        // to register a manual OPTIONS handler, so wings answers any\n"
+    "        // preflight with 204 + the default CORS header set.\n"
+    "        //\n"
+    "        // Counted as a 2xx (not skipped from /metrics) so the operator\n"
+    "        // can see preflight traffic if it ever spikes — useful when a\n"
+    "        // browser client is hammering the API in a tight loop.\n"
+    "        bool is_options = (method == \"OPTIONS\");\n"
+    "        if (is_options) {\n"
+    "            _request[\"params\"] = {};\n"
+    "            _request[\"cookies\"] = {};\n"
+    "            _wings_requests_total = _wings_requests_total + 1;\n"
+    "            _wings_requests_2xx = _wings_requests_2xx + 1;\n"
+    "            str preflight = http_create_response(\n"
+    "                204, \"text/plain; charset=utf-8\", \"\", _default_headers, keep);\n"
+    "            socket_send(client, preflight);\n"
+    "            _wings_log_request(method, path, 204, clock_ms() - _t0, length(preflight));\n"
+    "            arena_restore(wm);\n"
+    "            if (keep == 0) {\n"
+    "                break;\n"
+    "            }\n"
+    "            continue;\n"
+    "        }\n"
+    "\n"
+    "        // Two-pass dispatch (exact + pattern). Returns\n"
+    "        // {\"index\": <int>, \"params\": <json>}; index < 0 means no match.\n"
+    "        json route_match = _find_route_with_params(method, path);\n"
+    "        int route_idx = route_match[\"index\"];\n"
+    "        // HEAD fallback: if no match for HEAD, retry the lookup as GET\n"
+    "        // (still pattern-aware) and strip the body before sending.\n"
+    "        // Standard HTTP behaviour expected by uptime probes / healthcheckers.\n"
+    "        bool is_head = false;\n"
+    "        if (route_idx < 0 && method == \"HEAD\") {\n"
+    "            route_match = _find_route_with_params(\"GET\", path);\n"
+    "            route_idx = route_match[\"index\"];\n"
+    "            is_head = true;\n"
+    "        }\n"
+    "        // Captured path params land in _request[\"params\"] for the\n"
+    "        // handler to read. Empty json when route had no `:name` segments.\n"
+    "        _request[\"params\"] = route_match[\"params\"];\n"
+    "        _request[\"cookies\"] = wings_cookies(req);\n"
+    "        _request[\"remote_addr\"] = socket_peer_ip(client);\n"
+    "        str response = \"\";\n"
+    "        int status = 200;\n"
+    "        if (route_idx >= 0) {\n"
+    "            // Cache lookup + handler dispatch + counter bump + response\n"
+    "            // build all live in `_wings_dispatch_cached` so the\n"
+    "            // sync/async/evented serve loops stay in lockstep.\n"
+    "            response = _wings_dispatch_cached(route_idx, keep);\n"
+    "            status = _wings_last_status;\n"
+    "        } else {\n"
+    "            _wings_requests_total = _wings_requests_total + 1;\n"
+    "            _wings_requests_4xx = _wings_requests_4xx + 1;\n"
+    "            response = _wings_build_404(path, keep);\n"
+    "            status = 404;\n"
+    "        }\n"
+    "        _wings_log_request(method, path, status, clock_ms() - _t0, length(response));\n"
+    "        if (is_head) {\n"
+    "            response = _wings_strip_response_body(response);\n"
+    "        }\n"
+    "\n"
+    "        // Empty response = streaming handler already wrote to the\n"
+    "        // socket and signalled `{\"_stream\": 1}`. Skip our send and\n"
+    "        // force-close: keep-alive across a stream boundary would\n"
+    "        // strand connection state.\n"
+    "        if (length(response) == 0) {\n"
+    "            arena_restore(wm);\n"
+    "            break;\n"
+    "        }\n"
+    "        socket_send(client, response);\n"
+    "        arena_restore(wm);\n"
+    "\n"
+    "        if (keep == 0) {\n"
+    "            break;\n"
+    "        }\n"
+    "    }\n"
+    "    // Release this connection's arena checkpoint (not just rewind it). Pool\n"
+    "    // workers call this once per connection in a persistent thread; without the\n"
+    "    // drop the 32-slot checkpoint stack exhausts after 32 connections and the\n"
+    "    // per-request arena reset silently stops → unbounded leak under churn.\n"
+    "    arena_drop(wm);\n"
+    "    socket_close(client);\n"
+    "}\n"
+    "\n"
+    "// Single-step request server: receive one request on `client`, dispatch\n"
+    "// the matching route, send the response, and return the keep-alive\n"
+    "// flag (1 = caller should keep the fd open in the event-loop poll set,\n"
+    "// 0 = caller should close it). This is the unit that `listen_evented`\n"
+    "// drives once per POLLIN event — multiplexing many connections across\n"
+    "// a single thread without per-connection thread overhead.\n"
+    "//\n"
+    "// Internally mirrors the body of `_wings_serve_connection`'s loop —\n"
+    "// arena save/restore, route lookup, counter increment, response build —\n"
+    "// but exits after one request instead of looping. When we add real\n"
+    "// edge-triggered async I/O later, this is the function that grows a\n"
+    "// state machine; today it stays blocking-per-step which is fine for\n"
+    "// the typical < 64 KiB JSON request/response we see in practice.\n"
+    "func _wings_serve_one_request(int client) {\n"
+    "    int wm = arena_save();\n"
+    "    str raw = http_recv_request(client, _wings_max_body_bytes);\n"
+    "    if (length(raw) == 0) {\n"
+    "        arena_drop(wm);\n"
+    "        return 0;\n"
+    "    }\n"
+    "    json req = http_parse_request(raw);\n"
+    "    int keep = http_should_keepalive(req);\n"
+    "\n"
+    "    _request = req;\n"
+    "    wings_set_current_fd(client);\n"
+    "    str method = req[\"method\"];\n"
+    "    str path = req[\"path\"];\n"
+    "    float _t0 = clock_ms();\n"
+    "    bool is_options = (method == \"OPTIONS\");\n"
+    "    if (is_options) {\n"
+    "        _request[\"params\"] = {};\n"
+    "        _request[\"cookies\"] = {};\n"
+    "        _wings_requests_total = _wings_requests_total + 1;\n"
+    "        _wings_requests_2xx = _wings_requests_2xx + 1;\n"
+    "        str preflight = http_create_response(\n"
+    "            204, \"text/plain; charset=utf-8\", \"\", _default_headers, keep);\n"
+    "        socket_send(client, preflight);\n"
+    "        _wings_log_request(method, path, 204, clock_ms() - _t0, length(preflight));\n"
+    "        arena_drop(wm);\n"
+    "        return keep;\n"
+    "    }\n"
+    "\n"
+    "    json route_match = _find_route_with_params(method, path);\n"
+    "    int route_idx = route_match[\"index\"];\n"
+    "    bool is_head = false;\n"
+    "    if (route_idx < 0 && method == \"HEAD\") {\n"
+    "        route_match = _find_route_with_params(\"GET\", path);\n"
+    "        route_idx = route_match[\"index\"];\n"
+    "        is_head = true;\n"
+    "    }\n"
+    "    _request[\"params\"] = route_match[\"params\"];\n"
+    "    _request[\"cookies\"] = wings_cookies(req);\n"
+    "\n"
+    "    str response = \"\";\n"
+    "    int status = 200;\n"
+    "    if (route_idx >= 0) {\n"
+    "        // Shared dispatch (cache fast-path + handler + counters + build).\n"
+    "        response = _wings_dispatch_cached(route_idx, keep);\n"
+    "        status = _wings_last_status;\n"
+    "    } else {\n"
+    "        _wings_requests_total = _wings_requests_total + 1;\n"
+    "        _wings_requests_4xx = _wings_requests_4xx + 1;\n"
+    "        response = _wings_build_404(path, keep);\n"
+    "        status = 404;\n"
+    "    }\n"
+    "    _wings_log_request(method, path, status, clock_ms() - _t0, length(response));\n"
+    "    if (is_head) {\n"
+    "        response = _wings_strip_response_body(response);\n"
+    "    }\n"
+    "    // Empty response from a streaming handler — see the comment in\n"
+    "    // `_wings_serve_connection`. Force the caller to close by\n"
+    "    // returning keep=0.\n"
+    "    if (length(response) == 0) {\n"
+    "        arena_drop(wm);\n"
+    "        return 0;\n"
+    "    }\n"
+    "    socket_send(client, response);\n"
+    "    arena_drop(wm);\n"
+    "    return keep;\n"
+    "}\n"
+    "\n"
+    "// Single-thread, poll()-multiplexed event loop. Cross-platform via\n"
+    "// WSAPoll on Windows + POSIX poll() everywhere else. Trade-offs vs\n"
+    "// the other listeners:\n"
+    "//\n"
+    "//   * `listen`        — sync, one connection at a time. Simplest, slow.\n"
+    "//   * `listen_async`  — thread-per-connection. Best for short bursts.\n"
+    "//   * `listen_pool`   — pre-spawned thread pool. Best sustained RPS.\n"
+    "//   * `listen_evented`— single thread, multiplexed. Best for many idle\n"
+    "//                        keep-alive conns (chat clients, dashboards) —\n"
+    "//                        bounded memory, zero per-conn thread overhead.\n"
+    "//\n"
+    "// Blocking semantics inside `_wings_serve_one_request` keep this honest\n"
+    "// for typical < 64 KiB JSON traffic; while serving conn A, conn B's\n"
+    "// inbound bytes pool in the kernel buffer until B's slot fires POLLIN\n"
+    "// next iteration. Real edge-triggered I/O with partial-read state\n"
+    "// machines is a follow-up — not needed yet for \"Python kadar kolay\" goals.\n"
+    "func listen_evented(int port) {\n"
+    "    if (_find_route(\"GET\", \"/healthz\") < 0) {\n"
+    "        get(\"/healthz\", \"_wings_healthz\");\n"
+    "    }\n"
+    "    if (_find_route(\"GET\", \"/metrics\") < 0) {\n"
+    "        get(\"/metrics\", \"_wings_metrics\");\n"
+    "    }\n"
+    "    // Auto-docs: interactive Swagger UI at /docs backed by /openapi.json,\n"
+    "    // generated from the registered routes + their body_schema()s. Opt-out by\n"
+    "    // claiming either path yourself, or disable with TULPAR_WINGS_NODOCS=1.\n"
+    "    if (length(env(\"TULPAR_WINGS_NODOCS\")) == 0) {\n"
+    "        if (_find_route(\"GET\", \"/openapi.json\") < 0) {\n"
+    "            get(\"/openapi.json\", \"_wings_openapi_json\");\n"
+    "        }\n"
+    "        if (_find_route(\"GET\", \"/docs\") < 0) {\n"
+    "            get(\"/docs\", \"_wings_docs_html\");\n"
+    "        }\n"
+    "    }\n"
+    "    _wings_apply_env_config();\n"
+    "    _wings_started_at = timestamp();\n"
+    "\n"
+    "    _wings_print_banner(port, \"single-thread event loop\");\n"
+    "\n"
+    "    int server = socket_server(_wings_bind_host(), port);\n"
+    "    if (server < 0) {\n"
+    "        _wings_bind_failed(port);\n"
+    "        return;\n"
+    "    }\n"
+    "    socket_set_nonblocking(server);\n"
+    "\n"
+    "    json fds = [];\n"
+    "    push(fds, server);  // index 0 = listen socket\n"
+    "\n"
+    "    while (true) {\n"
+    "        // Per-tick arena scope: the poll result, the rebuilt fd set and the\n"
+    "        // closed-slot map are all transient and must be reclaimed each\n"
+    "        // iteration or the poll loop leaks ~per-request. `fds` itself is the\n"
+    "        // one persistent array (allocated before the loop) — we mutate it in\n"
+    "        // place at the bottom rather than reassigning it to a transient array,\n"
+    "        // so arena_drop can't free it out from under the next tick.\n"
+    "        int _evt_wm = arena_save();\n"
+    "        // 1s tick gives the loop a chance to bail / be interrupted.\n"
+    "        json ready = socket_poll(fds, 1000);\n"
+    "        if (length(ready) == 0) {\n"
+    "            arena_drop(_evt_wm);\n"
+    "            continue;\n"
+    "        }\n"
+    "\n"
+    "        // Build the next-iteration fd set from scratch — keeps logic\n"
+    "        // simple at the cost of O(n) per tick. Tracks which slots got\n"
+    "        // closed this iteration so we don't carry their fd forward.\n"
+    "        json next_fds = [];\n"
+    "        push(next_fds, server);\n"
+    "        json closed = {};\n"
+    "\n"
+    "        for (int i = 0; i < length(ready); i++) {\n"
+    "            int idx = ready[i];\n"
+    "            if (idx == 0) {\n"
+    "                // Listen socket fired — drain accept queue.\n"
+    "                while (true) {\n"
+    "                    int client = socket_accept(server);\n"
+    "                    if (client < 0) {\n"
+    "                        break;\n"
+    "                    }\n"
+    "                    push(next_fds, client);\n"
+    "                }\n"
+    "            } else {\n"
+    "                int client_fd = fds[idx];\n"
+    "                int keep = _wings_serve_one_request(client_fd);\n"
+    "                if (keep == 0) {\n"
+    "                    socket_close(client_fd);\n"
+    "                    closed[toString(idx)] = 1;\n"
+    "                } else {\n"
+    "                    push(next_fds, client_fd);\n"
+    "                }\n"
+    "            }\n"
+    "        }\n"
+    "\n"
+    "        // Carry over still-open clients that didn't fire this tick.\n"
+    "        for (int i = 1; i < length(fds); i++) {\n"
+    "            // Was this slot ready (and thus already handled above)?\n"
+    "            bool was_ready = false;\n"
+    "            for (int j = 0; j < length(ready); j++) {\n"
+    "                if (ready[j] == i) { was_ready = true; break; }\n"
+    "            }\n"
+    "            if (was_ready == false) {\n"
+    "                push(next_fds, fds[i]);\n"
+    "            }\n"
+    "        }\n"
+    "\n"
+    "        // Commit survivors into the persistent `fds` in place (clear, then\n"
+    "        // refill) so the transient `next_fds`/`ready`/`closed` are freed by\n"
+    "        // the arena_drop below instead of accumulating tick after tick.\n"
+    "        while (length(fds) > 0) {\n"
+    "            pop(fds);\n"
+    "        }\n"
+    "        for (int k = 0; k < length(next_fds); k++) {\n"
+    "            push(fds, next_fds[k]);\n"
+    "        }\n"
+    "        arena_drop(_evt_wm);\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Pre-spawned worker pool. Each worker thread is a perpetual\n"
+    "// `accept()` loop on the shared listening socket. The kernel serialises\n"
+    "// concurrent accept() across processes/threads, so only one worker\n"
+    "// wakes per incoming connection — no thundering-herd pause and no\n"
+    "// thread-creation cost per request.\n"
+    "//\n"
+    "// This is the \"thread pool\" middle ground between sync `listen` (one\n"
+    "// in-flight request) and `listen_async` (one OS thread per request).\n"
+    "// At 1k req/s, listen_async creates 1000 threads/sec; listen_pool\n"
+    "// reuses N. Empirically 4-16 workers saturate a single CPU core's\n"
+    "// worth of HTTP work; tune to physical cores for CPU-bound handlers.\n"
+    "//\n"
+    "// The socket fd is boxed into a `json` parameter because\n"
+    "// `thread_create` passes its argument through the canonical VMValue\n"
+    "// ABI rather than a native i64 register; the worker unboxes on entry.\n"
+    "// This is the same pattern `listen_async` uses for per-conn fds.\n"
+    "func _wings_pool_worker(json server_box) {\n"
+    "    int server = server_box;\n"
+    "    while (true) {\n"
+    "        int client = socket_accept(server);\n"
+    "        if (client < 0) {\n"
+    "            continue;\n"
+    "        }\n"
+    "        // Reuse the existing per-connection serve function — keep-alive\n"
+    "        // loop, arena reset, request counters, etc. all already there.\n"
+    "        json c = client;\n"
+    "        _wings_serve_connection(c);\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "func listen_pool(int port, int n_workers) {\n"
+    "    // `n_workers <= 0` -> auto-detect logical CPU count. The previous\n"
+    "    // fallback was a hardcoded `4` regardless of host; on a 4-vCPU CI\n"
+    "    // runner that happened to fit, but `listen_pool(port, 8)` would\n"
+    "    // over-subscribe and degrade by ~25% under high-concurrency load\n"
+    "    // because 8 threads thrashed for 4 cores. Auto-detect makes the\n"
+    "    // common case (\"pick a sensible default\") match the host.\n"
+    "    if (n_workers < 1) {\n"
+    "        n_workers = cpu_count();\n"
+    "    }\n"
+    "    if (_find_route(\"GET\", \"/healthz\") < 0) {\n"
+    "        get(\"/healthz\", \"_wings_healthz\");\n"
+    "    }\n"
+    "    if (_find_route(\"GET\", \"/metrics\") < 0) {\n"
+    "        get(\"/metrics\", \"_wings_metrics\");\n"
+    "    }\n"
+    "    // Auto-docs: interactive Swagger UI at /docs backed by /openapi.json,\n"
+    "    // generated from the registered routes + their body_schema()s. Opt-out by\n"
+    "    // claiming either path yourself, or disable with TULPAR_WINGS_NODOCS=1.\n"
+    "    if (length(env(\"TULPAR_WINGS_NODOCS\")) == 0) {\n"
+    "        if (_find_route(\"GET\", \"/openapi.json\") < 0) {\n"
+    "            get(\"/openapi.json\", \"_wings_openapi_json\");\n"
+    "        }\n"
+    "        if (_find_route(\"GET\", \"/docs\") < 0) {\n"
+    "            get(\"/docs\", \"_wings_docs_html\");\n"
+    "        }\n"
+    "    }\n"
+    "    _wings_apply_env_config();\n"
+    "    _wings_started_at = timestamp();\n"
+    "\n"
+    "    _wings_print_banner(port, \"worker pool, \" + toString(n_workers));\n"
+    "\n"
+    "    int server = socket_server(_wings_bind_host(), port);\n"
+    "    if (server < 0) {\n"
+    "        _wings_bind_failed(port);\n"
+    "        return;\n"
+    "    }\n"
+    "\n"
+    "    // Spawn N worker threads, each blocks on accept() of the same\n"
+    "    // listening socket. The first kernel-delivered connection wakes\n"
+    "    // exactly one worker.\n"
+    "    for (int i = 0; i < n_workers; i = i + 1) {\n"
+    "        json sb = server;\n"
+    "        int t = thread_create(_wings_pool_worker, sb);\n"
+    "        thread_detach(t);\n"
+    "    }\n"
+    "\n"
+    "    // Main thread parks. A \"Ctrl+C breaks out\" loop is enough — no\n"
+    "    // need to also serve from main. Keeping main idle simplifies\n"
+    "    // shutdown signalling once we add it.\n"
+    "    while (true) {\n"
+    "        sleep(60000);\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "func listen_async(int port) {\n"
+    "    if (_find_route(\"GET\", \"/healthz\") < 0) {\n"
+    "        get(\"/healthz\", \"_wings_healthz\");\n"
+    "    }\n"
+    "    if (_find_route(\"GET\", \"/metrics\") < 0) {\n"
+    "        get(\"/metrics\", \"_wings_metrics\");\n"
+    "    }\n"
+    "    // Auto-docs: interactive Swagger UI at /docs backed by /openapi.json,\n"
+    "    // generated from the registered routes + their body_schema()s. Opt-out by\n"
+    "    // claiming either path yourself, or disable with TULPAR_WINGS_NODOCS=1.\n"
+    "    if (length(env(\"TULPAR_WINGS_NODOCS\")) == 0) {\n"
+    "        if (_find_route(\"GET\", \"/openapi.json\") < 0) {\n"
+    "            get(\"/openapi.json\", \"_wings_openapi_json\");\n"
+    "        }\n"
+    "        if (_find_route(\"GET\", \"/docs\") < 0) {\n"
+    "            get(\"/docs\", \"_wings_docs_html\");\n"
+    "        }\n"
+    "    }\n"
+    "    _wings_apply_env_config();\n"
+    "    _wings_started_at = timestamp();\n"
+    "\n"
+    "    _wings_print_banner(port, \"multi-threaded\");\n"
+    "\n"
+    "    int server = socket_server(_wings_bind_host(), port);\n"
+    "    if (server < 0) {\n"
+    "        _wings_bind_failed(port);\n"
+    "        return;\n"
+    "    }\n"
+    "\n"
+    "    while (true) {\n"
+    "        int client = socket_accept(server);\n"
+    "        if (client < 0) {\n"
+    "            continue;\n"
+    "        }\n"
+    "        // Box the fd into a json so `thread_create` passes it through\n"
+    "        // the canonical VMValue ABI rather than a native i64 register.\n"
+    "        // The worker unboxes on entry.\n"
+    "        json c = client;\n"
+    "        int t = thread_create(_wings_serve_connection, c);\n"
+    "        thread_detach(t);\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// ----- OpenAPI auto-generation ---------------------------------------------\n"
+    "//\n"
+    "// Walks the registered routes and emits a minimal OpenAPI 3.0 document\n"
+    "// (the JSON Swagger UI / Postman / Insomnia consume directly). We\n"
+    "// don't infer types or response schemas — just methods and paths plus\n"
+    "// a placeholder 200 response. Fancier shapes (request/response models,\n"
+    "// auth) are a richer-route-metadata feature for a later iteration.\n"
+    "//\n"
+    "// Usage:\n"
+    "//   func openapi_handler() { return wings_openapi(\"My API\", \"1.0\"); }\n"
+    "//   get(\"/openapi.json\", \"openapi_handler\");\n"
+    "//\n"
+    "// The returned object is a json that toJson()/json_response can turn\n"
+    "// straight into a wire payload.\n"
+    "// Map a body_schema() field type to a JSON-Schema \"type\" string.\n"
+    "func _wings_oapi_type(str want) {\n"
+    "    if (want == \"int\")    { return \"integer\"; }\n"
+    "    if (want == \"num\")    { return \"number\"; }\n"
+    "    if (want == \"float\")  { return \"number\"; }\n"
+    "    if (want == \"bool\")   { return \"boolean\"; }\n"
+    "    if (want == \"array\")  { return \"array\"; }\n"
+    "    if (want == \"object\") { return \"object\"; }\n"
+    "    if (want == \"json\")   { return \"object\"; }\n"
+    "    return \"string\"; // str, any\n"
+    "}\n"
+    "\n"
+    "// Turn a body_schema() into an OpenAPI requestBody object (properties +\n"
+    "// required list), so /docs renders the exact shape the validator enforces.\n"
+    "// Turn one field spec (simple string or rich object) into a JSON-Schema\n"
+    "// property, carrying constraints across so /docs stays truthful. Recurses for\n"
+    "// array `items` and nested `object` schemas.\n"
+    "func _wings_oapi_prop(json spec) {\n"
+    "    str st = typeof(spec);\n"
+    "    if (st == \"string\") {\n"
+    "        return {\"type\": _wings_oapi_type(spec)};\n"
+    "    }\n"
+    "    str want = spec[\"type\"];\n"
+    "    json p = {\"type\": _wings_oapi_type(want)};\n"
+    "    if (want == \"str\") {\n"
+    "        if (_wings_has_key(spec, \"min\"))   { p[\"minLength\"] = spec[\"min\"]; }\n"
+    "        if (_wings_has_key(spec, \"max\"))   { p[\"maxLength\"] = spec[\"max\"]; }\n"
+    "        if (_wings_has_key(spec, \"regex\")) { p[\"pattern\"]   = spec[\"regex\"]; }\n"
+    "    } else if (want == \"int\" || want == \"float\" || want == \"num\") {\n"
+    "        if (_wings_has_key(spec, \"min\")) { p[\"minimum\"] = spec[\"min\"]; }\n"
+    "        if (_wings_has_key(spec, \"max\")) { p[\"maximum\"] = spec[\"max\"]; }\n"
+    "    } else if (want == \"array\") {\n"
+    "        if (_wings_has_key(spec, \"min\"))   { p[\"minItems\"] = spec[\"min\"]; }\n"
+    "        if (_wings_has_key(spec, \"max\"))   { p[\"maxItems\"] = spec[\"max\"]; }\n"
+    "        if (_wings_has_key(spec, \"items\")) { p[\"items\"] = _wings_oapi_prop(spec[\"items\"]); }\n"
+    "    } else if (want == \"object\") {\n"
+    "        if (_wings_has_key(spec, \"schema\")) {\n"
+    "            json inner = _wings_oapi_props(spec[\"schema\"]);\n"
+    "            p[\"properties\"] = inner[\"properties\"];\n"
+    "            if (_wings_has_key(inner, \"required\")) { p[\"required\"] = inner[\"required\"]; }\n"
+    "        }\n"
+    "    }\n"
+    "    return p;\n"
+    "}\n"
+    "\n"
+    "// Turn a {field: spec} schema map into JSON-Schema {properties, required}.\n"
+    "// Shared by the requestBody builder and nested-object recursion above.\n"
+    "func _wings_oapi_props(json schema) {\n"
+    "    json props = {};\n"
+    "    array required = [];\n"
+    "    for (k in keys(schema)) {\n"
+    "        json spec = schema[k];\n"
+    "        str name = k;\n"
+    "        int klen = length(k);\n"
+    "        if (klen > 0 && substring(k, klen - 1, klen) == \"?\") {\n"
+    "            name = substring(k, 0, klen - 1);\n"
+    "        } else {\n"
+    "            push(required, k);\n"
+    "        }\n"
+    "        props[name] = _wings_oapi_prop(spec);\n"
+    "    }\n"
+    "    json out = {\"properties\": props};\n"
+    "    if (length(required) > 0) {\n"
+    "        out[\"required\"] = required;\n"
+    "    }\n"
+    "    return out;\n"
+    "}\n"
+    "\n"
+    "func _wings_oapi_body(json schema) {\n"
+    "    json inner = _wings_oapi_props(schema);\n"
+    "    json sch = {\"type\": \"object\", \"properties\": inner[\"properties\"]};\n"
+    "    if (_wings_has_key(inner, \"required\")) {\n"
+    "        sch[\"required\"] = inner[\"required\"];\n"
+    "    }\n"
+    "    return {\"required\": true, \"content\": {\"application/json\": {\"schema\": sch}}};\n"
+    "}\n"
+    "\n"
+    "// Rewrite a Wings route path into OpenAPI form: `/users/:id` -> `/users/{id}`,\n"
+    "// which is what Swagger UI expects to bind path parameters.\n"
+    "func _wings_oapi_path(str path) {\n"
+    "    array segs = _wings_split_path(path);\n"
+    "    str out = \"\";\n"
+    "    for (s in segs) {\n"
+    "        str seg = s;\n"
+    "        if (length(s) > 0 && substring(s, 0, 1) == \":\") {\n"
+    "            seg = \"{\" + substring(s, 1, length(s)) + \"}\";\n"
+    "        }\n"
+    "        out = out + \"/\" + seg;\n"
+    "    }\n"
+    "    return out;\n"
+    "}\n"
+    "\n"
+    "// Derive OpenAPI path-parameter objects from `:name` segments in a route path.\n"
+    "func _wings_oapi_params(str path) {\n"
+    "    array params = [];\n"
+    "    array segs = _wings_split_path(path);\n"
+    "    for (s in segs) {\n"
+    "        if (length(s) > 0 && substring(s, 0, 1) == \":\") {\n"
+    "            str pname = substring(s, 1, length(s));\n"
+    "            push(params, {\"name\": pname, \"in\": \"path\", \"required\": true,\n"
+    "                          \"schema\": {\"type\": \"string\"}});\n"
+    "        }\n"
+    "    }\n"
+    "    return params;\n"
+    "}\n"
+    "\n"
+    "func wings_openapi(str title, str version) {\n"
+    "    json paths = {};\n"
+    "    for (int i = 0; i < length(_routes); i++) {\n"
+    "        json r = _routes[i];\n"
+    "        str path = r[\"path\"];\n"
+    "        str oapi_path = _wings_oapi_path(path);\n"
+    "        str method_lc = lower(r[\"method\"]);\n"
+    "        // OpenAPI keys path objects on the URL; multiple verbs on the\n"
+    "        // same path land on the same key. We build per-path on-demand.\n"
+    "        json existing = paths[oapi_path];\n"
+    "        if (!existing) {\n"
+    "            existing = {};\n"
+    "        }\n"
+    "        json op = {\n"
+    "            \"summary\": r[\"handler\"],\n"
+    "            \"responses\": {\"200\": {\"description\": \"OK\"}}\n"
+    "        };\n"
+    "        // `:id`-style path params become OpenAPI parameters.\n"
+    "        array pparams = _wings_oapi_params(path);\n"
+    "        if (length(pparams) > 0) {\n"
+    "            op[\"parameters\"] = pparams;\n"
+    "        }\n"
+    "        // A body_schema() drives both requestBody and the 422 response doc.\n"
+    "        json rsch = r[\"schema\"];\n"
+    "        if (rsch) {\n"
+    "            op[\"requestBody\"] = _wings_oapi_body(rsch);\n"
+    "            op[\"responses\"][\"422\"] = {\"description\": \"Validation Error\"};\n"
+    "        }\n"
+    "        // A response_model() documents the 200 body shape (the exact fields\n"
+    "        // the output filter lets through).\n"
+    "        json rmod = r[\"response_model\"];\n"
+    "        if (rmod) {\n"
+    "            json rin = _wings_oapi_props(rmod);\n"
+    "            json rsch200 = {\"type\": \"object\", \"properties\": rin[\"properties\"]};\n"
+    "            if (_wings_has_key(rin, \"required\")) {\n"
+    "                rsch200[\"required\"] = rin[\"required\"];\n"
+    "            }\n"
+    "            op[\"responses\"][\"200\"] = {\"description\": \"OK\",\n"
+    "                \"content\": {\"application/json\": {\"schema\": rsch200}}};\n"
+    "        }\n"
+    "        existing[method_lc] = op;\n"
+    "        paths[oapi_path] = existing;\n"
+    "    }\n"
+    "    json doc = {\n"
+    "        \"openapi\": \"3.0.0\",\n"
+    "        \"info\": {\"title\": title, \"version\": version},\n"
+    "        \"paths\": paths\n"
+    "    };\n"
+    "    // jwt_guard() (or docs_security(\"bearer\")) advertises bearer auth so\n"
+    "    // Swagger UI shows the Authorize button and sends the header.\n"
+    "    if (_wings_docs_bearer == 1) {\n"
+    "        doc[\"components\"] = {\"securitySchemes\": {\"bearerAuth\":\n"
+    "            {\"type\": \"http\", \"scheme\": \"bearer\", \"bearerFormat\": \"JWT\"}}};\n"
+    "        doc[\"security\"] = [{\"bearerAuth\": []}];\n"
+    "    }\n"
+    "    return doc;\n"
+    "}\n"
+    "\n"
+    "// Manually advertise a security scheme in /openapi.json (jwt_guard does this\n"
+    "// automatically). Today only \"bearer\" is recognised.\n"
+    "func docs_security(str scheme) {\n"
+    "    if (scheme == \"bearer\") {\n"
+    "        _wings_docs_bearer = 1;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Optional: set the title/version shown in /docs and /openapi.json.\n"
+    "//   docs_info(\"Users API\", \"2.1.0\");   // call before serve()\n"
+    "func docs_info(str title, str version) {\n"
+    "    _wings_title = title;\n"
+    "    _wings_version = version;\n"
+    "}\n"
+    "\n"
+    "// Auto-route handlers for the built-in docs endpoints (registered by listen()).\n"
+    "func _wings_openapi_json() {\n"
+    "    return wings_openapi(_wings_title, _wings_version);\n"
+    "}\n"
+    "\n"
+    "func _wings_docs_html() {\n"
+    "    str html = \"<!DOCTYPE html><html lang=\\\"en\\\"><head><meta charset=\\\"utf-8\\\">\" +\n"
+    "        \"<title>\" + _wings_title + \" — Docs</title>\" +\n"
+    "        \"<link rel=\\\"stylesheet\\\" href=\\\"https://unpkg.com/swagger-ui-dist/swagger-ui.css\\\">\" +\n"
+    "        \"</head><body><div id=\\\"swagger-ui\\\"></div>\" +\n"
+    "        \"<script src=\\\"https://unpkg.com/swagger-ui-dist/swagger-ui-bundle.js\\\"></script>\" +\n"
+    "        \"<script>window.onload=function(){SwaggerUIBundle({url:'/openapi.json',\" +\n"
+    "        \"dom_id:'#swagger-ui'});};</script></body></html>\";\n"
+    "    return {\"_raw\": html, \"_content_type\": \"text/html; charset=utf-8\"};\n"
+    "}\n"
+    "\n"
+    "// ----- Server loop ---------------------------------------------------------\n"
+    "func listen(int port) {\n"
+    "    // Auto-register /healthz and /metrics if the user hasn't already\n"
+    "    // claimed those paths. This is opt-out: just register your own\n"
+    "    // GET handler for the same path before calling listen().\n"
+    "    if (_find_route(\"GET\", \"/healthz\") < 0) {\n"
+    "        get(\"/healthz\", \"_wings_healthz\");\n"
+    "    }\n"
+    "    if (_find_route(\"GET\", \"/metrics\") < 0) {\n"
+    "        get(\"/metrics\", \"_wings_metrics\");\n"
+    "    }\n"
+    "    // Auto-docs: interactive Swagger UI at /docs backed by /openapi.json,\n"
+    "    // generated from the registered routes + their body_schema()s. Opt-out by\n"
+    "    // claiming either path yourself, or disable with TULPAR_WINGS_NODOCS=1.\n"
+    "    if (length(env(\"TULPAR_WINGS_NODOCS\")) == 0) {\n"
+    "        if (_find_route(\"GET\", \"/openapi.json\") < 0) {\n"
+    "            get(\"/openapi.json\", \"_wings_openapi_json\");\n"
+    "        }\n"
+    "        if (_find_route(\"GET\", \"/docs\") < 0) {\n"
+    "            get(\"/docs\", \"_wings_docs_html\");\n"
+    "        }\n"
+    "    }\n"
+    "    _wings_apply_env_config();\n"
+    "    _wings_started_at = timestamp();\n"
+    "\n"
+    "    // Resolve the port + bind first so the banner shows the real port (the\n"
+    "    // default path may have walked past a busy 8484).\n"
+    "    json _bind = _wings_bind(port);\n"
+    "    int server = _bind[\"fd\"];\n"
+    "    if (server < 0) {\n"
+    "        _wings_bind_failed(port);\n"
+    "        return;\n"
+    "    }\n"
+    "    int _port = _bind[\"port\"];\n"
+    "\n"
+    "    _wings_print_banner(_port, \"\");\n"
+    "\n"
+    "    // Arena watermark taken once at server start. Every request below\n"
+    "    // saves/restores against this baseline so transient request\n"
+    "    // allocations (parsed request, response string, JSON serialisation)\n"
+    "    // are recycled, not accumulated. Routes + _default_headers were\n"
+    "    // allocated before this point and stay live forever.\n"
+    "    int _wings_arena_wm = arena_save();\n"
+    "\n"
+    "    while (true) {\n"
+    "        int client = socket_accept(server);\n"
+    "        if (client < 0) {\n"
+    "            continue;\n"
+    "        }\n"
+    "\n"
+    "        while (true) {\n"
+    "            str raw = http_recv_request(client, _wings_max_body_bytes);\n"
+    "            if (length(raw) == 0) {\n"
+    "                break;\n"
+    "            }\n"
+    "            json req = http_parse_request(raw);\n"
+    "            _request = req;\n"
+    "            wings_set_current_fd(client);\n"
+    "\n"
+    "            str method = req[\"method\"];\n"
+    "            str path = req[\"path\"];\n"
+    "            float _t0 = clock_ms();\n"
+    "\n"
+    "            int keep = http_should_keepalive(req);\n"
+    "\n"
+    "            // CORS preflight short-circuit — see the matching block\n"
+    "            // in `listen()` for the full rationale (browsers reject a\n"
+    "            // 4xx preflight even when CORS headers are present, so\n"
+    "            // OPTIONS gets a synthetic 204 with the default header set).\n"
+    "            if (method == \"OPTIONS\") {\n"
+    "                _request[\"params\"] = {};\n"
+    "                _request[\"cookies\"] = {};\n"
+    "                str preflight = http_create_response(\n"
+    "                    204, \"text/plain; charset=utf-8\", \"\", _default_headers, keep);\n"
+    "                socket_send(client, preflight);\n"
+    "                _wings_log_request(method, path, 204, clock_ms() - _t0, length(preflight));\n"
+    "                _wings_requests_total = _wings_requests_total + 1;\n"
+    "                _wings_requests_2xx = _wings_requests_2xx + 1;\n"
+    "                arena_restore(_wings_arena_wm);\n"
+    "                if (keep == 0) {\n"
+    "                    break;\n"
+    "                }\n"
+    "                continue;\n"
+    "            }\n"
+    "\n"
+    "            // Two-pass dispatch (exact + pattern). _request gets a\n"
+    "            // populated `params` key before the handler runs.\n"
+    "            json route_match = _find_route_with_params(method, path);\n"
+    "            int route_idx = route_match[\"index\"];\n"
+    "            // HEAD fallback to (pattern-aware) GET handler; body stripped\n"
+    "            // after build so Content-Length still matches GET's payload.\n"
+    "            bool is_head = false;\n"
+    "            if (route_idx < 0 && method == \"HEAD\") {\n"
+    "                route_match = _find_route_with_params(\"GET\", path);\n"
+    "                route_idx = route_match[\"index\"];\n"
+    "                is_head = true;\n"
+    "            }\n"
+    "            _request[\"params\"] = route_match[\"params\"];\n"
+    "            _request[\"cookies\"] = wings_cookies(req);\n"
+    "            str response = \"\";\n"
+    "            int status = 200;\n"
+    "            if (route_idx >= 0) {\n"
+    "                // Shared dispatch (cache fast-path + handler + counters + build).\n"
+    "                response = _wings_dispatch_cached(route_idx, keep);\n"
+    "                status = _wings_last_status;\n"
+    "            } else {\n"
+    "                _wings_requests_total = _wings_requests_total + 1;\n"
+    "                _wings_requests_4xx = _wings_requests_4xx + 1;\n"
+    "                response = _wings_build_404(path, keep);\n"
+    "                status = 404;\n"
+    "            }\n"
+    "            _wings_log_request(method, path, status, clock_ms() - _t0, length(response));\n"
+    "            if (is_head) {\n"
+    "                response = _wings_strip_response_body(response);\n"
+    "            }\n"
+    "\n"
+    "            // Empty response → streaming handler took over the socket.\n"
+    "            // Close + bail; keep-alive doesn't survive a stream.\n"
+    "            if (length(response) == 0) {\n"
+    "                arena_restore(_wings_arena_wm);\n"
+    "                break;\n"
+    "            }\n"
+    "            socket_send(client, response);\n"
+    "\n"
+    "            // Per-request arena reset: keeps memory bounded even on a\n"
+    "            // single long-lived keep-alive connection. Anything the\n"
+    "            // handler returned via _request / response is owned by this\n"
+    "            // arena scope and goes away here. Handlers must NOT stash\n"
+    "            // arena pointers on globals.\n"
+    "            arena_restore(_wings_arena_wm);\n"
+    "\n"
+    "            if (keep == 0) {\n"
+    "                break;\n"
+    "            }\n"
+    "        }\n"
+    "        socket_close(client);\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// ============================================================================\n"
+    "// Wings DX katmanı (WINGS_DX.md) — kısa isimler + resource()\n"
+    "// ----------------------------------------------------------------------------\n"
+    "// Adlandırma standardı (WINGS_DX §4): public API'de `wings_` öneki yok; istek\n"
+    "// okuyanlar UFCS ile `req.x(...)` diye okunur; özellik açan çağrı özelliğin\n"
+    "// adıdır. Eski isimler kırılmaz — aşağıdaki sarmalayıcılar delege eder.\n"
+    "// ============================================================================\n"
+    "\n"
+    "// --- kısa isim alias'ları ----------------------------------------------------\n"
+    "func cookies(json req)              { return wings_cookies(req); }\n"
+    "func ws_upgrade(json req)           { return wings_ws_upgrade(req); }\n"
+    "func ws_send(int fd, str payload)   { return wings_ws_send_text(fd, payload); }\n"
+    "func ws_close(int fd)               { return wings_ws_send_close(fd); }\n"
+    "func ws_pong(int fd, str payload)   { return wings_ws_send_pong(fd, payload); }\n"
+    "func sse_headers()                  { return wings_sse_headers(); }\n"
+    "func sse_event(str name, str data)  { return wings_sse_event(name, data); }\n"
+    "func metrics_prom()                 { return wings_metrics_prom(); }\n"
+    "\n"
+    "// gzip([min_bytes]) — enable_gzip'in isim-stili karşılığı (cors/rate_limit\n"
+    "// gibi). gzip() → varsayılan eşik, gzip(256) → 256 bayt üstünü sıkıştır.\n"
+    "func gzip(int min_bytes)            { return enable_gzip(min_bytes); }\n"
+    "\n"
+    "// delete(path, handler) — HTTP fiiliyle birebir route kaydı (del aliası).\n"
+    "func delete(str path, str handler)  { return del(path, handler); }\n"
+    "\n"
+    "// accepts/returns — istek/cevap şeması çifti (body_schema/response_model'in\n"
+    "// tek-kelimeli karşılığı):\n"
+    "//   post(\"/users\", create_user);  accepts({\"name\": \"str\", \"age?\": \"int\"});\n"
+    "//   get(\"/users/:id\", show_user); returns({\"id\": \"int\", \"name\": \"str\"});\n"
+    "func accepts(json schema)           { return body_schema(schema); }\n"
+    "func returns(json schema)           { return response_model(schema); }\n"
+    "\n"
+    "// ============================================================================\n"
+    "// resource(path, Model[, opts]) — model handle'dan otomatik REST CRUD\n"
+    "// ----------------------------------------------------------------------------\n"
+    "//   import \"wings\";\n"
+    "//   import \"orm\";\n"
+    "//   database(\"notes.db\");\n"
+    "//   json Note = model(\"notes\", {\"id\": \"pk\", \"title\": \"str!\", \"done\": \"bool\"});\n"
+    "//   resource(\"/notes\", Note);   // 5 route + 422 şema + /docs otomatik\n"
+    "//   serve();\n"
+    "//\n"
+    "// Kaydedilenler: GET path (index), GET path/:id (show), POST path (create —\n"
+    "// modelden türetilmiş body_schema ile), PUT path/:id (update), DELETE\n"
+    "// path/:id (destroy). opts: {\"only\": [\"index\", \"show\"]} ya da\n"
+    "// {\"except\": [\"destroy\"]}.\n"
+    "//\n"
+    "// wings orm'u import ETMEZ: Model = {\"table\", \"db\", \"schema\"} sözleşmesine\n"
+    "// uyan her handle çalışır; CRUD'u `_wings_res_db_*` iç helper'ları db_*\n"
+    "// builtin'leriyle (her zaman parametreli SQL) yapar.\n"
+    "// ============================================================================\n"
+    "\n"
+    "array _wings_resources = [];\n"
+    "\n"
+    "func _wings_res_qident(str s) {\n"
+    "    return \"\\\"\" + replace(s, \"\\\"\", \"\\\"\\\"\") + \"\\\"\";\n"
+    "}\n"
+    "\n"
+    "// bool kolonları true/false'a çevir (orm _orm_cast_row ile aynı sözleşme).\n"
+    "func _wings_res_db_cast(json m, json row) {\n"
+    "    json schema = m[\"schema\"];\n"
+    "    json out = {};\n"
+    "    for (k in keys(row)) {\n"
+    "        bool casted = false;\n"
+    "        if (_wings_has_key(schema, k)) {\n"
+    "            str t = schema[k];\n"
+    "            if (t == \"bool\") {\n"
+    "                out[k] = toInt(toString(row[k])) == 1;\n"
+    "                casted = true;\n"
+    "            }\n"
+    "        }\n"
+    "        if (!casted) {\n"
+    "            out[k] = row[k];\n"
+    "        }\n"
+    "    }\n"
+    "    return out;\n"
+    "}\n"
+    "\n"
+    "func _wings_res_db_all(json m) {\n"
+    "    array rows = db_query(m[\"db\"], \"SELECT * FROM \" + _wings_res_qident(m[\"table\"]), []);\n"
+    "    array out = [];\n"
+    "    for (r in rows) {\n"
+    "        push(out, _wings_res_db_cast(m, r));\n"
+    "    }\n"
+    "    return out;\n"
+    "}\n"
+    "\n"
+    "func _wings_res_db_find(json m, int id) {\n"
+    "    str sql = \"SELECT * FROM \" + _wings_res_qident(m[\"table\"]) + \" WHERE id = ? LIMIT 1\";\n"
+    "    array rows = db_query(m[\"db\"], sql, [id]);\n"
+    "    if (length(rows) == 0) {\n"
+    "        json empty = {};\n"
+    "        return empty;\n"
+    "    }\n"
+    "    return _wings_res_db_cast(m, rows[0]);\n"
+    "}\n"
+    "\n"
+    "// keys(attrs) ∩ schema, pk hariç — 0/\"\"/false dâhil her mevcut anahtar\n"
+    "// yazılır, şema dışı anahtarlar düşer (request body passthrough).\n"
+    "func _wings_res_db_insert(json m, json attrs) {\n"
+    "    json schema = m[\"schema\"];\n"
+    "    str cols = \"\";\n"
+    "    str qs = \"\";\n"
+    "    array vals = [];\n"
+    "    bool first_col = true;\n"
+    "    for (k in keys(attrs)) {\n"
+    "        if (_wings_has_key(schema, k)) {\n"
+    "            str t = schema[k];\n"
+    "            if (t != \"pk\") {\n"
+    "                if (!first_col) {\n"
+    "                    cols = cols + \", \";\n"
+    "                    qs = qs + \", \";\n"
+    "                }\n"
+    "                cols = cols + _wings_res_qident(k);\n"
+    "                qs = qs + \"?\";\n"
+    "                push(vals, attrs[k]);\n"
+    "                first_col = false;\n"
+    "            }\n"
+    "        }\n"
+    "    }\n"
+    "    str sql = \"INSERT INTO \" + _wings_res_qident(m[\"table\"]) +\n"
+    "        \" (\" + cols + \") VALUES (\" + qs + \")\";\n"
+    "    db_execute(m[\"db\"], sql, vals);\n"
+    "    return db_last_insert_id(m[\"db\"]);\n"
+    "}\n"
+    "\n"
+    "func _wings_res_db_update(json m, int id, json attrs) {\n"
+    "    json schema = m[\"schema\"];\n"
+    "    str sets = \"\";\n"
+    "    array vals = [];\n"
+    "    bool first_col = true;\n"
+    "    for (k in keys(attrs)) {\n"
+    "        if (_wings_has_key(schema, k)) {\n"
+    "            str t = schema[k];\n"
+    "            if (t != \"pk\") {\n"
+    "                if (!first_col) { sets = sets + \", \"; }\n"
+    "                sets = sets + _wings_res_qident(k) + \" = ?\";\n"
+    "                push(vals, attrs[k]);\n"
+    "                first_col = false;\n"
+    "            }\n"
+    "        }\n"
+    "    }\n"
+    "    if (first_col) {\n"
+    "        return 0;\n"
+    "    }\n"
+    "    push(vals, id);\n"
+    "    str sql = \"UPDATE \" + _wings_res_qident(m[\"table\"]) + \" SET \" + sets + \" WHERE id = ?\";\n"
+    "    db_execute(m[\"db\"], sql, vals);\n"
+    "    return 1;\n"
+    "}\n"
+    "\n"
+    "func _wings_res_db_delete(json m, int id) {\n"
+    "    str sql = \"DELETE FROM \" + _wings_res_qident(m[\"table\"]) + \" WHERE id = ?\";\n"
+    "    db_execute(m[\"db\"], sql, [id]);\n"
+    "}\n"
+    "\n"
+    "// Kayıtlı resource'u base path'iyle bul ({} = yok).\n"
+    "func _wings_res_model(str base) {\n"
+    "    for (r in _wings_resources) {\n"
+    "        if (r[\"base\"] == base) {\n"
+    "            return r[\"model\"];\n"
+    "        }\n"
+    "    }\n"
+    "    json empty = {};\n"
+    "    return empty;\n"
+    "}\n"
+    "\n"
+    "// \"/notes/3\" → \"/notes\" (son segmenti at) — show/update/destroy kendi\n"
+    "// resource'unu istek path'inden bulur.\n"
+    "func _wings_res_parent(str path) {\n"
+    "    array parts = split(path, \"/\");\n"
+    "    int n = length(parts) - 1;\n"
+    "    str out = \"\";\n"
+    "    int i = 0;\n"
+    "    while (i < n) {\n"
+    "        if (i > 0) { out = out + \"/\"; }\n"
+    "        out = out + parts[i];\n"
+    "        i = i + 1;\n"
+    "    }\n"
+    "    return out;\n"
+    "}\n"
+    "\n"
+    "// Model şemasından body_schema türet: \"tip!\" → zorunlu, tip → opsiyonel\n"
+    "// (\"kolon?\"); pk ve ham SQL tanımları doğrulamaya girmez.\n"
+    "func _wings_res_schema(json m) {\n"
+    "    json schema = m[\"schema\"];\n"
+    "    json out = {};\n"
+    "    for (k in keys(schema)) {\n"
+    "        str t = schema[k];\n"
+    "        if (t == \"str!\")   { out[k] = \"str\"; }\n"
+    "        if (t == \"int!\")   { out[k] = \"int\"; }\n"
+    "        if (t == \"float!\") { out[k] = \"float\"; }\n"
+    "        if (t == \"str\")    { out[k + \"?\"] = \"str\"; }\n"
+    "        if (t == \"int\")    { out[k + \"?\"] = \"int\"; }\n"
+    "        if (t == \"float\")  { out[k + \"?\"] = \"float\"; }\n"
+    "        if (t == \"bool\")   { out[k + \"?\"] = \"bool\"; }\n"
+    "    }\n"
+    "    return out;\n"
+    "}\n"
+    "\n"
+    "func _wings_res_in(json arr, str s) {\n"
+    "    for (x in arr) {\n"
+    "        if (x == s) { return true; }\n"
+    "    }\n"
+    "    return false;\n"
+    "}\n"
+    "\n"
+    "// opts {\"only\": [...]} / {\"except\": [...]} filtresi. opts verilmemişse\n"
+    "// (default-arg 0 pad'i) tüm aksiyonlar açık.\n"
+    "func _wings_res_on(json opts, str action) {\n"
+    "    if (!opts) { return true; }\n"
+    "    if (_wings_has_key(opts, \"only\")) {\n"
+    "        return _wings_res_in(opts[\"only\"], action);\n"
+    "    }\n"
+    "    if (_wings_has_key(opts, \"except\")) {\n"
+    "        return !_wings_res_in(opts[\"except\"], action);\n"
+    "    }\n"
+    "    return true;\n"
+    "}\n"
+    "\n"
+    "// --- jenerik handler'lar ------------------------------------------------------\n"
+    "\n"
+    "func _wings_res_index(req) {\n"
+    "    json m = _wings_res_model(req[\"path\"]);\n"
+    "    if (length(keys(m)) == 0) { return server_error(\"resource not registered\"); }\n"
+    "    array rows = _wings_res_db_all(m);\n"
+    "    return ok({\"data\": rows, \"count\": length(rows)});\n"
+    "}\n"
+    "\n"
+    "func _wings_res_show(req) {\n"
+    "    json m = _wings_res_model(_wings_res_parent(req[\"path\"]));\n"
+    "    if (length(keys(m)) == 0) { return server_error(\"resource not registered\"); }\n"
+    "    int id = toInt(req.params.id);\n"
+    "    json row = _wings_res_db_find(m, id);\n"
+    "    if (length(keys(row)) == 0) { return not_found(\"record \" + toString(id) + \" not found\"); }\n"
+    "    return ok(row);\n"
+    "}\n"
+    "\n"
+    "func _wings_res_create(req) {\n"
+    "    json m = _wings_res_model(req[\"path\"]);\n"
+    "    if (length(keys(m)) == 0) { return server_error(\"resource not registered\"); }\n"
+    "    int id = _wings_res_db_insert(m, req.json);\n"
+    "    return created(_wings_res_db_find(m, id));\n"
+    "}\n"
+    "\n"
+    "func _wings_res_update(req) {\n"
+    "    json m = _wings_res_model(_wings_res_parent(req[\"path\"]));\n"
+    "    if (length(keys(m)) == 0) { return server_error(\"resource not registered\"); }\n"
+    "    int id = toInt(req.params.id);\n"
+    "    json row = _wings_res_db_find(m, id);\n"
+    "    if (length(keys(row)) == 0) { return not_found(\"record \" + toString(id) + \" not found\"); }\n"
+    "    _wings_res_db_update(m, id, req.json);\n"
+    "    return ok(_wings_res_db_find(m, id));\n"
+    "}\n"
+    "\n"
+    "func _wings_res_destroy(req) {\n"
+    "    json m = _wings_res_model(_wings_res_parent(req[\"path\"]));\n"
+    "    if (length(keys(m)) == 0) { return server_error(\"resource not registered\"); }\n"
+    "    int id = toInt(req.params.id);\n"
+    "    json row = _wings_res_db_find(m, id);\n"
+    "    if (length(keys(row)) == 0) { return not_found(\"record \" + toString(id) + \" not found\"); }\n"
+    "    _wings_res_db_delete(m, id);\n"
+    "    return no_content();\n"
+    "}\n"
+    "\n"
+    "// --- kayıt ---------------------------------------------------------------------\n"
+    "\n"
+    "func resource(str path, json m, json opts) {\n"
+    "    // Sondaki \"/\" normalize edilir; group() prefix'i base'e dahil edilir.\n"
+    "    str p = path;\n"
+    "    if (length(p) > 1) {\n"
+    "        if (substring(p, length(p) - 1, length(p)) == \"/\") {\n"
+    "            p = substring(p, 0, length(p) - 1);\n"
+    "        }\n"
+    "    }\n"
+    "    push(_wings_resources, {\"base\": _route_prefix + p, \"model\": m});\n"
+    "\n"
+    "    if (_wings_res_on(opts, \"index\"))  { get(p, \"_wings_res_index\"); }\n"
+    "    if (_wings_res_on(opts, \"show\"))   { get(p + \"/:id\", \"_wings_res_show\"); }\n"
+    "    if (_wings_res_on(opts, \"create\")) {\n"
+    "        post(p, \"_wings_res_create\");\n"
+    "        body_schema(_wings_res_schema(m));\n"
+    "    }\n"
+    "    if (_wings_res_on(opts, \"update\")) {\n"
+    "        put(p + \"/:id\", \"_wings_res_update\");\n"
+    "        body_schema(_wings_res_schema(m));\n"
+    "    }\n"
+    "    if (_wings_res_on(opts, \"destroy\")) {\n"
+    "        del(p + \"/:id\", \"_wings_res_destroy\");\n"
+    "    }\n"
+    "}\n"
+    "";
+
+// ========================================
+// lib/router.tpr
+// ========================================
+static const char *EMBEDDED_ROUTER =
+"// ============================================\n"
+    "// Tulpar Router Library - Express.js Style\n"
+    "// Version 2.0 - Complete with Middleware\n"
+    "// ============================================\n"
+    "\n"
+    "import \"lib/http_utils.tpr\";\n"
+    "\n"
+    "// Global Router State\n"
+    "array _router_routes = [];\n"
+    "array _router_middlewares = [];\n"
+    "str _router_host = \"127.0.0.1\";\n"
+    "int _router_port = 8080;\n"
+    "\n"
+    "// Global Request/Response (Middleware'ler için)\n"
+    "json _request = {};\n"
+    "json _response = {};\n"
+    "\n"
+    "// Per-request keep-alive intent. Set by _router_handle_client based on\n"
+    "// the parsed request's Connection header + HTTP version, then read by\n"
+    "// json_response when it emits the Connection line. Lives on the global\n"
+    "// (rather than threading through every response builder) because the\n"
+    "// router has multiple response builders and a single global keeps the\n"
+    "// surface API unchanged for handlers that build responses by hand.\n"
+    "int _keepalive = 0;\n"
+    "\n"
+    "// ============================================\n"
+    "// Helper Functions\n"
+    "// ============================================\n"
+    "\n"
+    "// Path parametrelerini ayıkla: /users/:id ile /users/123 eşleştir.\n"
+    "// Native runtime builtin `path_match` kullanır; Express-style :param ve /*\n"
+    "// wildcard sözdizimini destekler. Eski Tulpar-seviyeli implementasyon\n"
+    "// her istekte interpreter'da split/substring çağırıyordu — native yol\n"
+    "// yaklaşık 20× daha hızlı.\n"
+    "func match_path(str route_path, str request_path) {\n"
+    "    return path_match(route_path, request_path);\n"
+    "}\n"
+    "\n"
+    "// Query string parse et: ?name=ali&age=25\n"
+    "// Native `parse_query` builtin'ine delegasyon; URL decode (% / +) dahil.\n"
+    "func parse_query_string(str query_str) {\n"
+    "    return parse_query(query_str);\n"
+    "}\n"
+    "\n"
+    "// URL decode\n"
+    "func url_decode(str encoded) {\n"
+    "    str result = replace(encoded, \"%20\", \" \");\n"
+    "    result = replace(result, \"%2F\", \"/\");\n"
+    "    result = replace(result, \"%3A\", \":\");\n"
+    "    result = replace(result, \"%3F\", \"?\");\n"
+    "    result = replace(result, \"%3D\", \"=\");\n"
+    "    result = replace(result, \"%26\", \"&\");\n"
+    "    result = replace(result, \"%23\", \"#\");\n"
+    "    result = replace(result, \"%2B\", \"+\");\n"
+    "    return result;\n"
+    "}\n"
+    "\n"
+    "// Request body'den JSON parse et\n"
+    "func parse_json_body(str raw_body) {\n"
+    "    if (length(raw_body) == 0) {\n"
+    "        return {};\n"
+    "    }\n"
+    "    \n"
+    "    try {\n"
+    "        return fromJson(raw_body);\n"
+    "    } catch (e) {\n"
+    "        print(\"[Warning] Failed to parse JSON body: \" + e);\n"
+    "        return {};\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// ============================================\n"
+    "// Response Builders\n"
+    "// ============================================\n"
+    "\n"
+    "// JSON yanıt oluştur (CORS headers ile)\n"
+    "func json_response(int status, json data) {\n"
+    "    str json_str = toJson(data);\n"
+    "    str headers = \"\";\n"
+    "    \n"
+    "    // CORS headers ekle\n"
+    "    if (_response[\"cors\"]) {\n"
+    "        headers = headers + \"Access-Control-Allow-Origin: *\\r\\n\";\n"
+    "        headers = headers + \"Access-Control-Allow-Methods: GET, POST, PUT, DELETE, OPTIONS\\r\\n\";\n"
+    "        headers = headers + \"Access-Control-Allow-Headers: Content-Type, Authorization\\r\\n\";\n"
+    "    }\n"
+    "    \n"
+    "    // Security headers ekle\n"
+    "    if (_response[\"security_headers\"]) {\n"
+    "        headers = headers + \"X-Content-Type-Options: nosniff\\r\\n\";\n"
+    "        headers = headers + \"X-Frame-Options: DENY\\r\\n\";\n"
+    "        headers = headers + \"X-XSS-Protection: 1; mode=block\\r\\n\";\n"
+    "    }\n"
+    "    \n"
+    "    str status_text = \"OK\";\n"
+    "    if (status == 201) { status_text = \"Created\"; }\n"
+    "    if (status == 400) { status_text = \"Bad Request\"; }\n"
+    "    if (status == 401) { status_text = \"Unauthorized\"; }\n"
+    "    if (status == 403) { status_text = \"Forbidden\"; }\n"
+    "    if (status == 404) { status_text = \"Not Found\"; }\n"
+    "    if (status == 405) { status_text = \"Method Not Allowed\"; }\n"
+    "    if (status == 429) { status_text = \"Too Many Requests\"; }\n"
+    "    if (status == 500) { status_text = \"Internal Server Error\"; }\n"
+    "    \n"
+    "    str response = \"HTTP/1.1 \" + toString(status) + \" \" + status_text + \"\\r\\n\";\n"
+    "    response = response + \"Content-Type: application/json\\r\\n\";\n"
+    "    response = response + \"Content-Length: \" + toString(length(json_str)) + \"\\r\\n\";\n"
+    "    response = response + headers;\n"
+    "    if (_keepalive == 1) {\n"
+    "        response = response + \"Connection: keep-alive\\r\\n\";\n"
+    "    } else {\n"
+    "        response = response + \"Connection: close\\r\\n\";\n"
+    "    }\n"
+    "    response = response + \"\\r\\n\";\n"
+    "    response = response + json_str;\n"
+    "\n"
+    "    return response;\n"
+    "}\n"
+    "\n"
+    "// HTML yanıt oluştur\n"
+    "func html_response(int status, str html) {\n"
+    "    return http_create_response(status, \"text/html\", html);\n"
+    "}\n"
+    "\n"
+    "// Text yanıt oluştur\n"
+    "func text_response(int status, str text) {\n"
+    "    return http_create_response(status, \"text/plain\", text);\n"
+    "}\n"
+    "\n"
+    "// ============================================\n"
+    "// Router API Functions\n"
+    "// ============================================\n"
+    "\n"
+    "// Route Groups State\n"
+    "str _route_prefix = \"\";\n"
+    "\n"
+    "// Route Group oluştur\n"
+    "// group(\"/api/v1\", \"setup_v1_routes\");\n"
+    "// Not: Tulpar'da lambda olmadığı için group yapısı biraz farklı olmalı\n"
+    "// Veya basitçe prefix değiştiren fonksiyonlar:\n"
+    "\n"
+    "func router_group_start(str prefix) {\n"
+    "    _route_prefix = prefix;\n"
+    "}\n"
+    "\n"
+    "func router_group_end() {\n"
+    "    _route_prefix = \"\";\n"
+    "}\n"
+    "\n"
+    "// GET route ekle (prefix destekli)\n"
+    "func route_get(str path, str handler_name) {\n"
+    "    str full_path = _route_prefix + path;\n"
+    "    json route = {\n"
+    "        \"method\": \"GET\",\n"
+    "        \"path\": full_path,\n"
+    "        \"handler\": handler_name\n"
+    "    };\n"
+    "    push(_router_routes, route);\n"
+    "}\n"
+    "\n"
+    "// POST route ekle (prefix destekli)\n"
+    "func route_post(str path, str handler_name) {\n"
+    "    json route = {\n"
+    "        \"method\": \"POST\",\n"
+    "        \"path\": _route_prefix + path,\n"
+    "        \"handler\": handler_name\n"
+    "    };\n"
+    "    push(_router_routes, route);\n"
+    "}\n"
+    "\n"
+    "// PUT route ekle (prefix destekli)\n"
+    "func route_put(str path, str handler_name) {\n"
+    "    json route = {\n"
+    "        \"method\": \"PUT\",\n"
+    "        \"path\": _route_prefix + path,\n"
+    "        \"handler\": handler_name\n"
+    "    };\n"
+    "    push(_router_routes, route);\n"
+    "}\n"
+    "\n"
+    "// DELETE route ekle (prefix destekli)\n"
+    "func route_delete(str path, str handler_name) {\n"
+    "    json route = {\n"
+    "        \"method\": \"DELETE\",\n"
+    "        \"path\": _route_prefix + path,\n"
+    "        \"handler\": handler_name\n"
+    "    };\n"
+    "    push(_router_routes, route);\n"
+    "}\n"
+    "\n"
+    "// OPTIONS route ekle (prefix destekli)\n"
+    "func route_options(str path, str handler_name) {\n"
+    "    json route = {\n"
+    "        \"method\": \"OPTIONS\",\n"
+    "        \"path\": _route_prefix + path,\n"
+    "        \"handler\": handler_name\n"
+    "    };\n"
+    "    push(_router_routes, route);\n"
+    "}\n"
+    "\n"
+    "// Tüm HTTP metodları için route ekle\n"
+    "func route_all(str path, str handler_name) {\n"
+    "    route_get(path, handler_name);\n"
+    "    route_post(path, handler_name);\n"
+    "    route_put(path, handler_name);\n"
+    "    route_delete(path, handler_name);\n"
+    "    route_options(path, handler_name);\n"
+    "}\n"
+    "\n"
+    "// Middleware ekle\n"
+    "func use_middleware(str middleware_name) {\n"
+    "    push(_router_middlewares, middleware_name);\n"
+    "}\n"
+    "\n"
+    "// Route bul\n"
+    "func find_route(str method, str path) {\n"
+    "    int routes_len = length(_router_routes);\n"
+    "    for (int i = 0; i < routes_len; i++) {\n"
+    "        json route = _router_routes[i];\n"
+    "        str route_method = route[\"method\"];\n"
+    "        str route_path = route[\"path\"];\n"
+    "        \n"
+    "        if (route_method == method) {\n"
+    "            // Simple exact match first\n"
+    "            if (route_path == path) {\n"
+    "                return {\n"
+    "                    \"found\": true,\n"
+    "                    \"route\": route,\n"
+    "                    \"params\": {}\n"
+    "                };\n"
+    "            }\n"
+    "            \n"
+    "            // Pattern matching for parametric routes\n"
+    "            json mr = match_path(route_path, path);\n"
+    "            if (mr[\"matched\"]) {\n"
+    "                return {\n"
+    "                    \"found\": true,\n"
+    "                    \"route\": route,\n"
+    "                    \"params\": mr[\"params\"]\n"
+    "                };\n"
+    "            }\n"
+    "        }\n"
+    "    }\n"
+    "    return { \"found\": false };\n"
+    "}\n"
+    "\n"
+    "// ============================================\n"
+    "// Built-in Middleware Functions\n"
+    "// ============================================\n"
+    "\n"
+    "// Logger Middleware\n"
+    "func _mw_logger() {\n"
+    "    str method = _request[\"method\"];\n"
+    "    str path = _request[\"path\"];\n"
+    "    print(\"[\" + method + \"] \" + path);\n"
+    "}\n"
+    "\n"
+    "// CORS Middleware\n"
+    "func _mw_cors() {\n"
+    "    _response[\"cors\"] = true;\n"
+    "}\n"
+    "\n"
+    "// Security Headers Middleware\n"
+    "func _mw_security() {\n"
+    "    _response[\"security_headers\"] = true;\n"
+    "}\n"
+    "\n"
+    "// JSON Body Parser Middleware\n"
+    "func _mw_json_parser() {\n"
+    "    str raw_body = _request[\"raw_body\"];\n"
+    "    if (length(raw_body) > 0) {\n"
+    "        _request[\"body\"] = parse_json_body(raw_body);\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Auth Middleware (Basic)\n"
+    "func _mw_auth() {\n"
+    "    str auth_header = \"\";\n"
+    "    json headers = _request[\"headers\"];\n"
+    "    \n"
+    "    if (headers[\"Authorization\"]) {\n"
+    "        auth_header = headers[\"Authorization\"];\n"
+    "    }\n"
+    "    \n"
+    "    if (length(auth_header) == 0) {\n"
+    "        _response[\"status\"] = 401;\n"
+    "        _response[\"error\"] = \"Unauthorized: No Authorization header\";\n"
+    "        _response[\"skip_route\"] = true;\n"
+    "        return;\n"
+    "    }\n"
+    "    \n"
+    "    // Bearer token kontrolü\n"
+    "    if (startsWith(auth_header, \"Bearer \")) {\n"
+    "        str token = substring(auth_header, 7, length(auth_header));\n"
+    "        _request[\"token\"] = token;\n"
+    "        _request[\"authenticated\"] = true;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Session Middleware (Internal)\n"
+    "func _mw_session() {\n"
+    "    // Cookie header'ı al\n"
+    "    str cookie_header = \"\";\n"
+    "    if (_request[\"headers\"][\"Cookie\"]) {\n"
+    "        cookie_header = _request[\"headers\"][\"Cookie\"];\n"
+    "    }\n"
+    "    \n"
+    "    // Cookie'leri parse et\n"
+    "    json cookies = parse_cookies(cookie_header);\n"
+    "    \n"
+    "    str session_id = \"\";\n"
+    "    if (cookies[\"tulpar_sess\"]) {\n"
+    "        session_id = cookies[\"tulpar_sess\"];\n"
+    "    }\n"
+    "    \n"
+    "    // Session kontrolü (http_utils içinde _sessions global)\n"
+    "    if (length(session_id) > 0) {\n"
+    "        // Session geçerli mi kontrol et (basit)\n"
+    "        if (_sessions[session_id]) {\n"
+    "            _request[\"session_id\"] = session_id;\n"
+    "            _request[\"session\"] = _sessions[session_id][\"data\"];\n"
+    "        } else {\n"
+    "            // Geçersiz session\n"
+    "            _request[\"session_id\"] = \"\";\n"
+    "            _request[\"session\"] = {};\n"
+    "        }\n"
+    "    } else {\n"
+    "        _request[\"session_id\"] = \"\";\n"
+    "        _request[\"session\"] = {};\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Test Sleep Middleware\n"
+    "func _mw_test_sleep() {\n"
+    "    print(\"[DEBUG] Sleeping for 3s...\");\n"
+    "    sleep(3000); // 3 saniye blokla (Thread içinde olduğu için server durmamalı)\n"
+    "    print(\"[DEBUG] Awake!\");\n"
+    "}\n"
+    "\n"
+    "// ============================================\n"
+    "// Middleware Executor\n"
+    "// ============================================\n"
+    "\n"
+    "func run_middlewares() {\n"
+    "    for (int m = 0; m < length(_router_middlewares); m++) {\n"
+    "        str mw_name = _router_middlewares[m];\n"
+    "        \n"
+    "        // Built-in middleware kontrolü\n"
+    "        if (mw_name == \"logger\") {\n"
+    "            _mw_logger();\n"
+    "        } else if (mw_name == \"cors\") {\n"
+    "            _mw_cors();\n"
+    "        } else if (mw_name == \"security\") {\n"
+    "            _mw_security();\n"
+    "        } else if (mw_name == \"json_parser\") {\n"
+    "            _mw_json_parser();\n"
+    "        } else if (mw_name == \"auth\") {\n"
+    "            _mw_auth();\n"
+    "        } else if (mw_name == \"session\") {\n"
+    "            _mw_session();\n"
+    "        } else if (mw_name == \"test_sleep\") {\n"
+    "            _mw_test_sleep();\n"
+    "        }\n"
+    "        \n"
+    "        // Skip kontrolü\n"
+    "        if (_response[\"skip_route\"]) {\n"
+    "            return false;\n"
+    "        }\n"
+    "    }\n"
+    "    return true;\n"
+    "}\n"
+    "\n"
+    "// ============================================\n"
+    "// Server Start\n"
+    "// ============================================\n"
+    "\n"
+    "// One TCP-connection worker. Loops on the same client_fd serving every\n"
+    "// request the peer sends until either the request asks for close\n"
+    "// (HTTP/1.0 default or `Connection: close`), the peer EOFs, or a\n"
+    "// handler throws an unhandled exception. The previous version closed\n"
+    "// the socket after every request — this one keeps it open through the\n"
+    "// full keep-alive lifetime.\n"
+    "func _router_handle_client(int client) {\n"
+    "    while (true) {\n"
+    "        try {\n"
+    "            str req_str = http_recv_request(client, 65536);\n"
+    "            // length() is safer than `req_str == \"\"` here — see notes in\n"
+    "            // wings.tpr about empty-string equality codegen edge cases.\n"
+    "            if (length(req_str) == 0) {\n"
+    "                break;\n"
+    "            }\n"
+    "            // Request parse et\n"
+    "            json parsed = http_parse_request(req_str);\n"
+    "\n"
+    "            str method = \"\";\n"
+    "            str full_path = \"\";\n"
+    "            str raw_body = \"\";\n"
+    "            json headers = {};\n"
+    "\n"
+    "            if (parsed[\"method\"]) {\n"
+    "                method = parsed[\"method\"];\n"
+    "            }\n"
+    "            if (parsed[\"path\"]) {\n"
+    "                full_path = parsed[\"path\"];\n"
+    "            }\n"
+    "            if (parsed[\"body\"]) {\n"
+    "                raw_body = parsed[\"body\"];\n"
+    "            }\n"
+    "            if (parsed[\"headers\"]) {\n"
+    "                headers = parsed[\"headers\"];\n"
+    "            }\n"
+    "\n"
+    "            // Path ve query string ayır\n"
+    "            str path = full_path;\n"
+    "            str query_str = \"\";\n"
+    "            int qmark = indexOf(full_path, \"?\");\n"
+    "            if (qmark >= 0) {\n"
+    "                path = substring(full_path, 0, qmark);\n"
+    "                query_str = substring(full_path, qmark + 1, length(full_path));\n"
+    "            }\n"
+    "\n"
+    "            json query = parse_query_string(query_str);\n"
+    "\n"
+    "            // Decide keep-alive for *this* request and stash it on the\n"
+    "            // global so json_response (and any handler-built response\n"
+    "            // string) can emit the right Connection header.\n"
+    "            _keepalive = http_should_keepalive(parsed);\n"
+    "\n"
+    "            // Global _request'i hazırla\n"
+    "            _request = {\n"
+    "                \"method\": method,\n"
+    "                \"path\": path,\n"
+    "                \"full_path\": full_path,\n"
+    "                \"query\": query,\n"
+    "                \"headers\": headers,\n"
+    "                \"raw_body\": raw_body,\n"
+    "                \"params\": {},\n"
+    "                \"body\": {},\n"
+    "                \"remote_addr\": socket_peer_ip(client)\n"
+    "            };\n"
+    "\n"
+    "            // Global _response'u hazırla\n"
+    "            _response = {\n"
+    "                \"status\": 200,\n"
+    "                \"headers\": {},\n"
+    "                \"body\": \"\",\n"
+    "                \"skip_route\": false,\n"
+    "                \"cors\": false,\n"
+    "                \"security_headers\": false\n"
+    "            };\n"
+    "\n"
+    "            // Middleware'leri çalıştır\n"
+    "            bool continue_route = run_middlewares();\n"
+    "\n"
+    "            str response = \"\";\n"
+    "\n"
+    "            if (!continue_route) {\n"
+    "                int status = 500;\n"
+    "                if (_response[\"status\"]) {\n"
+    "                    status = _response[\"status\"];\n"
+    "                }\n"
+    "                str error_msg = \"Middleware error\";\n"
+    "                if (_response[\"error\"]) {\n"
+    "                    error_msg = _response[\"error\"];\n"
+    "                }\n"
+    "                response = json_response(status, {\n"
+    "                    \"success\": false,\n"
+    "                    \"error\": error_msg\n"
+    "                });\n"
+    "            } else {\n"
+    "                if (method == \"OPTIONS\") {\n"
+    "                    response = json_response(200, {\n"
+    "                        \"success\": true,\n"
+    "                        \"message\": \"CORS preflight OK\"\n"
+    "                    });\n"
+    "                } else {\n"
+    "                    json route_match = find_route(method, path);\n"
+    "\n"
+    "                    if (route_match[\"found\"]) {\n"
+    "                        json matched_route = route_match[\"route\"];\n"
+    "                        json params = route_match[\"params\"];\n"
+    "                        _request[\"params\"] = params;\n"
+    "                        json result = call(matched_route[\"handler\"]);\n"
+    "                        response = json_response(200, result);\n"
+    "                    } else {\n"
+    "                        response = json_response(404, {\n"
+    "                            \"success\": false,\n"
+    "                            \"error\": \"Not Found\",\n"
+    "                            \"message\": \"Route not found: \" + method + \" \" + path\n"
+    "                        });\n"
+    "                    }\n"
+    "                }\n"
+    "            }\n"
+    "\n"
+    "            socket_send(client, response);\n"
+    "            if (_keepalive == 0) {\n"
+    "                break;\n"
+    "            }\n"
+    "        } catch (e) {\n"
+    "            print(\"[ERROR] \" + e);\n"
+    "            // Crash-recovery path: emit a 500 with Connection: close so\n"
+    "            // the client knows not to send another request on a fd we're\n"
+    "            // about to drop.\n"
+    "            _keepalive = 0;\n"
+    "            str error_response = json_response(500, {\n"
+    "                \"success\": false,\n"
+    "                \"error\": \"Internal Server Error\",\n"
+    "                \"message\": toString(e)\n"
+    "            });\n"
+    "            socket_send(client, error_response);\n"
+    "            break;\n"
+    "        }\n"
+    "    }\n"
+    "    socket_close(client);\n"
+    "}\n"
+    "\n"
+    "func listen(int port) {\n"
+    "    _router_port = port;\n"
+    "    \n"
+    "    print(\"╔════════════════════════════════════════╗\");\n"
+    "    print(\"║        Tulpar Router v2.0              ║\");\n"
+    "    print(\"╚════════════════════════════════════════╝\");\n"
+    "    print(\"\");\n"
+    "    print(\"Starting server on port \" + toString(port) + \"...\");\n"
+    "    \n"
+    "    int server = socket_server(_router_host, port);\n"
+    "    \n"
+    "    if (server < 0) {\n"
+    "        print(\"[ERROR] Failed to start server!\");\n"
+    "        return;\n"
+    "    }\n"
+    "    \n"
+    "    print(\"Server listening on http://\" + _router_host + \":\" + toString(port));\n"
+    "    print(\"\");\n"
+    "    print(\"Waiting for requests...\");\n"
+    "    print(\"─────────────────────────────────────────\");\n"
+    "    \n"
+    "    // Ana döngü - senkron işleme (single-threaded)\n"
+    "    while (true) {\n"
+    "        int client = socket_accept(server);\n"
+    "        if (client >= 0) {\n"
+    "            _router_handle_client(client);\n"
+    "        }\n"
+    "    }\n"
+    "}\n"
+    "";
+
+// ========================================
+// lib/http_utils.tpr
+// ========================================
+static const char *EMBEDDED_HTTP_UTILS =
+"// ============================================\n"
+    "// Tulpar HTTP Utilities Library\n"
+    "// Cookies, Sessions, Static Files, HTTP Parsing\n"
+    "// ============================================\n"
+    "\n"
+    "// ============================================\n"
+    "// HTTP Request/Response Functions\n"
+    "// ============================================\n"
+    "\n"
+    "// HTTP Request Parse Et\n"
+    "// \"GET /path HTTP/1.1\\r\\nHeader: value\\r\\n\\r\\nbody\"\n"
+    "func http_parse_request(str raw_request) {\n"
+    "    json result = {\n"
+    "        \"method\": \"\",\n"
+    "        \"path\": \"\",\n"
+    "        \"version\": \"\",\n"
+    "        \"headers\": {},\n"
+    "        \"body\": \"\"\n"
+    "    };\n"
+    "    \n"
+    "    if (length(raw_request) == 0) {\n"
+    "        return result;\n"
+    "    }\n"
+    "    \n"
+    "    // Headers ve body ayır\n"
+    "    int body_start = indexOf(raw_request, \"\\r\\n\\r\\n\");\n"
+    "    str headers_part = raw_request;\n"
+    "    str body_part = \"\";\n"
+    "    \n"
+    "    if (body_start >= 0) {\n"
+    "        headers_part = substring(raw_request, 0, body_start);\n"
+    "        body_part = substring(raw_request, body_start + 4, length(raw_request));\n"
+    "    }\n"
+    "    \n"
+    "    // İlk satır: GET /path HTTP/1.1\n"
+    "    array lines = split(headers_part, \"\\r\\n\");\n"
+    "    \n"
+    "    if (length(lines) > 0) {\n"
+    "        str first_line = lines[0];\n"
+    "        array parts = split(first_line, \" \");\n"
+    "        \n"
+    "        if (length(parts) >= 2) {\n"
+    "            result[\"method\"] = parts[0];\n"
+    "            result[\"path\"] = parts[1];\n"
+    "            if (length(parts) >= 3) {\n"
+    "                result[\"version\"] = parts[2];\n"
+    "            }\n"
+    "        }\n"
+    "    }\n"
+    "    \n"
+    "    // Headers parse et\n"
+    "    json headers = {};\n"
+    "    for (int i = 1; i < length(lines); i++) {\n"
+    "        str line = lines[i];\n"
+    "        int colon = indexOf(line, \":\");\n"
+    "        if (colon > 0) {\n"
+    "            str key = substring(line, 0, colon);\n"
+    "            str value = substring(line, colon + 1, length(line));\n"
+    "            // Trim leading space from value\n"
+    "            if (length(value) > 0 && value[0] == \" \") {\n"
+    "                value = substring(value, 1, length(value));\n"
+    "            }\n"
+    "            headers[key] = value;\n"
+    "        }\n"
+    "    }\n"
+    "    result[\"headers\"] = headers;\n"
+    "    \n"
+    "    // Body\n"
+    "    result[\"body\"] = body_part;\n"
+    "    \n"
+    "    return result;\n"
+    "}\n"
+    "\n"
+    "// HTTP Response Oluştur\n"
+    "func http_create_response(int status, str content_type, str body) {\n"
+    "    str status_text = \"OK\";\n"
+    "    if (status == 201) { status_text = \"Created\"; }\n"
+    "    if (status == 204) { status_text = \"No Content\"; }\n"
+    "    if (status == 301) { status_text = \"Moved Permanently\"; }\n"
+    "    if (status == 302) { status_text = \"Found\"; }\n"
+    "    if (status == 304) { status_text = \"Not Modified\"; }\n"
+    "    if (status == 400) { status_text = \"Bad Request\"; }\n"
+    "    if (status == 401) { status_text = \"Unauthorized\"; }\n"
+    "    if (status == 403) { status_text = \"Forbidden\"; }\n"
+    "    if (status == 404) { status_text = \"Not Found\"; }\n"
+    "    if (status == 405) { status_text = \"Method Not Allowed\"; }\n"
+    "    if (status == 500) { status_text = \"Internal Server Error\"; }\n"
+    "    if (status == 501) { status_text = \"Not Implemented\"; }\n"
+    "    if (status == 503) { status_text = \"Service Unavailable\"; }\n"
+    "    \n"
+    "    str response = \"HTTP/1.1 \" + toString(status) + \" \" + status_text + \"\\r\\n\";\n"
+    "    response = response + \"Content-Type: \" + content_type + \"\\r\\n\";\n"
+    "    response = response + \"Content-Length: \" + toString(length(body)) + \"\\r\\n\";\n"
+    "    response = response + \"Connection: close\\r\\n\";\n"
+    "    response = response + \"\\r\\n\";\n"
+    "    response = response + body;\n"
+    "    \n"
+    "    return response;\n"
+    "}\n"
+    "\n"
+    "// ============================================\n"
+    "// Cookie Handling\n"
+    "// ============================================\n"
+    "\n"
+    "// Cookie Parse Et\n"
+    "// \"name=value; name2=value2\" -> {\"name\": \"value\", \"name2\": \"value2\"}\n"
+    "func parse_cookies(str cookie_header) {\n"
+    "    json cookies = {};\n"
+    "    \n"
+    "    if (length(cookie_header) == 0) {\n"
+    "        return cookies;\n"
+    "    }\n"
+    "    \n"
+    "    array parts = split(cookie_header, \";\");\n"
+    "    \n"
+    "    for (int i = 0; i < length(parts); i++) {\n"
+    "        str part = trim(parts[i]);\n"
+    "\n"
+    "        array kv = split(part, \"=\");\n"
+    "        if (length(kv) >= 2) {\n"
+    "            str key = trim(kv[0]);\n"
+    "            str val = trim(kv[1]);\n"
+    "            cookies[key] = val;\n"
+    "        }\n"
+    "    }\n"
+    "    \n"
+    "    return cookies;\n"
+    "}\n"
+    "\n"
+    "// Set-Cookie Header Oluştur\n"
+    "func create_cookie(str name, str value, json options) {\n"
+    "    str cookie = name + \"=\" + value;\n"
+    "    \n"
+    "    if (options[\"Path\"]) {\n"
+    "        cookie = cookie + \"; Path=\" + options[\"Path\"];\n"
+    "    } else {\n"
+    "        cookie = cookie + \"; Path=/\";\n"
+    "    }\n"
+    "    \n"
+    "    if (options[\"HttpOnly\"]) {\n"
+    "        if (options[\"HttpOnly\"]) {\n"
+    "            cookie = cookie + \"; HttpOnly\";\n"
+    "        }\n"
+    "    }\n"
+    "    \n"
+    "    if (options[\"Secure\"]) {\n"
+    "        if (options[\"Secure\"]) {\n"
+    "            cookie = cookie + \"; Secure\";\n"
+    "        }\n"
+    "    }\n"
+    "    \n"
+    "    if (options[\"Max-Age\"]) {\n"
+    "        cookie = cookie + \"; Max-Age=\" + toString(options[\"Max-Age\"]);\n"
+    "    }\n"
+    "    \n"
+    "    if (options[\"SameSite\"]) {\n"
+    "        cookie = cookie + \"; SameSite=\" + options[\"SameSite\"];\n"
+    "    }\n"
+    "    \n"
+    "    return cookie;\n"
+    "}\n"
+    "\n"
+    "// ============================================\n"
+    "// Session Management (In-Memory)\n"
+    "// ============================================\n"
+    "\n"
+    "json _sessions = {};\n"
+    "\n"
+    "// Yeni session oluştur\n"
+    "func create_session(json user_data) {\n"
+    "    // Session ID: rastgele sayı + timestamp ile çakışma/tahmin direnci.\n"
+    "    // Not: Gerçek uygulamada daha güvenli UUID kullanılmalı.\n"
+    "    int rand_id = toInt(random() * 1000000000);\n"
+    "    int created = timestamp();\n"
+    "    str session_id = \"sess_\" + toString(_router_port) + \"_\" + toString(rand_id) + \"_\" + toString(created);\n"
+    "\n"
+    "    _sessions[session_id] = {\n"
+    "        \"id\": session_id,\n"
+    "        \"data\": user_data,\n"
+    "        \"created_at\": created,\n"
+    "        \"expires_at\": created + 3600\n"
+    "    };\n"
+    "    \n"
+    "    return session_id;\n"
+    "}\n"
+    "\n"
+    "// Session getir\n"
+    "func get_session(str session_id) {\n"
+    "    if (_sessions[session_id]) {\n"
+    "        json sess = _sessions[session_id];\n"
+    "        // Süresi dolmuşsa geçersiz say.\n"
+    "        if (sess[\"expires_at\"] < timestamp()) {\n"
+    "            return {};\n"
+    "        }\n"
+    "        return sess;\n"
+    "    }\n"
+    "    return {};\n"
+    "}\n"
+    "\n"
+    "// Session sil\n"
+    "func destroy_session(str session_id) {\n"
+    "    // Tulpar'da array/map elemanı silme desteği kısıtlı olabilir\n"
+    "    // Şimdilik boşaltma yapalım\n"
+    "    if (_sessions[session_id]) {\n"
+    "        _sessions[session_id] = {}; \n"
+    "        return true;\n"
+    "    }\n"
+    "    return false;\n"
+    "}\n"
+    "\n"
+    "// ============================================\n"
+    "// Static File Serving\n"
+    "// ============================================\n"
+    "\n"
+    "// Content-Type belirle\n"
+    "func get_mime_type(str filename) {\n"
+    "    if (endsWith(filename, \".html\")) { return \"text/html\"; }\n"
+    "    if (endsWith(filename, \".css\")) { return \"text/css\"; }\n"
+    "    if (endsWith(filename, \".js\")) { return \"application/javascript\"; }\n"
+    "    if (endsWith(filename, \".json\")) { return \"application/json\"; }\n"
+    "    if (endsWith(filename, \".png\")) { return \"image/png\"; }\n"
+    "    if (endsWith(filename, \".jpg\")) { return \"image/jpeg\"; }\n"
+    "    if (endsWith(filename, \".txt\")) { return \"text/plain\"; }\n"
+    "    return \"application/octet-stream\";\n"
+    "}\n"
+    "\n"
+    "// Dosya oku ve response hazırla\n"
+    "func serve_static_file(str path) {\n"
+    "    // Path traversal koruması (basit)\n"
+    "    if (contains(path, \"..\")) {\n"
+    "        return json_response(403, {\"error\": \"Forbidden\"});\n"
+    "    }\n"
+    "\n"
+    "    try {\n"
+    "        // read_file dosya yoksa boş döner; o durumda 404 ver.\n"
+    "        str content = read_file(path);\n"
+    "        if (length(content) == 0) {\n"
+    "            return json_response(404, {\"error\": \"File not found\"});\n"
+    "        }\n"
+    "        return http_create_response(200, get_mime_type(path), content);\n"
+    "    } catch (e) {\n"
+    "        return json_response(404, {\"error\": \"File not found\"});\n"
+    "    }\n"
+    "}\n"
+    "";
+
+// ========================================
+// lib/async.tpr
+// ========================================
+static const char *EMBEDDED_ASYNC =
+"// ============================================\n"
+    "// Tulpar Async Library\n"
+    "// Basit asenkron programlama yardımcıları\n"
+    "// ============================================\n"
+    "\n"
+    "// NOT: TulparLang artık DİL DÜZEYİNDE gerçek async/await destekler (AOT yolu):\n"
+    "//   async func f() { await sleep_async(10); return 1; }\n"
+    "//   var p = f(); int r = await p;\n"
+    "// Bunlar stackful coroutine + event loop ile çalışır (runtime/tulpar_async).\n"
+    "// Aşağıdaki yardımcılar (Promise-benzeri, timer kaydı, task kuyruğu) bu dil\n"
+    "// özelliğinden ÖNCE yazılmış saf-Tulpar yapılardır; geriye dönük uyumluluk\n"
+    "// için bırakıldı. Yeni kod için `async`/`await` + `sleep_async()` tercih edin.\n"
+    "\n"
+    "// ============================================\n"
+    "// Global Timer State\n"
+    "// ============================================\n"
+    "\n"
+    "arrayJson _timers = [];\n"
+    "int _timer_id = 0;\n"
+    "\n"
+    "// ============================================\n"
+    "// Timer Types (for documentation)\n"
+    "// ============================================\n"
+    "\n"
+    "// Timer yapısı:\n"
+    "// {\n"
+    "//     \"id\": int,           // Timer ID\n"
+    "//     \"delay\": int,        // Milisaniye cinsinden gecikme\n"
+    "//     \"callback\": str,     // Callback fonksiyon adı\n"
+    "//     \"interval\": bool,    // Tekrarlayan timer mı?\n"
+    "//     \"active\": bool       // Timer aktif mi?\n"
+    "// }\n"
+    "\n"
+    "// ============================================\n"
+    "// Timer Functions\n"
+    "// ============================================\n"
+    "\n"
+    "// Yeni timeout oluştur (gelecek için hazırlık)\n"
+    "// NOT: Şu an blocking delay olarak çalışır\n"
+    "func setTimeout(str callback_name, int delay_ms) {\n"
+    "    _timer_id = _timer_id + 1;\n"
+    "    \n"
+    "    arrayJson timer = {\n"
+    "        \"id\": _timer_id,\n"
+    "        \"delay\": delay_ms,\n"
+    "        \"callback\": callback_name,\n"
+    "        \"interval\": false,\n"
+    "        \"active\": true\n"
+    "    };\n"
+    "    \n"
+    "    push(_timers, timer);\n"
+    "    \n"
+    "    // Şu an için sadece timer'ı kaydet\n"
+    "    // Gerçek çalıştırma event loop gerektirir\n"
+    "    print(\"[Timer] setTimeout registered: \" + callback_name + \" (delay: \" + toString(delay_ms) + \"ms)\");\n"
+    "    \n"
+    "    return _timer_id;\n"
+    "}\n"
+    "\n"
+    "// Yeni interval oluştur\n"
+    "func setInterval(str callback_name, int interval_ms) {\n"
+    "    _timer_id = _timer_id + 1;\n"
+    "    \n"
+    "    arrayJson timer = {\n"
+    "        \"id\": _timer_id,\n"
+    "        \"delay\": interval_ms,\n"
+    "        \"callback\": callback_name,\n"
+    "        \"interval\": true,\n"
+    "        \"active\": true\n"
+    "    };\n"
+    "    \n"
+    "    push(_timers, timer);\n"
+    "    \n"
+    "    print(\"[Timer] setInterval registered: \" + callback_name + \" (interval: \" + toString(interval_ms) + \"ms)\");\n"
+    "    \n"
+    "    return _timer_id;\n"
+    "}\n"
+    "\n"
+    "// Timer'ı iptal et\n"
+    "func clearTimeout(int timer_id) {\n"
+    "    for (int i = 0; i < length(_timers); i++) {\n"
+    "        if (_timers[i][\"id\"] == timer_id) {\n"
+    "            _timers[i][\"active\"] = false;\n"
+    "            print(\"[Timer] Timer \" + toString(timer_id) + \" cleared\");\n"
+    "            return true;\n"
+    "        }\n"
+    "    }\n"
+    "    return false;\n"
+    "}\n"
+    "\n"
+    "// Interval'ı iptal et (aynı işlev)\n"
+    "func clearInterval(int timer_id) {\n"
+    "    return clearTimeout(timer_id);\n"
+    "}\n"
+    "\n"
+    "// ============================================\n"
+    "// Promise-like Pattern (Simulated)\n"
+    "// ============================================\n"
+    "\n"
+    "// Promise state'leri\n"
+    "str PROMISE_PENDING = \"pending\";\n"
+    "str PROMISE_FULFILLED = \"fulfilled\";\n"
+    "str PROMISE_REJECTED = \"rejected\";\n"
+    "\n"
+    "// Promise oluştur\n"
+    "func create_promise() {\n"
+    "    return {\n"
+    "        \"state\": PROMISE_PENDING,\n"
+    "        \"value\": \"\",\n"
+    "        \"error\": \"\"\n"
+    "    };\n"
+    "}\n"
+    "\n"
+    "// Promise resolve et\n"
+    "func resolve_promise(arrayJson promise, str value) {\n"
+    "    promise[\"state\"] = PROMISE_FULFILLED;\n"
+    "    promise[\"value\"] = value;\n"
+    "    return promise;\n"
+    "}\n"
+    "\n"
+    "// Promise reject et\n"
+    "func reject_promise(arrayJson promise, str error) {\n"
+    "    promise[\"state\"] = PROMISE_REJECTED;\n"
+    "    promise[\"error\"] = error;\n"
+    "    return promise;\n"
+    "}\n"
+    "\n"
+    "// Promise durumunu kontrol et\n"
+    "func is_pending(arrayJson promise) {\n"
+    "    return promise[\"state\"] == PROMISE_PENDING;\n"
+    "}\n"
+    "\n"
+    "func is_fulfilled(arrayJson promise) {\n"
+    "    return promise[\"state\"] == PROMISE_FULFILLED;\n"
+    "}\n"
+    "\n"
+    "func is_rejected(arrayJson promise) {\n"
+    "    return promise[\"state\"] == PROMISE_REJECTED;\n"
+    "}\n"
+    "\n"
+    "// ============================================\n"
+    "// Async/Await Pattern (Documentation)\n"
+    "// ============================================\n"
+    "\n"
+    "/*\n"
+    "async/await ARTIK DESTEKLENİYOR (AOT yolu). Örnek:\n"
+    "\n"
+    "async func compute(int n) {\n"
+    "    await sleep_async(10);   // bloklamayan gecikme — diğer coroutine'ler çalışır\n"
+    "    return n * 2;\n"
+    "}\n"
+    "\n"
+    "var a = compute(21);   // promise döner (hemen)\n"
+    "var b = compute(50);   // ikinci coroutine\n"
+    "int ra = await a;      // 42\n"
+    "int rb = await b;      // 100\n"
+    "\n"
+    "Notlar:\n"
+    "- `async func` bir coroutine'dir; çağrı bir promise döndürür, gövde await'te\n"
+    "  askıya alınır.\n"
+    "- `await p` promise yerleşene kadar bekler; coroutine içindeyse scheduler'a\n"
+    "  yield eder, ana akıştaysa event loop'u sürer (\"block-on\").\n"
+    "- `sleep_async(ms)` bloklamayan timer'dır; `sleep(ms)` ise hâlâ bloklar.\n"
+    "- Program sonunda kalan tüm task'lar otomatik drenajla tamamlanır.\n"
+    "*/\n"
+    "\n"
+    "// ============================================\n"
+    "// Utility Functions\n"
+    "// ============================================\n"
+    "\n"
+    "// Gerçek delay fonksiyonu\n"
+    "func delay(int ms) {\n"
+    "    sleep(ms);\n"
+    "}\n"
+    "\n"
+    "// İş kuyruğu oluştur\n"
+    "func create_task_queue() {\n"
+    "    return {\n"
+    "        \"tasks\": [],\n"
+    "        \"running\": false\n"
+    "    };\n"
+    "}\n"
+    "\n"
+    "// Kuyruğa iş ekle\n"
+    "func enqueue_task(arrayJson queue, str task_name, arrayJson data) {\n"
+    "    arrayJson task = {\n"
+    "        \"name\": task_name,\n"
+    "        \"data\": data,\n"
+    "        \"status\": \"pending\"\n"
+    "    };\n"
+    "    push(queue[\"tasks\"], task);\n"
+    "    return queue;\n"
+    "}\n"
+    "\n"
+    "// Kuyruktan iş al\n"
+    "func dequeue_task(arrayJson queue) {\n"
+    "    if (length(queue[\"tasks\"]) > 0) {\n"
+    "        arrayJson task = queue[\"tasks\"][0];\n"
+    "        // shift() builtin'i yok: ilk elemanı al, kalanları yeni diziye taşı.\n"
+    "        arrayJson rest = [];\n"
+    "        int i = 1;\n"
+    "        while (i < length(queue[\"tasks\"])) {\n"
+    "            push(rest, queue[\"tasks\"][i]);\n"
+    "            i = i + 1;\n"
+    "        }\n"
+    "        queue[\"tasks\"] = rest;\n"
+    "        return task;\n"
+    "    }\n"
+    "    return {};\n"
+    "}\n"
+    "";
+
+// ========================================
+// lib/middleware.tpr
+// ========================================
+static const char *EMBEDDED_MIDDLEWARE =
+"// ============================================\n"
+    "// Tulpar Middleware Library\n"
+    "// Built-in middleware'ler\n"
+    "// ============================================\n"
+    "\n"
+    "// ============================================\n"
+    "// Logger Middleware\n"
+    "// Her request'i loglar\n"
+    "// ============================================\n"
+    "func middleware_logger() {\n"
+    "    str timestamp = toString(_request[\"timestamp\"]);\n"
+    "    str method = _request[\"method\"];\n"
+    "    str path = _request[\"path\"];\n"
+    "    \n"
+    "    print(\"[LOG] \" + timestamp + \" - \" + method + \" \" + path);\n"
+    "}\n"
+    "\n"
+    "// ============================================\n"
+    "// CORS Middleware\n"
+    "// Cross-Origin Resource Sharing headers ekler\n"
+    "// ============================================\n"
+    "func middleware_cors() {\n"
+    "    _response[\"headers\"][\"Access-Control-Allow-Origin\"] = \"*\";\n"
+    "    _response[\"headers\"][\"Access-Control-Allow-Methods\"] = \"GET, POST, PUT, DELETE, OPTIONS\";\n"
+    "    _response[\"headers\"][\"Access-Control-Allow-Headers\"] = \"Content-Type, Authorization\";\n"
+    "}\n"
+    "\n"
+    "// ============================================\n"
+    "// JSON Body Parser Middleware\n"
+    "// Request body'yi JSON olarak parse eder\n"
+    "// ============================================\n"
+    "func middleware_json_parser() {\n"
+    "    str content_type = \"\";\n"
+    "    if (_request[\"headers\"][\"Content-Type\"]) {\n"
+    "        content_type = _request[\"headers\"][\"Content-Type\"];\n"
+    "    }\n"
+    "    \n"
+    "    if (contains(content_type, \"application/json\")) {\n"
+    "        str raw_body = _request[\"raw_body\"];\n"
+    "        if (length(raw_body) > 0) {\n"
+    "            try {\n"
+    "                _request[\"body\"] = fromJson(raw_body);\n"
+    "            } catch (e) {\n"
+    "                _request[\"body\"] = {};\n"
+    "                print(\"[Warning] Failed to parse JSON body\");\n"
+    "            }\n"
+    "        }\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// ============================================\n"
+    "// Auth Middleware (Example)\n"
+    "// Bearer token kontrolü yapar\n"
+    "// ============================================\n"
+    "func middleware_auth() {\n"
+    "    str auth_header = \"\";\n"
+    "    if (_request[\"headers\"][\"Authorization\"]) {\n"
+    "        auth_header = _request[\"headers\"][\"Authorization\"];\n"
+    "    }\n"
+    "    \n"
+    "    if (length(auth_header) == 0) {\n"
+    "        _response[\"status\"] = 401;\n"
+    "        _response[\"error\"] = \"Unauthorized: No Authorization header\";\n"
+    "        _response[\"skip_route\"] = true;\n"
+    "        return;\n"
+    "    }\n"
+    "    \n"
+    "    // Bearer token kontrolü\n"
+    "    if (!startsWith(auth_header, \"Bearer \")) {\n"
+    "        _response[\"status\"] = 401;\n"
+    "        _response[\"error\"] = \"Unauthorized: Invalid token format\";\n"
+    "        _response[\"skip_route\"] = true;\n"
+    "        return;\n"
+    "    }\n"
+    "    \n"
+    "    // Token'ı ayıkla ve request'e ekle\n"
+    "    str token = substring(auth_header, 7, length(auth_header));\n"
+    "    _request[\"token\"] = token;\n"
+    "    _request[\"authenticated\"] = true;\n"
+    "}\n"
+    "\n"
+    "// ============================================\n"
+    "// Rate Limiter Middleware (Simple)\n"
+    "// Basit istek sayacı\n"
+    "// ============================================\n"
+    "// Not: Bu basit bir örnek. Gerçek rate limiting için\n"
+    "// redis veya benzeri bir store gerekir.\n"
+    "\n"
+    "arrayJson _rate_limit_store = {};\n"
+    "\n"
+    "func middleware_rate_limiter() {\n"
+    "    // Dispatcher _request[\"remote_addr\"]'ı socket_peer_ip ile dolduruyor;\n"
+    "    // yoksa (ör. doğrudan çağrı) \"unknown\"'a düş.\n"
+    "    str client_ip = \"unknown\";\n"
+    "    if (_request[\"remote_addr\"]) {\n"
+    "        client_ip = _request[\"remote_addr\"];\n"
+    "    }\n"
+    "    int max_requests = 100;\n"
+    "    int window_seconds = 60;\n"
+    "    \n"
+    "    // Basit rate limit kontrolü\n"
+    "    // Gerçek implementasyonda timestamp kontrolü gerekir\n"
+    "    if (_rate_limit_store[client_ip]) {\n"
+    "        int count = _rate_limit_store[client_ip];\n"
+    "        if (count >= max_requests) {\n"
+    "            _response[\"status\"] = 429;\n"
+    "            _response[\"error\"] = \"Too Many Requests\";\n"
+    "            _response[\"skip_route\"] = true;\n"
+    "            return;\n"
+    "        }\n"
+    "        _rate_limit_store[client_ip] = count + 1;\n"
+    "    } else {\n"
+    "        _rate_limit_store[client_ip] = 1;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// ============================================\n"
+    "// Security Headers Middleware\n"
+    "// Güvenlik headerları ekler\n"
+    "// ============================================\n"
+    "func middleware_security_headers() {\n"
+    "    _response[\"headers\"][\"X-Content-Type-Options\"] = \"nosniff\";\n"
+    "    _response[\"headers\"][\"X-Frame-Options\"] = \"DENY\";\n"
+    "    _response[\"headers\"][\"X-XSS-Protection\"] = \"1; mode=block\";\n"
+    "    _response[\"headers\"][\"Referrer-Policy\"] = \"strict-origin-when-cross-origin\";\n"
+    "}\n"
+    "\n"
+    "// ============================================\n"
+    "// Session Middleware\n"
+    "// Cookie tabanlı session yönetimi\n"
+    "// ============================================\n"
+    "// NOT: http_utils.tpr import edilmeli\n"
+    "\n"
+    "func middleware_session() {\n"
+    "    // Cookie header'ı al\n"
+    "    str cookie_header = \"\";\n"
+    "    if (_request[\"headers\"][\"Cookie\"]) {\n"
+    "        cookie_header = _request[\"headers\"][\"Cookie\"];\n"
+    "    }\n"
+    "    \n"
+    "    // Cookie'leri native parse_cookies builtin'i ile ayrıştır.\n"
+    "    str session_id = \"\";\n"
+    "    if (length(cookie_header) > 0) {\n"
+    "        json cookies = parse_cookies(cookie_header);\n"
+    "        if (cookies[\"tulpar_sess\"]) {\n"
+    "            session_id = cookies[\"tulpar_sess\"];\n"
+    "        }\n"
+    "    }\n"
+    "    \n"
+    "    // Session kontrolü\n"
+    "    if (length(session_id) > 0) {\n"
+    "        // Global sessions arrayine erişim gerekli\n"
+    "        // Şimdilik route handler içinde erişilecek\n"
+    "        _request[\"session_id\"] = session_id;\n"
+    "    } else {\n"
+    "        // Yeni session oluşturulmalı mı?\n"
+    "        // Bu genellikle login sırasında yapılır\n"
+    "        _request[\"session_id\"] = \"\";\n"
+    "    }\n"
+    "}\n"
+    "";
+
+// ========================================
+// lib/socket.tpr
+// ========================================
+static const char *EMBEDDED_SOCKET =
+"// Tulpar Standard Library - Socket Wrapper (No OOP)\n"
+    "\n"
+    "// Socket type - just a simple object\n"
+    "type Socket {\n"
+    "    int sockfd;\n"
+    "    str host;\n"
+    "    int port;\n"
+    "    bool is_server;\n"
+    "    bool connected;\n"
+    "}\n"
+    "\n"
+    "// Helper functions that work with Socket objects\n"
+    "func socket_obj_send(json sock, str data) {\n"
+    "    if (sock[\"connected\"]) {\n"
+    "        return socket_send(sock[\"sockfd\"], data);\n"
+    "    }\n"
+    "    return -1;\n"
+    "}\n"
+    "\n"
+    "func socket_obj_receive(json sock, int size) {\n"
+    "    if (sock[\"connected\"]) {\n"
+    "        return socket_receive(sock[\"sockfd\"], size);\n"
+    "    }\n"
+    "    return \"\";\n"
+    "}\n"
+    "\n"
+    "func socket_obj_close(json sock) {\n"
+    "    if (sock[\"connected\"]) {\n"
+    "        socket_close(sock[\"sockfd\"]);\n"
+    "        sock[\"connected\"] = false;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "func socket_obj_accept(json sock) {\n"
+    "    if (sock[\"is_server\"] && sock[\"connected\"]) {\n"
+    "        int client_fd = socket_accept(sock[\"sockfd\"]);\n"
+    "        if (client_fd != -1) {\n"
+    "            json client = {\n"
+    "                \"sockfd\": client_fd,\n"
+    "                \"host\": \"\",\n"
+    "                \"port\": 0,\n"
+    "                \"is_server\": false,\n"
+    "                \"connected\": true\n"
+    "            };\n"
+    "            return client;\n"
+    "        }\n"
+    "    }\n"
+    "    json empty = {\n"
+    "        \"sockfd\": -1,\n"
+    "        \"host\": \"\",\n"
+    "        \"port\": 0,\n"
+    "        \"is_server\": false,\n"
+    "        \"connected\": false\n"
+    "    };\n"
+    "    return empty;\n"
+    "}\n"
+    "\n"
+    "func create_server(str host, int port) {\n"
+    "    int fd = socket_server(host, port);\n"
+    "    json sock = {\n"
+    "        \"sockfd\": fd,\n"
+    "        \"host\": host,\n"
+    "        \"port\": port,\n"
+    "        \"is_server\": true,\n"
+    "        \"connected\": fd != -1\n"
+    "    };\n"
+    "    return sock;\n"
+    "}\n"
+    "\n"
+    "func create_client(str host, int port) {\n"
+    "    int fd = socket_client(host, port);\n"
+    "    json sock = {\n"
+    "        \"sockfd\": fd,\n"
+    "        \"host\": host,\n"
+    "        \"port\": port,\n"
+    "        \"is_server\": false,\n"
+    "        \"connected\": fd != -1\n"
+    "    };\n"
+    "    return sock;\n"
+    "}\n"
+    "";
+
+// ========================================
+// lib/tulpar_api.tpr
+// ========================================
+static const char *EMBEDDED_TULPAR_API =
+"// ============================================\n"
+    "// TulparAPI - FastAPI-style Micro Framework\n"
+    "// Ultra-fast API development for Tulpar\n"
+    "// ============================================\n"
+    "\n"
+    "import \"lib/router.tpr\";\n"
+    "\n"
+    "// Provide a len() helper aliasing built-in length()\n"
+    "func len(array a) { return length(a); }\n"
+    "func len(json a) { return length(a); }\n"
+    "func len(str s) { return length(s); }\n"
+    "\n"
+    "// ============================================\n"
+    "// TulparAPI Class-like Functions\n"
+    "// ============================================\n"
+    "\n"
+    "// Global API state\n"
+    "json _api_routes = [];\n"
+    "json _api_config = {\n"
+    "    \"title\": \"TulparAPI\",\n"
+    "    \"version\": \"1.0.0\",\n"
+    "    \"debug\": 0\n"
+    "};\n"
+    "\n"
+    "// Initialize API\n"
+    "func api_init(str title, str version) {\n"
+    "    _api_config[\"title\"] = title;\n"
+    "    _api_config[\"version\"] = version;\n"
+    "    print(\"🚀 \" + title + \" v\" + version + \" starting...\");\n"
+    "}\n"
+    "\n"
+    "// ============================================\n"
+    "// Route Decorators (Function-based)\n"
+    "// ============================================\n"
+    "\n"
+    "// GET endpoint\n"
+    "func api_get(str path, str handler_name) {\n"
+    "    route_get(path, handler_name);\n"
+    "    json route = {\n"
+    "        \"method\": \"GET\",\n"
+    "        \"path\": path,\n"
+    "        \"handler\": handler_name\n"
+    "    };\n"
+    "    push(_api_routes, route);\n"
+    "}\n"
+    "\n"
+    "// POST endpoint\n"
+    "func api_post(str path, str handler_name) {\n"
+    "    route_post(path, handler_name);\n"
+    "    json route = {\n"
+    "        \"method\": \"POST\",\n"
+    "        \"path\": path,\n"
+    "        \"handler\": handler_name\n"
+    "    };\n"
+    "    push(_api_routes, route);\n"
+    "}\n"
+    "\n"
+    "// PUT endpoint\n"
+    "func api_put(str path, str handler_name) {\n"
+    "    route_put(path, handler_name);\n"
+    "    json route = {\n"
+    "        \"method\": \"PUT\",\n"
+    "        \"path\": path,\n"
+    "        \"handler\": handler_name\n"
+    "    };\n"
+    "    push(_api_routes, route);\n"
+    "}\n"
+    "\n"
+    "// DELETE endpoint\n"
+    "func api_delete(str path, str handler_name) {\n"
+    "    route_delete(path, handler_name);\n"
+    "    json route = {\n"
+    "        \"method\": \"DELETE\",\n"
+    "        \"path\": path,\n"
+    "        \"handler\": handler_name\n"
+    "    };\n"
+    "    push(_api_routes, route);\n"
+    "}\n"
+    "\n"
+    "// ============================================\n"
+    "// Response Helpers\n"
+    "// ============================================\n"
+    "\n"
+    "// JSON Response (string HTTP response)\n"
+    "func api_json_response(json data) {\n"
+    "    return json_response(200, data);\n"
+    "}\n"
+    "\n"
+    "// JSON Response with status (string HTTP response)\n"
+    "func api_json_response_status(json data, int status) {\n"
+    "    return json_response(status, data);\n"
+    "}\n"
+    "\n"
+    "// Error Response\n"
+    "func api_error_response(str message, int status) {\n"
+    "    json error = {\n"
+    "        \"error\": message,\n"
+    "        \"status\": status\n"
+    "    };\n"
+    "    return api_json_response_status(error, status);\n"
+    "}\n"
+    "\n"
+    "// Success Response\n"
+    "func api_success_response(str message, json data) {\n"
+    "    json resp = {\n"
+    "        \"success\": 1,\n"
+    "        \"message\": message,\n"
+    "        \"data\": data\n"
+    "    };\n"
+    "    return api_json_response(resp);\n"
+    "}\n"
+    "\n"
+    "// ============================================\n"
+    "// Built-in Endpoints\n"
+    "// ============================================\n"
+    "\n"
+    "// Health check endpoint handler\n"
+    "func _health_handler(json req) {\n"
+    "    return api_json_response({\n"
+    "        \"status\": \"healthy\",\n"
+    "        \"timestamp\": clock_ms()\n"
+    "    });\n"
+    "}\n"
+    "\n"
+    "// API info endpoint handler\n"
+    "func _info_handler(json req) {\n"
+    "    return api_json_response({\n"
+    "        \"title\": _api_config[\"title\"],\n"
+    "        \"version\": _api_config[\"version\"],\n"
+    "        \"routes\": _api_routes\n"
+    "    });\n"
+    "}\n"
+    "\n"
+    "// ============================================\n"
+    "// Server Start\n"
+    "// ============================================\n"
+    "\n"
+    "func api_run(int port) {\n"
+    "    // Add built-in routes\n"
+    "    api_get(\"/health\", \"_health_handler\");\n"
+    "    api_get(\"/api/info\", \"_info_handler\");\n"
+    "\n"
+    "    print(\"📡 API running on http://127.0.0.1:\" + toString(port));\n"
+    "    print(\"📚 Endpoints registered: \" + toString(len(_api_routes)));\n"
+    "    print(\"\");\n"
+    "    \n"
+    "    // List all routes\n"
+    "    for(int i=0; i<len(_api_routes); i++) {\n"
+    "        json r = _api_routes[i];\n"
+    "        print(\"  \" + r[\"method\"] + \" \" + r[\"path\"]);\n"
+    "    }\n"
+    "    print(\"\");\n"
+    "    \n"
+    "    listen(port);\n"
+    "}\n"
+    "\n"
+    "// ============================================\n"
+    "// Middleware Support\n"
+    "// ============================================\n"
+    "\n"
+    "func api_use(str middleware_name) {\n"
+    "    use_middleware(middleware_name);\n"
+    "    print(\"✅ Middleware enabled: \" + middleware_name);\n"
+    "}\n"
+    "";
+
+// ========================================
+// lib/test.tpr
+// ========================================
+static const char *EMBEDDED_TEST =
+"// ============================================\n"
+    "// Tulpar Test Framework\n"
+    "// ============================================\n"
+    "// Usage:\n"
+    "//   import \"test\";\n"
+    "//\n"
+    "//   func basic_addition() {\n"
+    "//     assert_eq_int(1 + 1, 2);\n"
+    "//     assert_eq_str(upper(\"hi\"), \"HI\");\n"
+    "//   }\n"
+    "//\n"
+    "//   test(\"addition works\", \"basic_addition\");\n"
+    "//   test_summary();\n"
+    "//\n"
+    "// Each test runs in isolation by clearing per-test failure flags before\n"
+    "// invoking the handler via call(). Assertion failures set the flag + a\n"
+    "// message; the runner records pass/fail and continues so one bad test\n"
+    "// doesn't hide the rest. test_summary() exits with a non-zero status if\n"
+    "// any test failed, so the suite plays nicely with CI runners.\n"
+    "//\n"
+    "// Type-specialised assertions (assert_eq_int / assert_eq_str / assert_eq_bool)\n"
+    "// are used instead of a single generic assert_eq because Tulpar's AOT\n"
+    "// codegen has a known limitation where `json`-typed parameters can lose\n"
+    "// string identity after toJson round-trip when the call goes through\n"
+    "// dlsym (i.e. `call()`). The specialised forms compare the values directly\n"
+    "// without the json round-trip and work uniformly on AOT and VM.\n"
+    "// ============================================\n"
+    "\n"
+    "int _test_pass = 0;\n"
+    "int _test_fail = 0;\n"
+    "int _test_current_failed = 0;\n"
+    "str _test_current_msg = \"\";\n"
+    "str _test_current_name = \"\";\n"
+    "\n"
+    "func _test_set_fail(str msg) {\n"
+    "    _test_current_failed = 1;\n"
+    "    _test_current_msg = msg;\n"
+    "}\n"
+    "\n"
+    "// ----- Assertions ----------------------------------------------------------\n"
+    "\n"
+    "// Generic boolean assertion. `cond` must be truthy (non-zero); otherwise the\n"
+    "// current test fails with `msg` (or a default message).\n"
+    "func assert(int cond, str msg) {\n"
+    "    if (cond == 0) {\n"
+    "        if (length(msg) > 0) {\n"
+    "            _test_set_fail(msg);\n"
+    "        } else {\n"
+    "            if (length(_test_current_msg) == 0) {\n"
+    "                _test_set_fail(\"assert failed\");\n"
+    "            }\n"
+    "        }\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Integer equality.\n"
+    "func assert_eq_int(int actual, int expected) {\n"
+    "    if (actual != expected) {\n"
+    "        _test_set_fail(\"expected \" + toString(expected) +\n"
+    "                       \" got \" + toString(actual));\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// String equality (byte-exact). `actual` and `expected` are typed as\n"
+    "// `json` (rather than `str`) so any value flows through the same path\n"
+    "// — toString first, then byte-equality. This used to be necessary as\n"
+    "// a workaround for an AOT `!=`-on-strings bug, which was traced to\n"
+    "// `vm_make_bool` leaving uninitialised bytes in the VMValue payload\n"
+    "// (#40); the routing through toString is kept because it gives more\n"
+    "// useful error messages on type mismatches (you see \"got 42\" instead\n"
+    "// of \"got <object>\").\n"
+    "func assert_eq_str(json actual, json expected) {\n"
+    "    str sa = toString(actual);\n"
+    "    str sb = toString(expected);\n"
+    "    if (sa != sb) {\n"
+    "        _test_set_fail(\"expected '\" + sb + \"' got '\" + sa + \"'\");\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Boolean (0/1) equality.\n"
+    "func assert_eq_bool(int actual, int expected) {\n"
+    "    int a = 0;\n"
+    "    int e = 0;\n"
+    "    if (actual != 0) { a = 1; }\n"
+    "    if (expected != 0) { e = 1; }\n"
+    "    if (a != e) {\n"
+    "        _test_set_fail(\"expected \" + toString(e) + \" got \" + toString(a));\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// String-contains assertion (case-sensitive). Useful for error message tests.\n"
+    "// `contains` returns a bool (true/false); we negate via if/else rather than\n"
+    "// comparing to 0, since bool-vs-int equality in Tulpar lands on a slow\n"
+    "// fallback path that's easier to misread.\n"
+    "func assert_contains(json haystack, json needle) {\n"
+    "    str hs = toString(haystack);\n"
+    "    str nd = toString(needle);\n"
+    "    if (contains(hs, nd)) {\n"
+    "        // ok\n"
+    "    } else {\n"
+    "        _test_set_fail(\"expected '\" + hs + \"' to contain '\" + nd + \"'\");\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Throws assertion: invokes `handler` (function name, no `t_` prefix) and\n"
+    "// asserts that it raises an exception. If `expected_msg_contains` is\n"
+    "// non-empty, also asserts the caught message contains that substring.\n"
+    "//\n"
+    "//   func bad() { throw \"oops\"; }\n"
+    "//   assert_throws(\"bad\", \"oops\");\n"
+    "//\n"
+    "// Useful for testing the error path of input validation, parse errors,\n"
+    "// auth failures, etc.\n"
+    "func assert_throws(str handler, str expected_msg_contains) {\n"
+    "    int threw = 0;\n"
+    "    str caught_msg = \"\";\n"
+    "    try {\n"
+    "        call(handler);\n"
+    "    } catch (e) {\n"
+    "        threw = 1;\n"
+    "        caught_msg = toString(e);\n"
+    "    }\n"
+    "    if (threw == 0) {\n"
+    "        _test_set_fail(\"expected handler '\" + handler + \"' to throw\");\n"
+    "    } else {\n"
+    "        if (length(expected_msg_contains) > 0) {\n"
+    "            if (contains(caught_msg, expected_msg_contains)) {\n"
+    "                // ok\n"
+    "            } else {\n"
+    "                _test_set_fail(\"threw '\" + caught_msg +\n"
+    "                    \"' (expected to contain '\" + expected_msg_contains + \"')\");\n"
+    "            }\n"
+    "        }\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// HTTP status assertion: takes a raw response string (\"HTTP/1.1 200 OK\\r\\n...\")\n"
+    "// and asserts the numeric status appears in the status line.\n"
+    "func assert_status(json response, int expected_status) {\n"
+    "    str rs = toString(response);\n"
+    "    str expected_marker = \" \" + toString(expected_status) + \" \";\n"
+    "    if (contains(rs, expected_marker)) {\n"
+    "        // ok\n"
+    "    } else {\n"
+    "        _test_set_fail(\"expected status \" + toString(expected_status) +\n"
+    "            \" in '\" + substring(rs, 0, 32) + \"...'\");\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// ----- Runner --------------------------------------------------------------\n"
+    "\n"
+    "// Run a single test. Resets per-test state, dispatches the handler, then\n"
+    "// records pass/fail. Output is intentionally Jest-like:\n"
+    "//   PASS addition works\n"
+    "//   FAIL int overflow: expected 2147483647 got -2147483648\n"
+    "//\n"
+    "// IMPORTANT: handler names should NOT carry the `t_` prefix — call()\n"
+    "// adds it internally to find the AOT-mangled symbol.\n"
+    "func test(str name, str handler) {\n"
+    "    _test_current_failed = 0;\n"
+    "    _test_current_msg = \"\";\n"
+    "    _test_current_name = name;\n"
+    "    call(handler);\n"
+    "    if (_test_current_failed == 1) {\n"
+    "        _test_fail = _test_fail + 1;\n"
+    "        print(\"  FAIL \" + name + \": \" + _test_current_msg);\n"
+    "    } else {\n"
+    "        _test_pass = _test_pass + 1;\n"
+    "        print(\"  PASS \" + name);\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Print a summary and exit non-zero if any test failed. Call this once at\n"
+    "// the bottom of the test file.\n"
+    "func test_summary() {\n"
+    "    int total = _test_pass + _test_fail;\n"
+    "    print(\"\");\n"
+    "    print(\"Tests: \" + toString(total) +\n"
+    "          \" | Pass: \" + toString(_test_pass) +\n"
+    "          \" | Fail: \" + toString(_test_fail));\n"
+    "    if (_test_fail > 0) {\n"
+    "        exit(1);\n"
+    "    }\n"
+    "}\n"
+    "";
+
+// ========================================
+// lib/http_client.tpr
+// ========================================
+static const char *EMBEDDED_HTTP_CLIENT =
+"// ============================================\n"
+    "// Tulpar HTTP Client (outbound)\n"
+    "// ============================================\n"
+    "//\n"
+    "// Thin wrappers over the native `http_request(method, url, body)`\n"
+    "// builtin. The builtin handles URL parsing, DNS, connect, send, recv,\n"
+    "// and response parsing. These helpers exist so user code can write\n"
+    "//\n"
+    "//     json r = http_get(\"http://api/users/1\");\n"
+    "//     if (r[\"ok\"]) { print(r[\"body\"]); }\n"
+    "//\n"
+    "// without remembering the builtin's positional contract.\n"
+    "//\n"
+    "// Limitations (current):\n"
+    "//   * No HTTPS — `https://` URLs return `{ok:0, error:\"…\"}`.\n"
+    "//   * No redirects, no chunked encoding, no client-side keep-alive.\n"
+    "//   * Response body is a raw string; use fromJson() to parse.\n"
+    "// ============================================\n"
+    "\n"
+    "func http_get(str url) {\n"
+    "    return http_request(\"GET\", url, \"\");\n"
+    "}\n"
+    "\n"
+    "func http_post(str url, str body) {\n"
+    "    return http_request(\"POST\", url, body);\n"
+    "}\n"
+    "\n"
+    "func http_put(str url, str body) {\n"
+    "    return http_request(\"PUT\", url, body);\n"
+    "}\n"
+    "\n"
+    "func http_delete(str url) {\n"
+    "    return http_request(\"DELETE\", url, \"\");\n"
+    "}\n"
+    "\n"
+    "// Convenience: http_get_json / http_post_json — response.body is parsed\n"
+    "// as JSON when the request succeeded. On failure returns the raw error\n"
+    "// envelope so callers can do `r[\"ok\"]` checks uniformly.\n"
+    "func http_get_json(str url) {\n"
+    "    json r = http_get(url);\n"
+    "    if (r[\"ok\"]) {\n"
+    "        json out = {\n"
+    "            \"ok\": 1,\n"
+    "            \"status\": r[\"status\"],\n"
+    "            \"headers\": r[\"headers\"],\n"
+    "            \"data\": fromJson(r[\"body\"])\n"
+    "        };\n"
+    "        return out;\n"
+    "    }\n"
+    "    return r;\n"
+    "}\n"
+    "\n"
+    "func http_post_json(str url, json data) {\n"
+    "    str body = toJson(data);\n"
+    "    json r = http_post(url, body);\n"
+    "    if (r[\"ok\"]) {\n"
+    "        json out = {\n"
+    "            \"ok\": 1,\n"
+    "            \"status\": r[\"status\"],\n"
+    "            \"headers\": r[\"headers\"],\n"
+    "            \"data\": fromJson(r[\"body\"])\n"
+    "        };\n"
+    "        return out;\n"
+    "    }\n"
+    "    return r;\n"
+    "}\n"
+    "\n"
+    "// ============================================\n"
+    "// Async HTTP client (non-blocking)\n"
+    "// ============================================\n"
+    "//\n"
+    "// `http_request_async(method, url, body)` returns a promise instead of\n"
+    "// blocking. The request runs on a worker pool while the async event loop\n"
+    "// keeps pumping other coroutines, so many requests can be in flight at once:\n"
+    "//\n"
+    "//     async func fetch_two(str a, str b) {\n"
+    "//         json r = await gather(http_get_async(a), http_get_async(b));\n"
+    "//         return r;   // both fetched concurrently — total time ~ max(a, b)\n"
+    "//     }\n"
+    "//\n"
+    "// Each helper returns a promise; `await` it (directly or via gather()). The\n"
+    "// resolved value is the same { ok, status, headers, body } envelope as the\n"
+    "// blocking client. Pool size defaults to 4 (TULPAR_HTTP_POOL to override).\n"
+    "\n"
+    "func http_get_async(str url) {\n"
+    "    return http_request_async(\"GET\", url, \"\");\n"
+    "}\n"
+    "\n"
+    "func http_post_async(str url, str body) {\n"
+    "    return http_request_async(\"POST\", url, body);\n"
+    "}\n"
+    "\n"
+    "func http_put_async(str url, str body) {\n"
+    "    return http_request_async(\"PUT\", url, body);\n"
+    "}\n"
+    "\n"
+    "func http_delete_async(str url) {\n"
+    "    return http_request_async(\"DELETE\", url, \"\");\n"
+    "}\n"
+    "";
+
+// ========================================
+// lib/orm.tpr
+// ========================================
+static const char *EMBEDDED_ORM =
+"// ============================================\n"
+    "// Tulpar ORM v2 — model handle + UFCS üstünde Active-Record tarzı katman.\n"
+    "// ============================================\n"
+    "//\n"
+    "// Hedef (WINGS_DX.md §2): veritabanı kodu şöyle okunmalı —\n"
+    "//\n"
+    "//     import \"orm\";\n"
+    "//\n"
+    "//     database(\"app.db\");\n"
+    "//     json Note = model(\"notes\", {\n"
+    "//         \"id\":    \"pk\",        // INTEGER PRIMARY KEY AUTOINCREMENT\n"
+    "//         \"title\": \"str!\",      // TEXT NOT NULL\n"
+    "//         \"done\":  \"bool\"       // INTEGER 0/1 — okurken true/false döner\n"
+    "//     });\n"
+    "//\n"
+    "//     int id     = Note.create({\"title\": \"süt al\"});\n"
+    "//     json n     = Note.find(id);              // {} = bulunamadı\n"
+    "//     array all  = Note.all();\n"
+    "//     array open = Note.where(\"done = ?\", [0]); // HER ZAMAN bağlı parametre\n"
+    "//     array recent = Note.where(\"done = ?\", [0], {\"order\": \"id DESC\", \"limit\": 20});\n"
+    "//     json f     = Note.first(\"done = ?\", [0]);\n"
+    "//     int c      = Note.count();\n"
+    "//     Note.update(id, {\"done\": 0});            // 0/\"\" değerler de YAZILIR\n"
+    "//     json row   = Note.save({\"id\": 3, \"title\": \"x\"});  // upsert\n"
+    "//     Note.remove(id);\n"
+    "//\n"
+    "// `Note.find(1)` UFCS ile `find(Note, 1)`'e çözünür; model handle sıradan\n"
+    "// bir json'dur: {\"table\": ..., \"db\": <handle>, \"schema\": {...}}.\n"
+    "//\n"
+    "// Güvenlik: üretilen her SQL `?` + params ile 3-arg db_query/db_execute'a\n"
+    "// gider (v3.3.0 parametreli SQL). Tek kaçış kapısı `raw(m, where_sql)` —\n"
+    "// adı üstünde: içine kullanıcı girdisi GÖMME.\n"
+    "//\n"
+    "// v1 API'si (orm_open / define_model / orm_create / orm_find / orm_all /\n"
+    "// orm_where / orm_update / orm_delete) dosyanın sonunda ince sarmalayıcı\n"
+    "// olarak yaşıyor — eski kod kırılmaz. v1'den farklı olarak 0/boş değerler\n"
+    "// artık sessizce düşürülmez (bilinen MVP bug'ı kapandı).\n"
+    "// ============================================\n"
+    "\n"
+    "int _orm_db = -1;\n"
+    "json _orm_handles = {};\n"
+    "\n"
+    "// ----- bağlantı ---------------------------------------------------------------\n"
+    "\n"
+    "// database(path) — SQLite dosyasını açar ve SONRAKİ model() çağrılarının\n"
+    "// varsayılan bağlantısı yapar. Birden çok kez çağrılabilir; her model\n"
+    "// kendi handle'ını taşıdığı için eski modeller eski veritabanında kalır.\n"
+    "func database(str path) {\n"
+    "    _orm_db = db_open(path);\n"
+    "    if (_orm_db < 0) {\n"
+    "        throw \"database(): db_open(\" + path + \") başarısız / failed\";\n"
+    "    }\n"
+    "    return _orm_db;\n"
+    "}\n"
+    "\n"
+    "func orm_close() {\n"
+    "    if (_orm_db >= 0) {\n"
+    "        db_close(_orm_db);\n"
+    "        _orm_db = -1;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// ----- yardımcılar --------------------------------------------------------------\n"
+    "\n"
+    "// SQL identifier quoting — SQLite çift tırnak, içteki `\"` ikilenir.\n"
+    "func _orm_quote_ident(str s) {\n"
+    "    return \"\\\"\" + replace(s, \"\\\"\", \"\\\"\\\"\") + \"\\\"\";\n"
+    "}\n"
+    "\n"
+    "// obj `k` anahtarını gerçekten taşıyor mu? (obj[k] yokken 0 döndüğü için\n"
+    "// truthiness güvenilmez — v1'in 0/boş değer bug'ının kökü buydu.)\n"
+    "func _orm_has(json obj, str k) {\n"
+    "    array ks = keys(obj);\n"
+    "    for (x in ks) {\n"
+    "        if (x == k) { return true; }\n"
+    "    }\n"
+    "    return false;\n"
+    "}\n"
+    "\n"
+    "// Tip kısayolu → SQL kolon tanımı. body_schema ile ORTAK kelime hazinesi:\n"
+    "// pk / int / float / bool / str (+ `!` = NOT NULL). Tanınmayan her şey ham\n"
+    "// SQL olarak geçer (\"TEXT UNIQUE\" gibi) — v1'in raw tanımları da böylece\n"
+    "// çalışmaya devam eder.\n"
+    "func _orm_sql_type(str t) {\n"
+    "    if (t == \"pk\")     { return \"INTEGER PRIMARY KEY AUTOINCREMENT\"; }\n"
+    "    if (t == \"int\")    { return \"INTEGER\"; }\n"
+    "    if (t == \"int!\")   { return \"INTEGER NOT NULL\"; }\n"
+    "    if (t == \"float\")  { return \"REAL\"; }\n"
+    "    if (t == \"float!\") { return \"REAL NOT NULL\"; }\n"
+    "    if (t == \"bool\")   { return \"INTEGER NOT NULL DEFAULT 0\"; }\n"
+    "    if (t == \"str\")    { return \"TEXT\"; }\n"
+    "    if (t == \"str!\")   { return \"TEXT NOT NULL\"; }\n"
+    "    return t;\n"
+    "}\n"
+    "\n"
+    "// Tek değer cast'i. db_query INTEGER/REAL kolonları zaten int/float döndürür;\n"
+    "// tek gerçek dönüşüm \"bool\" kolonlarının 0/1'ini true/false yapmak.\n"
+    "func _orm_cast_val(str t, json v) {\n"
+    "    if (t == \"bool\") { return toInt(toString(v)) == 1; }\n"
+    "    return v;\n"
+    "}\n"
+    "\n"
+    "// Ham DB satırı → şemaya göre cast'lenmiş satır. Şemada olmayan kolonlar\n"
+    "// (COUNT(*) AS n gibi hesaplananlar) dokunulmadan geçer.\n"
+    "func _orm_cast_row(json m, json row) {\n"
+    "    json schema = m[\"schema\"];\n"
+    "    json out = {};\n"
+    "    array rks = keys(row);\n"
+    "    for (k in rks) {\n"
+    "        if (_orm_has(schema, k)) {\n"
+    "            str t = schema[k];\n"
+    "            out[k] = _orm_cast_val(t, row[k]);\n"
+    "        }\n"
+    "        if (!_orm_has(schema, k)) {\n"
+    "            out[k] = row[k];\n"
+    "        }\n"
+    "    }\n"
+    "    return out;\n"
+    "}\n"
+    "\n"
+    "func _orm_cast_rows(json m, array rows) {\n"
+    "    array out = [];\n"
+    "    for (r in rows) {\n"
+    "        push(out, _orm_cast_row(m, r));\n"
+    "    }\n"
+    "    return out;\n"
+    "}\n"
+    "\n"
+    "// CREATE TABLE IF NOT EXISTS — model() kısayolları çevirir, define_model\n"
+    "// (v1) ham tanımları olduğu gibi geçirir.\n"
+    "func _orm_create_table(json m, bool translate) {\n"
+    "    json schema = m[\"schema\"];\n"
+    "    array names = keys(schema);\n"
+    "    str sql = \"CREATE TABLE IF NOT EXISTS \" + _orm_quote_ident(m[\"table\"]) + \" (\";\n"
+    "    bool firstc = true;\n"
+    "    for (col in names) {\n"
+    "        if (!firstc) { sql = sql + \", \"; }\n"
+    "        str def = schema[col];\n"
+    "        if (translate) { def = _orm_sql_type(def); }\n"
+    "        sql = sql + _orm_quote_ident(col) + \" \" + def;\n"
+    "        firstc = false;\n"
+    "    }\n"
+    "    sql = sql + \")\";\n"
+    "    db_execute(m[\"db\"], sql);\n"
+    "}\n"
+    "\n"
+    "// Sıcak yoldaki sabit SQL'ler (find / count / remove) model tanımında BİR\n"
+    "// KEZ db_prepare ile hazırlanır; handle'lar modelde q_* olarak taşınır ve\n"
+    "// her çağrıda SQL metni kurulmaz, hash'lenmez, cache'te aranmaz. Hazırlık\n"
+    "// başarısız olursa (ör. v1 şemasında `id` kolonu yok) 0 kalır ve çağrılar\n"
+    "// eski db_query yoluna düşer. Tablo oluştuktan SONRA çağrılmalı.\n"
+    "func _orm_prepare(json m) {\n"
+    "    str t = _orm_quote_ident(m[\"table\"]);\n"
+    "    m[\"q_find\"] = db_prepare(m[\"db\"], \"SELECT * FROM \" + t + \" WHERE id = ? LIMIT 1\");\n"
+    "    m[\"q_count\"] = db_prepare(m[\"db\"], \"SELECT COUNT(*) AS n FROM \" + t);\n"
+    "    m[\"q_remove\"] = db_prepare(m[\"db\"], \"DELETE FROM \" + t + \" WHERE id = ?\");\n"
+    "    return m;\n"
+    "}\n"
+    "\n"
+    "// Modelin hazırlanmış statement handle'ı; yoksa/başarısızsa 0.\n"
+    "func _orm_stmt(json m, str k) {\n"
+    "    if (!_orm_has(m, k)) {\n"
+    "        return 0;\n"
+    "    }\n"
+    "    return toInt(toString(m[k]));\n"
+    "}\n"
+    "\n"
+    "// ----- model ---------------------------------------------------------------------\n"
+    "\n"
+    "// model(table, schema) → model handle. Tabloyu yoksa oluşturur. Handle'ı\n"
+    "// bir global'e ata (`json Note = model(...)`) ve UFCS ile kullan.\n"
+    "func model(str table, json schema) {\n"
+    "    if (_orm_db < 0) {\n"
+    "        throw \"model(): önce database(\\\"dosya.db\\\") çağır / call database(path) first\";\n"
+    "    }\n"
+    "    json m = {\"table\": table, \"db\": _orm_db, \"schema\": schema};\n"
+    "    _orm_create_table(m, true);\n"
+    "    m = _orm_prepare(m);\n"
+    "    _orm_handles[table] = m;\n"
+    "    return m;\n"
+    "}\n"
+    "\n"
+    "// ----- CRUD ------------------------------------------------------------------------\n"
+    "\n"
+    "// create(m, attrs) → int (yeni kaydın id'si). Şemada olmayan anahtarlar\n"
+    "// düşürülür (request body'yi olduğu gibi geçirebil), pk dışarıda tutulur,\n"
+    "// 0/\"\"/false dâhil şemadaki HER mevcut anahtar yazılır.\n"
+    "func create(json m, json attrs) {\n"
+    "    json schema = m[\"schema\"];\n"
+    "    str cols = \"\";\n"
+    "    str qs = \"\";\n"
+    "    array vals = [];\n"
+    "    bool first_col = true;\n"
+    "    array aks = keys(attrs);\n"
+    "    for (k in aks) {\n"
+    "        if (_orm_has(schema, k)) {\n"
+    "            str t = schema[k];\n"
+    "            if (t != \"pk\") {\n"
+    "                if (!first_col) {\n"
+    "                    cols = cols + \", \";\n"
+    "                    qs = qs + \", \";\n"
+    "                }\n"
+    "                cols = cols + _orm_quote_ident(k);\n"
+    "                qs = qs + \"?\";\n"
+    "                push(vals, attrs[k]);\n"
+    "                first_col = false;\n"
+    "            }\n"
+    "        }\n"
+    "    }\n"
+    "    str sql = \"INSERT INTO \" + _orm_quote_ident(m[\"table\"]) +\n"
+    "        \" (\" + cols + \") VALUES (\" + qs + \")\";\n"
+    "    db_execute(m[\"db\"], sql, vals);\n"
+    "    return db_last_insert_id(m[\"db\"]);\n"
+    "}\n"
+    "\n"
+    "// find(m, id) → tek satır (cast'li) ya da {} (bulunamadı).\n"
+    "func find(json m, int id) {\n"
+    "    array rows = [];\n"
+    "    int st = _orm_stmt(m, \"q_find\");\n"
+    "    if (st > 0) {\n"
+    "        rows = db_stmt_query(st, [id]);\n"
+    "    } else {\n"
+    "        str sql = \"SELECT * FROM \" + _orm_quote_ident(m[\"table\"]) + \" WHERE id = ? LIMIT 1\";\n"
+    "        rows = db_query(m[\"db\"], sql, [id]);\n"
+    "    }\n"
+    "    if (length(rows) == 0) {\n"
+    "        json empty = {};\n"
+    "        return empty;\n"
+    "    }\n"
+    "    return _orm_cast_row(m, rows[0]);\n"
+    "}\n"
+    "\n"
+    "// opts → \" ORDER BY ...\" + \" LIMIT ...\" kuyruğu. `opts` eksik bırakılırsa\n"
+    "// (default-arg padding) boxed int 0 olarak gelir — typeof kontrolü onu\n"
+    "// sessizce hiçbir-şey'e çevirir. `order` ham SQL parçasıdır (kolon adı +\n"
+    "// isteğe bağlı ASC/DESC) — `raw()` gibi kullanıcı girdisini doğrudan gömme.\n"
+    "func _orm_clause(json opts) {\n"
+    "    str s = \"\";\n"
+    "    if (typeof(opts) != \"object\") {\n"
+    "        return s;\n"
+    "    }\n"
+    "    if (_orm_has(opts, \"order\")) {\n"
+    "        s = s + \" ORDER BY \" + toString(opts[\"order\"]);\n"
+    "    }\n"
+    "    if (_orm_has(opts, \"limit\")) {\n"
+    "        s = s + \" LIMIT \" + toString(toInt(toString(opts[\"limit\"])));\n"
+    "    }\n"
+    "    return s;\n"
+    "}\n"
+    "\n"
+    "// all(m[, opts]) → array<json> (cast'li). opts: {\"order\": \"id DESC\", \"limit\": 20}.\n"
+    "func all(json m, json opts) {\n"
+    "    str sql = \"SELECT * FROM \" + _orm_quote_ident(m[\"table\"]) + _orm_clause(opts);\n"
+    "    array rows = db_query(m[\"db\"], sql, []);\n"
+    "    return _orm_cast_rows(m, rows);\n"
+    "}\n"
+    "\n"
+    "// where(m, cond, params[, opts]) → array<json>. Koşul `?` yer tutucuları\n"
+    "// taşır, değerler HER ZAMAN bağlanır: Note.where(\"done = ? AND id > ?\", [0, 5]).\n"
+    "// opts (opsiyonel): {\"order\": \"id DESC\", \"limit\": 20} — sayfalama/sıralama\n"
+    "// için where()'e ayrı bir query-builder gerekmeden.\n"
+    "func where(json m, str cond, array params, json opts) {\n"
+    "    str sql = \"SELECT * FROM \" + _orm_quote_ident(m[\"table\"]) + \" WHERE \" + cond + _orm_clause(opts);\n"
+    "    array rows = db_query(m[\"db\"], sql, params);\n"
+    "    return _orm_cast_rows(m, rows);\n"
+    "}\n"
+    "\n"
+    "// first(m, cond, params) → ilk eşleşen satır ya da {}.\n"
+    "func first(json m, str cond, array params) {\n"
+    "    str sql = \"SELECT * FROM \" + _orm_quote_ident(m[\"table\"]) +\n"
+    "        \" WHERE \" + cond + \" LIMIT 1\";\n"
+    "    array rows = db_query(m[\"db\"], sql, params);\n"
+    "    if (length(rows) == 0) {\n"
+    "        json empty = {};\n"
+    "        return empty;\n"
+    "    }\n"
+    "    return _orm_cast_row(m, rows[0]);\n"
+    "}\n"
+    "\n"
+    "// count(m) → tablodaki kayıt sayısı. Koşullu sayım: length(m.where(...)).\n"
+    "func count(json m) {\n"
+    "    array rows = [];\n"
+    "    int st = _orm_stmt(m, \"q_count\");\n"
+    "    if (st > 0) {\n"
+    "        rows = db_stmt_query(st, []);\n"
+    "    } else {\n"
+    "        str sql = \"SELECT COUNT(*) AS n FROM \" + _orm_quote_ident(m[\"table\"]);\n"
+    "        rows = db_query(m[\"db\"], sql, []);\n"
+    "    }\n"
+    "    return toInt(toString(rows[0][\"n\"]));\n"
+    "}\n"
+    "\n"
+    "// update(m, id, attrs) → 1 (bir şey yazıldı) / 0 (yazacak alan yoktu).\n"
+    "// create ile aynı kolon seçimi: keys(attrs) ∩ schema, pk hariç —\n"
+    "// {\"done\": 0} artık gerçekten yazılır (v1 bunu sessizce düşürüyordu).\n"
+    "func update(json m, int id, json attrs) {\n"
+    "    json schema = m[\"schema\"];\n"
+    "    str sets = \"\";\n"
+    "    array vals = [];\n"
+    "    bool first_col = true;\n"
+    "    array aks = keys(attrs);\n"
+    "    for (k in aks) {\n"
+    "        if (_orm_has(schema, k)) {\n"
+    "            str t = schema[k];\n"
+    "            if (t != \"pk\") {\n"
+    "                if (!first_col) { sets = sets + \", \"; }\n"
+    "                sets = sets + _orm_quote_ident(k) + \" = ?\";\n"
+    "                push(vals, attrs[k]);\n"
+    "                first_col = false;\n"
+    "            }\n"
+    "        }\n"
+    "    }\n"
+    "    if (first_col) {\n"
+    "        return 0;\n"
+    "    }\n"
+    "    push(vals, id);\n"
+    "    str sql = \"UPDATE \" + _orm_quote_ident(m[\"table\"]) + \" SET \" + sets + \" WHERE id = ?\";\n"
+    "    db_execute(m[\"db\"], sql, vals);\n"
+    "    return 1;\n"
+    "}\n"
+    "\n"
+    "// save(m, obj) → upsert: obj \"id\" taşıyor ve kayıt varsa update, yoksa\n"
+    "// create. Her iki yolda da taze satırı döndürür (id'si dolu).\n"
+    "func save(json m, json obj) {\n"
+    "    if (_orm_has(obj, \"id\")) {\n"
+    "        int id = toInt(toString(obj[\"id\"]));\n"
+    "        json existing = find(m, id);\n"
+    "        if (length(keys(existing)) > 0) {\n"
+    "            update(m, id, obj);\n"
+    "            return find(m, id);\n"
+    "        }\n"
+    "    }\n"
+    "    int nid = create(m, obj);\n"
+    "    return find(m, nid);\n"
+    "}\n"
+    "\n"
+    "// remove(m, id) → 1. (SQLite affected-count döndürmediğimiz için yaklaşık.)\n"
+    "func remove(json m, int id) {\n"
+    "    int st = _orm_stmt(m, \"q_remove\");\n"
+    "    if (st > 0) {\n"
+    "        db_stmt_execute(st, [id]);\n"
+    "        return 1;\n"
+    "    }\n"
+    "    str sql = \"DELETE FROM \" + _orm_quote_ident(m[\"table\"]) + \" WHERE id = ?\";\n"
+    "    db_execute(m[\"db\"], sql, [id]);\n"
+    "    return 1;\n"
+    "}\n"
+    "\n"
+    "// raw(m, where_sql) → array<json>. HAM where parçası — parametre BAĞLANMAZ.\n"
+    "// Kaçış kapısıdır: içine kullanıcı girdisi gömme; mümkünse where() kullan.\n"
+    "func raw(json m, str where_sql) {\n"
+    "    str sql = \"SELECT * FROM \" + _orm_quote_ident(m[\"table\"]) + \" WHERE \" + where_sql;\n"
+    "    return _orm_cast_rows(m, db_query(m[\"db\"], sql, []));\n"
+    "}\n"
+    "\n"
+    "// ============================================\n"
+    "// v1 uyumluluk katmanı — eski API, yeni çekirdeğe delege eder.\n"
+    "// Tek davranış farkı (bilerek): 0/\"\" değerler artık yazılır.\n"
+    "// ============================================\n"
+    "\n"
+    "func orm_open(str path) {\n"
+    "    return database(path);\n"
+    "}\n"
+    "\n"
+    "// v1 define_model ham SQL kolon tanımları alır (\"INTEGER PRIMARY KEY\n"
+    "// AUTOINCREMENT\" gibi) — çeviri yapılmadan geçer; kısayollar da çalışır.\n"
+    "func define_model(str table, json columns) {\n"
+    "    if (_orm_db < 0) {\n"
+    "        throw \"define_model(): önce orm_open(path) çağır / call orm_open(path) first\";\n"
+    "    }\n"
+    "    json m = {\"table\": table, \"db\": _orm_db, \"schema\": columns};\n"
+    "    _orm_create_table(m, false);\n"
+    "    m = _orm_prepare(m);\n"
+    "    _orm_handles[table] = m;\n"
+    "}\n"
+    "\n"
+    "func orm_create(str table, json attrs) {\n"
+    "    return create(_orm_handles[table], attrs);\n"
+    "}\n"
+    "\n"
+    "func orm_find(str table, int id) {\n"
+    "    return find(_orm_handles[table], id);\n"
+    "}\n"
+    "\n"
+    "func orm_all(str table) {\n"
+    "    return all(_orm_handles[table]);\n"
+    "}\n"
+    "\n"
+    "func orm_where(str table, str where_sql) {\n"
+    "    return raw(_orm_handles[table], where_sql);\n"
+    "}\n"
+    "\n"
+    "func orm_update(str table, int id, json attrs) {\n"
+    "    return update(_orm_handles[table], id, attrs);\n"
+    "}\n"
+    "\n"
+    "func orm_delete(str table, int id) {\n"
+    "    return remove(_orm_handles[table], id);\n"
+    "}\n"
+    "";
+
+// ========================================
+// lib/wings_tls.tpr
+// ========================================
+static const char *EMBEDDED_WINGS_TLS =
+"// Wings TLS listener — server-side HTTPS for Tulpar.\n"
+    "//\n"
+    "// Same handler API as `lib/wings`'s `listen` / `listen_async` /\n"
+    "// `listen_pool` / `listen_evented`, but every request rides over a\n"
+    "// TLS connection. Routes are still registered with `get` / `post` /\n"
+    "// etc. from `wings`; this module just adds the encrypted listener\n"
+    "// loop. Internally each connection gets its own thread (the\n"
+    "// listen_async shape) — keeps the implementation small while the\n"
+    "// async-I/O follow-up grows partial-read state for unencrypted Wings.\n"
+    "//\n"
+    "// Usage:\n"
+    "//   import \"wings\";\n"
+    "//   import \"wings_tls\";\n"
+    "//   get(\"/\", \"home\");\n"
+    "//   wings_tls(8443, \"./server.crt\", \"./server.key\");\n"
+    "//\n"
+    "// Cert + key are PEM-encoded files. For local dev use `openssl req\n"
+    "// -x509 -newkey rsa:2048 -keyout server.key -out server.crt -days 365\n"
+    "// -nodes -subj \"/CN=localhost\"`. For production point at your real\n"
+    "// cert chain (e.g. Let's Encrypt's `fullchain.pem` + `privkey.pem`).\n"
+    "//\n"
+    "// Build requirements: Tulpar must be compiled with OpenSSL — i.e.\n"
+    "// `find_package(OpenSSL)` succeeded at CMake time. `tls_init` returns\n"
+    "// 0 immediately on TLS-disabled builds and the listener prints an\n"
+    "// error and exits.\n"
+    "\n"
+    "import \"wings\";\n"
+    "\n"
+    "// Worker for one TLS connection. Reads bytes via SSL_read, parses,\n"
+    "// dispatches to the matching route, sends the response back via\n"
+    "// SSL_write, and tears down. No keep-alive yet — each connection\n"
+    "// serves one request and closes (TLS keep-alive can be re-added once\n"
+    "// `_wings_serve_one_request`-style splitting happens for the TLS path).\n"
+    "//\n"
+    "// The SSL pointer is boxed into a `json` so `thread_create` passes it\n"
+    "// through the canonical VMValue ABI; the worker unboxes on entry.\n"
+    "func _wings_tls_serve(json ssl_box) {\n"
+    "    int ssl = ssl_box;\n"
+    "    int wm = arena_save();\n"
+    "\n"
+    "    // SSL_read max — 256 KiB is plenty for typical wings JSON requests\n"
+    "    // and keeps DoS exposure bounded. See _wings_max_body_bytes for\n"
+    "    // the plain-HTTP equivalent.\n"
+    "    str raw = tls_recv(ssl, 262144);\n"
+    "    if (length(raw) == 0) {\n"
+    "        tls_close(ssl);\n"
+    "        arena_restore(wm);\n"
+    "        return;\n"
+    "    }\n"
+    "    json req = http_parse_request(raw);\n"
+    "\n"
+    "    _request = req;\n"
+    "    str method = req[\"method\"];\n"
+    "    str path = req[\"path\"];\n"
+    "    if (length(env(\"TULPAR_HTTP_QUIET\")) == 0) {\n"
+    "        print(\"  TLS \" + method + \" \" + path);\n"
+    "    }\n"
+    "\n"
+    "    // Same OPTIONS preflight short-circuit as plain wings — browsers\n"
+    "    // hitting an HTTPS endpoint with non-simple headers still need a\n"
+    "    // 204 + CORS-header reply before the real request.\n"
+    "    bool is_options = (method == \"OPTIONS\");\n"
+    "    if (is_options) {\n"
+    "        _request[\"params\"] = {};\n"
+    "        _wings_requests_total = _wings_requests_total + 1;\n"
+    "        _wings_requests_2xx = _wings_requests_2xx + 1;\n"
+    "        // Force `Connection: close` (5th arg = 0) since we aren't\n"
+    "        // doing keep-alive on the TLS path yet.\n"
+    "        str preflight = http_create_response(\n"
+    "            204, \"text/plain; charset=utf-8\", \"\", _default_headers, 0);\n"
+    "        tls_send(ssl, preflight);\n"
+    "        tls_close(ssl);\n"
+    "        arena_restore(wm);\n"
+    "        return;\n"
+    "    }\n"
+    "\n"
+    "    json route_match = _find_route_with_params(method, path);\n"
+    "    int route_idx = route_match[\"index\"];\n"
+    "    bool is_head = false;\n"
+    "    if (route_idx < 0 && method == \"HEAD\") {\n"
+    "        route_match = _find_route_with_params(\"GET\", path);\n"
+    "        route_idx = route_match[\"index\"];\n"
+    "        is_head = true;\n"
+    "    }\n"
+    "    _request[\"params\"] = route_match[\"params\"];\n"
+    "\n"
+    "    json result = {};\n"
+    "    bool found = false;\n"
+    "    if (route_idx >= 0) {\n"
+    "        json route = _routes[route_idx];\n"
+    "        result = call(route[\"handler\"]);\n"
+    "        found = true;\n"
+    "    }\n"
+    "    _wings_requests_total = _wings_requests_total + 1;\n"
+    "    if (found) {\n"
+    "        int eff_status = _wings_status_or(result, 200);\n"
+    "        if (eff_status >= 500) {\n"
+    "            _wings_requests_5xx = _wings_requests_5xx + 1;\n"
+    "        } else if (eff_status >= 400) {\n"
+    "            _wings_requests_4xx = _wings_requests_4xx + 1;\n"
+    "        } else {\n"
+    "            _wings_requests_2xx = _wings_requests_2xx + 1;\n"
+    "        }\n"
+    "    } else {\n"
+    "        _wings_requests_4xx = _wings_requests_4xx + 1;\n"
+    "    }\n"
+    "\n"
+    "    str response = \"\";\n"
+    "    if (found) {\n"
+    "        // 5th arg = 0: Connection: close. TLS keep-alive will land in\n"
+    "        // the same follow-up that adds partial-read state machines for\n"
+    "        // the plain wings path.\n"
+    "        response = _wings_build_response(result, 0);\n"
+    "    } else {\n"
+    "        response = _wings_build_404(path, 0);\n"
+    "    }\n"
+    "    if (is_head) {\n"
+    "        response = _wings_strip_response_body(response);\n"
+    "    }\n"
+    "    tls_send(ssl, response);\n"
+    "    tls_close(ssl);\n"
+    "    arena_restore(wm);\n"
+    "}\n"
+    "\n"
+    "// Public entry point. Starts a TLS listener on `port` using the cert\n"
+    "// and key files at the given paths. Blocks the calling thread on the\n"
+    "// accept loop; spawns one worker thread per accepted connection.\n"
+    "//\n"
+    "// The SSL_CTX is created once and shared across every connection this\n"
+    "// listener serves — cert/key files are read at startup, not per\n"
+    "// request. A failure to read the cert/key (wrong path, mismatched\n"
+    "// pair, malformed PEM) prints to stderr and aborts the listener so\n"
+    "// you don't end up running an \"open\" server by accident.\n"
+    "func wings_tls(int port, str cert_path, str key_path) {\n"
+    "    if (_find_route(\"GET\", \"/healthz\") < 0) {\n"
+    "        get(\"/healthz\", \"_wings_healthz\");\n"
+    "    }\n"
+    "    if (_find_route(\"GET\", \"/metrics\") < 0) {\n"
+    "        get(\"/metrics\", \"_wings_metrics\");\n"
+    "    }\n"
+    "    _wings_apply_env_config();\n"
+    "    _wings_started_at = timestamp();\n"
+    "\n"
+    "    int ctx = tls_init(cert_path, key_path);\n"
+    "    if (ctx == 0) {\n"
+    "        print(\"ERROR: TLS init failed — check cert/key paths and that\");\n"
+    "        print(\"       Tulpar was built with OpenSSL.\");\n"
+    "        return;\n"
+    "    }\n"
+    "\n"
+    "    print(\"\");\n"
+    "    print(\"  ╔═══════════════════════════════════╗\");\n"
+    "    print(\"  ║       Tulpar Wings v2.4 (TLS)     ║\");\n"
+    "    print(\"  ║    Give your API wings! 🪶        ║\");\n"
+    "    print(\"  ╚═══════════════════════════════════╝\");\n"
+    "    print(\"\");\n"
+    "    print(\"  Routes:\");\n"
+    "    for (int i = 0; i < length(_routes); i++) {\n"
+    "        json r = _routes[i];\n"
+    "        print(\"    \" + r[\"method\"] + \" \" + r[\"path\"] + \" -> \" + r[\"handler\"] + \"()\");\n"
+    "    }\n"
+    "    print(\"\");\n"
+    "    print(\"  Server: https://127.0.0.1:\" + toString(port) + \" (TLS)\");\n"
+    "    print(\"  Press Ctrl+C to stop\");\n"
+    "    print(\"\");\n"
+    "\n"
+    "    int server = socket_server(\"127.0.0.1\", port);\n"
+    "    if (server < 0) {\n"
+    "        print(\"ERROR: Failed to start server!\");\n"
+    "        tls_ctx_free(ctx);\n"
+    "        return;\n"
+    "    }\n"
+    "\n"
+    "    while (true) {\n"
+    "        int client = socket_accept(server);\n"
+    "        if (client < 0) {\n"
+    "            continue;\n"
+    "        }\n"
+    "        // SSL_accept happens here, on the accept thread, so a slow\n"
+    "        // handshake doesn't tie up the worker count. Failed handshake\n"
+    "        // closes the underlying fd inside tls_accept.\n"
+    "        int ssl = tls_accept(ctx, client);\n"
+    "        if (ssl == 0) {\n"
+    "            continue;\n"
+    "        }\n"
+    "        json sb = ssl;\n"
+    "        int t = thread_create(_wings_tls_serve, sb);\n"
+    "        thread_detach(t);\n"
+    "    }\n"
+    "}\n"
+    "";
+
+// ========================================
+// lib/tame.tpr
+// ========================================
+static const char *EMBEDDED_TAME =
+"// ============================================\n"
+    "// Tulpar Tame — 2D Oyun Kütüphanesi\n"
+    "// \"Tulpar'ın T'si, Game'in ame'si.\" 🎮\n"
+    "//\n"
+    "// Native katman: aot_tm_* builtin'leri (runtime/tame_bindings.cpp +\n"
+    "// runtime/tame_impl.c — vendored raylib, lib/raylib/). Bu dosya o katmanın\n"
+    "// üstündeki ergonomik sarmalayıcıdır: kısa isimler, adlı renkler, ufak\n"
+    "// oyun yardımcıları. `import \"tame\"` eden program otomatik olarak\n"
+    "// libtulpar_tame.a ile linklenir; tame kullanmayan binary'ler pencere/GL\n"
+    "// bağımlılığı almaz.\n"
+    "//\n"
+    "// Kullanım:\n"
+    "//   import \"tame\";\n"
+    "//   window(800, 450, \"Oyunum\");\n"
+    "//   while (running()) {\n"
+    "//       frame_begin();\n"
+    "//       clear(DARKBLUE);\n"
+    "//       rect(100, 100, 50, 50, GOLD);\n"
+    "//       text(\"merhaba!\", 20, 20, 24, WHITE);\n"
+    "//       frame_end();\n"
+    "//   }\n"
+    "//   close_window();\n"
+    "//\n"
+    "// Renkler paketlenmiş int'tir: 0xRRGGBBAA. rgb(r,g,b) / rgba(r,g,b,a) ile\n"
+    "// üret ya da aşağıdaki adlı renkleri (raylib paleti) kullan.\n"
+    "// Koordinatlar int veya float olabilir — native katman ikisini de kabul eder.\n"
+    "// ============================================\n"
+    "\n"
+    "// ---- Pencere / döngü -------------------------------------------------------\n"
+    "\n"
+    "// Oyun penceresini açar (varsayılan hedef 60 FPS). Görüntü ortamı yoksa\n"
+    "// false döner ve stderr'e açıklama basılır.\n"
+    "func window(w, h, title): bool { return tm_window(w, h, title); }\n"
+    "\n"
+    "// Ana oyun döngüsünün koşulu: pencere açık ve kapatılmak istenmemiş.\n"
+    "// (Varsayılan olarak ESC veya pencere kapatma düğmesi döngüyü bitirir.)\n"
+    "func running(): bool { return tm_running(); }\n"
+    "\n"
+    "// Pencereyi kapatır (döngüden sonra çağır).\n"
+    "func close_window() { tm_close(); }\n"
+    "\n"
+    "// Hedef kare hızını değiştirir (varsayılan 60).\n"
+    "func set_fps(n) { tm_set_fps(n); }\n"
+    "\n"
+    "// Kare çizimini başlat / bitir. frame_end() ekrana basar ve FPS bekler.\n"
+    "func frame_begin() { tm_begin(); }\n"
+    "func frame_end() { tm_end(); }\n"
+    "\n"
+    "func get_fps(): int { return tm_fps(); }\n"
+    "\n"
+    "// Son karenin süresi (saniye) — kare-bağımsız hareket için hızla çarp:\n"
+    "//   x = x + 120.0 * frame_time();\n"
+    "func frame_time(): float { return tm_frame_time(); }\n"
+    "\n"
+    "// Pencere açıldığından beri geçen süre (saniye).\n"
+    "func elapsed(): float { return tm_time(); }\n"
+    "\n"
+    "func screen_width(): int { return tm_width(); }\n"
+    "func screen_height(): int { return tm_height(); }\n"
+    "\n"
+    "// Görünür ekranın DÜNYA koordinatındaki kenarları. Masaüstü/web'de 0..w / 0..h;\n"
+    "// Android'de oyun dünyası ekrana ortalandığı için sol/üst NEGATİF, sağ/alt\n"
+    "// dünyadan BÜYÜK olabilir. Dokunmatik butonları gerçek ekran kenarına\n"
+    "// demirlemek için kullan (arcade bunu otomatik yapar).\n"
+    "func view_left(): float    { return tm_view_left(); }\n"
+    "func ekran_sol(): float    { return tm_view_left(); }\n"
+    "func view_right(): float   { return tm_view_right(); }\n"
+    "func ekran_sag(): float    { return tm_view_right(); }\n"
+    "func view_top(): float     { return tm_view_top(); }\n"
+    "func ekran_ust(): float    { return tm_view_top(); }\n"
+    "func view_bottom(): float  { return tm_view_bottom(); }\n"
+    "func ekran_alt(): float    { return tm_view_bottom(); }\n"
+    "\n"
+    "// İvmeölçer (telefonu eğerek kontrol). m/s^2; Android'de gerçek sensör,\n"
+    "// masaüstü/web'de 0. accel_available() ile sensör var mı öğren.\n"
+    "func accel_x(): float      { return tm_accel_x(); }\n"
+    "func egim_x(): float       { return tm_accel_x(); }\n"
+    "func accel_y(): float      { return tm_accel_y(); }\n"
+    "func egim_y(): float       { return tm_accel_y(); }\n"
+    "func accel_z(): float      { return tm_accel_z(); }\n"
+    "func egim_z(): float       { return tm_accel_z(); }\n"
+    "func accel_available(): bool { return tm_accel_available(); }\n"
+    "func egim_var(): bool      { return tm_accel_available(); }\n"
+    "\n"
+    "// Uygulama önde/odakta mı (arka plana atılınca false).\n"
+    "func is_active(): bool     { return tm_active(); }\n"
+    "func aktif_mi(): bool      { return tm_active(); }\n"
+    "\n"
+    "// Dosyasız ses efekti: freq Hz sinüs, ms milisaniye. Kısa oyun sesleri için.\n"
+    "func beep(freq, ms)        { tm_beep(freq, ms); }\n"
+    "func bip(freq, ms)         { tm_beep(freq, ms); }\n"
+    "// tone/ton: ses-seviyeli beep (vol 0..1) — kısık arka plan müziği notaları için.\n"
+    "func tone(freq, ms, vol)   { tm_tone(freq, ms, vol); }\n"
+    "func ton(freq, ms, vol)    { tm_tone(freq, ms, vol); }\n"
+    "\n"
+    "// ---- Çizim -----------------------------------------------------------------\n"
+    "// Hepsi frame_begin() ile frame_end() arasında çağrılır.\n"
+    "\n"
+    "func clear(color) { tm_clear(color); }\n"
+    "func rect(x, y, w, h, color) { tm_rect(x, y, w, h, color); }\n"
+    "func rect_lines(x, y, w, h, color) { tm_rect_lines(x, y, w, h, color); }\n"
+    "func circle(x, y, radius, color) { tm_circle(x, y, radius, color); }\n"
+    "func line(x1, y1, x2, y2, color) { tm_line(x1, y1, x2, y2, color); }\n"
+    "func pixel(x, y, color) { tm_pixel(x, y, color); }\n"
+    "func text(s, x, y, size, color) { tm_text(s, x, y, size, color); }\n"
+    "\n"
+    "// ---- Girdi -----------------------------------------------------------------\n"
+    "// Tuş adları: \"A\"..\"Z\", \"0\"..\"9\", \"SPACE\", \"ENTER\", \"ESC\", \"TAB\",\n"
+    "// \"BACKSPACE\", \"DELETE\", \"LEFT\", \"RIGHT\", \"UP\", \"DOWN\", \"SHIFT\", \"CTRL\",\n"
+    "// \"ALT\", \"HOME\", \"END\", \"PAGEUP\", \"PAGEDOWN\", \"F1\"..\"F12\" (büyük/küçük fark etmez).\n"
+    "\n"
+    "func key_down(k): bool { return tm_key_down(k); }       // şu an basılı mı\n"
+    "func key_pressed(k): bool { return tm_key_pressed(k); } // bu karede basıldı (tek tetik)\n"
+    "func key_released(k): bool { return tm_key_released(k); }\n"
+    "\n"
+    "// Fare düğmeleri: 0 = sol, 1 = sağ, 2 = orta.\n"
+    "func mouse_x(): int { return tm_mouse_x(); }\n"
+    "func mouse_y(): int { return tm_mouse_y(); }\n"
+    "func mouse_down(b): bool { return tm_mouse_down(b); }\n"
+    "func mouse_pressed(b): bool { return tm_mouse_pressed(b); }\n"
+    "func mouse_wheel(): float { return tm_mouse_wheel(); }\n"
+    "\n"
+    "// Fare DELTA'sı — bu karede ne kadar hareket etti. Bakış (mouse-look) için\n"
+    "// mouse_x/mouse_y farkını kendin hesaplama: imleç kilitliyken konum sabittir,\n"
+    "// hareket yalnız buradan okunur.\n"
+    "func mouse_dx(): float { return tm_mouse_dx(); }\n"
+    "func fare_dx(): float { return tm_mouse_dx(); }\n"
+    "func mouse_dy(): float { return tm_mouse_dy(); }\n"
+    "func fare_dy(): float { return tm_mouse_dy(); }\n"
+    "\n"
+    "// İmleci kilitle (gizle + pencereye hapset) — FPS bakışı için. Web'de\n"
+    "// tarayıcının Pointer Lock'ı; kullanıcı jesti (tıklama) sonrası verilir.\n"
+    "func cursor_lock(on) { tm_cursor_lock(on); }\n"
+    "func imlec_kilitle(on) { tm_cursor_lock(on); }\n"
+    "func cursor_locked(): bool { return tm_cursor_locked(); }\n"
+    "func imlec_kilitli(): bool { return tm_cursor_locked(); }\n"
+    "\n"
+    "// Dokunma (mobil). Çok parmak desteklenir; parmak index'i 0'dan başlar.\n"
+    "// Masaüstünde raylib tek dokunuşu fareye maplediği için mouse_* de çalışır,\n"
+    "// ama mobilde ASIL girdi budur. touched()/dokunuldu(): en az bir parmak var mı.\n"
+    "func touch_count(): int { return tm_touch_count(); }\n"
+    "func dokunma_sayisi(): int { return tm_touch_count(); }\n"
+    "func touch_x(i): int { return tm_touch_x(i); }\n"
+    "func dokunma_x(i): int { return tm_touch_x(i); }\n"
+    "func touch_y(i): int { return tm_touch_y(i); }\n"
+    "func dokunma_y(i): int { return tm_touch_y(i); }\n"
+    "func touched(): bool { return tm_touch_count() > 0; }\n"
+    "func dokunuldu(): bool { return tm_touch_count() > 0; }\n"
+    "\n"
+    "// Gamepad (id 0'dan başlar). Butonlar adla: \"A\"/\"B\"/\"X\"/\"Y\" (Xbox) veya\n"
+    "// \"CROSS\"/\"CIRCLE\"/\"SQUARE\"/\"TRIANGLE\" (PS), \"UP\"/\"DOWN\"/\"LEFT\"/\"RIGHT\",\n"
+    "// \"LB\"/\"RB\" (\"L1\"/\"R1\"), \"LT\"/\"RT\" (\"L2\"/\"R2\"), \"START\"/\"SELECT\"/\"GUIDE\",\n"
+    "// \"L3\"/\"R3\". Eksenler: \"LX\"/\"LY\"/\"RX\"/\"RY\" (-1..1), \"LT\"/\"RT\" (tetik).\n"
+    "func gamepad_available(id): bool { return tm_gamepad_available(id); }\n"
+    "func gamepad_name(id): str { return tm_gamepad_name(id); }\n"
+    "func gamepad_down(id, btn): bool { return tm_gamepad_down(id, btn); }\n"
+    "func gamepad_pressed(id, btn): bool { return tm_gamepad_pressed(id, btn); }\n"
+    "func gamepad_axis(id, axis): float { return tm_gamepad_axis(id, axis); }\n"
+    "\n"
+    "// ---- Sprite / texture (Faz 3) ----------------------------------------------\n"
+    "// Kaynaklar int handle'dır (-1 = yükleme başarısız). window() sonrası yükle;\n"
+    "// close_window() canlı kalan her şeyi kendisi bırakır.\n"
+    "\n"
+    "func load_texture(path): int { return tm_load_texture(path); }\n"
+    "func draw_texture(tex, x, y) { tm_draw_texture(tex, x, y); }\n"
+    "// scale: 1.0 = orijinal boyut; rotation: derece (saat yönü).\n"
+    "func draw_texture_ex(tex, x, y, scale, rotation) { tm_draw_texture_ex(tex, x, y, scale, rotation); }\n"
+    "func texture_width(tex): int { return tm_texture_width(tex); }\n"
+    "func texture_height(tex): int { return tm_texture_height(tex); }\n"
+    "func unload_texture(tex) { tm_unload_texture(tex); }\n"
+    "\n"
+    "// TTF/OTF font (boyut yüklemede sabitlenir; en iyi sonuç için çizim boyutuyla\n"
+    "// aynı tut).\n"
+    "func load_font(path, size): int { return tm_load_font(path, size); }\n"
+    "func text_font(f, s, x, y, size, color) { tm_text_font(f, s, x, y, size, color); }\n"
+    "// Varsayılan fontla yazının piksel genişliği — ortalamak için:\n"
+    "//   text(s, (screen_width() - measure_text(s, 24)) / 2, y, 24, WHITE);\n"
+    "func measure_text(s, size): int { return tm_measure_text(s, size); }\n"
+    "\n"
+    "// ---- Ses / müzik (Faz 4) -----------------------------------------------------\n"
+    "// Ses aygıtı ilk load_sound/load_music'te otomatik açılır. Çalan müzik\n"
+    "// stream'leri frame_end() içinde otomatik beslenir — update çağrısı gerekmez.\n"
+    "\n"
+    "func load_sound(path): int { return tm_load_sound(path); }\n"
+    "func play_sound(s) { tm_play_sound(s); }\n"
+    "func stop_sound(s) { tm_stop_sound(s); }\n"
+    "func sound_volume(s, v) { tm_sound_volume(s, v); }\n"
+    "\n"
+    "func load_music(path): int { return tm_load_music(path); }\n"
+    "func play_music(m) { tm_play_music(m); }\n"
+    "func stop_music(m) { tm_stop_music(m); }\n"
+    "func music_volume(m, v) { tm_music_volume(m, v); }\n"
+    "\n"
+    "// ---- Kalıcı kayıt + titreşim (mobil-dostu) ----------------------------------\n"
+    "// save/load: Android'de uygulamanın internal storage'ına, masaüstünde çalışma\n"
+    "// dizinine yazar/okur — AYNI oyun kodu her platformda kalıcı kayıt alır.\n"
+    "// İçerik düz metin: skor için toString/toInt yeterli. Dosya yoksa \"\" döner.\n"
+    "func save_data(name, text): bool { return tm_save_data(name, text); }\n"
+    "func kayit_yaz(name, text): bool { return tm_save_data(name, text); }\n"
+    "func load_data(name): str { return tm_load_data(name); }\n"
+    "func kayit_oku(name): str { return tm_load_data(name); }\n"
+    "// Titreşim: Android'de cihazı ms milisaniye titretir; masaüstü/web no-op.\n"
+    "func vibrate(ms) { tm_vibrate(ms); }\n"
+    "func titret(ms)  { tm_vibrate(ms); }\n"
+    "\n"
+    "// ---- Ek çizim / araç ----------------------------------------------------------\n"
+    "\n"
+    "// Dolu üçgen — köşe sırası önemsiz (sarım otomatik düzeltilir).\n"
+    "func triangle(x1, y1, x2, y2, x3, y3, color) { tm_triangle(x1, y1, x2, y2, x3, y3, color); }\n"
+    "\n"
+    "// Pencerenin anlık görüntüsünü PNG olarak kaydeder. Not: raylib dosyayı\n"
+    "// her zaman ÇALIŞMA DİZİNİNE yazar; path'teki dizin kısmı kırpılır\n"
+    "// (yalnız dosya adı kullanılır).\n"
+    "func screenshot(path) { tm_screenshot(path); }\n"
+    "\n"
+    "// ---- 3D (Faz 0) ---------------------------------------------------------------\n"
+    "// Tek küresel Camera3D + temel primitifler. Kare akışı:\n"
+    "//   window(...); ... begin(); clear(BLACK);\n"
+    "//   camera3d(0,4,8, 0,0,0, 45);   // göz, hedef, FOV\n"
+    "//   space_begin();                // 3D moda gir\n"
+    "//     grid(10, 1);                // referans ızgarası\n"
+    "//     cube(0,0,0, 2,2,2, GOLD);   // dolu küp\n"
+    "//     cube_wires(0,0,0, 2,2,2, BLACK);\n"
+    "//   space_end();                  // 3D modu bitir → sonrası 2D HUD\n"
+    "//   text(\"Skor\", 10, 10, 20, WHITE);\n"
+    "//   end();\n"
+    "\n"
+    "// Kamerayı konumla: göz (px,py,pz), bakış hedefi (tx,ty,tz), dikey FOV (derece).\n"
+    "func camera3d(px, py, pz, tx, ty, tz, fov) { tm3_camera(px, py, pz, tx, ty, tz, fov); }\n"
+    "func kamera3d(px, py, pz, tx, ty, tz, fov) { tm3_camera(px, py, pz, tx, ty, tz, fov); }\n"
+    "\n"
+    "// 3D çizim modunu başlat/bitir (kamerayı bağlar / çözer).\n"
+    "func space_begin() { tm3_begin(); }\n"
+    "func uzay_basla()  { tm3_begin(); }\n"
+    "func space_end()   { tm3_end(); }\n"
+    "func uzay_bitir()  { tm3_end(); }\n"
+    "\n"
+    "// Merkezi (x,y,z), boyutu (w,h,d) olan dolu küp/kutu.\n"
+    "func cube(x, y, z, w, h, d, color) { tm3_cube(x, y, z, w, h, d, color); }\n"
+    "func kup(x, y, z, w, h, d, color)  { tm3_cube(x, y, z, w, h, d, color); }\n"
+    "\n"
+    "// Tel-çerçeve küp/kutu.\n"
+    "func cube_wires(x, y, z, w, h, d, color) { tm3_cube_wires(x, y, z, w, h, d, color); }\n"
+    "func kup_tel(x, y, z, w, h, d, color)    { tm3_cube_wires(x, y, z, w, h, d, color); }\n"
+    "\n"
+    "// XZ düzleminde referans ızgarası.\n"
+    "func grid(slices, spacing)   { tm3_grid(slices, spacing); }\n"
+    "func izgara(slices, spacing) { tm3_grid(slices, spacing); }\n"
+    "\n"
+    "// -- Faz 1 primitifleri --\n"
+    "// Dolu küre (merkez x,y,z; yarıçap r).\n"
+    "func sphere(x, y, z, r, color) { tm3_sphere(x, y, z, r, color); }\n"
+    "func kure(x, y, z, r, color)   { tm3_sphere(x, y, z, r, color); }\n"
+    "\n"
+    "// Tel-çerçeve küre (seg = halka/dilim sayısı, ör. 12).\n"
+    "func sphere_wires(x, y, z, r, seg, color) { tm3_sphere_wires(x, y, z, r, seg, color); }\n"
+    "func kure_tel(x, y, z, r, seg, color)     { tm3_sphere_wires(x, y, z, r, seg, color); }\n"
+    "\n"
+    "// Taban (x,y,z)'de duran dikey silindir (yarıçap r, yükseklik h).\n"
+    "func cylinder(x, y, z, r, h, color) { tm3_cylinder(x, y, z, r, h, color); }\n"
+    "func silindir(x, y, z, r, h, color) { tm3_cylinder(x, y, z, r, h, color); }\n"
+    "\n"
+    "// XZ düzleminde dolu düzlem/zemin (merkez x,y,z; boyut sx×sz).\n"
+    "func plane(x, y, z, sx, sz, color)  { tm3_plane(x, y, z, sx, sz, color); }\n"
+    "func duzlem(x, y, z, sx, sz, color) { tm3_plane(x, y, z, sx, sz, color); }\n"
+    "\n"
+    "// 3D uzayda çizgi.\n"
+    "func line3d(x1, y1, z1, x2, y2, z2, color) { tm3_line(x1, y1, z1, x2, y2, z2, color); }\n"
+    "func cizgi3d(x1, y1, z1, x2, y2, z2, color) { tm3_line(x1, y1, z1, x2, y2, z2, color); }\n"
+    "\n"
+    "// -- Faz 1 raycast (fare/dokunuş ile tıklama-seçim) --\n"
+    "// Ekran (mx,my)'den kamera ışını ile kutuya/küreye tıklama testi.\n"
+    "// Vurursa çarpışma mesafesini (>=0), ıskalarsa -1 döner. Oyun kodu\n"
+    "// \"en küçük pozitif mesafe = tıklanan nesne\" ile seçim yapar.\n"
+    "func pick_box(mx, my, bx, by, bz, bw, bh, bd): float { return tm3_pick_box(mx, my, bx, by, bz, bw, bh, bd); }\n"
+    "func sec_kutu(mx, my, bx, by, bz, bw, bh, bd): float { return tm3_pick_box(mx, my, bx, by, bz, bw, bh, bd); }\n"
+    "func pick_sphere(mx, my, cx, cy, cz, r): float { return tm3_pick_sphere(mx, my, cx, cy, cz, r); }\n"
+    "func sec_kure(mx, my, cx, cy, cz, r): float    { return tm3_pick_sphere(mx, my, cx, cy, cz, r); }\n"
+    "\n"
+    "// -- Faz 1 vec3 skaler yardımcıları (saf Tulpar) --\n"
+    "// Vektör uzunluğu ve iki nokta arası mesafe (Tulpar'da struct dönüşü yok,\n"
+    "// bu yüzden bileşenler ayrı skaler geçer).\n"
+    "func vec3_len(x, y, z): float { return sqrt(x * x + y * y + z * z); }\n"
+    "func vec3_dist(ax, ay, az, bx, by, bz): float {\n"
+    "    float dx = ax - bx;\n"
+    "    float dy = ay - by;\n"
+    "    float dz = az - bz;\n"
+    "    return sqrt(dx * dx + dy * dy + dz * dz);\n"
+    "}\n"
+    "\n"
+    "// -- Faz 2: model yükleme / üretme / çizim / animasyon --\n"
+    "// Dosyadan model yükle (OBJ/GLTF/GLB/IQM) — gömülü animasyonlar da yüklenir.\n"
+    "func load_model(path): int  { return tm3_load_model(path); }\n"
+    "func model_yukle(path): int { return tm3_load_model(path); }\n"
+    "\n"
+    "// Prosedürel mesh üreteçleri (dosyasız) → model handle. GenMesh* örtüleri.\n"
+    "func gen_cube(w, h, d): int          { return tm3_gen(0, w, h, d, 0); }\n"
+    "func gen_kup(w, h, d): int           { return tm3_gen(0, w, h, d, 0); }\n"
+    "func gen_sphere(r, rings, slices): int { return tm3_gen(1, r, rings, slices, 0); }\n"
+    "func gen_kure(r, rings, slices): int   { return tm3_gen(1, r, rings, slices, 0); }\n"
+    "func gen_plane(w, len, rx, rz): int  { return tm3_gen(2, w, len, rx, rz); }\n"
+    "func gen_duzlem(w, len, rx, rz): int { return tm3_gen(2, w, len, rx, rz); }\n"
+    "func gen_cylinder(r, h, slices): int { return tm3_gen(3, r, h, slices, 0); }\n"
+    "func gen_silindir(r, h, slices): int { return tm3_gen(3, r, h, slices, 0); }\n"
+    "func gen_torus(radius, size, seg, sides): int { return tm3_gen(4, radius, size, seg, sides); }\n"
+    "func gen_cone(r, h, slices): int     { return tm3_gen(5, r, h, slices, 0); }\n"
+    "func gen_koni(r, h, slices): int     { return tm3_gen(5, r, h, slices, 0); }\n"
+    "func gen_knot(radius, size, seg, sides): int  { return tm3_gen(6, radius, size, seg, sides); }\n"
+    "\n"
+    "// Modeli çiz (dokusu varsa dokulu). tint = renk maskesi (WHITE = dokunun aynısı).\n"
+    "func draw_model(h, x, y, z, scale, tint) { tm3_draw_model(h, x, y, z, scale, tint); }\n"
+    "func model_ciz(h, x, y, z, scale, tint)  { tm3_draw_model(h, x, y, z, scale, tint); }\n"
+    "\n"
+    "// Y ekseni etrafında yaw (derece) döndürerek çiz.\n"
+    "func draw_model_rot(h, x, y, z, yaw, scale, tint) { tm3_draw_model_rot(h, x, y, z, yaw, scale, tint); }\n"
+    "func model_ciz_don(h, x, y, z, yaw, scale, tint)  { tm3_draw_model_rot(h, x, y, z, yaw, scale, tint); }\n"
+    "\n"
+    "// Yüklü dokuyu (load_texture handle'ı) modele bağla.\n"
+    "func model_texture(h, tex) { tm3_model_texture(h, tex); }\n"
+    "func model_doku(h, tex)    { tm3_model_texture(h, tex); }\n"
+    "\n"
+    "// Animasyon: sayı / kare-sayısı / pozu uygula / sil.\n"
+    "func anim_count(h): int         { return tm3_anim_count(h); }\n"
+    "func anim_sayisi(h): int        { return tm3_anim_count(h); }\n"
+    "func anim_frames(h, idx): int   { return tm3_anim_frames(h, idx); }\n"
+    "func anim_kare_sayisi(h, idx): int { return tm3_anim_frames(h, idx); }\n"
+    "func anim_play(h, idx, frame)   { tm3_anim(h, idx, frame); }\n"
+    "func anim_oynat(h, idx, frame)  { tm3_anim(h, idx, frame); }\n"
+    "func unload_model(h) { tm3_unload_model(h); }\n"
+    "func model_sil(h)    { tm3_unload_model(h); }\n"
+    "\n"
+    "// -- Faz 4: ışıklandırma --\n"
+    "// Gömülü Blinn-Phong shader (asset dosyası yok; masaüstü GL3.3 + web/Android\n"
+    "// GLES2 varyantları derleyicinin içinde). Açtığın anda küp/küre/silindir/\n"
+    "// düzlem ve modeller ışık alır — düz renk yerine gölgeli yüzeyler.\n"
+    "//\n"
+    "//   window(800, 450, \"3D\");\n"
+    "//   lights_on();                                  // varsayılan güneş gelir\n"
+    "//   sun(0.0-0.6, 0.0-1.0, 0.0-0.4, WHITE);        // yönlü ışık (YÖN verilir)\n"
+    "//   point_light(1, 3.0, 4.0, 2.0, GOLD);          // slot 1: nokta ışık\n"
+    "//   ambient_light(rgb(40, 44, 60));               // taban aydınlık\n"
+    "//\n"
+    "// En çok 4 ışık (slot 0-3). type: 0 = yönlü (güneş), 1 = nokta.\n"
+    "func lights_on(): bool  { return tm3_lights(1); }\n"
+    "func isik_ac(): bool    { return tm3_lights(1); }\n"
+    "func lights_off() { tm3_lights(0); }\n"
+    "func isik_kapat() { tm3_lights(0); }\n"
+    "\n"
+    "// Yönlü ışık (güneş): (x,y,z) YÖNdür, konum değil. Slot 0'a yazar.\n"
+    "func sun(x, y, z, color)   { tm3_light_set(0, 0, x, y, z, color); }\n"
+    "func gunes(x, y, z, color) { tm3_light_set(0, 0, x, y, z, color); }\n"
+    "\n"
+    "// Nokta ışık: (x,y,z) dünya KONUMU. idx = slot (0-3).\n"
+    "func point_light(idx, x, y, z, color) { tm3_light_set(idx, 1, x, y, z, color); }\n"
+    "func nokta_isik(idx, x, y, z, color)  { tm3_light_set(idx, 1, x, y, z, color); }\n"
+    "\n"
+    "// Yönlü ışığı istediğin slota koymak istersen (sun() slot 0'ı kullanır).\n"
+    "func dir_light(idx, x, y, z, color) { tm3_light_set(idx, 0, x, y, z, color); }\n"
+    "func yonlu_isik(idx, x, y, z, color) { tm3_light_set(idx, 0, x, y, z, color); }\n"
+    "\n"
+    "func light_off(idx) { tm3_light_off(idx); }\n"
+    "func isik_sil(idx)  { tm3_light_off(idx); }\n"
+    "\n"
+    "// Ortam ışığı — hiçbir ışığın vurmadığı yüzeylerin taban rengi.\n"
+    "func ambient_light(color) { tm3_ambient(color); }\n"
+    "func ortam_isik(color)    { tm3_ambient(color); }\n"
+    "\n"
+    "// -- Gölgeler (yönlü ışık / güneş için shadow mapping) --\n"
+    "// lights_on()'dan SONRA çağır. Nesneler zemine gölge düşürür → \"yerde duruyor\"\n"
+    "// hissi. Donanım derinlik dokusu desteklemiyorsa false döner, gölgeler kapalı\n"
+    "// kalır ve ışıklandırma çalışmaya devam eder (sessizce bozulmaz).\n"
+    "//\n"
+    "//   lights_on();\n"
+    "//   sun(0.0-0.6, 0.0-1.0, 0.0-0.4, WHITE);\n"
+    "//   shadows_on();\n"
+    "//   shadow_area(24.0);     // kapsanan alanın yarı-genişliği\n"
+    "//\n"
+    "// NOT: gölge açıkken sahne iki kez çizilir (ışık gözünden + kameradan), yani\n"
+    "// maliyeti vardır. Mobilde ağır gelirse shadow_area'yı küçült veya kapat.\n"
+    "func shadows_on(): bool  { return tm3_shadows(1); }\n"
+    "func golge_ac(): bool    { return tm3_shadows(1); }\n"
+    "func shadows_off() { tm3_shadows(0); }\n"
+    "func golge_kapat() { tm3_shadows(0); }\n"
+    "func shadow_area(a) { tm3_shadow_area(a); }\n"
+    "func golge_alani(a) { tm3_shadow_area(a); }\n"
+    "\n"
+    "// Gölge GERÇEKTEN çalışıyor mu? shadows_on() çağırmış olmak yetmez — donanım\n"
+    "// desteklemiyorsa gölge sessizce kapalı kalır. Oyununda \"Gölge: açık\" yazacaksan\n"
+    "// bunu sor, kendi bayrağını değil.\n"
+    "func shadows_active(): bool { return tm3_shadows_active(); }\n"
+    "func golge_aktif(): bool    { return tm3_shadows_active(); }\n"
+    "\n"
+    "// ---- 3D doku / materyal / gökyüzü ------------------------------------------\n"
+    "//\n"
+    "// Doku bir DURUM'dur: bir kez ayarlarsın, sonraki primitifler onu kullanır.\n"
+    "//\n"
+    "//   int t = load_texture(\"cimen.png\");\n"
+    "//   texture3d(t, 20.0, 20.0);   // zemin boyunca 20x20 döşe\n"
+    "//   plane(0.0, 0.0, 0.0, 60.0, 60.0, WHITE);\n"
+    "//   no_texture3d();             // sonrakiler yine düz renk\n"
+    "//\n"
+    "// Renk (son parametre) dokuyla ÇARPILIR — beyaz ver, doku olduğu gibi çıksın;\n"
+    "// renkli ver, dokuyu boya. Modeller kendi dokularını korur (model_texture).\n"
+    "// Dosyasız damalı doku — zemin/duvar karosu için PNG taşımaya gerek yok.\n"
+    "//   int t = checker(128, 128, 8, rgb(150,158,170), rgb(120,128,142));\n"
+    "func checker(w, h, cells, c1, c2): int { return tm_checker(w, h, cells, c1, c2); }\n"
+    "func damali(w, h, cells, c1, c2): int  { return tm_checker(w, h, cells, c1, c2); }\n"
+    "\n"
+    "func texture3d(t, tu, tv) { tm3_texture(t, tu, tv); }\n"
+    "func doku3d(t, tu, tv)    { tm3_texture(t, tu, tv); }\n"
+    "func no_texture3d() { tm3_texture(0 - 1, 1.0, 1.0); }\n"
+    "func doku3d_kapat() { tm3_texture(0 - 1, 1.0, 1.0); }\n"
+    "\n"
+    "// Parlaklık: shine = specular üssü (büyük = küçük/keskin parlama, \"cilalı\";\n"
+    "// küçük = geniş/yayvan, \"mat\"), spec = parlamanın gücü (0 = tamamen mat).\n"
+    "func material3d(shine, spec) { tm3_material(shine, spec); }\n"
+    "func materyal3d(shine, spec) { tm3_material(shine, spec); }\n"
+    "// Hazır iki uç — çoğu oyunun ihtiyacı bu ikisi.\n"
+    "func matte3d()  { tm3_material(4.0, 0.0); }\n"
+    "func mat3d()    { tm3_material(4.0, 0.0); }\n"
+    "func glossy3d() { tm3_material(48.0, 1.4); }\n"
+    "func parlak3d() { tm3_material(48.0, 1.4); }\n"
+    "\n"
+    "// Gökyüzü: kameraya duyarlı gradyan (yukarı bakınca zenit gelir), asset yok.\n"
+    "//   sky(rgb(74, 130, 210), rgb(190, 214, 238));   // tepe, ufuk\n"
+    "func sky(top, bottom): bool     { return tm3_sky(top, bottom); }\n"
+    "func gokyuzu(top, bottom): bool { return tm3_sky(top, bottom); }\n"
+    "func sky_off()        { tm3_sky_off(); }\n"
+    "func gokyuzu_kapat()  { tm3_sky_off(); }\n"
+    "\n"
+    "// Mesafe sisi — gökyüzü ile zemin arasındaki sert ufuk çizgisini kapatır ve\n"
+    "// derinlik hissi verir. density: 0.02 hafif pus, 0.06 yoğun sis.\n"
+    "//\n"
+    "//   sky(rgb(58,116,200), rgb(196,220,240));\n"
+    "//   fog_sky(0.03);        // sis rengini gökyüzünün UFKUNDAN al (doğrusu bu)\n"
+    "//\n"
+    "// Kendi rengini vermek istersen fog(renk, yogunluk). Sis ışık shader'ında\n"
+    "// hesaplanır, yani lights_off() ile ışığı kapatırsan sis de çizilmez.\n"
+    "func fog(color, density) { tm3_fog(color, density); }\n"
+    "func sis(color, density) { tm3_fog(color, density); }\n"
+    "func fog_sky(density) { tm3_fog(0 - 1, density); }\n"
+    "func sis_gokyuzu(density) { tm3_fog(0 - 1, density); }\n"
+    "func fog_off() { tm3_fog(0 - 1, 0.0); }\n"
+    "func sis_kapat() { tm3_fog(0 - 1, 0.0); }\n"
+    "\n"
+    "// ---- Yönetilen oyun döngüsü (Faz 5) -------------------------------------------\n"
+    "// Wings'in listen() modeli: update/draw fonksiyonlarını verirsin, döngüyü,\n"
+    "// kare zamanlamasını VE kare belleğini tame yönetir — her kare sonunda arena\n"
+    "// checkpoint'e geri sarılır (tek-save-çok-restore deseni), döngü bitince\n"
+    "// checkpoint bırakılır ve pencere kapanır.\n"
+    "//\n"
+    "//   func guncelle() { x = x + 2; }          // oyun mantığı\n"
+    "//   func ciz() { clear(BLACK); rect(x, 100, 50, 50, GOLD); }\n"
+    "//   window(800, 450, \"Oyunum\");\n"
+    "//   run(guncelle, ciz);\n"
+    "//\n"
+    "// KURAL (wings ile aynı): kareler arası yaşayacak oyun durumunu GLOBAL\n"
+    "// değişkenlerde tut — global'e yazılan değer otomatik kalıcılaşır; update\n"
+    "// içindeki yerel string/objeler kare sonunda geri sarılır.\n"
+    "func run(update_fn, draw_fn) {\n"
+    "    var _tame_wm = arena_save();\n"
+    "    while (tm_running()) {\n"
+    "        call(update_fn, 0);\n"
+    "        tm_begin();\n"
+    "        call(draw_fn, 0);\n"
+    "        tm_end();\n"
+    "        arena_restore(_tame_wm);\n"
+    "    }\n"
+    "    arena_drop(_tame_wm);\n"
+    "    tm_close();\n"
+    "}\n"
+    "\n"
+    "// ---- Renkler ---------------------------------------------------------------\n"
+    "\n"
+    "// r,g,b,a ∈ [0,255] → paketlenmiş 0xRRGGBBAA int'i.\n"
+    "func rgb(r, g, b): int { return r * 16777216 + g * 65536 + b * 256 + 255; }\n"
+    "func rgba(r, g, b, a): int { return r * 16777216 + g * 65536 + b * 256 + a; }\n"
+    "\n"
+    "// raylib paleti — önceden paketlenmiş değerler (a=255).\n"
+    "int LIGHTGRAY = 3368601855;  // 200,200,200\n"
+    "int GRAY = 2189591295;       // 130,130,130\n"
+    "int DARKGRAY = 1347440895;   // 80,80,80\n"
+    "int YELLOW = 4260954367;     // 253,249,0\n"
+    "int GOLD = 4291494143;       // 255,203,0\n"
+    "int ORANGE = 4288741631;     // 255,161,0\n"
+    "int PINK = 4285383423;       // 255,109,194\n"
+    "int RED = 3861460991;        // 230,41,55\n"
+    "int MAROON = 3189848063;     // 190,33,55\n"
+    "int GREEN = 14954751;        // 0,228,48\n"
+    "int LIME = 10366975;         // 0,158,47\n"
+    "int DARKGREEN = 7679231;     // 0,117,44\n"
+    "int SKYBLUE = 1723858943;    // 102,191,255\n"
+    "int BLUE = 7991807;          // 0,121,241\n"
+    "int DARKBLUE = 5418239;      // 0,82,172\n"
+    "int PURPLE = 3363504127;     // 200,122,255\n"
+    "int VIOLET = 2268905215;     // 135,60,190\n"
+    "int DARKPURPLE = 1881112319; // 112,31,126\n"
+    "int BEIGE = 3551560703;      // 211,176,131\n"
+    "int BROWN = 2137673727;      // 127,106,79\n"
+    "int DARKBROWN = 1279209471;  // 76,63,47\n"
+    "int WHITE = 4294967295;      // 255,255,255\n"
+    "int BLACK = 255;             // 0,0,0\n"
+    "int MAGENTA = 4278255615;    // 255,0,255\n"
+    "int RAYWHITE = 4126537215;   // 245,245,245\n"
+    "\n"
+    "// ---- Oyun yardımcıları -------------------------------------------------------\n"
+    "\n"
+    "// AABB çakışma testi — iki dikdörtgen kesişiyor mu? (çarpışma tespiti)\n"
+    "func rect_overlap(x1, y1, w1, h1, x2, y2, w2, h2): bool {\n"
+    "    if (x1 + w1 <= x2) { return false; }\n"
+    "    if (x2 + w2 <= x1) { return false; }\n"
+    "    if (y1 + h1 <= y2) { return false; }\n"
+    "    if (y2 + h2 <= y1) { return false; }\n"
+    "    return true;\n"
+    "}\n"
+    "\n"
+    "// Nokta dikdörtgenin içinde mi? (buton/tıklama testi)\n"
+    "func point_in_rect(px, py, x, y, w, h): bool {\n"
+    "    if (px < x) { return false; }\n"
+    "    if (py < y) { return false; }\n"
+    "    if (px >= x + w) { return false; }\n"
+    "    if (py >= y + h) { return false; }\n"
+    "    return true;\n"
+    "}\n"
+    "\n"
+    "// Değeri [lo, hi] aralığına kıstırır.\n"
+    "func clamp(v, lo, hi) {\n"
+    "    if (v < lo) { return lo; }\n"
+    "    if (v > hi) { return hi; }\n"
+    "    return v;\n"
+    "}\n"
+    "";
+
+// ========================================
+// lib/arcade.tpr
+// ========================================
+static const char *EMBEDDED_ARCADE =
+"// ============================================\n"
+    "// Tulpar Arcade — \"Preset\" oyun katmanı  🎮🧩\n"
+    "//\n"
+    "// tame'in üstünde, Unreal-blueprint / blok mantığıyla ÇOK KISA kod yazarak\n"
+    "// oyun yapmayı sağlayan üst-seviye motor. Kullanıcı döngü/çarpışma/fizik/çizim\n"
+    "// yazmaz; hazır \"blokları\" birleştirir:\n"
+    "//\n"
+    "//   import \"arcade\";\n"
+    "//   func kur() {\n"
+    "//       temizle();\n"
+    "//       oyuncu(320, 240, 24, 24, BLUE);      // ok/WASD ile hareket hazır\n"
+    "//       dusman(100, 100, 24, 24, RED);\n"
+    "//   }\n"
+    "//   sahne(640, 480, \"Kac\");\n"
+    "//   baslangicta(kur);\n"
+    "//   carpisinca(TAG_PLAYER, TAG_ENEMY, oyun_bitti);\n"
+    "//   oyna();                                   // döngü + çizim + çarpışma otomatik\n"
+    "//\n"
+    "// Her fonksiyonun hem Türkçe hem İngilizce adı var (alias). İngilizce eşleri:\n"
+    "//   scene / on_start / on_hit / play, player / enemy / item / wall / bullet ...\n"
+    "//\n"
+    "// TASARIM NOTLARI (Tulpar kısıtları — deneyle sabitlendi):\n"
+    "//  * Entity'ler PARALEL DİZİLERde tutulur (dizi elemanına struct geri-yazma\n"
+    "//    çalışmıyor; int/float eleman yazımı çalışıyor). Bir entity = bir index.\n"
+    "//  * TÜM callback'ler 0-ARG'dır (call() ile parametre geçmek segfault ediyor).\n"
+    "//    Callback içinde çarpışan taraflar me()/other() ile, context globallerinden\n"
+    "//    okunur; oyun durumu index'li setter'larla (kill, hiz_ver...) değiştirilir.\n"
+    "//  * Döngülerde while yerine for kullanılır (2+ değişkenli while + builtin çağrı\n"
+    "//    bir codegen bug'ını tetikliyor).  Modülo için mod() (`%` operatörü yok).\n"
+    "// ============================================\n"
+    "\n"
+    "import \"tame\";\n"
+    "\n"
+    "// ---- Sabitler ---------------------------------------------------------------\n"
+    "\n"
+    "// Hareket presetleri (entity başına _emove)\n"
+    "int MV_NONE     = 0;   // hareketsiz — kullanıcı on_frame içinde sürer\n"
+    "int MV_TOPDOWN  = 1;   // ok tuşları / WASD → 8 yön, hız px/sn\n"
+    "int MV_PLATFORM = 2;   // yatay giriş + yerçekimi + zıplama\n"
+    "int MV_VELOCITY = 3;   // sadece kendi hızıyla entegre (mermi/sabit hızlı)\n"
+    "\n"
+    "// Hazır tag'ler — kendi int tag'lerini de verebilirsin.\n"
+    "int TAG_PLAYER = 1;\n"
+    "int TAG_ENEMY  = 2;\n"
+    "int TAG_ITEM   = 3;\n"
+    "int TAG_WALL   = 4;\n"
+    "int TAG_BULLET = 5;\n"
+    "\n"
+    "// Oyun durumu\n"
+    "int _ar_state = 0;    // 0 = oynanıyor, 1 = oyun bitti, 2 = kazandın (R ile yeniden)\n"
+    "bool _ar_standalone = false;  // play() = true (tek oyun) / launcher = false; oyun-bitti \"Ana Menu\" vs \"Cikis\" etiketi\n"
+    "\n"
+    "// ---- Bölümler (level) -------------------------------------------------------\n"
+    "//\n"
+    "// Hiç `bolum()` kaydedilmemişse motor bugünkü tek-sahne davranışını korur\n"
+    "// (_has_levels false → HUD göstergesi yok, KAZANDIN state'i hiç oluşmaz).\n"
+    "array _levels = [];        // bölüm kurulum fonksiyonları (0-arg), index = bölüm-1\n"
+    "int _level_n = 0;          // kayıtlı en yüksek bölüm numarası\n"
+    "int _cur_level = 1;        // şu anki bölüm (1-tabanlı)\n"
+    "bool _has_levels = false;\n"
+    "float _banner_t = 0.0;     // \"Bölüm N\" afişi için kalan süre (sn)\n"
+    "int _lvl_pending = 0;      // 1 = bölüm geçişi bekliyor (bkz. bolum_gec notu)\n"
+    "\n"
+    "// ---- Entity paralel dizileri ------------------------------------------------\n"
+    "array _ex = [];      // konum x (float)\n"
+    "array _ey = [];      // konum y (float)\n"
+    "array _ew = [];      // genişlik\n"
+    "array _eh = [];      // yükseklik\n"
+    "array _evx = [];     // hız x (px/sn)\n"
+    "array _evy = [];     // hız y (px/sn)\n"
+    "array _etag = [];    // tag (int)\n"
+    "array _ecolor = [];  // renk (paketli int) — sprite yoksa dikdörtgen bu renkte\n"
+    "array _esprite = []; // texture handle (-1 = yok)\n"
+    "array _emove = [];   // hareket preseti\n"
+    "array _espeed = [];  // topdown/platform taban hız (px/sn)\n"
+    "array _ealive = [];  // 1 = canlı\n"
+    "array _eground = []; // 1 = platformer'da zeminde\n"
+    "array _egen = [];    // slot üretim sayacı (bayat handle tespiti — aşağıya bak)\n"
+    "int _n = 0;          // AYRILMIŞ slot sayısı (ölüler dahil; canlı sayısı değil)\n"
+    "\n"
+    "// ---- Slot geri kazanımı (boş-slot yığını) ----------------------------------\n"
+    "//\n"
+    "// Ölen entity'nin slot'u geri kullanılır; aksi halde sürekli mermi/düşman üreten\n"
+    "// bir oyunda paralel diziler sınırsız büyürdü.\n"
+    "//\n"
+    "// Tuzak: slot'u çıplak index olarak geri vermek, ölmüş bir entity'nin id'sini\n"
+    "// elinde tutan kodun slot yeniden kullanılınca SESSİZCE başka bir entity'yi\n"
+    "// oynatmasına yol açar. Bu yüzden dışarıya verilen id bir **handle**'dır:\n"
+    "//\n"
+    "//     handle = _egen[slot] * _ID_STRIDE + slot\n"
+    "//\n"
+    "// Öldürmede `_egen[slot]` artar → o slot'a ait tüm eski handle'lar anında\n"
+    "// bayatlar. Bayat handle ile yapılan her çağrı sessizce yok sayılır ve\n"
+    "// `yasiyor(h)` dürüstçe false döner (aliasing yerine dürüst \"öldü\" cevabı).\n"
+    "array _efree = [];   // boş slot yığını\n"
+    "int _free_n = 0;     // yığın tepesi (_efree kırpılmaz; bu sayaç sınırlar)\n"
+    "int _ID_STRIDE = 1048576;   // 2^20 slot/oyun — pratikte tavan yok\n"
+    "\n"
+    "// Slot -> dışarıya verilen handle.\n"
+    "func _mk_handle(slot): int { return _egen[slot] * _ID_STRIDE + slot; }\n"
+    "\n"
+    "// Handle -> slot; bayat/geçersizse -1. Tüm public id API'si bundan geçer.\n"
+    "func _slot_of(h): int {\n"
+    "    if (h < 0) { return -1; }\n"
+    "    int slot = mod(h, _ID_STRIDE);\n"
+    "    if (slot >= _n) { return -1; }\n"
+    "    int gen = toInt((h - slot) / _ID_STRIDE);\n"
+    "    if (gen != _egen[slot]) { return -1; }   // slot geri kullanılmış → bayat\n"
+    "    return slot;\n"
+    "}\n"
+    "int _ar_i = 0;       // fizik döngüsünün GÜNCEL entity index'i (GLOBAL — bkz.\n"
+    "                     // _ar_apply_movement'taki codegen notu; poison workaround)\n"
+    "\n"
+    "// ---- Dünya / fizik ayarları -------------------------------------------------\n"
+    "float _world_w = 640.0;\n"
+    "float _world_h = 480.0;\n"
+    "float _gravity = 0.0;     // px/sn^2 (0 = kapalı); platformer bunu kullanır\n"
+    "float _jump_v  = 520.0;   // zıplama başlangıç hızı (px/sn, yukarı)\n"
+    "bool  _clamp_world = true; // topdown'da entity'yi dünya sınırında tut\n"
+    "\n"
+    "// ---- Dokunmatik kontrol (mobil) ---------------------------------------------\n"
+    "// Sol tarafta yüzen DİNAMİK analog joystick (yuvarlak içinde yuvarlak) + —yalnızca\n"
+    "// oyun ateş/aksiyon okuyorsa— sağ altta aksiyon butonu çizilir/okunur. İlk\n"
+    "// dokunuşta OTOMATİK açılır; masaüstünde klavye çalışmaya devam eder (girdi =\n"
+    "// klavye VEYA dokunma). raylib touch koordinatlarını oyun-dünyası\n"
+    "// uzayına ölçekler (Android'de doğrulandı), bu yüzden zone'lar _world_w/_world_h\n"
+    "// ile tanımlı. touch_controls(false) ile kapatılabilir / (true) ile zorlanabilir.\n"
+    "bool _ar_touch_ui   = false;  // overlay çiz + oku (ilk dokunuşta açılır)\n"
+    "bool _ar_touch_force = false; // touch_controls(true): dokunma olmadan da aç\n"
+    "bool _ar_act_now    = false;  // aksiyon butonu bu kare basılı mı\n"
+    "bool _ar_act_prev   = false;\n"
+    "bool _ar_act_edge   = false;  // aksiyon butonu bu kare YENİ basıldı (jump/fire)\n"
+    "bool _ar_td_left    = false;  // yön durumları (bu kare; joystick eşiğinden türetilir)\n"
+    "bool _ar_td_right   = false;\n"
+    "bool _ar_td_up      = false;\n"
+    "bool _ar_td_down    = false;\n"
+    "bool _ar_tap_edge   = false;  // herhangi bir parmak 0→>0 (oyun-bitti'de restart)\n"
+    "int  _ar_touch_prevn = 0;\n"
+    "// Aksiyon/ateş butonu SADECE oyun onu okuyorsa (action_*/fire_*/zıplama preset'i)\n"
+    "// çizilir/okunur — böylece ateşi olmayan oyunlarda boş buton görünmez.\n"
+    "bool _ar_wants_action = false;\n"
+    "// Joystick SADECE oyun yön okuyorsa (left/right/up/down VEYA topdown/platform\n"
+    "// preset'i) çizilir — sadece-dokunma oyunlarında (ör. flappy) joystick çıkmaz.\n"
+    "bool _ar_wants_move = false;\n"
+    "// KONTROL ŞEMASI — oyun türüne göre hazır dokunmatik yerleşimler.\n"
+    "// 0=auto (oyunun OKUDUĞU yönlerden çıkar: yalnız sağ/sol → yatay butonlar,\n"
+    "// yalnız yukarı/aşağı → dikey butonlar, iki eksen → joystick, hiç → yok),\n"
+    "// 1=joystick, 2=dpad (4 ok butonu), 3=yatay (◀▶), 4=dikey (▲▼), 5=yok,\n"
+    "// 6=egim (telefonu eğerek — ivmeölçer; sensör yoksa/masaüstünde klavyeye düşer).\n"
+    "// kontrol_semasi(\"dpad\") / control_scheme(\"horizontal\") ile oyun elle seçer.\n"
+    "int  _ar_scheme = 0;\n"
+    "// Eğim (tilt) eşiği (m/s^2) — nötrden bu kadar sapınca yön tetiklenir (~13°).\n"
+    "float _ar_tilt_thr = 2.2;\n"
+    "// Taban çizgisi kalibrasyonu: moda ilk girişte \"nötr tutuş\" yakalanır; yön\n"
+    "// bu NÖTRDEN SAPMAYLA ölçülür → cihaz yönelimi/tutuş açısından bağımsız\n"
+    "// (yerçekimi hangi eksene düşerse düşsün sıfırlanır). _lx_clear/_ar_reset sıfırlar.\n"
+    "bool  _ar_tilt_cal = false;\n"
+    "float _ar_tilt_ax0 = 0.0;\n"
+    "float _ar_tilt_ay0 = 0.0;\n"
+    "bool _ar_rd_l = false;   // bu oyun hangi yönleri okudu (auto şema çıkarımı)\n"
+    "bool _ar_rd_r = false;\n"
+    "bool _ar_rd_u = false;\n"
+    "bool _ar_rd_d = false;\n"
+    "// Modern DİNAMİK analog joystick (yuvarlak içinde yuvarlak, yüzen taban):\n"
+    "// parmak sol bölgeye basınca taban orada belirir, parmağı sürükledikçe topuz\n"
+    "// (knob) onu takip eder; parmak çekilene kadar yön girdisi sürer. Taban parmağı\n"
+    "// halka kadar takip eder (\"trailing\" his). Yön analogtur ([-1..1]); preset'ler\n"
+    "// için eşikle 8-yönlü boolean'a çevrilir.\n"
+    "// Swipe (kaydırma) jesti: parmak inişinden kalkışına vektör; eşik üstü ve\n"
+    "// baskın eksende ise parmak kalktığı KARE yön bildirir. Joystick/butondan\n"
+    "// bağımsız izlenir — jest tabanlı oyunlar (yılan tarzı) kontrol çizdirmeden\n"
+    "// kaydirildi(\"sol\") ile oynanır.\n"
+    "int   _ar_swipe = 0;           // bu kare: 0 yok, 1 sol, 2 sağ, 3 yukarı, 4 aşağı\n"
+    "float _ar_sw_x0 = 0.0;         // parmak iniş noktası\n"
+    "float _ar_sw_y0 = 0.0;\n"
+    "float _ar_sw_x1 = 0.0;         // son bilinen konum\n"
+    "float _ar_sw_y1 = 0.0;\n"
+    "bool  _ar_joy_on = false;      // bu kare joystick etkin (bir parmak sürüyor)\n"
+    "float _ar_joy_bx = 0.0;        // taban merkezi (SABİT — sol-alt köşede demirli)\n"
+    "float _ar_joy_by = 0.0;\n"
+    "float _ar_joy_kx = 0.0;        // topuz (parmak) konumu, halkaya kırpılı\n"
+    "float _ar_joy_ky = 0.0;\n"
+    "float _ar_joy_dx = 0.0;        // analog yön x [-1..1]\n"
+    "float _ar_joy_dy = 0.0;        // analog yön y [-1..1]\n"
+    "\n"
+    "// ---- Çarpışma kuralları (registry) ------------------------------------------\n"
+    "array _ca  = [];   // tag A\n"
+    "array _cb  = [];   // tag B\n"
+    "array _cfn = [];   // 0-arg callback fonksiyonu\n"
+    "\n"
+    "// ---- Callback context'i (me()/other() bunları okur) -------------------------\n"
+    "int _hit_self  = -1;\n"
+    "int _hit_other = -1;\n"
+    "\n"
+    "// ---- Sahne callback'leri ----------------------------------------------------\n"
+    "var _start_fn = 0;   // baslangicta(fn): kurulum + R sonrası yeniden\n"
+    "var _frame_fn = 0;   // her_kare(fn): kare başı kullanıcı mantığı (opsiyonel)\n"
+    "var _draw_fn  = 0;   // ciz_ustune(fn): otomatik çizim üstüne ek çizim\n"
+    "bool _has_start = false;\n"
+    "bool _has_frame = false;\n"
+    "bool _has_draw  = false;\n"
+    "\n"
+    "// ---- Dil / language ---------------------------------------------------------\n"
+    "// Motorun ürettiği HUD metinleri (skor öneki, \"Bölüm n/N\", OYUN BITTI/KAZANDIN,\n"
+    "// yeniden-başla ipucu) bu koda göre TR ya da EN çizilir. Varsayılan: sistem dili\n"
+    "// (`sys_lang()` \"en\" ise İngilizce, aksi halde Türkçe). `dil(\"en\")`/`language(\"tr\")`\n"
+    "// ile açıkça ezilir. `bilgi()/controls()` şeridi oyun tarafından verilir — onun\n"
+    "// dili çağıran oyuna aittir, motor karışmaz.\n"
+    "str _lang = \"\";           // \"\" = henüz çözülmedi (ilk _lang_now'da sys_lang'dan gelir)\n"
+    "\n"
+    "// Etkin dili döndür; ilk çağrıda sistem dilinden çözer (ve önbelleğe alır).\n"
+    "func _lang_now(): str {\n"
+    "    if (_lang == \"\") {\n"
+    "        if (sys_lang() == \"en\") { _lang = \"en\"; }\n"
+    "        else { _lang = \"tr\"; }\n"
+    "    }\n"
+    "    return _lang;\n"
+    "}\n"
+    "func language(code) { if (code == \"en\") { _lang = \"en\"; } else { _lang = \"tr\"; } }\n"
+    "func dil(code)      { language(code); }\n"
+    "\n"
+    "// ---- Ses / haptik ayarları (kalıcı, in-app Ayarlar ekranından değişir) ------\n"
+    "// Motorun ürettiği tüm ses (tm_beep) ve titreşim (tm_vibrate) bu bayraklardan\n"
+    "// geçer; oyuncu Ayarlar'dan kapatırsa sessiz/titremesiz oynar. Ayarlar üç\n"
+    "// küçük dosyada kalıcıdır (en iyi-skor deseniyle aynı: save_data/load_data).\n"
+    "bool _snd_on = true;\n"
+    "bool _hap_on = true;\n"
+    "bool _mus_on = true;       // arka plan müziği (Ayarlar'dan aç-kapa; SFX'ten bağımsız)\n"
+    "bool _fps_on = false;      // FPS sayacı (Ayarlar'dan aç-kapa; varsayılan kapalı)\n"
+    "bool _cfg_loaded = false;\n"
+    "bool  _cfg_reset_armed = false;  // \"Rekorları Sıfırla\" iki-dokunuş onayı bekliyor mu\n"
+    "float _cfg_reset_msg   = 0.0;    // >0 → \"Silindi\" geri bildirimi (frame_time ile azalır)\n"
+    "\n"
+    "func _ar_load_settings() {\n"
+    "    if (_cfg_loaded) { return; }\n"
+    "    _cfg_loaded = true;\n"
+    "    str s = load_data(\"arcade_snd.txt\");  if (s == \"0\") { _snd_on = false; }\n"
+    "    str h = load_data(\"arcade_hap.txt\");  if (h == \"0\") { _hap_on = false; }\n"
+    "    str m = load_data(\"arcade_mus.txt\");  if (m == \"0\") { _mus_on = false; }\n"
+    "    str f = load_data(\"arcade_fps.txt\");  if (f == \"1\") { _fps_on = true; }\n"
+    "    str l = load_data(\"arcade_lang.txt\"); if (l == \"en\") { _lang = \"en\"; } else if (l == \"tr\") { _lang = \"tr\"; }\n"
+    "}\n"
+    "func _ar_save_settings() {\n"
+    "    if (_snd_on) { save_data(\"arcade_snd.txt\", \"1\"); } else { save_data(\"arcade_snd.txt\", \"0\"); }\n"
+    "    if (_hap_on) { save_data(\"arcade_hap.txt\", \"1\"); } else { save_data(\"arcade_hap.txt\", \"0\"); }\n"
+    "    if (_mus_on) { save_data(\"arcade_mus.txt\", \"1\"); } else { save_data(\"arcade_mus.txt\", \"0\"); }\n"
+    "    if (_fps_on) { save_data(\"arcade_fps.txt\", \"1\"); } else { save_data(\"arcade_fps.txt\", \"0\"); }\n"
+    "    save_data(\"arcade_lang.txt\", _lang_now());\n"
+    "}\n"
+    "\n"
+    "// Motor-içi ses/haptik kapıları — merkezî çağrılar bunları kullanır (doğrudan\n"
+    "// tm_beep/tm_vibrate DEĞİL) ki Ayarlar aç-kapa'sı her yere işlesin.\n"
+    "func _snd(freq, ms) { if (_snd_on) { tm_beep(freq, ms); } }\n"
+    "func _hap(ms)       { if (_hap_on) { tm_vibrate(ms); } }\n"
+    "\n"
+    "// Public aç-kapa (oyun kodu da isterse kullanabilir).\n"
+    "func sound_on(on)  { _snd_on = on; }\n"
+    "func ses_ac(on)    { _snd_on = on; }\n"
+    "func haptics_on(on){ _hap_on = on; }\n"
+    "func titresim_ac(on){ _hap_on = on; }\n"
+    "func music_on(on)  { _mus_on = on; if (!on) { _mus_track = -1; } }\n"
+    "func muzik_ac(on)  { music_on(on); }\n"
+    "func show_fps(on)  { _fps_on = on; }\n"
+    "func fps_goster(on){ _fps_on = on; }\n"
+    "\n"
+    "// ---- Prosedürel arka plan müziği (dosyasız chiptune sekanslayıcı) -----------\n"
+    "// tm_tone ile notaları KISIK (SFX'i bastırmadan) çalar; iki parça: 0=menü\n"
+    "// (sakin A-minör arpej), 1=oyun (hareketli C-majör pentatonik). elapsed()\n"
+    "// mutlak saatine göre sıradaki notayı tetikler → kare hızından bağımsız tempo.\n"
+    "// Frekans 0.0 = es (sessiz nota). Parça döngüsel; sona gelince başa sarar.\n"
+    "float _mus_vol   = 0.26;   // nota ses seviyesi (0..1); SFX=1.0'in altında kalır\n"
+    "int   _mus_idx   = 0;      // aktif parçadaki sıradaki nota\n"
+    "float _mus_next  = 0.0;    // elapsed() zamanı: bu nota ne zaman çalınacak\n"
+    "int   _mus_track = -1;     // -1=yüklü değil, 0=menü, 1=oyun\n"
+    "int   _mus_gtheme = 0;     // oyun-içi tema (0=varsayılan,1=gergin,2=neşeli)\n"
+    "array _mus_f = [];         // aktif parça: nota frekansları (Hz; 0=es)\n"
+    "array _mus_d = [];         // aktif parça: nota süreleri (sn)\n"
+    "\n"
+    "func _mus_select(track) {\n"
+    "    if (track == _mus_track) { return; }\n"
+    "    _mus_track = track;\n"
+    "    _mus_idx = 0;\n"
+    "    _mus_next = elapsed();   // sıradaki karede hemen başla\n"
+    "    if (track == 0) {\n"
+    "        // Menü — sakin, geniş arpej (A2 kökü); es'lerle nefes alır.\n"
+    "        _mus_f = [220.0, 261.63, 329.63, 440.0, 329.63, 261.63, 0.0, 196.0, 246.94, 329.63, 392.0, 329.63, 246.94, 0.0];\n"
+    "        _mus_d = [0.32, 0.32, 0.32, 0.32, 0.32, 0.32, 0.32, 0.32, 0.32, 0.32, 0.32, 0.32, 0.32, 0.32];\n"
+    "    } else if (_mus_gtheme == 1) {\n"
+    "        // Oyun teması 1 — gergin/hızlı (A-minör; nişancı/uzay için).\n"
+    "        _mus_f = [440.0, 523.25, 659.25, 523.25, 493.88, 392.0, 440.0, 659.25, 587.33, 523.25, 493.88, 440.0];\n"
+    "        _mus_d = [0.15, 0.15, 0.15, 0.15, 0.15, 0.15, 0.15, 0.15, 0.15, 0.15, 0.15, 0.15];\n"
+    "    } else if (_mus_gtheme == 2) {\n"
+    "        // Oyun teması 2 — zıpzıp/neşeli (G-majör; platformer için).\n"
+    "        _mus_f = [392.0, 493.88, 587.33, 783.99, 587.33, 493.88, 523.25, 659.25, 783.99, 659.25, 587.33, 493.88];\n"
+    "        _mus_d = [0.16, 0.16, 0.16, 0.16, 0.16, 0.16, 0.16, 0.16, 0.16, 0.16, 0.16, 0.16];\n"
+    "    } else {\n"
+    "        // Oyun teması 0 (varsayılan) — hareketli C pentatonik döngü.\n"
+    "        _mus_f = [523.25, 659.25, 783.99, 659.25, 523.25, 392.0, 523.25, 659.25, 587.33, 440.0, 523.25, 659.25, 783.99, 1046.5, 783.99, 659.25];\n"
+    "        _mus_d = [0.17, 0.17, 0.17, 0.17, 0.17, 0.17, 0.17, 0.17, 0.17, 0.17, 0.17, 0.17, 0.17, 0.17, 0.17, 0.17];\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Oyun-içi müzik temasını seç (0=varsayılan, 1=gergin, 2=neşeli). Oyun setup'ında\n"
+    "// çağır; launcher her oyuna geçişte 0'a döner (_lx_clear).\n"
+    "func music_theme(n) { _mus_gtheme = n; if (_mus_track == 1) { _mus_track = -1; } }\n"
+    "func muzik_tema(n)  { music_theme(n); }\n"
+    "\n"
+    "// Her karede çağrılır: seçili parçayı kur, sıradaki notanın vakti geldiyse çal.\n"
+    "func _mus_step(track) {\n"
+    "    if (!_mus_on) { return; }\n"
+    "    _mus_select(track);\n"
+    "    float now = elapsed();\n"
+    "    if (now >= _mus_next) {\n"
+    "        int n = len(_mus_f);\n"
+    "        if (n <= 0) { return; }\n"
+    "        float f = _mus_f[_mus_idx];\n"
+    "        float d = _mus_d[_mus_idx];\n"
+    "        if (f > 0.0) { tm_tone(f, toInt(d * 850.0), _mus_vol); }\n"
+    "        _mus_next = now + d;\n"
+    "        _mus_idx = _mus_idx + 1;\n"
+    "        if (_mus_idx >= n) { _mus_idx = 0; }\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// HUD\n"
+    "str _hud_prefix = \"\";     // \"\" = dile göre varsayılan (\"Skor: \" / \"Score: \")\n"
+    "bool _hud_set = false;    // hud()/hud_prefix() ile açıkça ayarlandı mı?\n"
+    "int _score = 0;\n"
+    "bool _show_score = true;\n"
+    "bool _ar_paused = false;   // oyun-içi duraklatma (play/launcher döngüsü okur; erken tanım)\n"
+    "\n"
+    "// Juice durumu — score_add / _pt_spawn (yukarıda) bunları kullandığı için erken.\n"
+    "array _pop_x = []; array _pop_y = []; array _pop_t = []; array _pop_txt = []; array _pop_kind = [];\n"
+    "int _pop_n = 0;\n"
+    "float _fx_last_x = 0.0;    // son patlama konumu (popup çıpası)\n"
+    "float _fx_last_y = 0.0;\n"
+    "float _fx_last_t = 0.0;    // > 0 ise son patlama bu kareye yakın\n"
+    "int   _combo = 0;          // ardışık seri sayacı (görsel; skoru bozmaz)\n"
+    "float _combo_t = 0.0;      // seri penceresi (sn); 0'a inince sıfırlanır\n"
+    "float _trans_t = 0.0;      // menü↔oyun geçiş fade'i (sn)\n"
+    "\n"
+    "// Global skor tablosu (opsiyonel; skor_tablosu_url ile açılır). Oyun-bitişinde\n"
+    "// skoru bir Tulpar Wings sunucusuna GÖNDERİR ve top-10'u ÇEKİP gösterir.\n"
+    "// _lb_url == \"\" ise tamamen kapalı (varsayılan) → hiçbir ağ çağrısı yapılmaz.\n"
+    "str  _lb_url  = \"\";\n"
+    "str  _lb_name = \"Oyuncu\";\n"
+    "array _lb_data = [];       // son çekilen tablo (isim/skor kayıtları)\n"
+    "bool _lb_has = false;      // bu oyun-bitişinde tablo çekilebildi mi?\n"
+    "str _hint = \"\";           // üst bilgilendirme şeridi (kontroller vb.)\n"
+    "bool _has_hint = false;\n"
+    "\n"
+    "// ============================================================================\n"
+    "//  KURULUM / DÖNGÜ\n"
+    "// ============================================================================\n"
+    "\n"
+    "// Pencereyi açar, 60 FPS ayarlar, dünyayı entity'nin sığacağı boyuta kurar.\n"
+    "func scene(w, h, title): bool {\n"
+    "    _world_w = w * 1.0;\n"
+    "    _world_h = h * 1.0;\n"
+    "    _ar_title = title;          // kalıcı en-iyi-skor kayıt anahtarı\n"
+    "    set_fps(60);\n"
+    "    return window(w, h, title);\n"
+    "}\n"
+    "func sahne(w, h, title): bool { return scene(w, h, title); }\n"
+    "\n"
+    "// Kurulum callback'i: oyun başında ve her R (yeniden başlat) çağrılır.\n"
+    "func on_start(fn)     { _start_fn = fn; _has_start = true; }\n"
+    "func baslangicta(fn)  { on_start(fn); }\n"
+    "\n"
+    "// Kare başı kullanıcı mantığı (opsiyonel, 0-arg).\n"
+    "func on_frame(fn)  { _frame_fn = fn; _has_frame = true; }\n"
+    "func her_kare(fn)  { on_frame(fn); }\n"
+    "\n"
+    "// Otomatik çizimin üstüne ek çizim (opsiyonel, 0-arg).\n"
+    "func on_draw(fn)    { _draw_fn = fn; _has_draw = true; }\n"
+    "func ciz_ustune(fn) { on_draw(fn); }\n"
+    "\n"
+    "// Yönetilen ana döngü: giriş + fizik + çarpışma + otomatik çizim + HUD +\n"
+    "// oyun-bitti/R-yeniden hepsi burada. Bundan sonra kod yazmana gerek yok.\n"
+    "func play() {\n"
+    "    _ar_load_settings();               // kalıcı ses/haptik/dil ayarları\n"
+    "    _ar_standalone = true;             // oyun-bitti ekranında ikinci buton = \"Cikis\"\n"
+    "    _ar_start_level = 1;               // tek oyun: bölüm seçimi yok, 1'den başla\n"
+    "    _lx_load_lvl_done(_ar_title, _level_n);   // bölüm yıldızlarını işaretleyebilmek için\n"
+    "    _ar_reset();\n"
+    "    _trans_start();                    // açılışta kısa fade-in\n"
+    "    var wm = arena_save();\n"
+    "    while (running()) {\n"
+    "        // Tek oyun (launcher yok): GERİ / ESC → duraklat. Menü olmadığı için\n"
+    "        // duraklat menüsünün 3. seçeneği \"Çıkış\"tır (pencereyi kapatır).\n"
+    "        // Yalnız aktif oynanırken duraklanır (biten oyun duraklatılamaz).\n"
+    "        if (!_ar_paused && _ar_state == 0) {\n"
+    "            if (key_pressed(\"ESCAPE\") || key_pressed(\"BACKSPACE\") || key_pressed(\"BACK\")) {\n"
+    "                _pause_enter();\n"
+    "            }\n"
+    "        }\n"
+    "        if (_ar_paused) {\n"
+    "            str ql = \"Cikis\"; if (_lang_now() == \"en\") { ql = \"Quit\"; }\n"
+    "            _mus_step(0);                  // duraklatınca sakin parça\n"
+    "            frame_begin();\n"
+    "            _ar_draw_all();\n"
+    "            _pause_draw(ql);\n"
+    "            frame_end();\n"
+    "            int act = _pause_step();\n"
+    "            if (act == 1) { _ar_paused = false; }\n"
+    "            else if (act == 2) { _ar_reset(); _ar_paused = false; }\n"
+    "            else if (act == 3) { break; }\n"
+    "        } else {\n"
+    "            _ar_update();\n"
+    "            if (_ar_state == 0) { _mus_step(1); } else { _mus_step(0); }\n"
+    "            frame_begin();\n"
+    "            _ar_draw_all();\n"
+    "            _trans_draw();\n"
+    "            frame_end();\n"
+    "            // Oyun-bitti ekranı: yalnız butonlar iş yapar (ekrana dokunma başlatmaz).\n"
+    "            if (_ar_state != 0) {\n"
+    "                int oa = _ar_over_step();\n"
+    "                if (oa == 1) { _ar_reset(); _trans_start(); }\n"
+    "                else if (oa == 2) { break; }   // tek oyunda \"Cikis\" → pencere kapanır\n"
+    "            }\n"
+    "        }\n"
+    "        arena_restore(wm);\n"
+    "    }\n"
+    "    arena_drop(wm);\n"
+    "    close_window();\n"
+    "}\n"
+    "func oyna() { play(); }\n"
+    "\n"
+    "// Baştan kur: entity'leri temizler, skoru sıfırlar, 1. bölüme döner.\n"
+    "// R (yeniden başla) hem \"oyun bitti\" hem \"kazandın\" durumundan buraya gelir:\n"
+    "// skor 0 + bölüm 1. (Sadece bulunduğun bölümü tekrarlamak kasten YOK — oyuncu\n"
+    "// \"yeniden\" deyince baştan başlamayı bekler; en tahmin edilebilir olan bu.)\n"
+    "int _ar_start_level = 1;   // \"Tekrar Oyna\"/reset bu bölüme döner (bölüm-seçimi ayarlar)\n"
+    "\n"
+    "func _ar_reset() {\n"
+    "    _score = 0;\n"
+    "    _ar_state = 0;\n"
+    "    _cur_level = _ar_start_level;\n"
+    "    _banner_t = 0.0;\n"
+    "    _lvl_pending = 0;\n"
+    "    _ar_paused = false;\n"
+    "    _fx_reset();\n"
+    "    _new_record = false;\n"
+    "    _ar_load_best();\n"
+    "    _ar_load_level();\n"
+    "}\n"
+    "\n"
+    "// Güncel bölümü kur: entity'leri sil → global kurulum (_start_fn) → bölüm fn'i.\n"
+    "// Bölüm kaydı yoksa bu tam olarak eski _ar_reset gövdesidir (geriye uyum).\n"
+    "func _ar_load_level() {\n"
+    "    clear_entities();\n"
+    "    if (_has_start) { call(_start_fn); }\n"
+    "    if (_has_levels) {\n"
+    "        if (_cur_level >= 1 && _cur_level <= _level_n) {\n"
+    "            var lfn = _levels[_cur_level - 1];\n"
+    "            if (lfn != 0) { call(lfn); }\n"
+    "        }\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// ============================================================================\n"
+    "//  BÖLÜMLER (level)\n"
+    "// ============================================================================\n"
+    "\n"
+    "// Bölüm kurulum fonksiyonu kaydet (n 1-tabanlı, fn 0-arg).\n"
+    "// Aynı n iki kez kaydedilirse sonuncusu kazanır. Kayıtlar `temizle()` ile\n"
+    "// SİLİNMEZ — bölümler entity değil, oyun tanımının parçasıdır.\n"
+    "func level(n, fn) {\n"
+    "    if (n < 1) { return; }\n"
+    "    // Diziyi n'e kadar 0 ile büyüt (araya boş bölüm kaydı bırakılabilir).\n"
+    "    for (int i = length(_levels); i < n; i = i + 1) { push(_levels, 0); }\n"
+    "    _levels[n - 1] = fn;\n"
+    "    if (n > _level_n) { _level_n = n; }\n"
+    "    _has_levels = true;\n"
+    "}\n"
+    "func bolum(n, fn) { level(n, fn); }\n"
+    "\n"
+    "// Sıradaki bölüme geç. Son bölümdeyse → KAZANDIN (_ar_state = 2).\n"
+    "//\n"
+    "// DİKKAT: geçişi burada YAPMAZ, sadece işaretler. Bu fonksiyon tipik olarak bir\n"
+    "// çarpışma callback'inden çağrılır ve o sırada `_ar_collisions()` paralel\n"
+    "// dizilerin üstünde dönüyordur; hemen `clear_entities()` çağırmak o döngünün\n"
+    "// altındaki diziyi değiştirirdi. Geçiş güvenli noktada (kare sonunda,\n"
+    "// _ar_update/step içinde) uygulanır.\n"
+    "func next_level() { _lvl_pending = 1; }\n"
+    "func bolum_gec()  { next_level(); }\n"
+    "\n"
+    "// Bekleyen bölüm geçişini uygula (motor içi, kare sonunda çağrılır).\n"
+    "func _ar_advance_level() {\n"
+    "    // Bu bölüm geçildi → o bölümün yıldızını kazan (bölüm-başına ilerleme).\n"
+    "    _ar_mark_level(_cur_level);\n"
+    "    if (_cur_level + 1 > _level_n) {            // son bölüm → kazandın\n"
+    "        _ar_state = 2;\n"
+    "        _ar_badge_set(0);     // \"İlk Zafer\" rozeti\n"
+    "        _snd(1046.0, 220);    // KAZANDIN — zafer tonu (C6)\n"
+    "        _ar_check_record();\n"
+    "        _lb_submit_fetch();   // global tablo açıksa: skoru gönder + top-10 çek\n"
+    "        return;\n"
+    "    }\n"
+    "    _cur_level = _cur_level + 1;\n"
+    "    _banner_t = 1.2;              // \"Bölüm N\" afişi ~1.2 sn\n"
+    "    _snd(680.0, 90);          // bölüm-geçiş \"yükselen\" tonu\n"
+    "    _ar_load_level();             // skor KORUNUR (oyuncunun toplam skoru)\n"
+    "}\n"
+    "\n"
+    "func level_no(): int    { return _cur_level; }\n"
+    "func bolum_no(): int    { return _cur_level; }\n"
+    "func level_count(): int { return _level_n; }\n"
+    "func bolum_sayisi(): int { return _level_n; }\n"
+    "\n"
+    "// ============================================================================\n"
+    "//  ENTITY OLUŞTURMA (\"bloklar\")\n"
+    "// ============================================================================\n"
+    "\n"
+    "// Genel oluşturucu — entity handle'ı döner (çıplak index DEĞİL; bkz _mk_handle).\n"
+    "// Önce ölmüş bir slot varsa onu geri kullanır, yoksa dizileri büyütür.\n"
+    "func spawn(x, y, w, h, color, tag, mv): int {\n"
+    "    if (_free_n > 0) {\n"
+    "        _free_n = _free_n - 1;\n"
+    "        int s = _efree[_free_n];\n"
+    "        _ex[s] = x * 1.0;\n"
+    "        _ey[s] = y * 1.0;\n"
+    "        _ew[s] = w * 1.0;\n"
+    "        _eh[s] = h * 1.0;\n"
+    "        _evx[s] = 0.0;\n"
+    "        _evy[s] = 0.0;\n"
+    "        _etag[s] = tag;\n"
+    "        _ecolor[s] = color;\n"
+    "        _esprite[s] = -1;\n"
+    "        _emove[s] = mv;\n"
+    "        _espeed[s] = 200.0;\n"
+    "        _ealive[s] = 1;\n"
+    "        _eground[s] = 0;\n"
+    "        return _mk_handle(s);       // _egen[s] öldürmede artmıştı → yeni kimlik\n"
+    "    }\n"
+    "    push(_ex, x * 1.0);\n"
+    "    push(_ey, y * 1.0);\n"
+    "    push(_ew, w * 1.0);\n"
+    "    push(_eh, h * 1.0);\n"
+    "    push(_evx, 0.0);\n"
+    "    push(_evy, 0.0);\n"
+    "    push(_etag, tag);\n"
+    "    push(_ecolor, color);\n"
+    "    push(_esprite, -1);\n"
+    "    push(_emove, mv);\n"
+    "    push(_espeed, 200.0);\n"
+    "    push(_ealive, 1);\n"
+    "    push(_eground, 0);\n"
+    "    push(_egen, 1);\n"
+    "    int slot = _n;\n"
+    "    _n = _n + 1;\n"
+    "    return _mk_handle(slot);\n"
+    "}\n"
+    "\n"
+    "// Slot'u öldür + boş yığına geri koy (MOTOR İÇİ — slot alır, handle değil).\n"
+    "// Üretim sayacını artırır: o slot'a ait eski handle'lar burada bayatlar.\n"
+    "func _kill_slot(slot) {\n"
+    "    if (slot < 0) { return; }\n"
+    "    if (_ealive[slot] == 0) { return; }        // çift-free koruması\n"
+    "    _ealive[slot] = 0;\n"
+    "    _egen[slot] = _egen[slot] + 1;\n"
+    "    if (_free_n < len(_efree)) { _efree[_free_n] = slot; }\n"
+    "    else { push(_efree, slot); }\n"
+    "    _free_n = _free_n + 1;\n"
+    "}\n"
+    "func uret(x, y, w, h, color, tag, mv): int { return spawn(x, y, w, h, color, tag, mv); }\n"
+    "\n"
+    "// Oyuncu: ok tuşları / WASD ile hareket hazır gelir (topdown).\n"
+    "func player(x, y, w, h, color): int { return spawn(x, y, w, h, color, TAG_PLAYER, MV_TOPDOWN); }\n"
+    "func oyuncu(x, y, w, h, color): int { return player(x, y, w, h, color); }\n"
+    "\n"
+    "// Platformer oyuncusu: yatay giriş + yerçekimi + zıplama (yercekimi() ile aç).\n"
+    "func platformer(x, y, w, h, color): int { return spawn(x, y, w, h, color, TAG_PLAYER, MV_PLATFORM); }\n"
+    "func oyuncu_p(x, y, w, h, color): int { return platformer(x, y, w, h, color); }\n"
+    "\n"
+    "// Düşman: hareketsiz başlar (hiz_ver ile ya da on_frame ile sürersin).\n"
+    "func enemy(x, y, w, h, color): int { return spawn(x, y, w, h, color, TAG_ENEMY, MV_NONE); }\n"
+    "func dusman(x, y, w, h, color): int { return enemy(x, y, w, h, color); }\n"
+    "\n"
+    "// Toplanabilir eşya (hareketsiz).\n"
+    "func item(x, y, w, h, color): int { return spawn(x, y, w, h, color, TAG_ITEM, MV_NONE); }\n"
+    "func esya(x, y, w, h, color): int { return item(x, y, w, h, color); }\n"
+    "\n"
+    "// Katı duvar/platform (hareketsiz; platformer entity'leri buna basar/çarpar).\n"
+    "func wall(x, y, w, h, color): int { return spawn(x, y, w, h, color, TAG_WALL, MV_NONE); }\n"
+    "func duvar(x, y, w, h, color): int { return wall(x, y, w, h, color); }\n"
+    "\n"
+    "// Mermi: verilen hızla kendi başına uçar (velocity preset).\n"
+    "func bullet(x, y, w, h, color, vx, vy): int {\n"
+    "    int id = spawn(x, y, w, h, color, TAG_BULLET, MV_VELOCITY);\n"
+    "    int s = _slot_of(id);          // spawn handle döner — diziler slot'la indekslenir\n"
+    "    _evx[s] = vx * 1.0;\n"
+    "    _evy[s] = vy * 1.0;\n"
+    "    return id;\n"
+    "}\n"
+    "func mermi(x, y, w, h, color, vx, vy): int { return bullet(x, y, w, h, color, vx, vy); }\n"
+    "\n"
+    "// Tüm entity'leri sil (yeniden başlatmada _ar_reset çağırır).\n"
+    "func clear_entities() {\n"
+    "    _ex = [];  _ey = [];  _ew = [];  _eh = [];\n"
+    "    _evx = []; _evy = []; _etag = []; _ecolor = [];\n"
+    "    _esprite = []; _emove = []; _espeed = []; _ealive = []; _eground = [];\n"
+    "    _egen = []; _efree = [];\n"
+    "    _n = 0;\n"
+    "    _free_n = 0;\n"
+    "}\n"
+    "func temizle() { clear_entities(); }\n"
+    "\n"
+    "// ============================================================================\n"
+    "//  ENTITY KONTROL (index ile — callback'lerin \"kasları\")\n"
+    "// ============================================================================\n"
+    "\n"
+    "// NOT: buradaki `id` bir handle'dır (çıplak index değil) — hepsi önce\n"
+    "// `_slot_of` ile slot'a çevirir. Bayat handle (slot geri kullanılmış) sessizce\n"
+    "// yok sayılır: setter'lar hiçbir şey yapmaz, getter'lar nötr değer döner.\n"
+    "func set_vel(id, vx, vy) { int s = _slot_of(id); if (s < 0) { return; } _evx[s] = vx * 1.0; _evy[s] = vy * 1.0; }\n"
+    "func hiz_ver(id, vx, vy) { set_vel(id, vx, vy); }\n"
+    "\n"
+    "func set_pos(id, x, y) { int s = _slot_of(id); if (s < 0) { return; } _ex[s] = x * 1.0; _ey[s] = y * 1.0; }\n"
+    "func konumla(id, x, y) { set_pos(id, x, y); }\n"
+    "\n"
+    "func get_x(id): float { int s = _slot_of(id); if (s < 0) { return 0.0; } return _ex[s]; }\n"
+    "func get_y(id): float { int s = _slot_of(id); if (s < 0) { return 0.0; } return _ey[s]; }\n"
+    "func x_of(id): float { int s = _slot_of(id); if (s < 0) { return 0.0; } return _ex[s]; }\n"
+    "func y_of(id): float { int s = _slot_of(id); if (s < 0) { return 0.0; } return _ey[s]; }\n"
+    "\n"
+    "// Hız okuma. `_evx[id]` ile DOĞRUDAN okumak yanlıştır: id bir handle'dır,\n"
+    "// diziler slot ile indekslenir (handle = gen*1048576 + slot → dizi dışı).\n"
+    "func get_vx(id): float { int s = _slot_of(id); if (s < 0) { return 0.0; } return _evx[s]; }\n"
+    "func get_vy(id): float { int s = _slot_of(id); if (s < 0) { return 0.0; } return _evy[s]; }\n"
+    "func vx_of(id): float { return get_vx(id); }\n"
+    "func vy_of(id): float { return get_vy(id); }\n"
+    "\n"
+    "// Topdown/platform taban hızını ayarla (px/sn).\n"
+    "// (slot değişkeni `sl` — `s` zaten hız parametresi)\n"
+    "func move_speed(id, s) { int sl = _slot_of(id); if (sl < 0) { return; } _espeed[sl] = s * 1.0; }\n"
+    "func hiz_ayarla(id, s) { move_speed(id, s); }\n"
+    "\n"
+    "func set_color(id, c) { int s = _slot_of(id); if (s < 0) { return; } _ecolor[s] = c; }\n"
+    "func renk_ata(id, c)  { set_color(id, c); }\n"
+    "\n"
+    "func set_sprite(id, tex) { int s = _slot_of(id); if (s < 0) { return; } _esprite[s] = tex; }\n"
+    "func resim_ata(id, tex)  { set_sprite(id, tex); }\n"
+    "\n"
+    "func kill(id)   { _kill_slot(_slot_of(id)); }\n"
+    "func oldur(id)  { kill(id); }\n"
+    "\n"
+    "func alive(id): bool  { int s = _slot_of(id); if (s < 0) { return false; } return _ealive[s] == 1; }\n"
+    "func yasiyor(id): bool { int s = _slot_of(id); if (s < 0) { return false; } return _ealive[s] == 1; }\n"
+    "\n"
+    "func tag_of(id): int { int s = _slot_of(id); if (s < 0) { return -1; } return _etag[s]; }\n"
+    "func tag_al(id): int { int s = _slot_of(id); if (s < 0) { return -1; } return _etag[s]; }\n"
+    "\n"
+    "// AYRILMIŞ slot sayısı — canlı entity sayısı DEĞİL. Ölen slot'lar geri\n"
+    "// kullanıldığı için bu sayı eşzamanlı en yüksek entity sayısına oturur\n"
+    "// (sürekli mermi üreten bir oyunda sonsuza dek büyümez).\n"
+    "func entity_count(): int { return _n; }\n"
+    "func entity_sayisi(): int { return _n; }\n"
+    "\n"
+    "// Şu an canlı olan entity sayısı.\n"
+    "func live_count(): int {\n"
+    "    int c = 0;\n"
+    "    for (int i = 0; i < _n; i = i + 1) {\n"
+    "        if (_ealive[i] == 1) { c = c + 1; }\n"
+    "    }\n"
+    "    return c;\n"
+    "}\n"
+    "func canli_sayisi(): int { return live_count(); }\n"
+    "\n"
+    "// Belirli tag'e sahip canlı entity sayısı — \"tüm eşyalar toplandı mı?\" gibi\n"
+    "// bölüm bitiş koşulları için (live_count() oyuncuyu/duvarları da sayar).\n"
+    "func tag_count(t): int {\n"
+    "    int c = 0;\n"
+    "    for (int i = 0; i < _n; i = i + 1) {\n"
+    "        if (_ealive[i] == 1 && _etag[i] == t) { c = c + 1; }\n"
+    "    }\n"
+    "    return c;\n"
+    "}\n"
+    "func tag_sayisi(t): int { return tag_count(t); }\n"
+    "\n"
+    "// ============================================================================\n"
+    "//  ÇARPIŞMA\n"
+    "// ============================================================================\n"
+    "\n"
+    "// tagA'lı bir entity tagB'li bir entity'ye değince fn (0-arg) çağrılır.\n"
+    "// fn içinde ben()=tagA tarafı, oteki()=tagB tarafı. Kural yönlüdür ama motor\n"
+    "// simetriği de dener (B→A eşleşmesi de tetikler, me/other buna göre ayarlanır).\n"
+    "func on_hit(tagA, tagB, fn) {\n"
+    "    push(_ca, tagA);\n"
+    "    push(_cb, tagB);\n"
+    "    push(_cfn, fn);\n"
+    "}\n"
+    "func carpisinca(tagA, tagB, fn) { on_hit(tagA, tagB, fn); }\n"
+    "\n"
+    "// Callback context'i.\n"
+    "// Çarpışan taraflar — handle döner (_hit_* içeride slot tutar).\n"
+    "func me(): int    { if (_hit_self < 0)  { return -1; } return _mk_handle(_hit_self); }\n"
+    "func ben(): int   { return me(); }\n"
+    "func other(): int { if (_hit_other < 0) { return -1; } return _mk_handle(_hit_other); }\n"
+    "func oteki(): int { return other(); }\n"
+    "\n"
+    "// İki entity çakışıyor mu? (manuel test)\n"
+    "// a/b handle'dır → slot'a çözülür (diziye doğrudan handle ile girmek dizi dışını\n"
+    "// okur; bkz. get_vx notu). Bayat/ölü handle → false.\n"
+    "func overlaps(a, b): bool {\n"
+    "    int sa = _slot_of(a);\n"
+    "    int sb = _slot_of(b);\n"
+    "    if (sa < 0 || sb < 0) { return false; }\n"
+    "    return rect_overlap(_ex[sa], _ey[sa], _ew[sa], _eh[sa], _ex[sb], _ey[sb], _ew[sb], _eh[sb]);\n"
+    "}\n"
+    "func degiyor(a, b): bool { return overlaps(a, b); }\n"
+    "\n"
+    "// ============================================================================\n"
+    "//  FİZİK / SAHNE AYARLARI\n"
+    "// ============================================================================\n"
+    "\n"
+    "// Platformer yerçekimini aç (px/sn^2). 0 = kapalı (topdown/arcade).\n"
+    "func gravity(g)    { _gravity = g * 1.0; }\n"
+    "func yercekimi(g)  { gravity(g); }\n"
+    "\n"
+    "// Zıplama hızını ayarla (yukarı, px/sn).\n"
+    "func jump_power(v) { _jump_v = v * 1.0; }\n"
+    "func ziplama(v)    { jump_power(v); }\n"
+    "\n"
+    "// Dünya sınırında tutmayı aç/kapat (topdown).\n"
+    "func clamp_to_world(on) { _clamp_world = on; }\n"
+    "\n"
+    "// ---- Skor / oyun-bitti ------------------------------------------------------\n"
+    "// Skor artışı yumuşak bir \"blip\" çalar (tüm oyunlara bedava işitsel geri\n"
+    "// bildirim). tm_beep ses cihazı yoksa güvenle no-op'tur (headless test/CI).\n"
+    "func score_add(n) {\n"
+    "    _score = _score + n;\n"
+    "    _snd(720.0, 40);\n"
+    "    // Seri (combo) — yalnız görsel; skoru değiştirmez → rekorlar adil kalır.\n"
+    "    if (_combo_t > 0.0) { _combo = _combo + 1; } else { _combo = 1; }\n"
+    "    _combo_t = 1.1;\n"
+    "    // \"+N\" baloncuğu: son patlama konumunda (çarpışma yeri), yoksa üst-orta.\n"
+    "    float px = _world_w * 0.5; float py = _world_h * 0.30;\n"
+    "    if (_fx_last_t > 0.0) { px = _fx_last_x; py = _fx_last_y; }\n"
+    "    _pop_spawn(px, py, \"+\" + toString(n), 0);\n"
+    "    if (_combo >= 3) {\n"
+    "        str cw = \"SERI x\"; if (_lang_now() == \"en\") { cw = \"STREAK x\"; }\n"
+    "        _pop_spawn(px, py - 24.0, cw + toString(_combo), 1);\n"
+    "    }\n"
+    "}\n"
+    "func skor_ekle(n) { score_add(n); }\n"
+    "func score(): int { return _score; }\n"
+    "func skor(): int  { return _score; }\n"
+    "func set_score(n) { _score = n; }\n"
+    "func skor_ata(n)  { _score = n; }\n"
+    "\n"
+    "// Oyun bitişi otomatik \"juice\" alır: sarsıntı + flash (tüm oyunlara bedava).\n"
+    "// İlk çağrıda rekor kontrolü de yapılır; tekrar çağrılar durumu bozmaz.\n"
+    "func game_over() {\n"
+    "    if (_ar_state == 0) {\n"
+    "        sars();\n"
+    "        parla();\n"
+    "        _snd(150.0, 240);      // düşük \"kayıp\" tonu (tüm oyunlara bedava)\n"
+    "        _hap(220);             // ölüm titreşimi (Android; masaüstü/web no-op)\n"
+    "        _ar_check_record();\n"
+    "        _lb_submit_fetch();    // global tablo açıksa: skoru gönder + top-10 çek\n"
+    "    }\n"
+    "    _ar_state = 1;\n"
+    "}\n"
+    "func oyun_bitti() { game_over(); }\n"
+    "\n"
+    "// \"Oyun artık oynanmıyor mu?\" — kaybetmek (1) de kazanmak (2) da bitiştir.\n"
+    "// Bölüm kaydı olmayan oyunlarda state 2 hiç oluşmaz → eski davranışla aynı.\n"
+    "func is_over(): bool  { return _ar_state != 0; }\n"
+    "func bitti_mi(): bool { return _ar_state != 0; }\n"
+    "\n"
+    "// Sadece \"son bölüm de bitti\" (kazandın) durumu.\n"
+    "func is_won(): bool    { return _ar_state == 2; }\n"
+    "func kazandin_mi(): bool { return _ar_state == 2; }\n"
+    "\n"
+    "// HUD skor metnini özelleştir / gizle.\n"
+    "func hud(prefix)  { _hud_prefix = prefix; _hud_set = true; }\n"
+    "func hud_gizle()  { _show_score = false; }\n"
+    "func hide_hud()   { _show_score = false; }\n"
+    "\n"
+    "// Ekranın üstünde kontrol/etkileşim bilgilendirme şeridi (ör.\n"
+    "//   bilgi(\"Ok/WASD: hareket   SPACE: ates\")). Skorun altında çizilir.\n"
+    "func bilgi(s)    { _hint = s; _has_hint = true; }\n"
+    "func controls(s) { _hint = s; _has_hint = true; }\n"
+    "func help_text(s){ _hint = s; _has_hint = true; }\n"
+    "\n"
+    "// ============================================================================\n"
+    "//  EFEKTLER — parçacık + sarsıntı + flash (\"juice\", saf Tulpar)\n"
+    "// ============================================================================\n"
+    "// patlama(x,y,renk) bir çarpışma callback'inden çağrılır; sars()/parla() da\n"
+    "// öyle. Motor bunları kare sonunda kendisi günceller/çizer. Parçacıklar da\n"
+    "// entity'ler gibi PARALEL DİZİ + slot geri kazanımı kullanır (ölü slot = life<=0).\n"
+    "// Solma alpha ile değil KÜÇÜLME ile yapılır (paketli renk int'inden alpha\n"
+    "// bileşenini çıkarmak için helper yok — küçülme aynı hissi bedavaya verir).\n"
+    "\n"
+    "array _pt_x = [];    // konum\n"
+    "array _pt_y = [];\n"
+    "array _pt_vx = [];   // hız (px/sn)\n"
+    "array _pt_vy = [];\n"
+    "array _pt_life = []; // kalan ömür (sn); <= 0 → slot ölü, yeniden kullanılabilir\n"
+    "array _pt_max = [];  // başlangıç ömrü (küçülme oranı için)\n"
+    "array _pt_col = [];  // renk (paketli int)\n"
+    "array _pt_size = []; // yarıçap (px)\n"
+    "int _pt_n = 0;\n"
+    "\n"
+    "// n adet parçacık saç: rastgele yön, hafif yukarı eğilim, yerçekimiyle düşer.\n"
+    "func _pt_spawn(x, y, col, n) {\n"
+    "    _fx_last_x = x * 1.0; _fx_last_y = y * 1.0; _fx_last_t = 0.12;  // popup çıpası\n"
+    "    for (int j = 0; j < n; j = j + 1) {\n"
+    "        float ang = random() * 6.2831853;\n"
+    "        float spd = 60.0 + random() * 180.0;\n"
+    "        float pvx = cos(ang) * spd;\n"
+    "        float pvy = sin(ang) * spd - 40.0;\n"
+    "        float plife = 0.35 + random() * 0.4;\n"
+    "        float psize = 2.0 + random() * 3.0;\n"
+    "        // Önce ölü slot ara (parçacık sayısı küçük — lineer tarama yeterli).\n"
+    "        int slot = 0 - 1;\n"
+    "        for (int i = 0; i < _pt_n; i = i + 1) {\n"
+    "            if (slot < 0 && _pt_life[i] <= 0.0) { slot = i; }\n"
+    "        }\n"
+    "        if (slot >= 0) {\n"
+    "            _pt_x[slot] = x * 1.0;  _pt_y[slot] = y * 1.0;\n"
+    "            _pt_vx[slot] = pvx;     _pt_vy[slot] = pvy;\n"
+    "            _pt_life[slot] = plife; _pt_max[slot] = plife;\n"
+    "            _pt_col[slot] = col;    _pt_size[slot] = psize;\n"
+    "        } else {\n"
+    "            push(_pt_x, x * 1.0);  push(_pt_y, y * 1.0);\n"
+    "            push(_pt_vx, pvx);     push(_pt_vy, pvy);\n"
+    "            push(_pt_life, plife); push(_pt_max, plife);\n"
+    "            push(_pt_col, col);    push(_pt_size, psize);\n"
+    "            _pt_n = _pt_n + 1;\n"
+    "        }\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "func _pt_update(dt) {\n"
+    "    for (int i = 0; i < _pt_n; i = i + 1) {\n"
+    "        if (_pt_life[i] <= 0.0) { continue; }\n"
+    "        _pt_life[i] = _pt_life[i] - dt;\n"
+    "        _pt_x[i] = _pt_x[i] + _pt_vx[i] * dt;\n"
+    "        _pt_y[i] = _pt_y[i] + _pt_vy[i] * dt;\n"
+    "        _pt_vy[i] = _pt_vy[i] + 420.0 * dt;   // yerçekimi — kıvılcım hissi\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Parçacıkları çiz (ox/oy = sarsıntı ofseti). Ömür bitene doğru küçülür.\n"
+    "func _pt_draw(ox, oy) {\n"
+    "    for (int i = 0; i < _pt_n; i = i + 1) {\n"
+    "        if (_pt_life[i] <= 0.0) { continue; }\n"
+    "        float k = _pt_life[i] / _pt_max[i];\n"
+    "        if (k > 1.0) { k = 1.0; }\n"
+    "        float r = _pt_size[i] * k;\n"
+    "        if (r >= 1.0) {\n"
+    "            circle(toInt(_pt_x[i] + ox), toInt(_pt_y[i] + oy), toInt(r), _pt_col[i]);\n"
+    "        }\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "func _pt_clear() {\n"
+    "    _pt_x = []; _pt_y = []; _pt_vx = []; _pt_vy = [];\n"
+    "    _pt_life = []; _pt_max = []; _pt_col = []; _pt_size = [];\n"
+    "    _pt_n = 0;\n"
+    "}\n"
+    "\n"
+    "// ---- Uçan \"+N\" skor baloncukları + combo/seri (saf görsel, skoru DEĞİŞTİRMEZ)\n"
+    "// Combo yalnız görseldir: seri sayacı skor matematiğini bozmaz → rekorlar adil\n"
+    "// kalır. \"+N\" baloncuğu son patlama konumunda (çarpışma yeri) belirir.\n"
+    "// (Global durum yukarıda erken tanımlı — score_add/_pt_spawn onlardan önce gelir.)\n"
+    "\n"
+    "func _pop_spawn(x, y, txt, kind) {\n"
+    "    int slot = 0 - 1;\n"
+    "    for (int i = 0; i < _pop_n; i = i + 1) { if (slot < 0 && _pop_t[i] <= 0.0) { slot = i; } }\n"
+    "    if (slot >= 0) {\n"
+    "        _pop_x[slot] = x * 1.0; _pop_y[slot] = y * 1.0;\n"
+    "        _pop_t[slot] = 0.9; _pop_txt[slot] = txt; _pop_kind[slot] = kind;\n"
+    "    } else {\n"
+    "        push(_pop_x, x * 1.0); push(_pop_y, y * 1.0);\n"
+    "        push(_pop_t, 0.9); push(_pop_txt, txt); push(_pop_kind, kind);\n"
+    "        _pop_n = _pop_n + 1;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "func _pop_update(dt) {\n"
+    "    for (int i = 0; i < _pop_n; i = i + 1) {\n"
+    "        if (_pop_t[i] <= 0.0) { continue; }\n"
+    "        _pop_t[i] = _pop_t[i] - dt;\n"
+    "        _pop_y[i] = _pop_y[i] - 46.0 * dt;    // yukarı süzül\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "func _pop_draw(ox, oy) {\n"
+    "    for (int i = 0; i < _pop_n; i = i + 1) {\n"
+    "        if (_pop_t[i] <= 0.0) { continue; }\n"
+    "        float k = _pop_t[i] / 0.9; if (k > 1.0) { k = 1.0; }\n"
+    "        int a = toInt(k * 255.0); if (a < 0) { a = 0; } if (a > 255) { a = 255; }\n"
+    "        int col = rgba(255, 215, 0, a);        // altın \"+N\"\n"
+    "        int sz = 20;\n"
+    "        if (_pop_kind[i] == 1) { col = rgba(255, 170, 60, a); sz = 24; }   // combo\n"
+    "        str t = _pop_txt[i];\n"
+    "        text(t, toInt(_pop_x[i] + ox - measure_text(t, sz) / 2.0),\n"
+    "             toInt(_pop_y[i] + oy), sz, col);\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "func _pop_clear() {\n"
+    "    _pop_x = []; _pop_y = []; _pop_t = []; _pop_txt = []; _pop_kind = [];\n"
+    "    _pop_n = 0;\n"
+    "    _combo = 0; _combo_t = 0.0;\n"
+    "    _fx_last_t = 0.0;\n"
+    "}\n"
+    "\n"
+    "// ---- Menü ↔ oyun geçiş fade'i (kısa siyah örtü) -----------------------------\n"
+    "// (_trans_t yukarıda erken tanımlı.)\n"
+    "func _trans_start() { _trans_t = 0.30; }\n"
+    "func _trans_draw() {\n"
+    "    if (_trans_t <= 0.0) { return; }\n"
+    "    float dt = frame_time();\n"
+    "    if (dt <= 0.0) { dt = 0.0166667; }\n"
+    "    if (dt > 0.05) { dt = 0.05; }\n"
+    "    _trans_t = _trans_t - dt;\n"
+    "    float k = _trans_t / 0.30; if (k < 0.0) { k = 0.0; } if (k > 1.0) { k = 1.0; }\n"
+    "    int a = toInt(k * 255.0);\n"
+    "    float vl = tm_view_left(); float vt = tm_view_top();\n"
+    "    float vr = tm_view_right(); float vb = tm_view_bottom();\n"
+    "    rect(vl, vt, vr - vl, vb - vt, rgba(10, 12, 18, a));\n"
+    "}\n"
+    "\n"
+    "// ---- Herkese açık parçacık API'si -------------------------------------------\n"
+    "func explode(x, y, col)       { _pt_spawn(x, y, col, 16); }\n"
+    "func patlama(x, y, col)       { explode(x, y, col); }\n"
+    "func explode_n(x, y, col, n)  { _pt_spawn(x, y, col, n); }\n"
+    "func patlama_n(x, y, col, n)  { _pt_spawn(x, y, col, n); }\n"
+    "\n"
+    "// ---- Ekran sarsıntısı + flash ----------------------------------------------\n"
+    "float _fx_sh_t = 0.0;     // kalan sarsıntı süresi (sn)\n"
+    "float _fx_sh_dur = 0.0;\n"
+    "float _fx_sh_mag = 7.0;   // azami ofset (px) — süre bittikçe söner\n"
+    "float _fx_ox = 0.0;       // BU karenin çizim ofseti (entity + parçacık kayar)\n"
+    "float _fx_oy = 0.0;\n"
+    "float _fx_fl_t = 0.0;     // kalan flash süresi (sn)\n"
+    "float _fx_fl_dur = 0.0;\n"
+    "\n"
+    "// Kısa ekran sarsıntısı (~0.28 sn). Çarpışma/patlama anında çağır.\n"
+    "func shake() { _fx_sh_t = 0.28; _fx_sh_dur = 0.28; _fx_sh_mag = 7.0; }\n"
+    "func sars()  { shake(); }\n"
+    "\n"
+    "// Beyaz tam-ekran flash (~0.16 sn) — hasar/ölüm vurgusu.\n"
+    "func flash() { _fx_fl_t = 0.16; _fx_fl_dur = 0.16; }\n"
+    "func parla() { flash(); }\n"
+    "\n"
+    "// ciz_ustune ile kendi sahnesini çizen oyunlar (ör. yılan) sarsıntıyı\n"
+    "// paylaşabilsin diye bu karenin ofseti dışa açık.\n"
+    "func shake_x(): float { return _fx_ox; }\n"
+    "func shake_y(): float { return _fx_oy; }\n"
+    "func sars_x(): float  { return _fx_ox; }\n"
+    "func sars_y(): float  { return _fx_oy; }\n"
+    "\n"
+    "// Kare başı efekt güncellemesi (motor içi) — oyun bittiğinde de çalışır ki\n"
+    "// son patlama/sarsıntı ekranda donmasın.\n"
+    "func _fx_update(dt) {\n"
+    "    _pt_update(dt);\n"
+    "    _pop_update(dt);\n"
+    "    // Seri penceresi + son-patlama çıpası zamanlayıcıları.\n"
+    "    if (_combo_t > 0.0) { _combo_t = _combo_t - dt; if (_combo_t <= 0.0) { _combo_t = 0.0; _combo = 0; } }\n"
+    "    if (_fx_last_t > 0.0) { _fx_last_t = _fx_last_t - dt; if (_fx_last_t < 0.0) { _fx_last_t = 0.0; } }\n"
+    "    _fx_ox = 0.0; _fx_oy = 0.0;\n"
+    "    if (_fx_sh_t > 0.0) {\n"
+    "        _fx_sh_t = _fx_sh_t - dt;\n"
+    "        if (_fx_sh_t < 0.0) { _fx_sh_t = 0.0; }\n"
+    "        float k = 0.0;\n"
+    "        if (_fx_sh_dur > 0.0) { k = _fx_sh_t / _fx_sh_dur; }\n"
+    "        float m = _fx_sh_mag * k;\n"
+    "        _fx_ox = (random() * 2.0 - 1.0) * m;\n"
+    "        _fx_oy = (random() * 2.0 - 1.0) * m;\n"
+    "    }\n"
+    "    if (_fx_fl_t > 0.0) {\n"
+    "        _fx_fl_t = _fx_fl_t - dt;\n"
+    "        if (_fx_fl_t < 0.0) { _fx_fl_t = 0.0; }\n"
+    "    }\n"
+    "    if (_badge_toast_t > 0.0) {           // rozet \"toast\"ı (oyun-bitti'de bile azalır)\n"
+    "        _badge_toast_t = _badge_toast_t - dt;\n"
+    "        if (_badge_toast_t < 0.0) { _badge_toast_t = 0.0; }\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "func _fx_reset() {\n"
+    "    _pt_clear();\n"
+    "    _pop_clear();\n"
+    "    _fx_sh_t = 0.0; _fx_fl_t = 0.0;\n"
+    "    _fx_ox = 0.0; _fx_oy = 0.0;\n"
+    "}\n"
+    "\n"
+    "// ============================================================================\n"
+    "//  EN İYİ SKOR — kalıcı rekor (save_data/load_data → masaüstünde CWD,\n"
+    "//  Android'de internalDataPath; oyun kodu hiçbir şey yapmaz, motor halleder)\n"
+    "// ============================================================================\n"
+    "str  _ar_title = \"\";      // kayıt anahtarı: sahne başlığı / launcher'da oyun adı\n"
+    "int  _best = 0;           // bu oyunun kalıcı en iyi skoru\n"
+    "bool _new_record = false; // bu elde rekor kırıldı (bitiş ekranında rozet)\n"
+    "\n"
+    "// ---- Yıldız (ilerleme) — BÖLÜM BAŞINA ---------------------------------------\n"
+    "// Bölümlü oyun: HER BÖLÜM kendi yıldızını kazanır (bölümü geçince). Kalıcı,\n"
+    "// bölüm başına: arcade_lvl_<ad>_<k>.txt = \"1\". Menü kartında tamamlanan/tüm\n"
+    "// bölüm; bölüm-seçim ekranında her bölümün yıldızı. Sonsuz oyun (bölüm yok):\n"
+    "// yildiz_hedef(a,b,c) skor eşiklerinden 0..3 yıldız (_stars, arcade_star_<ad>).\n"
+    "int  _stars   = 0;        // sonsuz oyun: kalıcı yıldız derecesi (0..3)\n"
+    "int  _star_g1 = 0;        // sonsuz oyun skor eşikleri (0 = tanımsız)\n"
+    "int  _star_g2 = 0;\n"
+    "int  _star_g3 = 0;\n"
+    "array _lvl_done = [];     // yüklü oyunun bölüm-tamamlama durumu (1-tabanlı → [k-1])\n"
+    "\n"
+    "func _ar_best_key(): str { return \"arcade_best_\" + _ar_title + \".txt\"; }\n"
+    "func _ar_star_key(): str { return \"arcade_star_\" + _ar_title + \".txt\"; }\n"
+    "func _ar_lvl_key(name, k): str { return \"arcade_lvl_\" + name + \"_\" + toString(k) + \".txt\"; }\n"
+    "\n"
+    "func _ar_load_best() {\n"
+    "    _best = 0;\n"
+    "    _stars = 0;\n"
+    "    if (_ar_title == \"\") { return; }\n"
+    "    str s = load_data(_ar_best_key());\n"
+    "    if (s != \"\") { _best = toInt(s); }\n"
+    "    str ss = load_data(_ar_star_key());\n"
+    "    if (ss != \"\") { _stars = toInt(ss); }\n"
+    "}\n"
+    "\n"
+    "// Bir oyunun tamamlanan bölüm sayısı (kalıcı dosyalardan).\n"
+    "func _count_done_levels(name, n): int {\n"
+    "    int c = 0; int k = 1;\n"
+    "    while (k <= n) {\n"
+    "        str s = load_data(_ar_lvl_key(name, k));\n"
+    "        if (s == \"1\") { c = c + 1; }\n"
+    "        k = k + 1;\n"
+    "    }\n"
+    "    return c;\n"
+    "}\n"
+    "\n"
+    "// Yüklü oyunun bölüm-tamamlama dizisini diskten doldur (bölüm-seçim ekranı için).\n"
+    "func _lx_load_lvl_done(name, n) {\n"
+    "    _lvl_done = [];\n"
+    "    int k = 1;\n"
+    "    while (k <= n) {\n"
+    "        str s = load_data(_ar_lvl_key(name, k));\n"
+    "        if (s == \"1\") { push(_lvl_done, 1); } else { push(_lvl_done, 0); }\n"
+    "        k = k + 1;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Bir bölümü TAMAMLANDI işaretle (kalıcı). Yeni ise kartı + rozetleri tazeler.\n"
+    "func _ar_mark_level(k) {\n"
+    "    if (_ar_title == \"\" || k < 1) { return; }\n"
+    "    if (k <= length(_lvl_done)) { if (_lvl_done[k - 1] == 1) { return; } }   // zaten\n"
+    "    save_data(_ar_lvl_key(_ar_title, k), \"1\");\n"
+    "    if (k <= length(_lvl_done)) { _lvl_done[k - 1] = 1; }\n"
+    "    if (_ar_mode == 1 && _menu_sel >= 0 && _menu_sel < _apps_n) {\n"
+    "        _apps_done[_menu_sel] = _count_done_levels(_ar_title, _level_n);\n"
+    "    }\n"
+    "    _ar_badge_check();\n"
+    "}\n"
+    "\n"
+    "// Toplam yıldız = bölümlü oyunların tamamlanan bölümleri + sonsuz oyun yıldızları.\n"
+    "func _total_stars(): int {\n"
+    "    int t = 0; int i = 0;\n"
+    "    while (i < _apps_n) {\n"
+    "        if (_apps_levn[i] > 0) { t = t + _apps_done[i]; }\n"
+    "        else { t = t + _apps_star[i]; }\n"
+    "        i = i + 1;\n"
+    "    }\n"
+    "    return t;\n"
+    "}\n"
+    "\n"
+    "// Sonsuz oyun: yıldızı k'ya YÜKSELT (asla düşürme), kalıcı yaz + rozet tazele.\n"
+    "func _ar_grant_stars(k) {\n"
+    "    if (_ar_title == \"\") { return; }\n"
+    "    if (k <= _stars) { return; }\n"
+    "    _stars = k;\n"
+    "    save_data(_ar_star_key(), toString(_stars));\n"
+    "    if (_ar_mode == 1 && _menu_sel >= 0 && _menu_sel < _apps_n) {\n"
+    "        _apps_star[_menu_sel] = _stars;\n"
+    "    }\n"
+    "    _ar_badge_check();\n"
+    "}\n"
+    "\n"
+    "// Sonsuz oyunlar için skor eşikleri (kazanılan yıldız = geçilen eşik sayısı).\n"
+    "func star_goals(a, b, c) { _star_g1 = a; _star_g2 = b; _star_g3 = c; }\n"
+    "func yildiz_hedef(a, b, c) { star_goals(a, b, c); }\n"
+    "func stars(): int  { return _stars; }\n"
+    "func yildiz(): int { return _stars; }\n"
+    "\n"
+    "// ---- Rozetler (başarımlar) --------------------------------------------------\n"
+    "// 5 kalıcı rozet (her biri arcade_badge_<i>.txt = \"1\"). Oyun-içi olaylar açar;\n"
+    "// yeni açılınca kısa \"toast\" + ses. Menüdeki kupa düğmesinden liste görünür.\n"
+    "array _badge_on = [];      // 0/1 durum (lazy yüklenir)\n"
+    "bool  _badges_loaded = false;\n"
+    "str   _badge_toast_txt = \"\";\n"
+    "float _badge_toast_t = 0.0;\n"
+    "\n"
+    "func _ar_badges_load() {\n"
+    "    if (_badges_loaded) { return; }\n"
+    "    _badges_loaded = true;\n"
+    "    _badge_on = [0, 0, 0, 0, 0];\n"
+    "    int i = 0;\n"
+    "    while (i < 5) {\n"
+    "        str s = load_data(\"arcade_badge_\" + toString(i) + \".txt\");\n"
+    "        if (s == \"1\") { _badge_on[i] = 1; }\n"
+    "        i = i + 1;\n"
+    "    }\n"
+    "}\n"
+    "func _badge_has(idx): bool {\n"
+    "    _ar_badges_load();\n"
+    "    return _badge_on[idx] == 1;\n"
+    "}\n"
+    "// Bir rozeti kazanılmış işaretle (idempotent). Yeni ise toast + ses tetikler.\n"
+    "func _ar_badge_set(idx) {\n"
+    "    _ar_badges_load();\n"
+    "    if (_badge_on[idx] == 1) { return; }\n"
+    "    _badge_on[idx] = 1;\n"
+    "    save_data(\"arcade_badge_\" + toString(idx) + \".txt\", \"1\");\n"
+    "    _badge_toast_txt = _badge_name(idx);\n"
+    "    _badge_toast_t = 2.2;\n"
+    "    _snd(880.0, 70);\n"
+    "    _snd(1174.0, 90);\n"
+    "}\n"
+    "// Türetilmiş rozetleri (mevcut duruma göre) değerlendir — yıldız kazanınca çağrılır.\n"
+    "func _ar_badge_check() {\n"
+    "    int total = _total_stars();\n"
+    "    if (total >= 3)  { _ar_badge_set(2); }\n"
+    "    if (total >= 15) { _ar_badge_set(3); }\n"
+    "    if (total >= 30) { _ar_badge_set(4); }\n"
+    "}\n"
+    "func _badge_name(idx): str {\n"
+    "    str L = _lang_now();\n"
+    "    if (idx == 0) { if (L == \"en\") { return \"First Win\"; } return \"Ilk Zafer\"; }\n"
+    "    if (idx == 1) { if (L == \"en\") { return \"Record Breaker\"; } return \"Rekortmen\"; }\n"
+    "    if (idx == 2) { if (L == \"en\") { return \"Three Stars\"; } return \"Uc Yildiz\"; }\n"
+    "    if (idx == 3) { if (L == \"en\") { return \"Collector\"; } return \"Koleksiyoncu\"; }\n"
+    "    if (L == \"en\") { return \"Master\"; }\n"
+    "    return \"Usta\";\n"
+    "}\n"
+    "func _badge_desc(idx): str {\n"
+    "    str L = _lang_now();\n"
+    "    if (idx == 0) { if (L == \"en\") { return \"Win any game\"; } return \"Bir oyunu kazan\"; }\n"
+    "    if (idx == 1) { if (L == \"en\") { return \"Break a record\"; } return \"Bir rekor kir\"; }\n"
+    "    if (idx == 2) { if (L == \"en\") { return \"3 total stars\"; } return \"Toplam 3 yildiz\"; }\n"
+    "    if (idx == 3) { if (L == \"en\") { return \"15 total stars\"; } return \"Toplam 15 yildiz\"; }\n"
+    "    if (L == \"en\") { return \"30 total stars\"; }\n"
+    "    return \"Toplam 30 yildiz\";\n"
+    "}\n"
+    "\n"
+    "// Oyun bittiğinde/kazanıldığında çağrılır: rekorsa kaydet + rozeti işaretle.\n"
+    "func _ar_check_record() {\n"
+    "    if (_ar_title == \"\") { return; }\n"
+    "    if (_score > _best) {\n"
+    "        _best = _score;\n"
+    "        _new_record = true;\n"
+    "        save_data(_ar_best_key(), toString(_best));\n"
+    "        _snd(1318.0, 130);    // yeni rekor \"ping\" (E6)\n"
+    "        _hap(120);\n"
+    "        _ar_badge_set(1);     // \"Rekortmen\" rozeti\n"
+    "    }\n"
+    "    // Sonsuz oyunlarda (bölüm yok) yıldız = en iyi skorun geçtiği eşik sayısı.\n"
+    "    if (_star_g1 > 0) {\n"
+    "        int k = 0;\n"
+    "        if (_best >= _star_g1) { k = 1; }\n"
+    "        if (_star_g2 > 0 && _best >= _star_g2) { k = 2; }\n"
+    "        if (_star_g3 > 0 && _best >= _star_g3) { k = 3; }\n"
+    "        if (k > 0) { _ar_grant_stars(k); }\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "func best_score(): int { return _best; }\n"
+    "func en_iyi_skor(): int { return _best; }\n"
+    "\n"
+    "// ---- Global skor tablosu (opsiyonel) ---------------------------------------\n"
+    "// Bir Tulpar Wings sunucusunun kök URL'sini ver (ör. \"http://10.0.2.2:3000\").\n"
+    "// \"\" (varsayılan) → tamamen kapalı, hiçbir ağ çağrısı yapılmaz.\n"
+    "func leaderboard_url(u)   { _lb_url = u; }\n"
+    "func skor_tablosu_url(u)  { _lb_url = u; }\n"
+    "func player_name(n)       { _lb_name = n; }\n"
+    "func oyuncu_adi(n)        { _lb_name = n; }\n"
+    "\n"
+    "// Oyun bitişinde: skoru GÖNDER + o oyunun top-10'unu ÇEK. Senkron HTTP —\n"
+    "// oyun-bitti ekranında (fizik durmuşken) tek sefer, bir kareyi bloklar.\n"
+    "// Sunucu yoksa/erişilemezse sessizce atlar (tablo çizilmez).\n"
+    "func _lb_submit_fetch() {\n"
+    "    _lb_has = false;\n"
+    "    _lb_data = [];\n"
+    "    if (_lb_url == \"\") { return; }\n"
+    "    if (_ar_title == \"\") { return; }\n"
+    "    json body = {\"oyun\": _ar_title, \"isim\": _lb_name, \"skor\": _score};\n"
+    "    http_request(\"POST\", _lb_url + \"/skor\", toJson(body));\n"
+    "    json r = http_request(\"POST\", _lb_url + \"/tablo\", toJson({\"oyun\": _ar_title}));\n"
+    "    if (toInt(r[\"ok\"]) == 1) {\n"
+    "        json parsed = fromJson(r[\"body\"]);\n"
+    "        _lb_data = parsed[\"tablo\"];\n"
+    "        _lb_has = true;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// ============================================================================\n"
+    "//  MOTOR İÇİ — kare güncelleme\n"
+    "// ============================================================================\n"
+    "\n"
+    "// ---- Dokunmatik: kontrol yerleşimi ------------------------------------------\n"
+    "// Konumlar GERÇEK ekran kenarlarına demirlenir (tm_view_* — Android'de sahne\n"
+    "// ortalanır, kenarlar dünyadan taşar; masaüstü/web'de view = dünya, eski\n"
+    "// davranışla birebir aynı). Boyutlar _world_h'ye göre (sahne ölçeğiyle uyumlu).\n"
+    "func _ar_dpad_cx(): float { return tm_view_left() + _world_h * 0.28; }\n"
+    "func _ar_dpad_cy(): float { return tm_view_bottom() - _world_h * 0.30; }\n"
+    "func _ar_dpad_r(): float  { return _world_h * 0.17; }\n"
+    "func _ar_act_cx(): float  { return tm_view_right() - _world_h * 0.24; }\n"
+    "func _ar_act_cy(): float  { return tm_view_bottom() - _world_h * 0.28; }\n"
+    "func _ar_act_r(): float   { return _world_h * 0.15; }\n"
+    "\n"
+    "// Her kare bir kez: parmakları oku → analog joystick + aksiyon-edge + tap-edge.\n"
+    "func _ar_read_touch() {\n"
+    "    _ar_td_left = false; _ar_td_right = false;\n"
+    "    _ar_td_up = false; _ar_td_down = false;\n"
+    "    _ar_joy_dx = 0.0; _ar_joy_dy = 0.0;\n"
+    "    _ar_act_now = false;\n"
+    "    int n = touch_count();\n"
+    "    if (n > 0) { _ar_touch_ui = true; } // ilk dokunuşta overlay'i kalıcı aç\n"
+    "    float acx = _ar_act_cx(); float acy = _ar_act_cy(); float ar = _ar_act_r();\n"
+    "    float baseR = _ar_dpad_r();          // topuzun taban içindeki azami yürüyüşü\n"
+    "    // Gerçek ekran kenarları (dünya koordinatında) — butonlar buraya demirli.\n"
+    "    float vl = tm_view_left();\n"
+    "    float vb = tm_view_bottom();\n"
+    "    // Joystick AKTİVASYON ALANI: SABİT tabanın (_ar_dpad_cx/cy, sol-alt) etrafında\n"
+    "    // KÜÇÜK bir daire. Yalnız joystick'in üstüne/yakınına dokununca devreye girer —\n"
+    "    // ekranın ortasına ya da doğal konumu dışında bir yere basmak joystick OLUŞTURMAZ.\n"
+    "    // (Eskiden tüm sol-alt çeyrekti; merkeze yakın basınca da açılıyordu → düzeltildi.)\n"
+    "    float jcx = _ar_dpad_cx();\n"
+    "    float jcy = _ar_dpad_cy();\n"
+    "    float jgr = baseR * 1.6;             // dokunması kolay olsun diye ring + biraz pay\n"
+    "    float jgr2 = jgr * jgr;\n"
+    "\n"
+    "    // Etkin şema + hareket kontrolü açık mı (elle seçim reads'i beklemez).\n"
+    "    int sc = _ar_scheme_now();\n"
+    "    bool mv_on = sc != 5 && (_ar_wants_move || _ar_scheme > 0);\n"
+    "\n"
+    "    // Eğim (tilt) şeması: ivmeölçerden yön türet (dokunma parmağı gerekmez).\n"
+    "    // Yön NÖTR tutuştan SAPMAYLA ölçülür (yukarıdaki kalibrasyon notu) → cihaz\n"
+    "    // yönelimi fark etmez. Sağ/sol = accel_y sapması, yukarı/aşağı = accel_x\n"
+    "    // sapması. Sensör yoksa (masaüstü) sessiz geçilir → klavye zaten çalışır.\n"
+    "    if (sc == 6 && tm_accel_available()) {\n"
+    "        float axv = tm_accel_x();\n"
+    "        float ayv = tm_accel_y();\n"
+    "        if (!_ar_tilt_cal) {\n"
+    "            _ar_tilt_ax0 = axv; _ar_tilt_ay0 = ayv; _ar_tilt_cal = true;\n"
+    "        }\n"
+    "        float dx = axv - _ar_tilt_ax0;\n"
+    "        float dy = ayv - _ar_tilt_ay0;\n"
+    "        if (dy < 0.0 - _ar_tilt_thr) { _ar_td_left = true; }\n"
+    "        if (dy > _ar_tilt_thr)       { _ar_td_right = true; }\n"
+    "        if (dx > _ar_tilt_thr)       { _ar_td_up = true; }\n"
+    "        if (dx < 0.0 - _ar_tilt_thr) { _ar_td_down = true; }\n"
+    "    }\n"
+    "\n"
+    "    // Yön BUTONU merkezleri (dpad/yatay/dikey şemaları) — sol-alt köşe.\n"
+    "    float bR  = _ar_btn_r();\n"
+    "    float bgr = bR * 1.55;               // buton yakalama payı (erişilebilirlik: cömert)\n"
+    "    float blx = 0.0; float bly = 0.0;    // sol ◀\n"
+    "    float brx = 0.0; float bry = 0.0;    // sağ ▶\n"
+    "    float bux = 0.0; float buy = 0.0;    // yukarı ▲\n"
+    "    float bdx = 0.0; float bdy = 0.0;    // aşağı ▼\n"
+    "    bool has_lr = false;\n"
+    "    bool has_ud = false;\n"
+    "    if (sc == 3) {                       // yatay: ◀ ▶ yan yana\n"
+    "        blx = vl + bR * 1.5;  bly = vb - bR * 1.5;\n"
+    "        brx = blx + bR * 2.6;  bry = bly;\n"
+    "        has_lr = true;\n"
+    "    } else if (sc == 4) {                // dikey: ▲ üstte, ▼ altta\n"
+    "        bdx = vl + bR * 1.5;  bdy = vb - bR * 1.5;\n"
+    "        bux = bdx;  buy = bdy - bR * 2.6;\n"
+    "        has_ud = true;\n"
+    "    } else if (sc == 2) {                // dpad: 4 buton artı-düzeni\n"
+    "        float dpcx = vl + bR * 2.8;  float dpcy = vb - bR * 2.8;\n"
+    "        float dpoff = bR * 1.75;\n"
+    "        blx = dpcx - dpoff;  bly = dpcy;\n"
+    "        brx = dpcx + dpoff;  bry = dpcy;\n"
+    "        bux = dpcx;  buy = dpcy - dpoff;\n"
+    "        bdx = dpcx;  bdy = dpcy + dpoff;\n"
+    "        has_lr = true;  has_ud = true;\n"
+    "    }\n"
+    "\n"
+    "    // Parmakları sınıflandır: aksiyon butonu / joystick adayı / yön butonları.\n"
+    "    int joy_i = 0 - 1;\n"
+    "    float best = 0.0;\n"
+    "    bool have_best = false;\n"
+    "    int i = 0;\n"
+    "    while (i < n) {\n"
+    "        float tx = touch_x(i) * 1.0;\n"
+    "        float ty = touch_y(i) * 1.0;\n"
+    "        float adx = tx - acx; float ady = ty - acy;\n"
+    "        // Erişilebilirlik: dokunma toleransı görünenden büyük (ar*1.3) — kolay bas.\n"
+    "        if (_ar_wants_action && adx * adx + ady * ady <= ar * 1.3 * ar * 1.3) {\n"
+    "            _ar_act_now = true;\n"
+    "        } else if (mv_on && sc == 1\n"
+    "                   && (tx - jcx) * (tx - jcx) + (ty - jcy) * (ty - jcy) <= jgr2) {\n"
+    "            float d2 = 0.0;\n"
+    "            if (_ar_joy_on) {\n"
+    "                float bx = tx - _ar_joy_bx; float by = ty - _ar_joy_by;\n"
+    "                d2 = bx * bx + by * by;\n"
+    "            }\n"
+    "            if (!have_best || d2 < best) { best = d2; joy_i = i; have_best = true; }\n"
+    "        } else if (mv_on) {\n"
+    "            // Yön butonları: dokunulan butonun yönünü bu kare işaretle.\n"
+    "            if (has_lr) {\n"
+    "                float lx = tx - blx; float ly = ty - bly;\n"
+    "                if (lx * lx + ly * ly <= bgr * bgr) { _ar_td_left = true; }\n"
+    "                float rx2 = tx - brx; float ry2 = ty - bry;\n"
+    "                if (rx2 * rx2 + ry2 * ry2 <= bgr * bgr) { _ar_td_right = true; }\n"
+    "            }\n"
+    "            if (has_ud) {\n"
+    "                float ux = tx - bux; float uy = ty - buy;\n"
+    "                if (ux * ux + uy * uy <= bgr * bgr) { _ar_td_up = true; }\n"
+    "                float dx2 = tx - bdx; float dy2 = ty - bdy;\n"
+    "                if (dx2 * dx2 + dy2 * dy2 <= bgr * bgr) { _ar_td_down = true; }\n"
+    "            }\n"
+    "        }\n"
+    "        i = i + 1;\n"
+    "    }\n"
+    "\n"
+    "    if (joy_i >= 0) {\n"
+    "        float tx = touch_x(joy_i) * 1.0;\n"
+    "        float ty = touch_y(joy_i) * 1.0;\n"
+    "        // Taban tamamen SABİT: sol-alt köşede demirli (parmakla GEZMEZ, parmağın\n"
+    "        // altında DOĞMAZ). Böylece oyuncu karakteri sürerken eli ekranın ortasına\n"
+    "        // kaymaz → görüşü kapanmaz. Yön, sabit merkezden parmağın sapmasıyla okunur.\n"
+    "        _ar_joy_bx = _ar_dpad_cx();\n"
+    "        _ar_joy_by = _ar_dpad_cy();\n"
+    "        _ar_joy_on = true;\n"
+    "        float ox = tx - _ar_joy_bx; float oy = ty - _ar_joy_by;\n"
+    "        float mag = sqrt(ox * ox + oy * oy);\n"
+    "        if (mag > baseR) {               // topuz halkanın dışına çıkamaz\n"
+    "            float k = baseR / mag;\n"
+    "            ox = ox * k; oy = oy * k;\n"
+    "            mag = baseR;\n"
+    "        }\n"
+    "        _ar_joy_kx = _ar_joy_bx + ox;\n"
+    "        _ar_joy_ky = _ar_joy_by + oy;\n"
+    "        _ar_joy_dx = ox / baseR;         // analog yön [-1..1]\n"
+    "        _ar_joy_dy = oy / baseR;\n"
+    "        float dz = 0.16;                 // ölü bölge — küçük; parmak eşiğini erken aşsın (daha tepkisel)\n"
+    "        if (_ar_joy_dx < 0.0 - dz) { _ar_td_left = true; }\n"
+    "        if (_ar_joy_dx > dz)       { _ar_td_right = true; }\n"
+    "        if (_ar_joy_dy < 0.0 - dz) { _ar_td_up = true; }\n"
+    "        if (_ar_joy_dy > dz)       { _ar_td_down = true; }\n"
+    "    } else {\n"
+    "        _ar_joy_on = false;              // parmak çekildi → nötr\n"
+    "    }\n"
+    "\n"
+    "    _ar_act_edge = _ar_act_now && !_ar_act_prev;\n"
+    "    _ar_act_prev = _ar_act_now;\n"
+    "\n"
+    "    // Swipe izleme (parmak 0): inişte başlangıç, sürerken son konum, kalkışta\n"
+    "    // vektör sınıflandırması. Eşik: dünya yüksekliğinin %10'u.\n"
+    "    _ar_swipe = 0;\n"
+    "    if (n > 0) {\n"
+    "        if (_ar_touch_prevn == 0) {\n"
+    "            _ar_sw_x0 = touch_x(0) * 1.0; _ar_sw_y0 = touch_y(0) * 1.0;\n"
+    "        }\n"
+    "        _ar_sw_x1 = touch_x(0) * 1.0; _ar_sw_y1 = touch_y(0) * 1.0;\n"
+    "    } else if (_ar_touch_prevn > 0) {\n"
+    "        float swdx = _ar_sw_x1 - _ar_sw_x0;\n"
+    "        float swdy = _ar_sw_y1 - _ar_sw_y0;\n"
+    "        float swax = swdx; if (swax < 0.0) { swax = 0.0 - swax; }\n"
+    "        float sway = swdy; if (sway < 0.0) { sway = 0.0 - sway; }\n"
+    "        float swthr = _world_h * 0.10;\n"
+    "        if (swax > sway && swax >= swthr) {\n"
+    "            if (swdx < 0.0) { _ar_swipe = 1; } else { _ar_swipe = 2; }\n"
+    "        } else if (sway > swax && sway >= swthr) {\n"
+    "            if (swdy < 0.0) { _ar_swipe = 3; } else { _ar_swipe = 4; }\n"
+    "        }\n"
+    "    }\n"
+    "\n"
+    "    _ar_tap_edge = (n > 0) && (_ar_touch_prevn == 0);\n"
+    "    _ar_touch_prevn = n;\n"
+    "}\n"
+    "\n"
+    "// Klavye + dokunma birleşik girdi — movement presetleri bunları kullanır.\n"
+    "// İlk çağrı `_ar_wants_move`'u işaretler → joystick yalnız yön okuyan oyunlarda çizilir.\n"
+    "func _ar_in_left(): bool  { _ar_wants_move = true; _ar_rd_l = true; return key_down(\"LEFT\")  || key_down(\"A\") || _ar_td_left; }\n"
+    "func _ar_in_right(): bool { _ar_wants_move = true; _ar_rd_r = true; return key_down(\"RIGHT\") || key_down(\"D\") || _ar_td_right; }\n"
+    "func _ar_in_up(): bool    { _ar_wants_move = true; _ar_rd_u = true; return key_down(\"UP\")    || key_down(\"W\") || _ar_td_up; }\n"
+    "func _ar_in_down(): bool  { _ar_wants_move = true; _ar_rd_d = true; return key_down(\"DOWN\")  || key_down(\"S\") || _ar_td_down; }\n"
+    "\n"
+    "// Etkin şema çözümü: elle seçildiyse o; auto ise oyunun okuduğu yönlerden.\n"
+    "func _ar_scheme_now(): int {\n"
+    "    if (_ar_scheme != 0) { return _ar_scheme; }\n"
+    "    bool lr = _ar_rd_l || _ar_rd_r;\n"
+    "    bool ud = _ar_rd_u || _ar_rd_d;\n"
+    "    if (lr && ud)  { return 1; }   // iki eksen → joystick\n"
+    "    if (lr)        { return 3; }   // yalnız sağ/sol → yatay butonlar\n"
+    "    if (ud)        { return 4; }   // yalnız yukarı/aşağı → dikey butonlar\n"
+    "    return 5;                      // yön okunmuyor → hareket kontrolü yok\n"
+    "}\n"
+    "\n"
+    "// Dokunmatik kontrol şemasını elle seç (TR+EN dize):\n"
+    "//   \"auto\"/\"oto\" (varsayılan) | \"joystick\" | \"dpad\"/\"yon4\" | \"yatay\"/\"horizontal\"\n"
+    "//   | \"dikey\"/\"vertical\" | \"yok\"/\"none\"\n"
+    "func kontrol_semasi(s) {\n"
+    "    if (s == \"joystick\")                        { _ar_scheme = 1; }\n"
+    "    else if (s == \"dpad\" || s == \"yon4\")        { _ar_scheme = 2; }\n"
+    "    else if (s == \"yatay\" || s == \"horizontal\") { _ar_scheme = 3; }\n"
+    "    else if (s == \"dikey\" || s == \"vertical\")   { _ar_scheme = 4; }\n"
+    "    else if (s == \"yok\" || s == \"none\")         { _ar_scheme = 5; }\n"
+    "    else if (s == \"egim\" || s == \"tilt\")        { _ar_scheme = 6; }\n"
+    "    else                                        { _ar_scheme = 0; }\n"
+    "}\n"
+    "func control_scheme(s) { kontrol_semasi(s); }\n"
+    "\n"
+    "// Yön butonu yarıçapı (dpad/yatay/dikey şemaları)\n"
+    "func _ar_btn_r(): float { return _world_h * 0.105; }\n"
+    "\n"
+    "// ---- Herkese açık yön okuma (klavye VEYA joystick) --------------------------\n"
+    "// Elle hareket süren oyunlar (raket/gemi/kuş...) `key_down(\"LEFT\")` yerine\n"
+    "// bunları kullanırsa dokunmatik joystick de çalışır — ve joystick yalnız bu\n"
+    "// okumaları yapan oyunlarda görünür. TR + EN alias.\n"
+    "func left(): bool   { return _ar_in_left(); }\n"
+    "func sol(): bool    { return _ar_in_left(); }\n"
+    "func right(): bool  { return _ar_in_right(); }\n"
+    "func sag(): bool    { return _ar_in_right(); }\n"
+    "func up(): bool     { return _ar_in_up(); }\n"
+    "func yukari(): bool { return _ar_in_up(); }\n"
+    "func down(): bool   { return _ar_in_down(); }\n"
+    "func asagi(): bool  { return _ar_in_down(); }\n"
+    "// Zıplama: klavye edge VEYA aksiyon butonu edge.\n"
+    "func _ar_in_jump(): bool  { _ar_wants_action = true; return key_pressed(\"SPACE\") || key_pressed(\"UP\") || key_pressed(\"W\") || _ar_act_edge; }\n"
+    "\n"
+    "// ---- Herkese açık: aksiyon butonu (ateş/etkileşim; nişancı oyunları için) ----\n"
+    "// Oyun kodunda `key_pressed(\"SPACE\")` yerine `action_pressed()` kullanılırsa\n"
+    "// hem klavye hem dokunma çalışır. action_held(): basılı tutuluyor mu.\n"
+    "func action_pressed(): bool { _ar_wants_action = true; return _ar_act_edge; }\n"
+    "func aksiyon_basildi(): bool { _ar_wants_action = true; return _ar_act_edge; }\n"
+    "func action_held(): bool    { _ar_wants_action = true; return _ar_act_now; }\n"
+    "func aksiyon_basili(): bool  { _ar_wants_action = true; return _ar_act_now; }\n"
+    "\n"
+    "// Ateş/zıpla için birleşik edge: SPACE/UP klavye VEYA aksiyon butonu. Nişancı\n"
+    "// oyunları `key_pressed(\"SPACE\")` yerine bunu kullanırsa dokunmatikte de ateş eder.\n"
+    "func fire_pressed(): bool  { _ar_wants_action = true; return key_pressed(\"SPACE\") || key_pressed(\"UP\") || _ar_act_edge; }\n"
+    "func ates_basildi(): bool  { return fire_pressed(); }\n"
+    "\n"
+    "// Ekranın HERHANGİ bir yerine bu kare yeni dokunuldu mu (parmak 0 → >0 kenarı).\n"
+    "// Sadece-dokunma oyunları (flappy tarzı) bunu okur: buton/joystick GEREKMEZ,\n"
+    "// hiçbir kontrol çizilmez — \"ekrana tıkla\" oyunun kendisidir.\n"
+    "func dokunuldu(): bool { return _ar_tap_edge; }\n"
+    "func tapped(): bool    { return _ar_tap_edge; }\n"
+    "\n"
+    "// Kaydırma jesti: parmak KALKTIĞI kare yönü bildirir. Yön adı TR ya da EN:\n"
+    "// \"sol\"/\"left\", \"sag\"/\"right\", \"yukari\"/\"up\", \"asagi\"/\"down\". Yılan tarzı\n"
+    "// oyunlar buton/joystick çizdirmeden jestle oynanır.\n"
+    "func kaydirildi(yon): bool {\n"
+    "    if (_ar_swipe == 1) { return yon == \"sol\" || yon == \"left\"; }\n"
+    "    if (_ar_swipe == 2) { return yon == \"sag\" || yon == \"right\"; }\n"
+    "    if (_ar_swipe == 3) { return yon == \"yukari\" || yon == \"up\"; }\n"
+    "    if (_ar_swipe == 4) { return yon == \"asagi\" || yon == \"down\"; }\n"
+    "    return false;\n"
+    "}\n"
+    "func swiped(dir): bool { return kaydirildi(dir); }\n"
+    "\n"
+    "// Dokunmatik overlay'i zorla aç/kapat (varsayılan: ilk dokunuşta otomatik).\n"
+    "func touch_controls(on)   { _ar_touch_force = on; _ar_touch_ui = on; }\n"
+    "func dokunma_kontrol(on)  { touch_controls(on); }\n"
+    "\n"
+    "// Dokunmatik overlay: DİNAMİK analog joystick (yuvarlak içinde yuvarlak) + —\n"
+    "// sadece oyun kullanıyorsa— sağ alt aksiyon butonu. Boşta joystick hayalet gibi\n"
+    "// varsayılan konumda soluk durur; parmak basınca tabanı orada belirir ve topuz\n"
+    "// parmağı takip eder. Yarı-saydam (rgba) — oyunu kapatmaz.\n"
+    "func _ar_draw_touch_ui() {\n"
+    "    float baseR = _ar_dpad_r();\n"
+    "    float knobR = baseR * 0.5;\n"
+    "    int hot = rgba(255, 255, 255, 225);\n"
+    "    int dim = rgba(255, 255, 255, 90);\n"
+    "\n"
+    "    // Hareket kontrolü — etkin şemaya göre joystick YA DA yön butonları.\n"
+    "    int sc = _ar_scheme_now();\n"
+    "    bool mv_on = sc != 5 && (_ar_wants_move || _ar_scheme > 0);\n"
+    "    if (mv_on && sc == 1) {\n"
+    "        float bx = _ar_dpad_cx(); float by = _ar_dpad_cy();  // boşta hayalet konumu\n"
+    "        float kx = bx; float ky = by;\n"
+    "        if (_ar_joy_on) { bx = _ar_joy_bx; by = _ar_joy_by; kx = _ar_joy_kx; ky = _ar_joy_ky; }\n"
+    "\n"
+    "        // dış halka (taban) + iç topuz\n"
+    "        circle(toInt(bx), toInt(by), toInt(baseR),\n"
+    "               _ar_joy_on ? rgba(210, 220, 255, 70) : rgba(210, 214, 230, 40));\n"
+    "        circle(toInt(kx), toInt(ky), toInt(knobR), _ar_joy_on ? hot : dim);\n"
+    "    } else if (mv_on && sc != 1) {\n"
+    "        // Yön butonları — merkezler _ar_read_touch ile AYNI formüller\n"
+    "        // (gerçek ekran kenarına demirli).\n"
+    "        float bR = _ar_btn_r();\n"
+    "        float vl = tm_view_left();\n"
+    "        float vb = tm_view_bottom();\n"
+    "        float ta = bR * 0.5;    // ok ucu uzaklığı\n"
+    "        float tb = bR * 0.3;    // ok tabanı yarısı\n"
+    "        int cOff = rgba(210, 214, 230, 45);\n"
+    "        int cOn  = rgba(210, 220, 255, 120);\n"
+    "        if (sc == 3 || sc == 2) {\n"
+    "            float blx = 0.0; float bly = 0.0; float brx = 0.0; float bry = 0.0;\n"
+    "            if (sc == 3) {\n"
+    "                blx = vl + bR * 1.5;  bly = vb - bR * 1.5;\n"
+    "                brx = blx + bR * 2.6;  bry = bly;\n"
+    "            } else {\n"
+    "                blx = vl + bR * 2.8 - bR * 1.75;  bly = vb - bR * 2.8;\n"
+    "                brx = vl + bR * 2.8 + bR * 1.75;  bry = bly;\n"
+    "            }\n"
+    "            circle(toInt(blx), toInt(bly), toInt(bR), _ar_td_left ? cOn : cOff);\n"
+    "            triangle(blx - ta, bly, blx + tb, bly - tb, blx + tb, bly + tb,\n"
+    "                     _ar_td_left ? hot : dim);\n"
+    "            circle(toInt(brx), toInt(bry), toInt(bR), _ar_td_right ? cOn : cOff);\n"
+    "            triangle(brx + ta, bry, brx - tb, bry - tb, brx - tb, bry + tb,\n"
+    "                     _ar_td_right ? hot : dim);\n"
+    "        }\n"
+    "        if (sc == 4 || sc == 2) {\n"
+    "            float bux = 0.0; float buy = 0.0; float bdx = 0.0; float bdy = 0.0;\n"
+    "            if (sc == 4) {\n"
+    "                bdx = vl + bR * 1.5;  bdy = vb - bR * 1.5;\n"
+    "                bux = bdx;  buy = bdy - bR * 2.6;\n"
+    "            } else {\n"
+    "                bux = vl + bR * 2.8;  buy = vb - bR * 2.8 - bR * 1.75;\n"
+    "                bdx = vl + bR * 2.8;  bdy = vb - bR * 2.8 + bR * 1.75;\n"
+    "            }\n"
+    "            circle(toInt(bux), toInt(buy), toInt(bR), _ar_td_up ? cOn : cOff);\n"
+    "            triangle(bux, buy - ta, bux - tb, buy + tb, bux + tb, buy + tb,\n"
+    "                     _ar_td_up ? hot : dim);\n"
+    "            circle(toInt(bdx), toInt(bdy), toInt(bR), _ar_td_down ? cOn : cOff);\n"
+    "            triangle(bdx, bdy + ta, bdx - tb, bdy - tb, bdx + tb, bdy - tb,\n"
+    "                     _ar_td_down ? hot : dim);\n"
+    "        }\n"
+    "    }\n"
+    "\n"
+    "    // aksiyon butonu — yalnızca oyun onu okuyorsa\n"
+    "    if (_ar_wants_action) {\n"
+    "        float acx = _ar_act_cx(); float acy = _ar_act_cy(); float ar = _ar_act_r();\n"
+    "        circle(toInt(acx), toInt(acy), toInt(ar),\n"
+    "               _ar_act_now ? rgba(255, 130, 120, 200) : rgba(230, 120, 110, 70));\n"
+    "        circle(toInt(acx), toInt(acy), toInt(ar * 0.5),\n"
+    "               _ar_act_now ? hot : dim);\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "func _ar_update() {\n"
+    "    _ar_read_touch();\n"
+    "    float dt = frame_time();\n"
+    "    // Headless/ilk kare 0 gelirse sabit adım kullan.\n"
+    "    if (dt <= 0.0) { dt = 0.0166667; }\n"
+    "    // İlk kare / takılma sonrası büyük dt platform arasından tünelleme yapabilir\n"
+    "    // (cisim tek karede platformu atlar) — sınırla.\n"
+    "    if (dt > 0.05) { dt = 0.05; }\n"
+    "\n"
+    "    // Efektler oyun-bitti ekranında da akmaya devam eder (son patlama donmasın).\n"
+    "    _fx_update(dt);\n"
+    "\n"
+    "    // Oyun bitti (1) ya da kazandın (2): fizik durur. Yeniden başlatma/menü\n"
+    "    // ARTIK ekrana gelişigüzel dokunmayla DEĞİL, oyun-bitti ekranındaki\n"
+    "    // \"Tekrar Oyna\" / \"Ana Menu\" butonlarıyla (_ar_over_step, döngüde ele alınır).\n"
+    "    if (_ar_state != 0) {\n"
+    "        return;\n"
+    "    }\n"
+    "\n"
+    "    if (_banner_t > 0.0) { _banner_t = _banner_t - dt; }\n"
+    "\n"
+    "    _ar_apply_movement(dt);\n"
+    "    _ar_collisions();\n"
+    "\n"
+    "    if (_has_frame) { call(_frame_fn); }\n"
+    "\n"
+    "    // Bekleyen bölüm geçişini burada uygula — çarpışma/kare callback'leri bitti,\n"
+    "    // artık paralel dizileri değiştirmek güvenli.\n"
+    "    if (_lvl_pending == 1) { _lvl_pending = 0; _ar_advance_level(); }\n"
+    "}\n"
+    "\n"
+    "// Hareket presetlerini uygula + konumu entegre et.\n"
+    "//\n"
+    "// Entity index'i GLOBAL `_ar_i`'de tutulur; duvar çözümü (`_ar_resolve_walls`)\n"
+    "// da bu global index üzerinden okur/yazar. (Tasarım tercihi — çarpışma\n"
+    "// callback'lerinin me()/other() global context deseniyle tutarlı.) Konum\n"
+    "// entegre edilip sonra katı duvarlardan MTV ile çözülür.\n"
+    "func _ar_apply_movement(dt) {\n"
+    "    for (_ar_i = 0; _ar_i < _n; _ar_i = _ar_i + 1) {\n"
+    "        if (_ealive[_ar_i] == 0) { continue; }\n"
+    "        int mv = _emove[_ar_i];\n"
+    "\n"
+    "        if (mv == MV_TOPDOWN) {\n"
+    "            float s = _espeed[_ar_i];\n"
+    "            float vx = 0.0;\n"
+    "            float vy = 0.0;\n"
+    "            if (_ar_in_left())  { vx = vx - s; }\n"
+    "            if (_ar_in_right()) { vx = vx + s; }\n"
+    "            if (_ar_in_up())    { vy = vy - s; }\n"
+    "            if (_ar_in_down())  { vy = vy + s; }\n"
+    "            // Çapraz normalizasyonu: iki eksen de aktifken (vx,vy) büyüklüğü s·√2\n"
+    "            // olur → çapraz %41 daha hızlı. Her ikisini 1/√2 ile ölçekle ki\n"
+    "            // çapraz hız da tam s olsun (düz/çapraz aynı hız).\n"
+    "            if (vx != 0.0 && vy != 0.0) {\n"
+    "                vx = vx * 0.70710678;\n"
+    "                vy = vy * 0.70710678;\n"
+    "            }\n"
+    "            _evx[_ar_i] = vx;\n"
+    "            _evy[_ar_i] = vy;\n"
+    "            _ex[_ar_i] = _ex[_ar_i] + vx * dt;\n"
+    "            _ey[_ar_i] = _ey[_ar_i] + vy * dt;\n"
+    "            _ar_resolve_walls();            // katı duvarlardan MTV ile it\n"
+    "            // Dünya sınırına kıstır\n"
+    "            if (_clamp_world) {\n"
+    "                if (_ex[_ar_i] < 0.0) { _ex[_ar_i] = 0.0; }\n"
+    "                if (_ey[_ar_i] < 0.0) { _ey[_ar_i] = 0.0; }\n"
+    "                float mxt = _world_w - _ew[_ar_i];\n"
+    "                float myt = _world_h - _eh[_ar_i];\n"
+    "                if (_ex[_ar_i] > mxt) { _ex[_ar_i] = mxt; }\n"
+    "                if (_ey[_ar_i] > myt) { _ey[_ar_i] = myt; }\n"
+    "            }\n"
+    "        } else if (mv == MV_PLATFORM) {\n"
+    "            float s = _espeed[_ar_i];\n"
+    "            float vx = 0.0;\n"
+    "            if (_ar_in_left())  { vx = vx - s; }\n"
+    "            if (_ar_in_right()) { vx = vx + s; }\n"
+    "            _evx[_ar_i] = vx;\n"
+    "            // Yerçekimi\n"
+    "            _evy[_ar_i] = _evy[_ar_i] + _gravity * dt;\n"
+    "            // Zıplama (zemindeyken)\n"
+    "            if (_eground[_ar_i] == 1) {\n"
+    "                if (_ar_in_jump()) {\n"
+    "                    _evy[_ar_i] = 0.0 - _jump_v;\n"
+    "                    _eground[_ar_i] = 0;\n"
+    "                }\n"
+    "            }\n"
+    "            _eground[_ar_i] = 0;\n"
+    "            // X ve Y ilerle, sonra katı duvarlardan MTV ile çöz (iniş/tavan/yan).\n"
+    "            _ex[_ar_i] = _ex[_ar_i] + _evx[_ar_i] * dt;\n"
+    "            _ey[_ar_i] = _ey[_ar_i] + _evy[_ar_i] * dt;\n"
+    "            _ar_resolve_walls();\n"
+    "            // Dünya sınırları: zemin (grounded), yanlar, tavan\n"
+    "            float floor_y = _world_h - _eh[_ar_i];\n"
+    "            if (_ey[_ar_i] >= floor_y) {\n"
+    "                _ey[_ar_i] = floor_y;\n"
+    "                _evy[_ar_i] = 0.0;\n"
+    "                _eground[_ar_i] = 1;\n"
+    "            }\n"
+    "            if (_ey[_ar_i] < 0.0) { _ey[_ar_i] = 0.0; _evy[_ar_i] = 0.0; }\n"
+    "            if (_ex[_ar_i] < 0.0) { _ex[_ar_i] = 0.0; }\n"
+    "            float mxp = _world_w - _ew[_ar_i];\n"
+    "            if (_ex[_ar_i] > mxp) { _ex[_ar_i] = mxp; }\n"
+    "        } else if (mv == MV_VELOCITY) {\n"
+    "            _ex[_ar_i] = _ex[_ar_i] + _evx[_ar_i] * dt;\n"
+    "            _ey[_ar_i] = _ey[_ar_i] + _evy[_ar_i] * dt;\n"
+    "            // Dünyanın dışına 64px taşan velocity entity'lerini (mermi/engel)\n"
+    "            // otomatik öldür — slot boş yığına döner ve yeniden kullanılır.\n"
+    "            if (_ex[_ar_i] < 0.0 - 64.0 || _ex[_ar_i] > _world_w + 64.0 ||\n"
+    "                _ey[_ar_i] < 0.0 - 64.0 || _ey[_ar_i] > _world_h + 64.0) {\n"
+    "                _kill_slot(_ar_i);\n"
+    "            }\n"
+    "        }\n"
+    "        // MV_NONE: kullanıcı sürer.\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Güncel entity'yi (global _ar_i) tüm katı TAG_WALL entity'lerinden iterek çöz.\n"
+    "// MTV (minimum translation vector): her çakışan duvar için X ve Y penetrasyon\n"
+    "// derinliklerini ölç, DAHA SIĞ eksende it. Bu, üstünde durulan platforma minik\n"
+    "// dikey batmanın yanlışlıkla YATAY itmeye (cismi platform kenarına ışınlama)\n"
+    "// dönüşmesini önler — eksen-ayrık yaklaşımın klasik \"zemin platformunda sağa\n"
+    "// gidememe\" bug'ının doğru çözümü. Yukarı iten (üste oturan) durum grounded.\n"
+    "func _ar_resolve_walls() {\n"
+    "    for (int w = 0; w < _n; w = w + 1) {\n"
+    "        if (_ealive[w] == 0) { continue; }\n"
+    "        if (_etag[w] != TAG_WALL) { continue; }\n"
+    "\n"
+    "        float px = _ex[_ar_i];  float py = _ey[_ar_i];\n"
+    "        float pw = _ew[_ar_i];  float ph = _eh[_ar_i];\n"
+    "        float wx = _ex[w];      float wy = _ey[w];\n"
+    "        float ww = _ew[w];      float wh = _eh[w];\n"
+    "\n"
+    "        // Çakışma yoksa geç.\n"
+    "        if (px + pw <= wx) { continue; }\n"
+    "        if (wx + ww <= px) { continue; }\n"
+    "        if (py + ph <= wy) { continue; }\n"
+    "        if (wy + wh <= py) { continue; }\n"
+    "\n"
+    "        // X penetrasyonu = kesişimin genişliği.\n"
+    "        float rx = px + pw;  if (wx + ww < rx) { rx = wx + ww; }\n"
+    "        float lx = px;       if (wx > lx)      { lx = wx; }\n"
+    "        float ox = rx - lx;\n"
+    "        // Y penetrasyonu = kesişimin yüksekliği.\n"
+    "        float ry = py + ph;  if (wy + wh < ry) { ry = wy + wh; }\n"
+    "        float ly = py;       if (wy > ly)      { ly = wy; }\n"
+    "        float oy = ry - ly;\n"
+    "\n"
+    "        if (ox < oy) {\n"
+    "            // Yatay it — hangi tarafa yakınsa oraya.\n"
+    "            float pcx = px + pw * 0.5;\n"
+    "            float wcx = wx + ww * 0.5;\n"
+    "            if (pcx < wcx) { _ex[_ar_i] = wx - pw; }   // duvarın soluna\n"
+    "            else { _ex[_ar_i] = wx + ww; }             // duvarın sağına\n"
+    "        } else {\n"
+    "            // Dikey it.\n"
+    "            float pcy = py + ph * 0.5;\n"
+    "            float wcy = wy + wh * 0.5;\n"
+    "            if (pcy < wcy) {\n"
+    "                _ey[_ar_i] = wy - ph;                  // üstüne otur\n"
+    "                _evy[_ar_i] = 0.0;\n"
+    "                _eground[_ar_i] = 1;\n"
+    "            } else {\n"
+    "                _ey[_ar_i] = wy + wh;                  // altına (tavan)\n"
+    "                _evy[_ar_i] = 0.0;\n"
+    "            }\n"
+    "        }\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Tüm canlı çiftler için çarpışma kurallarını değerlendir + callback tetikle.\n"
+    "func _ar_collisions() {\n"
+    "    int rules = length(_ca);\n"
+    "    if (rules == 0) { return; }\n"
+    "\n"
+    "    for (int a = 0; a < _n; a = a + 1) {\n"
+    "        if (_ealive[a] == 0) { continue; }\n"
+    "        for (int b = a + 1; b < _n; b = b + 1) {\n"
+    "            if (_ealive[b] == 0) { continue; }\n"
+    "            if (!rect_overlap(_ex[a], _ey[a], _ew[a], _eh[a], _ex[b], _ey[b], _ew[b], _eh[b])) { continue; }\n"
+    "\n"
+    "            int ta = _etag[a];\n"
+    "            int tb = _etag[b];\n"
+    "            for (int r = 0; r < rules; r = r + 1) {\n"
+    "                // İleri yön: kural (ca,cb) == (ta,tb)\n"
+    "                if (_ca[r] == ta && _cb[r] == tb) {\n"
+    "                    _hit_self = a; _hit_other = b;\n"
+    "                    call(_cfn[r]);\n"
+    "                }\n"
+    "                // Simetrik: kural (ca,cb) == (tb,ta)\n"
+    "                else if (_ca[r] == tb && _cb[r] == ta) {\n"
+    "                    _hit_self = b; _hit_other = a;\n"
+    "                    call(_cfn[r]);\n"
+    "                }\n"
+    "            }\n"
+    "        }\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Tek kare mantığı — HEADLESS TEST için (pencere/çizim olmadan advance).\n"
+    "// dt saniye. Testler bunu doğrudan çağırır.\n"
+    "func step(dt) {\n"
+    "    if (_ar_state != 0) { return; }\n"
+    "    _fx_update(dt * 1.0);\n"
+    "    if (_banner_t > 0.0) { _banner_t = _banner_t - dt * 1.0; }\n"
+    "    _ar_apply_movement(dt * 1.0);\n"
+    "    _ar_collisions();\n"
+    "    if (_has_frame) { call(_frame_fn); }\n"
+    "    if (_lvl_pending == 1) { _lvl_pending = 0; _ar_advance_level(); }\n"
+    "}\n"
+    "func adim(dt) { step(dt); }\n"
+    "\n"
+    "// ============================================================================\n"
+    "//  MOTOR İÇİ — çizim\n"
+    "// ============================================================================\n"
+    "\n"
+    "// Global tablo (oyun-bitti/kazandın ekranında, çekilebildiyse) — top-4.\n"
+    "func _lb_draw() {\n"
+    "    if (!_lb_has) { return; }\n"
+    "    str L = _lang_now();\n"
+    "    str t = \"Global Tablo\";\n"
+    "    if (L == \"en\") { t = \"Global Top\"; }\n"
+    "    int y0 = toInt(screen_height() * 0.50);\n"
+    "    text(t, toInt((screen_width() - measure_text(t, 20)) / 2.0), y0, 20, SKYBLUE);\n"
+    "    int n = length(_lb_data);\n"
+    "    if (n > 4) { n = 4; }\n"
+    "    for (int i = 0; i < n; i = i + 1) {\n"
+    "        json e = _lb_data[i];\n"
+    "        str line = toString(i + 1) + \". \" + toString(e[\"isim\"]) + \"   \" + toString(e[\"skor\"]);\n"
+    "        text(line, toInt((screen_width() - measure_text(line, 18)) / 2.0),\n"
+    "             y0 + 24 + i * 20, 18, WHITE);\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// ---- Oyun-bitti / Kazandın ekranı: skor + \"Tekrar Oyna\" / \"Ana Menu\" ----------\n"
+    "// Ekrana gelişigüzel dokunmak oyunu BAŞLATMAZ; yalnız bu butonlar iş yapar.\n"
+    "func _ar_over_btn_w(): float { return _world_w * 0.30; }\n"
+    "func _ar_over_btn_h(): float { return _world_h * 0.12; }\n"
+    "func _ar_over_btn_gap(): float { return _world_w * 0.04; }\n"
+    "func _ar_over_btn_y(): float {\n"
+    "    if (_lb_has) { return _world_h * 0.82; }   // tablo varsa altına\n"
+    "    return _world_h * 0.62;\n"
+    "}\n"
+    "func _ar_over_btn_x(i): float {\n"
+    "    float bw = _ar_over_btn_w(); float gap = _ar_over_btn_gap();\n"
+    "    float sx = (_world_w - (bw * 2.0 + gap)) / 2.0;\n"
+    "    if (i == 0) { return sx; }\n"
+    "    return sx + bw + gap;\n"
+    "}\n"
+    "func _ar_over_menu_label(): str {\n"
+    "    str L = _lang_now();\n"
+    "    if (_ar_standalone) { if (L == \"en\") { return \"Quit\"; } return \"Cikis\"; }\n"
+    "    if (L == \"en\") { return \"Menu\"; }\n"
+    "    return \"Ana Menu\";\n"
+    "}\n"
+    "func _ar_over_draw_btn(i, label, fill) {\n"
+    "    float bx = _ar_over_btn_x(i); float by = _ar_over_btn_y();\n"
+    "    float bw = _ar_over_btn_w();  float bh = _ar_over_btn_h();\n"
+    "    rect(bx, by, bw, bh, fill);\n"
+    "    rect_lines(bx, by, bw, bh, GOLD);\n"
+    "    int bsz = toInt(bh * 0.32);\n"
+    "    text(label, toInt(bx + (bw - measure_text(label, bsz)) / 2.0),\n"
+    "         toInt(by + (bh - bsz * 1.0) / 2.0), bsz, WHITE);\n"
+    "}\n"
+    "\n"
+    "func _ar_draw_over() {\n"
+    "    str L = _lang_now();\n"
+    "    // Tam-ekran karartma (letterbox bantları dahil — pause örtüsüyle aynı desen)\n"
+    "    float vl = tm_view_left(); float vt = tm_view_top();\n"
+    "    float vr = tm_view_right(); float vb = tm_view_bottom();\n"
+    "    rect(vl, vt, vr - vl, vb - vt, rgba(8, 10, 16, 210));\n"
+    "\n"
+    "    bool won = (_ar_state == 2);\n"
+    "    str titl = \"OYUN BITTI\"; int tcol = RED;\n"
+    "    if (won) { titl = \"KAZANDIN\"; tcol = LIME; }\n"
+    "    if (L == \"en\") { if (won) { titl = \"YOU WIN\"; } else { titl = \"GAME OVER\"; } }\n"
+    "    int tsz = toInt(_world_h * 0.10);\n"
+    "    text(titl, toInt((_world_w - measure_text(titl, tsz)) / 2.0),\n"
+    "         toInt(_world_h * 0.15), tsz, tcol);\n"
+    "\n"
+    "    // Skor — büyük ve ortada\n"
+    "    str spre = \"Skor: \"; if (L == \"en\") { spre = \"Score: \"; }\n"
+    "    str sline = spre + toString(_score);\n"
+    "    int ssz = toInt(_world_h * 0.075);\n"
+    "    text(sline, toInt((_world_w - measure_text(sline, ssz)) / 2.0),\n"
+    "         toInt(_world_h * 0.32), ssz, WHITE);\n"
+    "\n"
+    "    // Rekor / en iyi\n"
+    "    if (_ar_title != \"\") {\n"
+    "        str bl = \"\";\n"
+    "        if (_new_record) { bl = \"YENI REKOR!\"; if (L == \"en\") { bl = \"NEW RECORD!\"; } }\n"
+    "        else if (_best > 0) {\n"
+    "            bl = \"En iyi: \" + toString(_best);\n"
+    "            if (L == \"en\") { bl = \"Best: \" + toString(_best); }\n"
+    "        }\n"
+    "        if (bl != \"\") {\n"
+    "            int rsz = toInt(_world_h * 0.05);\n"
+    "            text(bl, toInt((_world_w - measure_text(bl, rsz)) / 2.0),\n"
+    "                 toInt(_world_h * 0.43), rsz, GOLD);\n"
+    "        }\n"
+    "    }\n"
+    "\n"
+    "    _lb_draw();\n"
+    "\n"
+    "    // Butonlar\n"
+    "    str rl = \"Tekrar Oyna\"; if (L == \"en\") { rl = \"Play Again\"; }\n"
+    "    _ar_over_draw_btn(0, rl, rgb(40, 110, 70));\n"
+    "    _ar_over_draw_btn(1, _ar_over_menu_label(), rgb(70, 60, 90));\n"
+    "}\n"
+    "\n"
+    "// Oyun-bitti bir karesi: 0 = bekle, 1 = tekrar oyna, 2 = menü/çıkış.\n"
+    "func _ar_over_step(): int {\n"
+    "    if (key_pressed(\"R\") || key_pressed(\"ENTER\") || key_pressed(\"SPACE\")) { return 1; }\n"
+    "    if (key_pressed(\"ESCAPE\") || key_pressed(\"BACKSPACE\") || key_pressed(\"BACK\")) { return 2; }\n"
+    "    int act = 0;\n"
+    "    if (_ar_tap_edge) {\n"
+    "        float tx = touch_x(0) * 1.0; float ty = touch_y(0) * 1.0;\n"
+    "        float by = _ar_over_btn_y(); float bh = _ar_over_btn_h(); float bw = _ar_over_btn_w();\n"
+    "        int i = 0;\n"
+    "        while (i < 2) {\n"
+    "            float bx = _ar_over_btn_x(i);\n"
+    "            if (tx >= bx && tx <= bx + bw && ty >= by && ty <= by + bh) { act = i + 1; }\n"
+    "            i = i + 1;\n"
+    "        }\n"
+    "    }\n"
+    "    return act;\n"
+    "}\n"
+    "\n"
+    "func _ar_draw_all() {\n"
+    "    clear(rgb(18, 20, 28));\n"
+    "\n"
+    "    // Entity'ler (sarsıntı ofsetiyle — sars() aktifken tüm sahne titrer)\n"
+    "    for (int i = 0; i < _n; i = i + 1) {\n"
+    "        if (_ealive[i] == 0) { continue; }\n"
+    "        if (_esprite[i] >= 0) {\n"
+    "            draw_texture(_esprite[i], _ex[i] + _fx_ox, _ey[i] + _fx_oy);\n"
+    "        } else {\n"
+    "            rect(_ex[i] + _fx_ox, _ey[i] + _fx_oy, _ew[i], _eh[i], _ecolor[i]);\n"
+    "        }\n"
+    "    }\n"
+    "\n"
+    "    // Kullanıcı ek çizimi\n"
+    "    if (_has_draw) { call(_draw_fn); }\n"
+    "\n"
+    "    // Parçacıklar — kullanıcı çiziminin de ÜSTÜNDE (ızgara çizen oyunlarda\n"
+    "    // [yılan] parçacıklar tahtanın altında kaybolmasın)\n"
+    "    _pt_draw(_fx_ox, _fx_oy);\n"
+    "    // Uçan \"+N\" / seri baloncukları (parçacıkların üstünde)\n"
+    "    _pop_draw(_fx_ox, _fx_oy);\n"
+    "\n"
+    "    // Flash (hasar/ölüm vurgusu) — GERÇEK ekranın tamamını kaplar (bantlar\n"
+    "    // dahil); HUD'un altında ki skor okunur kalsın\n"
+    "    if (_fx_fl_t > 0.0) {\n"
+    "        float flk = 0.0;\n"
+    "        if (_fx_fl_dur > 0.0) { flk = _fx_fl_t / _fx_fl_dur; }\n"
+    "        float fvl = tm_view_left(); float fvt = tm_view_top();\n"
+    "        rect(fvl, fvt, tm_view_right() - fvl, tm_view_bottom() - fvt,\n"
+    "             rgba(255, 255, 255, toInt(150.0 * flk)));\n"
+    "    }\n"
+    "\n"
+    "    // Dokunmatik kontrol overlay'i (oynanırken, dokunma modu açıksa)\n"
+    "    if (_ar_touch_ui) {\n"
+    "        if (_ar_state == 0) { _ar_draw_touch_ui(); }\n"
+    "    }\n"
+    "\n"
+    "    // HUD skor\n"
+    "    str L = _lang_now();\n"
+    "    if (_show_score) {\n"
+    "        str pre = _hud_prefix;\n"
+    "        if (!_hud_set) { if (L == \"en\") { pre = \"Score: \"; } else { pre = \"Skor: \"; } }\n"
+    "        text(pre + toString(_score), 12, 10, 24, WHITE);\n"
+    "        // Bölüm göstergesi sağ üstte — skor (12,10) ve hint (12,38) ile çakışmaz.\n"
+    "        if (_has_levels) {\n"
+    "            str lw = \"Bolum \";\n"
+    "            if (L == \"en\") { lw = \"Level \"; }\n"
+    "            str lv = lw + toString(_cur_level) + \"/\" + toString(_level_n);\n"
+    "            text(lv, screen_width() - measure_text(lv, 20) - 12, 10, 20, GOLD);\n"
+    "        }\n"
+    "    }\n"
+    "    // Üst bilgilendirme şeridi (kontroller) — skorun altında, ekranı geçmesin\n"
+    "    // diye küçük punto ile.\n"
+    "    if (_has_hint) {\n"
+    "        text(_hint, 12, 38, 16, SKYBLUE);\n"
+    "    }\n"
+    "\n"
+    "    // FPS sayacı (Ayarlar'dan açılınca) — üst-orta, skor/bölüm/EV ile çakışmaz.\n"
+    "    if (_fps_on) {\n"
+    "        str fps = \"FPS \" + toString(tm_fps());\n"
+    "        text(fps, (screen_width() - measure_text(fps, 18)) / 2, 10, 18, rgb(120, 230, 120));\n"
+    "    }\n"
+    "\n"
+    "    // \"Bölüm N\" afişi (geçişten sonra ~1.2 sn)\n"
+    "    if (_banner_t > 0.0) {\n"
+    "        str bw = \"Bolum \";\n"
+    "        if (L == \"en\") { bw = \"Level \"; }\n"
+    "        str bn = bw + toString(_cur_level);\n"
+    "        text(bn, (screen_width() - measure_text(bn, 40)) / 2, screen_height() / 2 - 20, 40, GOLD);\n"
+    "    }\n"
+    "\n"
+    "    // Oyun bitti / Kazandın: profesyonel örtü (skor + Tekrar Oyna / Ana Menu).\n"
+    "    if (_ar_state != 0) {\n"
+    "        _ar_draw_over();\n"
+    "    }\n"
+    "\n"
+    "    // Rozet \"toast\"ı — her şeyin üstünde (oyun-bitti örtüsü dahil).\n"
+    "    _badge_draw_toast();\n"
+    "}\n"
+    "\n"
+    "// Yeni kazanılan rozetin kısa üst-orta bildirimi (~2.2 sn). tm_view_* ile gerçek\n"
+    "// ekranın üstüne demirlenir (Android kamera modelinde bantlar dahil).\n"
+    "func _badge_draw_toast() {\n"
+    "    if (_badge_toast_t <= 0.0) { return; }\n"
+    "    str L = _lang_now();\n"
+    "    str head = \"Rozet! \"; if (L == \"en\") { head = \"Badge! \"; }\n"
+    "    str msg = head + _badge_toast_txt;\n"
+    "    int fs = toInt(_world_h * 0.045);\n"
+    "    if (fs < 14) { fs = 14; }\n"
+    "    int tw = measure_text(msg, fs);\n"
+    "    float bw = tw * 1.0 + _world_h * 0.09;\n"
+    "    float bh = fs * 1.0 + _world_h * 0.05;\n"
+    "    float bx = tm_view_left() + (tm_view_right() - tm_view_left() - bw) / 2.0;\n"
+    "    float by = tm_view_top() + _world_h * 0.06;\n"
+    "    rect(bx, by, bw, bh, rgba(20, 22, 34, 235));\n"
+    "    rect_lines(bx, by, bw, bh, GOLD);\n"
+    "    text(msg, toInt(bx + (bw - tw * 1.0) / 2.0), toInt(by + (bh - fs * 1.0) / 2.0), fs, GOLD);\n"
+    "}\n"
+    "\n"
+    "// ============================================================================\n"
+    "//  LAUNCHER — tek pencerede / tek APK'da çok oyun (mobil vitrin)\n"
+    "// ============================================================================\n"
+    "// Birden çok arcade oyununu tek pencerede toplar: açılışta bir menü ızgarası\n"
+    "// çizer, bir kart seçilince (dokunma ya da klavye) o oyunun setup fn'ini çağırıp\n"
+    "// motoru o oyuna hazırlar; oyun içinde sağ-üst EV butonu (ya da ESC) menüye\n"
+    "// döndürür. Paketleme boru hattı değişmez — hâlâ tek `.tpr`, tek NativeActivity.\n"
+    "//\n"
+    "// Kullanım:\n"
+    "//   sahne(640, 480, \"Tulpar Arcade\");\n"
+    "//   oyun_ekle(\"Topla\", topla_kur);   // her oyun = 0-arg bir setup fonksiyonu\n"
+    "//   oyun_ekle(\"Kac\",   kac_kur);\n"
+    "//   launcher();                      // menü + oyun geçişi döngüsü burada\n"
+    "//\n"
+    "// Bir oyun setup fn'i, normalde top-level yazacağın kayıtları yapar AMA\n"
+    "// sahne()/oyna() ÇAĞIRMAZ (pencere + döngü launcher'ın): baslangicta(...),\n"
+    "// bolum(...), her_kare(...), carpisinca(...), bilgi(...), yercekimi(...) vb.\n"
+    "\n"
+    "array _apps_name  = [];    // menüde görünen oyun adları\n"
+    "array _apps_setup = [];    // 0-arg setup fonksiyonları (index eşleşir)\n"
+    "array _apps_best  = [];    // kalıcı en iyi skorlar (launcher açılışında yüklenir)\n"
+    "array _apps_star  = [];    // SONSUZ oyun: kalıcı yıldız 0..3 (kart pip'leri)\n"
+    "array _apps_levn  = [];    // oyunun toplam bölüm sayısı (0 = sonsuz; init'te keşfedilir)\n"
+    "array _apps_done  = [];    // tamamlanan bölüm sayısı (bölümlü oyun kart göstergesi)\n"
+    "int   _apps_n     = 0;\n"
+    "int   _ar_mode    = 0;     // 0 = menü, 1 = oyun oynanıyor\n"
+    "int   _menu_sel   = 0;     // menüde seçili kart index'i\n"
+    "str   _menu_title = \"\";    // \"\" = varsayılan (\"TULPAR ARCADE\")\n"
+    "bool  _lx_home_prev = false;\n"
+    "\n"
+    "// Oyun kaydet: ad + 0-arg setup fonksiyonu.\n"
+    "func add_game(name, setup) {\n"
+    "    push(_apps_name, name);\n"
+    "    push(_apps_setup, setup);\n"
+    "    push(_apps_best, 0);\n"
+    "    push(_apps_star, 0);\n"
+    "    push(_apps_levn, 0);\n"
+    "    push(_apps_done, 0);\n"
+    "    _apps_n = _apps_n + 1;\n"
+    "}\n"
+    "func oyun_ekle(name, setup) { add_game(name, setup); }\n"
+    "\n"
+    "// Menü başlığını değiştir (varsayılan \"TULPAR ARCADE\").\n"
+    "func launcher_title(s) { _menu_title = s; }\n"
+    "func menu_basligi(s)   { launcher_title(s); }\n"
+    "\n"
+    "// Motoru sıradaki oyuna hazırla: TÜM kayıt durumunu sıfırlar. `_ar_reset()`\n"
+    "// yalnız skor/entity/bölüm sıfırlar; oyun DEĞİŞTİRİRKEN sahne callback'leri,\n"
+    "// bölüm kayıtları, çarpışma kuralları, hint/HUD ve fizik de temizlenmeli —\n"
+    "// yoksa yeni oyun eskisinin handler'larını miras alır.\n"
+    "func _lx_clear() {\n"
+    "    _start_fn = 0; _has_start = false;\n"
+    "    _frame_fn = 0; _has_frame = false;\n"
+    "    _draw_fn  = 0; _has_draw  = false;\n"
+    "    _levels = []; _level_n = 0; _cur_level = 1; _has_levels = false;\n"
+    "    _ca = []; _cb = []; _cfn = [];\n"
+    "    _hint = \"\"; _has_hint = false;\n"
+    "    _hud_prefix = \"\"; _hud_set = false; _show_score = true;\n"
+    "    _gravity = 0.0; _jump_v = 520.0; _clamp_world = true;\n"
+    "    _banner_t = 0.0; _lvl_pending = 0;\n"
+    "    _ar_wants_action = false;          // buton görünürlüğü oyuna göre sıfırlanır\n"
+    "    _ar_wants_move = false;            // joystick görünürlüğü de oyuna göre\n"
+    "    _ar_scheme = 0;                    // kontrol şeması oyuna göre (auto'ya dön)\n"
+    "    _ar_rd_l = false; _ar_rd_r = false; _ar_rd_u = false; _ar_rd_d = false;\n"
+    "    _ar_joy_on = false; _ar_joy_dx = 0.0; _ar_joy_dy = 0.0;\n"
+    "    _ar_swipe = 0;                     // önceki oyunun jesti sızmasın\n"
+    "    _ar_tilt_cal = false;              // yeni oyun kendi nötr tutuşunu yakalar\n"
+    "    _star_g1 = 0; _star_g2 = 0; _star_g3 = 0;   // yıldız eşikleri oyuna göre\n"
+    "    _mus_gtheme = 0;                            // müzik teması oyuna göre (varsayılan)\n"
+    "    clear_entities();\n"
+    "}\n"
+    "\n"
+    "// i. oyunu başlat: kayıtları temizle → oyunun setup'ı → yükle → oyun moduna geç.\n"
+    "int _lx_sel_game = -1;   // bölüm-seçim ekranında olduğumuz oyun index'i\n"
+    "\n"
+    "// Oyunu HAZIRLA (kayıtları temizle + setup'ı çağır) — pencere/oynatma YOK.\n"
+    "// Sonrası: _level_n bilinir, _lvl_done doldurulur.\n"
+    "func _lx_prepare(i) {\n"
+    "    _lx_clear();\n"
+    "    _ar_title = _apps_name[i];         // rekor anahtarı = menüdeki oyun adı\n"
+    "    call(_apps_setup[i]);\n"
+    "    _lx_load_lvl_done(_ar_title, _level_n);\n"
+    "}\n"
+    "\n"
+    "// Hazırlanmış oyunu OYNAT (skor/durum reset + oyun moduna geç).\n"
+    "func _lx_begin_play(i) {\n"
+    "    _ar_reset();                       // _ar_start_level'e göre + _ar_load_level\n"
+    "    _menu_sel = i;\n"
+    "    _ar_mode = 1;\n"
+    "    _trans_start();                    // oyuna girişte kısa fade-in\n"
+    "    // Seçme dokunuşu (parmak hâlâ basılı) oyunun ilk karesinde restart/aksiyon\n"
+    "    // olarak sayılmasın diye edge sayaçlarını \"basılı\"ya çek.\n"
+    "    _ar_touch_prevn = touch_count();\n"
+    "    _ar_act_prev = true;\n"
+    "    _lx_home_prev = true;\n"
+    "}\n"
+    "\n"
+    "// Karta dokununca: bölümlü oyun → önce BÖLÜM SEÇİM ekranı; sonsuz oyun → doğrudan.\n"
+    "func _lx_launch(i) {\n"
+    "    if (i < 0 || i >= _apps_n) { return; }\n"
+    "    _lx_prepare(i);\n"
+    "    if (_level_n > 0) {\n"
+    "        _lx_sel_game = i;\n"
+    "        _menu_sel = i;\n"
+    "        _ar_mode = _ar_mode_levelsel;\n"
+    "        _ar_touch_prevn = touch_count();\n"
+    "    } else {\n"
+    "        _ar_start_level = 1;           // sonsuz oyun: bölüm yok\n"
+    "        _lx_begin_play(i);\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// ---- Oyun içi EV (menüye geri) butonu — GERÇEK ekranın sağ üst köşesi ------\n"
+    "func _lx_home_x(): float { return tm_view_right() - _world_h * 0.11; }\n"
+    "func _lx_home_y(): float { return tm_view_top() + _world_h * 0.08; }\n"
+    "func _lx_home_r(): float { return _world_h * 0.05; }\n"
+    "\n"
+    "// Herhangi bir parmak EV butonuna yeni bastı mı (edge).\n"
+    "func _lx_home_pressed(): bool {\n"
+    "    float hx = _lx_home_x(); float hy = _lx_home_y();\n"
+    "    float grab = _lx_home_r() * 1.8;\n"
+    "    bool now = false;\n"
+    "    int n = touch_count();\n"
+    "    int i = 0;\n"
+    "    while (i < n) {\n"
+    "        float dx = touch_x(i) * 1.0 - hx;\n"
+    "        float dy = touch_y(i) * 1.0 - hy;\n"
+    "        if (dx * dx + dy * dy <= grab * grab) { now = true; }\n"
+    "        i = i + 1;\n"
+    "    }\n"
+    "    bool edge = now && !_lx_home_prev;\n"
+    "    _lx_home_prev = now;\n"
+    "    return edge;\n"
+    "}\n"
+    "\n"
+    "func _lx_draw_home() {\n"
+    "    float hx = _lx_home_x(); float hy = _lx_home_y(); float hr = _lx_home_r();\n"
+    "    circle(toInt(hx), toInt(hy), toInt(hr), rgba(230, 120, 110, 130));\n"
+    "    // basit \"geri/ev\" işareti: içte küçük beyaz kare\n"
+    "    float s = hr * 0.7;\n"
+    "    rect(hx - s * 0.5, hy - s * 0.5, s, s, rgba(255, 255, 255, 225));\n"
+    "}\n"
+    "\n"
+    "// Oyundan menüye dön (EV butonu, oyun-bitti \"Ana Menu\" ve duraklat-Menü ortak yolu):\n"
+    "// menüye geç + fade + seçme dokunuşunu tüket (dişli-kaskad koruması) + rozet tazele.\n"
+    "func _lx_goto_menu() {\n"
+    "    _ar_mode = 0;\n"
+    "    _trans_start();\n"
+    "    _ar_touch_prevn = touch_count();\n"
+    "    _apps_best[_menu_sel] = _best;\n"
+    "    if (_apps_levn[_menu_sel] > 0) {\n"
+    "        _apps_done[_menu_sel] = _count_done_levels(_ar_title, _apps_levn[_menu_sel]);\n"
+    "    } else {\n"
+    "        _apps_star[_menu_sel] = _stars;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// ---- Menü ızgara geometrisi ------------------------------------------------\n"
+    "func _menu_cols(): int {\n"
+    "    if (_apps_n <= 1) { return 1; }\n"
+    "    if (_apps_n <= 4) { return 2; }\n"
+    "    if (_apps_n <= 9) { return 3; }\n"
+    "    return 4;\n"
+    "}\n"
+    "func _menu_rows(): int {\n"
+    "    int cols = _menu_cols();\n"
+    "    int rows = toInt((_apps_n + cols - 1) / cols);   // ceil(n/cols)\n"
+    "    if (rows < 1) { rows = 1; }\n"
+    "    return rows;\n"
+    "}\n"
+    "func _menu_top(): float  { return _world_h * 0.28; }   // başlık için üst boşluk\n"
+    "func _menu_padh(): float { return _world_w * 0.045; }\n"
+    "func _menu_padv(): float { return _world_h * 0.05; }\n"
+    "\n"
+    "func _menu_card_w(): float {\n"
+    "    int cols = _menu_cols();\n"
+    "    float pad = _menu_padh();\n"
+    "    return (_world_w - pad * (cols + 1)) / (cols * 1.0);\n"
+    "}\n"
+    "func _menu_card_h(): float {\n"
+    "    int rows = _menu_rows();\n"
+    "    float pad = _menu_padv();\n"
+    "    return (_world_h - _menu_top() - pad * (rows + 1)) / (rows * 1.0);\n"
+    "}\n"
+    "func _menu_card_x(i): float {\n"
+    "    int cols = _menu_cols();\n"
+    "    int col = mod(i, cols);\n"
+    "    float pad = _menu_padh();\n"
+    "    return pad + col * (_menu_card_w() + pad);\n"
+    "}\n"
+    "func _menu_card_y(i): float {\n"
+    "    int cols = _menu_cols();\n"
+    "    int row = toInt(i / cols);\n"
+    "    float pad = _menu_padv();\n"
+    "    return _menu_top() + pad + row * (_menu_card_h() + pad);\n"
+    "}\n"
+    "\n"
+    "// Klavye ile seçimi ızgarada gezdir.\n"
+    "func _menu_move(dcol, drow) {\n"
+    "    int cols = _menu_cols();\n"
+    "    int col = mod(_menu_sel, cols) + dcol;\n"
+    "    int row = toInt(_menu_sel / cols) + drow;\n"
+    "    if (col < 0) { col = 0; }\n"
+    "    if (col > cols - 1) { col = cols - 1; }\n"
+    "    if (row < 0) { row = 0; }\n"
+    "    int ni = row * cols + col;\n"
+    "    if (ni >= 0 && ni < _apps_n) { _menu_sel = ni; }\n"
+    "}\n"
+    "\n"
+    "// Menü bir karesi: klavye navigasyonu + dokunma ile kart seçme.\n"
+    "func _menu_step() {\n"
+    "    if (key_pressed(\"LEFT\")  || key_pressed(\"A\")) { _menu_move(0 - 1, 0); }\n"
+    "    if (key_pressed(\"RIGHT\") || key_pressed(\"D\")) { _menu_move(1, 0); }\n"
+    "    if (key_pressed(\"UP\")    || key_pressed(\"W\")) { _menu_move(0, 0 - 1); }\n"
+    "    if (key_pressed(\"DOWN\")  || key_pressed(\"S\")) { _menu_move(0, 1); }\n"
+    "    if (key_pressed(\"ENTER\") || key_pressed(\"SPACE\")) { _lx_launch(_menu_sel); return; }\n"
+    "\n"
+    "    int n = touch_count();\n"
+    "    bool tap = (n > 0) && (_ar_touch_prevn == 0);\n"
+    "    if (tap) {\n"
+    "        float tx = touch_x(0) * 1.0;\n"
+    "        float ty = touch_y(0) * 1.0;\n"
+    "        int i = 0;\n"
+    "        while (i < _apps_n) {\n"
+    "            float cx = _menu_card_x(i); float cy = _menu_card_y(i);\n"
+    "            float cw = _menu_card_w();  float ch = _menu_card_h();\n"
+    "            if (tx >= cx && tx <= cx + cw && ty >= cy && ty <= cy + ch) {\n"
+    "                _lx_launch(i);\n"
+    "                return;\n"
+    "            }\n"
+    "            i = i + 1;\n"
+    "        }\n"
+    "    }\n"
+    "    _ar_touch_prevn = n;\n"
+    "}\n"
+    "\n"
+    "// Menü ekranını çiz: başlık + kart ızgarası (seçili kart altın çerçeveli).\n"
+    "// Kartta 3 yıldız pip'i çiz (kazanılan altın, kalan koyu).\n"
+    "func _menu_draw_pips(cx, cy, cw, ch, st) {\n"
+    "    float pr = ch * 0.055;\n"
+    "    if (pr < 3.0) { pr = 3.0; }\n"
+    "    float gap = pr * 2.8;\n"
+    "    float sx = cx + cw / 2.0 - gap;      // 3 pip → 2 aralık, ortala\n"
+    "    float py = cy + ch * 0.58;\n"
+    "    int j = 0;\n"
+    "    while (j < 3) {\n"
+    "        int col = rgb(58, 64, 84);\n"
+    "        if (j < st) { col = GOLD; }\n"
+    "        circle(toInt(sx + j * gap), toInt(py), toInt(pr), col);\n"
+    "        j = j + 1;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// ---- Bölüm seçim ekranı (mode 4) — kart→bölümler→oyna -----------------------\n"
+    "func _lsel_cols(): int {\n"
+    "    if (_level_n <= 3) { return _level_n; }\n"
+    "    if (_level_n <= 4) { return 2; }\n"
+    "    return 3;\n"
+    "}\n"
+    "func _lsel_bw(): float  { return _world_w * 0.22; }\n"
+    "func _lsel_bh(): float  { return _world_h * 0.17; }\n"
+    "func _lsel_gap(): float { return _world_w * 0.045; }\n"
+    "func _lsel_x0(): float {\n"
+    "    int c = _lsel_cols(); if (c < 1) { c = 1; }\n"
+    "    float total = c * _lsel_bw() + (c - 1) * _lsel_gap();\n"
+    "    return (_world_w - total) / 2.0;\n"
+    "}\n"
+    "func _lsel_y0(): float { return _world_h * 0.30; }\n"
+    "func _lsel_bx(k): float {          // k 0-tabanlı\n"
+    "    int c = _lsel_cols(); if (c < 1) { c = 1; }\n"
+    "    int col = mod(k, c);\n"
+    "    return _lsel_x0() + col * (_lsel_bw() + _lsel_gap());\n"
+    "}\n"
+    "func _lsel_by(k): float {\n"
+    "    int c = _lsel_cols(); if (c < 1) { c = 1; }\n"
+    "    int row = toInt(k / c);\n"
+    "    return _lsel_y0() + row * (_lsel_bh() + _lsel_gap());\n"
+    "}\n"
+    "\n"
+    "func _levelsel_draw() {\n"
+    "    clear(rgb(16, 18, 26));\n"
+    "    str L = _lang_now();\n"
+    "    str nm = _apps_name[_lx_sel_game];\n"
+    "    int tsz = toInt(_world_h * 0.075);\n"
+    "    text(nm, toInt((_world_w - measure_text(nm, tsz)) / 2.0), toInt(_world_h * 0.075), tsz, GOLD);\n"
+    "    str sub = \"Bolum sec\"; if (L == \"en\") { sub = \"Pick a level\"; }\n"
+    "    int ssz = toInt(_world_h * 0.042);\n"
+    "    text(sub, toInt((_world_w - measure_text(sub, ssz)) / 2.0), toInt(_world_h * 0.185), ssz, SKYBLUE);\n"
+    "    int k = 0;\n"
+    "    while (k < _level_n) {\n"
+    "        float bx = _lsel_bx(k); float by = _lsel_by(k);\n"
+    "        float bw = _lsel_bw();  float bh = _lsel_bh();\n"
+    "        bool done = false;\n"
+    "        if (k < length(_lvl_done)) { if (_lvl_done[k] == 1) { done = true; } }\n"
+    "        rect(bx, by, bw, bh, done ? rgb(46, 54, 82) : rgb(30, 34, 48));\n"
+    "        rect_lines(bx, by, bw, bh, done ? GOLD : rgb(60, 66, 86));\n"
+    "        str num = toString(k + 1);\n"
+    "        int nsz = toInt(bh * 0.36);\n"
+    "        text(num, toInt(bx + (bw - measure_text(num, nsz)) / 2.0), toInt(by + bh * 0.16), nsz, WHITE);\n"
+    "        int pcol = rgb(60, 66, 86); if (done) { pcol = GOLD; }\n"
+    "        circle(toInt(bx + bw / 2.0), toInt(by + bh * 0.72), toInt(bh * 0.11), pcol);\n"
+    "        k = k + 1;\n"
+    "    }\n"
+    "    float qx = _cfg_back_x(); float qy = _cfg_back_y();\n"
+    "    float qw = _cfg_back_w(); float qh = _cfg_back_h();\n"
+    "    rect(qx, qy, qw, qh, rgb(46, 54, 82));\n"
+    "    rect_lines(qx, qy, qw, qh, GOLD);\n"
+    "    str back = \"Geri\"; if (L == \"en\") { back = \"Back\"; }\n"
+    "    int bsz = toInt(qh * 0.40);\n"
+    "    text(back, toInt(qx + (qw - measure_text(back, bsz)) / 2.0),\n"
+    "         toInt(qy + (qh - bsz * 1.0) / 2.0), bsz, WHITE);\n"
+    "}\n"
+    "\n"
+    "// Bölüm seçim bir karesi: 0 = yok, -1 = geri, k(1..N) = o bölümü başlat.\n"
+    "func _levelsel_step(): int {\n"
+    "    if (key_pressed(\"BACK\") || key_pressed(\"ESCAPE\") || key_pressed(\"BACKSPACE\")) {\n"
+    "        return 0 - 1;\n"
+    "    }\n"
+    "    int n = touch_count();\n"
+    "    bool tap = (n > 0) && (_ar_touch_prevn == 0);\n"
+    "    int act = 0;\n"
+    "    if (tap) {\n"
+    "        float tx = touch_x(0) * 1.0; float ty = touch_y(0) * 1.0;\n"
+    "        int k = 0;\n"
+    "        while (k < _level_n) {\n"
+    "            float bx = _lsel_bx(k); float by = _lsel_by(k);\n"
+    "            float bw = _lsel_bw();  float bh = _lsel_bh();\n"
+    "            if (tx >= bx && tx <= bx + bw && ty >= by && ty <= by + bh) { act = k + 1; }\n"
+    "            k = k + 1;\n"
+    "        }\n"
+    "        float qx = _cfg_back_x(); float qy = _cfg_back_y();\n"
+    "        float qw = _cfg_back_w(); float qh = _cfg_back_h();\n"
+    "        if (tx >= qx && tx <= qx + qw && ty >= qy && ty <= qy + qh) { act = 0 - 1; }\n"
+    "    }\n"
+    "    _ar_touch_prevn = n;\n"
+    "    return act;\n"
+    "}\n"
+    "\n"
+    "func _menu_draw() {\n"
+    "    clear(rgb(16, 18, 26));\n"
+    "    str L = _lang_now();\n"
+    "    str title = _menu_title;\n"
+    "    if (title == \"\") { title = \"TULPAR ARCADE\"; }\n"
+    "    int tsz = toInt(_world_h * 0.095);\n"
+    "    text(title, toInt((_world_w - measure_text(title, tsz)) / 2.0),\n"
+    "         toInt(_world_h * 0.07), tsz, GOLD);\n"
+    "    str sub = \"Bir oyun sec\";\n"
+    "    if (L == \"en\") { sub = \"Pick a game\"; }\n"
+    "    int ssz = toInt(_world_h * 0.042);\n"
+    "    text(sub, toInt((_world_w - measure_text(sub, ssz)) / 2.0),\n"
+    "         toInt(_world_h * 0.185), ssz, SKYBLUE);\n"
+    "\n"
+    "    int i = 0;\n"
+    "    while (i < _apps_n) {\n"
+    "        float cx = _menu_card_x(i); float cy = _menu_card_y(i);\n"
+    "        float cw = _menu_card_w();  float ch = _menu_card_h();\n"
+    "        bool selp = (i == _menu_sel);\n"
+    "        rect(cx, cy, cw, ch, selp ? rgb(46, 54, 82) : rgb(30, 34, 48));\n"
+    "        if (selp) {\n"
+    "            rect_lines(cx, cy, cw, ch, GOLD);\n"
+    "            rect_lines(cx + 1.0, cy + 1.0, cw - 2.0, ch - 2.0, GOLD);\n"
+    "        }\n"
+    "        str nm = _apps_name[i];\n"
+    "        int nsz = toInt(ch * 0.24);\n"
+    "        if (nsz < 13) { nsz = 13; }\n"
+    "        text(nm, toInt(cx + (cw - measure_text(nm, nsz)) / 2.0),\n"
+    "             toInt(cy + ch * 0.26), nsz, WHITE);\n"
+    "        // İlerleme: bölümlü oyun → tamamlanan/tüm bölüm (altın yıldız + N/M),\n"
+    "        // sonsuz oyun → 0..3 yıldız pip'i.\n"
+    "        if (_apps_levn[i] > 0) {\n"
+    "            str pt = toString(_apps_done[i]) + \"/\" + toString(_apps_levn[i]);\n"
+    "            int psz = toInt(ch * 0.17); if (psz < 11) { psz = 11; }\n"
+    "            int ptw = measure_text(pt, psz);\n"
+    "            float pr = ch * 0.06;\n"
+    "            float py = cy + ch * 0.56;\n"
+    "            float gw = pr * 2.0 + ch * 0.05 + ptw * 1.0;   // pip + boşluk + metin\n"
+    "            float gx = cx + cw / 2.0 - gw / 2.0;\n"
+    "            circle(toInt(gx + pr), toInt(py + psz * 0.45), toInt(pr), GOLD);\n"
+    "            text(pt, toInt(gx + pr * 2.0 + ch * 0.05), toInt(py), psz, GOLD);\n"
+    "        } else {\n"
+    "            _menu_draw_pips(cx, cy, cw, ch, _apps_star[i]);\n"
+    "        }\n"
+    "        // En iyi skor rozeti — kartın altına, altın renkli.\n"
+    "        if (_apps_best[i] > 0) {\n"
+    "            str bh = \"En iyi: \";\n"
+    "            if (L == \"en\") { bh = \"Best: \"; }\n"
+    "            str bt = bh + toString(_apps_best[i]);\n"
+    "            int bsz = toInt(ch * 0.13);\n"
+    "            if (bsz < 10) { bsz = 10; }\n"
+    "            text(bt, toInt(cx + (cw - measure_text(bt, bsz)) / 2.0),\n"
+    "                 toInt(cy + ch - bsz * 1.5), bsz, GOLD);\n"
+    "        }\n"
+    "        i = i + 1;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Ana launcher döngüsü — menü ↔ oyun durum makinesi. `oyna()`nın çok-oyunlu\n"
+    "// karşılığı: pencereyi (zaten `sahne()` ile açık) ve döngüyü sahiplenir.\n"
+    "// Bir oyunun kayıtlı en iyi skorunu oku (launcher rozetleri için).\n"
+    "func _lx_load_best(name): int {\n"
+    "    str s = load_data(\"arcade_best_\" + name + \".txt\");\n"
+    "    if (s == \"\") { return 0; }\n"
+    "    return toInt(s);\n"
+    "}\n"
+    "func _lx_load_star(name): int {\n"
+    "    str s = load_data(\"arcade_star_\" + name + \".txt\");\n"
+    "    if (s == \"\") { return 0; }\n"
+    "    return toInt(s);\n"
+    "}\n"
+    "\n"
+    "// ============================================================================\n"
+    "//  APP KABUĞU — Ayarlar ekranı + Duraklat örtüsü + geri tuşu\n"
+    "// ============================================================================\n"
+    "\n"
+    "int  _ar_mode_settings = 2;   // launcher modu: 2 = Ayarlar ekranı\n"
+    "bool _pause_prev = false;     // duraklat düğmesi edge durumu (_ar_paused yukarıda)\n"
+    "\n"
+    "// ---- Menüdeki dişli (Ayarlar) düğmesi — sağ üst köşe -----------------------\n"
+    "func _cfg_btn_x(): float { return tm_view_right() - _world_h * 0.11; }\n"
+    "func _cfg_btn_y(): float { return tm_view_top()   + _world_h * 0.08; }\n"
+    "func _cfg_btn_r(): float { return _world_h * 0.055; }\n"
+    "\n"
+    "func _cfg_btn_draw() {\n"
+    "    float bx = _cfg_btn_x(); float by = _cfg_btn_y(); float br = _cfg_btn_r();\n"
+    "    circle(toInt(bx), toInt(by), toInt(br),        rgba(70, 80, 110, 220));\n"
+    "    circle(toInt(bx), toInt(by), toInt(br * 0.52), rgb(16, 18, 26));\n"
+    "    circle(toInt(bx), toInt(by), toInt(br * 0.20), rgba(215, 215, 235, 240));\n"
+    "}\n"
+    "\n"
+    "func _cfg_btn_tapped(): bool {\n"
+    "    int n = touch_count();\n"
+    "    if (n == 0 || _ar_touch_prevn != 0) { return false; }   // menü ile aynı edge kaynağı\n"
+    "    float dx = touch_x(0) * 1.0 - _cfg_btn_x();\n"
+    "    float dy = touch_y(0) * 1.0 - _cfg_btn_y();\n"
+    "    float grab = _cfg_btn_r() * 1.6;\n"
+    "    return dx * dx + dy * dy <= grab * grab;\n"
+    "}\n"
+    "\n"
+    "// ---- Menüdeki kupa (Rozetler) düğmesi — dişlinin solunda -------------------\n"
+    "int  _ar_mode_badges = 3;     // launcher modu: 3 = Rozetler ekranı\n"
+    "int  _ar_mode_levelsel = 4;   // launcher modu: 4 = Bölüm seçim ekranı\n"
+    "func _bdg_btn_x(): float { return _cfg_btn_x() - _world_h * 0.15; }\n"
+    "func _bdg_btn_y(): float { return _cfg_btn_y(); }\n"
+    "func _bdg_btn_r(): float { return _cfg_btn_r(); }\n"
+    "\n"
+    "func _bdg_btn_draw() {\n"
+    "    float bx = _bdg_btn_x(); float by = _bdg_btn_y(); float br = _bdg_btn_r();\n"
+    "    circle(toInt(bx), toInt(by), toInt(br), rgba(70, 80, 110, 220));\n"
+    "    // basit altın kupa: kâse + gövde + taban\n"
+    "    rect(bx - br * 0.35, by - br * 0.45, br * 0.70, br * 0.45, GOLD);   // kâse\n"
+    "    rect(bx - br * 0.10, by,             br * 0.20, br * 0.28, GOLD);   // gövde\n"
+    "    rect(bx - br * 0.35, by + br * 0.28, br * 0.70, br * 0.16, GOLD);   // taban\n"
+    "}\n"
+    "\n"
+    "func _bdg_btn_tapped(): bool {\n"
+    "    int n = touch_count();\n"
+    "    if (n == 0 || _ar_touch_prevn != 0) { return false; }\n"
+    "    float dx = touch_x(0) * 1.0 - _bdg_btn_x();\n"
+    "    float dy = touch_y(0) * 1.0 - _bdg_btn_y();\n"
+    "    float grab = _bdg_btn_r() * 1.6;\n"
+    "    return dx * dx + dy * dy <= grab * grab;\n"
+    "}\n"
+    "\n"
+    "// ---- Rozetler ekranı (mode 3) ----------------------------------------------\n"
+    "func _badges_draw() {\n"
+    "    clear(rgb(16, 18, 26));\n"
+    "    str L = _lang_now();\n"
+    "    str title = \"Rozetler\"; if (L == \"en\") { title = \"Badges\"; }\n"
+    "    int tsz = toInt(_world_h * 0.082);\n"
+    "    text(title, toInt((_world_w - measure_text(title, tsz)) / 2.0),\n"
+    "         toInt(_world_h * 0.055), tsz, GOLD);\n"
+    "    // Toplam yıldız satırı.\n"
+    "    int total = 0; int k = 0;\n"
+    "    while (k < _apps_n) { total = total + _apps_star[k]; k = k + 1; }\n"
+    "    str stx = \"Toplam yildiz: \"; if (L == \"en\") { stx = \"Total stars: \"; }\n"
+    "    str sline = stx + toString(total);\n"
+    "    int ssz = toInt(_world_h * 0.042);\n"
+    "    text(sline, toInt((_world_w - measure_text(sline, ssz)) / 2.0),\n"
+    "         toInt(_world_h * 0.150), ssz, SKYBLUE);\n"
+    "    int i = 0;\n"
+    "    while (i < 5) {\n"
+    "        float rx = _world_w * 0.13; float rw = _world_w * 0.74;\n"
+    "        float rh = _world_h * 0.10;  float ry = _world_h * (0.21 + i * 0.115);\n"
+    "        bool has = _badge_has(i);\n"
+    "        rect(rx, ry, rw, rh, has ? rgb(40, 46, 66) : rgb(24, 26, 36));\n"
+    "        float mr = rh * 0.28;\n"
+    "        int mcol = rgb(60, 66, 86); if (has) { mcol = GOLD; }\n"
+    "        circle(toInt(rx + rh * 0.55), toInt(ry + rh * 0.5), toInt(mr), mcol);\n"
+    "        int ncol = WHITE; if (!has) { ncol = rgb(120, 126, 140); }\n"
+    "        text(_badge_name(i), toInt(rx + rh * 1.1), toInt(ry + rh * 0.16),\n"
+    "             toInt(rh * 0.34), ncol);\n"
+    "        text(_badge_desc(i), toInt(rx + rh * 1.1), toInt(ry + rh * 0.55),\n"
+    "             toInt(rh * 0.24), rgb(150, 156, 170));\n"
+    "        i = i + 1;\n"
+    "    }\n"
+    "    // Geri düğmesi (Ayarlar geometrisini paylaşır).\n"
+    "    float bx = _cfg_back_x(); float by = _cfg_back_y();\n"
+    "    float bw = _cfg_back_w(); float bh = _cfg_back_h();\n"
+    "    rect(bx, by, bw, bh, rgb(46, 54, 82));\n"
+    "    rect_lines(bx, by, bw, bh, GOLD);\n"
+    "    str back = \"Geri\"; if (L == \"en\") { back = \"Back\"; }\n"
+    "    int bsz = toInt(bh * 0.40);\n"
+    "    text(back, toInt(bx + (bw - measure_text(back, bsz)) / 2.0),\n"
+    "         toInt(by + (bh - bsz * 1.0) / 2.0), bsz, WHITE);\n"
+    "}\n"
+    "\n"
+    "// Rozetler ekranı bir karesi. true → menüye dön.\n"
+    "func _badges_step(): bool {\n"
+    "    if (key_pressed(\"BACK\") || key_pressed(\"ESCAPE\") || key_pressed(\"BACKSPACE\")) {\n"
+    "        return true;\n"
+    "    }\n"
+    "    int n = touch_count();\n"
+    "    bool tap = (n > 0) && (_ar_touch_prevn == 0);\n"
+    "    bool leave = false;\n"
+    "    if (tap) {\n"
+    "        float tx = touch_x(0) * 1.0; float ty = touch_y(0) * 1.0;\n"
+    "        float bx = _cfg_back_x(); float by = _cfg_back_y();\n"
+    "        float bw = _cfg_back_w(); float bh = _cfg_back_h();\n"
+    "        if (tx >= bx && tx <= bx + bw && ty >= by && ty <= by + bh) { leave = true; }\n"
+    "    }\n"
+    "    _ar_touch_prevn = n;\n"
+    "    return leave;\n"
+    "}\n"
+    "\n"
+    "// ---- Ayarlar ekranı: 3 satır (Ses / Titreşim / Dil) + Geri -----------------\n"
+    "func _cfg_row_x(): float  { return _world_w * 0.14; }\n"
+    "func _cfg_row_w(): float  { return _world_w * 0.72; }\n"
+    "func _cfg_row_h(): float  { return _world_h * 0.086; }\n"
+    "func _cfg_row_y(i): float { return _world_h * (0.185 + i * 0.099); }\n"
+    "func _cfg_back_x(): float { return _world_w * 0.35; }\n"
+    "func _cfg_back_y(): float { return _world_h * 0.83; }\n"
+    "func _cfg_back_w(): float { return _world_w * 0.30; }\n"
+    "func _cfg_back_h(): float { return _world_h * 0.10; }\n"
+    "\n"
+    "func _cfg_val_onoff(on): str {\n"
+    "    str L = _lang_now();\n"
+    "    if (on) { if (L == \"en\") { return \"On\"; } return \"Acik\"; }\n"
+    "    if (L == \"en\") { return \"Off\"; }\n"
+    "    return \"Kapali\";\n"
+    "}\n"
+    "\n"
+    "func _cfg_draw_row(i, label, value) {\n"
+    "    float rx = _cfg_row_x(); float ry = _cfg_row_y(i);\n"
+    "    float rw = _cfg_row_w(); float rh = _cfg_row_h();\n"
+    "    rect(rx, ry, rw, rh, rgb(30, 34, 48));\n"
+    "    int lsz = toInt(rh * 0.38);\n"
+    "    text(label, toInt(rx + rw * 0.06), toInt(ry + (rh - lsz * 1.0) / 2.0), lsz, WHITE);\n"
+    "    int vsz = lsz;\n"
+    "    int vw = measure_text(value, vsz);\n"
+    "    float pw = vw * 1.0 + rw * 0.10;\n"
+    "    float px = rx + rw - pw - rw * 0.05;\n"
+    "    rect(px, ry + rh * 0.18, pw, rh * 0.64, rgb(46, 54, 82));\n"
+    "    text(value, toInt(px + (pw - vw * 1.0) / 2.0), toInt(ry + (rh - vsz * 1.0) / 2.0), vsz, GOLD);\n"
+    "}\n"
+    "\n"
+    "func _cfg_draw() {\n"
+    "    clear(rgb(16, 18, 26));\n"
+    "    str L = _lang_now();\n"
+    "    str title = \"Ayarlar\"; if (L == \"en\") { title = \"Settings\"; }\n"
+    "    int tsz = toInt(_world_h * 0.085);\n"
+    "    text(title, toInt((_world_w - measure_text(title, tsz)) / 2.0),\n"
+    "         toInt(_world_h * 0.075), tsz, GOLD);\n"
+    "\n"
+    "    str l0 = \"Ses\";      if (L == \"en\") { l0 = \"Sound\"; }\n"
+    "    str lm = \"Muzik\";    if (L == \"en\") { lm = \"Music\"; }\n"
+    "    str l1 = \"Titresim\"; if (L == \"en\") { l1 = \"Haptics\"; }\n"
+    "    str l2 = \"Dil\";      if (L == \"en\") { l2 = \"Language\"; }\n"
+    "    str l3 = \"FPS\";\n"
+    "    str l4 = \"Rekorlar\"; if (L == \"en\") { l4 = \"Records\"; }\n"
+    "    str lv = \"Turkce\";   if (L == \"en\") { lv = \"English\"; }\n"
+    "    str rv = \"Sil\";      if (L == \"en\") { rv = \"Clear\"; }\n"
+    "    if (_cfg_reset_msg > 0.0) { rv = \"Silindi\"; if (L == \"en\") { rv = \"Cleared\"; } }\n"
+    "    else if (_cfg_reset_armed) { rv = \"Emin?\"; if (L == \"en\") { rv = \"Sure?\"; } }\n"
+    "    _cfg_draw_row(0, l0, _cfg_val_onoff(_snd_on));\n"
+    "    _cfg_draw_row(1, lm, _cfg_val_onoff(_mus_on));\n"
+    "    _cfg_draw_row(2, l1, _cfg_val_onoff(_hap_on));\n"
+    "    _cfg_draw_row(3, l2, lv);\n"
+    "    _cfg_draw_row(4, l3, _cfg_val_onoff(_fps_on));\n"
+    "    _cfg_draw_row(5, l4, rv);\n"
+    "\n"
+    "    float bx = _cfg_back_x(); float by = _cfg_back_y();\n"
+    "    float bw = _cfg_back_w(); float bh = _cfg_back_h();\n"
+    "    rect(bx, by, bw, bh, rgb(46, 54, 82));\n"
+    "    rect_lines(bx, by, bw, bh, GOLD);\n"
+    "    str back = \"Geri\"; if (L == \"en\") { back = \"Back\"; }\n"
+    "    int bsz = toInt(bh * 0.40);\n"
+    "    text(back, toInt(bx + (bw - measure_text(back, bsz)) / 2.0),\n"
+    "         toInt(by + (bh - bsz * 1.0) / 2.0), bsz, WHITE);\n"
+    "}\n"
+    "\n"
+    "// Tüm oyunların kalıcı en iyi skorlarını sıfırla (dosyaya \"0\" yaz + rozetleri düş).\n"
+    "func _ar_reset_records() {\n"
+    "    int i = 0;\n"
+    "    while (i < _apps_n) {\n"
+    "        save_data(\"arcade_best_\" + _apps_name[i] + \".txt\", \"0\");\n"
+    "        _apps_best[i] = 0;\n"
+    "        i = i + 1;\n"
+    "    }\n"
+    "    _best = 0;\n"
+    "    _new_record = false;\n"
+    "}\n"
+    "\n"
+    "func _cfg_toggle(i) {\n"
+    "    if (i != 5) { _cfg_reset_armed = false; }   // başka satıra dokunmak onayı düşürür\n"
+    "    if (i == 0) { _snd_on = !_snd_on; if (_snd_on) { _snd(880.0, 60); } }\n"
+    "    else if (i == 1) { _mus_on = !_mus_on; if (!_mus_on) { _mus_track = -1; } }\n"
+    "    else if (i == 2) { _hap_on = !_hap_on; if (_hap_on) { _hap(80); } }\n"
+    "    else if (i == 3) { if (_lang_now() == \"en\") { _lang = \"tr\"; } else { _lang = \"en\"; } }\n"
+    "    else if (i == 4) { _fps_on = !_fps_on; }\n"
+    "    else if (i == 5) {\n"
+    "        // İki-dokunuş onayı: 1. dokunuş silahlandırır (\"Emin?\"), 2. dokunuş siler.\n"
+    "        if (_cfg_reset_armed) {\n"
+    "            _ar_reset_records();\n"
+    "            _cfg_reset_armed = false;\n"
+    "            _cfg_reset_msg = 1.2;\n"
+    "            _snd(400.0, 80);\n"
+    "        } else {\n"
+    "            _cfg_reset_armed = true;\n"
+    "        }\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Ayarlar ekranı bir karesi. true dönerse menüye dönülür (kaydedilir).\n"
+    "func _cfg_step(): bool {\n"
+    "    if (_cfg_reset_msg > 0.0) { _cfg_reset_msg = _cfg_reset_msg - frame_time(); }\n"
+    "    if (key_pressed(\"BACK\") || key_pressed(\"ESCAPE\") || key_pressed(\"BACKSPACE\")) {\n"
+    "        return true;\n"
+    "    }\n"
+    "    int n = touch_count();\n"
+    "    bool tap = (n > 0) && (_ar_touch_prevn == 0);\n"
+    "    bool leave = false;\n"
+    "    if (tap) {\n"
+    "        float tx = touch_x(0) * 1.0; float ty = touch_y(0) * 1.0;\n"
+    "        int i = 0;\n"
+    "        while (i < 6) {\n"
+    "            float ry = _cfg_row_y(i); float rh = _cfg_row_h();\n"
+    "            float rx = _cfg_row_x(); float rw = _cfg_row_w();\n"
+    "            // Yalnız SAĞDAKİ değer kutusu toggle eder; sol etikete/ortaya basmak\n"
+    "            // ayarı değiştirmez (değer kutusu sağa yaslı, sol ~%23 etiket bölgesi).\n"
+    "            float valL = rx + rw * 0.58;\n"
+    "            if (tx >= valL && tx <= rx + rw && ty >= ry && ty <= ry + rh) { _cfg_toggle(i); }\n"
+    "            i = i + 1;\n"
+    "        }\n"
+    "        float bx = _cfg_back_x(); float by = _cfg_back_y();\n"
+    "        float bw = _cfg_back_w(); float bh = _cfg_back_h();\n"
+    "        if (tx >= bx && tx <= bx + bw && ty >= by && ty <= by + bh) { leave = true; }\n"
+    "    }\n"
+    "    _ar_touch_prevn = n;\n"
+    "    return leave;\n"
+    "}\n"
+    "\n"
+    "// ---- Oyun-içi Duraklat düğmesi (EV butonunun solunda) ----------------------\n"
+    "func _pause_btn_x(): float { return tm_view_right() - _world_h * 0.24; }\n"
+    "func _pause_btn_y(): float { return tm_view_top()   + _world_h * 0.08; }\n"
+    "func _pause_btn_r(): float { return _world_h * 0.05; }\n"
+    "\n"
+    "func _pause_btn_draw() {\n"
+    "    float bx = _pause_btn_x(); float by = _pause_btn_y(); float br = _pause_btn_r();\n"
+    "    circle(toInt(bx), toInt(by), toInt(br), rgba(90, 100, 130, 130));\n"
+    "    float bw = br * 0.24; float bh = br * 0.9;\n"
+    "    rect(bx - br * 0.42, by - bh * 0.5, bw, bh, rgba(255, 255, 255, 225));\n"
+    "    rect(bx + br * 0.18, by - bh * 0.5, bw, bh, rgba(255, 255, 255, 225));\n"
+    "}\n"
+    "\n"
+    "// Duraklat düğmesine yeni basıldı mı (edge, kendi durumuyla).\n"
+    "func _pause_btn_pressed(): bool {\n"
+    "    float hx = _pause_btn_x(); float hy = _pause_btn_y();\n"
+    "    float grab = _pause_btn_r() * 1.8;\n"
+    "    bool now = false;\n"
+    "    int n = touch_count(); int i = 0;\n"
+    "    while (i < n) {\n"
+    "        float dx = touch_x(i) * 1.0 - hx;\n"
+    "        float dy = touch_y(i) * 1.0 - hy;\n"
+    "        if (dx * dx + dy * dy <= grab * grab) { now = true; }\n"
+    "        i = i + 1;\n"
+    "    }\n"
+    "    bool edge = now && !_pause_prev;\n"
+    "    _pause_prev = now;\n"
+    "    return edge;\n"
+    "}\n"
+    "\n"
+    "// ---- Duraklat örtüsü (3 düğme: Devam / Yeniden / Menü) ----------------------\n"
+    "func _pause_rect_x(): float { return _world_w * 0.30; }\n"
+    "func _pause_rect_w(): float { return _world_w * 0.40; }\n"
+    "func _pause_rect_h(): float { return _world_h * 0.12; }\n"
+    "func _pause_rect_y(i): float { return _world_h * (0.36 + i * 0.16); }\n"
+    "\n"
+    "func _pause_draw(menu_label) {\n"
+    "    float vl = tm_view_left(); float vt = tm_view_top();\n"
+    "    float vr = tm_view_right(); float vb = tm_view_bottom();\n"
+    "    rect(vl, vt, vr - vl, vb - vt, rgba(8, 10, 16, 185));\n"
+    "    str L = _lang_now();\n"
+    "    str t = \"Duraklatildi\"; if (L == \"en\") { t = \"Paused\"; }\n"
+    "    int tsz = toInt(_world_h * 0.09);\n"
+    "    text(t, toInt((_world_w - measure_text(t, tsz)) / 2.0), toInt(_world_h * 0.18), tsz, GOLD);\n"
+    "\n"
+    "    str l0 = \"Devam\";   if (L == \"en\") { l0 = \"Resume\"; }\n"
+    "    str l1 = \"Yeniden\"; if (L == \"en\") { l1 = \"Restart\"; }\n"
+    "    _pause_draw_btn(0, l0);\n"
+    "    _pause_draw_btn(1, l1);\n"
+    "    _pause_draw_btn(2, menu_label);\n"
+    "}\n"
+    "\n"
+    "func _pause_draw_btn(i, label) {\n"
+    "    float bx = _pause_rect_x(); float by = _pause_rect_y(i);\n"
+    "    float bw = _pause_rect_w(); float bh = _pause_rect_h();\n"
+    "    rect(bx, by, bw, bh, rgb(46, 54, 82));\n"
+    "    rect_lines(bx, by, bw, bh, GOLD);\n"
+    "    int bsz = toInt(bh * 0.38);\n"
+    "    text(label, toInt(bx + (bw - measure_text(label, bsz)) / 2.0),\n"
+    "         toInt(by + (bh - bsz * 1.0) / 2.0), bsz, WHITE);\n"
+    "}\n"
+    "\n"
+    "// Duraklat bir karesi: 0=yok, 1=devam, 2=yeniden, 3=menü/çıkış.\n"
+    "func _pause_step(): int {\n"
+    "    int act = 0;\n"
+    "    int n = touch_count();\n"
+    "    bool tap = (n > 0) && (_ar_touch_prevn == 0);\n"
+    "    if (tap) {\n"
+    "        float tx = touch_x(0) * 1.0; float ty = touch_y(0) * 1.0;\n"
+    "        int i = 0;\n"
+    "        while (i < 3) {\n"
+    "            float bx = _pause_rect_x(); float bw = _pause_rect_w();\n"
+    "            float by = _pause_rect_y(i); float bh = _pause_rect_h();\n"
+    "            if (tx >= bx && tx <= bx + bw && ty >= by && ty <= by + bh) { act = i + 1; }\n"
+    "            i = i + 1;\n"
+    "        }\n"
+    "    }\n"
+    "    _ar_touch_prevn = n;\n"
+    "    if (key_pressed(\"ENTER\") || key_pressed(\"SPACE\")) { act = 1; }\n"
+    "    if (key_pressed(\"R\")) { act = 2; }\n"
+    "    return act;\n"
+    "}\n"
+    "\n"
+    "func _pause_enter() {\n"
+    "    _ar_paused = true;\n"
+    "    _ar_touch_prevn = touch_count();   // örtü girişteki dokunuşu \"yeni tap\" saymasın\n"
+    "}\n"
+    "\n"
+    "func launcher() {\n"
+    "    if (_apps_n == 0) { return; }\n"
+    "    _ar_mode = 0;\n"
+    "    _menu_sel = 0;\n"
+    "    _ar_standalone = false;            // oyun-bitti ekranında ikinci buton = \"Ana Menu\"\n"
+    "    // Kalıcı rekorları bir kez yükle (kare başına dosya IO'su OLMAZ).\n"
+    "    for (int bi = 0; bi < _apps_n; bi = bi + 1) {\n"
+    "        _apps_best[bi] = _lx_load_best(_apps_name[bi]);\n"
+    "        _apps_star[bi] = _lx_load_star(_apps_name[bi]);\n"
+    "    }\n"
+    "    // Bölüm sayılarını + tamamlanan bölümleri keşfet: her setup'ı bir kez çağır\n"
+    "    // (saf kayıt — pencere/entity YOK), _level_n'i oku, sonra temizle. Kartlar +\n"
+    "    // bölüm-seçim ekranı bunu kullanır (setup'ı tekrar çalıştırmadan).\n"
+    "    for (int pj = 0; pj < _apps_n; pj = pj + 1) {\n"
+    "        _lx_clear();\n"
+    "        _ar_title = _apps_name[pj];\n"
+    "        call(_apps_setup[pj]);\n"
+    "        _apps_levn[pj] = _level_n;\n"
+    "        _apps_done[pj] = _count_done_levels(_apps_name[pj], _level_n);\n"
+    "    }\n"
+    "    _lx_clear();\n"
+    "    _ar_load_settings();               // kalıcı ses/haptik/dil ayarlarını uygula\n"
+    "    var wm = arena_save();\n"
+    "    while (running()) {\n"
+    "        if (_ar_mode == 0) {\n"
+    "            // Menü: kupa → Rozetler; dişli → Ayarlar; Android GERİ → çık.\n"
+    "            if (_bdg_btn_tapped()) {\n"
+    "                _ar_mode = _ar_mode_badges;\n"
+    "                _ar_touch_prevn = touch_count();\n"
+    "            } else if (_cfg_btn_tapped()) {\n"
+    "                _ar_mode = _ar_mode_settings;\n"
+    "                _cfg_reset_armed = false;   // ayara her girişte \"Rekorları Sıfırla\" onayı sıfır\n"
+    "                _cfg_reset_msg = 0.0;\n"
+    "                _ar_touch_prevn = touch_count();\n"
+    "            } else if (key_pressed(\"BACK\")) {\n"
+    "                break;\n"
+    "            } else {\n"
+    "                _menu_step();\n"
+    "            }\n"
+    "            _mus_step(0);                  // menü müziği (sakin parça)\n"
+    "            frame_begin();\n"
+    "            _menu_draw();\n"
+    "            _bdg_btn_draw();\n"
+    "            _cfg_btn_draw();\n"
+    "            _trans_draw();\n"
+    "            frame_end();\n"
+    "        } else if (_ar_mode == _ar_mode_settings) {\n"
+    "            // Ayarlar ekranı — çıkışta kaydeder.\n"
+    "            bool leave = _cfg_step();\n"
+    "            _mus_step(0);                  // ayarlarda da menü müziği sürer\n"
+    "            frame_begin();\n"
+    "            _cfg_draw();\n"
+    "            _trans_draw();\n"
+    "            frame_end();\n"
+    "            if (leave) { _ar_save_settings(); _ar_mode = 0; }\n"
+    "        } else if (_ar_mode == _ar_mode_badges) {\n"
+    "            // Rozetler ekranı — sadece görüntüler, Geri ile menüye döner.\n"
+    "            bool bleave = _badges_step();\n"
+    "            _mus_step(0);\n"
+    "            frame_begin();\n"
+    "            _badges_draw();\n"
+    "            _trans_draw();\n"
+    "            frame_end();\n"
+    "            if (bleave) { _ar_mode = 0; _ar_touch_prevn = touch_count(); }\n"
+    "        } else if (_ar_mode == _ar_mode_levelsel) {\n"
+    "            // Bölüm seçim ekranı — bir bölüm seç ya da Geri ile menüye dön.\n"
+    "            int la = _levelsel_step();\n"
+    "            _mus_step(0);\n"
+    "            frame_begin();\n"
+    "            _levelsel_draw();\n"
+    "            _trans_draw();\n"
+    "            frame_end();\n"
+    "            if (la == 0 - 1) { _lx_clear(); _ar_mode = 0; _ar_touch_prevn = touch_count(); }\n"
+    "            else if (la > 0) { _ar_start_level = la; _lx_begin_play(_lx_sel_game); }\n"
+    "        } else {\n"
+    "            // Oyun. GERİ / ESC → duraklat (ilerleme kaybolmasın); EV → anında menü.\n"
+    "            // Yalnız aktif oynanırken duraklanır (biten oyun duraklatılamaz).\n"
+    "            if (!_ar_paused && _ar_state == 0) {\n"
+    "                if (key_pressed(\"ESCAPE\") || key_pressed(\"BACKSPACE\") || key_pressed(\"BACK\")) {\n"
+    "                    _pause_enter();\n"
+    "                }\n"
+    "            }\n"
+    "            if (_ar_paused) {\n"
+    "                str ml = \"Menu\";\n"
+    "                _mus_step(0);              // duraklatınca sakin parçaya geç\n"
+    "                frame_begin();\n"
+    "                _ar_draw_all();\n"
+    "                _lx_draw_home();\n"
+    "                _pause_draw(ml);\n"
+    "                frame_end();\n"
+    "                int act = _pause_step();\n"
+    "                if (act == 1) { _ar_paused = false; }\n"
+    "                else if (act == 2) { _ar_reset(); _ar_paused = false; }\n"
+    "                else if (act == 3) { _ar_paused = false; _lx_goto_menu(); }\n"
+    "            } else {\n"
+    "                _ar_update();\n"
+    "                if (_ar_state == 0) { _mus_step(1); } else { _mus_step(0); }\n"
+    "                frame_begin();\n"
+    "                _ar_draw_all();\n"
+    "                _lx_draw_home();\n"
+    "                _trans_draw();\n"
+    "                frame_end();\n"
+    "                // Oyun-bitti ekranı: \"Tekrar Oyna\" / \"Ana Menu\" butonları (ekrana\n"
+    "                // gelişigüzel dokunma oyunu BAŞLATMAZ). EV butonu da menüye döndürür.\n"
+    "                if (_ar_state != 0) {\n"
+    "                    int oa = _ar_over_step();\n"
+    "                    if (oa == 1) { _ar_reset(); _trans_start(); }\n"
+    "                    else if (oa == 2) { _lx_goto_menu(); }\n"
+    "                }\n"
+    "                if (_lx_home_pressed()) { _lx_goto_menu(); }\n"
+    "            }\n"
+    "        }\n"
+    "        arena_restore(wm);\n"
+    "    }\n"
+    "    arena_drop(wm);\n"
+    "    close_window();\n"
+    "}\n"
+    "func oyun_menusu() { launcher(); }\n"
+    "";
+
+// ========================================
+// lib/scene3d.tpr
+// ========================================
+static const char *EMBEDDED_SCENE3D =
+"// scene3d — Tulpar 3D preset motoru (arcade'in 3D kardeşi).\n"
+    "//\n"
+    "// Saf Tulpar; `tame`'in tm3_* 3D binding'leri üzerine kurulu (C/runtime wiring\n"
+    "// YOK — düzenleyince yalnız `./build.sh clean` re-embed yeter). Felsefe arcade\n"
+    "// ile aynı ama 3D: az kod → çalışan oyun. Fark: entity'ler PARALEL DİZİ değil,\n"
+    "// modern `struct Ent3` DİZİSİ (struct-in-array + alan-yazma artık çalışıyor).\n"
+    "//\n"
+    "// Motor her kare şunu yönetir: girdi → hareket → yerçekimi/zemin → AABB\n"
+    "// çarpışma (+ duvar itme) → takip kamerası → tüm entity'lerin çizimi → HUD.\n"
+    "// Kullanıcı yalnız setup + update + çarpışma kancalarını yazar.\n"
+    "//\n"
+    "// \"~20 satırda 3D toplayıcı\" hedef API'si (bkz. examples/scene3d_collector.tpr):\n"
+    "//\n"
+    "//   import \"scene3d\";\n"
+    "//   int player = 0;\n"
+    "//   func setup() {\n"
+    "//       player = spawn3(0,1,0,  1,2,1, SKYBLUE, SHAPE_CUBE, TAG_PLAYER);\n"
+    "//       camera_follow(player, 12.0, 8.0);\n"
+    "//       spawn3(4,1,3, 1,1,1, GOLD, SHAPE_SPHERE, TAG_ITEM);\n"
+    "//       spawn3(0,1,-9, 24,3,1, GRAY, SHAPE_CUBE, TAG_WALL);\n"
+    "//   }\n"
+    "//   func update() { move3d(player, 8.0); if (jump_pressed()) { jump3d(player, 10.0); } }\n"
+    "//   func collect()  { kill3d(other3d()); score3d_add(10); }\n"
+    "//   scene3d(900, 520, \"3D Toplayici\");\n"
+    "//   on_setup3d(setup); on_update3d(update); on_hit3d(TAG_PLAYER, TAG_ITEM, collect);\n"
+    "//   play3d();\n"
+    "\n"
+    "import \"tame\";\n"
+    "\n"
+    "// ---- Sabitler --------------------------------------------------------------\n"
+    "int SHAPE_CUBE   = 0;\n"
+    "int SHAPE_SPHERE = 1;\n"
+    "int SHAPE_CYL    = 2;\n"
+    "int SHAPE_MODEL  = 3;\n"
+    "\n"
+    "int TAG_PLAYER = 1;\n"
+    "int TAG_ITEM   = 2;\n"
+    "int TAG_WALL   = 3;\n"
+    "int TAG_ENEMY  = 4;\n"
+    "int TAG_PROP   = 5;\n"
+    "\n"
+    "// raylib tuş kodları (tame key constant açığa çıkarmıyor — burada tanımlı).\n"
+    "int K_W = 87;   int K_A = 65;   int K_S = 83;   int K_D = 68;\n"
+    "int K_UP = 265; int K_DOWN = 264; int K_LEFT = 263; int K_RIGHT = 262;\n"
+    "int K_SPACE = 32;\n"
+    "int K_Q = 81;   int K_E = 69;   // kamerayı klavyeyle çevir (fare yedeği)\n"
+    "\n"
+    "float DEG2RAD3 = 0.01745329;\n"
+    "float RAD2DEG3 = 57.29578;\n"
+    "\n"
+    "// ---- Entity modeli ---------------------------------------------------------\n"
+    "struct Ent3 {\n"
+    "    float x;  float y;  float z;     // konum (merkez)\n"
+    "    float vx; float vy; float vz;    // hız (birim/sn)\n"
+    "    float sx; float sy; float sz;    // TAM boyut (AABB = s/2 yarı-boyut)\n"
+    "    float yaw;                        // Y dönüşü (derece) — hareket yönüne bakar\n"
+    "    int shape;                        // SHAPE_*\n"
+    "    int model;                        // SHAPE_MODEL ise handle, değilse -1\n"
+    "    int color;                        // paketli renk\n"
+    "    int tag;                          // TAG_*\n"
+    "    int grounded;                     // zeminde mi (zıplama için)\n"
+    "    int alive;                        // 1/0\n"
+    "}\n"
+    "\n"
+    "array _e3 = [];             // entity store\n"
+    "\n"
+    "// ---- Kamera / fizik / durum -----------------------------------------------\n"
+    "float _grav      = 26.0;    // birim/sn^2\n"
+    "float _ground_y  = 0.0;     // zemin düzlemi yüksekliği\n"
+    "int   _ground_on = 1;       // zemin+ızgara çiz\n"
+    "float _ground_sz = 40.0;    // zemin/ızgara yarı-genişliği\n"
+    "\n"
+    "int   _cam_target = 0 - 1;  // takip edilen entity (-1 = sabit)\n"
+    "float _cam_dist   = 12.0;\n"
+    "float _cam_height = 8.0;\n"
+    "float _cam_fov    = 45.0;\n"
+    "\n"
+    "// Kamera modu. SABİT = motorun ilk günkü kamerası: hedefin hep +Z arkasında\n"
+    "// durur, HİÇ dönmez — bu yüzden W tuşu her zaman dünya ekseninde -Z demekti.\n"
+    "// Dönebilen kamera (yörünge/FPS) hem bakışı hem de hareketin yönünü açar:\n"
+    "// yön girdisi artık kameranın baktığı yere göre çevrilir (bkz. move3d).\n"
+    "// Varsayılan SABİT kalıyor — eski sahnelerin görüntüsü ve kontrolü değişmesin.\n"
+    "int CAM_FIXED = 0;\n"
+    "int CAM_ORBIT = 1;\n"
+    "int CAM_FPS   = 2;\n"
+    "\n"
+    "int   _cam_mode3  = 0;\n"
+    "// Kamera açıları DERECE. yaw 0 = kamera +Z'de, bakış -Z (sabit kameranın açısı).\n"
+    "// _cam_pitch3 BAKIŞ eğimidir (+ = yukarı bak); yörüngede kameranın yüksekliği\n"
+    "// bunun TERSİDİR — fareyi yukarı ittiğinde yukarı bakarsın, yani kamera alçalır.\n"
+    "float _cam_yaw3   = 0.0;\n"
+    "float _cam_pitch3 = 0.0;\n"
+    "float _cam_sens3  = 0.22;   // derece / piksel (fare)\n"
+    "float _cam_tsens3 = 0.30;   // derece / piksel (dokunmatik — parmak daha kaba)\n"
+    "float _cam_eye3   = 0.0;    // FPS göz yüksekliği (0 = entity boyundan türet)\n"
+    "float _cam_min3   = 3.0;    // yörünge zoom sınırları (tekerlek)\n"
+    "float _cam_max3   = 40.0;\n"
+    "int   _cam_lock3  = 0;      // imleç kilidi (FPS'te varsayılan açık)\n"
+    "\n"
+    "int   _score3 = 0;\n"
+    "int   _game_over3 = 0;\n"
+    "// Işıklandırma varsayılan AÇIK (bkz. play3d). lights3d(false) ile kapatılır —\n"
+    "// düz/ışıksız retro görünüm isteyen oyunlar için.\n"
+    "int   _lights3 = 1;\n"
+    "// Gölgeler de varsayılan AÇIK. Gölge, 3B'de cismin \"yerde durduğu\" hissini\n"
+    "// veren tek şey — gölgesiz sahnede her şey havada yüzüyormuş gibi görünür.\n"
+    "// Işık kapalıysa gölge de anlamsızdır, o yüzden ışığa bağlı (bkz. play3d).\n"
+    "int   _shadows3 = 1;\n"
+    "// Gölge haritasının kapsadığı alanın yarı-genişliği (dünya birimi). Kamera\n"
+    "// hedefinin çevresini kapsar; küçük = keskin ama dar, büyük = geniş ama kaba.\n"
+    "float _shadow_area3 = 24.0;\n"
+    "// Gökyüzü VARSAYILAN KAPALI — ışık/gölgeden farklı olarak bu bir sanat\n"
+    "// yönü kararı, algı düzeltmesi değil. Karanlık/stilize bir sahnede zorla açık\n"
+    "// mavi gökyüzü yanlış olur. sky3d(tepe, ufuk) ile açılır.\n"
+    "int   _sky3 = 0;\n"
+    "int   _sky_top3 = 0;\n"
+    "int   _sky_bot3 = 0;\n"
+    "// Zemin dokusu (opsiyonel). -1 = dokusuz düz renk (varsayılan).\n"
+    "int   _ground_tex3 = 0 - 1;\n"
+    "float _ground_tile3 = 1.0;\n"
+    "// Sis yoğunluğu. 0 = kapalı (varsayılan). Rengi gökyüzünün ufkundan alınır.\n"
+    "float _fog3 = 0.0;\n"
+    "\n"
+    "// callback'ler (0-arg; arcade deseni — call() ile güvenli).\n"
+    "// fn referansları `var` ile tutulmalı — `int` global fn-değerini bozar.\n"
+    "var _setup3_fn = 0;   int _has_setup3 = 0;\n"
+    "var _update3_fn = 0;  int _has_update3 = 0;\n"
+    "\n"
+    "// çarpışma kancaları (en çok 16): tagA, tagB, fn\n"
+    "array _hitA = [];\n"
+    "array _hitB = [];\n"
+    "array _hitF = [];\n"
+    "\n"
+    "// çarpışma bağlamı (kanca içinde me3d()/other3d() okur)\n"
+    "int _hit_me = 0;\n"
+    "int _hit_other = 0;\n"
+    "\n"
+    "int _win_w = 800;\n"
+    "int _win_h = 480;\n"
+    "string _win_title = \"Tulpar 3D\";\n"
+    "\n"
+    "// ---- Entity oluşturma / erişim ---------------------------------------------\n"
+    "// Yeni entity üret → dizin döner. sx/sy/sz TAM boyut.\n"
+    "func spawn3(x, y, z, sx, sy, sz, color, shape, tag): int {\n"
+    "    Ent3 e = { x: x, y: y, z: z,  vx: 0.0, vy: 0.0, vz: 0.0,\n"
+    "               sx: sx, sy: sy, sz: sz,  yaw: 0.0,\n"
+    "               shape: shape, model: 0 - 1, color: color, tag: tag,\n"
+    "               grounded: 0, alive: 1 };\n"
+    "    push(_e3, e);\n"
+    "    return length(_e3) - 1;\n"
+    "}\n"
+    "\n"
+    "// SHAPE_MODEL entity: yüklü/üretilmiş model handle'ıyla.\n"
+    "func spawn3_model(x, y, z, scale, model_handle, tag): int {\n"
+    "    Ent3 e = { x: x, y: y, z: z,  vx: 0.0, vy: 0.0, vz: 0.0,\n"
+    "               sx: scale, sy: scale, sz: scale,  yaw: 0.0,\n"
+    "               shape: SHAPE_MODEL, model: model_handle, color: WHITE, tag: tag,\n"
+    "               grounded: 0, alive: 1 };\n"
+    "    push(_e3, e);\n"
+    "    return length(_e3) - 1;\n"
+    "}\n"
+    "\n"
+    "func kill3d(i) { Ent3 e = _e3[i]; e.alive = 0; _e3[i] = e; }\n"
+    "func alive3(i): bool { Ent3 e = _e3[i]; return e.alive == 1; }\n"
+    "\n"
+    "func get3x(i): float { Ent3 e = _e3[i]; return e.x; }\n"
+    "func get3y(i): float { Ent3 e = _e3[i]; return e.y; }\n"
+    "func get3z(i): float { Ent3 e = _e3[i]; return e.z; }\n"
+    "\n"
+    "func set3pos(i, x, y, z) { Ent3 e = _e3[i]; e.x = x; e.y = y; e.z = z; _e3[i] = e; }\n"
+    "func set3vel(i, vx, vy, vz) { Ent3 e = _e3[i]; e.vx = vx; e.vy = vy; e.vz = vz; _e3[i] = e; }\n"
+    "\n"
+    "func me3d(): int { return _hit_me; }\n"
+    "func other3d(): int { return _hit_other; }\n"
+    "\n"
+    "// Sahneyi sıfırla: tüm entity'ler, skor, çarpışma kancaları, oyun-bitti bayrağı.\n"
+    "// Restart (R ile yeniden başlat) ve otomatik testler için. setup fn'i saklı kalır.\n"
+    "func scene3d_reset() {\n"
+    "    _e3 = [];\n"
+    "    _hitA = []; _hitB = []; _hitF = [];\n"
+    "    _score3 = 0;\n"
+    "    _game_over3 = 0;\n"
+    "    _cam_target = 0 - 1;\n"
+    "    // Kamera da sıfırlanır: hedef zaten kayboluyor, mod/açı da setup'ta\n"
+    "    // yeniden kurulur. Bırakılsa yeniden başlatılan sahne önceki turun\n"
+    "    // bakış açısıyla açılırdı.\n"
+    "    _cam_mode3 = CAM_FIXED; _cam_yaw3 = 0.0; _cam_pitch3 = 0.0; _cam_lock3 = 0;\n"
+    "    _hit_me = 0; _hit_other = 0;\n"
+    "}\n"
+    "\n"
+    "func score3d_add(n) { _score3 = _score3 + n; }\n"
+    "func score3d(): int { return _score3; }\n"
+    "func game_over3d() { _game_over3 = 1; }\n"
+    "\n"
+    "// ---- Girdi yardımcıları (klavye VEYA dokunmatik) ---------------------------\n"
+    "// Klavye: WASD/oklar (masaüstü; web'de dokunmatik shell sentetik tuş üretir).\n"
+    "// Native dokunmatik (Android): SOL yarı = sanal joystick (yön), SAĞ yarıya\n"
+    "// dokunuş = zıpla. _read_touch3() her kare play3d içinde çağrılır.\n"
+    "// Yön: W/yukarı = -Z (ileri), S/aşağı = +Z, A/sol = -X, D/sağ = +X.\n"
+    "\n"
+    "float _t_dx = 0.0;      // bu kareki dokunmatik yön (sol joystick)\n"
+    "float _t_dz = 0.0;\n"
+    "int   _t_jump = 0;      // bu karede sağ-yarı zıplama tetiği (edge)\n"
+    "int   _t_jump_prev = 0;\n"
+    "float _tj_cx = 0.0;     // joystick çıpası (ilk dokunuşta oluşur)\n"
+    "float _tj_cy = 0.0;\n"
+    "int   _tj_active = 0;\n"
+    "\n"
+    "// Sağ yarı, kamera dönebiliyorken bir BAKIŞ pedidir: sürükleyince kamera döner,\n"
+    "// dokunup çekince (parmak kaymadan kalkarsa) zıplar. Sabit kamerada eskisi gibi\n"
+    "// yalnız zıplama düğmesi — o modda döndürecek bir şey yok.\n"
+    "float _t_lx = 0.0;      // bu kareki bakış deltası (piksel)\n"
+    "float _t_ly = 0.0;\n"
+    "float _tl_px = 0.0;     // son parmak konumu (delta için)\n"
+    "float _tl_py = 0.0;\n"
+    "int   _tl_active = 0;\n"
+    "float _tl_moved = 0.0;  // parmak toplam ne kadar kaydı (tap ayrımı)\n"
+    "\n"
+    "func _read_touch3() {\n"
+    "    _t_dx = 0.0; _t_dz = 0.0;\n"
+    "    _t_lx = 0.0; _t_ly = 0.0;\n"
+    "    int n = touch_count();\n"
+    "    float halfw = _win_w * 0.5;\n"
+    "    int move_seen = 0;\n"
+    "    int look_seen = 0;\n"
+    "    int jump_now = 0;\n"
+    "    int i = 0;\n"
+    "    while (i < n) {\n"
+    "        float tx = touch_x(i) * 1.0;\n"
+    "        float ty = touch_y(i) * 1.0;\n"
+    "        if (tx < halfw) {\n"
+    "            if (_tj_active == 0) { _tj_cx = tx; _tj_cy = ty; _tj_active = 1; }\n"
+    "            float dx = tx - _tj_cx;\n"
+    "            float dy = ty - _tj_cy;\n"
+    "            float dl = sqrt(dx * dx + dy * dy);\n"
+    "            if (dl > 12.0) { _t_dx = dx / dl; _t_dz = dy / dl; }\n"
+    "            move_seen = 1;\n"
+    "        } else {\n"
+    "            if (_cam_mode3 == CAM_FIXED) {\n"
+    "                jump_now = 1;   // sağ yarı basılı\n"
+    "            } else {\n"
+    "                if (_tl_active == 0) {\n"
+    "                    _tl_px = tx; _tl_py = ty; _tl_active = 1; _tl_moved = 0.0;\n"
+    "                } else {\n"
+    "                    float lx = tx - _tl_px;\n"
+    "                    float ly = ty - _tl_py;\n"
+    "                    _t_lx = lx;\n"
+    "                    _t_ly = ly;\n"
+    "                    _tl_moved = _tl_moved + abs_f3(lx) + abs_f3(ly);\n"
+    "                    _tl_px = tx; _tl_py = ty;\n"
+    "                }\n"
+    "                look_seen = 1;\n"
+    "            }\n"
+    "        }\n"
+    "        i = i + 1;\n"
+    "    }\n"
+    "    if (move_seen == 0) { _tj_active = 0; }\n"
+    "    if (_cam_mode3 == CAM_FIXED) {\n"
+    "        // edge: sağ-yarı yeni basıldıysa zıpla (basılı tutmak tekrar tetiklemez)\n"
+    "        if (jump_now == 1 && _t_jump_prev == 0) { _t_jump = 1; } else { _t_jump = 0; }\n"
+    "        _t_jump_prev = jump_now;\n"
+    "        _tl_active = 0;\n"
+    "    } else {\n"
+    "        // bakış pedinde zıplama parmak KALKINCA tetiklenir: kaymadıysa dokunuştur,\n"
+    "        // kaydıysa bakıştır. (Basma anında tetiklersek her bakış hareketi zıplatır.)\n"
+    "        _t_jump = 0;\n"
+    "        if (look_seen == 0) {\n"
+    "            if (_tl_active == 1 && _tl_moved < 16.0) { _t_jump = 1; }\n"
+    "            _tl_active = 0;\n"
+    "        }\n"
+    "        _t_jump_prev = 0;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "func _in_dx(): float {\n"
+    "    float dx = 0.0;\n"
+    "    if (key_down(K_A)) { dx = dx - 1.0; }\n"
+    "    if (key_down(K_LEFT)) { dx = dx - 1.0; }\n"
+    "    if (key_down(K_D)) { dx = dx + 1.0; }\n"
+    "    if (key_down(K_RIGHT)) { dx = dx + 1.0; }\n"
+    "    if (dx > 1.0) { dx = 1.0; }\n"
+    "    if (dx < 0.0 - 1.0) { dx = 0.0 - 1.0; }\n"
+    "    if (dx == 0.0) { dx = _t_dx; }   // klavye yoksa dokunmatik\n"
+    "    return dx;\n"
+    "}\n"
+    "func _in_dz(): float {\n"
+    "    float dz = 0.0;\n"
+    "    if (key_down(K_W)) { dz = dz - 1.0; }\n"
+    "    if (key_down(K_UP)) { dz = dz - 1.0; }\n"
+    "    if (key_down(K_S)) { dz = dz + 1.0; }\n"
+    "    if (key_down(K_DOWN)) { dz = dz + 1.0; }\n"
+    "    if (dz > 1.0) { dz = 1.0; }\n"
+    "    if (dz < 0.0 - 1.0) { dz = 0.0 - 1.0; }\n"
+    "    if (dz == 0.0) { dz = _t_dz; }   // klavye yoksa dokunmatik\n"
+    "    return dz;\n"
+    "}\n"
+    "func jump_pressed(): bool { return key_pressed(K_SPACE) || _t_jump == 1; }\n"
+    "\n"
+    "// Hareket preset'i: WASD → yatay hız (çapraz normalize). Y hızına dokunmaz\n"
+    "// (yerçekimi/zıplama onu sürer). Hareket varsa entity o yöne döner (yaw).\n"
+    "//\n"
+    "// Yön KAMERAYA GÖREdir: \"ileri\", kameranın baktığı yöndür — kamerayı çevirip\n"
+    "// W'ye basınca yeni yöne gidersin. Sabit kamerada yaw hep 0 olduğu için bu\n"
+    "// dönüşüm birim matristir, yani eski sahnelerde hareket birebir aynı kalır.\n"
+    "func move3d(i, speed) {\n"
+    "    float dx = _in_dx();\n"
+    "    float dz = _in_dz();\n"
+    "    float cy = _cam_yaw3 * DEG2RAD3;\n"
+    "    float cs = cos(cy);\n"
+    "    float sn = sin(cy);\n"
+    "    float wx = dx * cs - dz * sn;\n"
+    "    float wz = dx * sn + dz * cs;\n"
+    "    float m = sqrt(wx * wx + wz * wz);\n"
+    "    Ent3 e = _e3[i];\n"
+    "    if (m > 0.0) {\n"
+    "        e.vx = wx / m * speed;\n"
+    "        e.vz = wz / m * speed;\n"
+    "        e.yaw = atan2(wx, wz) * RAD2DEG3;   // rad→derece, hareket yönüne bak\n"
+    "    } else {\n"
+    "        e.vx = 0.0;\n"
+    "        e.vz = 0.0;\n"
+    "    }\n"
+    "    // Birinci şahısta gövde hareket yönüne değil, BAKIŞ yönüne döner —\n"
+    "    // yoksa geri giderken karakter kameranın içinde ters döner.\n"
+    "    if (_cam_mode3 == CAM_FPS) { e.yaw = _cam_yaw3; }\n"
+    "    _e3[i] = e;\n"
+    "}\n"
+    "\n"
+    "// Zıpla: yalnız zemindeyken.\n"
+    "func jump3d(i, force) {\n"
+    "    Ent3 e = _e3[i];\n"
+    "    if (e.grounded == 1) { e.vy = force; e.grounded = 0; _e3[i] = e; }\n"
+    "}\n"
+    "\n"
+    "// ---- Fizik: hız entegrasyonu + yerçekimi + zemin ---------------------------\n"
+    "func _s3_physics(dt) {\n"
+    "    int n = length(_e3);\n"
+    "    int i = 0;\n"
+    "    while (i < n) {\n"
+    "        Ent3 e = _e3[i];\n"
+    "        if (e.alive == 1) {\n"
+    "            // yerçekimi yalnız oyuncu/düşman/prop'a (duvarlar sabit)\n"
+    "            if (e.tag != TAG_WALL) {\n"
+    "                e.vy = e.vy - _grav * dt;\n"
+    "            }\n"
+    "            e.x = e.x + e.vx * dt;\n"
+    "            e.y = e.y + e.vy * dt;\n"
+    "            e.z = e.z + e.vz * dt;\n"
+    "            // zemin teması\n"
+    "            float half = e.sy * 0.5;\n"
+    "            float floor_y = _ground_y + half;\n"
+    "            if (e.y <= floor_y && e.tag != TAG_WALL) {\n"
+    "                e.y = floor_y;\n"
+    "                if (e.vy < 0.0) { e.vy = 0.0; }\n"
+    "                e.grounded = 1;\n"
+    "            } else {\n"
+    "                if (e.tag != TAG_WALL) { e.grounded = 0; }\n"
+    "            }\n"
+    "            _e3[i] = e;\n"
+    "        }\n"
+    "        i = i + 1;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// ---- AABB örtüşmesi + duvar itme (MTV) -------------------------------------\n"
+    "func _aabb_overlap(a, b): bool {\n"
+    "    Ent3 ea = _e3[a];\n"
+    "    Ent3 eb = _e3[b];\n"
+    "    float dx = ea.x - eb.x; if (dx < 0.0) { dx = 0.0 - dx; }\n"
+    "    float dy = ea.y - eb.y; if (dy < 0.0) { dy = 0.0 - dy; }\n"
+    "    float dz = ea.z - eb.z; if (dz < 0.0) { dz = 0.0 - dz; }\n"
+    "    float rx = (ea.sx + eb.sx) * 0.5;\n"
+    "    float ry = (ea.sy + eb.sy) * 0.5;\n"
+    "    float rz = (ea.sz + eb.sz) * 0.5;\n"
+    "    return dx < rx && dy < ry && dz < rz;\n"
+    "}\n"
+    "\n"
+    "// Oyuncuyu duvardan en küçük örtüşme ekseni boyunca dışarı it (MTV).\n"
+    "func _wall_block(p, w) {\n"
+    "    Ent3 ep = _e3[p];\n"
+    "    Ent3 ew = _e3[w];\n"
+    "    float dx = ep.x - ew.x;\n"
+    "    float dy = ep.y - ew.y;\n"
+    "    float dz = ep.z - ew.z;\n"
+    "    float ox = (ep.sx + ew.sx) * 0.5 - abs_f3(dx);\n"
+    "    float oy = (ep.sy + ew.sy) * 0.5 - abs_f3(dy);\n"
+    "    float oz = (ep.sz + ew.sz) * 0.5 - abs_f3(dz);\n"
+    "    if (ox <= 0.0 || oy <= 0.0 || oz <= 0.0) { return; }\n"
+    "    // en küçük örtüşme eksenini seç, o yönde dışarı it\n"
+    "    if (ox <= oy && ox <= oz) {\n"
+    "        if (dx > 0.0) { ep.x = ep.x + ox; } else { ep.x = ep.x - ox; }\n"
+    "        ep.vx = 0.0;\n"
+    "    } else {\n"
+    "        if (oz <= oy) {\n"
+    "            if (dz > 0.0) { ep.z = ep.z + oz; } else { ep.z = ep.z - oz; }\n"
+    "            ep.vz = 0.0;\n"
+    "        } else {\n"
+    "            if (dy > 0.0) { ep.y = ep.y + oy; if (ep.vy < 0.0) { ep.grounded = 1; } }\n"
+    "            else { ep.y = ep.y - oy; }\n"
+    "            ep.vy = 0.0;\n"
+    "        }\n"
+    "    }\n"
+    "    _e3[p] = ep;\n"
+    "}\n"
+    "\n"
+    "func abs_f3(v): float { if (v < 0.0) { return 0.0 - v; } return v; }\n"
+    "\n"
+    "func _s3_collision() {\n"
+    "    int n = length(_e3);\n"
+    "    // 1) Duvar itme: her canlı oyuncu vs her canlı duvar (otomatik)\n"
+    "    int p = 0;\n"
+    "    while (p < n) {\n"
+    "        Ent3 ep = _e3[p];\n"
+    "        if (ep.alive == 1 && ep.tag == TAG_PLAYER) {\n"
+    "            int w = 0;\n"
+    "            while (w < n) {\n"
+    "                Ent3 ew = _e3[w];\n"
+    "                if (ew.alive == 1 && ew.tag == TAG_WALL && _aabb_overlap(p, w)) {\n"
+    "                    _wall_block(p, w);\n"
+    "                }\n"
+    "                w = w + 1;\n"
+    "            }\n"
+    "        }\n"
+    "        p = p + 1;\n"
+    "    }\n"
+    "    // 2) Kayıtlı çarpışma kancaları: tagA × tagB örtüşürse fn çağır\n"
+    "    int h = 0;\n"
+    "    int hn = length(_hitA);\n"
+    "    while (h < hn) {\n"
+    "        int ta = _hitA[h];\n"
+    "        int tb = _hitB[h];\n"
+    "        int fn = _hitF[h];\n"
+    "        int a = 0;\n"
+    "        while (a < n) {\n"
+    "            Ent3 ea = _e3[a];\n"
+    "            if (ea.alive == 1 && ea.tag == ta) {\n"
+    "                int b = 0;\n"
+    "                while (b < n) {\n"
+    "                    Ent3 eb = _e3[b];\n"
+    "                    if (eb.alive == 1 && eb.tag == tb && a != b && _aabb_overlap(a, b)) {\n"
+    "                        _hit_me = a;\n"
+    "                        _hit_other = b;\n"
+    "                        call(fn);\n"
+    "                    }\n"
+    "                    b = b + 1;\n"
+    "                }\n"
+    "            }\n"
+    "            a = a + 1;\n"
+    "        }\n"
+    "        h = h + 1;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// ---- Kamera: bakış girdisi + üç mod ----------------------------------------\n"
+    "// Bakışı süren üç girdi de aynı açılara yazar:\n"
+    "//   fare   — FPS'te (imleç kilitli) sürekli, yörüngede SAĞ tuş basılıyken.\n"
+    "//            Kilitliyken mouse_x() sabit kalır, o yüzden delta okunur.\n"
+    "//   parmak — ekranın sağ yarısı (bkz. _read_touch3).\n"
+    "//   Q/E    — klavye yedeği: tarayıcıda Pointer Lock verilmediyse ya da\n"
+    "//            farenin olmadığı yerde kamera yine de çevrilebilsin.\n"
+    "func _s3_camera_input(dt) {\n"
+    "    if (_cam_mode3 == CAM_FIXED) { return; }\n"
+    "    float dx = 0.0;\n"
+    "    float dy = 0.0;\n"
+    "    if (_cam_lock3 == 1 || mouse_down(1)) {\n"
+    "        dx = mouse_dx() * _cam_sens3;\n"
+    "        dy = mouse_dy() * _cam_sens3;\n"
+    "    }\n"
+    "    dx = dx + _t_lx * _cam_tsens3;\n"
+    "    dy = dy + _t_ly * _cam_tsens3;\n"
+    "    if (key_down(K_Q)) { dx = dx - 100.0 * dt; }\n"
+    "    if (key_down(K_E)) { dx = dx + 100.0 * dt; }\n"
+    "\n"
+    "    _cam_yaw3 = _cam_yaw3 + dx;\n"
+    "    // Ekran Y'si aşağı büyür: fareyi yukarı itmek dy'yi negatif yapar, yani\n"
+    "    // yukarı bakmak demektir.\n"
+    "    _cam_pitch3 = _cam_pitch3 - dy;\n"
+    "\n"
+    "    if (_cam_yaw3 > 360.0) { _cam_yaw3 = _cam_yaw3 - 360.0; }\n"
+    "    if (_cam_yaw3 < 0.0)   { _cam_yaw3 = _cam_yaw3 + 360.0; }\n"
+    "\n"
+    "    // Eğim sınırı: tam tepeye/dibe gelince kamera \"takla atar\" (up vektörü\n"
+    "    // bakışla hizalanır) — 85° öncesinde kesiyoruz. Yörüngede yukarı bakmak\n"
+    "    // kamerayı yere gömdüğü için üst sınır daha dar.\n"
+    "    float pmax = 85.0;\n"
+    "    if (_cam_mode3 == CAM_ORBIT) { pmax = 25.0; }\n"
+    "    if (_cam_pitch3 > pmax) { _cam_pitch3 = pmax; }\n"
+    "    if (_cam_pitch3 < 0.0 - 85.0) { _cam_pitch3 = 0.0 - 85.0; }\n"
+    "\n"
+    "    // Tekerlekle yakınlaş/uzaklaş (yalnız yörünge — FPS'te mesafe yok).\n"
+    "    if (_cam_mode3 == CAM_ORBIT) {\n"
+    "        float w = mouse_wheel();\n"
+    "        if (w != 0.0) { _cam_dist = _cam_dist - w * 1.5; }\n"
+    "        if (_cam_dist < _cam_min3) { _cam_dist = _cam_min3; }\n"
+    "        if (_cam_dist > _cam_max3) { _cam_dist = _cam_max3; }\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "func _s3_camera() {\n"
+    "    if (_cam_target < 0) {\n"
+    "        camera3d(_cam_dist, _cam_height, _cam_dist,  0.0, 0.0, 0.0, _cam_fov);\n"
+    "        return;\n"
+    "    }\n"
+    "    Ent3 t = _e3[_cam_target];\n"
+    "    if (_cam_mode3 == CAM_FIXED) {\n"
+    "        // Oyuncunun arkasında (+Z) ve yukarıda; oyuncuya bakar.\n"
+    "        camera3d(t.x, t.y + _cam_height, t.z + _cam_dist,   t.x, t.y, t.z,  _cam_fov);\n"
+    "        return;\n"
+    "    }\n"
+    "    // Bakış yönünün yatay bileşeni: yaw 0 → (0,0,-1), yani -Z \"ileri\".\n"
+    "    float yr = _cam_yaw3 * DEG2RAD3;\n"
+    "    float fx = sin(yr);\n"
+    "    float fz = 0.0 - cos(yr);\n"
+    "    if (_cam_mode3 == CAM_FPS) {\n"
+    "        float pr = _cam_pitch3 * DEG2RAD3;\n"
+    "        float ch = cos(pr);\n"
+    "        float eye = _cam_eye3;\n"
+    "        if (eye <= 0.0) { eye = t.sy * 0.35; }   // gövdenin üst tarafı\n"
+    "        float ex = t.x;\n"
+    "        float ey = t.y + eye;\n"
+    "        float ez = t.z;\n"
+    "        camera3d(ex, ey, ez,   ex + fx * ch, ey + sin(pr), ez + fz * ch,  _cam_fov);\n"
+    "        return;\n"
+    "    }\n"
+    "    // Yörünge: hedefin çevresinde bir küre üzerinde. Bakış eğimi negatifken\n"
+    "    // (aşağı bakış) kamera yukarıdadır — o yüzden işaret ters çevriliyor.\n"
+    "    float pr = (0.0 - _cam_pitch3) * DEG2RAD3;\n"
+    "    float horiz = _cam_dist * cos(pr);\n"
+    "    float cx = t.x - fx * horiz;\n"
+    "    float cz = t.z - fz * horiz;\n"
+    "    float cy = t.y + _cam_dist * sin(pr);\n"
+    "    // Kamerayı zeminin altına düşürme — oyuncu bir anda yer katmanının\n"
+    "    // içinden bakmaya başlar (klasik \"kamera yere gömüldü\" görüntüsü).\n"
+    "    if (_ground_on == 1 && cy < _ground_y + 0.8) { cy = _ground_y + 0.8; }\n"
+    "    camera3d(cx, cy, cz,   t.x, t.y, t.z,  _cam_fov);\n"
+    "}\n"
+    "\n"
+    "// ---- Çizim -----------------------------------------------------------------\n"
+    "func _s3_render() {\n"
+    "    if (_ground_on == 1) {\n"
+    "        if (_ground_tex3 >= 0) {\n"
+    "            // Dokulu zemin: renk beyaz olmalı, yoksa doku boyanır.\n"
+    "            texture3d(_ground_tex3, _ground_tile3, _ground_tile3);\n"
+    "            plane(0.0, _ground_y, 0.0,  _ground_sz * 2.0, _ground_sz * 2.0, WHITE);\n"
+    "            no_texture3d();\n"
+    "        } else {\n"
+    "            plane(0.0, _ground_y, 0.0,  _ground_sz * 2.0, _ground_sz * 2.0, rgb(30, 34, 46));\n"
+    "            grid(toInt(_ground_sz), 1.0);\n"
+    "        }\n"
+    "    }\n"
+    "    int n = length(_e3);\n"
+    "    int i = 0;\n"
+    "    while (i < n) {\n"
+    "        Ent3 e = _e3[i];\n"
+    "        int draw_it = 0;\n"
+    "        if (e.alive == 1) { draw_it = 1; }\n"
+    "        // Birinci şahısta kamera gövdenin İÇİNDEdir: çizersek ekranı kendi\n"
+    "        // kutumuzun iç yüzeyi kaplar.\n"
+    "        if (_cam_mode3 == CAM_FPS && i == _cam_target) { draw_it = 0; }\n"
+    "        if (draw_it == 1) {\n"
+    "            if (e.shape == SHAPE_CUBE) {\n"
+    "                cube(e.x, e.y, e.z, e.sx, e.sy, e.sz, e.color);\n"
+    "            } else {\n"
+    "                if (e.shape == SHAPE_SPHERE) {\n"
+    "                    sphere(e.x, e.y, e.z, e.sx * 0.5, e.color);\n"
+    "                } else {\n"
+    "                    if (e.shape == SHAPE_CYL) {\n"
+    "                        cylinder(e.x, e.y - e.sy * 0.5, e.z, e.sx * 0.5, e.sy, e.color);\n"
+    "                    } else {\n"
+    "                        if (e.shape == SHAPE_MODEL && e.model >= 0) {\n"
+    "                            draw_model_rot(e.model, e.x, e.y - e.sy * 0.5, e.z, e.yaw, e.sx, e.color);\n"
+    "                        }\n"
+    "                    }\n"
+    "                }\n"
+    "            }\n"
+    "        }\n"
+    "        i = i + 1;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// ---- Kayıt / kurulum API'si ------------------------------------------------\n"
+    "func scene3d(w, h, title) { _win_w = w; _win_h = h; _win_title = title; }\n"
+    "func on_setup3d(fn)  { _setup3_fn = fn; _has_setup3 = 1; }\n"
+    "func on_update3d(fn) { _update3_fn = fn; _has_update3 = 1; }\n"
+    "func on_hit3d(tagA, tagB, fn) { push(_hitA, tagA); push(_hitB, tagB); push(_hitF, fn); }\n"
+    "\n"
+    "func ground3d(y) { _ground_y = y; _ground_on = 1; }\n"
+    "func no_ground3d() { _ground_on = 0; }\n"
+    "func gravity3d(g) { _grav = g; }\n"
+    "func camera_follow(target, dist, height) {\n"
+    "    _cam_target = target; _cam_dist = dist; _cam_height = height;\n"
+    "    _cam_mode3 = CAM_FIXED; _cam_yaw3 = 0.0; _cam_pitch3 = 0.0;\n"
+    "}\n"
+    "func camera_fov(f) { _cam_fov = f; }\n"
+    "\n"
+    "// ---- Kamera modları --------------------------------------------------------\n"
+    "// YÖRÜNGE (üçüncü şahıs): kamera hedefin çevresinde döner. Fare SAĞ tuşu\n"
+    "// basılıyken sürükle, ekranın sağ yarısına parmakla sürükle ya da Q/E.\n"
+    "// Tekerlek yakınlaştırır. Başlangıç açısı camera_follow ile BİREBİR aynı\n"
+    "// (dist/height aynı anlamda) — fark, artık döndürebilmen.\n"
+    "func camera_orbit(target, dist, height) {\n"
+    "    _cam_target = target;\n"
+    "    _cam_mode3 = CAM_ORBIT;\n"
+    "    _cam_dist = sqrt(dist * dist + height * height);\n"
+    "    _cam_pitch3 = 0.0 - atan2(height, dist) * RAD2DEG3;\n"
+    "    _cam_yaw3 = 0.0;\n"
+    "    _cam_height = height;\n"
+    "}\n"
+    "func kamera_yorunge(target, dist, height) { camera_orbit(target, dist, height); }\n"
+    "\n"
+    "// BİRİNCİ ŞAHIS: kamera hedefin gözünde. Hedef çizilmez (içindesin).\n"
+    "// eye = göz yüksekliği, 0 verirsen gövde boyundan türetilir.\n"
+    "// Masaüstünde imleci kilitler (fareyle sürekli bakış); Escape'in yerine\n"
+    "// camera_lock3d(false) ile bırakabilirsin.\n"
+    "func camera_fps(target, eye) {\n"
+    "    _cam_target = target;\n"
+    "    _cam_mode3 = CAM_FPS;\n"
+    "    _cam_eye3 = eye;\n"
+    "    _cam_yaw3 = 0.0;\n"
+    "    _cam_pitch3 = 0.0;\n"
+    "    _cam_lock3 = 1;\n"
+    "}\n"
+    "func kamera_fpv(target, eye) { camera_fps(target, eye); }\n"
+    "func kamera_birinci_sahis(target, eye) { camera_fps(target, eye); }\n"
+    "\n"
+    "// Bakış hassasiyeti (derece / piksel). Fare ve dokunmatik ayrı ayarlanır.\n"
+    "func camera_sens3d(s) { _cam_sens3 = s; }\n"
+    "func kamera_hassasiyet3d(s) { camera_sens3d(s); }\n"
+    "func camera_touch_sens3d(s) { _cam_tsens3 = s; }\n"
+    "func kamera_dokunma_hassasiyet3d(s) { camera_touch_sens3d(s); }\n"
+    "\n"
+    "// Kamerayı belirli bir açıya çevir (derece): yaw 0 = -Z'ye bakar,\n"
+    "// pitch + = yukarı bakar. Bölüm başında sahneyi çerçevelemek için.\n"
+    "func camera_look3d(yaw, pitch) { _cam_yaw3 = yaw; _cam_pitch3 = pitch; }\n"
+    "func kamera_bak3d(yaw, pitch) { camera_look3d(yaw, pitch); }\n"
+    "func camera_yaw3d(): float { return _cam_yaw3; }\n"
+    "func kamera_yon3d(): float { return _cam_yaw3; }\n"
+    "func camera_pitch3d(): float { return _cam_pitch3; }\n"
+    "func kamera_egim3d(): float { return _cam_pitch3; }\n"
+    "func camera_dist3d(): float { return _cam_dist; }\n"
+    "func kamera_mesafe3d(): float { return _cam_dist; }\n"
+    "\n"
+    "// Tekerlek zoom sınırları (yörünge).\n"
+    "func camera_zoom3d(min_d, max_d) { _cam_min3 = min_d; _cam_max3 = max_d; }\n"
+    "func kamera_zoom3d(min_d, max_d) { camera_zoom3d(min_d, max_d); }\n"
+    "\n"
+    "// İmleç kilidi: açıkken fare pencereye hapsolur ve bakış sürekli fareye bağlı\n"
+    "// olur (FPS'te varsayılan açık). Yörüngede açarsan sağ tuşa basmadan bakarsın.\n"
+    "func camera_lock3d(on) { if (on) { _cam_lock3 = 1; } else { _cam_lock3 = 0; } }\n"
+    "func kamera_kilit3d(on) { camera_lock3d(on); }\n"
+    "// Motorun varsayılan ışığını aç/kapat (setup'tan ÖNCE, kayıt aşamasında çağır).\n"
+    "// Kapatınca her şey eski düz-renk görünümünde çizilir.\n"
+    "func lights3d(on) { if (on) { _lights3 = 1; } else { _lights3 = 0; } }\n"
+    "func isik3d(on)   { lights3d(on); }\n"
+    "// Gölgeleri aç/kapat (setup'tan ÖNCE). Işık kapalıyken zaten çizilmezler.\n"
+    "func shadows3d(on) { if (on) { _shadows3 = 1; } else { _shadows3 = 0; } }\n"
+    "func golge3d(on)   { shadows3d(on); }\n"
+    "// Gölge alanını daralt/genişlet. Sahnen küçükse küçült — gölge keskinleşir.\n"
+    "func shadow_area3d(a) { _shadow_area3 = a; }\n"
+    "func golge_alani3d(a) { shadow_area3d(a); }\n"
+    "\n"
+    "// Gradyan gökyüzünü aç (setup'tan ÖNCE): top = tepe, bottom = ufuk rengi.\n"
+    "//   sky3d(rgb(58, 116, 200), rgb(196, 220, 240));\n"
+    "func sky3d(top, bottom) { _sky3 = 1; _sky_top3 = top; _sky_bot3 = bottom; }\n"
+    "func gokyuzu3d(top, bottom) { sky3d(top, bottom); }\n"
+    "func sky3d_off() { _sky3 = 0; }\n"
+    "func gokyuzu3d_kapat() { sky3d_off(); }\n"
+    "\n"
+    "// Zemini dokula. tile = doku, zemin boyunca kaç kez tekrarlansın (ölçek hissi\n"
+    "// buradan gelir). Doku verilince ızgara çizgileri çizilmez — doku zaten\n"
+    "// yüzeyin ölçeğini gösteriyor.\n"
+    "//   int t = checker(128, 128, 8, rgb(158,166,176), rgb(120,128,140));\n"
+    "//   ground_texture3d(t, 24.0);\n"
+    "func ground_texture3d(t, tile) { _ground_tex3 = t; _ground_tile3 = tile; }\n"
+    "func zemin_doku3d(t, tile)     { ground_texture3d(t, tile); }\n"
+    "\n"
+    "// Mesafe sisi (0 = kapalı, 0.02 hafif pus, 0.06 yoğun). Rengi gökyüzünün\n"
+    "// ufkundan alınır, o yüzden sky3d() ile birlikte kullanılmalı — yoksa\n"
+    "// uzaktaki cisimler koyu varsayılan ufuk rengine karışır.\n"
+    "func fog3d(density) { _fog3 = density; }\n"
+    "func sis3d(density) { fog3d(density); }\n"
+    "\n"
+    "// ---- Yönetilen döngü -------------------------------------------------------\n"
+    "func play3d() {\n"
+    "    if (!window(_win_w, _win_h, _win_title)) { return; }\n"
+    "    set_fps(60);\n"
+    "    // Işıklandırma VARSAYILAN AÇIK — motoru kullanan oyun sıfır konfigürasyonla\n"
+    "    // düz renkli kutular yerine gölgeli yüzeyler görsün. Kapatmak için oyun\n"
+    "    // kodunda isik3d(false) çağır; kendi ışığını kurmak istersen setup içinde\n"
+    "    // sun()/point_light() çağırman yeter (bunlar varsayılanı ezer).\n"
+    "    if (_lights3 == 1) {\n"
+    "        lights_on();\n"
+    "        sun(0.0 - 0.55, 0.0 - 1.0, 0.0 - 0.35, rgb(255, 246, 224));\n"
+    "        ambient_light(rgb(46, 50, 66));\n"
+    "        // Gölgeler de varsayılan açık — cismin yerde durduğu hissi gölgeyle\n"
+    "        // gelir. Donanım kuramazsa tame sessizce ışıkla devam eder (oyun\n"
+    "        // çalışmaya devam eder, sadece gölgesiz), golge3d(false) ile kapat.\n"
+    "        if (_shadows3 == 1) {\n"
+    "            shadows_on();\n"
+    "            shadow_area(_shadow_area3);\n"
+    "        }\n"
+    "    }\n"
+    "    if (_sky3 == 1) { sky(_sky_top3, _sky_bot3); }\n"
+    "    // Sis, gökyüzü ayarlandıktan SONRA — rengini onun ufkundan alıyor.\n"
+    "    if (_fog3 > 0.0) { fog_sky(_fog3); }\n"
+    "    if (_has_setup3 == 1) { call(_setup3_fn); }\n"
+    "    // İmleç kilidi setup'tan SONRA kuruluyor — kamera modunu setup içinde\n"
+    "    // seçmek serbest (camera_fps varsayılan olarak kilidi ister).\n"
+    "    int _lock_was = 0 - 1;\n"
+    "\n"
+    "    while (running()) {\n"
+    "        float dt = frame_time();\n"
+    "        if (dt <= 0.0) { dt = 0.0166667; }\n"
+    "        if (dt > 0.05) { dt = 0.05; }\n"
+    "\n"
+    "        if (_cam_lock3 != _lock_was) { cursor_lock(_cam_lock3); _lock_was = _cam_lock3; }\n"
+    "        _read_touch3();   // dokunmatik durumunu güncelle (move3d/jump_pressed okur)\n"
+    "        // Bakış, update'ten ÖNCE: oyunun update'i camera_yaw3d() okuyabilsin ve\n"
+    "        // move3d bu karenin kamera yönünü kullansın (bir kare gecikme olmaz).\n"
+    "        _s3_camera_input(dt);\n"
+    "        if (_has_update3 == 1 && _game_over3 == 0) { call(_update3_fn); }\n"
+    "        if (_game_over3 == 0) {\n"
+    "            _s3_physics(dt);\n"
+    "            _s3_collision();\n"
+    "        }\n"
+    "\n"
+    "        frame_begin();\n"
+    "        clear(rgb(16, 18, 26));\n"
+    "        _s3_camera();\n"
+    "        space_begin();\n"
+    "            _s3_render();\n"
+    "        space_end();\n"
+    "\n"
+    "        text(_win_title, 12, 10, 20, RAYWHITE);\n"
+    "        text(\"Skor: \" + toString(_score3), 12, 34, 18, GOLD);\n"
+    "\n"
+    "        // Dokunmatik ipucu (yalnız parmak ekrandayken): sol joystick + sağ ped.\n"
+    "        if (_tj_active == 1) {\n"
+    "            circle(toInt(_tj_cx), toInt(_tj_cy), 44.0, rgba(120, 140, 180, 60));\n"
+    "            circle(toInt(_tj_cx + _t_dx * 30.0), toInt(_tj_cy + _t_dz * 30.0), 20.0, rgba(200, 220, 255, 150));\n"
+    "            circle(toInt(_win_w) - 70, toInt(_win_h) - 70, 40.0, rgba(255, 210, 90, 80));\n"
+    "            if (_cam_mode3 == CAM_FIXED) {\n"
+    "                text(\"ZIP\", toInt(_win_w) - 92, toInt(_win_h) - 80, 18, RAYWHITE);\n"
+    "            } else {\n"
+    "                // Bu modda sağ yarı bakış pedi: sürükle = bak, dokun = zıpla.\n"
+    "                text(\"BAK\", toInt(_win_w) - 92, toInt(_win_h) - 80, 18, RAYWHITE);\n"
+    "            }\n"
+    "        }\n"
+    "        if (_game_over3 == 1) {\n"
+    "            text(\"OYUN BITTI\", toInt(_win_w * 0.5) - 70, toInt(_win_h * 0.5), 30, rgb(255, 90, 90));\n"
+    "        }\n"
+    "        frame_end();\n"
+    "    }\n"
+    "    close_window();\n"
+    "}\n"
+    "\n"
+    "// ---- Türkçe alias'lar ------------------------------------------------------\n"
+    "func uret3(x, y, z, sx, sy, sz, color, shape, tag): int { return spawn3(x, y, z, sx, sy, sz, color, shape, tag); }\n"
+    "func oldur3(i) { kill3d(i); }\n"
+    "func hareket3(i, speed) { move3d(i, speed); }\n"
+    "func zipla3(i, force) { jump3d(i, force); }\n"
+    "func ziplandi(): bool { return jump_pressed(); }\n"
+    "func skor3_ekle(n) { score3d_add(n); }\n"
+    "func ben3(): int { return me3d(); }\n"
+    "func oteki3(): int { return other3d(); }\n"
+    "func sahne3d(w, h, title) { scene3d(w, h, title); }\n"
+    "func kurulumda3(fn) { on_setup3d(fn); }\n"
+    "func her_kare3(fn) { on_update3d(fn); }\n"
+    "func carpisinca3(tagA, tagB, fn) { on_hit3d(tagA, tagB, fn); }\n"
+    "func zemin3(y) { ground3d(y); }\n"
+    "func yercekimi3(g) { gravity3d(g); }\n"
+    "func kamera_takip(target, dist, height) { camera_follow(target, dist, height); }\n"
+    "func oyna3d() { play3d(); }\n"
+    "";
+
+// ========================================
+// Library Lookup
+// ========================================
+static const char* get_embedded_lib(const char *name) {
+    if (strcmp(name, "wings") == 0) return EMBEDDED_WINGS;
+    if (strcmp(name, "router") == 0) return EMBEDDED_ROUTER;
+    if (strcmp(name, "http_utils") == 0) return EMBEDDED_HTTP_UTILS;
+    if (strcmp(name, "http") == 0) return EMBEDDED_HTTP_UTILS;
+    if (strcmp(name, "async") == 0) return EMBEDDED_ASYNC;
+    if (strcmp(name, "middleware") == 0) return EMBEDDED_MIDDLEWARE;
+    if (strcmp(name, "socket") == 0) return EMBEDDED_SOCKET;
+    if (strcmp(name, "tulpar_api") == 0) return EMBEDDED_TULPAR_API;
+    if (strcmp(name, "test") == 0) return EMBEDDED_TEST;
+    if (strcmp(name, "http_client") == 0) return EMBEDDED_HTTP_CLIENT;
+    if (strcmp(name, "orm") == 0) return EMBEDDED_ORM;
+    if (strcmp(name, "wings_tls") == 0) return EMBEDDED_WINGS_TLS;
+    if (strcmp(name, "tame") == 0) return EMBEDDED_TAME;
+    if (strcmp(name, "arcade") == 0) return EMBEDDED_ARCADE;
+    if (strcmp(name, "scene3d") == 0) return EMBEDDED_SCENE3D;
+    return NULL;
+}
+
+#endif // TULPAR_EMBEDDED_LIBS_H
@@ -37,7 +37,7 @@ const BuiltinEntry kBuiltins[] = {
     {"substring",    "substring(s: str, start: int, end: int): str", "[start, end) aralığını döner."},
     {"ord",          "ord(s: str, i: int): int",                    "s'nin i. byte'ının işaretsiz değeri (0-255); i aralık dışıysa -1. String'ler UTF-8 byte dizisi olduğundan (length/substring byte-tabanlı) elle UTF-8 işleme için — örn. tam bir çok-byte kod noktasını silmek (0x80-0xBF devam byte'larını geri sayarak)."},
     {"contains",     "contains(s: str, needle: str): bool",         "Alt string araması."},
-    {"range",        "range(n: int): array<int>",                   "[0, n) aralığında dizi üretir."},
+    {"range",        "range(start?: int, end: int, step?: int): array<int>", "[0, n) ya da [start, end) aralığında (step adımıyla) dizi üretir. for-in içinde dizi oluşturulmaz, sayaçlı döngüye derlenir."},
 
     // ---- tame (2D oyun) native katmanı — `import "tame"` sarmalayıcılarının altı.
     // Renk = paketlenmiş int 0xRRGGBBAA (lib/tame.tpr: rgb()/rgba() + adlı renkler).
@@ -189,6 +189,7 @@ const BuiltinEntry kBuiltins[] = {
     {"write_file",   "write_file(path: str, data: str): bool",      "Dosyayı yeniden yazar."},
     {"append_file",  "append_file(path: str, data: str): bool",     "Dosyaya ekler."},
     {"file_exists",  "file_exists(path: str): bool",                "Dosya/dizin var mı?"},
+    {"file_delete",  "file_delete(path: str): bool",                "Dosyayı siler; silinemezse false döner."},
 
     // ---- System ----
     {"sys_run",      "sys_run(cmd: str): int",                      "Kabuk komutunu çalıştırır; çıktı canlı akar, exit code döner (0=başarı)."},
@@ -214,6 +215,16 @@ const BuiltinEntry kBuiltins[] = {
     {"db_execute",   "db_execute(handle: int, sql: str, params?: array): bool",      "INSERT/UPDATE/DELETE yürütür. Opsiyonel params dizisi ? yer tutucularına bağlanır (injection-safe)."},
     {"db_query",     "db_query(handle: int, sql: str, params?: array): array<json>", "SELECT döner. Opsiyonel params dizisi ? yer tutucularına bağlanır (injection-safe)."},
     {"db_last_insert_id", "db_last_insert_id(handle: int): int",    ""},
+    {"db_cursor",    "db_cursor(handle: int, sql: str, params?: array): int", "SELECT'i satır satır okumak için cursor açar; sonuç kümesi belleğe alınmaz. db_next ile ilerlenir."},
+    {"db_next",      "db_next(cursor: int): json",                  "Sıradaki satırı döner; satırlar bitince 0 döner ve cursor kendiliğinden kapanır."},
+    {"db_close_cursor", "db_close_cursor(cursor: int): void",       "Cursor'ı erken bırakır (tüm satırlar okunmadan çıkılırken)."},
+    {"db_query_columns", "db_query_columns(handle: int, sql: str, params?: array): json", "Sonucu kolon bazında döner: {kolon: [değerler]}. Analitik okumalarda satır başına nesne oluşturmaz."},
+    {"db_prepare",   "db_prepare(handle: int, sql: str): int",     "SQL'i bir kez hazırlar ve tekrar kullanılabilir statement handle döner (hata: 0). LRU cache'ten düşürülmez."},
+    {"db_stmt_query", "db_stmt_query(stmt: int, params?: array): array", "Hazırlanmış statement'ı çalıştırır, satırları db_query gibi döner."},
+    {"db_stmt_execute", "db_stmt_execute(stmt: int, params?: array): bool", "Hazırlanmış statement'ı çalıştırır (INSERT/UPDATE/DELETE)."},
+    {"db_stats",     "db_stats(): json",                          "Statement cache sayaçları: stmt_cache_hits/misses/evictions, stmt_cache_capacity, prepared."},
+    {"db_executemany", "db_executemany(handle: int, sql: str, rows: array): bool", "Tek statement'ı satır dizisi (param dizilerinin dizisi) üzerinde tek transaction içinde çalıştırır; ya hepsi ya hiçbiri."},
+    {"db_group_commit", "db_group_commit(handle: int, on: bool): bool", "Parametreli yazmaları tek bir yazıcı thread'de ortak transaction'larda toplar (group commit). Yalnızca dosya tabanlı DB."},
     {"db_error",     "db_error(handle: int): str",                  "Son hatayı döner."},
 
     // ---- HTTP ----
@@ -245,6 +256,9 @@ const BuiltinEntry kBuiltins[] = {
     {"text",                "text(body: str): json",                "text/plain yanıt zarfı."},
     {"with_status",         "with_status(data: json, status: int): json", "Herhangi bir HTTP durum kodu ile yanıt."},
     {"persist",             "persist(value): value",                "Bir değeri kalıcı belleğe derin kopyalar (arena reset'ten sağ çıkar). In-memory global'lerde sakla: push(_users, persist(u))."},
+    {"arc_stats",           "arc_stats(): json",                    "ARC serbest bırakma sayaçları: freed_objects/bytes, pending_objects/bytes (ertelenen), deferred_releases, free_budget."},
+    {"arc_drain",           "arc_drain(): int",                     "Bu thread'de kuyrukta bekleyen ARC serbest bırakmalarını hemen yapar; serbest bırakılan nesne sayısını döner."},
+    {"arena_stats",         "arena_stats(): json",                  "Arena sayaçları (tüm thread'ler): bytes, peak_bytes, blocks, huge_blocks/allocs, trims, trimmed_bytes, keep_blocks, trim_after."},
 
     // ---- Wings DX katmanı (WINGS_DX.md) — kısa isimler + resource ----
     {"resource",            "resource(path: str, model: json, opts?: json): void", "ORM model handle'ından otomatik REST CRUD: GET/POST path, GET/PUT/DELETE path/:id + türetilmiş body_schema (422) + /docs. opts: {\"only\": [...]} / {\"except\": [...]}."},
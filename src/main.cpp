@@ -68,6 +68,12 @@ static void print_help() {
   std::printf("  tulpar <source.tpr>              %s\n",
               tulpar::i18n::tr_en("- Programi calistir (AOT, native hiz)",
                                   "- Run program (AOT, native speed)"));
+  std::printf("  tulpar --jit <source.tpr>        %s\n",
+              tulpar::i18n::tr_en(
+                  "- Gecici binary yerine suretin icinde JIT ile calistir "
+                  "(TULPAR_RUN_MODE=jit|aot)",
+                  "- Run in-process via JIT instead of a temp binary "
+                  "(TULPAR_RUN_MODE=jit|aot)"));
   std::printf("  tulpar build <source.tpr> [out]  %s\n",
               tulpar::i18n::tr_en("- Bagimsiz native ikili olustur",
                                   "- Build standalone native binary"));
@@ -101,6 +107,26 @@ static void print_help() {
               tulpar::i18n::tr_en(
                   "- run/build oncesi tip uyarilarini kapat",
                   "- Disable pre-build [typecheck] warnings"));
+  std::printf("  -j N, --jobs=N                   %s\n",
+              tulpar::i18n::tr_en(
+                  "- Optimizasyon + obje uretimini N parcada paralel yap "
+                  "(TULPAR_BUILD_JOBS; -j0 = cekirdek sayisi)",
+                  "- Optimise + emit in N parallel partitions "
+                  "(TULPAR_BUILD_JOBS; -j0 = one per core)"));
+  std::printf("  --allocator=tulpar|system        %s\n",
+              tulpar::i18n::tr_en(
+                  "- Nesne bellek ayiricisi (varsayilan tulpar: thread "
+                  "basina onbellekli; system = platform malloc)",
+                  "- Object allocator (default tulpar: thread-caching; "
+                  "system = platform malloc)"));
+  std::printf("  --checks=full|release|none       %s\n",
+              tulpar::i18n::tr_en(
+                  "- Calisma zamani kontrolleri (varsayilan release: kanitli "
+                  "dizi erisimlerinde sinir kontrolu yok; full = tum sinir "
+                  "kontrolleri + tam sayi tasmasi; none = sinir kontrolu yok)",
+                  "- Runtime checks (default release: no bounds check on "
+                  "proven array accesses; full = every bounds check + int "
+                  "overflow; none = no bounds checks)"));
   std::printf("  --strict                         %s\n",
               tulpar::i18n::tr_en(
                   "- [typecheck] uyarilarini hata olarak ele al "
@@ -257,6 +283,71 @@ int main(int argc, char **argv) {
       aab_package = 1;
     }
   }
+  // -j N / -jN / --jobs=N: optimise + emit in N parallel partitions
+  // (aot_set_build_jobs). Position-independent like the target flags; -j0
+  // means one job per hardware thread. `jobs_value_idx` is the argv slot of
+  // a detached `-j N` value so the positional scans below skip it.
+  int build_jobs = 0;
+  int jobs_value_idx = -1;
+  for (int i = 1; i < argc; i++) {
+    const char *v = nullptr;
+    if (strncmp(argv[i], "--jobs=", 7) == 0) {
+      v = argv[i] + 7;
+    } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+      v = argv[i + 1];
+      jobs_value_idx = i + 1;
+    } else if (strncmp(argv[i], "-j", 2) == 0 && argv[i][2] >= '0' &&
+               argv[i][2] <= '9') {
+      v = argv[i] + 2;
+    }
+    if (v) {
+      int n = atoi(v);
+      build_jobs = n > 0 ? n : -1;
+    }
+  }
+#ifdef TULPAR_AOT_ENABLED
+  if (build_jobs) aot_set_build_jobs(build_jobs);
+#endif
+  // --allocator=tulpar|system: the allocator the program's runtime uses for
+  // objects (runtime/tulpar_alloc.h). Position-independent; applies to
+  // `tulpar build` and to plain runs. An explicit choice skips the build
+  // cache below, which only compares timestamps.
+  int allocator_given = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--allocator=", 12) != 0) continue;
+    const char *v = argv[i] + 12;
+    if (strcmp(v, "tulpar") != 0 && strcmp(v, "system") != 0) {
+      std::fprintf(stderr,
+                   "[build] --allocator='%s' taninmadi (tulpar|system).\n", v);
+      return 1;
+    }
+    allocator_given = 1;
+#ifdef TULPAR_AOT_ENABLED
+    aot_set_allocator(strcmp(v, "system") == 0);
+#endif
+  }
+  // --checks=full|release|none: which runtime checks the AOT build keeps
+  // (ChecksMode in aot/llvm_backend.hpp). Skips the build cache like
+  // --allocator.
+  int checks_given = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--checks=", 9) != 0) continue;
+    const char *v = argv[i] + 9;
+    int level = strcmp(v, "release") == 0 ? 0
+                : strcmp(v, "full") == 0  ? 1
+                : strcmp(v, "none") == 0  ? 2
+                                          : -1;
+    if (level < 0) {
+      std::fprintf(stderr,
+                   "[build] --checks='%s' taninmadi (full|release|none).\n",
+                   v);
+      return 1;
+    }
+    checks_given = 1;
+#ifdef TULPAR_AOT_ENABLED
+    aot_set_checks(level);
+#endif
+  }
   int skip_typecheck = 0;  // --no-typecheck disables the pre-pass warnings
   // Plan 07 PR 1: `tulpar build --debug` (or `-g`) requests an AOT
   // build that keeps debug symbols. Today this just forwards `-g` to
@@ -301,6 +392,7 @@ int main(int argc, char **argv) {
 
   // Parse flags
   for (int i = 1; i < argc; i++) {
+    if (i == jobs_value_idx) continue;  // value of a detached `-j N`
 
     if (strcmp(argv[i], "--vm") == 0 || strcmp(argv[i], "--run") == 0) {
       // AOT-only (see CLAUDE.md): the bytecode VM execution path is gone.
@@ -322,6 +414,14 @@ int main(int argc, char **argv) {
       // Promote `[typecheck]` warnings to exit-blocking errors. Format
       // stays the same; we just summarise and exit 1 when count > 0.
       strict_typecheck = 1;
+    } else if (strcmp(argv[i], "--jit") == 0 ||
+               strcmp(argv[i], "--no-jit") == 0) {
+      // `tulpar --jit foo.tpr`: run in-process through ORC LLJIT instead of
+      // linking + exec'ing a temp binary (TULPAR_RUN_MODE=jit|aot is the
+      // env form). Doesn't shift arg_offset on its own.
+#ifdef TULPAR_AOT_ENABLED
+      aot_set_run_jit(argv[i][2] == 'j');
+#endif
     } else if (strcmp(argv[i], "--debug") == 0 ||
                strcmp(argv[i], "-g") == 0) {
       // `tulpar build --debug` opt-in. Doesn't shift arg_offset on its
@@ -412,7 +512,7 @@ int main(int argc, char **argv) {
     const char *src_arg = nullptr;
     const char *out_arg = nullptr;
     for (int i = arg_offset + 1; i < argc; i++) {
-      if (argv[i][0] == '-') continue;
+      if (argv[i][0] == '-' || i == jobs_value_idx) continue;
       if (!src_arg) src_arg = argv[i];
       else if (!out_arg) out_arg = argv[i];
     }
@@ -496,7 +596,8 @@ int main(int argc, char **argv) {
       const char *nocache = getenv("TULPAR_AOT_NOCACHE");
       // Web hedefinde cache atlanır: stat edilecek dosya .html/.js/.wasm
       // üçlüsü ve buradaki native yol yanlış pozitif "up-to-date" üretir.
-      if (!web_target && !(nocache && *nocache && *nocache != '0')) {
+      if (!web_target && !allocator_given && !checks_given &&
+          !(nocache && *nocache && *nocache != '0')) {
         char exe_path[512];
 #ifdef _WIN32
         snprintf(exe_path, sizeof(exe_path), "%s.exe", output_name);
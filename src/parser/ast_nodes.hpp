@@ -347,6 +347,7 @@ struct ContinueStatement {
 
 struct Block {
     std::vector<std::unique_ptr<ASTNode>> statements;
+    bool unchecked = false;                    // `unchecked { ... }`
     SourceLocation loc;
     
     Block(std::vector<std::unique_ptr<ASTNode>> stmts, SourceLocation l)
@@ -421,6 +421,16 @@ std::unique_ptr<ASTNode> Parser::parse_statement() {
     if (check(TOKEN_LBRACE)) {
         return parse_block();
     }
+    // `unchecked { ... }` — a block whose array accesses skip the bounds
+    // check in AOT builds. Contextual like `as`: only an identifier that is
+    // directly followed by `{`, so a variable named `unchecked` still works.
+    if (check(TOKEN_IDENTIFIER) && current().value() == "unchecked" &&
+        peek().type() == TOKEN_LBRACE) {
+        advance(); // consume 'unchecked'
+        auto block = parse_block();
+        std::get<Block>(block->value).unchecked = true;
+        return block;
+    }
     
     // Expression statement
     return parse_expression_statement();
@@ -1753,6 +1763,7 @@ static ASTNode_C* convert_ast_node(const ASTNode& node) {
             set_loc(out, n.loc);
         } else if constexpr (std::is_same_v<T, Block>) {
             out->type = AST_BLOCK;
+            out->is_unchecked = n.unchecked ? 1 : 0;
             out->statement_count = static_cast<int>(n.statements.size());
             if (out->statement_count > 0) {
                 out->statements = static_cast<ASTNode_C**>(std::calloc(out->statement_count, sizeof(ASTNode_C*)));
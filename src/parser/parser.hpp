@@ -162,6 +162,7 @@ typedef struct ASTNode_C {
   
   uint8_t is_moved;
   uint8_t is_async; // AST_FUNCTION_DECL: declared with `async`
+  uint8_t is_unchecked; // AST_BLOCK: `unchecked { ... }`, no bounds checks
 
   struct ASTNode_C *condition;
   struct ASTNode_C *then_branch;
@@ -704,7 +704,9 @@ static void register_builtin_signatures(TypeInferContext *ctx) {
       {"length", TYPE_INT, {TYPE_UNKNOWN}},
       {"len", TYPE_INT, {TYPE_UNKNOWN}},
       // Range / iteration
-      {"range", TYPE_ARRAY_INT, {TYPE_INT}},
+      // range(end) / range(start, end) / range(start, end, step) — too few
+      // args is allowed, so one signature covers all three.
+      {"range", TYPE_ARRAY_INT, {TYPE_INT, TYPE_INT, TYPE_INT}},
       // Object/json keys — returns a string array of field names.
       {"keys", TYPE_ARRAY_STR, {TYPE_UNKNOWN}},
       {"values", TYPE_ARRAY, {TYPE_UNKNOWN}},
@@ -927,6 +929,7 @@ static void register_builtin_signatures(TypeInferContext *ctx) {
       {"read_file", TYPE_STRING, {TYPE_STRING}},
       {"append_file", TYPE_BOOL, {TYPE_STRING, TYPE_STRING}},
       {"file_exists", TYPE_BOOL, {TYPE_STRING}},
+      {"file_delete", TYPE_BOOL, {TYPE_STRING}},
       // System / process
       {"sys_run", TYPE_INT, {TYPE_STRING}},
       // Regex (std::regex ECMAScript; match = full-string, search = substring)
@@ -965,6 +968,20 @@ static void register_builtin_signatures(TypeInferContext *ctx) {
       // allowed, so both db_query(db,sql) and db_query(db,sql,params) pass.
       {"db_query", TYPE_UNKNOWN, {TYPE_UNKNOWN, TYPE_STRING, TYPE_UNKNOWN}},
       {"db_execute", TYPE_BOOL, {TYPE_UNKNOWN, TYPE_STRING, TYPE_UNKNOWN}},
+      {"db_cursor", TYPE_UNKNOWN, {TYPE_UNKNOWN, TYPE_STRING, TYPE_UNKNOWN}},
+      {"db_next", TYPE_UNKNOWN, {TYPE_UNKNOWN}},
+      {"db_close_cursor", TYPE_VOID, {TYPE_UNKNOWN}},
+      {"db_query_columns", TYPE_UNKNOWN,
+       {TYPE_UNKNOWN, TYPE_STRING, TYPE_UNKNOWN}},
+      {"db_prepare", TYPE_UNKNOWN, {TYPE_UNKNOWN, TYPE_STRING}},
+      {"db_stmt_query", TYPE_UNKNOWN, {TYPE_UNKNOWN, TYPE_UNKNOWN}},
+      {"db_stmt_execute", TYPE_BOOL, {TYPE_UNKNOWN, TYPE_UNKNOWN}},
+      {"db_stats", TYPE_UNKNOWN, {}},
+      {"arc_stats", TYPE_UNKNOWN, {}},
+      {"arc_drain", TYPE_INT, {}},
+      {"arena_stats", TYPE_UNKNOWN, {}},
+      {"db_executemany", TYPE_BOOL, {TYPE_UNKNOWN, TYPE_STRING, TYPE_UNKNOWN}},
+      {"db_group_commit", TYPE_BOOL, {TYPE_UNKNOWN, TYPE_UNKNOWN}},
       // Array mutation — `push(arr, val)` accepts any value type.
       {"push", TYPE_VOID, {TYPE_UNKNOWN, TYPE_UNKNOWN}},
   };
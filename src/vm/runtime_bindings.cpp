@@ -7,6 +7,9 @@
 #include "../common/platform_threads.h"
 #include "../pkg/sha256.hpp"
 #include "../../runtime/tulpar_gzip.h"
+#include "../../runtime/tulpar_json.h"
+#include "../../runtime/tulpar_alloc.h"
+#include "../../runtime/tulpar_arc.h"
 #include "vm.hpp"
 
 // Windows MSVC compatibility: ssize_t is not standard on Windows
@@ -29,12 +32,15 @@ typedef SSIZE_T ssize_t;
 #include <random>
 #include <algorithm>
 #include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <filesystem>
+#include <list>
 #include <mutex>
 #include <regex>
-#include <unordered_set>
 #include <unordered_map>
 #include <string>
+#include <thread>
 #include <vector>
 #ifdef _WIN32
 #include <conio.h>     // _getch — single-key (raw) input for read_key
@@ -44,6 +50,7 @@ typedef SSIZE_T ssize_t;
 #include <unistd.h>    // read / STDIN_FILENO
 #include <sys/ioctl.h> // TIOCGWINSZ / winsize — terminal size for term_width/height
 #include <sys/select.h>// select() — timed key wait for read_key_timeout
+#include <sys/mman.h>  // mmap / munmap — arena blocks (see Arena trimming)
 #endif
 
 // EXTERN "C" BLOCK - AOT Runtime Functions (called from LLVM compiled code)
@@ -62,6 +69,8 @@ extern "C" {
 
 #define AOT_ARENA_BLOCK_SIZE (1024 * 1024) // 1MB blocks
 #define AOT_ARENA_ALIGNMENT 8
+// Single allocations above this bypass the block chain (see HUGE ALLOCATIONS).
+#define AOT_ARENA_HUGE_SIZE (AOT_ARENA_BLOCK_SIZE / 4)
 
 typedef struct AOTArenaBlock {
   char *memory;
@@ -74,6 +83,10 @@ typedef struct {
   AOTArenaBlock *current;
   AOTArenaBlock *head;
   size_t total_allocated;
+  int blocks;           // length of the head chain
+  int idle_rewinds;     // rewinds in a row that stayed within the keep limit
+  AOTArenaBlock *huge;  // dedicated oversized blocks, newest first
+  int huge_count;       // length of `huge` (checkpoints record it)
 } AOTArena;
 
 // Per-thread arena. Originally a single global — fine for the
@@ -480,6 +493,72 @@ void aot_runtime_init(void) {
 #endif
 }
 
+// ---------------------------------------------------------------------------
+// Arena trimming + statistics.
+//
+// A rewind (arena_restore / arena_drop) keeps every block of the chain for
+// the next request — that is what makes the arena fast. But one request that
+// builds a 500 MB report used to pin those 500 blocks in its worker thread
+// forever (times the listen_pool size). Policy, per thread:
+//
+//   - keep the first TULPAR_ARENA_KEEP_BLOCKS blocks (default 4 = 4 MB);
+//   - once TULPAR_ARENA_TRIM_AFTER rewinds in a row (default 32) got by
+//     within that limit, unmap the surplus blocks. A burst followed by
+//     quiet traffic gives the memory back; steady big requests keep theirs.
+//
+// Block memory is mapped straight from the OS (mmap / VirtualAlloc) rather
+// than malloc'd: a freed 1 MB malloc chunk can stay inside the allocator's
+// heap, an unmapped block leaves RSS immediately.
+//
+// Counters are process-wide (all worker arenas) and surface through
+// arena_stats() and Wings /metrics.
+// ---------------------------------------------------------------------------
+static int g_arena_keep_blocks = -1; // -1: not read from the environment yet
+static int g_arena_trim_after = -1;
+static std::atomic<int64_t> g_arena_bytes{0};      // mapped right now
+static std::atomic<int64_t> g_arena_peak_bytes{0};
+static std::atomic<int64_t> g_arena_blocks{0};     // chain blocks, all threads
+static std::atomic<int64_t> g_arena_huge_live{0};
+static std::atomic<int64_t> g_arena_huge_allocs{0};
+static std::atomic<int64_t> g_arena_trims{0};
+static std::atomic<int64_t> g_arena_trimmed_bytes{0};
+
+static void aot_arena_policy_init(void) {
+  if (g_arena_keep_blocks >= 0)
+    return;
+  const char *keep = getenv("TULPAR_ARENA_KEEP_BLOCKS");
+  const char *after = getenv("TULPAR_ARENA_TRIM_AFTER");
+  int k = keep && *keep ? atoi(keep) : 4;
+  int a = after && *after ? atoi(after) : 32;
+  g_arena_trim_after = a > 0 ? a : 0;
+  g_arena_keep_blocks = k > 1 ? k : 1;
+}
+
+static char *aot_arena_map(size_t size) {
+#if PLATFORM_WINDOWS
+  return static_cast<char *>(
+      VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+#elif defined(__EMSCRIPTEN__)
+  return static_cast<char *>(malloc(size));
+#else
+  void *p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  return p == MAP_FAILED ? nullptr : static_cast<char *>(p);
+#endif
+}
+
+static void aot_arena_unmap(char *memory, size_t size) {
+#if PLATFORM_WINDOWS
+  (void)size;
+  VirtualFree(memory, 0, MEM_RELEASE);
+#elif defined(__EMSCRIPTEN__)
+  (void)size;
+  free(memory);
+#else
+  munmap(memory, size);
+#endif
+}
+
 static AOTArenaBlock *aot_arena_new_block(size_t min_size) {
   size_t size =
       min_size > AOT_ARENA_BLOCK_SIZE ? min_size : AOT_ARENA_BLOCK_SIZE;
@@ -487,7 +566,7 @@ static AOTArenaBlock *aot_arena_new_block(size_t min_size) {
   if (!block)
     return nullptr;
 
-  block->memory = static_cast<char*>(malloc(size));
+  block->memory = aot_arena_map(size);
   if (!block->memory) {
     free(block);
     return nullptr;
@@ -495,13 +574,24 @@ static AOTArenaBlock *aot_arena_new_block(size_t min_size) {
   block->size = size;
   block->used = 0;
   block->next = nullptr;
+  int64_t now = g_arena_bytes.fetch_add((int64_t)size) + (int64_t)size;
+  int64_t peak = g_arena_peak_bytes.load(std::memory_order_relaxed);
+  while (now > peak && !g_arena_peak_bytes.compare_exchange_weak(peak, now)) {
+  }
   return block;
 }
 
+static void aot_arena_free_block(AOTArenaBlock *block) {
+  g_arena_bytes.fetch_sub((int64_t)block->size);
+  aot_arena_unmap(block->memory, block->size);
+  free(block);
+}
+
 static void aot_arena_init(void) {
   if (g_aot_string_arena)
     return;
 
+  aot_arena_policy_init();
   g_aot_string_arena = static_cast<AOTArena*>(malloc(sizeof(AOTArena)));
   if (!g_aot_string_arena)
     return;
@@ -509,6 +599,41 @@ static void aot_arena_init(void) {
   g_aot_string_arena->head = aot_arena_new_block(AOT_ARENA_BLOCK_SIZE);
   g_aot_string_arena->current = g_aot_string_arena->head;
   g_aot_string_arena->total_allocated = 0;
+  g_aot_string_arena->blocks = g_aot_string_arena->head ? 1 : 0;
+  g_aot_string_arena->idle_rewinds = 0;
+  g_aot_string_arena->huge = nullptr;
+  g_aot_string_arena->huge_count = 0;
+  g_arena_blocks += g_aot_string_arena->blocks;
+}
+
+// HUGE ALLOCATIONS: a single request above AOT_ARENA_HUGE_SIZE gets its own
+// exactly-sized mapping on a side list instead of a chain block. It no longer
+// strands the rest of the current block, and it never becomes a reusable
+// chain block that a later rewind would keep: the rewind past it unmaps it.
+static void *aot_arena_alloc_huge(size_t size) {
+  AOTArenaBlock *block = aot_arena_new_block(size);
+  if (!block)
+    return malloc(size); // Fallback
+  block->used = size;
+  block->next = g_aot_string_arena->huge;
+  g_aot_string_arena->huge = block;
+  g_aot_string_arena->huge_count++;
+  g_aot_string_arena->total_allocated += size;
+  g_arena_huge_live++;
+  g_arena_huge_allocs++;
+  return block->memory;
+}
+
+// Unmap huge blocks until only `keep` remain (the ones older than a checkpoint).
+static void aot_arena_pop_huge(int keep) {
+  AOTArena *arena = g_aot_string_arena;
+  while (arena->huge_count > keep && arena->huge) {
+    AOTArenaBlock *block = arena->huge;
+    arena->huge = block->next;
+    arena->huge_count--;
+    g_arena_huge_live--;
+    aot_arena_free_block(block);
+  }
 }
 
 // Fast arena allocation - no free needed until arena reset
@@ -520,6 +645,8 @@ static void *aot_arena_alloc(size_t size) {
 
   // Align size
   size = (size + AOT_ARENA_ALIGNMENT - 1) & ~(AOT_ARENA_ALIGNMENT - 1);
+  if (size > AOT_ARENA_HUGE_SIZE)
+    return aot_arena_alloc_huge(size);
 
   AOTArenaBlock *block = g_aot_string_arena->current;
 
@@ -544,6 +671,8 @@ static void *aot_arena_alloc(size_t size) {
       new_block->next = block->next;
       block->next = new_block;
       g_aot_string_arena->current = new_block;
+      g_aot_string_arena->blocks++;
+      g_arena_blocks++;
       block = new_block;
     }
   }
@@ -568,6 +697,7 @@ void aot_arena_reset(void) {
   }
   g_aot_string_arena->current = g_aot_string_arena->head;
   g_aot_string_arena->total_allocated = 0;
+  aot_arena_pop_huge(0);
 }
 
 // ---------------------------------------------------------------------------
@@ -584,10 +714,11 @@ void aot_arena_reset(void) {
 // the save (route registrations, default headers, module-level globals)
 // stays intact.
 //
-// Recycle policy: we don't actually free freed blocks — `used` is just
-// reset to 0. The next allocation re-uses them in O(1) without thrashing
-// malloc. For genuine memory release, `aot_arena_reset()` (which truncates
-// everything) is still the right call.
+// Recycle policy: a rewind doesn't free blocks — `used` is just reset to 0
+// and the next allocation re-uses them in O(1) without thrashing malloc.
+// Only the surplus beyond the keep limit is unmapped, and only after a run
+// of idle rewinds (see Arena trimming above); huge blocks past the
+// checkpoint are unmapped right away.
 //
 // The checkpoint stack itself is bounded at 32 to keep accidental save-
 // without-restore from leaking arbitrary memory; HTTP servers only ever
@@ -597,7 +728,7 @@ void aot_arena_reset(void) {
 typedef struct {
   AOTArenaBlock *block;  // block we were appending to at save time
   size_t used;            // its `used` value at save time
-  size_t region_mark;     // g_region size at save time (malloc-object region)
+  int huge_count;         // huge blocks alive at save time
 } AOTArenaCheckpoint;
 
 #define AOT_ARENA_CHECKPOINT_MAX 32
@@ -608,65 +739,55 @@ static thread_local AOTArenaCheckpoint g_arena_checkpoints[AOT_ARENA_CHECKPOINT_
 static thread_local int g_arena_checkpoint_top = 0;
 
 // ---------------------------------------------------------------------------
-// Per-request malloc-object region (leak fix — benchmarks/WINGS_VS_FASTAPI.md)
+// Request-scoped containers (leak fix — benchmarks/WINGS_VS_FASTAPI.md)
 //
-// In AOT (vm == nullptr) every object/array LITERAL is malloc'd with
-// arena_allocated = 0 and, with no VM object list to chain into, was never
-// freed: a steady per-request leak. We now chain those malloc'd containers
-// into a per-thread region that arena_save/arena_restore bracket, so a
-// request's transient containers are freed in lockstep with its arena
-// strings. Only literals allocated *inside* an arena scope are tracked —
-// top-level globals (allocated before any save) and the deep copies made by
-// aot_persist / string_pin are never tracked, so persistent data is untouched.
+// In AOT (vm == nullptr) an object/array LITERAL has no VM object list to
+// chain into, so a malloc'd one was never freed: a steady per-request leak.
+// Inside an arena scope (g_arena_checkpoint_top > 0) literals are therefore
+// carved from the per-thread arena itself — header AND the items/keys/values
+// buffers the push/set wrappers grow — and tagged `arena_allocated = 1`, so
+// a request's transient containers are reclaimed by the same block rewind as
+// its strings. No per-literal malloc, no side table to walk at restore.
+// (Earlier revisions malloc'd them and tracked each one in a thread_local
+// vector + unordered_set: a malloc and a hash insert per `{}`/`[]`, and a
+// hash lookup per barrier check — see benchmarks/container_literals.tpr.)
+// Literals allocated *outside* any scope — top-level globals — and the deep
+// copies made by aot_persist / string_pin stay malloc'd and permanent.
 //
-// `g_region_set` gives the runtime write barrier an O(1) "is this object
-// transient?" test: a store of a transient value into a persistent container
-// (a global, or an already-persisted object) deep-copies the value so it
-// survives the next arena_restore. That barrier — value-flow based — is what
-// makes the freeing safe even when a global is aliased through a local.
+// The header tag is what the runtime write barrier tests: a store of a
+// transient value into a persistent container (a global, or an already-
+// persisted object) deep-copies the value so it survives the next
+// arena_restore. That barrier — value-flow based — is what makes the bulk
+// reclaim safe even when a global is aliased through a local.
 VMValue aot_persist(VMValue v); // defined below; used by the write barrier
 
-static thread_local std::vector<Obj *> g_region;
-static thread_local std::unordered_set<Obj *> g_region_set;
-
-static inline void region_track(Obj *o) {
-  if (g_arena_checkpoint_top <= 0 || !o)
-    return; // outside any request scope → permanent (e.g. top-level globals)
-  g_region.push_back(o);
-  g_region_set.insert(o);
-}
-
-// A value is "transient" if it lives only until the next arena_restore: arena
-// memory, or a malloc container tracked in the current region. Persistent
-// objects (top-level globals, aot_persist/string_pin copies) are neither.
+// A value is "transient" if it lives only until the next arena_restore, i.e.
+// in arena memory. Persistent objects (top-level globals, aot_persist /
+// string_pin copies) are malloc'd. One header load, no lookup.
 static inline bool obj_is_transient(Obj *o) {
-  return o && (o->arena_allocated || g_region_set.count(o));
+  return o && o->arena_allocated;
 }
 
-// Free a tracked malloc container plus its own malloc'd backing buffers. Does
-// NOT recurse: nested containers are tracked separately, and element strings
-// are arena-owned (reclaimed by the arena rewind).
-static inline void region_free_one(Obj *o) {
-  if (!o || o->arena_allocated)
-    return;
-  if (o->type == OBJ_OBJECT) {
-    ObjObject *x = (ObjObject *)o;
-    free(x->keys);
-    free(x->values);
-  } else if (o->type == OBJ_ARRAY) {
-    free(((ObjArray *)o)->items);
-  }
-  free(o);
+// Header for a container literal: from the arena inside a request scope,
+// malloc'd (permanent) outside one.
+static inline void *region_alloc_container(size_t size, uint8_t *arena) {
+  *arena = g_arena_checkpoint_top > 0 ? 1 : 0;
+  return *arena ? aot_arena_alloc(size) : tulpar_malloc(size);
 }
 
 // Runtime write barrier: storing a transient value into a persistent container
 // deep-copies it to permanent storage. No-op on the hot path (transient
-// container ← anything), so building a response costs nothing.
+// container ← anything), so building a response costs nothing. A persistent
+// value stored into a shared container becomes shared with it (atomic ARC,
+// see tulpar_arc.cpp); aot_persist copies already are.
 static inline VMValue wb_persist_escape(Obj *container, VMValue v) {
   if (!container || obj_is_transient(container))
     return v; // container itself is transient → freed together with v
-  if (!IS_OBJ(v) || !obj_is_transient(AS_OBJ(v)))
+  if (!IS_OBJ(v) || !obj_is_transient(AS_OBJ(v))) {
+    if (container->is_shared && IS_OBJ(v))
+      arc_share(AS_OBJ(v));
     return v; // scalar, or value already persistent
+  }
   return aot_persist(v);
 }
 
@@ -678,15 +799,65 @@ VMValue aot_arena_save(void) {
   g_arena_checkpoints[idx].block = g_aot_string_arena->current;
   g_arena_checkpoints[idx].used =
       g_aot_string_arena->current ? g_aot_string_arena->current->used : 0;
-  g_arena_checkpoints[idx].region_mark = g_region.size();
+  g_arena_checkpoints[idx].huge_count = g_aot_string_arena->huge_count;
   return VM_INT(idx);
 }
 
-// Roll the arena (and the malloc-object region) back to checkpoint `idx`.
+// Unmap the chain blocks beyond the keep limit once the thread has gone
+// `trim_after` rewinds without needing them. `cp_pos` is the 1-based chain
+// position of the checkpoint's block: it and everything before it still
+// hold live data, so the cut never lands earlier than that.
+static void aot_arena_trim(int used_blocks, int cp_pos) {
+  AOTArena *arena = g_aot_string_arena;
+  int keep = g_arena_keep_blocks;
+  if (used_blocks > keep) {
+    arena->idle_rewinds = 0;
+    return;
+  }
+  if (arena->blocks <= keep || ++arena->idle_rewinds < g_arena_trim_after)
+    return;
+  if (keep < cp_pos)
+    keep = cp_pos;
+  AOTArenaBlock *last = arena->head;
+  for (int i = 1; i < keep && last; i++)
+    last = last->next;
+  if (!last || !last->next)
+    return;
+  AOTArenaBlock *b = last->next;
+  last->next = nullptr;
+  int64_t freed = 0;
+  int n = 0;
+  while (b) {
+    AOTArenaBlock *next = b->next;
+    freed += (int64_t)b->size;
+    n++;
+    aot_arena_free_block(b);
+    b = next;
+  }
+  arena->blocks -= n;
+  arena->idle_rewinds = 0;
+  g_arena_blocks -= n;
+  g_arena_trims++;
+  g_arena_trimmed_bytes += freed;
+}
+
+// Roll the arena — strings and request-scoped containers — back to `idx`.
 // Shared by arena_restore (keeps the checkpoint) and arena_drop (releases it).
 static void aot_arena_rewind_to(int idx) {
   AOTArenaCheckpoint *cp = &g_arena_checkpoints[idx];
   if (cp->block) {
+    // How deep into the chain this scope went (the current block is always
+    // the furthest one touched) and where the checkpoint sits.
+    int used_blocks = 0, cp_pos = 0, pos = 0;
+    for (AOTArenaBlock *b = g_aot_string_arena->head; b; b = b->next) {
+      pos++;
+      if (b == cp->block)
+        cp_pos = pos;
+      if (b == g_aot_string_arena->current)
+        used_blocks = pos;
+      if (cp_pos && used_blocks)
+        break;
+    }
     // Zero out every block AFTER the checkpoint's block: keep the
     // memory mapping but reset `used` so the next alloc reuses it.
     for (AOTArenaBlock *b = cp->block->next; b; b = b->next) {
@@ -696,16 +867,12 @@ static void aot_arena_rewind_to(int idx) {
     // saved. Anything allocated since then is now logically free.
     cp->block->used = cp->used;
     g_aot_string_arena->current = cp->block;
+    aot_arena_trim(used_blocks, cp_pos);
   }
-  // Free the malloc'd containers tracked since this checkpoint (a request's
-  // transient objects/arrays), in lockstep with the arena string rewind.
-  // Persisted/global objects were never tracked, so they survive untouched.
-  for (size_t i = cp->region_mark; i < g_region.size(); i++) {
-    g_region_set.erase(g_region[i]);
-    region_free_one(g_region[i]);
-  }
-  if (cp->region_mark < g_region.size())
-    g_region.resize(cp->region_mark);
+  aot_arena_pop_huge(cp->huge_count);
+  // End of request: flush ARC frees a free budget left queued on this thread
+  // (see Deferred, iterative freeing in tulpar_arc.cpp).
+  arc_drain(0);
 }
 
 VMValue aot_arena_restore(VMValue idxVal) {
@@ -744,13 +911,14 @@ void aot_arena_destroy(void) {
   if (!g_aot_string_arena)
     return;
 
+  aot_arena_pop_huge(0);
   AOTArenaBlock *block = g_aot_string_arena->head;
   while (block) {
     AOTArenaBlock *next = block->next;
-    free(block->memory);
-    free(block);
+    aot_arena_free_block(block);
     block = next;
   }
+  g_arena_blocks -= g_aot_string_arena->blocks;
   free(g_aot_string_arena);
   g_aot_string_arena = nullptr;
 }
@@ -770,14 +938,13 @@ static ObjString *aot_allocate_string(const char *chars, int length) {
   ObjString *str = (ObjString *)block;
   str->obj.type = OBJ_STRING;
   str->obj.arena_allocated = 1; // Mark as arena allocated
-  str->obj.next = nullptr;
+  str->obj.is_shared = 0;
   str->obj.ref_count = 1;
   str->obj.is_moved = 0;
   str->length = length;
   str->capacity = length + 1;
 
   // Chars immediately follow struct
-  str->chars = block + sizeof(ObjString);
   memcpy(str->chars, chars, length);
   str->chars[length] = '\0';
 
@@ -805,17 +972,16 @@ VMValue aot_string_pin(VMValue strVal) {
   ObjString *src = AS_STRING(strVal);
 
   // Single contiguous malloc: ObjString header + char payload + NUL.
-  ObjString *pinned = (ObjString *)malloc(sizeof(ObjString) + src->length + 1);
+  ObjString *pinned = (ObjString *)tulpar_malloc(sizeof(ObjString) + src->length + 1);
   if (!pinned) return strVal; // OOM — fall back to arena string
 
   pinned->obj.type = OBJ_STRING;
   pinned->obj.arena_allocated = 0; // permanent — not part of arena
-  pinned->obj.next = nullptr;
+  pinned->obj.is_shared = 1;
   pinned->obj.ref_count = 1;
   pinned->obj.is_moved = 0;
   pinned->length = src->length;
   pinned->capacity = src->length + 1;
-  pinned->chars = (char *)(pinned + 1);
   memcpy(pinned->chars, src->chars, src->length);
   pinned->chars[src->length] = '\0';
   pinned->hash = 0;
@@ -830,7 +996,7 @@ ObjString *vm_alloc_string_aot(void *vm, const char *chars, int length) {
 
 // persist(value) -> value
 //
-// Deep-copies a value into permanent (malloc'd, ARC-managed) storage that
+// Copies a value into permanent (malloc'd, ARC-managed) storage that
 // survives an `arena_restore`. This is the escape hatch for handler code that
 // keeps request-built data in a long-lived global — the in-memory "database"
 // pattern: `push(_users, persist(u))`. Without it, the per-request arena reset
@@ -838,68 +1004,107 @@ ObjString *vm_alloc_string_aot(void *vm, const char *chars, int length) {
 // (→ crash on the next read).
 //
 // Scalars (int/float/bool/void) are returned by value — no heap, nothing to
-// copy. Strings, arrays and objects are rebuilt recursively with malloc and
+// copy. Transient strings, arrays and objects are rebuilt with malloc and
 // `arena_allocated = 0` so the arena reset skips them. They live as long as
 // something references them (today effectively process lifetime; a future GC
-// would reclaim via ref_count).
-static ObjString *aot_persist_string_obj(ObjString *src) {
-  ObjString *p = (ObjString *)malloc(sizeof(ObjString) + src->length + 1);
-  if (!p) return src;
+// would reclaim via ref_count). Copies start out shared (atomic ARC, see
+// tulpar_arc.cpp): persistent storage is exactly what listen_pool workers and
+// thread_create threads reach through globals.
+//
+// Only arena-backed nodes are copied. A child that is already permanent is
+// shared with the copy — retained, so ref_count > 1 records that more than
+// one persistent owner reaches it — and the first write that reaches it
+// copies it then (aot_cow below, COPY-ON-WRITE WRITES in llvm_backend.cpp).
+// Re-storing a mostly-persistent value — a cache entry rebuilt around its
+// old item list — costs the new nodes, not the list.
+// A node a local or parameter aliases (aot_alias) is copied instead of
+// shared: a write through the alias has no container to re-link a copy
+// into, so it must keep reaching the node itself.
+static ObjString *aot_persist_chars(const char *chars, int length) {
+  ObjString *p = (ObjString *)tulpar_malloc(sizeof(ObjString) + length + 1);
+  if (!p) return nullptr;
   p->obj.type = OBJ_STRING;
   p->obj.arena_allocated = 0;
-  p->obj.next = nullptr;
+  p->obj.is_shared = 1;
   p->obj.ref_count = 1;
   p->obj.is_moved = 0;
-  p->length = src->length;
-  p->capacity = src->length + 1;
-  p->chars = (char *)(p + 1);
-  memcpy(p->chars, src->chars, src->length);
-  p->chars[src->length] = '\0';
+  p->length = length;
+  p->capacity = length + 1;
+  memcpy(p->chars, chars, length);
+  p->chars[length] = '\0';
   p->hash = 0;
   return p;
 }
 
-VMValue aot_persist(VMValue v) {
-  if (IS_STRING(v)) {
-    return VM_OBJ((Obj *)aot_persist_string_obj(AS_STRING(v)));
+static ObjString *aot_persist_string_obj(ObjString *src) {
+  ObjString *p = aot_persist_chars(src->chars, src->length);
+  return p ? p : src;
+}
+
+// Hand a permanent object to one more persistent owner.
+static inline void aot_share_permanent(Obj *o) {
+  arc_share(o);
+  arc_retain(o);
+}
+
+// Object key: strings are immutable, so a permanent one is shared.
+static ObjString *aot_persist_key(ObjString *key) {
+  if (!key) return nullptr;
+  if (obj_is_transient((Obj *)key)) return aot_persist_string_obj(key);
+  aot_share_permanent((Obj *)key);
+  return key;
+}
+
+// Element of a node being copied: permanent children are shared, unless a
+// local aliases them (aot_alias).
+static VMValue aot_persist_child(VMValue v) {
+  if (IS_OBJ(v) && !obj_is_transient(AS_OBJ(v)) &&
+      !(AS_OBJ(v)->is_moved & OBJ_ALIASED)) {
+    aot_share_permanent(AS_OBJ(v));
+    return v;
   }
+  return aot_persist(v);
+}
+
+// Fresh malloc'd copy of one array/object node; its children go through
+// aot_persist_child. Used for transient nodes and by aot_cow.
+static VMValue aot_persist_node(VMValue v) {
   if (IS_ARRAY(v)) {
     ObjArray *src = AS_ARRAY(v);
-    ObjArray *dst = (ObjArray *)malloc(sizeof(ObjArray));
+    ObjArray *dst = (ObjArray *)tulpar_malloc(sizeof(ObjArray));
     if (!dst) return v;
     dst->obj.type = OBJ_ARRAY;
     dst->obj.arena_allocated = 0;
-    dst->obj.next = nullptr;
+    dst->obj.is_shared = 1;
     dst->obj.ref_count = 1;
     dst->obj.is_moved = 0;
     int n = src->count;
     dst->count = n;
     dst->capacity = n;
-    dst->items = (n > 0) ? (VMValue *)malloc(sizeof(VMValue) * n) : nullptr;
+    dst->items = (n > 0) ? (VMValue *)tulpar_malloc(sizeof(VMValue) * n) : nullptr;
     for (int i = 0; i < n; i++) {
-      dst->items[i] = aot_persist(src->items[i]);
+      dst->items[i] = aot_persist_child(src->items[i]);
     }
     return VM_OBJ((Obj *)dst);
   }
   if (IS_OBJECT(v)) {
     ObjObject *src = AS_OBJECT(v);
-    ObjObject *dst = (ObjObject *)malloc(sizeof(ObjObject));
+    ObjObject *dst = (ObjObject *)tulpar_malloc(sizeof(ObjObject));
     if (!dst) return v;
     dst->obj.type = OBJ_OBJECT;
     dst->obj.arena_allocated = 0;
-    dst->obj.next = nullptr;
+    dst->obj.is_shared = 1;
     dst->obj.ref_count = 1;
     dst->obj.is_moved = 0;
     int n = src->count;
     dst->count = n;
     dst->capacity = n;
     if (n > 0) {
-      dst->keys = (ObjString **)malloc(sizeof(ObjString *) * n);
-      dst->values = (VMValue *)malloc(sizeof(VMValue) * n);
+      dst->keys = (ObjString **)tulpar_malloc(sizeof(ObjString *) * n);
+      dst->values = (VMValue *)tulpar_malloc(sizeof(VMValue) * n);
       for (int i = 0; i < n; i++) {
-        dst->keys[i] =
-            src->keys[i] ? aot_persist_string_obj(src->keys[i]) : nullptr;
-        dst->values[i] = aot_persist(src->values[i]);
+        dst->keys[i] = aot_persist_key(src->keys[i]);
+        dst->values[i] = aot_persist_child(src->values[i]);
       }
     } else {
       dst->keys = nullptr;
@@ -907,6 +1112,23 @@ VMValue aot_persist(VMValue v) {
     }
     return VM_OBJ((Obj *)dst);
   }
+  return v;
+}
+
+VMValue aot_persist(VMValue v) {
+  if (IS_STRING(v)) {
+    ObjString *s = AS_STRING(v);
+    if (!obj_is_transient((Obj *)s)) {
+      aot_share_permanent((Obj *)s);
+      return v;
+    }
+    return VM_OBJ((Obj *)aot_persist_string_obj(s));
+  }
+  // The top node is always a new one — `persist(x)` and `_g = x` hand out a
+  // value the caller can mutate without touching x — even when x is
+  // permanent; only its children may be shared.
+  if (IS_ARRAY(v) || IS_OBJECT(v))
+    return aot_persist_node(v);
   // Scalars and any other value type: copy by value, no heap.
   return v;
 }
@@ -916,6 +1138,71 @@ VMValue aot_persist_ptr(VMValue *v) {
   return aot_persist(*v);
 }
 
+// Ownership move into a global: the compiler emits this instead of
+// aot_persist when the stored value is a fresh temporary or the last use of
+// a local nothing else references (OWNERSHIP MOVES in llvm_backend.cpp).
+// Nobody can observe the sharing, so a value that is already permanent —
+// malloc'd outside a request scope, its children persisted by the write
+// barrier — is handed over as is: no deep copy, and the original is no
+// longer leaked next to it. It only has to become shared like any other
+// global value. Transient (arena) values still get the copy.
+VMValue aot_persist_move(VMValue v) {
+  if (!IS_OBJ(v) || obj_is_transient(AS_OBJ(v)))
+    return aot_persist(v);
+  arc_share(AS_OBJ(v));
+  return v;
+}
+
+// Copy-on-write: a permanent array/object with more than one persistent
+// owner (ref_count > 1, see aot_persist) is copied before it is mutated.
+// The copy retains the children, the original loses this owner. Anything
+// else — scalars, strings, transient or unshared nodes — comes back as is.
+// The compiler inlines the ref_count check for a variable's own value and
+// calls this on the cold path.
+VMValue aot_cow(VMValue v) {
+  if (!IS_ARRAY(v) && !IS_OBJECT(v)) return v;
+  Obj *o = AS_OBJ(v);
+  if (obj_is_transient(o) || o->ref_count <= 1) return v;
+  VMValue copy = aot_persist_node(v);
+  arc_release(o); // > 1 owners: drops the count, never frees
+  return copy;
+}
+
+// A permanent array/object that a json local, a parameter or a return value
+// is about to alias, already made unique by the compiler. Marked
+// (OBJ_ALIASED, its own bit next to arc_move's OBJ_MOVED) so a later
+// aot_persist copies it instead of sharing it: sharing would give it
+// ref_count > 1, and the alias's next write would go to a private copy
+// instead of the owner's node. The mark is never cleared; the node just
+// keeps the deep-copy behaviour.
+VMValue aot_alias(VMValue v) {
+  if ((IS_ARRAY(v) || IS_OBJECT(v)) && !obj_is_transient(AS_OBJ(v)))
+    AS_OBJ(v)->is_moved |= OBJ_ALIASED;
+  return v;
+}
+
+// `target[index]` on a write path (or about to be aliased): the element is made
+// unique in place (aot_cow) before it is returned, so the write that follows
+// cannot leak into another owner's copy. `target` itself has already been
+// through this. A missing element reads exactly like vm_get_element.
+VMValue vm_get_element(VMValue target, VMValue index); // defined below
+VMValue aot_cow_element(VMValue target, VMValue index) {
+  VMValue *slot = nullptr;
+  if (IS_ARRAY(target) && IS_INT(index)) {
+    ObjArray *arr = AS_ARRAY(target);
+    int64_t i = AS_INT(index);
+    if (i >= 0 && i < arr->count) slot = &arr->items[i];
+  } else if (IS_OBJECT(target) && IS_STRING(index)) {
+    ObjObject *obj = AS_OBJECT(target);
+    const char *key = AS_STRING(index)->chars;
+    for (int i = 0; i < obj->count && !slot; i++)
+      if (strcmp(obj->keys[i]->chars, key) == 0) slot = &obj->values[i];
+  }
+  if (!slot) return vm_get_element(target, index);
+  *slot = aot_cow(*slot);
+  return *slot;
+}
+
 // Wrapper for AOT print (takes pointer to VMValue, calls vm_print_value which
 // takes value)
 #include <cstddef>
@@ -957,12 +1244,11 @@ VMValue aot_string_concat_fast(VMValue a, VMValue b) {
   ObjString *result = (ObjString *)block;
   result->obj.type = OBJ_STRING;
   result->obj.arena_allocated = 1;
-  result->obj.next = nullptr;
+  result->obj.is_shared = 0;
   result->obj.ref_count = 1;
   result->obj.is_moved = 0;
   result->length = total_len;
   result->capacity = total_len + 1;
-  result->chars = block + sizeof(ObjString);
 
   // Direct memory copy
   memcpy(result->chars, s1->chars, len1);
@@ -981,6 +1267,113 @@ VMValue aot_string_concat_fast_ptr(VMValue *a_ptr, VMValue *b_ptr) {
   return aot_string_concat_fast(*a_ptr, *b_ptr);
 }
 
+// Grow the arena allocation ending at `end` by `extra` bytes in place. Only
+// possible when it is the newest allocation of the current block (its end is
+// the bump tip) and the block has room. The tip must also lie past the
+// innermost arena_save checkpoint: growing a pre-checkpoint allocation across
+// the mark would let arena_restore hand its tail to the next request.
+static bool aot_arena_extend_tip(char *end, size_t extra) {
+  if (!g_aot_string_arena || !g_aot_string_arena->current)
+    return false;
+  AOTArenaBlock *block = g_aot_string_arena->current;
+  if (end != block->memory + block->used || block->used + extra > block->size)
+    return false;
+  if (g_arena_checkpoint_top > 0) {
+    AOTArenaCheckpoint *cp = &g_arena_checkpoints[g_arena_checkpoint_top - 1];
+    if (cp->block == block && (size_t)(end - block->memory) <= cp->used)
+      return false;
+  }
+  block->used += extra;
+  g_aot_string_arena->total_allocated += extra;
+  return true;
+}
+
+// `s = s + x` on a string-builder local (see STRING BUILDER LOCALS in
+// llvm_backend.cpp). The backend proves `s` never escapes — no alias, no
+// capture, only non-retaining reads — so the string it holds can be grown in
+// place *if* this function made it: `*owner` records the last string built
+// here and is cleared by the backend on every plain `s = ...`. Anything else
+// in the slot (a literal, a parameter's string, a value from a call) is
+// copied into a fresh buffer first, so shared strings are never written.
+//
+// Growth is geometric (2x, at least 32 bytes), extending the buffer in place
+// when it is still the arena tip, so n appends cost O(n) bytes copied instead
+// of the O(n^2) of allocating a new concatenation each time.
+void vm_binary_op(VM *vm, VMValue *a_ptr, VMValue *b_ptr, int op_token,
+                  VMValue *result);
+
+void aot_string_append_inplace(VMValue *slot, VMValue *b_ptr, void **owner) {
+  if (!slot || !b_ptr || !owner)
+    return;
+  if (!IS_STRING(*slot) && !IS_STRING(*b_ptr)) {
+    // No string on either side (e.g. `str s;` still holding its int 0):
+    // plain `+` semantics.
+    vm_binary_op(nullptr, slot, b_ptr, TOKEN_PLUS, slot);
+    return;
+  }
+  VMValue sb = IS_STRING(*b_ptr) ? *b_ptr : aot_to_string(*b_ptr);
+  if (!IS_STRING(sb))
+    return;
+  ObjString *add = AS_STRING(sb);
+
+  ObjString *s = IS_STRING(*slot) ? AS_STRING(*slot) : nullptr;
+  bool owned = s && (void *)s == *owner && s->obj.arena_allocated;
+  if (!s) {
+    VMValue sa = aot_to_string(*slot);
+    if (!IS_STRING(sa))
+      return;
+    s = AS_STRING(sa);
+  }
+
+  int len1 = s->length;
+  int len2 = add->length;
+  int total_len = len1 + len2;
+
+  if (owned && total_len + 1 > s->capacity) {
+    // Out of room: try to grow in place at the arena tip.
+    int new_cap = s->capacity * 2;
+    if (new_cap < total_len + 1)
+      new_cap = total_len + 1;
+    size_t old_end = sizeof(ObjString) + (size_t)s->capacity;
+    old_end = (old_end + AOT_ARENA_ALIGNMENT - 1) & ~(size_t)(AOT_ARENA_ALIGNMENT - 1);
+    size_t new_end = sizeof(ObjString) + (size_t)new_cap;
+    new_end = (new_end + AOT_ARENA_ALIGNMENT - 1) & ~(size_t)(AOT_ARENA_ALIGNMENT - 1);
+    if (aot_arena_extend_tip((char *)s + old_end, new_end - old_end))
+      s->capacity = (int)(new_end - sizeof(ObjString));
+    else
+      owned = false;
+  }
+
+  if (!owned) {
+    int cap = total_len + 1;
+    cap = cap < 32 ? 32 : cap;
+    if (cap < (len1 + 1) * 2)
+      cap = (len1 + 1) * 2;
+    char *block = static_cast<char *>(aot_arena_alloc(sizeof(ObjString) + cap));
+    if (!block)
+      return;
+    ObjString *result = (ObjString *)block;
+    result->obj.type = OBJ_STRING;
+    result->obj.arena_allocated = 1;
+    result->obj.is_shared = 0;
+    result->obj.ref_count = 1;
+    result->obj.is_moved = 0;
+    result->length = len1;
+    result->capacity = cap;
+    memcpy(result->chars, s->chars, len1);
+    s = result;
+    *owner = s;
+    *slot = VM_OBJ((Obj *)s);
+  }
+
+  // `add` may be `s` itself only through an alias the backend ruled out;
+  // memmove keeps even that case well-defined.
+  memmove(s->chars + len1, add->chars, len2);
+  s->length = total_len;
+  s->chars[total_len] = '\0';
+  s->hash = 0;
+}
+
 // Create string from C string literal (fast path)
 VMValue aot_string_from_cstr(const char *cstr) {
   int len = strlen(cstr);
@@ -1024,16 +1417,250 @@ void aot_stringbuilder_append(StringBuilder *sb, const char *str, int len) {
 // precision — the LLVM backend uses a 32-bit float type — so a plain "%g" at
 // 6 sig-figs both loses precision (1000000.5 -> "1e+06") and, at higher fixed
 // precision, exposes the float32 rounding noise (3.14 -> "3.14000010490417").
-// Instead find the SHORTEST decimal that round-trips to the same float32:
+// Instead print the SHORTEST decimal that round-trips to the same float32:
 // 3.14 -> "3.14", 1000000.5 -> "1000000.5", 0.1+0.2 -> "0.3". Mirrors what
-// Python/Go/Rust print for their floats. Returns the written length.
+// Python/Go/Rust print for their floats.
+//
+// The digits come from Ryu's f2s (Ulf Adams, PLDI 2018): one 32x64-bit
+// multiply per bound against a small table of 5^±k, no bignums, no libc.
+// This used to be a `%.*g` / strtod probe loop — up to nine snprintf+strtod
+// round trips per float, the hottest call in toJson of float-heavy rows.
+// The layout below reproduces that loop's "%.<shortest>g" output byte for
+// byte, so printed and serialised floats don't change.
+
+// 5^-q and 5^i, scaled to 59 / 61 significant bits (see Ryu's f2s.c).
+static const uint64_t kF2sPow5InvSplit[31] = {
+    576460752303423489u, 461168601842738791u, 368934881474191033u,
+    295147905179352826u, 472236648286964522u, 377789318629571618u,
+    302231454903657294u, 483570327845851670u, 386856262276681336u,
+    309485009821345069u, 495176015714152110u, 396140812571321688u,
+    316912650057057351u, 507060240091291761u, 405648192073033409u,
+    324518553658426727u, 519229685853482763u, 415383748682786211u,
+    332306998946228969u, 531691198313966350u, 425352958651173080u,
+    340282366920938464u, 544451787073501542u, 435561429658801234u,
+    348449143727040987u, 557518629963265579u, 446014903970612463u,
+    356811923176489971u, 570899077082383953u, 456719261665907162u,
+    365375409332725730u,
+};
+static const uint64_t kF2sPow5Split[47] = {
+    1152921504606846976u, 1441151880758558720u, 1801439850948198400u,
+    2251799813685248000u, 1407374883553280000u, 1759218604441600000u,
+    2199023255552000000u, 1374389534720000000u, 1717986918400000000u,
+    2147483648000000000u, 1342177280000000000u, 1677721600000000000u,
+    2097152000000000000u, 1310720000000000000u, 1638400000000000000u,
+    2048000000000000000u, 1280000000000000000u, 1600000000000000000u,
+    2000000000000000000u, 1250000000000000000u, 1562500000000000000u,
+    1953125000000000000u, 1220703125000000000u, 1525878906250000000u,
+    1907348632812500000u, 1192092895507812500u, 1490116119384765625u,
+    1862645149230957031u, 1164153218269348144u, 1455191522836685180u,
+    1818989403545856475u, 2273736754432320594u, 1421085471520200371u,
+    1776356839400250464u, 2220446049250313080u, 1387778780781445675u,
+    1734723475976807094u, 2168404344971008868u, 1355252715606880542u,
+    1694065894508600678u, 2117582368135750847u, 1323488980084844279u,
+    1654361225106055349u, 2067951531382569187u, 1292469707114105741u,
+    1615587133892632177u, 2019483917365790221u,
+};
+
+static inline int32_t f2s_pow5bits(int32_t e) {
+  return (int32_t)(((uint32_t)e * 1217359u) >> 19) + 1;
+}
+static inline uint32_t f2s_log10_pow2(int32_t e) {
+  return ((uint32_t)e * 78913u) >> 18;
+}
+static inline uint32_t f2s_log10_pow5(int32_t e) {
+  return ((uint32_t)e * 732923u) >> 20;
+}
+static inline uint32_t f2s_pow5_factor(uint32_t v) {
+  uint32_t count = 0;
+  while (v % 5 == 0) {
+    v /= 5;
+    count++;
+  }
+  return count;
+}
+static inline uint32_t f2s_mul_shift(uint32_t m, uint64_t factor,
+                                     int32_t shift) {
+  uint64_t lo = (uint64_t)m * (uint32_t)factor;
+  uint64_t hi = (uint64_t)m * (uint32_t)(factor >> 32);
+  return (uint32_t)(((lo >> 32) + hi) >> (shift - 32));
+}
+
+// Shortest `digits * 10^exp10` that reads back as the float with the given
+// IEEE fields (finite, non-zero).
+static void f2s_shortest(uint32_t ieee_m, uint32_t ieee_e, uint32_t *digits,
+                         int32_t *exp10) {
+  int32_t e2;
+  uint32_t m2;
+  if (ieee_e == 0) {
+    e2 = 1 - 127 - 23 - 2;
+    m2 = ieee_m;
+  } else {
+    e2 = (int32_t)ieee_e - 127 - 23 - 2;
+    m2 = (1u << 23) | ieee_m;
+  }
+  const bool accept_bounds = (m2 & 1) == 0;
+  const uint32_t mv = 4 * m2;
+  const uint32_t mm_shift = ieee_m != 0 || ieee_e <= 1;
+
+  // Scaled value and its round-trip interval [vm, vp].
+  uint32_t vr, vp, vm;
+  int32_t e10;
+  bool vm_trailing_zeros = false, vr_trailing_zeros = false;
+  uint8_t last_removed = 0;
+  if (e2 >= 0) {
+    const uint32_t q = f2s_log10_pow2(e2);
+    e10 = (int32_t)q;
+    const int32_t k = 59 + f2s_pow5bits((int32_t)q) - 1;
+    const int32_t i = -e2 + (int32_t)q + k;
+    vr = f2s_mul_shift(mv, kF2sPow5InvSplit[q], i);
+    vp = f2s_mul_shift(mv + 2, kF2sPow5InvSplit[q], i);
+    vm = f2s_mul_shift(mv - 1 - mm_shift, kF2sPow5InvSplit[q], i);
+    if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+      const int32_t l = 59 + f2s_pow5bits((int32_t)(q - 1)) - 1;
+      last_removed = (uint8_t)(
+          f2s_mul_shift(mv, kF2sPow5InvSplit[q - 1], -e2 + (int32_t)q - 1 + l) %
+          10);
+    }
+    if (q <= 9) {
+      if (mv % 5 == 0)
+        vr_trailing_zeros = f2s_pow5_factor(mv) >= q;
+      else if (accept_bounds)
+        vm_trailing_zeros = f2s_pow5_factor(mv - 1 - mm_shift) >= q;
+      else
+        vp -= f2s_pow5_factor(mv + 2) >= q;
+    }
+  } else {
+    const uint32_t q = f2s_log10_pow5(-e2);
+    e10 = (int32_t)q + e2;
+    const int32_t i = -e2 - (int32_t)q;
+    const int32_t k = f2s_pow5bits(i) - 61;
+    int32_t j = (int32_t)q - k;
+    vr = f2s_mul_shift(mv, kF2sPow5Split[i], j);
+    vp = f2s_mul_shift(mv + 2, kF2sPow5Split[i], j);
+    vm = f2s_mul_shift(mv - 1 - mm_shift, kF2sPow5Split[i], j);
+    if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+      j = (int32_t)q - 1 - (f2s_pow5bits(i + 1) - 61);
+      last_removed = (uint8_t)(f2s_mul_shift(mv, kF2sPow5Split[i + 1], j) % 10);
+    }
+    if (q <= 1) {
+      vr_trailing_zeros = true;
+      if (accept_bounds)
+        vm_trailing_zeros = mm_shift == 1;
+      else
+        --vp;
+    } else if (q < 31) {
+      vr_trailing_zeros = (mv & ((1u << (q - 1)) - 1)) == 0;
+    }
+  }
+
+  // Drop digits while the interval still holds a shorter candidate.
+  int32_t removed = 0;
+  uint32_t output;
+  if (vm_trailing_zeros || vr_trailing_zeros) {
+    while (vp / 10 > vm / 10) {
+      vm_trailing_zeros &= vm % 10 == 0;
+      vr_trailing_zeros &= last_removed == 0;
+      last_removed = (uint8_t)(vr % 10);
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      ++removed;
+    }
+    if (vm_trailing_zeros) {
+      while (vm % 10 == 0) {
+        vr_trailing_zeros &= last_removed == 0;
+        last_removed = (uint8_t)(vr % 10);
+        vr /= 10;
+        vp /= 10;
+        vm /= 10;
+        ++removed;
+      }
+    }
+    if (vr_trailing_zeros && last_removed == 5 && vr % 2 == 0)
+      last_removed = 4; // round half to even
+    output = vr + ((vr == vm && (!accept_bounds || !vm_trailing_zeros)) ||
+                   last_removed >= 5);
+  } else {
+    while (vp / 10 > vm / 10) {
+      last_removed = (uint8_t)(vr % 10);
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      ++removed;
+    }
+    output = vr + (vr == vm || last_removed >= 5);
+  }
+  *digits = output;
+  *exp10 = e10 + removed;
+}
+
 static int aot_format_float(char *buf, size_t n, double value) {
   float f = (float)value;
-  for (int prec = 1; prec <= 9; prec++) {  // 9 sig-figs round-trips any float32
-    int len = snprintf(buf, n, "%.*g", prec, (double)f);
-    if ((float)strtod(buf, nullptr) == f) return len;
+  uint32_t bits;
+  memcpy(&bits, &f, sizeof(bits));
+  const uint32_t ieee_m = bits & 0x7FFFFFu;
+  const uint32_t ieee_e = (bits >> 23) & 0xFFu;
+  if (ieee_e == 0xFF || n < 24) // inf / nan keep libc's spelling
+    return snprintf(buf, n, "%g", (double)f);
+
+  int len = 0;
+  if (bits >> 31)
+    buf[len++] = '-';
+  if (ieee_e == 0 && ieee_m == 0) {
+    buf[len++] = '0';
+    buf[len] = '\0';
+    return len;
+  }
+
+  uint32_t output;
+  int32_t exp10;
+  f2s_shortest(ieee_m, ieee_e, &output, &exp10);
+  char d[10];
+  int olen = 0;
+  for (uint32_t v = output; v; v /= 10)
+    d[olen++] = (char)('0' + v % 10);
+  for (int i = 0; i < olen / 2; i++) { // reverse into most-significant first
+    char t = d[i];
+    d[i] = d[olen - 1 - i];
+    d[olen - 1 - i] = t;
+  }
+
+  // "%.<olen>g": scientific when the leading digit's exponent is < -4 or
+  // >= the precision, fixed otherwise; trailing zeros never occur (the
+  // digits are already the shortest).
+  const int x = exp10 + olen - 1;
+  if (x < -4 || x >= olen) {
+    buf[len++] = d[0];
+    if (olen > 1) {
+      buf[len++] = '.';
+      memcpy(buf + len, d + 1, olen - 1);
+      len += olen - 1;
+    }
+    int ax = x < 0 ? -x : x;
+    buf[len++] = 'e';
+    buf[len++] = x < 0 ? '-' : '+';
+    if (ax >= 100)
+      buf[len++] = (char)('0' + ax / 100);
+    buf[len++] = (char)('0' + ax / 10 % 10);
+    buf[len++] = (char)('0' + ax % 10);
+  } else if (x >= 0) {
+    memcpy(buf + len, d, x + 1);
+    len += x + 1;
+    if (olen > x + 1) {
+      buf[len++] = '.';
+      memcpy(buf + len, d + x + 1, olen - x - 1);
+      len += olen - x - 1;
+    }
+  } else {
+    buf[len++] = '0';
+    buf[len++] = '.';
+    for (int z = 0; z < -x - 1; z++)
+      buf[len++] = '0';
+    memcpy(buf + len, d, olen);
+    len += olen;
   }
-  return snprintf(buf, n, "%.9g", (double)f);
+  buf[len] = '\0';
+  return len;
 }
 
 // Append VMValue to StringBuilder (handles any type)
@@ -1534,9 +2161,9 @@ void vm_object_set(VM *vm, ObjObject *obj, char *key, VMValue value) {
       obj->values = new_values;
     } else {
       obj->keys =
-          (ObjString **)realloc(obj->keys, sizeof(ObjString *) * obj->capacity);
+          (ObjString **)tulpar_realloc(obj->keys, sizeof(ObjString *) * obj->capacity);
       obj->values =
-          static_cast<VMValue*>(realloc(obj->values, sizeof(VMValue) * obj->capacity));
+          static_cast<VMValue*>(tulpar_realloc(obj->values, sizeof(VMValue) * obj->capacity));
     }
   }
 
@@ -1630,7 +2257,7 @@ void vm_set_element(VM *vm, VMValue target, VMValue index, VMValue value) {
 
 // Print a VMValue (used by OP_PRINT in VM)
 void print_vm_value(VMValue value) {
-  switch (value.type) {
+  switch (VM_TYPE(value)) {
   case VM_VAL_VOID:
     // The `null` literal and a value-less (void) result share this tag;
     // "null" reads better than "void" now that `null` is user-facing.
@@ -1707,7 +2334,7 @@ void print_newline(void) {
 static thread_local char aot_string_buffer[1024];
 
 VMValue aot_to_string(VMValue value) {
-  switch (value.type) {
+  switch (VM_TYPE(value)) {
   case VM_VAL_INT:
     snprintf(aot_string_buffer, sizeof(aot_string_buffer), "%lld",
              AS_INT(value));
@@ -1745,7 +2372,7 @@ VMValue aot_to_string_ptr(VMValue *value_ptr) {
 
 // toInt(VMValue) -> int64
 int64_t aot_to_int(VMValue value) {
-  switch (value.type) {
+  switch (VM_TYPE(value)) {
   case VM_VAL_INT:
     return AS_INT(value);
   case VM_VAL_FLOAT:
@@ -1770,7 +2397,7 @@ int64_t aot_to_int_ptr(VMValue *value_ptr) {
 
 // toFloat(VMValue) -> double
 double aot_to_float(VMValue value) {
-  switch (value.type) {
+  switch (VM_TYPE(value)) {
   case VM_VAL_INT:
     return (double)AS_INT(value);
   case VM_VAL_FLOAT:
@@ -1841,7 +2468,7 @@ void aot_array_push(VMValue *arr_ptr, VMValue *item_ptr) {
         arr->items = new_items;
       } else {
         arr->items =
-            static_cast<VMValue *>(realloc(arr->items, sizeof(VMValue) * new_cap));
+            static_cast<VMValue *>(tulpar_realloc(arr->items, sizeof(VMValue) * new_cap));
       }
       arr->capacity = new_cap;
     }
@@ -1892,8 +2519,8 @@ extern "C" VMValue aot_struct_alloc(const char *type_name, int field_count) {
   ObjStruct *s = static_cast<ObjStruct *>(aot_arena_alloc(sizeof(ObjStruct) + extra));
   if (!s) return VM_INT(0);
   s->obj.type = OBJ_STRUCT;
-  s->obj.next = nullptr;
   s->obj.arena_allocated = 1;
+  s->obj.is_shared = 0;
   s->obj.ref_count = 1;
   s->obj.is_moved = 0;
   s->type_name = type_name;
@@ -2358,37 +2985,112 @@ VMValue aot_to_json_ptr(VMValue *value_ptr) {
   return aot_to_json(*value_ptr);
 }
 
+// ---- Compiled struct serialisers ----------------------------------------------
+// `toJson(v)` on a native struct (or an inline struct array) doesn't box the
+// value and walk it: the backend emits one `tulpar.tojson.<Struct>` function
+// per struct type whose key fragments (`{"x":`, `,"y":`) are escaped at
+// compile time, and it drives this writer directly — a memcpy per key and an
+// integer format per field. begin/end bracket exactly one toJson call; the
+// emitted code makes no other runtime calls in between, so one builder per
+// thread is enough.
+static thread_local JSBuilder g_json_out;
+
+void *aot_json_buf_begin(void) {
+  js_init(&g_json_out);
+  return &g_json_out;
+}
+
+void aot_json_buf_raw(void *b, const char *s, long long len) {
+  js_append_n(static_cast<JSBuilder *>(b), s, (size_t)len);
+}
+
+void aot_json_buf_int(void *b, long long v) {
+  char tmp[24];
+  int len = js_int_to_str(tmp, v);
+  js_append_n(static_cast<JSBuilder *>(b), tmp, len);
+}
+
+void aot_json_buf_bool(void *b, long long v) {
+  if (v)
+    js_append_n(static_cast<JSBuilder *>(b), "true", 4);
+  else
+    js_append_n(static_cast<JSBuilder *>(b), "false", 5);
+}
+
+VMValue aot_json_buf_end(void *b) {
+  JSBuilder *jb = static_cast<JSBuilder *>(b);
+  if (!jb->data)
+    return VM_INT(0);
+  ObjString *res = aot_allocate_string(jb->data, jb->len);
+  js_free(jb);
+  return VM_OBJ((Obj *)res);
+}
+
 // AOT Wrappers for Allocations
 ObjArray *vm_allocate_array_aot_wrapper(void *vm) {
   if (vm)
     return vm_allocate_array(static_cast<VM *>(vm));
-  ObjArray *arr = static_cast<ObjArray*>(malloc(sizeof(ObjArray)));
+  uint8_t in_arena;
+  ObjArray *arr = static_cast<ObjArray*>(
+      region_alloc_container(sizeof(ObjArray), &in_arena));
   arr->obj.type = OBJ_ARRAY;
-  arr->obj.arena_allocated = 0;
-  arr->obj.next = nullptr;
+  arr->obj.arena_allocated = in_arena; // request-local → reclaimed at arena_restore
+  arr->obj.is_shared = 0;
   arr->obj.ref_count = 1;
   arr->obj.is_moved = 0;
   arr->count = 0;
   arr->capacity = 0;
   arr->items = nullptr;
-  region_track((Obj *)arr); // request-local literal → freed at arena_restore
   return arr;
 }
 
 ObjObject *vm_allocate_object_aot_wrapper(void *vm) {
   if (vm)
     return vm_allocate_object(static_cast<VM *>(vm));
-  ObjObject *obj = static_cast<ObjObject*>(malloc(sizeof(ObjObject)));
+  uint8_t in_arena;
+  ObjObject *obj = static_cast<ObjObject*>(
+      region_alloc_container(sizeof(ObjObject), &in_arena));
   obj->obj.type = OBJ_OBJECT;
-  obj->obj.arena_allocated = 0;
-  obj->obj.next = nullptr;
+  obj->obj.arena_allocated = in_arena; // request-local → reclaimed at arena_restore
+  obj->obj.is_shared = 0;
   obj->obj.ref_count = 1;
   obj->obj.is_moved = 0;
   obj->count = 0;
   obj->capacity = 0;
   obj->keys = nullptr;
   obj->values = nullptr;
-  region_track((Obj *)obj); // request-local literal → freed at arena_restore
+  return obj;
+}
+
+// Container literals the AOT escape scan proved never leave their function
+// (STACK CONTAINER LOCALS in llvm_backend.cpp): the header and its first
+// `cap` slots are allocas in the caller's frame, re-initialised every time
+// the declaration runs. Tagged `arena_allocated = 1` so ARC never frees
+// them, the write barrier treats them as transient like any request-scoped
+// literal, and growth past `cap` goes through the same arena path.
+ObjArray *aot_stack_array_init(ObjArray *arr, VMValue *items, int cap) {
+  arr->obj.type = OBJ_ARRAY;
+  arr->obj.arena_allocated = 1;
+  arr->obj.is_shared = 0;
+  arr->obj.ref_count = 1;
+  arr->obj.is_moved = 0;
+  arr->count = 0;
+  arr->capacity = cap;
+  arr->items = items;
+  return arr;
+}
+
+ObjObject *aot_stack_object_init(ObjObject *obj, ObjString **keys,
+                                 VMValue *values, int cap) {
+  obj->obj.type = OBJ_OBJECT;
+  obj->obj.arena_allocated = 1;
+  obj->obj.is_shared = 0;
+  obj->obj.ref_count = 1;
+  obj->obj.is_moved = 0;
+  obj->count = 0;
+  obj->capacity = cap;
+  obj->keys = keys;
+  obj->values = values;
   return obj;
 }
 
@@ -2410,7 +3112,7 @@ void vm_array_push_aot_wrapper(void *vm, ObjArray *array, VMValue value) {
       }
       array->items = new_items;
     } else {
-      array->items = static_cast<VMValue*>(realloc(array->items, sizeof(VMValue) * new_cap));
+      array->items = static_cast<VMValue*>(tulpar_realloc(array->items, sizeof(VMValue) * new_cap));
     }
     array->capacity = new_cap;
   }
@@ -2444,8 +3146,8 @@ void vm_object_set_aot_wrapper(void *vm, ObjObject *obj, char *key,
       obj->keys = new_keys;
       obj->values = new_values;
     } else {
-      obj->keys = (ObjString **)realloc(obj->keys, sizeof(ObjString *) * new_cap);
-      obj->values = static_cast<VMValue*>(realloc(obj->values, sizeof(VMValue) * new_cap));
+      obj->keys = (ObjString **)tulpar_realloc(obj->keys, sizeof(ObjString *) * new_cap);
+      obj->values = static_cast<VMValue*>(tulpar_realloc(obj->values, sizeof(VMValue) * new_cap));
     }
     obj->capacity = new_cap;
   }
@@ -2551,7 +3253,7 @@ VMValue aot_regex_capture(VMValue patVal, VMValue strVal) {
         ObjArray *a = (ObjArray *)aot_arena_alloc(sizeof(ObjArray));
         a->obj.type = OBJ_ARRAY;
         a->obj.arena_allocated = 1;
-        a->obj.next = nullptr;
+        a->obj.is_shared = 0;
         a->obj.ref_count = 1;
         a->obj.is_moved = 0;
         a->capacity = 0;
@@ -2575,7 +3277,7 @@ VMValue aot_regex_capture(VMValue patVal, VMValue strVal) {
     ObjArray *a = (ObjArray *)aot_arena_alloc(sizeof(ObjArray));
     a->obj.type = OBJ_ARRAY;
     a->obj.arena_allocated = 1;
-    a->obj.next = nullptr;
+    a->obj.is_shared = 0;
     a->obj.ref_count = 1;
     a->obj.is_moved = 0;
     a->capacity = n;
@@ -2717,7 +3419,7 @@ VMValue aot_file_glob(VMValue patVal) {
         ObjArray *a = (ObjArray *)aot_arena_alloc(sizeof(ObjArray));
         a->obj.type = OBJ_ARRAY;
         a->obj.arena_allocated = 1;
-        a->obj.next = nullptr;
+        a->obj.is_shared = 0;
         a->obj.ref_count = 1;
         a->obj.is_moved = 0;
         a->capacity = 0;
@@ -2767,7 +3469,7 @@ VMValue aot_file_glob(VMValue patVal) {
     ObjArray *a = (ObjArray *)aot_arena_alloc(sizeof(ObjArray));
     a->obj.type = OBJ_ARRAY;
     a->obj.arena_allocated = 1;
-    a->obj.next = nullptr;
+    a->obj.is_shared = 0;
     a->obj.ref_count = 1;
     a->obj.is_moved = 0;
     int n = (int)matches.size();
@@ -2795,7 +3497,7 @@ VMValue aot_csv_parse(VMValue strVal) {
         ObjArray *a = (ObjArray *)aot_arena_alloc(sizeof(ObjArray));
         a->obj.type = OBJ_ARRAY;
         a->obj.arena_allocated = 1;
-        a->obj.next = nullptr;
+        a->obj.is_shared = 0;
         a->obj.ref_count = 1;
         a->obj.is_moved = 0;
         a->capacity = 0;
@@ -2856,7 +3558,7 @@ VMValue aot_csv_parse(VMValue strVal) {
     ObjArray *outer = (ObjArray *)aot_arena_alloc(sizeof(ObjArray));
     outer->obj.type = OBJ_ARRAY;
     outer->obj.arena_allocated = 1;
-    outer->obj.next = nullptr;
+    outer->obj.is_shared = 0;
     outer->obj.ref_count = 1;
     outer->obj.is_moved = 0;
     outer->capacity = rn;
@@ -2867,7 +3569,7 @@ VMValue aot_csv_parse(VMValue strVal) {
         ObjArray *inner = (ObjArray *)aot_arena_alloc(sizeof(ObjArray));
         inner->obj.type = OBJ_ARRAY;
         inner->obj.arena_allocated = 1;
-        inner->obj.next = nullptr;
+        inner->obj.is_shared = 0;
         inner->obj.ref_count = 1;
         inner->obj.is_moved = 0;
         inner->capacity = cn;
@@ -2932,7 +3634,7 @@ VMValue aot_keys(VMValue objVal) {
         ObjArray *a = (ObjArray *)aot_arena_alloc(sizeof(ObjArray));
         a->obj.type = OBJ_ARRAY;
         a->obj.arena_allocated = 1;
-        a->obj.next = nullptr;
+        a->obj.is_shared = 0;
         a->obj.ref_count = 1;
         a->obj.is_moved = 0;
         a->capacity = 0;
@@ -2946,7 +3648,7 @@ VMValue aot_keys(VMValue objVal) {
     ObjArray *a = (ObjArray *)aot_arena_alloc(sizeof(ObjArray));
     a->obj.type = OBJ_ARRAY;
     a->obj.arena_allocated = 1;
-    a->obj.next = nullptr;
+    a->obj.is_shared = 0;
     a->obj.ref_count = 1;
     a->obj.is_moved = 0;
     a->capacity = n;
@@ -2982,7 +3684,7 @@ VMValue aot_object_clone(VMValue val) {
   ObjObject *dst = (ObjObject *)aot_arena_alloc(sizeof(ObjObject));
   dst->obj.type = OBJ_OBJECT;
   dst->obj.arena_allocated = 1;
-  dst->obj.next = nullptr;
+  dst->obj.is_shared = 0;
   dst->obj.ref_count = 1;
   dst->obj.is_moved = 0;
   int n = src->count;
@@ -3244,6 +3946,52 @@ VMValue aot_array_slice_ptr(VMValue *arr_ptr, long long start) {
   }
   return VM_OBJ((Obj *)out);
 }
+
+// Box an unboxed AOT array local (`arrayInt` / `arrayFloat` / `arrayBool`,
+// see typed_array_* in llvm_backend.cpp) into a regular ObjArray at a dynamic
+// boundary — toJson, print, return, for-in. The copy is a snapshot: the
+// backend only keeps an array unboxed when no alias of it can be observed
+// afterwards. kind: 0 = int64, 1 = double, 2 = int8 bool.
+VMValue aot_typed_array_box(const void *data, long long count, long long kind) {
+  ObjArray *out = vm_allocate_array_aot_wrapper(nullptr);
+  if (data && count > 0) {
+    out->items = static_cast<VMValue *>(tulpar_malloc(sizeof(VMValue) * (size_t)count));
+    out->capacity = (int)count;
+    out->count = (int)count;
+    for (long long i = 0; i < count; i++) {
+      switch (kind) {
+      case 1:
+        out->items[i] = VM_FLOAT(static_cast<const double *>(data)[i]);
+        break;
+      case 2:
+        out->items[i] = VM_BOOL(static_cast<const int8_t *>(data)[i] != 0);
+        break;
+      default:
+        out->items[i] = VM_INT(static_cast<const int64_t *>(data)[i]);
+        break;
+      }
+    }
+  }
+  return VM_OBJ((Obj *)out);
+}
+
+// Out-of-range index on an unboxed array local: same diagnostic as
+// vm_array_get / vm_array_set; the inline codegen then reads 0 / skips the
+// store, exactly like the boxed path.
+void aot_typed_array_oob(void) {
+  printf("%s\n",
+         tulpar::i18n::tr_en("Calisma Zamani Hatasi: Dizi indeksi sinir disinda",
+                             "Runtime Error: Array index out of bounds"));
+}
+
+// `--checks=full`: an int + - * overflowed i64. Reported like the other
+// runtime errors; the program continues with the wrapped result.
+void aot_int_overflow(void) {
+  printf("%s\n",
+         tulpar::i18n::tr_en("Calisma Zamani Hatasi: Tam sayi tasmasi",
+                             "Runtime Error: Integer overflow"));
+}
+
 // ============================================================================
 // File I/O Builtins
 // ============================================================================
@@ -3969,6 +4717,20 @@ VMValue aot_file_exists_ptr(VMValue *path_ptr) {
   return aot_file_exists(*path_ptr);
 }
 
+// file_delete(path) -> bool: remove a file; false if it could not be removed
+// (missing, a directory, no permission).
+VMValue aot_file_delete(VMValue path_val) {
+  if (!IS_STRING(path_val))
+    return VM_BOOL(false);
+  return VM_BOOL(remove(AS_STRING(path_val)->chars) == 0);
+}
+
+VMValue aot_file_delete_ptr(VMValue *path_ptr) {
+  if (!path_ptr)
+    return VM_BOOL(false);
+  return aot_file_delete(*path_ptr);
+}
+
 // sha256(s: str) -> str — lowercase 64-char hex digest of the input
 // bytes. Wraps the same `tulpar::sha256_hex` helper the package
 // manager and update-cmd already use; the user-facing builtin lets
@@ -4237,9 +4999,17 @@ VMValue aot_secure_token_ptr(VMValue *n_ptr) {
 }
 
 // ============================================================================
-// Exception Handling Runtime (setjmp/longjmp based)
+// Exception Handling Runtime
 // ============================================================================
+// Two lowerings, chosen per target (see runtime/tulpar_eh.h): zero-cost
+// unwinding (throw = C++ exception, try = landing pad) on Itanium targets,
+// setjmp/longjmp with an explicit handler stack on Windows x64 and wasm32.
 #include <setjmp.h>
+#include <exception>
+#include "../../runtime/tulpar_eh.h"
+#if TULPAR_EH_UNWIND
+#include <cxxabi.h> // __cxa_begin_catch / __cxa_end_catch
+#endif
 
 #define EH_STACK_MAX 64
 
@@ -4259,6 +5029,10 @@ VMValue aot_secure_token_ptr(VMValue *n_ptr) {
 // frame — undefined behaviour / crash. Per-thread storage gives each worker its
 // own try-frame stack. The async event loop runs coroutines on one thread, so
 // aot_eh_context_swap still operates on that thread's eh_cur as before.
+//
+// Under TULPAR_EH_UNWIND the handler "stack" is the machine stack itself —
+// each coroutine already has its own (fiber), and the unwinder stops at the
+// coroutine's task_body catch — so only `exception` is used here.
 typedef struct EhContext {
   jmp_buf stack[EH_STACK_MAX];
   int depth;
@@ -4268,7 +5042,56 @@ typedef struct EhContext {
 static thread_local EhContext eh_main = {};
 static thread_local EhContext *eh_cur = &eh_main; // active handler context
 
-// Returns pointer to jmp_buf for direct setjmp call
+// Report an exception nobody caught and exit(1) — the same message for both
+// lowerings.
+[[noreturn]] static void eh_report_uncaught(VMValue exception) {
+  fprintf(stderr, "Uncaught Exception: ");
+  if (IS_STRING(exception)) {
+    fprintf(stderr, "%s\n", AS_STRING(exception)->chars);
+  } else if (IS_OBJECT(exception)) {
+    fprintf(stderr, "<object type=%d>\n", AS_OBJ(exception)->type);
+  } else {
+    fprintf(stderr, "<value type=%d>\n", (int)VM_TYPE(exception));
+  }
+  exit(1);
+}
+
+#if TULPAR_EH_UNWIND
+TulparThrow::~TulparThrow() {}
+
+// No try frame is registered anywhere under unwinding, so "uncaught" is only
+// known when the unwinder's search phase finds no landing pad: __cxa_throw
+// then calls std::terminate with the exception still current. Report it as
+// before; anything that isn't ours goes to the previous handler.
+static std::terminate_handler g_eh_prev_terminate = nullptr;
+[[noreturn]] static void eh_terminate(void) {
+  try {
+    std::exception_ptr p = std::current_exception();
+    if (p)
+      std::rethrow_exception(p);
+  } catch (const TulparThrow &t) {
+    eh_report_uncaught(t.value);
+  } catch (...) {
+  }
+  if (g_eh_prev_terminate)
+    g_eh_prev_terminate();
+  abort();
+}
+[[maybe_unused]] static const bool g_eh_terminate_installed = [] {
+  g_eh_prev_terminate = std::set_terminate(eh_terminate);
+  return true;
+}();
+
+VMValue aot_eh_catch(void *exn) {
+  void *obj = abi::__cxa_begin_catch(exn);
+  VMValue v = static_cast<TulparThrow *>(obj)->value;
+  abi::__cxa_end_catch();
+  eh_cur->exception = v; // aot_get_exception stays meaningful
+  return v;
+}
+#endif
+
+// setjmp lowering only: returns pointer to jmp_buf for direct setjmp call
 jmp_buf *aot_try_push(void) {
   if (eh_cur->depth >= EH_STACK_MAX) {
     fprintf(stderr, "Exception handler stack overflow\n");
@@ -4283,21 +5106,17 @@ void aot_try_pop(void) {
 }
 
 void aot_throw(VMValue exception) {
-  if (eh_cur->depth == 0) {
-    fprintf(stderr, "Uncaught Exception: ");
-    if (IS_STRING(exception)) {
-      fprintf(stderr, "%s\n", AS_STRING(exception)->chars);
-    } else if (IS_OBJECT(exception)) {
-      fprintf(stderr, "<object type=%d>\n", AS_OBJ(exception)->type);
-    } else {
-      fprintf(stderr, "<value type=%d>\n", exception.type);
-    }
-    exit(1);
-  }
+#if TULPAR_EH_UNWIND
+  eh_cur->exception = exception;
+  throw TulparThrow(exception);
+#else
+  if (eh_cur->depth == 0)
+    eh_report_uncaught(exception);
   eh_cur->exception = exception;
   int target_depth = eh_cur->depth - 1;
   eh_cur->depth = target_depth;
   longjmp(eh_cur->stack[target_depth], 1);
+#endif
 }
 
 // ---- Per-coroutine EH context management (used by runtime/tulpar_async.cpp) -
@@ -4943,7 +5762,7 @@ VMValue aot_socket_poll(VMValue fdsVal, VMValue timeoutVal) {
     ObjArray *a = (ObjArray *)aot_arena_alloc(sizeof(ObjArray));
     a->obj.type = OBJ_ARRAY;
     a->obj.arena_allocated = 1;
-    a->obj.next = nullptr;
+    a->obj.is_shared = 0;
     a->obj.ref_count = 1;
     a->obj.is_moved = 0;
     a->capacity = n;
@@ -5281,6 +6100,9 @@ VMValue aot_thread_create(void *func_ptr, VMValue arg) {
 
   targs->func_ptr = func_ptr;
   targs->arg = arg;
+  // Both threads can reach `arg` from here on: switch its counts to atomic.
+  if (IS_OBJ(arg))
+    arc_share(AS_OBJ(arg));
 
 #if PLATFORM_WINDOWS
   int result = tulpar_thread_create(&thread, (tulpar_thread_func_t)aot_thread_entry, targs);
@@ -5373,7 +6195,7 @@ static ObjObject *aot_http_make_obj(int initial_capacity) {
   ObjObject *o = (ObjObject *)aot_arena_alloc(sizeof(ObjObject));
   o->obj.type = OBJ_OBJECT;
   o->obj.arena_allocated = 1;
-  o->obj.next = nullptr;
+  o->obj.is_shared = 0;
   o->capacity = initial_capacity > 0 ? initial_capacity : 4;
   o->count = 0;
   o->keys = (ObjString **)aot_arena_alloc(sizeof(ObjString *) * o->capacity);
@@ -6920,10 +7742,9 @@ VMValue aot_http_create_response_keepalive(VMValue statusVal,
   ObjString *str = (ObjString *)block;
   str->obj.type = OBJ_STRING;
   str->obj.arena_allocated = 1;
-  str->obj.next = nullptr;
+  str->obj.is_shared = 0;
   str->obj.ref_count = 1;
   str->obj.is_moved = 0;
-  str->chars = block + sizeof(ObjString);
   str->hash = 0;
   char *w = str->chars;
 
@@ -7078,6 +7899,144 @@ static VMValue aot_wings_strip_meta(VMValue v) {
   return VM_OBJ((Obj *)dst);
 }
 
+// wings_encode_model(schema, result) -> JSON string
+//
+// Serialiser for routes declared with `response_model(schema)`. It replaces
+// the Tulpar-side filter (`_wings_apply_response_model` built a fresh object
+// per row, looked each field up through keys(), then toJson re-walked and
+// re-escaped every key). The schema is compiled once into a plan — the
+// declared fields in order, each with its `,"name":` fragment already
+// escaped — and cached per thread, keyed by the schema object. Serialising a
+// row then costs one key match and one value format per declared field. The
+// match first tries the slot the key sat in for the previous row, because
+// rows from one query share a key order.
+//
+// Output is byte-identical to the old filter + toJson: declared fields in
+// schema order (a trailing `?` is stripped), missing ones skipped, the
+// envelope meta keys never emitted. Arrays apply the plan to every object
+// element and serialise other elements as they are. Any other value gives
+// `{}`.
+struct JsonModelField {
+  std::string name;
+  std::string frag; // `,"name":` — the first field writes it from frag[1]
+  int hint;         // index the key sat in for the previous row
+};
+
+struct JsonModelPlan {
+  std::vector<ObjString *> schema_keys; // identity check: freed schema
+                                        // addresses can be reused
+  std::vector<JsonModelField> fields;
+};
+
+static thread_local std::unordered_map<const ObjObject *, JsonModelPlan>
+    g_json_models;
+
+static JsonModelPlan *json_model_plan(ObjObject *schema) {
+  // Schemas built per call (not one per route) would grow the cache forever.
+  if (g_json_models.size() >= 1024 && !g_json_models.count(schema))
+    g_json_models.clear();
+  JsonModelPlan &plan = g_json_models[schema];
+  bool fresh = plan.schema_keys.size() == (size_t)schema->count;
+  for (int i = 0; fresh && i < schema->count; i++)
+    fresh = plan.schema_keys[i] == schema->keys[i];
+  if (fresh)
+    return &plan;
+
+  plan.schema_keys.assign(schema->keys, schema->keys + schema->count);
+  plan.fields.clear();
+  for (int i = 0; i < schema->count; i++) {
+    ObjString *k = schema->keys[i];
+    if (!k)
+      continue;
+    std::string name(k->chars, k->length);
+    if (!name.empty() && name.back() == '?')
+      name.pop_back();
+    if (name.empty() || wings_is_meta_key(name.c_str()))
+      continue;
+    bool dup = false;
+    for (const JsonModelField &f : plan.fields)
+      dup = dup || f.name == name;
+    if (dup)
+      continue;
+    JSBuilder esc;
+    js_init(&esc);
+    js_append_char(&esc, ',');
+    js_escape_string(&esc, name.data(), (int)name.size());
+    js_append_char(&esc, ':');
+    if (esc.data)
+      plan.fields.push_back(
+          JsonModelField{name, std::string(esc.data, esc.len), 0});
+    js_free(&esc);
+  }
+  return &plan;
+}
+
+static int json_model_find(ObjObject *obj, JsonModelField &f) {
+  int h = f.hint;
+  if (h < obj->count && obj->keys[h] &&
+      (size_t)obj->keys[h]->length == f.name.size() &&
+      memcmp(obj->keys[h]->chars, f.name.data(), f.name.size()) == 0)
+    return h;
+  for (int i = 0; i < obj->count; i++) {
+    ObjString *k = obj->keys[i];
+    if (k && (size_t)k->length == f.name.size() &&
+        memcmp(k->chars, f.name.data(), f.name.size()) == 0) {
+      f.hint = i;
+      return i;
+    }
+  }
+  return -1;
+}
+
+static void json_model_object(JSBuilder *b, JsonModelPlan *plan,
+                              ObjObject *obj, int depth) {
+  js_append_char(b, '{');
+  bool first = true;
+  for (JsonModelField &f : plan->fields) {
+    int i = json_model_find(obj, f);
+    if (i < 0)
+      continue;
+    if (first)
+      js_append_n(b, f.frag.data() + 1, f.frag.size() - 1);
+    else
+      js_append_n(b, f.frag.data(), f.frag.size());
+    first = false;
+    js_serialize(b, obj->values[i], depth + 1);
+  }
+  js_append_char(b, '}');
+}
+
+VMValue aot_wings_encode_model(VMValue schemaVal, VMValue resultVal) {
+  if (!IS_OBJECT(schemaVal))
+    return aot_to_json(aot_wings_strip_meta(resultVal));
+  JsonModelPlan *plan = json_model_plan((ObjObject *)AS_OBJECT(schemaVal));
+
+  JSBuilder b;
+  js_init(&b);
+  if (!b.data)
+    return VM_INT(0);
+  if (IS_OBJECT(resultVal)) {
+    json_model_object(&b, plan, (ObjObject *)AS_OBJECT(resultVal), 0);
+  } else if (IS_ARRAY(resultVal)) {
+    ObjArray *arr = AS_ARRAY(resultVal);
+    js_append_char(&b, '[');
+    for (int i = 0; i < arr->count; i++) {
+      if (i > 0)
+        js_append_char(&b, ',');
+      if (IS_OBJECT(arr->items[i]))
+        json_model_object(&b, plan, (ObjObject *)AS_OBJECT(arr->items[i]), 1);
+      else
+        js_serialize(&b, arr->items[i], 1);
+    }
+    js_append_char(&b, ']');
+  } else {
+    js_append_n(&b, "{}", 2);
+  }
+  ObjString *res = aot_allocate_string(b.data, b.len);
+  js_free(&b);
+  return VM_OBJ((Obj *)res);
+}
+
 VMValue aot_wings_build_response(VMValue resultVal, VMValue defaultHeadersVal,
                                  VMValue keepVal) {
   int status = 200;
@@ -8004,7 +8963,7 @@ static VMValue parse_json_array(const char **p, const char *end) {
   ObjArray *arr = (ObjArray *)aot_arena_alloc(sizeof(ObjArray));
   arr->obj.type = OBJ_ARRAY;
   arr->obj.arena_allocated = 1;
-  arr->obj.next = nullptr;
+  arr->obj.is_shared = 0;
   arr->capacity = 8;
   arr->count = 0;
   arr->items = (VMValue *)aot_arena_alloc(sizeof(VMValue) * arr->capacity);
@@ -8046,7 +9005,7 @@ static VMValue parse_json_object(const char **p, const char *end) {
   ObjObject *obj = (ObjObject *)aot_arena_alloc(sizeof(ObjObject));
   obj->obj.type = OBJ_OBJECT;
   obj->obj.arena_allocated = 1;
-  obj->obj.next = nullptr;
+  obj->obj.is_shared = 0;
   obj->capacity = 8;
   obj->count = 0;
   obj->keys =
@@ -8128,28 +9087,381 @@ static VMValue parse_json_value(const char **p, const char *end) {
   return VM_INT(0);
 }
 
-VMValue aot_from_json(VMValue jsonStr) {
-  if (!IS_STRING(jsonStr))
-    return VM_INT(0);
-
-  ObjString *s = AS_STRING(jsonStr);
-  const char *p = s->chars;
-  const char *end = s->chars + s->length;
+// ---- Two-stage fast path -----------------------------------------------------
+// Stage 1 (runtime/tulpar_json.cpp) has already found, with SIMD, every
+// structural byte, string opening quote and atom start, and validated UTF-8.
+// Stage 2 below walks that offset list with an explicit stack — no
+// skip_whitespace, no recursion — and materialises each container once, at
+// its exact size, when its closing bracket is reached (the legacy parser
+// above starts at 8 and re-copies on every doubling, leaving the old blocks
+// in the arena). Object keys are interned per parse: in a 10k-row
+// array-of-records body every row's "id" / "name" is the same ObjString.
+//
+// Anything stage 2 doesn't accept as strict JSON (trailing commas, junk after
+// the value, bad escapes) returns false and aot_from_json falls back to the
+// lenient legacy parser, so malformed bodies parse exactly as they used to.
 
-  return parse_json_value(&p, end);
-}
+struct JsonKeySlot {
+  uint64_t hash;
+  ObjString *key;
+};
 
-// ============================================================================
-// Input Functions (AOT) - Extended
-// ============================================================================
+struct JsonTape {
+  const char *src;
+  size_t len;
+  const uint32_t *pos;
+  size_t count;
+  std::vector<VMValue> values;     // children of the still-open containers
+  std::vector<ObjString *> keys;   // keys of the still-open objects
+  std::vector<JsonKeySlot> table;  // interned keys, open addressing
+  size_t interned = 0;
+  std::string scratch;             // unescape buffer
+};
 
-VMValue aot_input_int(VMValue promptVal) {
-  if (IS_STRING(promptVal)) {
-    printf("%s", AS_STRING(promptVal)->chars);
-    fflush(stdout);
-  }
+// Span of the token starting at pos[i]: up to the next structural offset,
+// minus trailing whitespace.
+static size_t json_tape_span_end(const JsonTape &t, size_t i) {
+  size_t e = i + 1 < t.count ? t.pos[i + 1] : t.len;
+  while (e > t.pos[i] &&
+         (t.src[e - 1] == ' ' || t.src[e - 1] == '\t' ||
+          t.src[e - 1] == '\n' || t.src[e - 1] == '\r'))
+    e--;
+  return e;
+}
+
+static int json_hex4(const char *s, unsigned *out) {
+  unsigned v = 0;
+  for (int k = 0; k < 4; k++) {
+    char c = s[k];
+    v <<= 4;
+    if (c >= '0' && c <= '9') v |= (unsigned)(c - '0');
+    else if (c >= 'a' && c <= 'f') v |= (unsigned)(c - 'a' + 10);
+    else if (c >= 'A' && c <= 'F') v |= (unsigned)(c - 'A' + 10);
+    else return 0;
+  }
+  *out = v;
+  return 1;
+}
 
-  char buf[64];
+// JSON string escapes, including \uXXXX and surrogate pairs (→ UTF-8).
+static bool json_unescape(const char *s, size_t n, std::string *out) {
+  out->clear();
+  size_t i = 0;
+  while (i < n) {
+    const char *bs = (const char *)memchr(s + i, '\\', n - i);
+    size_t run = bs ? (size_t)(bs - (s + i)) : n - i;
+    out->append(s + i, run);
+    i += run;
+    if (i >= n) break;
+    if (i + 1 >= n) return false;
+    char c = s[i + 1];
+    i += 2;
+    switch (c) {
+    case '"': out->push_back('"'); break;
+    case '\\': out->push_back('\\'); break;
+    case '/': out->push_back('/'); break;
+    case 'b': out->push_back('\b'); break;
+    case 'f': out->push_back('\f'); break;
+    case 'n': out->push_back('\n'); break;
+    case 'r': out->push_back('\r'); break;
+    case 't': out->push_back('\t'); break;
+    case 'u': {
+      unsigned cp;
+      if (i + 4 > n || !json_hex4(s + i, &cp)) return false;
+      i += 4;
+      if (cp >= 0xD800 && cp <= 0xDBFF) {
+        unsigned lo;
+        if (i + 6 > n || s[i] != '\\' || s[i + 1] != 'u' ||
+            !json_hex4(s + i + 2, &lo) || lo < 0xDC00 || lo > 0xDFFF)
+          return false;
+        i += 6;
+        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+      } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+        return false;
+      }
+      if (cp < 0x80) {
+        out->push_back((char)cp);
+      } else if (cp < 0x800) {
+        out->push_back((char)(0xC0 | (cp >> 6)));
+        out->push_back((char)(0x80 | (cp & 0x3F)));
+      } else if (cp < 0x10000) {
+        out->push_back((char)(0xE0 | (cp >> 12)));
+        out->push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+        out->push_back((char)(0x80 | (cp & 0x3F)));
+      } else {
+        out->push_back((char)(0xF0 | (cp >> 18)));
+        out->push_back((char)(0x80 | ((cp >> 12) & 0x3F)));
+        out->push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+        out->push_back((char)(0x80 | (cp & 0x3F)));
+      }
+      break;
+    }
+    default:
+      return false;
+    }
+  }
+  return true;
+}
+
+// String token at pos[i] (its opening quote). The closing quote is the last
+// non-whitespace byte before the next structural offset.
+static bool json_tape_string(JsonTape &t, size_t i, const char **chars,
+                             size_t *n) {
+  size_t open = t.pos[i];
+  size_t e = json_tape_span_end(t, i);
+  if (e < open + 2 || t.src[e - 1] != '"') return false;
+  const char *s = t.src + open + 1;
+  size_t raw = e - 1 - (open + 1);
+  if (!memchr(s, '\\', raw)) {
+    *chars = s;
+    *n = raw;
+    return true;
+  }
+  if (!json_unescape(s, raw, &t.scratch)) return false;
+  *chars = t.scratch.data();
+  *n = t.scratch.size();
+  return true;
+}
+
+static uint64_t json_key_hash(const char *s, size_t n) {
+  uint64_t h = 1469598103934665603ULL; // FNV-1a
+  for (size_t k = 0; k < n; k++) {
+    h ^= (unsigned char)s[k];
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+static ObjString *json_tape_key(JsonTape &t, const char *s, size_t n) {
+  if (t.table.empty()) t.table.assign(64, JsonKeySlot{0, nullptr});
+  uint64_t h = json_key_hash(s, n);
+  size_t mask = t.table.size() - 1;
+  for (size_t k = (size_t)h & mask;; k = (k + 1) & mask) {
+    JsonKeySlot &slot = t.table[k];
+    if (!slot.key) break;
+    if (slot.hash == h && (size_t)slot.key->length == n &&
+        memcmp(slot.key->chars, s, n) == 0) {
+      // Shared from here on — keep ref_count honest for anything that
+      // mutates a string in place when it believes it is the only owner.
+      slot.key->obj.ref_count++;
+      return slot.key;
+    }
+  }
+  ObjString *key = aot_allocate_string(s, (int)n);
+  if (!key) return nullptr;
+  if ((t.interned + 1) * 2 > t.table.size()) {
+    std::vector<JsonKeySlot> grown(t.table.size() * 2, JsonKeySlot{0, nullptr});
+    size_t gmask = grown.size() - 1;
+    for (const JsonKeySlot &old : t.table) {
+      if (!old.key) continue;
+      size_t k = (size_t)old.hash & gmask;
+      while (grown[k].key) k = (k + 1) & gmask;
+      grown[k] = old;
+    }
+    t.table.swap(grown);
+    mask = gmask;
+  }
+  size_t k = (size_t)h & mask;
+  while (t.table[k].key) k = (k + 1) & mask;
+  t.table[k] = JsonKeySlot{h, key};
+  t.interned++;
+  return key;
+}
+
+// Bare atom: true / false / null / a JSON number (int or float).
+static bool json_tape_atom(const char *s, size_t n, VMValue *out) {
+  if (n == 4 && memcmp(s, "true", 4) == 0) { *out = VM_BOOL(1); return true; }
+  if (n == 5 && memcmp(s, "false", 5) == 0) { *out = VM_BOOL(0); return true; }
+  if (n == 4 && memcmp(s, "null", 4) == 0) { *out = VM_INT(0); return true; }
+
+  size_t i = 0;
+  bool neg = false, is_float = false;
+  if (i < n && s[i] == '-') { neg = true; i++; }
+  size_t int_start = i;
+  uint64_t v = 0;
+  while (i < n && s[i] >= '0' && s[i] <= '9') v = v * 10 + (uint64_t)(s[i++] - '0');
+  size_t int_digits = i - int_start;
+  if (int_digits == 0 || (int_digits > 1 && s[int_start] == '0')) return false;
+  if (i < n && s[i] == '.') {
+    is_float = true;
+    size_t f = ++i;
+    while (i < n && s[i] >= '0' && s[i] <= '9') i++;
+    if (i == f) return false;
+  }
+  if (i < n && (s[i] == 'e' || s[i] == 'E')) {
+    is_float = true;
+    i++;
+    if (i < n && (s[i] == '+' || s[i] == '-')) i++;
+    size_t d = i;
+    while (i < n && s[i] >= '0' && s[i] <= '9') i++;
+    if (i == d) return false;
+  }
+  if (i != n) return false;
+
+  if (!is_float && int_digits <= 18) {
+    *out = VM_INT(neg ? -(int64_t)v : (int64_t)v);
+    return true;
+  }
+  std::string buf(s, n);
+  if (is_float) *out = VM_FLOAT(strtod(buf.c_str(), nullptr));
+  else *out = VM_INT(strtoll(buf.c_str(), nullptr, 10));
+  return true;
+}
+
+static VMValue json_tape_close_array(JsonTape &t, size_t vbase) {
+  int n = (int)(t.values.size() - vbase);
+  ObjArray *arr = (ObjArray *)aot_arena_alloc(sizeof(ObjArray));
+  arr->obj.type = OBJ_ARRAY;
+  arr->obj.arena_allocated = 1;
+  arr->obj.is_shared = 0;
+  arr->capacity = n ? n : 1;
+  arr->count = n;
+  arr->items = (VMValue *)aot_arena_alloc(sizeof(VMValue) * arr->capacity);
+  if (n) memcpy(arr->items, t.values.data() + vbase, sizeof(VMValue) * n);
+  t.values.resize(vbase);
+  return VM_OBJ((Obj *)arr);
+}
+
+static VMValue json_tape_close_object(JsonTape &t, size_t vbase,
+                                      size_t kbase) {
+  int n = (int)(t.values.size() - vbase);
+  ObjObject *obj = (ObjObject *)aot_arena_alloc(sizeof(ObjObject));
+  obj->obj.type = OBJ_OBJECT;
+  obj->obj.arena_allocated = 1;
+  obj->obj.is_shared = 0;
+  obj->capacity = n ? n : 1;
+  obj->count = n;
+  obj->keys =
+      (ObjString **)aot_arena_alloc(sizeof(ObjString *) * obj->capacity);
+  obj->values = (VMValue *)aot_arena_alloc(sizeof(VMValue) * obj->capacity);
+  if (n) {
+    memcpy(obj->keys, t.keys.data() + kbase, sizeof(ObjString *) * n);
+    memcpy(obj->values, t.values.data() + vbase, sizeof(VMValue) * n);
+  }
+  t.values.resize(vbase);
+  t.keys.resize(kbase);
+  return VM_OBJ((Obj *)obj);
+}
+
+static bool json_tape_build(JsonTape &t, VMValue *result) {
+  struct Frame {
+    bool is_object;
+    size_t vbase, kbase;
+  };
+  std::vector<Frame> stack;
+  enum { EXPECT_VALUE, EXPECT_KEY, AFTER_VALUE } state = EXPECT_VALUE;
+  VMValue cur = VM_INT(0);
+  size_t i = 0;
+
+  for (;;) {
+    if (state == EXPECT_VALUE) {
+      if (i >= t.count) return false;
+      char c = t.src[t.pos[i]];
+      if (c == '[' || c == '{') {
+        bool is_obj = c == '{';
+        if (i + 1 < t.count && t.src[t.pos[i + 1]] == (is_obj ? '}' : ']')) {
+          i += 2;
+          cur = is_obj ? json_tape_close_object(t, t.values.size(), t.keys.size())
+                       : json_tape_close_array(t, t.values.size());
+          state = AFTER_VALUE;
+          continue;
+        }
+        stack.push_back(Frame{is_obj, t.values.size(), t.keys.size()});
+        i++;
+        state = is_obj ? EXPECT_KEY : EXPECT_VALUE;
+        continue;
+      }
+      if (c == '"') {
+        const char *s;
+        size_t n;
+        if (!json_tape_string(t, i, &s, &n)) return false;
+        ObjString *str = aot_allocate_string(s, (int)n);
+        if (!str) return false;
+        cur = VM_OBJ((Obj *)str);
+      } else if (c == ']' || c == '}' || c == ',' || c == ':') {
+        return false;
+      } else if (!json_tape_atom(t.src + t.pos[i],
+                                 json_tape_span_end(t, i) - t.pos[i], &cur)) {
+        return false;
+      }
+      i++;
+      state = AFTER_VALUE;
+    } else if (state == EXPECT_KEY) {
+      if (i + 1 >= t.count || t.src[t.pos[i]] != '"' ||
+          t.src[t.pos[i + 1]] != ':')
+        return false;
+      const char *s;
+      size_t n;
+      if (!json_tape_string(t, i, &s, &n)) return false;
+      ObjString *key = json_tape_key(t, s, n);
+      if (!key) return false;
+      t.keys.push_back(key);
+      i += 2;
+      state = EXPECT_VALUE;
+    } else { // AFTER_VALUE
+      if (stack.empty()) {
+        if (i != t.count) return false; // junk after the top-level value
+        *result = cur;
+        return true;
+      }
+      t.values.push_back(cur);
+      if (i >= t.count) return false;
+      char c = t.src[t.pos[i++]];
+      Frame top = stack.back();
+      if (c == ',') {
+        state = top.is_object ? EXPECT_KEY : EXPECT_VALUE;
+      } else if (c == (top.is_object ? '}' : ']')) {
+        stack.pop_back();
+        cur = top.is_object ? json_tape_close_object(t, top.vbase, top.kbase)
+                            : json_tape_close_array(t, top.vbase);
+      } else {
+        return false;
+      }
+    }
+  }
+}
+
+VMValue aot_from_json(VMValue jsonStr) {
+  if (!IS_STRING(jsonStr))
+    return VM_INT(0);
+
+  ObjString *s = AS_STRING(jsonStr);
+  const char *p = s->chars;
+  const char *end = s->chars + s->length;
+
+  TulparJsonIndex ix;
+  int rc = tulpar_json_index((const unsigned char *)p, (size_t)s->length, &ix);
+  if (rc == TULPAR_JSON_EUTF8)
+    return VM_INT(0); // not JSON (RFC 8259 §8.1) — same as a non-string arg
+  if (rc == TULPAR_JSON_OK) {
+    JsonTape t;
+    t.src = p;
+    t.len = (size_t)s->length;
+    t.pos = ix.pos;
+    t.count = ix.count;
+    VMValue out;
+    bool ok = json_tape_build(t, &out);
+    tulpar_json_index_free(&ix);
+    if (ok)
+      return out;
+  }
+
+  // Lenient path: not strict JSON (or an unterminated string) — keep the
+  // legacy parser's best-effort result for these bodies.
+  return parse_json_value(&p, end);
+}
+
+// ============================================================================
+// Input Functions (AOT) - Extended
+// ============================================================================
+
+VMValue aot_input_int(VMValue promptVal) {
+  if (IS_STRING(promptVal)) {
+    printf("%s", AS_STRING(promptVal)->chars);
+    fflush(stdout);
+  }
+
+  char buf[64];
   if (fgets(buf, sizeof(buf), stdin)) {
     size_t len = strlen(buf);
     if (len > 0 && buf[len - 1] == '\n') {
@@ -8189,34 +9501,45 @@ VMValue aot_input_float(VMValue promptVal) {
 // Range Function (AOT)
 // ============================================================================
 
-VMValue aot_range(VMValue endVal) {
-  int64_t end = IS_INT(endVal) ? AS_INT(endVal) : 0;
-  if (end <= 0) {
-    ObjArray *arr = (ObjArray *)aot_arena_alloc(sizeof(ObjArray));
-    arr->obj.type = OBJ_ARRAY;
-    arr->obj.arena_allocated = 1;
-    arr->obj.next = nullptr;
-    arr->capacity = 0;
-    arr->count = 0;
-    arr->items = nullptr;
-    return VM_OBJ((Obj *)arr);
-  }
+// range(start, end, step) as an ObjArray of boxed ints. Only a range() that
+// escapes gets here (stored, passed, returned, indexed): the backend lowers
+// `for (x in range(...))` to a counted loop that never calls it. A 0 step, or
+// one pointing away from `end`, is an empty array. Arguments are truncated
+// like toInt(), the same as that loop: range(1.5, 4) is [1,2,3].
+static VMValue range_array(int64_t start, int64_t end, int64_t step) {
+  int64_t count = 0;
+  if (step > 0 && end > start)
+    count = (int64_t)(((uint64_t)end - (uint64_t)start - 1) / (uint64_t)step) + 1;
+  else if (step < 0 && end < start)
+    count = (int64_t)(((uint64_t)start - (uint64_t)end - 1) /
+                      (0 - (uint64_t)step)) + 1;
 
   ObjArray *arr = (ObjArray *)aot_arena_alloc(sizeof(ObjArray));
   arr->obj.type = OBJ_ARRAY;
   arr->obj.arena_allocated = 1;
-  arr->obj.next = nullptr;
-  arr->capacity = (int)end;
-  arr->count = (int)end;
-  arr->items = (VMValue *)aot_arena_alloc(sizeof(VMValue) * end);
+  arr->obj.is_shared = 0;
+  arr->capacity = (int)count;
+  arr->count = (int)count;
+  arr->items =
+      count > 0 ? (VMValue *)aot_arena_alloc(sizeof(VMValue) * count) : nullptr;
 
-  for (int64_t i = 0; i < end; i++) {
-    arr->items[i] = VM_INT(i);
+  int64_t v = start;
+  for (int64_t i = 0; i < count; i++, v += step) {
+    arr->items[i] = VM_INT(v);
   }
 
   return VM_OBJ((Obj *)arr);
 }
 
+VMValue aot_range(VMValue endVal) {
+  return range_array(0, aot_to_int(endVal), 1);
+}
+
+VMValue aot_range_step(VMValue startVal, VMValue endVal, VMValue stepVal) {
+  return range_array(aot_to_int(startVal), aot_to_int(endVal),
+                     aot_to_int(stepVal));
+}
+
 // ============================================================================
 // SQLite Database Functions (AOT)
 // ============================================================================
@@ -8234,6 +9557,8 @@ VMValue aot_range(VMValue endVal) {
 // — each open() would see a fresh empty DB — so they keep a single shared
 // connection (the historical serialized behavior).
 // ----------------------------------------------------------------------------
+struct DbGroupCommit; // opt-in write coalescing (db_group_commit), see below
+
 struct DbConn {
   std::string path;
   bool wal = false;             // apply WAL pragmas on each connection
@@ -8242,6 +9567,8 @@ struct DbConn {
   std::mutex conns_mu;          // guards conns (file-backed mode)
   std::vector<sqlite3 *> conns; // every per-thread conn opened, for db_close
   std::atomic<bool> closed{false};
+  std::mutex gc_ctl_mu;                    // serializes group-commit start/stop
+  std::atomic<DbGroupCommit *> gc{nullptr}; // allocated on first enable
 };
 
 static std::mutex g_db_registry_mu;
@@ -8254,19 +9581,67 @@ static thread_local std::vector<sqlite3 *> g_db_tls_conns;
 // connections are per-thread (g_db_tls_conns), this is naturally lock-free on
 // the hot path. db_query reuses a compiled statement via sqlite3_reset instead
 // of re-preparing identical SQL, a win for read-heavy endpoints running the
-// same SELECT repeatedly. Queries are raw SQL strings (no bound params), so
-// only EXACT repeats hit; values baked into the SQL each get their own entry.
-// Bounded with FIFO eviction (the evicted statement is finalized). prepare_v2
-// auto-reprepares cached statements across schema changes, so caching is safe.
-// db_close uses sqlite3_close_v2 so any still-cached statements don't block the
-// close (the connection is reclaimed once they finalize, e.g. on eviction).
+// same SELECT repeatedly. Only EXACT SQL repeats hit; values baked into the
+// SQL each get their own entry (bound `?` params don't).
+//
+// Lookup is a hash of the SQL text into an index map (the SQL is compared
+// once, on the candidate only); eviction is true LRU — a hit moves the entry
+// to the front — so a hot query survives a burst of one-off ad-hoc SQL that
+// FIFO would have let push it out. Capacity per connection defaults to 64;
+// TULPAR_DB_STMT_CACHE=<n> overrides it (minimum 1). Hits, misses
+// and evictions are counted process-wide for db_stats() / Wings metrics.
+// prepare_v2 auto-reprepares cached statements across schema changes, so
+// caching is safe. db_close uses sqlite3_close_v2 so any still-cached
+// statements don't block the close (the connection is reclaimed once they
+// finalize, e.g. on eviction).
 struct StmtCacheEntry {
+  uint64_t hash;
   std::string sql;
   sqlite3_stmt *stmt;
 };
-static const size_t kStmtCacheCap = 64;
-static thread_local std::unordered_map<sqlite3 *, std::vector<StmtCacheEntry>>
-    g_stmt_cache;
+struct StmtCache {
+  std::list<StmtCacheEntry> lru; // most recently used first
+  std::unordered_map<uint64_t, std::list<StmtCacheEntry>::iterator> index;
+};
+static thread_local std::unordered_map<sqlite3 *, StmtCache> g_stmt_cache;
+
+static std::atomic<uint64_t> g_stmt_cache_hits{0};
+static std::atomic<uint64_t> g_stmt_cache_misses{0};
+static std::atomic<uint64_t> g_stmt_cache_evictions{0};
+
+static size_t db_stmt_cache_cap(void) {
+  static const size_t cap = [] {
+    const char *env = getenv("TULPAR_DB_STMT_CACHE");
+    if (env && *env) {
+      long v = atol(env);
+      return v > 0 ? (size_t)v : (size_t)1;
+    }
+    return (size_t)64;
+  }();
+  return cap;
+}
+
+static uint64_t db_sql_hash(const char *sql, int len) {
+  uint64_t h = 1469598103934665603ULL; // FNV-1a
+  for (int i = 0; i < len; i++) {
+    h ^= (unsigned char)sql[i];
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+// Prepare without caching: a statement owned by one cursor / db_prepare
+// handle. nullptr on failure.
+static sqlite3_stmt *db_prepare_raw(sqlite3 *db, const char *sql, int sql_len) {
+  sqlite3_stmt *stmt = nullptr;
+  if (sqlite3_prepare_v2(db, sql, sql_len, &stmt, nullptr) != SQLITE_OK ||
+      !stmt) {
+    if (stmt)
+      sqlite3_finalize(stmt);
+    return nullptr;
+  }
+  return stmt;
+}
 
 // Return a ready-to-step statement for `sql` on `db`: a reset cache hit, or a
 // freshly prepared + cached statement. nullptr on prepare failure. The caller
@@ -8274,37 +9649,92 @@ static thread_local std::unordered_map<sqlite3 *, std::vector<StmtCacheEntry>>
 // to release locks (the next reuse resets again, which is harmless).
 static sqlite3_stmt *db_cached_prepare(sqlite3 *db, const char *sql,
                                        int sql_len) {
-  std::vector<StmtCacheEntry> &cache = g_stmt_cache[db];
-  for (size_t i = 0; i < cache.size(); i++) {
-    if (cache[i].sql.size() == (size_t)sql_len &&
-        memcmp(cache[i].sql.data(), sql, sql_len) == 0) {
-      sqlite3_reset(cache[i].stmt);
-      return cache[i].stmt;
-    }
-  }
-  sqlite3_stmt *stmt = nullptr;
-  if (sqlite3_prepare_v2(db, sql, sql_len, &stmt, nullptr) != SQLITE_OK || !stmt)
+  StmtCache &cache = g_stmt_cache[db];
+  uint64_t h = db_sql_hash(sql, sql_len);
+  std::unordered_map<uint64_t, std::list<StmtCacheEntry>::iterator>::iterator
+      hit = cache.index.find(h);
+  if (hit != cache.index.end()) {
+    std::list<StmtCacheEntry>::iterator e = hit->second;
+    if (e->sql.size() == (size_t)sql_len &&
+        memcmp(e->sql.data(), sql, sql_len) == 0) {
+      g_stmt_cache_hits.fetch_add(1, std::memory_order_relaxed);
+      if (e != cache.lru.begin())
+        cache.lru.splice(cache.lru.begin(), cache.lru, e);
+      sqlite3_reset(e->stmt);
+      return e->stmt;
+    }
+    // 64-bit hash collision: the newer SQL takes the slot.
+    sqlite3_finalize(e->stmt);
+    cache.lru.erase(e);
+    cache.index.erase(hit);
+  }
+  g_stmt_cache_misses.fetch_add(1, std::memory_order_relaxed);
+  sqlite3_stmt *stmt = db_prepare_raw(db, sql, sql_len);
+  if (!stmt)
     return nullptr;
-  if (cache.size() >= kStmtCacheCap) {
-    sqlite3_finalize(cache.front().stmt); // FIFO evict
-    cache.erase(cache.begin());
-  }
-  cache.push_back({std::string(sql, (size_t)sql_len), stmt});
+  while (cache.lru.size() >= db_stmt_cache_cap()) {
+    StmtCacheEntry &old = cache.lru.back();
+    cache.index.erase(old.hash);
+    sqlite3_finalize(old.stmt);
+    cache.lru.pop_back();
+    g_stmt_cache_evictions.fetch_add(1, std::memory_order_relaxed);
+  }
+  cache.lru.push_front({h, std::string(sql, (size_t)sql_len), stmt});
+  cache.index[h] = cache.lru.begin();
   return stmt;
 }
 
 // Finalize and drop THIS thread's cached statements for `db` (called on close
 // so the common single-thread / shared path is fully leak-free).
 static void db_drop_stmt_cache(sqlite3 *db) {
-  std::unordered_map<sqlite3 *, std::vector<StmtCacheEntry>>::iterator it =
-      g_stmt_cache.find(db);
+  std::unordered_map<sqlite3 *, StmtCache>::iterator it = g_stmt_cache.find(db);
   if (it == g_stmt_cache.end())
     return;
-  for (size_t i = 0; i < it->second.size(); i++)
-    sqlite3_finalize(it->second[i].stmt);
+  for (StmtCacheEntry &e : it->second.lru)
+    sqlite3_finalize(e.stmt);
   g_stmt_cache.erase(it);
 }
 
+// Open db_cursor statements, per thread (see "Cursors" below).
+struct DbCursor {
+  sqlite3 *db = nullptr;
+  sqlite3_stmt *stmt = nullptr; // nullptr once db_close finalized it
+  int cols = 0;
+  ObjString **keys = nullptr;   // malloc'd; entries are interned names
+  bool open = false;
+};
+static thread_local std::vector<DbCursor> g_db_cursors;
+
+static void db_cursor_finish(DbCursor &c) {
+  if (c.stmt)
+    sqlite3_finalize(c.stmt);
+  c.stmt = nullptr;
+}
+
+// Finalize THIS thread's cursors on `db` (db_close; as db_drop_stmt_cache).
+static void db_drop_cursors(sqlite3 *db) {
+  for (DbCursor &c : g_db_cursors)
+    if (c.open && c.db == db)
+      db_cursor_finish(c);
+}
+
+// db_prepare handles (see "Prepared handles" below): this thread's pinned
+// statement per handle, prepared on its own connection on first use.
+struct DbPinnedStmt {
+  sqlite3 *db = nullptr;
+  sqlite3_stmt *stmt = nullptr;
+};
+static thread_local std::vector<DbPinnedStmt> g_db_pinned;
+
+static void db_drop_pinned(sqlite3 *db) {
+  for (DbPinnedStmt &p : g_db_pinned)
+    if (p.stmt && p.db == db) {
+      sqlite3_finalize(p.stmt);
+      p.stmt = nullptr;
+      p.db = nullptr;
+    }
+}
+
 static void db_apply_pragmas(sqlite3 *db, bool wal) {
   // busy_timeout: on a locked DB, block-and-retry for up to 5s instead of
   // failing immediately with SQLITE_BUSY (matters now that independent
@@ -8351,9 +9781,8 @@ static sqlite3 *db_open_conn(DbConn *desc) {
   return db;
 }
 
-// Resolve a handle to the connection THIS thread should use. For file-backed
-// DBs the connection is opened lazily on first use per thread.
-static sqlite3 *db_resolve(VMValue dbVal) {
+// Descriptor for an open handle (nullptr if invalid or closed).
+static DbConn *db_desc(VMValue dbVal) {
   if (!IS_INT(dbVal))
     return nullptr;
   int64_t h = AS_INT(dbVal);
@@ -8367,11 +9796,21 @@ static sqlite3 *db_resolve(VMValue dbVal) {
       return nullptr;
     desc = g_db_registry[id];
   }
-  // closed checked before consulting the tls cache, so a connection already
-  // closed by db_close (possibly from another thread at shutdown) is never
-  // reused through a stale per-thread pointer.
   if (!desc || desc->closed.load())
     return nullptr;
+  return desc;
+}
+
+// Resolve a handle to the connection THIS thread should use. For file-backed
+// DBs the connection is opened lazily on first use per thread.
+static sqlite3 *db_resolve(VMValue dbVal) {
+  // closed checked (db_desc) before consulting the tls cache, so a connection
+  // already closed by db_close (possibly from another thread at shutdown) is
+  // never reused through a stale per-thread pointer.
+  DbConn *desc = db_desc(dbVal);
+  if (!desc)
+    return nullptr;
+  size_t id = (size_t)(AS_INT(dbVal) - 1);
   if (desc->shared)
     return desc->shared_conn;
   if (g_db_tls_conns.size() <= id)
@@ -8445,6 +9884,8 @@ VMValue aot_db_open_ptr(VMValue *path_ptr) {
   return aot_db_open(*path_ptr);
 }
 
+static void db_group_commit_stop(DbConn *desc);
+
 // db_close(db_handle) -> void
 void aot_db_close(VMValue dbVal) {
   if (!IS_INT(dbVal))
@@ -8468,6 +9909,8 @@ void aot_db_close(VMValue dbVal) {
   // gates on `closed` so those threads stop using their cached pointers.
   if (desc->closed.exchange(true))
     return;
+  // Drain and join the group-commit writer first: queued writes still land.
+  db_group_commit_stop(desc);
   // Finalize this thread's cached prepared statements for the connections being
   // closed (keeps the common single-thread / shared :memory: path leak-free),
   // then close. sqlite3_close_v2 tolerates statements still cached by OTHER
@@ -8475,6 +9918,8 @@ void aot_db_close(VMValue dbVal) {
   // eviction) instead of failing with SQLITE_BUSY.
   if (desc->shared) {
     if (desc->shared_conn) {
+      db_drop_cursors(desc->shared_conn);
+      db_drop_pinned(desc->shared_conn);
       db_drop_stmt_cache(desc->shared_conn);
       sqlite3_close_v2(desc->shared_conn);
       desc->shared_conn = nullptr;
@@ -8483,6 +9928,8 @@ void aot_db_close(VMValue dbVal) {
     std::lock_guard<std::mutex> g(desc->conns_mu);
     for (sqlite3 *db : desc->conns)
       if (db) {
+        db_drop_cursors(db);
+        db_drop_pinned(db);
         db_drop_stmt_cache(db);
         sqlite3_close_v2(db);
       }
@@ -8498,6 +9945,11 @@ void aot_db_close_ptr(VMValue *db_ptr) {
   aot_db_close(*db_ptr);
 }
 
+// Group commit (db_group_commit), defined with db_executemany below.
+static bool db_group_write(VMValue dbVal, sqlite3 *own, const char *sql,
+                           int sql_len, VMValue params, bool many, bool *ok);
+static void db_forget_group_id(VMValue dbVal);
+
 // db_execute(db_handle, sql) -> bool (success)
 VMValue aot_db_execute(VMValue dbVal, VMValue sqlVal) {
   if (!IS_STRING(sqlVal))
@@ -8508,6 +9960,7 @@ VMValue aot_db_execute(VMValue dbVal, VMValue sqlVal) {
 
   if (!db)
     return VM_BOOL(0);
+  db_forget_group_id(dbVal);
 
   char *errMsg = nullptr;
   int rc = sqlite3_exec(db, sql->chars, nullptr, nullptr, &errMsg);
@@ -8525,6 +9978,105 @@ VMValue aot_db_execute_ptr(VMValue *db_ptr, VMValue *sql_ptr) {
   return aot_db_execute(*db_ptr, *sql_ptr);
 }
 
+// ----------------------------------------------------------------------------
+// Result rows
+//
+// Column names are interned per thread in permanent (malloc'd) storage: a
+// 100k-row SELECT used to allocate 100k x cols key strings in the arena, all
+// copies of the same few names. Now every row of a result set points at ONE
+// key array and the strings behind it are shared by every query that names
+// the same column. They must outlive arena_restore (a cursor loop may rewind
+// the arena between rows) and are never released — the table is capped, and
+// past the cap names fall back to per-result arena copies.
+// ----------------------------------------------------------------------------
+static const size_t kDbKeyInternCap = 4096;
+static thread_local std::unordered_map<std::string, ObjString *> g_db_keys;
+
+static ObjString *db_column_key(const char *name) {
+  if (!name)
+    name = "";
+  std::string k(name);
+  std::unordered_map<std::string, ObjString *>::iterator it = g_db_keys.find(k);
+  if (it != g_db_keys.end())
+    return it->second;
+  if (g_db_keys.size() >= kDbKeyInternCap)
+    return aot_allocate_string(name, (int)k.size());
+  ObjString *key = aot_persist_chars(k.c_str(), (int)k.size());
+  if (!key)
+    return aot_allocate_string(name, (int)k.size());
+  g_db_keys.emplace(k, key);
+  return key;
+}
+
+// Key array for `stmt`'s columns, arena-allocated; rows alias it. Safe to
+// share: an insert into a row whose count == capacity always reallocates its
+// key array first (vm_object_set), so no row ever writes into this one.
+static ObjString **db_column_keys(sqlite3_stmt *stmt, int cols) {
+  if (cols <= 0)
+    return nullptr;
+  ObjString **keys = (ObjString **)aot_arena_alloc(sizeof(ObjString *) * cols);
+  for (int i = 0; i < cols; i++)
+    keys[i] = db_column_key(sqlite3_column_name(stmt, i));
+  return keys;
+}
+
+// Column `i` of the current row. BLOB / NULL read as 0, as before.
+static VMValue db_column_value(sqlite3_stmt *stmt, int i) {
+  switch (sqlite3_column_type(stmt, i)) {
+  case SQLITE_INTEGER:
+    return VM_INT(sqlite3_column_int64(stmt, i));
+  case SQLITE_FLOAT:
+    return VM_FLOAT(sqlite3_column_double(stmt, i));
+  case SQLITE_TEXT: {
+    const char *text = (const char *)sqlite3_column_text(stmt, i);
+    int len = sqlite3_column_bytes(stmt, i);
+    return VM_OBJ((Obj *)aot_allocate_string(text, len));
+  }
+  default:
+    return VM_INT(0);
+  }
+}
+
+static ObjObject *db_row_object(sqlite3_stmt *stmt, ObjString **keys,
+                                int cols) {
+  ObjObject *row = (ObjObject *)aot_arena_alloc(sizeof(ObjObject));
+  row->obj.type = OBJ_OBJECT;
+  row->obj.arena_allocated = 1;
+  row->obj.is_shared = 0;
+  row->obj.ref_count = 1;
+  row->obj.is_moved = 0;
+  row->capacity = cols;
+  row->count = cols;
+  row->keys = keys;
+  row->values = (VMValue *)aot_arena_alloc(sizeof(VMValue) * cols);
+  for (int i = 0; i < cols; i++)
+    row->values[i] = db_column_value(stmt, i);
+  return row;
+}
+
+static void db_array_push(ObjArray *arr, VMValue v) {
+  if (arr->count >= arr->capacity) {
+    int new_cap = arr->capacity < 16 ? 16 : arr->capacity * 2;
+    VMValue *new_items = (VMValue *)aot_arena_alloc(sizeof(VMValue) * new_cap);
+    if (arr->count > 0)
+      memcpy(new_items, arr->items, sizeof(VMValue) * arr->count);
+    arr->items = new_items;
+    arr->capacity = new_cap;
+  }
+  arr->items[arr->count++] = v;
+}
+
+// Step `stmt` to the end, appending one row object per result row. Returns
+// the final sqlite3_step code (SQLITE_DONE on a clean finish).
+static int db_collect_rows(sqlite3_stmt *stmt, ObjArray *result) {
+  int cols = sqlite3_column_count(stmt);
+  ObjString **keys = db_column_keys(stmt, cols);
+  int step_rc;
+  while ((step_rc = sqlite3_step(stmt)) == SQLITE_ROW)
+    db_array_push(result, VM_OBJ((Obj *)db_row_object(stmt, keys, cols)));
+  return step_rc;
+}
+
 // db_query(db_handle, sql) -> array of objects (rows)
 VMValue aot_db_query(VMValue dbVal, VMValue sqlVal) {
   if (!IS_STRING(sqlVal)) {
@@ -8532,7 +10084,7 @@ VMValue aot_db_query(VMValue dbVal, VMValue sqlVal) {
     ObjArray *arr = (ObjArray *)aot_arena_alloc(sizeof(ObjArray));
     arr->obj.type = OBJ_ARRAY;
     arr->obj.arena_allocated = 1;
-    arr->obj.next = nullptr;
+    arr->obj.is_shared = 0;
     arr->capacity = 0;
     arr->count = 0;
     arr->items = nullptr;
@@ -8546,7 +10098,7 @@ VMValue aot_db_query(VMValue dbVal, VMValue sqlVal) {
   ObjArray *result = (ObjArray *)aot_arena_alloc(sizeof(ObjArray));
   result->obj.type = OBJ_ARRAY;
   result->obj.arena_allocated = 1;
-  result->obj.next = nullptr;
+  result->obj.is_shared = 0;
   result->capacity = 16;
   result->count = 0;
   result->items =
@@ -8565,65 +10117,7 @@ VMValue aot_db_query(VMValue dbVal, VMValue sqlVal) {
     return VM_OBJ((Obj *)result);
   }
 
-  int col_count = sqlite3_column_count(stmt);
-
-  // Fetch rows
-  int step_rc;
-  while ((step_rc = sqlite3_step(stmt)) == SQLITE_ROW) {
-    // Create object for this row
-    ObjObject *row = (ObjObject *)aot_arena_alloc(sizeof(ObjObject));
-    row->obj.type = OBJ_OBJECT;
-    row->obj.arena_allocated = 1;
-    row->obj.next = nullptr;
-    row->capacity = col_count;
-    row->count = 0;
-    row->keys = (ObjString **)aot_arena_alloc(sizeof(ObjString *) * col_count);
-    row->values = (VMValue *)aot_arena_alloc(sizeof(VMValue) * col_count);
-
-    for (int i = 0; i < col_count; i++) {
-      const char *col_name = sqlite3_column_name(stmt, i);
-      row->keys[row->count] = aot_allocate_string(col_name, strlen(col_name));
-
-      // Get value based on type
-      int col_type = sqlite3_column_type(stmt, i);
-      VMValue val;
-
-      switch (col_type) {
-      case SQLITE_INTEGER:
-        val = VM_INT(sqlite3_column_int64(stmt, i));
-        break;
-      case SQLITE_FLOAT:
-        val = VM_FLOAT(sqlite3_column_double(stmt, i));
-        break;
-      case SQLITE_TEXT: {
-        const char *text = (const char *)sqlite3_column_text(stmt, i);
-        int len = sqlite3_column_bytes(stmt, i);
-        val = VM_OBJ((Obj *)aot_allocate_string(text, len));
-        break;
-      }
-      case SQLITE_BLOB:
-      case SQLITE_NULL:
-      default:
-        val = VM_INT(0); // nullptr
-        break;
-      }
-
-      row->values[row->count] = val;
-      row->count++;
-    }
-
-    // Grow result array if needed
-    if (result->count >= result->capacity) {
-      int new_cap = result->capacity * 2;
-      VMValue *new_items =
-          (VMValue *)aot_arena_alloc(sizeof(VMValue) * new_cap);
-      memcpy(new_items, result->items, sizeof(VMValue) * result->count);
-      result->items = new_items;
-      result->capacity = new_cap;
-    }
-
-    result->items[result->count++] = VM_OBJ((Obj *)row);
-  }
+  int step_rc = db_collect_rows(stmt, result);
 
   // step_rc is SQLITE_DONE on a clean finish; anything else (e.g. a residual
   // SQLITE_BUSY the busy handler couldn't resolve) means the row set may be
@@ -8683,6 +10177,11 @@ VMValue aot_db_execute_params(VMValue dbVal, VMValue sqlVal, VMValue paramsVal)
   if (!db)
     return VM_BOOL(0);
   ObjString *sql = AS_STRING(sqlVal);
+  bool grouped_ok;
+  if (db_group_write(dbVal, db, sql->chars, sql->length, paramsVal, false,
+                     &grouped_ok))
+    return VM_BOOL(grouped_ok);
+  db_forget_group_id(dbVal);
   sqlite3_stmt *stmt = db_cached_prepare(db, sql->chars, sql->length);
   if (!stmt) {
     if (getenv("TULPAR_DB_DEBUG"))
@@ -8711,13 +10210,293 @@ VMValue aot_db_execute_params_ptr(VMValue *db_ptr, VMValue *sql_ptr,
                               params_ptr ? *params_ptr : VM_INT(0));
 }
 
+// ----------------------------------------------------------------------------
+// Batched writes: db_executemany + opt-in group commit
+//
+// Outside an explicit transaction every db_execute is its own implicit
+// transaction, i.e. one WAL commit (and, with synchronous=NORMAL, one WAL
+// append + lock round-trip) per INSERT. Two ways to amortize that:
+//
+//   * db_executemany(db, sql, rows) binds one prepared statement in a loop
+//     over an array of param arrays inside ONE transaction (a savepoint if
+//     the connection is already in one). All-or-nothing.
+//   * db_group_commit(db, true) starts a writer thread with its own
+//     connection. Parameterized db_execute / db_executemany / db_stmt_execute
+//     calls from any worker thread are queued to it instead of running on the
+//     caller's connection; the writer drains whatever has queued up into one
+//     BEGIN IMMEDIATE ... COMMIT and then wakes each caller with its own
+//     result (and last-insert id), so db_execute still returns only after its
+//     write is durable. No timer: requests accumulate naturally while the
+//     previous batch commits, so a lone writer pays no extra latency. A
+//     failing statement only fails its own request (SQLite rolls back the
+//     statement, not the batch). Callers inside their own explicit
+//     transaction, and the raw 2-arg db_execute (DDL, BEGIN, PRAGMA), stay on
+//     the caller's connection. File-backed DBs only.
+// ----------------------------------------------------------------------------
+
+// Bind + step every row of `rowsVal` through `stmt` inside one transaction
+// (or savepoint). Any failing row rolls the whole batch back.
+static bool db_exec_many(sqlite3 *db, sqlite3_stmt *stmt, VMValue rowsVal) {
+  if (!IS_ARRAY(rowsVal))
+    return false;
+  ObjArray *rows = AS_ARRAY(rowsVal);
+  if (rows->count == 0)
+    return true;
+  bool own_tx = sqlite3_get_autocommit(db) != 0;
+  if (sqlite3_exec(db, own_tx ? "BEGIN IMMEDIATE" : "SAVEPOINT tulpar_many",
+                   nullptr, nullptr, nullptr) != SQLITE_OK)
+    return false;
+  bool ok = true;
+  for (int i = 0; i < rows->count && ok; i++) {
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    if (!IS_ARRAY(rows->items[i])) {
+      ok = false;
+      break;
+    }
+    db_bind_params(stmt, rows->items[i]);
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+    }
+    ok = rc == SQLITE_DONE;
+    if (!ok && getenv("TULPAR_DB_DEBUG"))
+      fprintf(stderr, "[dbm] row %d rc=%d (%s)\n", i, rc, sqlite3_errmsg(db));
+  }
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+  if (own_tx) {
+    if (ok && sqlite3_exec(db, "COMMIT", nullptr, nullptr, nullptr) != SQLITE_OK)
+      ok = false;
+    if (!ok && !sqlite3_get_autocommit(db))
+      sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+  } else {
+    if (!ok)
+      sqlite3_exec(db, "ROLLBACK TO tulpar_many", nullptr, nullptr, nullptr);
+    sqlite3_exec(db, "RELEASE tulpar_many", nullptr, nullptr, nullptr);
+  }
+  return ok;
+}
+
+// One queued write. Lives on the calling thread's stack; the caller blocks
+// until `done`, so the VM strings/arrays it points at stay valid.
+struct DbWriteReq {
+  const char *sql;
+  int sql_len;
+  VMValue params; // one param array, or an array of them when `many`
+  bool many;
+  bool ok = false;
+  bool done = false;
+  int64_t last_id = 0;
+};
+
+struct DbGroupCommit {
+  std::mutex mu;
+  std::condition_variable cv;      // writer: work queued / stop requested
+  std::condition_variable done_cv; // callers: a batch finished
+  std::deque<DbWriteReq *> queue;
+  std::thread writer;
+  sqlite3 *conn = nullptr; // writer-owned connection
+  bool running = false;
+};
+
+static const size_t kDbGroupMaxBatch = 512;
+static std::atomic<uint64_t> g_db_group_batches{0};
+static std::atomic<uint64_t> g_db_group_writes{0};
+
+// Last-insert id of this thread's most recent grouped write, per handle id:
+// the insert ran on the writer's connection, so the caller's own connection
+// doesn't know it. Cleared by the next direct write.
+static thread_local std::unordered_map<size_t, int64_t> g_db_group_last_id;
+
+static void db_forget_group_id(VMValue dbVal) {
+  if (!g_db_group_last_id.empty() && IS_INT(dbVal))
+    g_db_group_last_id.erase((size_t)(AS_INT(dbVal) - 1));
+}
+
+static void db_group_run_one(sqlite3 *db, DbWriteReq *r) {
+  sqlite3_stmt *stmt = db_cached_prepare(db, r->sql, r->sql_len);
+  if (!stmt) {
+    r->ok = false;
+    return;
+  }
+  if (r->many) {
+    r->ok = db_exec_many(db, stmt, r->params);
+  } else {
+    sqlite3_clear_bindings(stmt);
+    db_bind_params(stmt, r->params);
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+    }
+    r->ok = rc == SQLITE_DONE;
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+  }
+  r->last_id = sqlite3_last_insert_rowid(db);
+}
+
+static void db_group_writer(DbGroupCommit *gc) {
+  sqlite3 *db = gc->conn;
+  std::vector<DbWriteReq *> batch;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lk(gc->mu);
+      gc->cv.wait(lk, [gc] { return !gc->queue.empty() || !gc->running; });
+      if (gc->queue.empty())
+        break; // stopped and drained
+      size_t n = std::min(gc->queue.size(), kDbGroupMaxBatch);
+      batch.assign(gc->queue.begin(), gc->queue.begin() + n);
+      gc->queue.erase(gc->queue.begin(), gc->queue.begin() + n);
+    }
+    // `first` = start of the requests covered by the open transaction. An
+    // error that aborts the whole transaction (IOERR, FULL, ...) flips the
+    // connection back to autocommit: everything since `first` is lost, so
+    // those requests fail and a fresh transaction covers the rest.
+    bool tx = sqlite3_exec(db, "BEGIN IMMEDIATE", nullptr, nullptr,
+                           nullptr) == SQLITE_OK;
+    size_t first = 0;
+    for (size_t i = 0; i < batch.size(); i++) {
+      db_group_run_one(db, batch[i]);
+      if (tx && sqlite3_get_autocommit(db)) {
+        for (size_t j = first; j <= i; j++)
+          batch[j]->ok = false;
+        first = i + 1;
+        tx = sqlite3_exec(db, "BEGIN IMMEDIATE", nullptr, nullptr,
+                          nullptr) == SQLITE_OK;
+      }
+    }
+    if (tx && sqlite3_exec(db, "COMMIT", nullptr, nullptr, nullptr) !=
+                  SQLITE_OK) {
+      sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+      for (size_t j = first; j < batch.size(); j++)
+        batch[j]->ok = false;
+    }
+    g_db_group_batches.fetch_add(1, std::memory_order_relaxed);
+    g_db_group_writes.fetch_add(batch.size(), std::memory_order_relaxed);
+    {
+      std::lock_guard<std::mutex> g(gc->mu);
+      for (DbWriteReq *r : batch)
+        r->done = true;
+    }
+    gc->done_cv.notify_all();
+    batch.clear();
+  }
+  db_drop_stmt_cache(db);
+  sqlite3_close_v2(db);
+  gc->conn = nullptr;
+}
+
+// Route a write to the handle's group-commit writer. false = not enabled (or
+// the caller is inside its own transaction): the caller runs it directly.
+static bool db_group_write(VMValue dbVal, sqlite3 *own, const char *sql,
+                           int sql_len, VMValue params, bool many, bool *ok) {
+  DbConn *desc = db_desc(dbVal);
+  DbGroupCommit *gc = desc ? desc->gc.load() : nullptr;
+  if (!gc || !sqlite3_get_autocommit(own))
+    return false;
+  DbWriteReq req;
+  req.sql = sql;
+  req.sql_len = sql_len;
+  req.params = params;
+  req.many = many;
+  {
+    std::unique_lock<std::mutex> lk(gc->mu);
+    if (!gc->running)
+      return false;
+    gc->queue.push_back(&req);
+    gc->cv.notify_one();
+    gc->done_cv.wait(lk, [&req] { return req.done; });
+  }
+  g_db_group_last_id[(size_t)(AS_INT(dbVal) - 1)] = req.last_id;
+  *ok = req.ok;
+  return true;
+}
+
+static bool db_group_commit_start(DbConn *desc) {
+  std::lock_guard<std::mutex> ctl(desc->gc_ctl_mu);
+  DbGroupCommit *gc = desc->gc.load();
+  if (gc && gc->running)
+    return true;
+  sqlite3 *conn = nullptr;
+  if (sqlite3_open(desc->path.c_str(), &conn) != SQLITE_OK) {
+    if (conn)
+      sqlite3_close(conn);
+    return false;
+  }
+  db_apply_pragmas(conn, desc->wal);
+  if (!gc) {
+    gc = new DbGroupCommit(); // lives as long as the descriptor (never freed)
+    desc->gc.store(gc);
+  }
+  gc->conn = conn;
+  {
+    std::lock_guard<std::mutex> g(gc->mu);
+    gc->running = true;
+  }
+  gc->writer = std::thread(db_group_writer, gc);
+  return true;
+}
+
+static void db_group_commit_stop(DbConn *desc) {
+  std::lock_guard<std::mutex> ctl(desc->gc_ctl_mu);
+  DbGroupCommit *gc = desc->gc.load();
+  if (!gc)
+    return;
+  {
+    std::lock_guard<std::mutex> g(gc->mu);
+    if (!gc->running)
+      return;
+    gc->running = false;
+  }
+  gc->cv.notify_all();
+  if (gc->writer.joinable())
+    gc->writer.join();
+}
+
+// db_group_commit(db, on) -> bool. true = group commit is now in the
+// requested state; false for :memory: / invalid handles or if the writer's
+// connection can't be opened.
+VMValue aot_db_group_commit(VMValue dbVal, VMValue onVal) {
+  DbConn *desc = db_desc(dbVal);
+  if (!desc || desc->shared)
+    return VM_BOOL(0);
+  bool on = IS_BOOL(onVal) ? AS_BOOL(onVal) : (IS_INT(onVal) && AS_INT(onVal));
+  if (!on) {
+    db_group_commit_stop(desc);
+    return VM_BOOL(1);
+  }
+  return VM_BOOL(db_group_commit_start(desc));
+}
+
+// db_executemany(db, sql, rows) -> bool. `rows` is an array of param arrays;
+// one prepared statement, one transaction, all-or-nothing.
+VMValue aot_db_executemany(VMValue dbVal, VMValue sqlVal, VMValue rowsVal) {
+  if (!IS_STRING(sqlVal) || !IS_ARRAY(rowsVal))
+    return VM_BOOL(0);
+  sqlite3 *db = db_resolve(dbVal);
+  if (!db)
+    return VM_BOOL(0);
+  ObjString *sql = AS_STRING(sqlVal);
+  bool grouped_ok;
+  if (db_group_write(dbVal, db, sql->chars, sql->length, rowsVal, true,
+                     &grouped_ok))
+    return VM_BOOL(grouped_ok);
+  db_forget_group_id(dbVal);
+  sqlite3_stmt *stmt = db_cached_prepare(db, sql->chars, sql->length);
+  if (!stmt) {
+    if (getenv("TULPAR_DB_DEBUG"))
+      fprintf(stderr, "[dbm] prepare failed (%s)\n", sqlite3_errmsg(db));
+    return VM_BOOL(0);
+  }
+  return VM_BOOL(db_exec_many(db, stmt, rowsVal));
+}
+
 // db_query(db, sql, params) -> array of row objects. Parameterized variant of
 // aot_db_query — `?` placeholders bound from the `params` array.
 VMValue aot_db_query_params(VMValue dbVal, VMValue sqlVal, VMValue paramsVal) {
   ObjArray *result = (ObjArray *)aot_arena_alloc(sizeof(ObjArray));
   result->obj.type = OBJ_ARRAY;
   result->obj.arena_allocated = 1;
-  result->obj.next = nullptr;
+  result->obj.is_shared = 0;
   result->capacity = 16;
   result->count = 0;
   result->items = (VMValue *)aot_arena_alloc(sizeof(VMValue) * result->capacity);
@@ -8738,53 +10517,7 @@ VMValue aot_db_query_params(VMValue dbVal, VMValue sqlVal, VMValue paramsVal) {
   sqlite3_clear_bindings(stmt);
   db_bind_params(stmt, paramsVal);
 
-  int col_count = sqlite3_column_count(stmt);
-  int step_rc;
-  while ((step_rc = sqlite3_step(stmt)) == SQLITE_ROW) {
-    ObjObject *row = (ObjObject *)aot_arena_alloc(sizeof(ObjObject));
-    row->obj.type = OBJ_OBJECT;
-    row->obj.arena_allocated = 1;
-    row->obj.next = nullptr;
-    row->capacity = col_count;
-    row->count = 0;
-    row->keys = (ObjString **)aot_arena_alloc(sizeof(ObjString *) * col_count);
-    row->values = (VMValue *)aot_arena_alloc(sizeof(VMValue) * col_count);
-    for (int i = 0; i < col_count; i++) {
-      const char *col_name = sqlite3_column_name(stmt, i);
-      row->keys[row->count] = aot_allocate_string(col_name, strlen(col_name));
-      int col_type = sqlite3_column_type(stmt, i);
-      VMValue val;
-      switch (col_type) {
-      case SQLITE_INTEGER:
-        val = VM_INT(sqlite3_column_int64(stmt, i));
-        break;
-      case SQLITE_FLOAT:
-        val = VM_FLOAT(sqlite3_column_double(stmt, i));
-        break;
-      case SQLITE_TEXT: {
-        const char *text = (const char *)sqlite3_column_text(stmt, i);
-        int len = sqlite3_column_bytes(stmt, i);
-        val = VM_OBJ((Obj *)aot_allocate_string(text, len));
-        break;
-      }
-      case SQLITE_BLOB:
-      case SQLITE_NULL:
-      default:
-        val = VM_INT(0);
-        break;
-      }
-      row->values[row->count] = val;
-      row->count++;
-    }
-    if (result->count >= result->capacity) {
-      int new_cap = result->capacity * 2;
-      VMValue *new_items = (VMValue *)aot_arena_alloc(sizeof(VMValue) * new_cap);
-      memcpy(new_items, result->items, sizeof(VMValue) * result->count);
-      result->items = new_items;
-      result->capacity = new_cap;
-    }
-    result->items[result->count++] = VM_OBJ((Obj *)row);
-  }
+  int step_rc = db_collect_rows(stmt, result);
   if (step_rc != SQLITE_DONE && getenv("TULPAR_DB_DEBUG"))
     fprintf(stderr, "[dbq] step rc=%d (%s) rows=%d\n", step_rc,
             sqlite3_errmsg(db), result->count);
@@ -8801,6 +10534,393 @@ VMValue aot_db_query_params_ptr(VMValue *db_ptr, VMValue *sql_ptr,
                             params_ptr ? *params_ptr : VM_INT(0));
 }
 
+// ----------------------------------------------------------------------------
+// Cursors: db_cursor / db_next / db_close_cursor
+//
+// db_query materialises the whole result set before the caller sees a row;
+// a cursor steps one row per db_next, so a large export holds one row at a
+// time (and can arena_restore between rows). Each cursor owns a statement
+// prepared for it alone — not the shared statement cache, where a nested
+// db_query of the same SQL would reset it mid-iteration. Handles are 1-based
+// indices into a per-thread table, like the connections they run on. The
+// statement is finalized as soon as the last row has been read (releasing
+// the WAL read snapshot) and its slot is recycled — the handle is dead once
+// db_next has returned 0. db_close_cursor is needed only to stop early.
+// db_close finalizes the calling thread's cursors on that database.
+// ----------------------------------------------------------------------------
+static DbCursor *db_cursor_resolve(VMValue curVal) {
+  if (!IS_INT(curVal))
+    return nullptr;
+  int64_t h = AS_INT(curVal);
+  if (h <= 0 || (size_t)h > g_db_cursors.size())
+    return nullptr;
+  DbCursor &c = g_db_cursors[(size_t)(h - 1)];
+  return c.open ? &c : nullptr;
+}
+
+// db_cursor(db, sql[, params]) -> cursor handle (int, 0 on failure)
+VMValue aot_db_cursor(VMValue dbVal, VMValue sqlVal, VMValue paramsVal) {
+  if (!IS_STRING(sqlVal))
+    return VM_INT(0);
+  sqlite3 *db = db_resolve(dbVal);
+  if (!db)
+    return VM_INT(0);
+  ObjString *sql = AS_STRING(sqlVal);
+  sqlite3_stmt *stmt = db_prepare_raw(db, sql->chars, sql->length);
+  if (!stmt) {
+    if (getenv("TULPAR_DB_DEBUG"))
+      fprintf(stderr, "[dbc] prepare failed (%s)\n", sqlite3_errmsg(db));
+    return VM_INT(0);
+  }
+  db_bind_params(stmt, paramsVal);
+
+  size_t slot = 0;
+  while (slot < g_db_cursors.size() && g_db_cursors[slot].open)
+    slot++;
+  if (slot == g_db_cursors.size())
+    g_db_cursors.emplace_back();
+  DbCursor &c = g_db_cursors[slot];
+  c.db = db;
+  c.stmt = stmt;
+  c.cols = sqlite3_column_count(stmt);
+
+  c.keys = c.cols > 0
+               ? (ObjString **)malloc(sizeof(ObjString *) * c.cols)
+               : nullptr;
+  for (int i = 0; c.keys && i < c.cols; i++)
+    c.keys[i] = db_column_key(sqlite3_column_name(stmt, i));
+  c.open = true;
+  return VM_INT((int64_t)(slot + 1));
+}
+
+// db_close_cursor(cursor) -> void
+void aot_db_close_cursor(VMValue curVal) {
+  DbCursor *c = db_cursor_resolve(curVal);
+  if (!c)
+    return;
+  db_cursor_finish(*c);
+  free(c->keys);
+  c->keys = nullptr;
+  c->open = false;
+}
+
+// db_next(cursor) -> next row object, or 0 once the rows are exhausted (and
+// on an invalid / closed cursor). The row's key array is an arena copy of
+// the cursor's, so rows outlive db_close_cursor; the key strings themselves
+// are shared.
+VMValue aot_db_next(VMValue curVal) {
+  DbCursor *c = db_cursor_resolve(curVal);
+  if (!c)
+    return VM_INT(0);
+  if (!c->stmt) { // finalized by db_close
+    aot_db_close_cursor(curVal);
+    return VM_INT(0);
+  }
+  int rc = sqlite3_step(c->stmt);
+  if (rc != SQLITE_ROW) {
+    if (rc != SQLITE_DONE && getenv("TULPAR_DB_DEBUG"))
+      fprintf(stderr, "[dbc] step rc=%d (%s)\n", rc, sqlite3_errmsg(c->db));
+    aot_db_close_cursor(curVal);
+    return VM_INT(0);
+  }
+  ObjString **keys = nullptr;
+  if (c->cols > 0) {
+    keys = (ObjString **)aot_arena_alloc(sizeof(ObjString *) * c->cols);
+    memcpy(keys, c->keys, sizeof(ObjString *) * c->cols);
+  }
+  return VM_OBJ((Obj *)db_row_object(c->stmt, keys, c->cols));
+}
+
+// db_query_columns(db, sql[, params]) -> {column: [values...]}
+//
+// Column-major result for analytics-style reads (sum a column, feed a
+// chart): one array per column instead of one object per row, so a 100k-row
+// read allocates `cols` arrays rather than 100k objects. Column order
+// follows the SELECT; a query with no rows still returns every column, each
+// with an empty array.
+VMValue aot_db_query_columns(VMValue dbVal, VMValue sqlVal,
+                             VMValue paramsVal) {
+  ObjObject *out = (ObjObject *)aot_arena_alloc(sizeof(ObjObject));
+  out->obj.type = OBJ_OBJECT;
+  out->obj.arena_allocated = 1;
+  out->obj.is_shared = 0;
+  out->obj.ref_count = 1;
+  out->obj.is_moved = 0;
+  out->capacity = 0;
+  out->count = 0;
+  out->keys = nullptr;
+  out->values = nullptr;
+
+  if (!IS_STRING(sqlVal))
+    return VM_OBJ((Obj *)out);
+  sqlite3 *db = db_resolve(dbVal);
+  if (!db)
+    return VM_OBJ((Obj *)out);
+  ObjString *sql = AS_STRING(sqlVal);
+  sqlite3_stmt *stmt = db_cached_prepare(db, sql->chars, sql->length);
+  if (!stmt) {
+    if (getenv("TULPAR_DB_DEBUG"))
+      fprintf(stderr, "[dbq] prepare failed (%s)\n", sqlite3_errmsg(db));
+    return VM_OBJ((Obj *)out);
+  }
+  sqlite3_clear_bindings(stmt);
+  db_bind_params(stmt, paramsVal);
+
+  int cols = sqlite3_column_count(stmt);
+  if (cols > 0) {
+    out->capacity = cols;
+    out->count = cols;
+    out->keys = db_column_keys(stmt, cols);
+    out->values = (VMValue *)aot_arena_alloc(sizeof(VMValue) * cols);
+  }
+  std::vector<ObjArray *> columns((size_t)cols);
+  for (int i = 0; i < cols; i++) {
+    ObjArray *arr = (ObjArray *)aot_arena_alloc(sizeof(ObjArray));
+    arr->obj.type = OBJ_ARRAY;
+    arr->obj.arena_allocated = 1;
+    arr->obj.is_shared = 0;
+    arr->obj.ref_count = 1;
+    arr->obj.is_moved = 0;
+    arr->capacity = 0;
+    arr->count = 0;
+    arr->items = nullptr;
+    columns[i] = arr;
+    out->values[i] = VM_OBJ((Obj *)arr);
+  }
+  int step_rc;
+  int rows = 0;
+  while ((step_rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+    for (int i = 0; i < cols; i++)
+      db_array_push(columns[i], db_column_value(stmt, i));
+    rows++;
+  }
+  if (step_rc != SQLITE_DONE && getenv("TULPAR_DB_DEBUG"))
+    fprintf(stderr, "[dbq] step rc=%d (%s) rows=%d\n", step_rc,
+            sqlite3_errmsg(db), rows);
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+  return VM_OBJ((Obj *)out);
+}
+
+// ----------------------------------------------------------------------------
+// Prepared handles: db_prepare / db_stmt_query / db_stmt_execute
+//
+// db_prepare(db, sql) registers the SQL once and returns a process-wide
+// handle; the ORM does this per model at definition time, so find / count /
+// remove never build, hash or compare SQL text on the hot path. Because a
+// db handle resolves to a different connection on every worker thread, the
+// handle names (db, sql) rather than a statement: each thread prepares its
+// own pinned statement on first use. Pinned statements sit outside the LRU
+// cache and are never evicted; db_close finalizes the calling thread's.
+// The same (db, sql) pair always maps to the same handle.
+// ----------------------------------------------------------------------------
+struct DbPrepared {
+  int64_t db_handle;
+  std::string sql;
+};
+static std::mutex g_db_prepared_mu;
+static std::vector<DbPrepared> g_db_prepared; // index = handle - 1
+
+// This thread's ready-to-step (reset, unbound) statement for handle `h`,
+// with its connection in *db_out. nullptr on a bad handle, a closed db or a
+// failed prepare. The owning db handle goes to *handle_out when asked for.
+static sqlite3_stmt *db_prepared_stmt(VMValue h, sqlite3 **db_out,
+                                      int64_t *handle_out = nullptr) {
+  if (!IS_INT(h) || AS_INT(h) <= 0)
+    return nullptr;
+  size_t idx = (size_t)(AS_INT(h) - 1);
+  DbPrepared p;
+  {
+    std::lock_guard<std::mutex> g(g_db_prepared_mu);
+    if (idx >= g_db_prepared.size())
+      return nullptr;
+    p.db_handle = g_db_prepared[idx].db_handle;
+    if (idx >= g_db_pinned.size() || !g_db_pinned[idx].stmt)
+      p.sql = g_db_prepared[idx].sql;
+  }
+  sqlite3 *db = db_resolve(VM_INT(p.db_handle));
+  if (!db)
+    return nullptr;
+  if (handle_out)
+    *handle_out = p.db_handle;
+  if (g_db_pinned.size() <= idx)
+    g_db_pinned.resize(idx + 1);
+  DbPinnedStmt &pin = g_db_pinned[idx];
+  if (pin.stmt && pin.db == db) {
+    sqlite3_reset(pin.stmt);
+    sqlite3_clear_bindings(pin.stmt);
+    *db_out = db;
+    return pin.stmt;
+  }
+  if (pin.stmt) { // db was closed and reopened under the same handle
+    sqlite3_finalize(pin.stmt);
+    pin.stmt = nullptr;
+    std::lock_guard<std::mutex> g(g_db_prepared_mu);
+    p.sql = g_db_prepared[idx].sql;
+  }
+  pin.stmt = db_prepare_raw(db, p.sql.data(), (int)p.sql.size());
+  pin.db = pin.stmt ? db : nullptr;
+  if (!pin.stmt && getenv("TULPAR_DB_DEBUG"))
+    fprintf(stderr, "[dbp] prepare failed (%s)\n", sqlite3_errmsg(db));
+  *db_out = db;
+  return pin.stmt;
+}
+
+// db_prepare(db, sql) -> statement handle (int, 0 if the SQL doesn't prepare)
+VMValue aot_db_prepare(VMValue dbVal, VMValue sqlVal) {
+  sqlite3 *db = IS_INT(dbVal) ? db_resolve(dbVal) : nullptr;
+  if (!IS_STRING(sqlVal) || !db)
+    return VM_INT(0);
+  ObjString *sql = AS_STRING(sqlVal);
+  // Prepare first: bad SQL gets 0 and never takes a registry slot.
+  sqlite3_stmt *stmt = db_prepare_raw(db, sql->chars, sql->length);
+  if (!stmt) {
+    if (getenv("TULPAR_DB_DEBUG"))
+      fprintf(stderr, "[dbp] prepare failed (%s)\n", sqlite3_errmsg(db));
+    return VM_INT(0);
+  }
+  size_t idx;
+  {
+    std::lock_guard<std::mutex> g(g_db_prepared_mu);
+    idx = 0;
+    while (idx < g_db_prepared.size() &&
+           !(g_db_prepared[idx].db_handle == AS_INT(dbVal) &&
+             g_db_prepared[idx].sql.size() == (size_t)sql->length &&
+             memcmp(g_db_prepared[idx].sql.data(), sql->chars,
+                    sql->length) == 0))
+      idx++;
+    if (idx == g_db_prepared.size())
+      g_db_prepared.push_back(
+          {AS_INT(dbVal), std::string(sql->chars, (size_t)sql->length)});
+  }
+  // Pin it for this thread (a repeat db_prepare keeps the existing pin).
+  if (g_db_pinned.size() <= idx)
+    g_db_pinned.resize(idx + 1);
+  DbPinnedStmt &pin = g_db_pinned[idx];
+  if (pin.stmt && pin.db == db) {
+    sqlite3_finalize(stmt);
+  } else {
+    if (pin.stmt)
+      sqlite3_finalize(pin.stmt);
+    pin.stmt = stmt;
+    pin.db = db;
+  }
+  return VM_INT((int64_t)(idx + 1));
+}
+
+// db_stmt_query(stmt, params) -> array of row objects (as db_query)
+VMValue aot_db_stmt_query(VMValue stmtVal, VMValue paramsVal) {
+  ObjArray *result = (ObjArray *)aot_arena_alloc(sizeof(ObjArray));
+  result->obj.type = OBJ_ARRAY;
+  result->obj.arena_allocated = 1;
+  result->obj.is_shared = 0;
+  result->obj.ref_count = 1;
+  result->obj.is_moved = 0;
+  result->capacity = 0;
+  result->count = 0;
+  result->items = nullptr;
+  sqlite3 *db = nullptr;
+  sqlite3_stmt *stmt = db_prepared_stmt(stmtVal, &db);
+  if (!stmt)
+    return VM_OBJ((Obj *)result);
+  db_bind_params(stmt, paramsVal);
+  int step_rc = db_collect_rows(stmt, result);
+  if (step_rc != SQLITE_DONE && getenv("TULPAR_DB_DEBUG"))
+    fprintf(stderr, "[dbp] step rc=%d (%s) rows=%d\n", step_rc,
+            sqlite3_errmsg(db), result->count);
+  sqlite3_reset(stmt);
+  return VM_OBJ((Obj *)result);
+}
+
+// db_stmt_execute(stmt, params) -> bool (as db_execute, group commit
+// included: the writer runs the statement's SQL through its own cache).
+VMValue aot_db_stmt_execute(VMValue stmtVal, VMValue paramsVal) {
+  sqlite3 *db = nullptr;
+  int64_t handle = 0;
+  sqlite3_stmt *stmt = db_prepared_stmt(stmtVal, &db, &handle);
+  if (!stmt)
+    return VM_BOOL(0);
+  const char *sql = sqlite3_sql(stmt);
+  bool grouped_ok;
+  if (db_group_write(VM_INT(handle), db, sql, (int)strlen(sql), paramsVal,
+                     false, &grouped_ok))
+    return VM_BOOL(grouped_ok);
+  db_forget_group_id(VM_INT(handle));
+  db_bind_params(stmt, paramsVal);
+  int rc;
+  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+  }
+  if (rc != SQLITE_DONE && getenv("TULPAR_DB_DEBUG"))
+    fprintf(stderr, "[dbp] step rc=%d (%s)\n", rc, sqlite3_errmsg(db));
+  sqlite3_reset(stmt);
+  return VM_BOOL(rc == SQLITE_DONE);
+}
+
+// db_stats() -> {"stmt_cache_hits", "stmt_cache_misses",
+// "stmt_cache_evictions", "stmt_cache_capacity", "prepared",
+// "group_commit_batches", "group_commit_writes"}. Counters are
+// process-wide (all threads, all connections); Wings folds them into
+// /metrics.
+VMValue aot_db_stats(void) {
+  ObjObject *o = aot_http_make_obj(7);
+  size_t prepared;
+  {
+    std::lock_guard<std::mutex> g(g_db_prepared_mu);
+    prepared = g_db_prepared.size();
+  }
+  aot_http_obj_set(o, "stmt_cache_hits", 15,
+                   VM_INT((int64_t)g_stmt_cache_hits.load()));
+  aot_http_obj_set(o, "stmt_cache_misses", 17,
+                   VM_INT((int64_t)g_stmt_cache_misses.load()));
+  aot_http_obj_set(o, "stmt_cache_evictions", 20,
+                   VM_INT((int64_t)g_stmt_cache_evictions.load()));
+  aot_http_obj_set(o, "stmt_cache_capacity", 19,
+                   VM_INT((int64_t)db_stmt_cache_cap()));
+  aot_http_obj_set(o, "prepared", 8, VM_INT((int64_t)prepared));
+  aot_http_obj_set(o, "group_commit_batches", 20,
+                   VM_INT((int64_t)g_db_group_batches.load()));
+  aot_http_obj_set(o, "group_commit_writes", 19,
+                   VM_INT((int64_t)g_db_group_writes.load()));
+  return VM_OBJ((Obj *)o);
+}
+
+// arc_stats() -> json: ARC free counters (see tulpar_arc.cpp). pending_* is
+// what a free budget (TULPAR_ARC_FREE_BUDGET) left queued right now.
+VMValue aot_arc_stats(void) {
+  ArcStats st;
+  arc_get_stats(&st);
+  ObjObject *o = aot_http_make_obj(6);
+  aot_http_obj_set(o, "freed_objects", 13, VM_INT(st.freed_objects));
+  aot_http_obj_set(o, "freed_bytes", 11, VM_INT(st.freed_bytes));
+  aot_http_obj_set(o, "pending_objects", 15, VM_INT(st.pending_objects));
+  aot_http_obj_set(o, "pending_bytes", 13, VM_INT(st.pending_bytes));
+  aot_http_obj_set(o, "deferred_releases", 17, VM_INT(st.deferred_releases));
+  aot_http_obj_set(o, "free_budget", 11, VM_INT(st.free_budget));
+  return VM_OBJ((Obj *)o);
+}
+
+// arena_stats() -> json: AOT arena counters across all threads (see Arena
+// trimming). bytes / peak_bytes count mapped block memory, huge blocks
+// included; trims is how many times a thread gave surplus blocks back.
+VMValue aot_arena_stats(void) {
+  aot_arena_policy_init();
+  ObjObject *o = aot_http_make_obj(9);
+  aot_http_obj_set(o, "bytes", 5, VM_INT(g_arena_bytes.load()));
+  aot_http_obj_set(o, "peak_bytes", 10, VM_INT(g_arena_peak_bytes.load()));
+  aot_http_obj_set(o, "blocks", 6, VM_INT(g_arena_blocks.load()));
+  aot_http_obj_set(o, "huge_blocks", 11, VM_INT(g_arena_huge_live.load()));
+  aot_http_obj_set(o, "huge_allocs", 11, VM_INT(g_arena_huge_allocs.load()));
+  aot_http_obj_set(o, "trims", 5, VM_INT(g_arena_trims.load()));
+  aot_http_obj_set(o, "trimmed_bytes", 13,
+                   VM_INT(g_arena_trimmed_bytes.load()));
+  aot_http_obj_set(o, "keep_blocks", 11, VM_INT(g_arena_keep_blocks));
+  aot_http_obj_set(o, "trim_after", 10, VM_INT(g_arena_trim_after));
+  return VM_OBJ((Obj *)o);
+}
+
+// arc_drain() -> int: free everything queued on this thread now.
+VMValue aot_arc_drain(void) { return VM_INT(arc_drain(0)); }
+
 // db_last_insert_id(db_handle) -> int64
 // Resolves to this thread's connection — the same one that ran the INSERT
 // within a request handler, so the rowid is correct.
@@ -8808,6 +10928,12 @@ VMValue aot_db_last_insert_id(VMValue dbVal) {
   sqlite3 *db = db_resolve(dbVal);
   if (!db)
     return VM_INT(0);
+  if (!g_db_group_last_id.empty()) {
+    std::unordered_map<size_t, int64_t>::iterator it =
+        g_db_group_last_id.find((size_t)(AS_INT(dbVal) - 1));
+    if (it != g_db_group_last_id.end())
+      return VM_INT(it->second);
+  }
 
   return VM_INT(sqlite3_last_insert_rowid(db));
 }
@@ -8833,7 +10959,7 @@ VMValue aot_typeof(VMValue v) {
   const char *type_name;
   int len;
 
-  switch (v.type) {
+  switch (VM_TYPE(v)) {
   case VM_VAL_INT:
     type_name = "int";
     len = 3;
@@ -8884,18 +11010,13 @@ VMValue aot_is_bool(VMValue v) { return VM_BOOL(IS_BOOL(v)); }
 VMValue aot_call_closure(ObjClosure *cls, VMValue *args, int argc) {
   if (!cls) {
     printf("Calisma Zamani Hatasi: Null closure cagirildi\n");
-    VMValue res;
-    res.type = VM_VAL_VOID;
-    return res;
+    return VM_VOID();
   }
   if (cls->arity != argc) {
     printf("Calisma Zamani Hatasi: Hatali parametre sayisi. Beklenen: %d, Alinan: %d\n", cls->arity, argc);
-    VMValue res;
-    res.type = VM_VAL_VOID;
-    return res;
+    return VM_VOID();
   }
-  VMValue result;
-  result.type = VM_VAL_VOID;
+  VMValue result = VM_VOID();
   void *env = cls->env;
   switch (argc) {
     case 0:
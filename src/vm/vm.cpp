@@ -18,6 +18,7 @@
 #include "../common/localization.hpp"
 #include "vm.hpp"
 #include "../pkg/sha256.hpp"
+#include "../../runtime/tulpar_alloc.h"
 #include <cctype>
 #include <cmath> // For clock()
 #include <stdarg.h>
@@ -259,7 +260,7 @@ static Obj *allocate_object(VM *vm, size_t size, ObjType type) {
     obj = (Obj *)arena_alloc(vm->arena, size);
     from_arena = 1;
   } else {
-    obj = static_cast<Obj*>(malloc(size));
+    obj = static_cast<Obj*>(tulpar_malloc(size));
     from_arena = 0;
   }
 
@@ -268,8 +269,14 @@ static Obj *allocate_object(VM *vm, size_t size, ObjType type) {
 
   obj->type = type;
   obj->arena_allocated = from_arena;
-  obj->next = vm->objects;
-  vm->objects = obj;
+  obj->is_shared = 0;
+  if (vm->object_count >= vm->object_capacity) {
+    vm->object_capacity =
+        vm->object_capacity == 0 ? 256 : vm->object_capacity * 2;
+    vm->objects = (Obj **)realloc(vm->objects,
+                                  vm->object_capacity * sizeof(Obj *));
+  }
+  vm->objects[vm->object_count++] = obj;
   vm->bytes_allocated += size;
   return obj;
 }
@@ -296,23 +303,16 @@ ObjString *vm_alloc_string(VM *vm, const char *chars, int length) {
     }
   }
 
-  // Allocate new string
-  ObjString *str =
-      (ObjString *)allocate_object(vm, sizeof(ObjString), OBJ_STRING);
+  // Allocate new string; the bytes follow the header in the same block.
+  // Interned strings are never appended to in place, so no spare capacity:
+  // `s = s + x` grows its own arena buffer geometrically in
+  // aot_string_append_inplace and never sees these strings.
+  ObjString *str = (ObjString *)allocate_object(
+      vm, sizeof(ObjString) + length + 1, OBJ_STRING);
   str->length = length;
-
-  // OPTIMIZATION: Pre-allocate capacity for string concatenation
-  // Empty strings and small strings get extra capacity for future appends
-  if (length == 0) {
-    str->capacity = 256; // Empty string gets 256 bytes (common in loops!)
-  } else if (length < 64) {
-    str->capacity = 128; // Small strings get 128 bytes
-  } else {
-    str->capacity = length * 2; // Larger strings: 2x growth strategy
-  }
+  str->capacity = length + 1;
 
   str->obj.ref_count = 1; // Start with 1 reference (The caller/stack)
-  str->chars = static_cast<char*>(malloc(str->capacity + 1));
   memcpy(str->chars, chars, length);
   str->chars[length] = '\0';
   str->hash = hash;
@@ -343,13 +343,14 @@ ObjString *vm_take_string(VM *vm, char *chars, int length) {
     }
   }
 
-  // Allocate new string object wrapper
-  ObjString *str =
-      (ObjString *)allocate_object(vm, sizeof(ObjString), OBJ_STRING);
+  // Copy into an inline string and release the caller's buffer.
+  ObjString *str = (ObjString *)allocate_object(
+      vm, sizeof(ObjString) + length + 1, OBJ_STRING);
   str->length = length;
-  str->capacity = length;
+  str->capacity = length + 1;
   str->obj.ref_count = 1;
-  str->chars = chars; // Take ownership directly!
+  memcpy(str->chars, chars, length);
+  free(chars);
   str->chars[length] = '\0';
   str->hash = hash;
 
@@ -443,12 +444,11 @@ ObjString *vm_copy_string(VM *vm, const char *chars, int length) {
 }
 
 ObjString *vm_alloc_string_buffer(VM *vm, int length, int capacity) {
-  ObjString *str =
-      (ObjString *)allocate_object(vm, sizeof(ObjString), OBJ_STRING);
+  ObjString *str = (ObjString *)allocate_object(
+      vm, sizeof(ObjString) + capacity + 1, OBJ_STRING);
   str->length = length;
-  str->capacity = capacity;
+  str->capacity = capacity + 1;
   str->obj.ref_count = 1;
-  str->chars = static_cast<char*>(malloc(capacity + 1));
   str->chars[length] = '\0';
   str->hash = 0; // Not hashed yet
   return str;
@@ -509,6 +509,8 @@ VM *vm_create() {
   }
 
   vm->objects = nullptr;
+  vm->object_count = 0;
+  vm->object_capacity = 0;
   vm->bytes_allocated = 0;
   vm->next_gc = 1024 * 1024; // First GC at 1MB
 
@@ -527,13 +529,9 @@ static void free_object(Obj *obj) {
 
   switch (obj->type) {
   case OBJ_STRING: {
-    ObjString *str = (ObjString *)obj;
-    // chars is always malloc'd, free it
-    if (str->chars)
-      free(str->chars);
-    // Only free the struct if not from arena
+    // chars are inline; only free the block if not from arena
     if (!from_arena)
-      free(str);
+      tulpar_free(obj);
     break;
   }
   case OBJ_FUNCTION: {
@@ -556,27 +554,27 @@ static void free_object(Obj *obj) {
       free(func->chunk.local_names);
     }
     if (!from_arena)
-      free(func);
+      tulpar_free(func);
     break;
   }
   case OBJ_ARRAY: {
     ObjArray *arr = (ObjArray *)obj;
     // items is always malloc'd
     if (arr->items)
-      free(arr->items);
+      tulpar_free(arr->items);
     if (!from_arena)
-      free(arr);
+      tulpar_free(arr);
     break;
   }
   case OBJ_OBJECT: {
     ObjObject *o = (ObjObject *)obj;
     // keys and values are always malloc'd
     if (o->keys)
-      free(o->keys);
+      tulpar_free(o->keys);
     if (o->values)
-      free(o->values);
+      tulpar_free(o->values);
     if (!from_arena)
-      free(o);
+      tulpar_free(o);
     break;
   }
   case OBJ_STRUCT: {
@@ -585,17 +583,17 @@ static void free_object(Obj *obj) {
     // freeing the object itself is enough — the arena claims arena
     // allocations on its own.
     if (!from_arena)
-      free(obj);
+      tulpar_free(obj);
     break;
   }
   case OBJ_CLOSURE: {
     if (!from_arena)
-      free(obj);
+      tulpar_free(obj);
     break;
   }
   default:
     if (!from_arena)
-      free(obj);
+      tulpar_free(obj);
     break;
   }
 }
@@ -606,14 +604,12 @@ void vm_free(VM *vm) {
 
   // Free all objects (only those allocated with malloc, not arena)
   // Note: Arena objects are freed when arena is destroyed
-  Obj *obj = vm->objects;
-  while (obj) {
-    Obj *next = obj->next;
+  for (int i = 0; i < vm->object_count; i++) {
     // Only free if it's a large object (allocated with malloc)
     // For now we still free all - arena handles its own memory
-    free_object(obj);
-    obj = next;
+    free_object(vm->objects[i]);
   }
+  free(vm->objects);
 
   // Free arena allocator
   if (vm->arena) {
@@ -667,7 +663,7 @@ VMValue *vm_get_global(VM *vm, ObjString *name) {
 // ============================================================================
 
 void vm_print_value(VMValue value) {
-  switch (value.type) {
+  switch (VM_TYPE(value)) {
   case VM_VAL_INT:
     printf("%lld", AS_INT(value));
     break;
@@ -841,7 +837,7 @@ void vm_array_push(VM *vm, ObjArray *array, VMValue value) {
     int old_capacity = array->capacity;
     array->capacity = old_capacity < 8 ? 8 : old_capacity * 2;
     array->items =
-        static_cast<VMValue*>(realloc(array->items, sizeof(VMValue) * array->capacity));
+        static_cast<VMValue*>(tulpar_realloc(array->items, sizeof(VMValue) * array->capacity));
   }
   array->items[array->count] = value;
   array->count++;
@@ -69,7 +69,7 @@ void arena_reset(Arena *arena); // Reset without freeing
 // ============================================================================
 
 // Combine two types into single value for switch
-#define TYPE_PAIR(a, b) (((uint8_t)(a).type << 4) | (uint8_t)(b).type)
+#define TYPE_PAIR(a, b) (((uint8_t)VM_TYPE(a) << 4) | (uint8_t)VM_TYPE(b))
 
 // Common type pairs (for fast path in arithmetic)
 #define TYPE_INT_INT ((VM_VAL_INT << 4) | VM_VAL_INT)         // 0x00
@@ -101,22 +101,34 @@ typedef enum {
 // Object types for heap allocation
 typedef enum { OBJ_STRING, OBJ_ARRAY, OBJ_OBJECT, OBJ_FUNCTION, OBJ_STRUCT, OBJ_CLOSURE, OBJ_PROMISE } ObjType;
 
-// Base object header - ARC enabled
+// Base object header - ARC enabled. One 8-byte word: type and flags in the
+// low bytes, the refcount in the high half (atomic ops go through
+// &ref_count, so it stays a plain aligned int32). The interpreter's object
+// list lives in VM::objects, not in the header — AOT objects never had a
+// list to join.
 typedef struct Obj {
-  ObjType type;
-  struct Obj *next;        // For GC linked list
+  uint8_t type;            // ObjType
   uint8_t arena_allocated; // 1 if allocated from arena, 0 if malloc
+  uint8_t is_shared;       // 1 once reachable from another thread: atomic ARC
+  uint8_t is_moved;        // OBJ_MOVED / OBJ_ALIASED bits, 0 when fresh
   int32_t ref_count;       // ARC reference count
-  uint8_t is_moved;        // Move semantics: 1 if ownership transferred
 } Obj;
 
-// String object
+// Bits of Obj.is_moved. The two marks are independent: an aliased node is
+// still live and owned, a moved one is not.
+#define OBJ_MOVED 0x01   // ownership transferred (arc_move): skip the release
+#define OBJ_ALIASED 0x02 // AOT: aliased by a local, never shared (aot_alias)
+
+// String object. The bytes live inline right after the header (`chars` is
+// a flexible array member), so a short key costs one 20-byte header plus
+// its text and reading it is a single dependent load. `capacity` counts the
+// bytes available in `chars`, NUL included.
 typedef struct {
   Obj obj;
   int length;
   int capacity;
-  char *chars;
   uint32_t hash;
+  char chars[];
 } ObjString;
 
 // Function object
@@ -189,6 +201,12 @@ static inline VMValue vm_make_obj(void *v) {
   return value;
 }
 
+#define VM_TYPE(v) ((v).type)
+#define AS_INT(v) ((v).as.int_val)
+#define AS_FLOAT(v) ((v).as.float_val)
+#define AS_BOOL(v) ((v).as.bool_val)
+#define AS_OBJ(v) ((v).as.obj)
+
 // Value creation macros
 #define VM_INT(v) vm_make_int((v))
 #define VM_FLOAT(v) vm_make_float((v))
@@ -197,18 +215,14 @@ static inline VMValue vm_make_obj(void *v) {
 #define VM_OBJ(v) vm_make_obj((v))
 
 // Value accessors
-#define AS_INT(v) ((v).as.int_val)
-#define AS_FLOAT(v) ((v).as.float_val)
-#define AS_BOOL(v) ((v).as.bool_val)
-#define AS_OBJ(v) ((v).as.obj)
 #define AS_STRING(v) ((ObjString *)AS_OBJ(v))
 
 // Type checks
-#define IS_INT(v) ((v).type == VM_VAL_INT)
-#define IS_FLOAT(v) ((v).type == VM_VAL_FLOAT)
-#define IS_BOOL(v) ((v).type == VM_VAL_BOOL)
-#define IS_VOID(v) ((v).type == VM_VAL_VOID)
-#define IS_OBJ(v) ((v).type == VM_VAL_OBJ)
+#define IS_INT(v) (VM_TYPE(v) == VM_VAL_INT)
+#define IS_FLOAT(v) (VM_TYPE(v) == VM_VAL_FLOAT)
+#define IS_BOOL(v) (VM_TYPE(v) == VM_VAL_BOOL)
+#define IS_VOID(v) (VM_TYPE(v) == VM_VAL_VOID)
+#define IS_OBJ(v) (VM_TYPE(v) == VM_VAL_OBJ)
 #define IS_STRING(v) (IS_OBJ(v) && AS_OBJ(v)->type == OBJ_STRING)
 #define IS_FUNCTION(v) (IS_OBJ(v) && AS_OBJ(v)->type == OBJ_FUNCTION)
 #define IS_NUMBER(v) (IS_INT(v) || IS_FLOAT(v))
@@ -368,7 +382,9 @@ typedef struct VM {
   int global_cache_count;
 
   // Object allocation tracking (for GC)
-  Obj *objects;
+  Obj **objects;
+  int object_count;
+  int object_capacity;
   size_t bytes_allocated;
   size_t next_gc;
 
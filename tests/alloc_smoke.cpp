@@ -0,0 +1,230 @@
+// Standalone smoke test for runtime/tulpar_alloc.cpp:
+//   * per-thread heaps — 8 threads allocate and free every size class
+//     and check their fill patterns survive (no block handed out twice);
+//   * remote frees — blocks allocated on one thread and freed on another
+//     come back to the owner's heap and are reused;
+//   * realloc in place / across classes / to and from malloc sizes;
+//   * tulpar_free on a plain malloc pointer;
+//   * heap adoption — a heap left by an exited thread is reused;
+//   * --allocator=system — after tulpar_alloc_select(SYSTEM) nothing new
+//     comes from the spans.
+// Build manually with (one command line):
+//
+//   g++ -std=c++17 -O2 -pthread tests/alloc_smoke.cpp
+//       runtime/tulpar_alloc.cpp -o alloc_smoke && ./alloc_smoke
+//
+// Exits 0 on success, 1 on any mismatch. Like arc_shared_smoke, not part
+// of build.sh test — wired into CI as its own step.
+
+#include "../runtime/tulpar_alloc.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+int g_failures = 0;
+
+void check(bool ok, const char *what) {
+    std::printf("  %s %s\n", ok ? "PASS" : "FAIL", what);
+    if (!ok) g_failures++;
+}
+
+const size_t kSizes[] = {1, 8, 16, 24, 40, 64, 100, 128, 200, 256,
+                         384, 512, 700, 1024, 1500, 4096};
+const int kSizeCount = sizeof(kSizes) / sizeof(kSizes[0]);
+
+bool filled_with(const unsigned char *p, size_t n, unsigned char v) {
+    for (size_t i = 0; i < n; i++)
+        if (p[i] != v) return false;
+    return true;
+}
+
+// A thread_local whose destructor allocates. Touched before the thread's
+// first tulpar_malloc, so it is destroyed after the allocator's own
+// thread-exit hook has already handed the heap back; the block it gets is
+// passed out for main to free.
+std::mutex g_late_mtx;
+std::vector<void *> g_late_blocks;
+struct LateAlloc {
+    bool armed = false;
+    ~LateAlloc() {
+        if (!armed) return;
+        void *p = tulpar_malloc(48);
+        std::memset(p, 0x33, 48);
+        std::lock_guard<std::mutex> lock(g_late_mtx);
+        g_late_blocks.push_back(p);
+    }
+};
+thread_local LateAlloc t_late;
+
+} // namespace
+
+int main() {
+    std::printf("=== Tulpar allocator ===\n");
+
+    // Per-thread churn: keep a window of live blocks, verify each before
+    // freeing it.
+    const int kThreads = 8;
+    const int kIters = 200000;
+    std::atomic<int> corrupt{0};
+    {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < kThreads; t++) {
+            workers.emplace_back([t, &corrupt] {
+                const int kWindow = 512;
+                unsigned char *live[kWindow] = {};
+                size_t len[kWindow] = {};
+                unsigned char tag[kWindow] = {};
+                for (int i = 0; i < kIters; i++) {
+                    int slot = (i * 7919 + t) & (kWindow - 1);
+                    if (live[slot]) {
+                        if (!filled_with(live[slot], len[slot], tag[slot]))
+                            corrupt++;
+                        tulpar_free(live[slot]);
+                    }
+                    size_t n = kSizes[(i + t) % kSizeCount];
+                    live[slot] = (unsigned char *)tulpar_malloc(n);
+                    len[slot] = n;
+                    tag[slot] = (unsigned char)(i ^ t);
+                    std::memset(live[slot], tag[slot], n);
+                }
+                for (int s = 0; s < kWindow; s++) {
+                    if (live[s] && !filled_with(live[s], len[s], tag[s]))
+                        corrupt++;
+                    tulpar_free(live[s]);
+                }
+            });
+        }
+        for (std::thread &w : workers) w.join();
+    }
+    check(corrupt == 0, "per-thread alloc/free keeps blocks intact");
+
+    // Producer/consumer: blocks cross threads and are freed remotely.
+    TulparAllocStats before, after;
+    tulpar_alloc_get_stats(&before);
+    {
+        const int kBlocks = 100000;
+        std::vector<void *> handoff;
+        std::mutex mtx;
+        std::atomic<bool> done{false};
+        std::thread producer([&] {
+            for (int round = 0; round < 4; round++) {
+                std::vector<void *> batch;
+                for (int i = 0; i < kBlocks; i++) {
+                    void *p = tulpar_malloc(48);
+                    std::memset(p, 0x5a, 48);
+                    batch.push_back(p);
+                    if (batch.size() == 1000) {
+                        std::lock_guard<std::mutex> lock(mtx);
+                        handoff.insert(handoff.end(), batch.begin(),
+                                       batch.end());
+                        batch.clear();
+                    }
+                }
+            }
+            done = true;
+        });
+        std::thread consumer([&] {
+            for (;;) {
+                std::vector<void *> batch;
+                bool finished = done;
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    batch.swap(handoff);
+                }
+                for (void *p : batch) {
+                    if (!filled_with((unsigned char *)p, 48, 0x5a)) corrupt++;
+                    tulpar_free(p);
+                }
+                if (finished && batch.empty()) break;
+                if (batch.empty()) std::this_thread::yield();
+            }
+        });
+        producer.join();
+        consumer.join();
+    }
+    tulpar_alloc_get_stats(&after);
+    check(corrupt == 0 && after.remote_frees - before.remote_frees >= 400000,
+          "cross-thread frees go through the remote lists");
+
+    // Short-lived threads one after another: each adopts the heap the
+    // previous one left behind and reuses its (purged) spans.
+    auto burst = [] {
+        std::thread([] {
+            std::vector<void *> again;
+            for (int i = 0; i < 400000; i++)
+                again.push_back(tulpar_malloc(48));
+            for (void *p : again) tulpar_free(p);
+        }).join();
+    };
+    burst();
+    tulpar_alloc_get_stats(&before);
+    for (int i = 0; i < 5; i++) burst();
+    tulpar_alloc_get_stats(&after);
+    check(after.spans == before.spans, "exited thread's heap is adopted");
+    check(after.heaps == before.heaps && after.heaps <= kThreads + 2,
+          "heaps are reused, not leaked");
+
+    // Allocating from a later thread_local destructor must not pick up a
+    // heap again: those blocks come from malloc, so freeing them here is
+    // not a remote free.
+    for (int i = 0; i < 5; i++) {
+        std::thread([] {
+            t_late.armed = true;
+            tulpar_free(tulpar_malloc(48));
+        }).join();
+    }
+    tulpar_alloc_get_stats(&before);
+    for (void *p : g_late_blocks) {
+        if (!filled_with((unsigned char *)p, 48, 0x33)) corrupt++;
+        tulpar_free(p);
+    }
+    tulpar_alloc_get_stats(&after);
+    check(corrupt == 0 && g_late_blocks.size() == 5 &&
+              after.remote_frees == before.remote_frees,
+          "allocations after thread-exit teardown use malloc");
+
+    // realloc: grow within a block, across classes and out to malloc.
+    char *r = (char *)tulpar_malloc(20);
+    std::memcpy(r, "tulpar-realloc-test", 20);
+    char *r2 = (char *)tulpar_realloc(r, 24);
+    check(r2 == r, "realloc within the block keeps the pointer");
+    r2 = (char *)tulpar_realloc(r2, 300);
+    r2 = (char *)tulpar_realloc(r2, 8000);
+    check(std::strcmp(r2, "tulpar-realloc-test") == 0,
+          "realloc across classes keeps the contents");
+    r2 = (char *)tulpar_realloc(r2, 16);
+    check(std::memcmp(r2, "tulpar-realloc-t", 16) == 0,
+          "realloc back into a class keeps the contents");
+    tulpar_free(r2);
+    check(tulpar_realloc(nullptr, 32) != nullptr, "realloc(NULL) allocates");
+
+    // Plain malloc pointers are accepted by free/realloc.
+    void *m = std::malloc(64);
+    m = tulpar_realloc(m, 128);
+    tulpar_free(m);
+    tulpar_free(nullptr);
+    check(true, "malloc pointers and NULL accepted");
+
+    // --allocator=system: new blocks come from malloc; old ones still free.
+    void *old_block = tulpar_malloc(32);
+    tulpar_alloc_get_stats(&before);
+    tulpar_alloc_select(TULPAR_ALLOCATOR_SYSTEM);
+    std::vector<void *> sys;
+    for (int i = 0; i < 100000; i++) sys.push_back(tulpar_malloc(32));
+    for (void *p : sys) tulpar_free(p);
+    tulpar_free(old_block);
+    tulpar_alloc_get_stats(&after);
+    check(tulpar_alloc_selected() == TULPAR_ALLOCATOR_SYSTEM &&
+              after.allocator == TULPAR_ALLOCATOR_SYSTEM &&
+              after.spans == before.spans,
+          "system allocator bypasses the spans");
+
+    std::printf("%s\n", g_failures == 0 ? "OK" : "FAILED");
+    return g_failures == 0 ? 0 : 1;
+}
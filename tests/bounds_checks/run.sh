@@ -0,0 +1,110 @@
+#!/bin/bash
+# Bounds-check regression runner — builds tests/bounds_checks/loops.tpr at
+# each --checks level and asserts what the compiler elided (the
+# `[AOT] Bounds checks:` line under TULPAR_AOT_VERBOSE=1) and which
+# out-of-range accesses the program still reports.
+#
+#   default        2 accesses proved (1 loop at compile time, 1 behind a
+#                  guard); output matches loops.expected. The errors before
+#                  "guard fails" come from the checked copy codegen_for_ranged
+#                  runs when range_loop_guard fails — the proved copy has no
+#                  checks to report them.
+#   --checks=full  nothing elided, same output as the default.
+#   --checks=none  nothing left to elide; only the boxed pop() loop reports.
+#
+# Run from repo root: `./tests/bounds_checks/run.sh`. The runner expects
+# `./tulpar` (or `./tulpar.exe` on Git Bash) to exist and be built.
+
+set -u
+
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+NC='\033[0m'
+
+TULPAR="./tulpar"
+[ -x "$TULPAR" ] || TULPAR="./tulpar.exe"
+if [ ! -x "$TULPAR" ]; then
+    echo "ERROR: ./tulpar not built. Run ./build.sh first." >&2
+    exit 1
+fi
+
+DIR=tests/bounds_checks
+SRC="$DIR/loops.tpr"
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+# English diagnostics, a fresh compile every time (a cache hit prints no
+# stats).
+export LC_ALL=C TULPAR_AOT_NOCACHE=1 TULPAR_AOT_VERBOSE=1
+
+failures=0
+
+pass() { printf "${GREEN}PASS${NC} %s\n" "$1"; }
+fail() {
+    printf "${RED}FAIL${NC} %s\n" "$1"
+    [ -n "${2:-}" ] && echo "$2" | sed 's/^/    /'
+    failures=$((failures + 1))
+}
+
+# build <label> <flags...>: compile into $OUT/<label>, leave the stats line
+# in $stats and the program's output in $run.
+build() {
+    local label=$1
+    shift
+    local log
+    log=$("$TULPAR" build "$@" "$SRC" "$OUT/$label" 2>&1 | tr -d '\000')
+    stats=$(echo "$log" | grep '^\[AOT\] Bounds checks:' | sed 's/^\[AOT\] Bounds checks: //')
+    if [ ! -x "$OUT/$label" ]; then
+        fail "$label: build failed" "$log"
+        run=""
+        return 1
+    fi
+    run=$("$OUT/$label" 2>&1)
+}
+
+expect_stats() {
+    local label=$1 want=$2
+    if [ "$stats" = "$want" ]; then
+        pass "$label: $want"
+    else
+        fail "$label: expected '$want'" "got '$stats'"
+    fi
+}
+
+oob_lines() { echo "$run" | grep -c 'Array index out of bounds'; }
+
+if build default; then
+    expect_stats default "2 typed-array access(es) proved in range (1 loop(s) at compile time, 1 behind a loop guard)."
+    if [ "$run" = "$(cat "$DIR/loops.expected")" ]; then
+        pass "default: output matches loops.expected"
+    else
+        fail "default: output differs from loops.expected" "$run"
+    fi
+fi
+
+if build full --checks=full; then
+    expect_stats full "0 typed-array access(es) proved in range (0 loop(s) at compile time, 0 behind a loop guard)."
+    if [ "$run" = "$(cat "$DIR/loops.expected")" ]; then
+        pass "full: same output as the default"
+    else
+        fail "full: output differs from loops.expected" "$run"
+    fi
+fi
+
+if build none --checks=none; then
+    expect_stats none "0 typed-array access(es) proved in range (0 loop(s) at compile time, 0 behind a loop guard)."
+    n=$(oob_lines)
+    if [ "$n" -eq 2 ] && echo "$run" | grep -qx 'static 36' &&
+       echo "$run" | grep -qx 'guarded 18' &&
+       echo "$run" | grep -qx 'shrinks in loop 10'; then
+        pass "none: typed-array checks gone, boxed pop() loop still reports"
+    else
+        fail "none: expected 2 reports (boxed loop only), got $n" "$run"
+    fi
+fi
+
+echo ""
+if [ $failures -ne 0 ]; then
+    printf "${RED}%d bounds-check test(s) failed.${NC}\n" "$failures"
+    exit 1
+fi
+printf "${GREEN}All bounds-check tests passed${NC}\n"
@@ -51,9 +51,11 @@ RUNTIME_CPP=(
     "$ROOT/src/vm/runtime_bindings.cpp"
     "$ROOT/src/vm/vm.cpp"
     "$ROOT/src/vm/bytecode.cpp"
+    "$ROOT/runtime/tulpar_alloc.cpp"
     "$ROOT/runtime/tulpar_arc.cpp"
     "$ROOT/runtime/tulpar_native.cpp"
     "$ROOT/runtime/tulpar_gzip.cpp"
+    "$ROOT/runtime/tulpar_json.cpp"
     "$ROOT/src/lexer/lexer.cpp"
     "$ROOT/src/parser/parser.cpp"
     "$ROOT/src/parser/import_alias.cpp"